@@ -0,0 +1,263 @@
+#!/usr/bin/env python3
+"""
+Startup benchmark for gpu-screen-recorder-adw.
+
+Runs the app against bench/fake-gpu-screen-recorder under a headless GDK
+backend (Xvfb or broadway) and records, relative to process launch:
+
+  probes_done     gpu-screen-recorder --info and audio probes finished
+  config_applied  config loaded and applied to the Config page
+  first_frame     first frame painted by the window
+
+plus resident memory shortly after the first frame.  The app reports
+milestones by appending "<name> <CLOCK_MONOTONIC usec>" lines to the file
+named by GSR_STARTUP_TRACE.
+
+Results are written as JSON (--output) and summarised on stdout.
+"""
+
+import argparse
+import json
+import os
+import shutil
+import signal
+import statistics
+import subprocess
+import sys
+import tempfile
+import time
+
+MILESTONES = ("probes_done", "config_applied", "first_frame")
+
+
+def monotonic_usec():
+    return time.clock_gettime_ns(time.CLOCK_MONOTONIC) // 1000
+
+
+def free_display_number(start=90):
+    for n in range(start, start + 100):
+        if not os.path.exists(f"/tmp/.X11-unix/X{n}") and \
+           not os.path.exists(f"/tmp/.X{n}-lock"):
+            return n
+    raise RuntimeError("no free X display number")
+
+
+def wait_for(predicate, timeout):
+    deadline = time.monotonic() + timeout
+    while time.monotonic() < deadline:
+        if predicate():
+            return True
+        time.sleep(0.01)
+    return False
+
+
+class Backend:
+    """A headless display server the app can connect to."""
+
+    def __init__(self, kind):
+        self.kind = kind
+        self.proc = None
+        self.env = {}
+
+    def start(self):
+        n = free_display_number()
+        if self.kind == "xvfb":
+            self.proc = subprocess.Popen(
+                ["Xvfb", f":{n}", "-screen", "0", "1920x1080x24", "-nolisten", "tcp"],
+                stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+            if not wait_for(lambda: os.path.exists(f"/tmp/.X11-unix/X{n}"), 10):
+                raise RuntimeError("Xvfb did not start")
+            self.env = {"GDK_BACKEND": "x11", "DISPLAY": f":{n}",
+                        "GSR_FAKE_DISPLAY_SERVER": "x11"}
+        else:
+            self.proc = subprocess.Popen(
+                ["gtk4-broadwayd", f":{n}"],
+                stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+            time.sleep(0.5)
+            if self.proc.poll() is not None:
+                raise RuntimeError("gtk4-broadwayd did not start")
+            # Not an X11 display, so let the app take its Wayland code paths
+            self.env = {"GDK_BACKEND": "broadway", "BROADWAY_DISPLAY": f":{n}",
+                        "GSR_FAKE_DISPLAY_SERVER": "wayland"}
+
+    def stop(self):
+        if self.proc and self.proc.poll() is None:
+            self.proc.terminate()
+            self.proc.wait()
+
+
+def pick_backend(requested):
+    if requested != "auto":
+        return requested
+    if shutil.which("Xvfb"):
+        return "xvfb"
+    if shutil.which("gtk4-broadwayd"):
+        return "broadway"
+    raise RuntimeError("neither Xvfb nor gtk4-broadwayd found in PATH")
+
+
+def start_session_bus():
+    """Private session bus so GApplication registration behaves normally."""
+    if not shutil.which("dbus-daemon"):
+        return None, None
+    proc = subprocess.Popen(
+        ["dbus-daemon", "--session", "--nofork", "--print-address=1"],
+        stdout=subprocess.PIPE, stderr=subprocess.DEVNULL, text=True)
+    address = proc.stdout.readline().strip()
+    return proc, address
+
+
+def read_trace(path):
+    marks = {}
+    try:
+        with open(path) as f:
+            for line in f:
+                parts = line.split()
+                if len(parts) == 2 and parts[0] not in marks:
+                    marks[parts[0]] = int(parts[1])
+    except FileNotFoundError:
+        pass
+    return marks
+
+
+def read_rss_kib(pid):
+    try:
+        with open(f"/proc/{pid}/status") as f:
+            for line in f:
+                if line.startswith("VmRSS:"):
+                    return int(line.split()[1])
+    except FileNotFoundError:
+        pass
+    return None
+
+
+def run_once(args, base_env, workdir, index):
+    trace = os.path.join(workdir, f"trace-{index}.txt")
+    env = dict(base_env)
+    env["GSR_STARTUP_TRACE"] = trace
+
+    launch = monotonic_usec()
+    proc = subprocess.Popen([args.app], env=env,
+                            stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+    try:
+        done = wait_for(lambda: "first_frame" in read_trace(trace) or proc.poll() is not None,
+                        args.timeout)
+        time.sleep(args.settle)
+        rss = read_rss_kib(proc.pid)
+    finally:
+        if proc.poll() is None:
+            proc.send_signal(signal.SIGTERM)
+            try:
+                proc.wait(timeout=5)
+            except subprocess.TimeoutExpired:
+                proc.kill()
+                proc.wait()
+
+    marks = read_trace(trace)
+    result = {name: (marks[name] - launch) / 1000.0 if name in marks else None
+              for name in MILESTONES}
+    result["rss_kib"] = rss
+    result["timed_out"] = not done
+    return result
+
+
+def summarise(runs, key):
+    values = [r[key] for r in runs if r[key] is not None]
+    if not values:
+        return None
+    return {
+        "min": min(values),
+        "median": statistics.median(values),
+        "max": max(values),
+        "n": len(values),
+    }
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--app", required=True, help="gpu-screen-recorder-adw executable")
+    parser.add_argument("--stub", required=True, help="fake gpu-screen-recorder script")
+    parser.add_argument("--backend", choices=("auto", "xvfb", "broadway"), default="auto")
+    parser.add_argument("--iterations", type=int, default=5)
+    parser.add_argument("--info-delay-ms", type=int, default=0)
+    parser.add_argument("--monitors", type=int, default=1)
+    parser.add_argument("--cards", type=int, default=1,
+                        help="DRM cards reported; above 1 each is probed once, then cached")
+    parser.add_argument("--audio-devices", type=int, default=2)
+    parser.add_argument("--timeout", type=float, default=30.0,
+                        help="seconds to wait for the first frame")
+    parser.add_argument("--settle", type=float, default=0.5,
+                        help="seconds to wait after the first frame before sampling RSS")
+    parser.add_argument("--output", help="write JSON results to this file")
+    args = parser.parse_args()
+
+    backend = Backend(pick_backend(args.backend))
+    bus_proc = None
+
+    with tempfile.TemporaryDirectory(prefix="gsr-bench-") as workdir:
+        bindir = os.path.join(workdir, "bin")
+        os.mkdir(bindir)
+        os.symlink(os.path.abspath(args.stub), os.path.join(bindir, "gpu-screen-recorder"))
+
+        env = dict(os.environ)
+        env.update({
+            "PATH": bindir + os.pathsep + env.get("PATH", ""),
+            "XDG_CONFIG_HOME": os.path.join(workdir, "config"),
+            "XDG_CACHE_HOME": os.path.join(workdir, "cache"),
+            "GSK_RENDERER": "cairo",
+            "GTK_A11Y": "none",
+            "NO_AT_BRIDGE": "1",
+            "GSR_FAKE_INFO_DELAY_MS": str(args.info_delay_ms),
+            "GSR_FAKE_MONITORS": str(args.monitors),
+            "GSR_FAKE_CARDS": str(args.cards),
+            "GSR_FAKE_AUDIO_DEVICES": str(args.audio_devices),
+        })
+        env.pop("WAYLAND_DISPLAY", None)
+
+        try:
+            backend.start()
+            env.update(backend.env)
+
+            bus_proc, bus_address = start_session_bus()
+            if bus_address:
+                env["DBUS_SESSION_BUS_ADDRESS"] = bus_address
+
+            runs = [run_once(args, env, workdir, i) for i in range(args.iterations)]
+        finally:
+            if bus_proc:
+                bus_proc.terminate()
+                bus_proc.wait()
+            backend.stop()
+
+    results = {
+        "backend": backend.kind,
+        "parameters": {
+            "iterations": args.iterations,
+            "info_delay_ms": args.info_delay_ms,
+            "monitors": args.monitors,
+            "cards": args.cards,
+            "audio_devices": args.audio_devices,
+        },
+        "units": {"milestones": "ms since launch", "rss": "KiB"},
+        "runs": runs,
+        "summary": {key: summarise(runs, key) for key in MILESTONES + ("rss_kib",)},
+    }
+
+    if args.output:
+        with open(args.output, "w") as f:
+            json.dump(results, f, indent=2)
+            f.write("\n")
+
+    for key, stats in results["summary"].items():
+        if stats is None:
+            print(f"{key:16s} n/a")
+        else:
+            print(f"{key:16s} min {stats['min']:10.1f}  median {stats['median']:10.1f}  "
+                  f"max {stats['max']:10.1f}")
+
+    return 1 if any(r["timed_out"] for r in runs) else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -2,6 +2,7 @@
 
 #include <errno.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include <gio/gio.h>
@@ -52,17 +53,99 @@ static void handle_shortcuts_data(GVariant *shortcuts, gsr_shortcut_callback cal
     }
 }
 
+/*
+ * Portal requests are asynchronous twice over: the method call returns a
+ * Request object path, and the real answer arrives later as a Response
+ * signal on that path.  Nothing here blocks the main loop.
+ *
+ * To not miss a fast Response, the signal is subscribed on the path the
+ * portal will use (derived from our unique name and handle_token) before
+ * the call goes out.  Old portals that pick a different path are handled
+ * by moving the subscription once the call returns.
+ *
+ * Every request is tracked in self->pending.  Deinit cancels in-flight
+ * calls and drops all subscriptions; a Response already queued may still
+ * be dispatched, so requests are refcounted: self->pending, the method
+ * call and the signal subscription each hold a reference, and a callback
+ * that finds req->self cleared does nothing.
+ */
+
+/* Bounds on the method call alone; the Response has no deadline */
+#define PORTAL_CALL_TIMEOUT_MS   5000
+/* Some portals only reply to BindShortcuts once their dialog closes */
+#define PORTAL_DIALOG_TIMEOUT_MS (2 * 60 * 1000)
+
+typedef enum {
+    REQUEST_CREATE_SESSION,
+    REQUEST_SHORTCUTS,      /* ListShortcuts / BindShortcuts */
+} request_type;
+
 typedef struct {
-    gsr_global_shortcuts *self;
-    gsr_shortcut_callback callback;
+    int ref_count;
+    gsr_global_shortcuts *self;    /* NULL once finished or detached */
+    request_type type;
+    const char *method;
+    char *request_path;
+    guint response_signal_id;
+    gsr_init_callback init_callback;
+    gsr_shortcut_callback shortcut_callback;
     void *userdata;
-} signal_list_bind_userdata;
+} portal_request;
+
+static portal_request *portal_request_ref(portal_request *req) {
+    ++req->ref_count;
+    return req;
+}
+
+static void portal_request_unref(portal_request *req) {
+    if(--req->ref_count > 0)
+        return;
+    g_free(req->request_path);
+    free(req);
+}
+
+/* The subscription's reference goes once GDBus is done with it */
+static void portal_request_unsubscribe(portal_request *req, GDBusConnection *con) {
+    if(req->response_signal_id) {
+        g_dbus_connection_signal_unsubscribe(con, req->response_signal_id);
+        req->response_signal_id = 0;
+    }
+}
+
+/* Detach from self and drop its reference */
+static void portal_request_finish(portal_request *req) {
+    gsr_global_shortcuts *self = req->self;
+    portal_request_unsubscribe(req, self->gdbus_con);
+    self->pending = g_list_remove(self->pending, req);
+    req->self = NULL;
+    portal_request_unref(req);
+}
+
+static void portal_request_fail(portal_request *req) {
+    if(req->type == REQUEST_CREATE_SESSION)
+        req->init_callback(false, req->userdata);
+    portal_request_finish(req);
+}
 
-static void dbus_signal_list_bind(GDBusProxy *proxy, gchar *sender_name, gchar *signal_name, GVariant *parameters, signal_list_bind_userdata *userdata) {
-    (void)proxy;
+static void on_portal_response(GDBusConnection *connection,
+                               const gchar     *sender_name,
+                               const gchar     *object_path,
+                               const gchar     *interface_name,
+                               const gchar     *signal_name,
+                               GVariant        *parameters,
+                               gpointer         userdata)
+{
+    (void)connection;
     (void)sender_name;
-    if(g_strcmp0(signal_name, "Response") != 0)
-        goto done;
+    (void)object_path;
+    (void)interface_name;
+    (void)signal_name;
+    portal_request *req = userdata;
+    gsr_global_shortcuts *self = req->self;
+
+    /* Queued before the request was finished or detached */
+    if(!self)
+        return;
 
     guint32 response = 0;
     GVariant *results = NULL;
@@ -70,21 +153,103 @@ static void dbus_signal_list_bind(GDBusProxy *proxy, gchar *sender_name, gchar *
 
     if(response != 0 || !results) {
         if(results) g_variant_unref(results);
-        goto done;
+        portal_request_fail(req);
+        return;
     }
 
-    GVariant *shortcuts = g_variant_lookup_value(results, "shortcuts", G_VARIANT_TYPE("a(sa{sv})"));
-    if(!shortcuts) {
-        g_variant_unref(results);
-        goto done;
+    if(req->type == REQUEST_CREATE_SESSION) {
+        gchar *session_handle = NULL;
+        if(g_variant_lookup(results, "session_handle", "s", &session_handle) && session_handle) {
+            self->session_handle = strdup(session_handle);
+            self->session_created = true;
+            req->init_callback(true, req->userdata);
+            g_free(session_handle);
+        } else {
+            req->init_callback(false, req->userdata);
+        }
+    } else {
+        GVariant *shortcuts = g_variant_lookup_value(results, "shortcuts", G_VARIANT_TYPE("a(sa{sv})"));
+        if(shortcuts) {
+            handle_shortcuts_data(shortcuts, req->shortcut_callback, req->userdata);
+            g_variant_unref(shortcuts);
+        }
     }
 
-    handle_shortcuts_data(shortcuts, userdata->callback, userdata->userdata);
-    g_variant_unref(shortcuts);
     g_variant_unref(results);
+    portal_request_finish(req);
+}
+
+static void portal_request_subscribe(portal_request *req, const char *path) {
+    gsr_global_shortcuts *self = req->self;
+    portal_request_unsubscribe(req, self->gdbus_con);
+    g_free(req->request_path);
+    req->request_path = g_strdup(path);
+    req->response_signal_id = g_dbus_connection_signal_subscribe(self->gdbus_con,
+        "org.freedesktop.portal.Desktop", "org.freedesktop.portal.Request", "Response",
+        req->request_path, NULL, G_DBUS_SIGNAL_FLAGS_NONE,
+        on_portal_response, portal_request_ref(req), (GDestroyNotify)portal_request_unref);
+}
+
+static void on_portal_call_done(GObject *source, GAsyncResult *result, gpointer userdata) {
+    portal_request *req = userdata;
+
+    GError *error = NULL;
+    GVariant *ret = g_dbus_connection_call_finish(G_DBUS_CONNECTION(source), result, &error);
+
+    /* Already answered, or deinit ran meanwhile */
+    if(!req->self) {
+        if(ret) g_variant_unref(ret);
+        g_clear_error(&error);
+        portal_request_unref(req);
+        return;
+    }
+
+    if(!ret) {
+        g_warning("gsr_global_shortcuts: %s failed: %s", req->method, error ? error->message : "unknown error");
+        g_clear_error(&error);
+        portal_request_fail(req);
+        portal_request_unref(req);
+        return;
+    }
 
-    done:
-    free(userdata);
+    const gchar *path = NULL;
+    g_variant_get(ret, "(&o)", &path);
+    if(path && g_strcmp0(path, req->request_path) != 0)
+        portal_request_subscribe(req, path);
+    g_variant_unref(ret);
+    portal_request_unref(req);
+}
+
+/*
+ * Takes ownership of req and of the (floating) parameters.  Returns false
+ * if nothing was sent.  timeout_ms only bounds the method call itself;
+ * the Response may come much later (e.g. after a user dialog).
+ */
+static bool portal_request_start(gsr_global_shortcuts *self, portal_request *req, const char *handle_token, GVariant *parameters, int timeout_ms) {
+    const char *unique_name = g_dbus_connection_get_unique_name(self->gdbus_con);
+    if(!unique_name) {
+        g_variant_unref(g_variant_ref_sink(parameters));
+        free(req);
+        return false;
+    }
+
+    /* :1.42 → 1_42 */
+    char *sender = g_strdup(unique_name[0] == ':' ? unique_name + 1 : unique_name);
+    g_strdelimit(sender, ".", '_');
+    char *expected_path = g_strdup_printf("/org/freedesktop/portal/desktop/request/%s/%s", sender, handle_token);
+    g_free(sender);
+
+    /* This first reference belongs to self->pending */
+    req->ref_count = 1;
+    req->self = self;
+    self->pending = g_list_prepend(self->pending, req);
+    portal_request_subscribe(req, expected_path);
+    g_free(expected_path);
+
+    g_dbus_connection_call(self->gdbus_con, "org.freedesktop.portal.Desktop", "/org/freedesktop/portal/desktop",
+        "org.freedesktop.portal.GlobalShortcuts", req->method, parameters, G_VARIANT_TYPE("(o)"),
+        G_DBUS_CALL_FLAGS_NO_AUTO_START, timeout_ms, self->cancellable, on_portal_call_done, portal_request_ref(req));
+    return true;
 }
 
 typedef struct {
@@ -119,7 +284,7 @@ static void signal_callback(GDBusConnection *connection,
         g_variant_get(parameters, "(ost@a{sv})", &session_handle, &shortcut_id, &timestamp, &options);
 
         if(session_handle && shortcut_id && g_strcmp0(session_handle, cu->self->session_handle) == 0)
-            cu->deactivated_callback(shortcut_id, cu->userdata);
+            cu->deactivated_callback(shortcut_id, timestamp, cu->userdata);
 
         g_free(session_handle);
         g_free(shortcut_id);
@@ -137,84 +302,64 @@ static void signal_callback(GDBusConnection *connection,
     }
 }
 
-typedef struct {
-    gsr_global_shortcuts *self;
-    gsr_init_callback callback;
-    void *userdata;
-} signal_create_session_userdata;
-
-static void dbus_signal_create_session(GDBusProxy *proxy, gchar *sender_name, gchar *signal_name, GVariant *parameters, signal_create_session_userdata *cu) {
-    (void)proxy;
-    (void)sender_name;
-    if(g_strcmp0(signal_name, "Response") != 0)
-        goto done;
-
-    guint32 response = 0;
-    GVariant *results = NULL;
-    g_variant_get(parameters, "(u@a{sv})", &response, &results);
-
-    if(response != 0 || !results) {
-        cu->callback(false, cu->userdata);
-        if(results) g_variant_unref(results);
-        goto done;
-    }
-
-    gchar *session_handle = NULL;
-    if(g_variant_lookup(results, "session_handle", "s", &session_handle) && session_handle) {
-        cu->self->session_handle = strdup(session_handle);
-        cu->self->session_created = true;
-        cu->callback(true, cu->userdata);
-        g_free(session_handle);
-    } else {
-        cu->callback(false, cu->userdata);
-    }
-    g_variant_unref(results);
-
-    done:
-    free(cu);
-}
-
 static bool gsr_global_shortcuts_create_session(gsr_global_shortcuts *self, gsr_init_callback callback, void *userdata) {
     char handle_token[128];
     gsr_dbus_portal_get_unique_handle_token(self, handle_token, sizeof(handle_token));
 
     char session_handle_token[128];
     snprintf(session_handle_token, sizeof(session_handle_token), "gpu_screen_recorder_adwaita_%s", self->random_str);
-    
+
     GVariantBuilder builder;
     g_variant_builder_init(&builder, G_VARIANT_TYPE("a{sv}"));
     g_variant_builder_add(&builder, "{sv}", "handle_token", g_variant_new_string(handle_token));
     g_variant_builder_add(&builder, "{sv}", "session_handle_token", g_variant_new_string(session_handle_token));
     GVariant *aa = g_variant_builder_end(&builder);
 
-    GVariant *ret = g_dbus_connection_call_sync(self->gdbus_con, "org.freedesktop.portal.Desktop", "/org/freedesktop/portal/desktop", "org.freedesktop.portal.GlobalShortcuts", "CreateSession", g_variant_new_tuple(&aa, 1), NULL, G_DBUS_CALL_FLAGS_NO_AUTO_START, 1000, NULL, NULL);
-
-    if(ret) {
-        const gchar *val = NULL;
-        g_variant_get(ret, "(&o)", &val);
-        if(!val) {
-            g_variant_unref(ret);
-            return false;
-        }
+    portal_request *req = calloc(1, sizeof(portal_request));
+    if(!req) {
+        g_variant_unref(g_variant_ref_sink(aa));
+        return false;
+    }
+    req->type = REQUEST_CREATE_SESSION;
+    req->method = "CreateSession";
+    req->init_callback = callback;
+    req->userdata = userdata;
+    return portal_request_start(self, req, handle_token, g_variant_new_tuple(&aa, 1), PORTAL_CALL_TIMEOUT_MS);
+}
 
-        GDBusProxy *proxy = g_dbus_proxy_new_for_bus_sync(G_BUS_TYPE_SESSION, G_DBUS_PROXY_FLAGS_DO_NOT_AUTO_START, NULL, "org.freedesktop.portal.Desktop", val, "org.freedesktop.portal.Request", NULL, NULL);
-        g_variant_unref(ret);
-        if(!proxy)
-            return false;
+typedef struct {
+    gsr_global_shortcuts *self;
+    gsr_init_callback callback;
+    void *userdata;
+} bus_get_userdata;
+
+static void on_bus_get_done(GObject *source, GAsyncResult *result, gpointer userdata) {
+    (void)source;
+    bus_get_userdata *bu = userdata;
+    GError *error = NULL;
+    GDBusConnection *con = g_bus_get_finish(result, &error);
+
+    if(g_error_matches(error, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+        /* Deinit already ran; self may be gone */
+        g_clear_error(&error);
+        if(con) g_object_unref(con);
+        free(bu);
+        return;
+    }
 
-        signal_create_session_userdata *cu = malloc(sizeof(signal_create_session_userdata));
-        if(!cu) {
-            g_object_unref(proxy);
-            return false;
-        }
-        cu->self = self;
-        cu->callback = callback;
-        cu->userdata = userdata;
-        g_signal_connect(proxy, "g-signal", G_CALLBACK(dbus_signal_create_session), cu);
-        return true;
-    } else {
-        return false;
+    gsr_global_shortcuts *self = bu->self;
+    if(!con) {
+        g_warning("gsr_global_shortcuts_init: g_bus_get failed: %s", error ? error->message : "unknown error");
+        g_clear_error(&error);
+        bu->callback(false, bu->userdata);
+        free(bu);
+        return;
     }
+
+    self->gdbus_con = con;
+    if(!gsr_global_shortcuts_create_session(self, bu->callback, bu->userdata))
+        bu->callback(false, bu->userdata);
+    free(bu);
 }
 
 bool gsr_global_shortcuts_init(gsr_global_shortcuts *self, gsr_init_callback callback, void *userdata) {
@@ -226,27 +371,54 @@ bool gsr_global_shortcuts_init(gsr_global_shortcuts *self, gsr_init_callback cal
         return false;
     }
 
-    self->gdbus_con = g_bus_get_sync(G_BUS_TYPE_SESSION, NULL, NULL);
-    if(!self->gdbus_con) {
-        g_warning("gsr_global_shortcuts_init: g_bus_get_sync failed");
-        return false;
-    }
-
-    if(!gsr_global_shortcuts_create_session(self, callback, userdata)) {
-        gsr_global_shortcuts_deinit(self);
+    bus_get_userdata *bu = malloc(sizeof(bus_get_userdata));
+    if(!bu)
         return false;
-    }
+    bu->self = self;
+    bu->callback = callback;
+    bu->userdata = userdata;
 
+    /* The result (session created or not) is reported through callback */
+    self->cancellable = g_cancellable_new();
+    g_bus_get(G_BUS_TYPE_SESSION, self->cancellable, on_bus_get_done, bu);
     return true;
 }
 
 void gsr_global_shortcuts_deinit(gsr_global_shortcuts *self) {
+    if(self->cancellable) {
+        g_cancellable_cancel(self->cancellable);
+        g_clear_object(&self->cancellable);
+    }
+
+    /* Cancelled calls and dropped subscriptions release their own references */
+    for(GList *l = self->pending; l; l = l->next) {
+        portal_request *req = l->data;
+        portal_request_unsubscribe(req, self->gdbus_con);
+        req->self = NULL;
+        portal_request_unref(req);
+    }
+    g_clear_pointer(&self->pending, g_list_free);
+
+    if(self->gdbus_con && self->activated_signal_id) {
+        g_dbus_connection_signal_unsubscribe(self->gdbus_con, self->activated_signal_id);
+        self->activated_signal_id = 0;
+    }
+
+    /* The bus connection is shared with the rest of the app and outlives
+       us, so close the portal session explicitly (fire and forget) */
+    if(self->gdbus_con && self->session_handle) {
+        g_dbus_connection_call(self->gdbus_con, "org.freedesktop.portal.Desktop", self->session_handle,
+            "org.freedesktop.portal.Session", "Close", NULL, NULL,
+            G_DBUS_CALL_FLAGS_NO_AUTO_START, -1, NULL, NULL, NULL);
+    }
+
     g_clear_object(&self->gdbus_con);
 
     if(self->session_handle) {
         free(self->session_handle);
         self->session_handle = NULL;
     }
+    self->session_created = false;
 }
 
 bool gsr_global_shortcuts_list_shortcuts(gsr_global_shortcuts *self, gsr_shortcut_callback callback, void *userdata) {
@@ -265,33 +437,16 @@ bool gsr_global_shortcuts_list_shortcuts(gsr_global_shortcuts *self, gsr_shortcu
 
     GVariant *args[2] = { session_handle_obj, aa };
 
-    GVariant *ret = g_dbus_connection_call_sync(self->gdbus_con, "org.freedesktop.portal.Desktop", "/org/freedesktop/portal/desktop", "org.freedesktop.portal.GlobalShortcuts", "ListShortcuts", g_variant_new_tuple(args, 2), NULL, G_DBUS_CALL_FLAGS_NO_AUTO_START, 1000, NULL, NULL);
-    if(ret) {
-        const gchar *val = NULL;
-        g_variant_get(ret, "(&o)", &val);
-        if(!val) {
-            g_variant_unref(ret);
-            return false;
-        }
-
-        GDBusProxy *proxy = g_dbus_proxy_new_for_bus_sync(G_BUS_TYPE_SESSION, G_DBUS_PROXY_FLAGS_DO_NOT_AUTO_START, NULL, "org.freedesktop.portal.Desktop", val, "org.freedesktop.portal.Request", NULL, NULL);
-        g_variant_unref(ret);
-        if(!proxy)
-            return false;
-
-        signal_list_bind_userdata *cu = malloc(sizeof(signal_list_bind_userdata));
-        if(!cu) {
-            g_object_unref(proxy);
-            return false;
-        }
-        cu->self = self;
-        cu->callback = callback;
-        cu->userdata = userdata;
-        g_signal_connect(proxy, "g-signal", G_CALLBACK(dbus_signal_list_bind), cu);
-        return true;
-    } else {
+    portal_request *req = calloc(1, sizeof(portal_request));
+    if(!req) {
+        g_variant_unref(g_variant_ref_sink(g_variant_new_tuple(args, 2)));
         return false;
     }
+    req->type = REQUEST_SHORTCUTS;
+    req->method = "ListShortcuts";
+    req->shortcut_callback = callback;
+    req->userdata = userdata;
+    return portal_request_start(self, req, handle_token, g_variant_new_tuple(args, 2), PORTAL_CALL_TIMEOUT_MS);
 }
 
 bool gsr_global_shortcuts_bind_shortcuts(gsr_global_shortcuts *self, const gsr_bind_shortcut *shortcuts, int num_shortcuts, gsr_shortcut_callback callback, void *userdata) {
@@ -325,33 +480,16 @@ bool gsr_global_shortcuts_bind_shortcuts(gsr_global_shortcuts *self, const gsr_b
     GVariant *parent_window = g_variant_new_string("");
     GVariant *args[4] = { session_handle_obj, aa, parent_window, bb };
 
-    GVariant *ret = g_dbus_connection_call_sync(self->gdbus_con, "org.freedesktop.portal.Desktop", "/org/freedesktop/portal/desktop", "org.freedesktop.portal.GlobalShortcuts", "BindShortcuts", g_variant_new_tuple(args, 4), NULL, G_DBUS_CALL_FLAGS_NO_AUTO_START, -1, NULL, NULL);
-    if(ret) {
-        const gchar *val = NULL;
-        g_variant_get(ret, "(&o)", &val);
-        if(!val) {
-            g_variant_unref(ret);
-            return false;
-        }
-
-        GDBusProxy *proxy = g_dbus_proxy_new_for_bus_sync(G_BUS_TYPE_SESSION, G_DBUS_PROXY_FLAGS_DO_NOT_AUTO_START, NULL, "org.freedesktop.portal.Desktop", val, "org.freedesktop.portal.Request", NULL, NULL);
-        g_variant_unref(ret);
-        if(!proxy)
-            return false;
-
-        signal_list_bind_userdata *cu = malloc(sizeof(signal_list_bind_userdata));
-        if(!cu) {
-            g_object_unref(proxy);
-            return false;
-        }
-        cu->self = self;
-        cu->callback = callback;
-        cu->userdata = userdata;
-        g_signal_connect(proxy, "g-signal", G_CALLBACK(dbus_signal_list_bind), cu);
-        return true;
-    } else {
+    portal_request *req = calloc(1, sizeof(portal_request));
+    if(!req) {
+        g_variant_unref(g_variant_ref_sink(g_variant_new_tuple(args, 4)));
         return false;
     }
+    req->type = REQUEST_SHORTCUTS;
+    req->method = "BindShortcuts";
+    req->shortcut_callback = callback;
+    req->userdata = userdata;
+    return portal_request_start(self, req, handle_token, g_variant_new_tuple(args, 4), PORTAL_DIALOG_TIMEOUT_MS);
 }
 
 bool gsr_global_shortcuts_subscribe_activated_signal(gsr_global_shortcuts *self, gsr_deactivated_callback deactivated_callback, gsr_shortcut_callback shortcut_changed_callback, void *userdata) {
@@ -359,10 +497,14 @@ bool gsr_global_shortcuts_subscribe_activated_signal(gsr_global_shortcuts *self,
         return false;
 
     signal_userdata *cu = malloc(sizeof(signal_userdata));
+    if(!cu)
+        return false;
     cu->self = self;
     cu->deactivated_callback = deactivated_callback;
     cu->shortcut_changed_callback = shortcut_changed_callback;
     cu->userdata = userdata;
-    g_dbus_connection_signal_subscribe(self->gdbus_con, "org.freedesktop.portal.Desktop", "org.freedesktop.portal.GlobalShortcuts", NULL, "/org/freedesktop/portal/desktop", NULL, G_DBUS_SIGNAL_FLAGS_NONE, signal_callback, cu, free);
+    if(self->activated_signal_id)
+        g_dbus_connection_signal_unsubscribe(self->gdbus_con, self->activated_signal_id);
+    self->activated_signal_id = g_dbus_connection_signal_subscribe(self->gdbus_con, "org.freedesktop.portal.Desktop", "org.freedesktop.portal.GlobalShortcuts", NULL, "/org/freedesktop/portal/desktop", NULL, G_DBUS_SIGNAL_FLAGS_NONE, signal_callback, cu, free);
     return true;
 }
@@ -3,6 +3,7 @@
 /* Global shortcuts via desktop portal */
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <gio/gio.h>
 
 #define DBUS_RANDOM_STR_SIZE 16
@@ -19,7 +20,8 @@ typedef struct {
 
 typedef void (*gsr_init_callback)(bool success, void *userdata);
 typedef void (*gsr_shortcut_callback)(gsr_shortcut shortcut, void *userdata);
-typedef void (*gsr_deactivated_callback)(const char *id, void *userdata);
+/* timestamp is the portal's event time in milliseconds */
+typedef void (*gsr_deactivated_callback)(const char *id, uint64_t timestamp, void *userdata);
 
 typedef struct {
     GDBusConnection *gdbus_con;
@@ -27,8 +29,18 @@ typedef struct {
     bool session_created;
     char random_str[DBUS_RANDOM_STR_SIZE + 1];
     unsigned int handle_counter;
+    GCancellable *cancellable;      /* cancelled by deinit */
+    GList *pending;                 /* outstanding portal requests */
+    guint activated_signal_id;
 } gsr_global_shortcuts;
 
+/*
+ * All calls are asynchronous and never block the main loop.  init returns
+ * true if session creation was started; the outcome arrives through
+ * callback.  list/bind return true if the request was sent.  deinit may
+ * be called at any time (also on a zeroed struct) and guarantees no
+ * callback runs afterwards.
+ */
 bool gsr_global_shortcuts_init(gsr_global_shortcuts *self, gsr_init_callback callback, void *userdata);
 void gsr_global_shortcuts_deinit(gsr_global_shortcuts *self);
 
@@ -0,0 +1,115 @@
+#include "gsr-child-output.h"
+
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <glib-unix.h>
+
+/* A line longer than this is delivered in pieces */
+#define MAX_LINE_LENGTH 4096
+
+struct _GsrChildOutput {
+    int                    fd;
+    guint                  source_id;
+    GString               *pending;    /* partial last line */
+    GsrChildOutputLineFunc callback;
+    gpointer               user_data;
+};
+
+/* ── Reading ─────────────────────────────────────────────────────── */
+
+static void
+deliver_lines(GsrChildOutput *self)
+{
+    char *start = self->pending->str;
+    char *nl;
+    while ((nl = memchr(start, '\n', self->pending->len - (gsize)(start - self->pending->str)))) {
+        *nl = '\0';
+        if (nl > start && nl[-1] == '\r')
+            nl[-1] = '\0';
+        self->callback(start, self->user_data);
+        start = nl + 1;
+    }
+    g_string_erase(self->pending, 0, start - self->pending->str);
+
+    if (self->pending->len >= MAX_LINE_LENGTH) {
+        self->callback(self->pending->str, self->user_data);
+        g_string_truncate(self->pending, 0);
+    }
+}
+
+/* Returns FALSE on EOF or a read error */
+static gboolean
+read_available(GsrChildOutput *self)
+{
+    char buf[4096];
+    for (;;) {
+        ssize_t n = read(self->fd, buf, sizeof(buf));
+        if (n > 0) {
+            g_string_append_len(self->pending, buf, n);
+            deliver_lines(self);
+            continue;
+        }
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            return TRUE;
+        return FALSE;
+    }
+}
+
+static gboolean
+on_fd_ready(gint fd G_GNUC_UNUSED, GIOCondition condition, gpointer user_data)
+{
+    GsrChildOutput *self = user_data;
+
+    if (read_available(self) && !(condition & (G_IO_HUP | G_IO_ERR)))
+        return G_SOURCE_CONTINUE;
+
+    self->source_id = 0;
+    return G_SOURCE_REMOVE;
+}
+
+/* ── Public API ──────────────────────────────────────────────────── */
+
+GsrChildOutput *
+gsr_child_output_new(int fd, GsrChildOutputLineFunc callback, gpointer user_data)
+{
+    GsrChildOutput *self = g_new0(GsrChildOutput, 1);
+    self->fd = fd;
+    self->pending = g_string_new(NULL);
+    self->callback = callback;
+    self->user_data = user_data;
+
+    g_unix_set_fd_nonblocking(fd, TRUE, NULL);
+    self->source_id = g_unix_fd_add(fd, G_IO_IN | G_IO_HUP | G_IO_ERR,
+                                    on_fd_ready, self);
+    return self;
+}
+
+void
+gsr_child_output_flush(GsrChildOutput *self)
+{
+    if (!self || self->fd < 0)
+        return;
+
+    read_available(self);
+    if (self->pending->len > 0) {
+        self->callback(self->pending->str, self->user_data);
+        g_string_truncate(self->pending, 0);
+    }
+}
+
+void
+gsr_child_output_free(GsrChildOutput *self)
+{
+    if (!self)
+        return;
+
+    g_clear_handle_id(&self->source_id, g_source_remove);
+    if (self->fd >= 0)
+        close(self->fd);
+    g_string_free(self->pending, TRUE);
+    g_free(self);
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+/*
+ * gsr-child-output.h — Line reader for a child process's stdout/stderr.
+ *
+ * Watches the read end of a pipe from the main loop and hands each
+ * complete line (without the newline) to a callback.  The fd is made
+ * non-blocking and owned by the reader.
+ */
+
+#include <glib.h>
+
+typedef void (*GsrChildOutputLineFunc)(const char *line, gpointer user_data);
+
+typedef struct _GsrChildOutput GsrChildOutput;
+
+/**
+ * Start reading lines from fd.  Takes ownership of fd.
+ */
+GsrChildOutput *gsr_child_output_new  (int                    fd,
+                                       GsrChildOutputLineFunc callback,
+                                       gpointer               user_data);
+
+/**
+ * Read whatever is still in the pipe and deliver it, including a last
+ * line without a trailing newline.  Call after the child was reaped,
+ * since its final output may not have been dispatched yet.
+ */
+void            gsr_child_output_flush(GsrChildOutput *self);
+
+/**
+ * Stop watching and close the fd.  No callbacks happen after this.
+ */
+void            gsr_child_output_free (GsrChildOutput *self);
@@ -1,5 +1,9 @@
 #include "gsr-config-page.h"
 #ifdef HAVE_X11
+#include "gsr-window.h"
+#include "gsr-window-chooser-dialog.h"
+#include "gsr-x11-window-list.h"
+#include "gsr-x11-preview.h"
 #include "gsr-x11-window-picker.h"
 #endif
 
@@ -8,7 +12,7 @@
 /* ═══════════════════════════════════════════════════════════════════
  *  GsrConfigPage — "Config" tab
  *
- *  Groups:  Capture Target · Audio · Video · Notifications
+ *  Groups:  Capture Target · Audio · Video · Notifications · Hotkeys
  *  All widgets are built programmatically from GsrInfo data.
  * ═══════════════════════════════════════════════════════════════════ */
 
@@ -38,6 +42,23 @@ struct _GsrConfigPage {
     unsigned long        selected_window_id;   /* X11 Window, 0 = none */
     char                *selected_window_name; /* owned, or NULL */
     GsrX11WindowPicker  *active_picker;        /* non-NULL during pick */
+    GsrX11WindowList    *window_list;          /* cached clients, NULL if no display */
+    GsrWindowChooserDialog *window_chooser;    /* weak, non-NULL while open */
+
+    /* X11 region picker, shares active_picker */
+    AdwActionRow        *select_region_row;
+    int                  region_x;
+    int                  region_y;
+    int                  region_width;         /* 0 = none */
+    int                  region_height;
+
+    /* Live preview of the target, paused while hidden or capturing */
+    GsrX11Preview       *preview;              /* NULL without MIT-SHM */
+    GtkWidget           *preview_box;
+    GtkPicture          *preview_picture;
+    GtkLabel            *preview_cost_label;
+    gboolean             preview_mapped;
+    gboolean             session_active;
 #endif
 
     /* ── Audio group ─── */
@@ -52,6 +73,7 @@ struct _GsrConfigPage {
 
     /* ── Video group ─── */
     AdwPreferencesGroup *video_group;
+    AdwComboRow         *gpu_card_row;        /* NULL with a single card */
     AdwComboRow         *quality_row;
     AdwSpinRow          *bitrate_row;
     AdwComboRow         *video_codec_row;
@@ -69,6 +91,12 @@ struct _GsrConfigPage {
     AdwSwitchRow        *notify_started_row;
     AdwSwitchRow        *notify_stopped_row;
     AdwSwitchRow        *notify_saved_row;
+
+#ifdef HAVE_X11
+    /* ── Hotkeys group (X11, advanced) ─── */
+    AdwPreferencesGroup *hotkeys_group;
+    AdwComboRow         *hotkey_backend_row;
+#endif
 };
 
 G_DEFINE_FINAL_TYPE(GsrConfigPage, gsr_config_page, ADW_TYPE_PREFERENCES_PAGE)
@@ -89,6 +117,10 @@ ids_array_append(char ***ids, int *n, int *cap, const char *id)
 
 /* ── Capture Target ──────────────────────────────────────────────── */
 
+#ifdef HAVE_X11
+static void update_preview_target(GsrConfigPage *self);
+#endif
+
 static void
 on_record_area_changed(GObject *obj, GParamSpec *pspec G_GNUC_UNUSED, gpointer user_data)
 {
@@ -119,6 +151,11 @@ on_record_area_changed(GObject *obj, GParamSpec *pspec G_GNUC_UNUSED, gpointer u
     /* "Select window..." row */
     gboolean is_window = g_str_equal(id, "window");
     gtk_widget_set_visible(GTK_WIDGET(self->select_window_row), is_window);
+
+    /* "Select region..." row */
+    gtk_widget_set_visible(GTK_WIDGET(self->select_region_row), g_str_equal(id, "region"));
+
+    update_preview_target(self);
 #endif
 }
 
@@ -141,6 +178,21 @@ on_change_resolution_toggled(GObject *obj, GParamSpec *pspec G_GNUC_UNUSED, gpoi
 /* ── Window picker callback & handler ────────────────────────────── */
 
 #ifdef HAVE_X11
+static void
+set_selected_window(GsrConfigPage *self, unsigned long window, const char *name)
+{
+    /* Store the selected window */
+    g_free(self->selected_window_name);
+    self->selected_window_id = window;
+    self->selected_window_name = g_strdup(name);
+
+    /* Update the row subtitle */
+    g_autofree char *subtitle = g_strdup_printf("%s (0x%lx)",
+        name && name[0] ? name : _("(no name)"), window);
+    adw_action_row_set_subtitle(self->select_window_row, subtitle);
+    update_preview_target(self);
+}
+
 static void
 on_window_picked(const GsrX11WindowPickResult *result, void *userdata)
 {
@@ -152,16 +204,7 @@ on_window_picked(const GsrX11WindowPickResult *result, void *userdata)
         return;
     }
 
-    /* Store the selected window */
-    g_free(self->selected_window_name);
-    self->selected_window_id = (unsigned long)result->window;
-    self->selected_window_name = g_strdup(result->name);
-
-    /* Update the row subtitle */
-    g_autofree char *subtitle = g_strdup_printf("%s (0x%lx)",
-        result->name ? result->name : _("(no name)"),
-        (unsigned long)result->window);
-    adw_action_row_set_subtitle(self->select_window_row, subtitle);
+    set_selected_window(self, (unsigned long)result->window, result->name);
 }
 
 static void
@@ -185,6 +228,159 @@ on_select_window_activated(AdwActionRow *row G_GNUC_UNUSED, gpointer user_data)
             _("Failed to grab pointer"));
     }
 }
+
+static void
+on_window_chosen(GsrWindowChooserDialog *dialog, gpointer user_data)
+{
+    GsrConfigPage *self = GSR_CONFIG_PAGE(user_data);
+    set_selected_window(self, gsr_window_chooser_dialog_get_window(dialog),
+                        gsr_window_chooser_dialog_get_window_name(dialog));
+}
+
+static void
+on_window_list_changed(GsrX11WindowList *list, gpointer user_data)
+{
+    GsrConfigPage *self = GSR_CONFIG_PAGE(user_data);
+    if (self->window_chooser)
+        gsr_window_chooser_dialog_update(self->window_chooser, list);
+}
+
+static void
+on_choose_window_clicked(GtkButton *button G_GNUC_UNUSED, gpointer user_data)
+{
+    GsrConfigPage *self = GSR_CONFIG_PAGE(user_data);
+    if (self->window_chooser)
+        return;
+
+    self->window_chooser = gsr_window_chooser_dialog_new(self->window_list);
+    g_object_add_weak_pointer(G_OBJECT(self->window_chooser),
+                              (gpointer *)&self->window_chooser);
+    g_signal_connect_object(self->window_chooser, "window-chosen",
+        G_CALLBACK(on_window_chosen), self, 0);
+    adw_dialog_present(ADW_DIALOG(self->window_chooser), GTK_WIDGET(self));
+}
+
+/* ── Live preview ─── */
+
+#define PREVIEW_WIDTH   320
+#define PREVIEW_HEIGHT  180
+
+static void
+on_preview_frame(GdkTexture *frame, gpointer user_data)
+{
+    GsrConfigPage *self = GSR_CONFIG_PAGE(user_data);
+    gtk_picture_set_paintable(self->preview_picture, GDK_PAINTABLE(frame));
+
+    double ms, cpu;
+    if (gsr_x11_preview_get_cost(self->preview, &ms, &cpu)) {
+        g_autofree char *text = g_strdup_printf(_("Preview: %.1f ms per frame, %.1f%% CPU"),
+                                                ms, cpu);
+        gtk_label_set_text(self->preview_cost_label, text);
+    }
+}
+
+static void
+update_preview_running(GsrConfigPage *self)
+{
+    if (self->preview)
+        gsr_x11_preview_set_running(self->preview,
+                                    self->preview_mapped && !self->session_active);
+}
+
+static void
+on_preview_map(GtkWidget *widget G_GNUC_UNUSED, gpointer user_data)
+{
+    GsrConfigPage *self = GSR_CONFIG_PAGE(user_data);
+    self->preview_mapped = TRUE;
+    update_preview_running(self);
+}
+
+static void
+on_preview_unmap(GtkWidget *widget G_GNUC_UNUSED, gpointer user_data)
+{
+    GsrConfigPage *self = GSR_CONFIG_PAGE(user_data);
+    self->preview_mapped = FALSE;
+    update_preview_running(self);
+}
+
+/* Follow the record area; hidden when there's nothing to show yet */
+static void
+update_preview_target(GsrConfigPage *self)
+{
+    if (!self->preview)
+        return;
+
+    const char *id = gsr_config_page_get_record_area_id(self);
+    gboolean shown;
+    if (g_str_equal(id, "window")) {
+        shown = self->selected_window_id != 0;
+        gsr_x11_preview_show_window(self->preview, self->selected_window_id);
+    } else if (g_str_equal(id, "region")) {
+        shown = self->region_width > 0 && self->region_height > 0;
+        gsr_x11_preview_show_region(self->preview, self->region_x, self->region_y,
+                                    self->region_width, self->region_height);
+    } else {
+        shown = gsr_x11_preview_show_monitor(self->preview, id);
+        if (!shown)
+            gsr_x11_preview_show_nothing(self->preview);
+    }
+
+    if (!shown)
+        gtk_picture_set_paintable(self->preview_picture, NULL);
+    gtk_widget_set_visible(self->preview_box, shown);
+}
+
+static void
+update_region_subtitle(GsrConfigPage *self)
+{
+    if (self->region_width <= 0 || self->region_height <= 0) {
+        adw_action_row_set_subtitle(self->select_region_row,
+            _("Drag a rectangle, or click a window"));
+        return;
+    }
+    g_autofree char *subtitle = g_strdup_printf(_("%d×%d at %d, %d"),
+        self->region_width, self->region_height, self->region_x, self->region_y);
+    adw_action_row_set_subtitle(self->select_region_row, subtitle);
+}
+
+static void
+on_region_picked(const GsrX11RegionPickResult *result, void *userdata)
+{
+    GsrConfigPage *self = GSR_CONFIG_PAGE(userdata);
+    self->active_picker = NULL; /* picker self-destructs after callback */
+
+    if (result->width <= 0 || result->height <= 0) {
+        /* Cancelled — keep previous region (if any) */
+        return;
+    }
+
+    self->region_x = result->x;
+    self->region_y = result->y;
+    self->region_width = result->width;
+    self->region_height = result->height;
+    update_region_subtitle(self);
+    update_preview_target(self);
+}
+
+static void
+on_select_region_activated(AdwActionRow *row G_GNUC_UNUSED, gpointer user_data)
+{
+    GsrConfigPage *self = GSR_CONFIG_PAGE(user_data);
+
+    if (self->info->system_info.display_server != GSR_DISPLAY_SERVER_X11)
+        return;
+
+    if (self->active_picker) {
+        gsr_x11_window_picker_free(self->active_picker);
+        self->active_picker = NULL;
+    }
+
+    self->active_picker = gsr_x11_region_picker_new(on_region_picked, self);
+    if (!self->active_picker) {
+        adw_action_row_set_subtitle(self->select_region_row,
+            _("Failed to grab pointer"));
+    }
+}
 #endif /* HAVE_X11 */
 
 static void
@@ -213,6 +409,13 @@ build_capture_group(GsrConfigPage *self)
         gtk_string_list_append(self->record_area_model, _("Focused window"));
         ids_array_append(&self->record_area_ids, &self->n_record_area_ids, &cap, "focused");
     }
+
+    /* "Region" — X11 only, picked with a rubber band */
+    if (info->system_info.display_server == GSR_DISPLAY_SERVER_X11 &&
+        info->supported_capture_options.region) {
+        gtk_string_list_append(self->record_area_model, _("Region"));
+        ids_array_append(&self->record_area_ids, &self->n_record_area_ids, &cap, "region");
+    }
 #endif
 
     /* Monitors */
@@ -263,11 +466,39 @@ build_capture_group(GsrConfigPage *self)
     adw_action_row_add_suffix(self->select_window_row, GTK_WIDGET(pick_icon));
     g_signal_connect(self->select_window_row, "activated",
         G_CALLBACK(on_select_window_activated), self);
+
+    /* Searchable list, kept current from X events so it opens at once */
+    if (info->system_info.display_server == GSR_DISPLAY_SERVER_X11)
+        self->window_list = gsr_x11_window_list_new();
+    if (self->window_list) {
+        gsr_x11_window_list_set_changed_func(self->window_list, on_window_list_changed, self);
+        GtkButton *choose_btn = GTK_BUTTON(gtk_button_new_from_icon_name("view-list-symbolic"));
+        gtk_widget_set_tooltip_text(GTK_WIDGET(choose_btn), _("Choose from a list"));
+        gtk_widget_set_valign(GTK_WIDGET(choose_btn), GTK_ALIGN_CENTER);
+        gtk_widget_add_css_class(GTK_WIDGET(choose_btn), "flat");
+        g_signal_connect(choose_btn, "clicked", G_CALLBACK(on_choose_window_clicked), self);
+        adw_action_row_add_suffix(self->select_window_row, GTK_WIDGET(choose_btn));
+    }
     gtk_widget_set_visible(GTK_WIDGET(self->select_window_row), FALSE);
     self->selected_window_id = 0;
     self->selected_window_name = NULL;
     self->active_picker = NULL;
     adw_preferences_group_add(self->capture_group, GTK_WIDGET(self->select_window_row));
+
+    /* "Select region..." row (shown when record area = "region") */
+    self->select_region_row = ADW_ACTION_ROW(adw_action_row_new());
+    adw_preferences_row_set_title(ADW_PREFERENCES_ROW(self->select_region_row),
+        _("Select region..."));
+    gtk_list_box_row_set_activatable(GTK_LIST_BOX_ROW(self->select_region_row), TRUE);
+    GtkImage *region_icon = GTK_IMAGE(gtk_image_new_from_icon_name("find-location-symbolic"));
+    adw_action_row_add_suffix(self->select_region_row, GTK_WIDGET(region_icon));
+    g_signal_connect(self->select_region_row, "activated",
+        G_CALLBACK(on_select_region_activated), self);
+    gtk_widget_set_visible(GTK_WIDGET(self->select_region_row), FALSE);
+    self->region_width = 0;
+    self->region_height = 0;
+    update_region_subtitle(self);
+    adw_preferences_group_add(self->capture_group, GTK_WIDGET(self->select_region_row));
 #endif /* HAVE_X11 */
 
     /* Change video resolution */
@@ -313,6 +544,35 @@ build_capture_group(GsrConfigPage *self)
     gtk_widget_set_visible(GTK_WIDGET(self->restore_portal_row), FALSE);
     adw_preferences_group_add(self->capture_group, GTK_WIDGET(self->restore_portal_row));
 
+#ifdef HAVE_X11
+    /* Live preview, below the rows (X11 with MIT-SHM only) */
+    if (info->system_info.display_server == GSR_DISPLAY_SERVER_X11)
+        self->preview = gsr_x11_preview_new(PREVIEW_WIDTH, PREVIEW_HEIGHT,
+                                            on_preview_frame, self);
+    if (self->preview) {
+        self->preview_box = gtk_box_new(GTK_ORIENTATION_VERTICAL, 6);
+        gtk_widget_set_margin_top(self->preview_box, 12);
+
+        self->preview_picture = GTK_PICTURE(gtk_picture_new());
+        gtk_picture_set_content_fit(self->preview_picture, GTK_CONTENT_FIT_CONTAIN);
+        gtk_widget_set_size_request(GTK_WIDGET(self->preview_picture), -1, PREVIEW_HEIGHT);
+        gtk_widget_add_css_class(GTK_WIDGET(self->preview_picture), "card");
+        gtk_widget_set_overflow(GTK_WIDGET(self->preview_picture), GTK_OVERFLOW_HIDDEN);
+        g_signal_connect(self->preview_picture, "map", G_CALLBACK(on_preview_map), self);
+        g_signal_connect(self->preview_picture, "unmap", G_CALLBACK(on_preview_unmap), self);
+        gtk_box_append(GTK_BOX(self->preview_box), GTK_WIDGET(self->preview_picture));
+
+        self->preview_cost_label = GTK_LABEL(gtk_label_new(NULL));
+        gtk_widget_add_css_class(GTK_WIDGET(self->preview_cost_label), "caption");
+        gtk_widget_add_css_class(GTK_WIDGET(self->preview_cost_label), "dim-label");
+        gtk_widget_add_css_class(GTK_WIDGET(self->preview_cost_label), "numeric");
+        gtk_box_append(GTK_BOX(self->preview_box), GTK_WIDGET(self->preview_cost_label));
+
+        gtk_widget_set_visible(self->preview_box, FALSE);
+        adw_preferences_group_add(self->capture_group, self->preview_box);
+    }
+#endif
+
     adw_preferences_page_add(ADW_PREFERENCES_PAGE(self), self->capture_group);
 }
 
@@ -545,39 +805,14 @@ on_quality_changed(GObject *obj, GParamSpec *pspec G_GNUC_UNUSED, gpointer user_
     gtk_widget_set_visible(GTK_WIDGET(self->bitrate_row), idx == 0);
 }
 
+/* Labels say which codecs the selected card can encode; the ids are
+   only added the first time */
 static void
-build_video_group(GsrConfigPage *self)
+fill_video_codec_model(GsrConfigPage *self)
 {
-    self->video_group = ADW_PREFERENCES_GROUP(adw_preferences_group_new());
-    adw_preferences_group_set_title(self->video_group, _("Video"));
-
     const GsrInfo *info = self->info;
-
-    /* Quality */
-    self->quality_row = ADW_COMBO_ROW(adw_combo_row_new());
-    adw_preferences_row_set_title(ADW_PREFERENCES_ROW(self->quality_row), _("Video quality"));
-    GtkStringList *q_model = gtk_string_list_new((const char *const[]){
-        _("Constant bitrate"),
-        _("Medium"), _("High"),
-        _("Very High"),
-        _("Ultra"), NULL });
-    adw_combo_row_set_model(self->quality_row, G_LIST_MODEL(q_model));
-    adw_combo_row_set_selected(self->quality_row, 0);
-    g_signal_connect(self->quality_row, "notify::selected",
-        G_CALLBACK(on_quality_changed), self);
-    adw_preferences_group_add(self->video_group, GTK_WIDGET(self->quality_row));
-
-    /* Bitrate */
-    self->bitrate_row = ADW_SPIN_ROW(adw_spin_row_new_with_range(1, 500000, 1));
-    adw_preferences_row_set_title(ADW_PREFERENCES_ROW(self->bitrate_row), _("Video bitrate (kbps)"));
-    adw_spin_row_set_value(self->bitrate_row, 15000);
-    adw_preferences_group_add(self->video_group, GTK_WIDGET(self->bitrate_row));
-
-    /* Video codec */
-    self->video_codec_model = gtk_string_list_new(NULL);
-    self->video_codec_ids = NULL;
-    self->n_video_codec_ids = 0;
-    int vc_cap = 0;
+    gboolean first = self->video_codec_ids == NULL;
+    int vc_cap = self->n_video_codec_ids;
 
     struct { const char *id; const char *label_ok; const char *label_na; } codecs[] = {
         { "auto",          _("Auto"), NULL },
@@ -605,12 +840,132 @@ build_video_group(GsrConfigPage *self)
                            _("H.264 Software (N/A)") },
     };
 
+    int card = gsr_config_page_get_gpu_card(self);
+    const char *labels[G_N_ELEMENTS(codecs) + 1];
     for (size_t i = 0; i < G_N_ELEMENTS(codecs); i++) {
-        bool ok = gsr_info_is_codec_supported(info, codecs[i].id);
-        const char *label = (ok || !codecs[i].label_na) ? codecs[i].label_ok : codecs[i].label_na;
-        gtk_string_list_append(self->video_codec_model, label);
-        ids_array_append(&self->video_codec_ids, &self->n_video_codec_ids, &vc_cap, codecs[i].id);
+        bool ok = gsr_info_is_codec_supported(info, card, codecs[i].id);
+        labels[i] = (ok || !codecs[i].label_na) ? codecs[i].label_ok : codecs[i].label_na;
+        if (first)
+            ids_array_append(&self->video_codec_ids, &self->n_video_codec_ids, &vc_cap, codecs[i].id);
+    }
+    labels[G_N_ELEMENTS(codecs)] = NULL;
+
+    /* Replacing the labels would drop the selection */
+    guint selected = self->video_codec_row
+        ? adw_combo_row_get_selected(self->video_codec_row) : 0;
+    gtk_string_list_splice(self->video_codec_model, 0,
+        g_list_model_get_n_items(G_LIST_MODEL(self->video_codec_model)), labels);
+    if (self->video_codec_row)
+        adw_combo_row_set_selected(self->video_codec_row, selected);
+}
+
+static const char *
+gpu_vendor_to_string(GsrGpuVendor vendor)
+{
+    switch (vendor) {
+    case GSR_GPU_VENDOR_AMD:      return "AMD";
+    case GSR_GPU_VENDOR_INTEL:    return "Intel";
+    case GSR_GPU_VENDOR_NVIDIA:   return "NVIDIA";
+    case GSR_GPU_VENDOR_BROADCOM: return "Broadcom";
+    default:                      return _("Unknown GPU");
     }
+}
+
+/* What the selected card can do, as found by probing it */
+static void
+on_gpu_card_changed(GObject    *obj G_GNUC_UNUSED,
+                    GParamSpec *pspec G_GNUC_UNUSED,
+                    gpointer    user_data)
+{
+    GsrConfigPage *self = GSR_CONFIG_PAGE(user_data);
+    int card = gsr_config_page_get_gpu_card(self);
+
+    g_autofree char *subtitle = NULL;
+    if (card < 0) {
+        subtitle = g_strdup(_("The one GPU Screen Recorder picks for the capture target"));
+    } else {
+        const GsrDrmCard *c = &self->info->gpu_info.cards[card];
+        g_auto(GStrv) env = gsr_info_get_card_environ(self->info, card);
+        if (!env) {
+            subtitle = g_strdup(_("Can't be chosen on its own, GPU Screen Recorder picks the GPU"));
+        } else if (!c->probed) {
+            subtitle = g_strdup(_("Couldn't be probed, recording on it may fail"));
+        } else {
+            GString *codecs = g_string_new(NULL);
+            const char *names[][2] = {
+                { "h264", "H.264" }, { "hevc", "HEVC" }, { "av1", "AV1" },
+                { "vp8", "VP8" }, { "vp9", "VP9" },
+            };
+            for (size_t i = 0; i < G_N_ELEMENTS(names); i++) {
+                if (!gsr_info_is_codec_supported(self->info, card, names[i][0]))
+                    continue;
+                if (codecs->len > 0)
+                    g_string_append(codecs, ", ");
+                g_string_append(codecs, names[i][1]);
+            }
+            subtitle = g_strdup_printf(
+                ngettext("%s · %d monitor connected", "%s · %d monitors connected",
+                         (unsigned long)c->n_monitors),
+                codecs->len > 0 ? codecs->str : _("Software encoding only"), c->n_monitors);
+            g_string_free(codecs, TRUE);
+        }
+    }
+    adw_action_row_set_subtitle(ADW_ACTION_ROW(self->gpu_card_row), subtitle);
+
+    fill_video_codec_model(self);
+}
+
+static void
+build_video_group(GsrConfigPage *self)
+{
+    self->video_group = ADW_PREFERENCES_GROUP(adw_preferences_group_new());
+    adw_preferences_group_set_title(self->video_group, _("Video"));
+
+    const GsrInfo *info = self->info;
+
+    /* GPU: with several, pick the one that isn't busy rendering */
+    if (info->gpu_info.n_cards > 1) {
+        GtkStringList *gpu_model = gtk_string_list_new(NULL);
+        gtk_string_list_append(gpu_model, _("Automatic"));
+        for (int i = 0; i < info->gpu_info.n_cards; i++) {
+            const GsrDrmCard *c = &info->gpu_info.cards[i];
+            g_autofree char *name = g_path_get_basename(c->path);
+            g_autofree char *label = g_strdup_printf("%s (%s)",
+                gpu_vendor_to_string(c->vendor), name);
+            gtk_string_list_append(gpu_model, label);
+        }
+        self->gpu_card_row = ADW_COMBO_ROW(adw_combo_row_new());
+        adw_preferences_row_set_title(ADW_PREFERENCES_ROW(self->gpu_card_row), _("GPU"));
+        adw_combo_row_set_model(self->gpu_card_row, G_LIST_MODEL(gpu_model));
+        adw_combo_row_set_selected(self->gpu_card_row, 0);
+        adw_preferences_group_add(self->video_group, GTK_WIDGET(self->gpu_card_row));
+    }
+
+    /* Quality */
+    self->quality_row = ADW_COMBO_ROW(adw_combo_row_new());
+    adw_preferences_row_set_title(ADW_PREFERENCES_ROW(self->quality_row), _("Video quality"));
+    GtkStringList *q_model = gtk_string_list_new((const char *const[]){
+        _("Constant bitrate"),
+        _("Medium"), _("High"),
+        _("Very High"),
+        _("Ultra"), NULL });
+    adw_combo_row_set_model(self->quality_row, G_LIST_MODEL(q_model));
+    adw_combo_row_set_selected(self->quality_row, 0);
+    g_signal_connect(self->quality_row, "notify::selected",
+        G_CALLBACK(on_quality_changed), self);
+    adw_preferences_group_add(self->video_group, GTK_WIDGET(self->quality_row));
+
+    /* Bitrate */
+    self->bitrate_row = ADW_SPIN_ROW(adw_spin_row_new_with_range(1, 500000, 1));
+    adw_preferences_row_set_title(ADW_PREFERENCES_ROW(self->bitrate_row), _("Video bitrate (kbps)"));
+    adw_spin_row_set_value(self->bitrate_row, 15000);
+    adw_preferences_group_add(self->video_group, GTK_WIDGET(self->bitrate_row));
+
+    /* Video codec */
+    self->video_codec_model = gtk_string_list_new(NULL);
+    self->video_codec_ids = NULL;
+    self->n_video_codec_ids = 0;
+    fill_video_codec_model(self);
 
     self->video_codec_row = ADW_COMBO_ROW(adw_combo_row_new());
     adw_preferences_row_set_title(ADW_PREFERENCES_ROW(self->video_codec_row), _("Video codec"));
@@ -619,6 +974,12 @@ build_video_group(GsrConfigPage *self)
     gtk_widget_set_visible(GTK_WIDGET(self->video_codec_row), FALSE); /* advanced only */
     adw_preferences_group_add(self->video_group, GTK_WIDGET(self->video_codec_row));
 
+    if (self->gpu_card_row) {
+        g_signal_connect(self->gpu_card_row, "notify::selected",
+            G_CALLBACK(on_gpu_card_changed), self);
+        on_gpu_card_changed(NULL, NULL, self);
+    }
+
     /* Color range */
     self->color_range_row = ADW_COMBO_ROW(adw_combo_row_new());
     adw_preferences_row_set_title(ADW_PREFERENCES_ROW(self->color_range_row), _("Color range"));
@@ -693,6 +1054,46 @@ build_notifications_group(GsrConfigPage *self)
     adw_preferences_page_add(ADW_PREFERENCES_PAGE(self), self->notifications_group);
 }
 
+/* ── Hotkeys group ───────────────────────────────────────────────── */
+
+#ifdef HAVE_X11
+static void
+on_hotkey_backend_changed(GObject    *obj G_GNUC_UNUSED,
+                          GParamSpec *pspec G_GNUC_UNUSED,
+                          gpointer    user_data)
+{
+    GsrConfigPage *self = GSR_CONFIG_PAGE(user_data);
+
+    /* Save config & switch the hotkey watcher right away */
+    GtkRoot *root = gtk_widget_get_root(GTK_WIDGET(self));
+    if (root && GSR_IS_WINDOW(root))
+        gsr_window_on_hotkey_changed(GSR_WINDOW(root));
+}
+
+static void
+build_hotkeys_group(GsrConfigPage *self)
+{
+    self->hotkeys_group = ADW_PREFERENCES_GROUP(adw_preferences_group_new());
+    adw_preferences_group_set_title(self->hotkeys_group, _("Hotkeys"));
+    gtk_widget_set_visible(GTK_WIDGET(self->hotkeys_group), FALSE); /* advanced only */
+
+    self->hotkey_backend_row = ADW_COMBO_ROW(adw_combo_row_new());
+    adw_preferences_row_set_title(ADW_PREFERENCES_ROW(self->hotkey_backend_row),
+        _("Hotkey method"));
+    adw_action_row_set_subtitle(ADW_ACTION_ROW(self->hotkey_backend_row),
+        _("Raw input keeps hotkeys working while a fullscreen game grabs the keyboard"));
+    GtkStringList *model = gtk_string_list_new(
+        (const char *const[]){ _("Key grab (Recommended)"), _("Raw input"), NULL });
+    adw_combo_row_set_model(self->hotkey_backend_row, G_LIST_MODEL(model));
+    adw_combo_row_set_selected(self->hotkey_backend_row, 0);
+    g_signal_connect(self->hotkey_backend_row, "notify::selected",
+        G_CALLBACK(on_hotkey_backend_changed), self);
+    adw_preferences_group_add(self->hotkeys_group, GTK_WIDGET(self->hotkey_backend_row));
+
+    adw_preferences_page_add(ADW_PREFERENCES_PAGE(self), self->hotkeys_group);
+}
+#endif /* HAVE_X11 */
+
 /* ── GObject lifecycle ───────────────────────────────────────────── */
 
 static void
@@ -710,6 +1111,11 @@ gsr_config_page_finalize(GObject *object)
         self->active_picker = NULL;
     }
     g_free(self->selected_window_name);
+    if (self->window_chooser)
+        g_object_remove_weak_pointer(G_OBJECT(self->window_chooser),
+                                     (gpointer *)&self->window_chooser);
+    gsr_x11_window_list_free(self->window_list);
+    gsr_x11_preview_free(self->preview);
 #endif
 
     G_OBJECT_CLASS(gsr_config_page_parent_class)->finalize(object);
@@ -745,6 +1151,10 @@ gsr_config_page_new(const GsrInfo *info)
     build_audio_group(self);
     build_video_group(self);
     build_notifications_group(self);
+#ifdef HAVE_X11
+    if (info->system_info.display_server == GSR_DISPLAY_SERVER_X11)
+        build_hotkeys_group(self);
+#endif
 
     /* Trigger initial visibility */
     on_record_area_changed(G_OBJECT(self->record_area_row), NULL, self);
@@ -772,6 +1182,12 @@ gsr_config_page_set_advanced(GsrConfigPage *self, gboolean advanced)
 
     /* Notifications: advanced only */
     gtk_widget_set_visible(GTK_WIDGET(self->notifications_group), advanced);
+
+#ifdef HAVE_X11
+    /* Hotkeys: advanced only (X11 only, so may not exist) */
+    if (self->hotkeys_group)
+        gtk_widget_set_visible(GTK_WIDGET(self->hotkeys_group), advanced);
+#endif
 }
 
 /* ── Config apply/read ───────────────────────────────────────────── */
@@ -888,6 +1304,14 @@ gsr_config_page_apply_config(GsrConfigPage *self, const GsrConfig *config)
         adw_spin_row_set_value(self->area_width_row, m->record_area_width);
     if (m->record_area_height > 0)
         adw_spin_row_set_value(self->area_height_row, m->record_area_height);
+#ifdef HAVE_X11
+    self->region_x = m->region_x;
+    self->region_y = m->region_y;
+    self->region_width = MAX(m->region_width, 0);
+    self->region_height = MAX(m->region_height, 0);
+    update_region_subtitle(self);
+    update_preview_target(self);
+#endif
 
     /* Portal session */
     adw_switch_row_set_active(self->restore_portal_row, m->restore_portal_session);
@@ -978,6 +1402,9 @@ gsr_config_page_apply_config(GsrConfigPage *self, const GsrConfig *config)
         audio_codec_string_to_index(m->audio_codec));
 
     /* ── Video ── */
+    if (self->gpu_card_row)
+        adw_combo_row_set_selected(self->gpu_card_row,
+            (guint)(gsr_info_find_card(self->info, m->gpu_card) + 1));
     adw_combo_row_set_selected(self->quality_row,
         quality_string_to_index(m->quality));
     if (m->video_bitrate > 0)
@@ -1017,6 +1444,19 @@ gsr_config_page_apply_config(GsrConfigPage *self, const GsrConfig *config)
     adw_switch_row_set_active(self->notify_saved_row,
         m->show_recording_saved_notifications);
 
+    /* ── Hotkeys ── */
+#ifdef HAVE_X11
+    if (self->hotkey_backend_row) {
+        /* Applying isn't a user change — don't save and regrab */
+        g_signal_handlers_block_by_func(self->hotkey_backend_row,
+            on_hotkey_backend_changed, self);
+        adw_combo_row_set_selected(self->hotkey_backend_row,
+            g_strcmp0(m->hotkey_backend, "raw") == 0 ? 1 : 0);
+        g_signal_handlers_unblock_by_func(self->hotkey_backend_row,
+            on_hotkey_backend_changed, self);
+    }
+#endif
+
     /* Trigger visibility callbacks */
     on_record_area_changed(G_OBJECT(self->record_area_row), NULL, self);
     on_quality_changed(G_OBJECT(self->quality_row), NULL, self);
@@ -1038,6 +1478,12 @@ gsr_config_page_read_config(GsrConfigPage *self, GsrConfig *config)
     m->video_height = (int32_t)adw_spin_row_get_value(self->video_height_row);
     m->record_area_width = (int32_t)adw_spin_row_get_value(self->area_width_row);
     m->record_area_height = (int32_t)adw_spin_row_get_value(self->area_height_row);
+#ifdef HAVE_X11
+    m->region_x = self->region_x;
+    m->region_y = self->region_y;
+    m->region_width = self->region_width;
+    m->region_height = self->region_height;
+#endif
     m->restore_portal_session = adw_switch_row_get_active(self->restore_portal_row);
 
     /* ── Audio ── */
@@ -1119,6 +1565,11 @@ gsr_config_page_read_config(GsrConfigPage *self, GsrConfig *config)
         adw_combo_row_get_selected(self->audio_codec_row)));
 
     /* ── Video ── */
+    /* Kept as loaded while there's only one card to choose from */
+    if (self->gpu_card_row) {
+        int card = gsr_config_page_get_gpu_card(self);
+        g_set_str(&m->gpu_card, card >= 0 ? self->info->gpu_info.cards[card].path : "");
+    }
     g_set_str(&m->quality, quality_index_to_string(
         adw_combo_row_get_selected(self->quality_row)));
 
@@ -1149,6 +1600,13 @@ gsr_config_page_read_config(GsrConfigPage *self, GsrConfig *config)
         adw_switch_row_get_active(self->notify_stopped_row);
     m->show_recording_saved_notifications =
         adw_switch_row_get_active(self->notify_saved_row);
+
+    /* ── Hotkeys ── */
+#ifdef HAVE_X11
+    if (self->hotkey_backend_row)
+        g_set_str(&m->hotkey_backend,
+            adw_combo_row_get_selected(self->hotkey_backend_row) == 1 ? "raw" : "grab");
+#endif
 }
 
 /* ── Command-line helpers (Phase 5) ──────────────────────────────── */
@@ -1171,6 +1629,14 @@ gsr_config_page_get_video_codec_id(GsrConfigPage *self)
     return "auto";
 }
 
+int
+gsr_config_page_get_gpu_card(GsrConfigPage *self)
+{
+    if (!self->gpu_card_row)
+        return -1;
+    return (int)adw_combo_row_get_selected(self->gpu_card_row) - 1;
+}
+
 gboolean
 gsr_config_page_get_app_audio_inverted(GsrConfigPage *self)
 {
@@ -1382,12 +1848,34 @@ gsr_config_page_get_selected_window(GsrConfigPage *self)
 #endif
 }
 
+gboolean
+gsr_config_page_get_region(GsrConfigPage *self, int *x, int *y, int *width, int *height)
+{
+    g_return_val_if_fail(GSR_IS_CONFIG_PAGE(self), FALSE);
+#ifdef HAVE_X11
+    if (self->region_width <= 0 || self->region_height <= 0)
+        return FALSE;
+    *x = self->region_x;
+    *y = self->region_y;
+    *width = self->region_width;
+    *height = self->region_height;
+    return TRUE;
+#else
+    (void)x; (void)y; (void)width; (void)height;
+    return FALSE;
+#endif
+}
+
 gboolean
 gsr_config_page_has_valid_window_selection(GsrConfigPage *self)
 {
     g_return_val_if_fail(GSR_IS_CONFIG_PAGE(self), FALSE);
 
     const char *area_id = gsr_config_page_get_record_area_id(self);
+    if (g_str_equal(area_id, "region")) {
+        int x, y, width, height;
+        return gsr_config_page_get_region(self, &x, &y, &width, &height);
+    }
     if (!g_str_equal(area_id, "window"))
         return TRUE; /* not in window mode, always valid */
 
@@ -1397,3 +1885,16 @@ gsr_config_page_has_valid_window_selection(GsrConfigPage *self)
     return FALSE;
 #endif
 }
+
+void
+gsr_config_page_set_session_active(GsrConfigPage *self, gboolean active)
+{
+    g_return_if_fail(GSR_IS_CONFIG_PAGE(self));
+#ifdef HAVE_X11
+    /* The preview would compete with the capture for the same pixels */
+    self->session_active = active;
+    update_preview_running(self);
+#else
+    (void)active;
+#endif
+}
@@ -31,6 +31,12 @@ const char    *gsr_config_page_get_record_area_id  (GsrConfigPage *self);
  */
 const char    *gsr_config_page_get_video_codec_id  (GsrConfigPage *self);
 
+/**
+ * Get the DRM card to run on, an index into the info's gpu_info.cards,
+ * or -1 to leave it to the recorder.
+ */
+int            gsr_config_page_get_gpu_card        (GsrConfigPage *self);
+
 /**
  * Build audio "-a" arguments into a GPtrArray of strings.
  * Each string is one "-a" value (e.g. "device:xxx" or merged pipe-delimited).
@@ -92,11 +98,29 @@ gboolean       gsr_config_page_get_notify_saved        (GsrConfigPage *self);
  */
 unsigned long  gsr_config_page_get_selected_window     (GsrConfigPage *self);
 
+/**
+ * Get the region picked for the "region" record area, in root window
+ * coordinates.  Returns FALSE if none has been picked.
+ */
+gboolean       gsr_config_page_get_region              (GsrConfigPage *self,
+                                                        int           *x,
+                                                        int           *y,
+                                                        int           *width,
+                                                        int           *height);
+
 /**
  * Check if we have a valid window selection.
- * Returns TRUE if not in "window" mode, or if a window has been picked.
- * Returns FALSE if in "window" mode but no window selected yet.
+ * Returns TRUE if not in "window" or "region" mode, or if a window /
+ * region has been picked.
+ * Returns FALSE if in one of those modes but nothing picked yet.
  */
 gboolean       gsr_config_page_has_valid_window_selection(GsrConfigPage *self);
 
+/**
+ * Tell the page a capture started or stopped; the live preview of the
+ * capture target pauses while one runs.
+ */
+void           gsr_config_page_set_session_active      (GsrConfigPage *self,
+                                                        gboolean       active);
+
 G_END_DECLS
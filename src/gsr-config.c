@@ -13,6 +13,8 @@
 
 #include <gtk/gtk.h>
 
+#include "gsr-trace.h"
+
 /*
  * X keysym constants for the custom modifier bitmask encoding.
  * These are just integer values used for config file serialization —
@@ -138,6 +140,10 @@ static const CfgEntry config_entries[] = {
     { "main.record_area_option",                  CFG_STRING,       CFG_OFF(main_config, record_area_option),       0 },
     { "main.record_area_width",                   CFG_I32,          CFG_OFF(main_config, record_area_width),        0 },
     { "main.record_area_height",                  CFG_I32,          CFG_OFF(main_config, record_area_height),       0 },
+    { "main.region_x",                            CFG_I32,          CFG_OFF(main_config, region_x),                 0 },
+    { "main.region_y",                            CFG_I32,          CFG_OFF(main_config, region_y),                 0 },
+    { "main.region_width",                        CFG_I32,          CFG_OFF(main_config, region_width),             0 },
+    { "main.region_height",                       CFG_I32,          CFG_OFF(main_config, region_height),            0 },
     { "main.video_width",                         CFG_I32,          CFG_OFF(main_config, video_width),              0 },
     { "main.video_height",                        CFG_I32,          CFG_OFF(main_config, video_height),             0 },
     { "main.fps",                                 CFG_I32,          CFG_OFF(main_config, fps),                      0 },
@@ -152,6 +158,7 @@ static const CfgEntry config_entries[] = {
     { "main.codec",                               CFG_STRING,       CFG_OFF(main_config, codec),                    0 },
     { "main.audio_codec",                         CFG_STRING,       CFG_OFF(main_config, audio_codec),              0 },
     { "main.framerate_mode",                      CFG_STRING,       CFG_OFF(main_config, framerate_mode),           0 },
+    { "main.gpu_card",                            CFG_STRING,       CFG_OFF(main_config, gpu_card),                 0 },
     { "main.advanced_view",                       CFG_BOOL,         CFG_OFF(main_config, advanced_view),            0 },
     { "main.overclock",                           CFG_BOOL,         CFG_OFF(main_config, overclock),                0 },
     { "main.show_recording_started_notifications",CFG_BOOL,         CFG_OFF(main_config, show_recording_started_notifications), 0 },
@@ -164,6 +171,10 @@ static const CfgEntry config_entries[] = {
     { "main.hevc_amd_bug_warning_shown",          CFG_BOOL,         CFG_OFF(main_config, hevc_amd_bug_warning_shown),0 },
     { "main.av1_amd_bug_warning_shown",           CFG_BOOL,         CFG_OFF(main_config, av1_amd_bug_warning_shown),0 },
     { "main.restore_portal_session",              CFG_BOOL,         CFG_OFF(main_config, restore_portal_session),   0 },
+    { "main.hotkey_backend",                      CFG_STRING,       CFG_OFF(main_config, hotkey_backend),           0 },
+    { "main.post_process_command",                CFG_STRING_ARRAY, CFG_OFF(main_config, post_process_command),
+                                                                    CFG_OFF(main_config, n_post_process_command) },
+    { "main.post_process_max_jobs",               CFG_I32,          CFG_OFF(main_config, post_process_max_jobs),    0 },
     { "main.use_new_ui",                          CFG_BOOL,         CFG_OFF(main_config, use_new_ui),               0 },
     { "main.installed_gsr_global_hotkeys_version",CFG_I32,          CFG_OFF(main_config, installed_gsr_global_hotkeys_version),0 },
 
@@ -173,11 +184,26 @@ static const CfgEntry config_entries[] = {
     { "streaming.twitch.key",                     CFG_STRING,       CFG_OFF(streaming_config, twitch_stream_key),    0 },
     { "streaming.custom.url",                     CFG_STRING,       CFG_OFF(streaming_config, custom_url),           0 },
     { "streaming.custom.container",               CFG_STRING,       CFG_OFF(streaming_config, custom_container),     0 },
+    { "streaming.adaptive_bitrate",               CFG_BOOL,         CFG_OFF(streaming_config, adaptive_bitrate),     0 },
+    { "streaming.save_locally",                   CFG_BOOL,         CFG_OFF(streaming_config, save_locally),         0 },
+    { "streaming.twitch.ingest_host",             CFG_STRING_ARRAY, CFG_OFF(streaming_config, twitch_ingest_host),
+                                                                    CFG_OFF(streaming_config, n_twitch_ingest_host) },
+    { "streaming.youtube.ingest_host",            CFG_STRING_ARRAY, CFG_OFF(streaming_config, youtube_ingest_host),
+                                                                    CFG_OFF(streaming_config, n_youtube_ingest_host) },
+    { "streaming.simulcast_url",                  CFG_STRING_ARRAY, CFG_OFF(streaming_config, simulcast_url),
+                                                                    CFG_OFF(streaming_config, n_simulcast_url) },
     { "streaming.start_stop_recording_hotkey",    CFG_HOTKEY,       CFG_OFF(streaming_config, start_stop_hotkey),    0 },
 
     /* ── record ── */
     { "record.save_directory",                    CFG_STRING,       CFG_OFF(record_config, save_directory),          0 },
     { "record.container",                         CFG_STRING,       CFG_OFF(record_config, container),               0 },
+    { "record.segment_minutes",                   CFG_I32,          CFG_OFF(record_config, segment_minutes),         0 },
+    { "record.segment_size_mb",                   CFG_I32,          CFG_OFF(record_config, segment_size_mb),         0 },
+    { "record.multi_monitor",                     CFG_BOOL,         CFG_OFF(record_config, multi_monitor),           0 },
+    { "record.monitors",                          CFG_STRING_ARRAY, CFG_OFF(record_config, monitors),
+                                                                    CFG_OFF(record_config, n_monitors) },
+    { "record.multi_fps_budget",                  CFG_I32,          CFG_OFF(record_config, multi_fps_budget),        0 },
+    { "record.multi_bitrate_budget_kbps",         CFG_I32,          CFG_OFF(record_config, multi_bitrate_budget_kbps), 0 },
     { "record.start_stop_recording_hotkey",       CFG_HOTKEY,       CFG_OFF(record_config, start_stop_hotkey),       0 },
     { "record.pause_unpause_recording_hotkey",    CFG_HOTKEY,       CFG_OFF(record_config, pause_unpause_hotkey),    0 },
 
@@ -185,8 +211,14 @@ static const CfgEntry config_entries[] = {
     { "replay.save_directory",                    CFG_STRING,       CFG_OFF(replay_config, save_directory),          0 },
     { "replay.container",                         CFG_STRING,       CFG_OFF(replay_config, container),               0 },
     { "replay.time",                              CFG_I32,          CFG_OFF(replay_config, replay_time),             0 },
+    { "replay.storage",                           CFG_STRING,       CFG_OFF(replay_config, storage),                 0 },
+    { "replay.estimate_scale_percent",            CFG_I32,          CFG_OFF(replay_config, estimate_scale_percent),  0 },
     { "replay.start_stop_recording_hotkey",       CFG_HOTKEY,       CFG_OFF(replay_config, start_stop_hotkey),       0 },
     { "replay.save_recording_hotkey",             CFG_HOTKEY,       CFG_OFF(replay_config, save_hotkey),             0 },
+    { "replay.save_short_time",                   CFG_I32,          CFG_OFF(replay_config, save_short_time),         0 },
+    { "replay.save_short_hotkey",                 CFG_HOTKEY,       CFG_OFF(replay_config, save_short_hotkey),       0 },
+    { "replay.save_long_time",                    CFG_I32,          CFG_OFF(replay_config, save_long_time),          0 },
+    { "replay.save_long_hotkey",                  CFG_HOTKEY,       CFG_OFF(replay_config, save_long_hotkey),        0 },
 };
 
 #define N_CONFIG_ENTRIES ((int)(sizeof(config_entries) / sizeof(config_entries[0])))
@@ -213,6 +245,10 @@ gsr_config_init_defaults(GsrConfig *config)
     m->record_area_option = g_strdup("");
     m->record_area_width = 0;
     m->record_area_height = 0;
+    m->region_x = 0;
+    m->region_y = 0;
+    m->region_width = 0;
+    m->region_height = 0;
     m->video_width = 0;
     m->video_height = 0;
     m->fps = 60;
@@ -222,11 +258,15 @@ gsr_config_init_defaults(GsrConfig *config)
     m->change_video_resolution = false;
     m->audio_input = NULL;
     m->n_audio_input = 0;
+    m->post_process_command = NULL;
+    m->n_post_process_command = 0;
+    m->post_process_max_jobs = 1;
     m->color_range = g_strdup("limited");
     m->quality = g_strdup("very_high");
     m->codec = g_strdup("auto");
     m->audio_codec = g_strdup("opus");
     m->framerate_mode = g_strdup("auto");
+    m->gpu_card = g_strdup("");
     m->advanced_view = false;
     m->overclock = false;
     m->show_recording_started_notifications = false;
@@ -239,6 +279,7 @@ gsr_config_init_defaults(GsrConfig *config)
     m->steam_deck_warning_shown = false;
     m->hevc_amd_bug_warning_shown = false;
     m->av1_amd_bug_warning_shown = false;
+    m->hotkey_backend = g_strdup("grab");
     m->use_new_ui = false;
     m->installed_gsr_global_hotkeys_version = 0;
 
@@ -254,11 +295,26 @@ gsr_config_init_defaults(GsrConfig *config)
     s->twitch_stream_key = g_strdup("");
     s->custom_url = g_strdup("");
     s->custom_container = g_strdup("flv");
+    s->adaptive_bitrate = false;
+    s->save_locally = false;
+    s->twitch_ingest_host = NULL;
+    s->n_twitch_ingest_host = 0;
+    s->youtube_ingest_host = NULL;
+    s->n_youtube_ingest_host = 0;
+    s->simulcast_url = NULL;
+    s->n_simulcast_url = 0;
     s->start_stop_hotkey = DEFAULT_HOTKEY_START_STOP;
 
     GsrRecordConfig *r = &config->record_config;
     r->save_directory = gsr_config_get_videos_dir();
     r->container = g_strdup("mp4");
+    r->segment_minutes = 0;
+    r->segment_size_mb = 0;
+    r->multi_monitor = false;
+    r->monitors = NULL;
+    r->n_monitors = 0;
+    r->multi_fps_budget = 0;
+    r->multi_bitrate_budget_kbps = 0;
     r->start_stop_hotkey = DEFAULT_HOTKEY_START_STOP;
     r->pause_unpause_hotkey = DEFAULT_HOTKEY_SECONDARY;
 
@@ -266,8 +322,12 @@ gsr_config_init_defaults(GsrConfig *config)
     rp->save_directory = gsr_config_get_videos_dir();
     rp->container = g_strdup("mp4");
     rp->replay_time = 30;
+    rp->storage = g_strdup("ram");
+    rp->estimate_scale_percent = 100;
     rp->start_stop_hotkey = DEFAULT_HOTKEY_START_STOP;
     rp->save_hotkey = DEFAULT_HOTKEY_SECONDARY;
+    rp->save_short_time = 30;
+    rp->save_long_time = 300;
 
     #undef DEFAULT_HOTKEY_START_STOP
     #undef DEFAULT_HOTKEY_SECONDARY
@@ -278,6 +338,7 @@ gsr_config_init_defaults(GsrConfig *config)
 gboolean
 gsr_config_read(GsrConfig *config)
 {
+    gint64 trace_begin = GSR_TRACE_CURRENT_TIME;
     char *config_dir = gsr_config_get_dir();
     char *config_path = g_build_filename(config_dir, "config", NULL);
     g_free(config_dir);
@@ -286,6 +347,7 @@ gsr_config_read(GsrConfig *config)
     gsize length = 0;
     if (!g_file_get_contents(config_path, &contents, &length, NULL)) {
         g_free(config_path);
+        GSR_TRACE_MARK(trace_begin, "gsr_config_read", "no config file");
         return FALSE;
     }
     g_free(config_path);
@@ -342,11 +404,19 @@ gsr_config_read(GsrConfig *config)
                         int copy_len = val_len < 63 ? val_len : 63;
                         memcpy(tmp, val, (size_t)copy_len);
                         tmp[copy_len] = '\0';
-                        if (sscanf(tmp, "%" PRIi64 " %" PRIu32,
-                                   &hk->keysym, &hk->modifiers) != 2) {
+                        /* "<keysym> <modifiers> [press]" — the optional
+                           third token was added later, so older files
+                           (and other frontends) keep working. */
+                        char edge[16] = "";
+                        int n = sscanf(tmp, "%" PRIi64 " %" PRIu32 " %15s",
+                                       &hk->keysym, &hk->modifiers, edge);
+                        if (n < 2) {
                             hk->keysym = 0;
                             hk->modifiers = 0;
                         }
+                        hk->trigger = strcmp(edge, "press") == 0
+                            ? GSR_HOTKEY_TRIGGER_PRESS
+                            : GSR_HOTKEY_TRIGGER_RELEASE;
                         break;
                     }
                     case CFG_STRING_ARRAY: {
@@ -368,6 +438,7 @@ gsr_config_read(GsrConfig *config)
     }
 
     g_free(contents);
+    GSR_TRACE_MARK(trace_begin, "gsr_config_read", "%zu bytes", (size_t)length);
     return TRUE;
 }
 
@@ -376,6 +447,7 @@ gsr_config_read(GsrConfig *config)
 void
 gsr_config_save(const GsrConfig *config)
 {
+    gint64 trace_begin = GSR_TRACE_CURRENT_TIME;
     char *config_dir = gsr_config_get_dir();
     char *config_path = g_build_filename(config_dir, "config", NULL);
 
@@ -418,8 +490,9 @@ gsr_config_save(const GsrConfig *config)
         }
         case CFG_HOTKEY: {
             const GsrConfigHotkey *hk = (const GsrConfigHotkey *)(const void *)(base + e->offset);
-            fprintf(file, "%s %" PRIi64 " %" PRIu32 "\n", e->key,
-                    hk->keysym, hk->modifiers);
+            fprintf(file, "%s %" PRIi64 " %" PRIu32 "%s\n", e->key,
+                    hk->keysym, hk->modifiers,
+                    hk->trigger == GSR_HOTKEY_TRIGGER_PRESS ? " press" : "");
             break;
         }
         case CFG_STRING_ARRAY: {
@@ -436,6 +509,7 @@ gsr_config_save(const GsrConfig *config)
     }
 
     fclose(file);
+    GSR_TRACE_MARK(trace_begin, "gsr_config_save", "%d entries", N_CONFIG_ENTRIES);
 }
 
 /* ── Clear ───────────────────────────────────────────────────────── */
@@ -450,6 +524,8 @@ gsr_config_clear(GsrConfig *config)
     g_free(m->codec);
     g_free(m->audio_codec);
     g_free(m->framerate_mode);
+    g_free(m->gpu_card);
+    g_free(m->hotkey_backend);
 
     if (m->audio_input) {
         for (int i = 0; i < m->n_audio_input; i++)
@@ -457,6 +533,12 @@ gsr_config_clear(GsrConfig *config)
         g_free(m->audio_input);
     }
 
+    if (m->post_process_command) {
+        for (int i = 0; i < m->n_post_process_command; i++)
+            g_free(m->post_process_command[i]);
+        g_free(m->post_process_command);
+    }
+
     GsrStreamingConfig *s = &config->streaming_config;
     g_free(s->streaming_service);
     g_free(s->youtube_stream_key);
@@ -464,15 +546,57 @@ gsr_config_clear(GsrConfig *config)
     g_free(s->custom_url);
     g_free(s->custom_container);
 
+    if (s->twitch_ingest_host) {
+        for (int i = 0; i < s->n_twitch_ingest_host; i++)
+            g_free(s->twitch_ingest_host[i]);
+        g_free(s->twitch_ingest_host);
+    }
+
+    if (s->youtube_ingest_host) {
+        for (int i = 0; i < s->n_youtube_ingest_host; i++)
+            g_free(s->youtube_ingest_host[i]);
+        g_free(s->youtube_ingest_host);
+    }
+
+    if (s->simulcast_url) {
+        for (int i = 0; i < s->n_simulcast_url; i++)
+            g_free(s->simulcast_url[i]);
+        g_free(s->simulcast_url);
+    }
+
     g_free(config->record_config.save_directory);
     g_free(config->record_config.container);
+    if (config->record_config.monitors) {
+        for (int i = 0; i < config->record_config.n_monitors; i++)
+            g_free(config->record_config.monitors[i]);
+        g_free(config->record_config.monitors);
+    }
 
     g_free(config->replay_config.save_directory);
     g_free(config->replay_config.container);
+    g_free(config->replay_config.storage);
 
     memset(config, 0, sizeof(*config));
 }
 
+/* ── Replay save lengths ─────────────────────────────────────────── */
+
+const int gsr_replay_save_lengths[GSR_N_REPLAY_SAVE_LENGTHS] = {
+    10, 30, 60, 5 * 60, 10 * 60, 30 * 60,
+};
+
+int
+gsr_replay_save_length_index(int seconds)
+{
+    if (seconds <= 0)
+        return -1;
+    for (int i = 0; i < GSR_N_REPLAY_SAVE_LENGTHS; i++) {
+        if (gsr_replay_save_lengths[i] >= seconds)
+            return i;
+    }
+    return -1;
+}
+
 /* ── Hotkey conversion utilities ─────────────────────────────────── */
 
 /*
@@ -9,18 +9,29 @@ G_BEGIN_DECLS
 
 /* ── Hotkey ──────────────────────────────────────────────────────── */
 
+/* Which key edge fires the hotkey.  Release is the historical default. */
+typedef enum {
+    GSR_HOTKEY_TRIGGER_RELEASE = 0,
+    GSR_HOTKEY_TRIGGER_PRESS   = 1,
+} GsrHotkeyTrigger;
+
 typedef struct {
     int64_t  keysym;
     uint32_t modifiers;
+    GsrHotkeyTrigger trigger;
 } GsrConfigHotkey;
 
 /* ── Config struct ───────────────────────────────────────────────── */
 
 typedef struct {
     /* Capture target */
-    char    *record_area_option;   /* "window", "focused", "portal", or monitor name */
+    char    *record_area_option;   /* "window", "focused", "region", "portal", or monitor name */
     int32_t  record_area_width;
     int32_t  record_area_height;
+    int32_t  region_x;             /* "region", in root window coordinates */
+    int32_t  region_y;
+    int32_t  region_width;         /* 0 until one is picked */
+    int32_t  region_height;
     int32_t  video_width;
     int32_t  video_height;
 
@@ -32,6 +43,7 @@ typedef struct {
     char    *codec;                /* "auto", "h264", "hevc", etc. */
     char    *audio_codec;          /* "opus", "aac" */
     char    *framerate_mode;       /* "auto", "cfr", "vfr" */
+    char    *gpu_card;             /* DRM card to run on, "" = the recorder's choice */
     bool     overclock;
     bool     record_cursor;
 
@@ -60,6 +72,15 @@ typedef struct {
     bool     hevc_amd_bug_warning_shown;
     bool     av1_amd_bug_warning_shown;
 
+    /* Post-processing of saved files; "{file}" in a command is replaced by
+       the path, otherwise the path is appended.  Run in order per file. */
+    char   **post_process_command; /* NULL-terminated array */
+    int      n_post_process_command;
+    int32_t  post_process_max_jobs;
+
+    /* Hotkeys */
+    char    *hotkey_backend;       /* "grab" (XGrabKey), "raw" (XInput2 raw events) */
+
     /* Misc */
     bool     use_new_ui;
     int32_t  installed_gsr_global_hotkeys_version;
@@ -71,13 +92,35 @@ typedef struct {
     char *twitch_stream_key;
     char *custom_url;
     char *custom_container;    /* "mp4", "flv", "matroska", etc. */
+    bool  adaptive_bitrate;    /* Lower the bitrate while the uplink is congested */
+    bool  save_locally;        /* Also write the stream to the record directory */
+
+    /* Candidate ingest servers ("host[:port]"), the fastest is used;
+       built-in lists if empty */
+    char **twitch_ingest_host; /* NULL-terminated array */
+    int    n_twitch_ingest_host;
+    char **youtube_ingest_host;
+    int    n_youtube_ingest_host;
+
+    /* Further destinations fed from the same encode, full URLs */
+    char **simulcast_url;      /* NULL-terminated array */
+    int    n_simulcast_url;
 
     GsrConfigHotkey start_stop_hotkey;
 } GsrStreamingConfig;
 
 typedef struct {
-    char *save_directory;
-    char *container;
+    char    *save_directory;
+    char    *container;
+    int32_t  segment_minutes;      /* Split into a new file after, 0 = never */
+    int32_t  segment_size_mb;      /* Split into a new file at, 0 = never */
+
+    /* Record several monitors at once, one file each */
+    bool     multi_monitor;
+    char   **monitors;             /* NULL-terminated array of output names */
+    int      n_monitors;
+    int32_t  multi_fps_budget;     /* Frame rate shared by all, 0 = no limit */
+    int32_t  multi_bitrate_budget_kbps; /* Bitrate shared by all, 0 = no limit */
 
     GsrConfigHotkey start_stop_hotkey;
     GsrConfigHotkey pause_unpause_hotkey;
@@ -87,11 +130,33 @@ typedef struct {
     char    *save_directory;
     char    *container;
     int32_t  replay_time;
+    char    *storage;              /* "ram", "disk" (-replay-storage) */
+    int32_t  estimate_scale_percent; /* buffer size correction learned from RSS */
+
+    /* Partial saves of the last N seconds, one of gsr_replay_save_lengths */
+    int32_t  save_short_time;
+    int32_t  save_long_time;
 
     GsrConfigHotkey start_stop_hotkey;
     GsrConfigHotkey save_hotkey;
+    GsrConfigHotkey save_short_hotkey;
+    GsrConfigHotkey save_long_hotkey;
 } GsrReplayConfig;
 
+/*
+ * Trailing lengths (seconds) gpu-screen-recorder can save from a running
+ * replay without saving the whole buffer: SIGRTMIN+1 saves the first,
+ * SIGRTMIN+2 the second, and so on.
+ */
+#define GSR_N_REPLAY_SAVE_LENGTHS 6
+extern const int gsr_replay_save_lengths[GSR_N_REPLAY_SAVE_LENGTHS];
+
+/**
+ * Index of the shortest partial-save length that covers `seconds`, or -1
+ * if seconds <= 0 or longer than any of them (save the whole buffer).
+ */
+int gsr_replay_save_length_index(int seconds);
+
 typedef struct {
     GsrMainConfig      main_config;
     GsrStreamingConfig streaming_config;
@@ -151,6 +216,7 @@ char *gsr_config_hotkey_to_accel(const GsrConfigHotkey *hk);
  * Convert a GTK accelerator string like "<Alt>1" to a GsrConfigHotkey.
  * Returns TRUE on success, FALSE if the accel string is invalid.
  * If accel is NULL, the hotkey is cleared (keysym=0, modifiers=0).
+ * hk->trigger is left untouched.
  */
 gboolean gsr_config_hotkey_from_accel(GsrConfigHotkey *hk, const char *accel);
 
@@ -0,0 +1,121 @@
+#include "gsr-encode-stats.h"
+
+#include <string.h>
+
+#include <glib/gstdio.h>
+
+/* ── Rings ───────────────────────────────────────────────────────── */
+
+static void
+ring_push(GsrEncodeStatRing *ring, double value)
+{
+    ring->values[ring->head] = value;
+    ring->head = (ring->head + 1) % GSR_ENCODE_STATS_HISTORY;
+    if (ring->count < GSR_ENCODE_STATS_HISTORY)
+        ring->count++;
+}
+
+/* ── Parsing ─────────────────────────────────────────────────────── */
+
+/*
+ * Recent recorders print "update fps: 60, damage fps: 58" once a second,
+ * older ones "fps: 60".  The update fps is what gets encoded.
+ */
+static gboolean
+parse_fps(const char *line, double *out)
+{
+    const char *p = strstr(line, "update fps:");
+    if (p)
+        p += strlen("update fps:");
+    else if (g_str_has_prefix(line, "fps:"))
+        p = line + strlen("fps:");
+    else
+        return FALSE;
+
+    char *end = NULL;
+    double fps = g_ascii_strtod(p, &end);
+    if (end == p || fps < 0.0)
+        return FALSE;
+    *out = fps;
+    return TRUE;
+}
+
+/* ── Public API ──────────────────────────────────────────────────── */
+
+void
+gsr_encode_stats_reset(GsrEncodeStats *stats, int target_fps)
+{
+    memset(stats, 0, sizeof(*stats));
+    stats->target_fps = target_fps;
+    stats->last_size = -1;
+}
+
+gboolean
+gsr_encode_stats_parse_line(GsrEncodeStats *stats, const char *line)
+{
+    double fps;
+    if (!parse_fps(line, &fps))
+        return FALSE;
+
+    stats->reported_fps = fps;
+    stats->have_reported_fps = TRUE;
+    return TRUE;
+}
+
+void
+gsr_encode_stats_sample(GsrEncodeStats *stats, const char *output_path, gint64 now_us)
+{
+    if (stats->have_reported_fps) {
+        ring_push(&stats->rings[GSR_ENCODE_STAT_FPS], stats->reported_fps);
+        stats->have_reported_fps = FALSE;
+
+        /* Not reported by the recorder: whatever falls short of the
+           target.  Only an estimate, since the two clocks aren't aligned. */
+        if (stats->target_fps > 0) {
+            double dropped = MAX(stats->target_fps - stats->reported_fps, 0.0);
+            ring_push(&stats->rings[GSR_ENCODE_STAT_DROPPED], dropped);
+            stats->total_dropped += (guint64)(dropped + 0.5);
+        }
+    }
+
+    GStatBuf st;
+    if (!output_path || g_stat(output_path, &st) != 0)
+        return;
+
+    gint64 size = st.st_size;
+    ring_push(&stats->rings[GSR_ENCODE_STAT_FILE_SIZE], (double)size);
+    if (stats->last_size >= 0 && now_us > stats->last_size_time) {
+        double seconds = (double)(now_us - stats->last_size_time) / G_USEC_PER_SEC;
+        double bits = (double)MAX(size - stats->last_size, 0) * 8.0;
+        ring_push(&stats->rings[GSR_ENCODE_STAT_BITRATE], bits / seconds);
+    }
+    stats->last_size = size;
+    stats->last_size_time = now_us;
+}
+
+gboolean
+gsr_encode_stats_has(const GsrEncodeStats *stats, GsrEncodeStat stat)
+{
+    return stats->rings[stat].count > 0;
+}
+
+double
+gsr_encode_stats_latest(const GsrEncodeStats *stats, GsrEncodeStat stat)
+{
+    const GsrEncodeStatRing *ring = &stats->rings[stat];
+    if (ring->count == 0)
+        return 0.0;
+    return ring->values[(ring->head + GSR_ENCODE_STATS_HISTORY - 1) % GSR_ENCODE_STATS_HISTORY];
+}
+
+guint
+gsr_encode_stats_history(const GsrEncodeStats *stats, GsrEncodeStat stat,
+                         double *out, guint max)
+{
+    const GsrEncodeStatRing *ring = &stats->rings[stat];
+    guint n = MIN(ring->count, max);
+    guint start = (ring->head + GSR_ENCODE_STATS_HISTORY - n) % GSR_ENCODE_STATS_HISTORY;
+    for (guint i = 0; i < n; i++)
+        out[i] = ring->values[(start + i) % GSR_ENCODE_STATS_HISTORY];
+    return n;
+}
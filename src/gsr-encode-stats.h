@@ -0,0 +1,88 @@
+#pragma once
+
+/*
+ * gsr-encode-stats.h — Live statistics of a running capture.
+ *
+ * Fed with gpu-screen-recorder's stderr, one line at a time, and sampled
+ * once a second.  What the recorder doesn't print is derived: dropped
+ * frames from the reported fps against the target, bitrate and file size
+ * from stat() on the output file.  Each metric keeps its last
+ * GSR_ENCODE_STATS_HISTORY samples in a fixed ring, so a long session
+ * uses no more memory than a short one.
+ */
+
+#include <glib.h>
+
+#define GSR_ENCODE_STATS_HISTORY 120   /* samples, one per second */
+
+typedef enum {
+    GSR_ENCODE_STAT_FPS,           /* frames per second */
+    GSR_ENCODE_STAT_DROPPED,       /* frames per second short of the target */
+    GSR_ENCODE_STAT_BITRATE,       /* bits per second */
+    GSR_ENCODE_STAT_FILE_SIZE,     /* bytes */
+    GSR_N_ENCODE_STATS
+} GsrEncodeStat;
+
+typedef struct {
+    double  values[GSR_ENCODE_STATS_HISTORY];
+    guint   head;                  /* next slot to write */
+    guint   count;                 /* valid samples, ≤ GSR_ENCODE_STATS_HISTORY */
+} GsrEncodeStatRing;
+
+typedef struct {
+    GsrEncodeStatRing rings[GSR_N_ENCODE_STATS];
+    int               target_fps;
+    guint64           total_dropped;
+
+    /* Latest reading from the recorder, consumed by the next sample */
+    double            reported_fps;
+    gboolean          have_reported_fps;
+
+    /* Previous output file size, for the bitrate */
+    gint64            last_size;   /* -1 if none yet */
+    gint64            last_size_time;
+} GsrEncodeStats;
+
+/**
+ * Clear everything for a new capture running at target_fps; 0 when the
+ * frame rate is variable and nothing counts as dropped.
+ */
+void     gsr_encode_stats_reset     (GsrEncodeStats *stats,
+                                     int             target_fps);
+
+/**
+ * Parse one line of recorder output.  Returns TRUE if it was a
+ * statistics line (and so needn't be logged).
+ */
+gboolean gsr_encode_stats_parse_line(GsrEncodeStats *stats,
+                                     const char     *line);
+
+/**
+ * Take the once-a-second sample.  output_path is the file being written,
+ * or NULL when there is none (replay buffer, stream).  now_us is
+ * monotonic time.
+ */
+void     gsr_encode_stats_sample    (GsrEncodeStats *stats,
+                                     const char     *output_path,
+                                     gint64          now_us);
+
+/**
+ * TRUE if stat has at least one sample.
+ */
+gboolean gsr_encode_stats_has       (const GsrEncodeStats *stats,
+                                     GsrEncodeStat         stat);
+
+/**
+ * Most recent sample of stat, 0 if none.
+ */
+double   gsr_encode_stats_latest    (const GsrEncodeStats *stats,
+                                     GsrEncodeStat         stat);
+
+/**
+ * Copy up to max samples of stat into out, oldest first.  Returns the
+ * number copied.
+ */
+guint    gsr_encode_stats_history   (const GsrEncodeStats *stats,
+                                     GsrEncodeStat         stat,
+                                     double               *out,
+                                     guint                 max);
@@ -5,6 +5,7 @@
 #include <string.h>
 
 #include "gsr-config.h"
+#include "gsr-trace.h"
 #include "gsr-window.h"
 
 /*
@@ -30,9 +31,11 @@
 /* ── Shortcut IDs (Wayland portal) ────────────────────────────────── */
 
 #ifdef HAVE_WAYLAND
-#define SHORTCUT_ID_START_STOP       "gpu_screen_recorder_start_stop_recording"
-#define SHORTCUT_ID_PAUSE_UNPAUSE    "gpu_screen_recorder_pause_unpause_recording"
-#define SHORTCUT_ID_SAVE_REPLAY      "gpu_screen_recorder_save_replay"
+#define SHORTCUT_ID_START_STOP        "gpu_screen_recorder_start_stop_recording"
+#define SHORTCUT_ID_PAUSE_UNPAUSE     "gpu_screen_recorder_pause_unpause_recording"
+#define SHORTCUT_ID_SAVE_REPLAY       "gpu_screen_recorder_save_replay"
+#define SHORTCUT_ID_SAVE_REPLAY_SHORT "gpu_screen_recorder_save_replay_short"
+#define SHORTCUT_ID_SAVE_REPLAY_LONG  "gpu_screen_recorder_save_replay_long"
 #endif
 
 /* ── Internal state ──────────────────────────────────────────────── */
@@ -41,29 +44,19 @@ typedef enum {
     HOTKEY_ACTION_START_STOP,
     HOTKEY_ACTION_PAUSE_UNPAUSE,
     HOTKEY_ACTION_SAVE_REPLAY,
+    HOTKEY_ACTION_SAVE_REPLAY_SHORT,
+    HOTKEY_ACTION_SAVE_REPLAY_LONG,
 } HotkeyAction;
 
-#ifdef HAVE_X11
-typedef struct {
-    unsigned int x11_modifiers;
-    KeySym       keysym;
-    HotkeyAction action;
-} GrabbedCombo;
-
-#define MAX_ACTIVE_COMBOS 4
-#endif /* HAVE_X11 */
-
 struct _GsrHotkeys {
     GsrDisplayServer  display_server;
     GsrWindow        *window;          /* NOT owned */
 
 #ifdef HAVE_X11
-    /* X11 backend */
+    /* X11 backend; each grabbed combo carries its HotkeyAction */
+    Display          *xdisplay;        /* GDK's, NOT owned */
     GsrX11Hotkeys    *x11;
-
-    /* Currently grabbed combos and what action they map to */
-    GrabbedCombo      active_combos[MAX_ACTIVE_COMBOS];
-    int               n_active_combos;
+    GsrX11HotkeyBackend x11_backend;   /* as configured (may have fallen back) */
 #endif /* HAVE_X11 */
 
 #ifdef HAVE_WAYLAND
@@ -78,12 +71,14 @@ struct _GsrHotkeys {
 /* ── Forward declarations ────────────────────────────────────────── */
 
 #ifdef HAVE_X11
-static void on_x11_hotkey(unsigned int modifiers, KeySym keysym, void *userdata);
+static void on_x11_hotkey(const GsrX11HotkeyCombo *combo,
+                          int64_t event_time_us, void *userdata);
 #endif
 
 #ifdef HAVE_WAYLAND
 static void on_wayland_init(bool success, void *userdata);
-static void on_wayland_deactivated(const char *shortcut_id, void *userdata);
+static void on_wayland_deactivated(const char *shortcut_id, uint64_t timestamp,
+                                   void *userdata);
 static void on_wayland_shortcut_changed(gsr_shortcut shortcut, void *userdata);
 #endif
 
@@ -112,51 +107,23 @@ dispatch_pause_unpause(GsrHotkeys *self)
 }
 
 static void
-dispatch_save_replay(GsrHotkeys *self)
+dispatch_save_replay(GsrHotkeys *self, int seconds)
 {
-    gsr_window_hotkey_save_replay(self->window);
+    gsr_window_hotkey_save_replay(self->window, seconds);
 }
 
 /* ── X11 callback ────────────────────────────────────────────────── */
 
 #ifdef HAVE_X11
 static void
-on_x11_hotkey(unsigned int modifiers, KeySym keysym, void *userdata)
+on_x11_hotkey(const GsrX11HotkeyCombo *combo,
+              int64_t event_time_us, void *userdata)
 {
     GsrHotkeys *self = userdata;
+    gint64 trace_begin = GSR_TRACE_CURRENT_TIME;
+    HotkeyAction action = (HotkeyAction)combo->action;
 
-    /* Find which action this combo maps to */
-    HotkeyAction action = HOTKEY_ACTION_START_STOP;
-    bool found = false;
-
-    for (int i = 0; i < self->n_active_combos; i++) {
-        if (self->active_combos[i].keysym == keysym &&
-            self->active_combos[i].x11_modifiers == modifiers)
-        {
-            action = self->active_combos[i].action;
-            found = true;
-            break;
-        }
-    }
-
-    if (!found) {
-        /* Fallback: match by keysym only (modifier might have extra bits
-         * from NumLock/CapsLock that XGrabKey variants handle) */
-        unsigned int base_mods = modifiers & (ControlMask | ShiftMask | Mod1Mask | Mod4Mask);
-        for (int i = 0; i < self->n_active_combos; i++) {
-            if (self->active_combos[i].keysym == keysym &&
-                self->active_combos[i].x11_modifiers == base_mods)
-            {
-                action = self->active_combos[i].action;
-                found = true;
-                break;
-            }
-        }
-    }
-
-    if (!found)
-        return;
-
+    gsr_window_begin_hotkey(self->window, event_time_us, "x11");
     switch (action) {
     case HOTKEY_ACTION_START_STOP:
         dispatch_start_stop(self);
@@ -165,9 +132,18 @@ on_x11_hotkey(unsigned int modifiers, KeySym keysym, void *userdata)
         dispatch_pause_unpause(self);
         break;
     case HOTKEY_ACTION_SAVE_REPLAY:
-        dispatch_save_replay(self);
+        dispatch_save_replay(self, 0);
+        break;
+    case HOTKEY_ACTION_SAVE_REPLAY_SHORT:
+    case HOTKEY_ACTION_SAVE_REPLAY_LONG:
+        gsr_window_hotkey_save_replay_partial(self->window,
+            action == HOTKEY_ACTION_SAVE_REPLAY_LONG);
         break;
     }
+    gsr_window_end_hotkey(self->window);
+
+    GSR_TRACE_MARK(trace_begin, "x11_hotkey_dispatch", "action=%d keysym=0x%lx",
+                   action, (unsigned long)combo->keysym);
 }
 #endif /* HAVE_X11 */
 
@@ -193,15 +169,28 @@ on_wayland_init(bool success, void *userdata)
 }
 
 static void
-on_wayland_deactivated(const char *shortcut_id, void *userdata)
+on_wayland_deactivated(const char *shortcut_id, uint64_t timestamp,
+                       void *userdata)
 {
     GsrHotkeys *self = userdata;
+    gint64 trace_begin = GSR_TRACE_CURRENT_TIME;
 
     const char *page = get_visible_page_name(self);
     if (!page)
         return;
 
-    /* The portal uses 3 shared IDs across all modes.
+    /*
+     * Compositors stamp portal events with CLOCK_MONOTONIC milliseconds in
+     * practice, but the spec doesn't promise a clock.  Trust the stamp only
+     * when it's plausibly recent; otherwise time from signal delivery.
+     */
+    gint64 now_us = g_get_monotonic_time();
+    gint64 event_time_us = (gint64)timestamp * 1000;
+    if (event_time_us > now_us || now_us - event_time_us > 10 * G_USEC_PER_SEC)
+        event_time_us = now_us;
+    gsr_window_begin_hotkey(self->window, event_time_us, "wayland");
+
+    /* The portal uses 5 shared IDs across all modes.
      * Dispatch based on the currently visible page. */
 
     if (g_strcmp0(shortcut_id, SHORTCUT_ID_START_STOP) == 0) {
@@ -216,8 +205,17 @@ on_wayland_deactivated(const char *shortcut_id, void *userdata)
             dispatch_pause_unpause(self);
     } else if (g_strcmp0(shortcut_id, SHORTCUT_ID_SAVE_REPLAY) == 0) {
         if (g_str_equal(page, "replay"))
-            dispatch_save_replay(self);
+            dispatch_save_replay(self, 0);
+    } else if (g_strcmp0(shortcut_id, SHORTCUT_ID_SAVE_REPLAY_SHORT) == 0 ||
+               g_strcmp0(shortcut_id, SHORTCUT_ID_SAVE_REPLAY_LONG) == 0) {
+        if (g_str_equal(page, "replay"))
+            gsr_window_hotkey_save_replay_partial(self->window,
+                g_strcmp0(shortcut_id, SHORTCUT_ID_SAVE_REPLAY_LONG) == 0);
     }
+    gsr_window_end_hotkey(self->window);
+
+    GSR_TRACE_MARK(trace_begin, "wayland_hotkey_dispatch", "id=%s page=%s",
+                   shortcut_id, page);
 }
 
 static void
@@ -230,6 +228,41 @@ on_wayland_shortcut_changed(gsr_shortcut shortcut, void *userdata)
 }
 #endif /* HAVE_WAYLAND */
 
+/* ── X11 backend selection ───────────────────────────────────────── */
+
+#ifdef HAVE_X11
+static GsrX11HotkeyBackend
+configured_x11_backend(GsrHotkeys *self)
+{
+    const GsrConfig *config = gsr_window_get_config(self->window);
+    if (config && g_strcmp0(config->main_config.hotkey_backend, "raw") == 0)
+        return GSR_X11_HOTKEY_BACKEND_RAW;
+    return GSR_X11_HOTKEY_BACKEND_GRAB;
+}
+
+/* Recreate the watcher if the user switched between grab and raw */
+static void
+sync_x11_backend(GsrHotkeys *self)
+{
+    GsrX11HotkeyBackend want = configured_x11_backend(self);
+    if (want == self->x11_backend)
+        return;
+
+    GsrX11Hotkeys *x11 = gsr_x11_hotkeys_new(self->xdisplay, want,
+                                             on_x11_hotkey, self);
+    if (!x11) {
+        g_warning("Failed to switch X11 hotkey backend");
+        return;
+    }
+    gsr_x11_hotkeys_free(self->x11);
+    self->x11 = x11;
+    self->x11_backend = want;
+    g_debug("X11 hotkeys now use %s",
+            gsr_x11_hotkeys_get_backend(x11) == GSR_X11_HOTKEY_BACKEND_RAW
+                ? "XInput2 raw events" : "key grabs");
+}
+#endif /* HAVE_X11 */
+
 /* ── Public API ──────────────────────────────────────────────────── */
 
 GsrHotkeys *
@@ -271,7 +304,10 @@ gsr_hotkeys_new(GsrDisplayServer display_server, GsrWindow *window)
             return NULL;
         }
 
-        self->x11 = gsr_x11_hotkeys_new(xdisplay, on_x11_hotkey, self);
+        self->xdisplay = xdisplay;
+        self->x11_backend = configured_x11_backend(self);
+        self->x11 = gsr_x11_hotkeys_new(xdisplay, self->x11_backend,
+                                        on_x11_hotkey, self);
         if (!self->x11) {
             fprintf(stderr, "gsr warning: failed to create X11 hotkey watcher\n");
             free(self);
@@ -310,10 +346,10 @@ gsr_hotkeys_free(GsrHotkeys *self)
 #endif
 
 #ifdef HAVE_WAYLAND
-    if (self->wayland_initialized) {
-        gsr_global_shortcuts_deinit(&self->wayland);
-        self->wayland_initialized = false;
-    }
+    /* Also cancels a session request still waiting on the portal, so
+       on_wayland_init() can't fire into a freed window */
+    gsr_global_shortcuts_deinit(&self->wayland);
+    self->wayland_initialized = false;
 #endif
 
     free(self);
@@ -337,20 +373,15 @@ grab_hotkey_from_config(GsrHotkeys *self,
     if (keysym == 0)
         return;
 
-    GsrX11HotkeyCombo combo = { .modifiers = x11_mods, .keysym = (KeySym)keysym };
+    GsrX11HotkeyCombo combo = {
+        .modifiers = x11_mods,
+        .keysym    = (KeySym)keysym,
+        .on_press  = hk->trigger == GSR_HOTKEY_TRIGGER_PRESS,
+        .action    = action,
+    };
     if (!gsr_x11_hotkeys_grab(self->x11, combo)) {
         g_warning("Failed to grab hotkey (keysym=0x%lx, mods=0x%x)",
                   (unsigned long)keysym, x11_mods);
-        return;
-    }
-
-    if (self->n_active_combos < MAX_ACTIVE_COMBOS) {
-        self->active_combos[self->n_active_combos] = (GrabbedCombo){
-            .x11_modifiers = x11_mods,
-            .keysym = (KeySym)keysym,
-            .action = action,
-        };
-        self->n_active_combos++;
     }
 }
 
@@ -362,7 +393,7 @@ gsr_hotkeys_regrab_for_visible_page(GsrHotkeys *self)
 
     /* Ungrab everything first */
     gsr_x11_hotkeys_ungrab_all(self->x11);
-    self->n_active_combos = 0;
+    sync_x11_backend(self);
 
     const char *page = get_visible_page_name(self);
     if (!page)
@@ -393,6 +424,12 @@ gsr_hotkeys_regrab_for_visible_page(GsrHotkeys *self)
         grab_hotkey_from_config(self,
             &config->replay_config.save_hotkey,
             HOTKEY_ACTION_SAVE_REPLAY);
+        grab_hotkey_from_config(self,
+            &config->replay_config.save_short_hotkey,
+            HOTKEY_ACTION_SAVE_REPLAY_SHORT);
+        grab_hotkey_from_config(self,
+            &config->replay_config.save_long_hotkey,
+            HOTKEY_ACTION_SAVE_REPLAY_LONG);
     }
 }
 #endif /* HAVE_X11 */
@@ -413,7 +450,7 @@ gsr_hotkeys_register_wayland_shortcuts_once(GsrHotkeys *self)
 
     self->wayland_shortcuts_bound = true;
 
-    const gsr_bind_shortcut shortcuts[3] = {
+    const gsr_bind_shortcut shortcuts[] = {
         {
             .description = "Start/stop recording/replay/streaming",
             .shortcut = { .id = SHORTCUT_ID_START_STOP, .trigger_description = "ALT+1" },
@@ -426,9 +463,17 @@ gsr_hotkeys_register_wayland_shortcuts_once(GsrHotkeys *self)
             .description = "Save replay",
             .shortcut = { .id = SHORTCUT_ID_SAVE_REPLAY, .trigger_description = "ALT+3" },
         },
+        {
+            .description = "Save short replay",
+            .shortcut = { .id = SHORTCUT_ID_SAVE_REPLAY_SHORT, .trigger_description = "ALT+4" },
+        },
+        {
+            .description = "Save long replay",
+            .shortcut = { .id = SHORTCUT_ID_SAVE_REPLAY_LONG, .trigger_description = "ALT+5" },
+        },
     };
 
-    if (!gsr_global_shortcuts_bind_shortcuts(&self->wayland, shortcuts, 3,
+    if (!gsr_global_shortcuts_bind_shortcuts(&self->wayland, shortcuts, (int)G_N_ELEMENTS(shortcuts),
                                               on_wayland_shortcut_changed, self))
     {
         fprintf(stderr, "gsr warning: failed to bind Wayland shortcuts\n");
@@ -4,7 +4,7 @@
  * gsr-hotkeys.h — Unified hotkey manager for X11 and Wayland.
  *
  * Detects the display server at runtime and uses either:
- *   - X11: XGrabKey + GSource polling (gsr-x11-hotkeys)
+ *   - X11: XGrabKey or XInput2 raw events + GSource polling (gsr-x11-hotkeys)
  *   - Wayland: XDG GlobalShortcuts portal (global_shortcuts)
  *
  * Dispatches hotkey actions to the appropriate page based on the
@@ -1,9 +1,12 @@
 #include "gsr-info.h"
+#include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sys/wait.h>
 
+#include "gsr-trace.h"
+
 /* ── Helpers ─────────────────────────────────────────────────────── */
 
 static char *
@@ -83,12 +86,62 @@ typedef enum {
 typedef struct {
     GsrInfo     *info;
     InfoSection  section;
+    const char  *sysfs_root;    /* "/sys" */
     /* temporary growable monitor array */
     GsrMonitor  *monitors;
     int          n_monitors;
     int          monitors_capacity;
+    /* and DRM card array */
+    GsrDrmCard  *cards;
+    int          n_cards;
+    int          cards_capacity;
 } ParseState;
 
+/* ── DRM cards ───────────────────────────────────────────────────── */
+
+static GsrGpuVendor
+vendor_from_pci_id(guint64 id)
+{
+    switch (id) {
+    case 0x1002: return GSR_GPU_VENDOR_AMD;
+    case 0x8086: return GSR_GPU_VENDOR_INTEL;
+    case 0x10de: return GSR_GPU_VENDOR_NVIDIA;
+    case 0x14e4: return GSR_GPU_VENDOR_BROADCOM;
+    default:     return GSR_GPU_VENDOR_UNKNOWN;
+    }
+}
+
+/* A PCI card's device link ends in its slot, ../../../0000:01:00.0 */
+static void
+read_card_sysfs(GsrDrmCard *card, const char *sysfs_root)
+{
+    g_autofree char *name = g_path_get_basename(card->path);
+    g_autofree char *device = g_build_filename(sysfs_root, "class", "drm", name, "device", NULL);
+    g_autofree char *vendor_path = g_build_filename(device, "vendor", NULL);
+    g_autofree char *target = g_file_read_link(device, NULL);
+    g_autofree char *vendor = NULL;
+    if (!target || !g_file_get_contents(vendor_path, &vendor, NULL, NULL))
+        return;
+
+    card->pci_slot = g_path_get_basename(target);
+    card->vendor = vendor_from_pci_id(g_ascii_strtoull(vendor, NULL, 16));
+}
+
+static void
+add_card(ParseState *st, const char *line, size_t len)
+{
+    if (st->n_cards >= st->cards_capacity) {
+        st->cards_capacity = st->cards_capacity ? st->cards_capacity * 2 : 4;
+        st->cards = g_realloc_n(st->cards, (size_t)st->cards_capacity, sizeof(GsrDrmCard));
+    }
+    GsrDrmCard *card = &st->cards[st->n_cards++];
+    memset(card, 0, sizeof(*card));
+
+    const char *sep = memchr(line, '|', len);
+    card->path = g_strndup(line, sep ? (size_t)(sep - line) : len);
+    read_card_sysfs(card, st->sysfs_root);
+}
+
 static void
 parse_system_info(ParseState *st, const char *line, size_t len)
 {
@@ -159,8 +212,10 @@ parse_capture_options(ParseState *st, const char *line, size_t len)
         st->info->supported_capture_options.focused = true;
     } else if (str_eq(line, len, "portal")) {
         st->info->supported_capture_options.portal = true;
-    } else if (str_eq(line, len, "region") || (len > 0 && line[0] == '/')) {
-        /* skip "region" and DRM card paths */
+    } else if (str_eq(line, len, "region")) {
+        st->info->supported_capture_options.region = true;
+    } else if (len > 0 && line[0] == '/') {
+        add_card(st, line, len);
     } else {
         /* monitor entry: name|WxH */
         if (st->n_monitors >= st->monitors_capacity) {
@@ -213,30 +268,208 @@ info_line_cb(const char *line, size_t len, void *user_data)
     }
 }
 
-/* ── Public API ──────────────────────────────────────────────────── */
-
-GsrInfoExitStatus
-gsr_info_load(GsrInfo *info)
+/* Run an --info command into info; false if it didn't run at all.
+   The raw output goes to *output_out if given. */
+static bool
+load_info(GsrInfo *info, const char *cmd, const char *sysfs_root,
+          int *exit_code, char **output_out)
 {
     memset(info, 0, sizeof(*info));
 
-    int exit_code = -1;
-    char *output = read_command_output("gpu-screen-recorder --info", &exit_code);
-    if (!output) {
-        g_warning("'gpu-screen-recorder --info' failed to run");
-        return GSR_INFO_EXIT_FAILED_TO_RUN;
-    }
+    char *output = read_command_output(cmd, exit_code);
+    if (!output)
+        return false;
 
     ParseState st = {
         .info = info,
         .section = SECTION_UNKNOWN,
+        .sysfs_root = sysfs_root,
     };
     for_each_line(output, info_line_cb, &st);
-    g_free(output);
+    if (output_out)
+        *output_out = output;
+    else
+        g_free(output);
 
-    /* Transfer monitors */
+    /* Transfer monitors and cards */
     info->supported_capture_options.monitors = st.monitors;
     info->supported_capture_options.n_monitors = st.n_monitors;
+    info->gpu_info.cards = st.cards;
+    info->gpu_info.n_cards = st.n_cards;
+    return true;
+}
+
+/* What the recorder supports when it runs on this card */
+static void
+probe_card(GsrInfo *info, int index, const char *recorder, const char *sysfs_root)
+{
+    GsrDrmCard *card = &info->gpu_info.cards[index];
+    g_auto(GStrv) env = gsr_info_get_card_environ(info, index);
+    if (!env)
+        return;
+
+    GString *cmd = g_string_new("env");
+    for (int i = 0; env[i]; i++) {
+        g_autofree char *quoted = g_shell_quote(env[i]);
+        g_string_append_printf(cmd, " %s", quoted);
+    }
+    g_string_append_printf(cmd, " %s --info", recorder);
+
+    GsrInfo probe;
+    int exit_code = -1;
+    if (load_info(&probe, cmd->str, sysfs_root, &exit_code, NULL) && exit_code == 0) {
+        card->probed = true;
+        card->video_codecs = probe.supported_video_codecs;
+        card->n_monitors = probe.supported_capture_options.n_monitors;
+        if (probe.gpu_info.vendor != GSR_GPU_VENDOR_UNKNOWN)
+            card->vendor = probe.gpu_info.vendor;
+    } else {
+        g_warning("'%s' failed (exit code %d)", cmd->str, exit_code);
+    }
+    gsr_info_clear(&probe);
+    g_string_free(cmd, TRUE);
+}
+
+/* ── Probe cache ─────────────────────────────────────────────────── */
+
+static const struct {
+    const char *id;
+    size_t      offset;
+} codec_fields[] = {
+    { "h264",          offsetof(GsrSupportedVideoCodecs, h264) },
+    { "h264_software", offsetof(GsrSupportedVideoCodecs, h264_software) },
+    { "hevc",          offsetof(GsrSupportedVideoCodecs, hevc) },
+    { "hevc_hdr",      offsetof(GsrSupportedVideoCodecs, hevc_hdr) },
+    { "hevc_10bit",    offsetof(GsrSupportedVideoCodecs, hevc_10bit) },
+    { "av1",           offsetof(GsrSupportedVideoCodecs, av1) },
+    { "av1_hdr",       offsetof(GsrSupportedVideoCodecs, av1_hdr) },
+    { "av1_10bit",     offsetof(GsrSupportedVideoCodecs, av1_10bit) },
+    { "vp8",           offsetof(GsrSupportedVideoCodecs, vp8) },
+    { "vp9",           offsetof(GsrSupportedVideoCodecs, vp9) },
+};
+
+static bool *
+codec_field(GsrSupportedVideoCodecs *vc, size_t i)
+{
+    return (bool *)((char *)vc + codec_fields[i].offset);
+}
+
+/*
+ * The per-card probes, valid for as long as the plain --info output stays
+ * the same: a new driver, card or monitor changes it.  First line: that
+ * output's checksum.  Then one card per line: path, tab, probed (0/1),
+ * tab, vendor, tab, codecs (comma-separated), tab, monitors.
+ */
+static bool
+load_probe_cache(GsrInfo *info, const char *cache_path, const char *checksum)
+{
+    g_autofree char *contents = NULL;
+    if (!cache_path || !g_file_get_contents(cache_path, &contents, NULL, NULL))
+        return false;
+
+    g_auto(GStrv) lines = g_strsplit(contents, "\n", -1);
+    if (!lines[0] || !g_str_equal(lines[0], checksum))
+        return false;
+
+    int n_found = 0;
+    for (int i = 1; lines[i]; i++) {
+        g_auto(GStrv) fields = g_strsplit(lines[i], "\t", 5);
+        if (g_strv_length(fields) != 5)
+            continue;
+        int index = gsr_info_find_card(info, fields[0]);
+        if (index < 0)
+            continue;
+
+        GsrDrmCard *card = &info->gpu_info.cards[index];
+        card->probed = g_str_equal(fields[1], "1");
+        card->vendor = (GsrGpuVendor)g_ascii_strtoll(fields[2], NULL, 10);
+        memset(&card->video_codecs, 0, sizeof(card->video_codecs));
+        g_auto(GStrv) codecs = g_strsplit(fields[3], ",", -1);
+        for (size_t c = 0; c < G_N_ELEMENTS(codec_fields); c++)
+            *codec_field(&card->video_codecs, c) = g_strv_contains((const char *const *)codecs,
+                                                                   codec_fields[c].id);
+        card->n_monitors = (int)g_ascii_strtoll(fields[4], NULL, 10);
+        n_found++;
+    }
+    return n_found == info->gpu_info.n_cards;
+}
+
+static void
+save_probe_cache(const GsrInfo *info, const char *cache_path, const char *checksum)
+{
+    if (!cache_path)
+        return;
+
+    GString *contents = g_string_new(checksum);
+    g_string_append_c(contents, '\n');
+    for (int i = 0; i < info->gpu_info.n_cards; i++) {
+        const GsrDrmCard *card = &info->gpu_info.cards[i];
+        GsrSupportedVideoCodecs vc = card->video_codecs;
+        GString *codecs = g_string_new(NULL);
+        for (size_t c = 0; c < G_N_ELEMENTS(codec_fields); c++) {
+            if (!*codec_field(&vc, c))
+                continue;
+            if (codecs->len > 0)
+                g_string_append_c(codecs, ',');
+            g_string_append(codecs, codec_fields[c].id);
+        }
+        g_string_append_printf(contents, "%s\t%d\t%d\t%s\t%d\n", card->path,
+                               card->probed ? 1 : 0, (int)card->vendor, codecs->str,
+                               card->n_monitors);
+        g_string_free(codecs, TRUE);
+    }
+
+    g_autofree char *dir = g_path_get_dirname(cache_path);
+    g_mkdir_with_parents(dir, 0755);
+
+    GError *error = NULL;
+    if (!g_file_set_contents(cache_path, contents->str, (gssize)contents->len, &error)) {
+        g_warning("Failed to save GPU probes: %s", error->message);
+        g_error_free(error);
+    }
+    g_string_free(contents, TRUE);
+}
+
+/* ── Loading ─────────────────────────────────────────────────────── */
+
+/* recorder is the command to run, already quoted for the shell, and
+   sysfs_root where /sys is; the tests point both at stand-ins */
+static GsrInfoExitStatus
+info_load(GsrInfo *info, const char *cache_path, const char *recorder,
+          const char *sysfs_root)
+{
+    gint64 trace_begin = GSR_TRACE_CURRENT_TIME;
+
+    int exit_code = -1;
+    g_autofree char *output = NULL;
+    g_autofree char *cmd = g_strdup_printf("%s --info", recorder);
+    if (!load_info(info, cmd, sysfs_root, &exit_code, &output)) {
+        g_warning("'%s' failed to run", cmd);
+        GSR_TRACE_MARK(trace_begin, "gsr_info_load", "failed to run");
+        return GSR_INFO_EXIT_FAILED_TO_RUN;
+    }
+
+    /* Versions that save the last N seconds on SIGRTMIN+N say so in their
+       usage; older ones exit on those signals */
+    if (exit_code == 0) {
+        g_autofree char *help_cmd = g_strdup_printf("%s --help 2>&1", recorder);
+        g_autofree char *help = read_command_output(help_cmd, NULL);
+        info->system_info.supports_partial_saves = help && strstr(help, "SIGRTMIN+1");
+    }
+
+    /* Only a choice of cards is worth a probe each, and only once per setup */
+    if (exit_code == 0 && info->gpu_info.n_cards > 1) {
+        g_autofree char *checksum = g_compute_checksum_for_string(G_CHECKSUM_SHA256, output, -1);
+        if (!load_probe_cache(info, cache_path, checksum)) {
+            for (int i = 0; i < info->gpu_info.n_cards; i++)
+                probe_card(info, i, recorder, sysfs_root);
+            save_probe_cache(info, cache_path, checksum);
+        }
+    }
+
+    GSR_TRACE_MARK(trace_begin, "gsr_info_load", "exit=%d monitors=%d cards=%d",
+                   exit_code, info->supported_capture_options.n_monitors,
+                   info->gpu_info.n_cards);
 
     switch (exit_code) {
     case 0:  return GSR_INFO_EXIT_OK;
@@ -246,21 +479,42 @@ gsr_info_load(GsrInfo *info)
     }
 }
 
+/* ── Public API ──────────────────────────────────────────────────── */
+
+GsrInfoExitStatus
+gsr_info_load(GsrInfo *info, const char *cache_path)
+{
+    return info_load(info, cache_path, "gpu-screen-recorder", "/sys");
+}
+
 void
 gsr_info_clear(GsrInfo *info)
 {
     for (int i = 0; i < info->supported_capture_options.n_monitors; i++)
         g_free(info->supported_capture_options.monitors[i].name);
     g_free(info->supported_capture_options.monitors);
+    for (int i = 0; i < info->gpu_info.n_cards; i++) {
+        g_free(info->gpu_info.cards[i].path);
+        g_free(info->gpu_info.cards[i].pci_slot);
+    }
+    g_free(info->gpu_info.cards);
     memset(info, 0, sizeof(*info));
 }
 
+static const GsrSupportedVideoCodecs *
+get_video_codecs(const GsrInfo *info, int card)
+{
+    if (card >= 0 && card < info->gpu_info.n_cards && info->gpu_info.cards[card].probed)
+        return &info->gpu_info.cards[card].video_codecs;
+    return &info->supported_video_codecs;
+}
+
 bool
-gsr_info_is_codec_supported(const GsrInfo *info, const char *codec_id)
+gsr_info_is_codec_supported(const GsrInfo *info, int card, const char *codec_id)
 {
     if (g_strcmp0(codec_id, "auto") == 0)        return true;
 
-    const GsrSupportedVideoCodecs *vc = &info->supported_video_codecs;
+    const GsrSupportedVideoCodecs *vc = get_video_codecs(info, card);
     if (g_strcmp0(codec_id, "h264") == 0)           return vc->h264;
     if (g_strcmp0(codec_id, "h264_software") == 0)  return vc->h264_software;
     if (g_strcmp0(codec_id, "hevc") == 0)           return vc->hevc;
@@ -278,7 +532,8 @@ bool
 gsr_info_is_capture_option_enabled(const GsrInfo *info, const char *option_id)
 {
     if (info->system_info.display_server == GSR_DISPLAY_SERVER_WAYLAND) {
-        if (g_strcmp0(option_id, "window") == 0 || g_strcmp0(option_id, "focused") == 0)
+        if (g_strcmp0(option_id, "window") == 0 || g_strcmp0(option_id, "focused") == 0 ||
+            g_strcmp0(option_id, "region") == 0)
             return false;
     }
     if (g_strcmp0(option_id, "portal") == 0)
@@ -287,9 +542,9 @@ gsr_info_is_capture_option_enabled(const GsrInfo *info, const char *option_id)
 }
 
 const char *
-gsr_info_get_first_usable_hw_video_codec(const GsrInfo *info)
+gsr_info_get_first_usable_hw_video_codec(const GsrInfo *info, int card)
 {
-    const GsrSupportedVideoCodecs *vc = &info->supported_video_codecs;
+    const GsrSupportedVideoCodecs *vc = get_video_codecs(info, card);
     if (vc->h264) return "h264";
     if (vc->hevc) return "hevc";
     if (vc->av1)  return "av1";
@@ -298,6 +553,43 @@ gsr_info_get_first_usable_hw_video_codec(const GsrInfo *info)
     return NULL;
 }
 
+int
+gsr_info_find_card(const GsrInfo *info, const char *path)
+{
+    for (int i = 0; path && i < info->gpu_info.n_cards; i++) {
+        if (g_str_equal(info->gpu_info.cards[i].path, path))
+            return i;
+    }
+    return -1;
+}
+
+char **
+gsr_info_get_card_environ(const GsrInfo *info, int index)
+{
+    if (index < 0 || index >= info->gpu_info.n_cards)
+        return NULL;
+    const GsrDrmCard *card = &info->gpu_info.cards[index];
+
+    /* Offloading only says "NVIDIA": the driver picks which of its GPUs,
+       so with two of them neither can be chosen */
+    if (card->vendor == GSR_GPU_VENDOR_NVIDIA) {
+        for (int i = 0; i < info->gpu_info.n_cards; i++) {
+            if (i != index && info->gpu_info.cards[i].vendor == GSR_GPU_VENDOR_NVIDIA)
+                return NULL;
+        }
+        char *env[] = { "__NV_PRIME_RENDER_OFFLOAD=1", NULL };
+        return g_strdupv(env);
+    }
+    if (!card->pci_slot)
+        return NULL;
+
+    /* Mesa takes the slot as pci-0000_01_00_0 */
+    g_autofree char *tag = g_strdelimit(g_strdup(card->pci_slot), ":.", '_');
+    char **env = g_new0(char *, 2);
+    env[0] = g_strdup_printf("DRI_PRIME=pci-%s", tag);
+    return env;
+}
+
 /* ── Audio device queries ────────────────────────────────────────── */
 
 GsrAudioDevice *
@@ -35,12 +35,9 @@ typedef struct {
     GsrDisplayServer display_server;
     bool             supports_app_audio;
     bool             is_steam_deck;
+    bool             supports_partial_saves; /* SIGRTMIN+N, from --help */
 } GsrSystemInfo;
 
-typedef struct {
-    GsrGpuVendor vendor;
-} GsrGpuInfo;
-
 typedef struct {
     bool h264;
     bool h264_software;
@@ -54,6 +51,22 @@ typedef struct {
     bool vp9;
 } GsrSupportedVideoCodecs;
 
+/* A DRM card the recorder can run on */
+typedef struct {
+    char                    *path;         /* "/dev/dri/card1", owned */
+    char                    *pci_slot;     /* "0000:01:00.0", owned, NULL if not PCI */
+    GsrGpuVendor             vendor;
+    bool                     probed;       /* fields below are valid */
+    GsrSupportedVideoCodecs  video_codecs;
+    int                      n_monitors;   /* connected to this card */
+} GsrDrmCard;
+
+typedef struct {
+    GsrGpuVendor vendor;      /* of the card the recorder picks itself */
+    GsrDrmCard  *cards;       /* owned array */
+    int          n_cards;
+} GsrGpuInfo;
+
 typedef struct {
     char *name;       /* owned */
     int   width;
@@ -64,6 +77,7 @@ typedef struct {
     bool         window;
     bool         focused;
     bool         portal;
+    bool         region;      /* -w region -region WxH+X+Y */
     GsrMonitor  *monitors;    /* owned array */
     int          n_monitors;
 } GsrSupportedCaptureOptions;
@@ -84,11 +98,22 @@ typedef struct {
 
 /* ── Functions ───────────────────────────────────────────────────── */
 
-GsrInfoExitStatus  gsr_info_load          (GsrInfo *info);
+/**
+ * Run gpu-screen-recorder --info, and --help for what it can save.  With
+ * more than one card, each is probed too; the probes are kept in cache_path (may be NULL) and redone only
+ * when the --info output changes.
+ */
+GsrInfoExitStatus  gsr_info_load          (GsrInfo    *info,
+                                           const char *cache_path);
 void               gsr_info_clear         (GsrInfo *info);
 
+/**
+ * card indexes gpu_info.cards; -1 (or a card that couldn't be probed)
+ * means the card the recorder picks itself.
+ */
 bool               gsr_info_is_codec_supported
                                            (const GsrInfo *info,
+                                            int            card,
                                             const char    *codec_id);
 
 bool               gsr_info_is_capture_option_enabled
@@ -99,7 +124,23 @@ bool               gsr_info_is_capture_option_enabled
  * Returns the first usable HW video codec name (h264 > hevc > av1 > vp8 > vp9),
  * or NULL if none supported.
  */
-const char        *gsr_info_get_first_usable_hw_video_codec(const GsrInfo *info);
+const char        *gsr_info_get_first_usable_hw_video_codec(const GsrInfo *info,
+                                                            int            card);
+
+/**
+ * Index of the card at path in gpu_info.cards, or -1.
+ */
+int                gsr_info_find_card     (const GsrInfo *info,
+                                           const char    *path);
+
+/**
+ * Environment variables ("NAME=value") that make the recorder run on
+ * gpu_info.cards[card]: DRI_PRIME for Mesa drivers, PRIME render offload
+ * for NVIDIA.  NULL if the environment can't single the card out (not
+ * PCI, or one of two NVIDIA cards).  Caller must g_strfreev().
+ */
+char             **gsr_info_get_card_environ(const GsrInfo *info,
+                                             int            card);
 
 /* Audio device / application queries (separate commands) */
 GsrAudioDevice    *gsr_audio_devices_get  (int *n_devices);
@@ -0,0 +1,256 @@
+#include "gsr-ingest-probe.h"
+
+#include <gio/gio.h>
+
+typedef struct {
+    char  *host;
+    gint64 rtt_us;
+    gint64 probed_at;       /* wall clock, µs */
+} CacheEntry;
+
+struct _GsrIngestProbe {
+    char       *cache_path;
+    GHashTable *cache;      /* service → CacheEntry* */
+    GHashTable *runs;       /* service → Run*, borrowed */
+};
+
+typedef struct {
+    GsrIngestProbe    *probe;        /* NULL once the prober is freed */
+    char              *service;
+    GCancellable      *cancellable;
+    guint              deadline_id;
+    int                n_pending;
+    char              *best_host;
+    gint64             best_rtt_us;
+    GsrIngestProbeFunc callback;
+    gpointer           user_data;
+} Run;
+
+typedef struct {
+    Run   *run;
+    char  *host;
+    gint64 connecting_us;   /* last connect() started, 0 if none yet */
+    gint64 rtt_us;          /* -1 until connected */
+} Attempt;
+
+/* ── Cache ───────────────────────────────────────────────────────── */
+
+static void
+cache_entry_free(CacheEntry *entry)
+{
+    g_free(entry->host);
+    g_free(entry);
+}
+
+/* One service per line: service, tab, host, tab, rtt µs, tab, time µs */
+static void
+load_cache(GsrIngestProbe *self)
+{
+    g_autofree char *contents = NULL;
+    if (!g_file_get_contents(self->cache_path, &contents, NULL, NULL))
+        return;
+
+    g_auto(GStrv) lines = g_strsplit(contents, "\n", -1);
+    for (int i = 0; lines[i]; i++) {
+        g_auto(GStrv) fields = g_strsplit(lines[i], "\t", 4);
+        if (g_strv_length(fields) != 4)
+            continue;
+        CacheEntry *entry = g_new0(CacheEntry, 1);
+        entry->host = g_strdup(fields[1]);
+        entry->rtt_us = g_ascii_strtoll(fields[2], NULL, 10);
+        entry->probed_at = g_ascii_strtoll(fields[3], NULL, 10);
+        g_hash_table_replace(self->cache, g_strdup(fields[0]), entry);
+    }
+}
+
+static void
+save_cache(GsrIngestProbe *self)
+{
+    GString *contents = g_string_new(NULL);
+    GHashTableIter iter;
+    gpointer key, value;
+    g_hash_table_iter_init(&iter, self->cache);
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
+        const CacheEntry *entry = value;
+        g_string_append_printf(contents, "%s\t%s\t%" G_GINT64_FORMAT "\t%" G_GINT64_FORMAT "\n",
+                               (const char *)key, entry->host, entry->rtt_us, entry->probed_at);
+    }
+
+    g_autofree char *dir = g_path_get_dirname(self->cache_path);
+    g_mkdir_with_parents(dir, 0755);
+
+    GError *error = NULL;
+    if (!g_file_set_contents(self->cache_path, contents->str, (gssize)contents->len, &error)) {
+        g_warning("Failed to save ingest servers: %s", error->message);
+        g_error_free(error);
+    }
+    g_string_free(contents, TRUE);
+}
+
+/* ── Probing ─────────────────────────────────────────────────────── */
+
+static void
+finish_run(Run *run)
+{
+    g_clear_handle_id(&run->deadline_id, g_source_remove);
+
+    GsrIngestProbe *self = run->probe;
+    if (self) {
+        g_hash_table_remove(self->runs, run->service);
+        if (run->best_host) {
+            CacheEntry *entry = g_new0(CacheEntry, 1);
+            entry->host = g_strdup(run->best_host);
+            entry->rtt_us = run->best_rtt_us;
+            entry->probed_at = g_get_real_time();
+            g_hash_table_replace(self->cache, g_strdup(run->service), entry);
+            save_cache(self);
+        }
+        g_debug("Ingest for %s: %s (%" G_GINT64_FORMAT " µs)", run->service,
+                run->best_host ? run->best_host : "none", run->best_rtt_us);
+        if (run->callback)
+            run->callback(run->service, run->best_host, run->best_rtt_us, run->user_data);
+    }
+
+    g_object_unref(run->cancellable);
+    g_free(run->service);
+    g_free(run->best_host);
+    g_free(run);
+}
+
+static gboolean
+on_deadline(gpointer user_data)
+{
+    Run *run = user_data;
+    run->deadline_id = 0;
+    g_cancellable_cancel(run->cancellable);
+    return G_SOURCE_REMOVE;
+}
+
+/* Time the handshake only, not the name lookup */
+static void
+on_client_event(GSocketClient      *client G_GNUC_UNUSED,
+                GSocketClientEvent  event,
+                GSocketConnectable *connectable G_GNUC_UNUSED,
+                GIOStream          *connection G_GNUC_UNUSED,
+                gpointer            user_data)
+{
+    Attempt *attempt = user_data;
+    if (event == G_SOCKET_CLIENT_CONNECTING)
+        attempt->connecting_us = g_get_monotonic_time();
+    else if (event == G_SOCKET_CLIENT_CONNECTED && attempt->connecting_us > 0)
+        attempt->rtt_us = g_get_monotonic_time() - attempt->connecting_us;
+}
+
+static void
+on_connected(GObject *source, GAsyncResult *result, gpointer user_data)
+{
+    Attempt *attempt = user_data;
+    Run *run = attempt->run;
+
+    GSocketConnection *conn = g_socket_client_connect_to_host_finish(
+        G_SOCKET_CLIENT(source), result, NULL);
+    if (conn && attempt->rtt_us >= 0 &&
+        (!run->best_host || attempt->rtt_us < run->best_rtt_us))
+    {
+        g_free(run->best_host);
+        run->best_host = g_strdup(attempt->host);
+        run->best_rtt_us = attempt->rtt_us;
+    }
+    g_clear_object(&conn);
+
+    g_signal_handlers_disconnect_by_data(source, attempt);
+    g_object_unref(source);
+    g_free(attempt->host);
+    g_free(attempt);
+
+    if (--run->n_pending == 0)
+        finish_run(run);
+}
+
+/* ── Public API ──────────────────────────────────────────────────── */
+
+GsrIngestProbe *
+gsr_ingest_probe_new(const char *cache_path)
+{
+    GsrIngestProbe *self = g_new0(GsrIngestProbe, 1);
+    self->cache_path = g_strdup(cache_path);
+    self->cache = g_hash_table_new_full(g_str_hash, g_str_equal, g_free,
+                                        (GDestroyNotify)cache_entry_free);
+    self->runs = g_hash_table_new(g_str_hash, g_str_equal);
+    load_cache(self);
+    return self;
+}
+
+void
+gsr_ingest_probe_free(GsrIngestProbe *self)
+{
+    if (!self)
+        return;
+
+    /* Runs free themselves once their connects come back cancelled */
+    GHashTableIter iter;
+    gpointer value;
+    g_hash_table_iter_init(&iter, self->runs);
+    while (g_hash_table_iter_next(&iter, NULL, &value)) {
+        Run *run = value;
+        run->probe = NULL;
+        g_cancellable_cancel(run->cancellable);
+    }
+
+    g_hash_table_destroy(self->runs);
+    g_hash_table_destroy(self->cache);
+    g_free(self->cache_path);
+    g_free(self);
+}
+
+const char *
+gsr_ingest_probe_get_best(GsrIngestProbe *self, const char *service,
+                          const char *const *hosts, gint64 *rtt_us)
+{
+    g_return_val_if_fail(self != NULL && service != NULL, NULL);
+
+    const CacheEntry *entry = g_hash_table_lookup(self->cache, service);
+    if (!entry ||
+        g_get_real_time() - entry->probed_at > (gint64)GSR_INGEST_PROBE_TTL_S * G_USEC_PER_SEC ||
+        !hosts || !g_strv_contains(hosts, entry->host))
+        return NULL;
+
+    if (rtt_us)
+        *rtt_us = entry->rtt_us;
+    return entry->host;
+}
+
+void
+gsr_ingest_probe_run(GsrIngestProbe *self, const char *service,
+                     const char *const *hosts, guint16 default_port,
+                     GsrIngestProbeFunc callback, gpointer user_data)
+{
+    g_return_if_fail(self != NULL && service != NULL);
+
+    if (!hosts || !hosts[0] || g_hash_table_contains(self->runs, service))
+        return;
+
+    Run *run = g_new0(Run, 1);
+    run->probe = self;
+    run->service = g_strdup(service);
+    run->cancellable = g_cancellable_new();
+    run->best_rtt_us = -1;
+    run->callback = callback;
+    run->user_data = user_data;
+    g_hash_table_insert(self->runs, run->service, run);
+
+    /* All at once, so the slowest host costs the deadline at most */
+    for (int i = 0; hosts[i]; i++) {
+        Attempt *attempt = g_new0(Attempt, 1);
+        attempt->run = run;
+        attempt->host = g_strdup(hosts[i]);
+        attempt->rtt_us = -1;
+
+        GSocketClient *client = g_socket_client_new();
+        g_signal_connect(client, "event", G_CALLBACK(on_client_event), attempt);
+        g_socket_client_connect_to_host_async(client, hosts[i], default_port,
+                                              run->cancellable, on_connected, attempt);
+        run->n_pending++;
+    }
+    run->deadline_id = g_timeout_add(GSR_INGEST_PROBE_DEADLINE_MS, on_deadline, run);
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+/*
+ * gsr-ingest-probe.h — Pick the closest ingest server for a service.
+ *
+ * Connects to every candidate host at once and times the TCP handshake
+ * alone (from the connect() of the resolved address to its completion,
+ * so DNS doesn't count).  Hosts that haven't connected by the deadline
+ * are out.  The fastest host is cached per service, in memory and in a
+ * small file, and reused until the TTL runs out or the candidate list
+ * no longer has it.
+ */
+
+#include <glib.h>
+
+#define GSR_INGEST_PROBE_DEADLINE_MS  1500
+#define GSR_INGEST_PROBE_TTL_S        (30 * 60)
+
+typedef struct _GsrIngestProbe GsrIngestProbe;
+
+/*
+ * A probe finished.  best_host is NULL if no candidate connected in time;
+ * rtt_us is its handshake time.
+ */
+typedef void (*GsrIngestProbeFunc)(const char *service, const char *best_host,
+                                   gint64 rtt_us, gpointer user_data);
+
+/**
+ * Create a prober keeping its results in cache_path.
+ */
+GsrIngestProbe *gsr_ingest_probe_new     (const char *cache_path);
+
+/**
+ * Cancel running probes and free.  No callbacks happen after this.
+ */
+void            gsr_ingest_probe_free    (GsrIngestProbe *self);
+
+/**
+ * The cached best of hosts for service, or NULL if there is none, it's
+ * older than GSR_INGEST_PROBE_TTL_S or not in hosts.  rtt_us may be NULL.
+ */
+const char     *gsr_ingest_probe_get_best(GsrIngestProbe    *self,
+                                          const char        *service,
+                                          const char *const *hosts,
+                                          gint64            *rtt_us);
+
+/**
+ * Probe hosts ("host" or "host:port", default_port otherwise) for
+ * service, unless a probe for it is running already.  callback may be
+ * NULL.
+ */
+void            gsr_ingest_probe_run     (GsrIngestProbe    *self,
+                                          const char        *service,
+                                          const char *const *hosts,
+                                          guint16            default_port,
+                                          GsrIngestProbeFunc callback,
+                                          gpointer           user_data);
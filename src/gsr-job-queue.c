@@ -0,0 +1,315 @@
+#include "gsr-job-queue.h"
+
+#include <errno.h>
+#include <signal.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <glib/gstdio.h>
+
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+
+#define JOB_NICE              10
+#define IOPRIO_WHO_PROCESS    1
+#define IOPRIO_CLASS_IDLE     3
+#define IOPRIO_CLASS_SHIFT    13
+
+typedef struct {
+    GsrJobQueue *queue;     /* back pointer for the child watch */
+    char        *file;
+    char        *command;
+    GPid         pid;       /* 0 until started; also the process group */
+    guint        watch_id;
+} Job;
+
+struct _GsrJobQueue {
+    char              *state_path;
+    GQueue             jobs;        /* Job*, in the order they were added */
+    int                max_jobs;
+    int                n_running;
+    gboolean           paused;
+    GsrJobFinishedFunc callback;
+    gpointer           user_data;
+};
+
+/* ── Jobs ────────────────────────────────────────────────────────── */
+
+static Job *
+job_new(GsrJobQueue *queue, const char *file, const char *command)
+{
+    Job *job = g_new0(Job, 1);
+    job->queue = queue;
+    job->file = g_strdup(file);
+    job->command = g_strdup(command);
+    return job;
+}
+
+static void
+job_free(Job *job)
+{
+    g_free(job->file);
+    g_free(job->command);
+    g_free(job);
+}
+
+/* Runs in the forked child, before exec */
+static void
+job_child_setup(gpointer user_data G_GNUC_UNUSED)
+{
+    /* Own process group, so pausing/killing reaches shell pipelines too */
+    setpgid(0, 0);
+
+    /* Best effort: a job that can't be deprioritised still runs */
+    (void)setpriority(PRIO_PROCESS, 0, JOB_NICE);
+#if defined(__linux__) && defined(SYS_ioprio_set)
+    (void)syscall(SYS_ioprio_set, IOPRIO_WHO_PROCESS, 0,
+                  IOPRIO_CLASS_IDLE << IOPRIO_CLASS_SHIFT);
+#endif
+}
+
+static char **
+build_argv(const char *command, const char *file, GError **error)
+{
+    char **argv = NULL;
+    if (!g_shell_parse_argv(command, NULL, &argv, error))
+        return NULL;
+
+    gboolean has_placeholder = FALSE;
+    for (int i = 0; argv[i]; i++) {
+        if (!strstr(argv[i], "{file}"))
+            continue;
+        GString *arg = g_string_new(argv[i]);
+        g_string_replace(arg, "{file}", file, 0);
+        g_free(argv[i]);
+        argv[i] = g_string_free(arg, FALSE);
+        has_placeholder = TRUE;
+    }
+
+    if (!has_placeholder) {
+        guint n = g_strv_length(argv);
+        argv = g_renew(char *, argv, n + 2);
+        argv[n] = g_strdup(file);
+        argv[n + 1] = NULL;
+    }
+    return argv;
+}
+
+/* ── State file ──────────────────────────────────────────────────── */
+
+/* One job per line: escaped file, tab, escaped command */
+static void
+save_state(GsrJobQueue *self)
+{
+    if (g_queue_is_empty(&self->jobs)) {
+        if (g_unlink(self->state_path) != 0 && errno != ENOENT)
+            g_warning("Failed to remove %s: %s", self->state_path, g_strerror(errno));
+        return;
+    }
+
+    GString *contents = g_string_new(NULL);
+    for (GList *l = self->jobs.head; l; l = l->next) {
+        const Job *job = l->data;
+        g_autofree char *file = g_strescape(job->file, NULL);
+        g_autofree char *command = g_strescape(job->command, NULL);
+        g_string_append_printf(contents, "%s\t%s\n", file, command);
+    }
+
+    g_autofree char *dir = g_path_get_dirname(self->state_path);
+    g_mkdir_with_parents(dir, 0755);
+
+    GError *error = NULL;
+    if (!g_file_set_contents(self->state_path, contents->str, (gssize)contents->len, &error)) {
+        g_warning("Failed to save post-processing queue: %s", error->message);
+        g_error_free(error);
+    }
+    g_string_free(contents, TRUE);
+}
+
+static void
+load_state(GsrJobQueue *self)
+{
+    g_autofree char *contents = NULL;
+    if (!g_file_get_contents(self->state_path, &contents, NULL, NULL))
+        return;
+
+    g_auto(GStrv) lines = g_strsplit(contents, "\n", -1);
+    for (int i = 0; lines[i]; i++) {
+        char *tab = strchr(lines[i], '\t');
+        if (!tab)
+            continue;
+        *tab = '\0';
+        g_autofree char *file = g_strcompress(lines[i]);
+        g_autofree char *command = g_strcompress(tab + 1);
+        g_queue_push_tail(&self->jobs, job_new(self, file, command));
+    }
+}
+
+/* ── Scheduling ──────────────────────────────────────────────────── */
+
+static void schedule(GsrJobQueue *self);
+
+static void
+finish_job(GsrJobQueue *self, GList *link, int exit_status)
+{
+    Job *job = link->data;
+    g_queue_delete_link(&self->jobs, link);
+    save_state(self);
+
+    if (self->callback)
+        self->callback(job->file, job->command, exit_status, self->user_data);
+    job_free(job);
+}
+
+static void
+on_job_exited(GPid pid, gint wait_status, gpointer user_data)
+{
+    Job *job = user_data;
+    GsrJobQueue *self = job->queue;
+
+    g_spawn_close_pid(pid);
+    job->watch_id = 0;
+    self->n_running--;
+
+    int exit_status = WIFEXITED(wait_status) ? WEXITSTATUS(wait_status) : -1;
+    finish_job(self, g_queue_find(&self->jobs, job), exit_status);
+    schedule(self);
+}
+
+static gboolean
+start_job(GsrJobQueue *self, Job *job)
+{
+    GError *error = NULL;
+    g_auto(GStrv) argv = build_argv(job->command, job->file, &error);
+    if (!argv ||
+        !g_spawn_async(NULL, argv, NULL,
+                       G_SPAWN_SEARCH_PATH | G_SPAWN_DO_NOT_REAP_CHILD |
+                       G_SPAWN_STDOUT_TO_DEV_NULL,
+                       job_child_setup, NULL, &job->pid, &error))
+    {
+        g_warning("Failed to run \"%s\": %s", job->command, error->message);
+        g_error_free(error);
+        return FALSE;
+    }
+
+    job->watch_id = g_child_watch_add(job->pid, on_job_exited, job);
+    self->n_running++;
+    g_debug("Post-processing %s: %s (pid=%d)", job->file, job->command, job->pid);
+    return TRUE;
+}
+
+/* Jobs for one file run in order: wait for any earlier one */
+static gboolean
+has_earlier_job_for_file(GList *link)
+{
+    const Job *job = link->data;
+    for (GList *l = link->prev; l; l = l->prev) {
+        if (g_str_equal(((const Job *)l->data)->file, job->file))
+            return TRUE;
+    }
+    return FALSE;
+}
+
+static void
+schedule(GsrJobQueue *self)
+{
+    if (self->paused)
+        return;
+
+    GList *l = self->jobs.head;
+    while (l && self->n_running < self->max_jobs) {
+        GList *next = l->next;
+        Job *job = l->data;
+        if (job->pid == 0 && !has_earlier_job_for_file(l) && !start_job(self, job))
+            finish_job(self, l, -1);
+        l = next;
+    }
+}
+
+/* ── Public API ──────────────────────────────────────────────────── */
+
+GsrJobQueue *
+gsr_job_queue_new(const char *state_path, GsrJobFinishedFunc callback,
+                  gpointer user_data)
+{
+    GsrJobQueue *self = g_new0(GsrJobQueue, 1);
+    self->state_path = g_strdup(state_path);
+    g_queue_init(&self->jobs);
+    self->max_jobs = 1;
+    self->callback = callback;
+    self->user_data = user_data;
+
+    load_state(self);
+    schedule(self);
+    return self;
+}
+
+void
+gsr_job_queue_free(GsrJobQueue *self)
+{
+    if (!self)
+        return;
+
+    /* Running jobs stay in the state file and start over next time */
+    for (GList *l = self->jobs.head; l; l = l->next) {
+        Job *job = l->data;
+        if (job->pid == 0)
+            continue;
+        g_clear_handle_id(&job->watch_id, g_source_remove);
+        kill(-job->pid, SIGTERM);
+        kill(-job->pid, SIGCONT);
+        g_spawn_close_pid(job->pid);
+    }
+
+    g_queue_clear_full(&self->jobs, (GDestroyNotify)job_free);
+    g_free(self->state_path);
+    g_free(self);
+}
+
+void
+gsr_job_queue_set_max_jobs(GsrJobQueue *self, int max_jobs)
+{
+    g_return_if_fail(self != NULL);
+    self->max_jobs = MAX(max_jobs, 1);
+    schedule(self);
+}
+
+void
+gsr_job_queue_add(GsrJobQueue *self, const char *file,
+                  const char *const *commands, int n_commands)
+{
+    g_return_if_fail(self != NULL && file != NULL);
+
+    for (int i = 0; i < n_commands; i++) {
+        if (commands[i] && commands[i][0])
+            g_queue_push_tail(&self->jobs, job_new(self, file, commands[i]));
+    }
+    save_state(self);
+    schedule(self);
+}
+
+void
+gsr_job_queue_set_paused(GsrJobQueue *self, gboolean paused)
+{
+    g_return_if_fail(self != NULL);
+    if (self->paused == paused)
+        return;
+    self->paused = paused;
+
+    for (GList *l = self->jobs.head; l; l = l->next) {
+        const Job *job = l->data;
+        if (job->pid != 0)
+            kill(-job->pid, paused ? SIGSTOP : SIGCONT);
+    }
+    schedule(self);
+}
+
+guint
+gsr_job_queue_get_n_jobs(GsrJobQueue *self)
+{
+    g_return_val_if_fail(self != NULL, 0);
+    return g_queue_get_length(&self->jobs);
+}
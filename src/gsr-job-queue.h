@@ -0,0 +1,61 @@
+#pragma once
+
+/*
+ * gsr-job-queue.h — Background post-processing of saved recordings.
+ *
+ * Each job runs one external command on one saved file.  Jobs for the
+ * same file run in the order they were added; jobs for different files
+ * run in parallel up to max_jobs.  Commands run at nice 10 with idle I/O
+ * priority and are stopped (SIGSTOP) while the queue is paused, e.g.
+ * during a capture.  Pending and running jobs are written to a state
+ * file, so jobs cut short by quitting run again on the next start.
+ */
+
+#include <glib.h>
+
+typedef struct _GsrJobQueue GsrJobQueue;
+
+/*
+ * A job finished.  exit_status is the command's exit code, or -1 if it
+ * couldn't be started or was killed by a signal.
+ */
+typedef void (*GsrJobFinishedFunc)(const char *file, const char *command,
+                                   int exit_status, gpointer user_data);
+
+/**
+ * Create a queue, loading jobs left in state_path by a previous run;
+ * those start right away.
+ */
+GsrJobQueue *gsr_job_queue_new       (const char        *state_path,
+                                      GsrJobFinishedFunc callback,
+                                      gpointer           user_data);
+
+/**
+ * Kill running commands and free the queue.  Unfinished jobs stay in the
+ * state file.
+ */
+void         gsr_job_queue_free      (GsrJobQueue *self);
+
+/**
+ * Maximum number of commands running at once (at least 1).
+ */
+void         gsr_job_queue_set_max_jobs(GsrJobQueue *self, int max_jobs);
+
+/**
+ * Queue one job per command for file.  "{file}" in a command is replaced
+ * by the path; a command without it gets the path as last argument.
+ */
+void         gsr_job_queue_add       (GsrJobQueue       *self,
+                                      const char        *file,
+                                      const char *const *commands,
+                                      int                n_commands);
+
+/**
+ * Pause (SIGSTOP running commands, start no new ones) or resume.
+ */
+void         gsr_job_queue_set_paused(GsrJobQueue *self, gboolean paused);
+
+/**
+ * Number of jobs not finished yet, running ones included.
+ */
+guint        gsr_job_queue_get_n_jobs(GsrJobQueue *self);
@@ -0,0 +1,75 @@
+#include "gsr-latency-histogram.h"
+
+#include <string.h>
+
+#define SUB_BUCKETS   (1 << GSR_LATENCY_SUB_BUCKET_BITS)
+#define LINEAR_LIMIT  (2 * SUB_BUCKETS)      /* values below this are exact */
+#define MAX_VALUE     ((gint64)G_MAXINT32)
+
+/* ── Bucket mapping ──────────────────────────────────────────────── */
+
+static int
+bucket_index(gint64 value)
+{
+    if (value < LINEAR_LIMIT)
+        return (int)value;
+
+    /* Keep the top GSR_LATENCY_SUB_BUCKET_BITS + 1 bits of the value */
+    int msb = 63 - __builtin_clzll((unsigned long long)value);
+    int shift = msb - GSR_LATENCY_SUB_BUCKET_BITS;
+    return shift * SUB_BUCKETS + (int)(value >> shift);
+}
+
+static gint64
+bucket_upper_bound(int index)
+{
+    if (index < LINEAR_LIMIT)
+        return index;
+
+    int shift = index / SUB_BUCKETS - 1;
+    gint64 sub = index % SUB_BUCKETS + SUB_BUCKETS;
+    return ((sub + 1) << shift) - 1;
+}
+
+/* ── Public API ──────────────────────────────────────────────────── */
+
+void
+gsr_latency_histogram_reset(GsrLatencyHistogram *hist)
+{
+    memset(hist, 0, sizeof(*hist));
+}
+
+void
+gsr_latency_histogram_record(GsrLatencyHistogram *hist, gint64 value_us)
+{
+    gint64 v = CLAMP(value_us, 0, MAX_VALUE);
+
+    hist->counts[bucket_index(v)]++;
+
+    if (hist->total == 0 || v < hist->min_us)
+        hist->min_us = v;
+    if (v > hist->max_us)
+        hist->max_us = v;
+    hist->total++;
+}
+
+gint64
+gsr_latency_histogram_percentile(const GsrLatencyHistogram *hist,
+                                 double                     percentile)
+{
+    if (hist->total == 0)
+        return 0;
+
+    double p = CLAMP(percentile, 0.0, 100.0);
+    guint64 rank = (guint64)(p / 100.0 * (double)hist->total + 0.5);
+    if (rank == 0)
+        rank = 1;
+
+    guint64 seen = 0;
+    for (int i = 0; i < GSR_LATENCY_N_BUCKETS; i++) {
+        seen += hist->counts[i];
+        if (seen >= rank)
+            return MIN(bucket_upper_bound(i), hist->max_us);
+    }
+    return hist->max_us;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+/*
+ * gsr-latency-histogram.h — Fixed-size HDR-style latency histogram.
+ *
+ * Values are microseconds.  Buckets are log-linear: exact below 32 µs,
+ * then 16 sub-buckets per power of two, so any recorded value is reported
+ * within ~6% of its true value.  Recording is O(1) and allocation-free.
+ */
+
+#include <glib.h>
+
+/* 16 linear buckets per octave up to 2^31 µs (~36 minutes) */
+#define GSR_LATENCY_SUB_BUCKET_BITS 4
+#define GSR_LATENCY_N_BUCKETS       ((30 - GSR_LATENCY_SUB_BUCKET_BITS + 1) * (1 << GSR_LATENCY_SUB_BUCKET_BITS) + (1 << GSR_LATENCY_SUB_BUCKET_BITS))
+
+typedef struct {
+    guint32 counts[GSR_LATENCY_N_BUCKETS];
+    guint64 total;
+    gint64  min_us;
+    gint64  max_us;
+} GsrLatencyHistogram;
+
+/**
+ * Clear all samples.
+ */
+void   gsr_latency_histogram_reset     (GsrLatencyHistogram *hist);
+
+/**
+ * Add one sample.  Negative values count as 0; values beyond the range
+ * land in the last bucket.
+ */
+void   gsr_latency_histogram_record    (GsrLatencyHistogram *hist,
+                                        gint64               value_us);
+
+/**
+ * Value at the given percentile (0–100), reported as the upper bound of
+ * the bucket it falls in.  Returns 0 when the histogram is empty.
+ */
+gint64 gsr_latency_histogram_percentile(const GsrLatencyHistogram *hist,
+                                        double                     percentile);
@@ -0,0 +1,343 @@
+#include "gsr-library-index.h"
+
+#include <string.h>
+
+#include <glib/gstdio.h>
+
+#define INDEX_MAGIC "GSRLIB\0\1"
+
+typedef struct {
+    char    magic[8];
+    guint32 n_entries;
+    guint32 n_dirs;
+    guint32 strings_size;
+    guint32 reserved[3];
+} IndexHeader;
+
+typedef struct {
+    guint32 path_offset;
+    guint32 reserved;
+    gint64  mtime;
+} DirRecord;
+
+G_STATIC_ASSERT(sizeof(IndexHeader) == 32);
+G_STATIC_ASSERT(sizeof(DirRecord) == 16);
+G_STATIC_ASSERT(sizeof(GsrLibraryEntry) == 40);
+
+struct _GsrLibraryIndex {
+    char       *path;
+    GArray     *entries;    /* GsrLibraryEntry */
+    GArray     *dirs;       /* DirRecord */
+    GByteArray *strings;    /* NUL-terminated paths, may hold garbage */
+    GHashTable *by_path;    /* path → position + 1; NULL until needed */
+    gboolean    dirty;
+};
+
+/* ── Helpers ─────────────────────────────────────────────────────── */
+
+static guint32
+add_string(GsrLibraryIndex *self, const char *str)
+{
+    guint32 offset = self->strings->len;
+    g_byte_array_append(self->strings, (const guint8 *)str, (guint)strlen(str) + 1);
+    return offset;
+}
+
+static const char *
+string_at(GsrLibraryIndex *self, guint32 offset)
+{
+    return offset < self->strings->len ? (const char *)self->strings->data + offset : "";
+}
+
+static void
+ensure_by_path(GsrLibraryIndex *self)
+{
+    if (self->by_path)
+        return;
+
+    self->by_path = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+    for (guint i = 0; i < self->entries->len; i++) {
+        const GsrLibraryEntry *e = &g_array_index(self->entries, GsrLibraryEntry, i);
+        g_hash_table_insert(self->by_path, g_strdup(string_at(self, e->path_offset)),
+                            GUINT_TO_POINTER(i + 1));
+    }
+}
+
+/* Checks that every offset points inside the table and the table ends in NUL */
+static gboolean
+strings_valid(GsrLibraryIndex *self)
+{
+    guint len = self->strings->len;
+    if (len > 0 && self->strings->data[len - 1] != '\0')
+        return FALSE;
+    for (guint i = 0; i < self->entries->len; i++) {
+        if (g_array_index(self->entries, GsrLibraryEntry, i).path_offset >= len)
+            return FALSE;
+    }
+    for (guint i = 0; i < self->dirs->len; i++) {
+        if (g_array_index(self->dirs, DirRecord, i).path_offset >= len)
+            return FALSE;
+    }
+    return TRUE;
+}
+
+/* ── Load / save ─────────────────────────────────────────────────── */
+
+static gboolean
+load_mapped(GsrLibraryIndex *self, const char *data, gsize length)
+{
+    IndexHeader header;
+    if (length < sizeof(header))
+        return FALSE;
+    memcpy(&header, data, sizeof(header));
+    if (memcmp(header.magic, INDEX_MAGIC, sizeof(header.magic)) != 0)
+        return FALSE;
+
+    gsize dirs_size = (gsize)header.n_dirs * sizeof(DirRecord);
+    gsize entries_size = (gsize)header.n_entries * sizeof(GsrLibraryEntry);
+    if (length != sizeof(header) + dirs_size + entries_size + header.strings_size)
+        return FALSE;
+
+    const char *p = data + sizeof(header);
+    g_array_append_vals(self->dirs, p, header.n_dirs);
+    p += dirs_size;
+    g_array_append_vals(self->entries, p, header.n_entries);
+    p += entries_size;
+    g_byte_array_append(self->strings, (const guint8 *)p, header.strings_size);
+
+    return strings_valid(self);
+}
+
+GsrLibraryIndex *
+gsr_library_index_load(const char *path)
+{
+    GsrLibraryIndex *self = g_new0(GsrLibraryIndex, 1);
+    self->path = g_strdup(path);
+    self->entries = g_array_new(FALSE, FALSE, sizeof(GsrLibraryEntry));
+    self->dirs = g_array_new(FALSE, FALSE, sizeof(DirRecord));
+    self->strings = g_byte_array_new();
+
+    GMappedFile *mapped = g_mapped_file_new(path, FALSE, NULL);
+    if (!mapped)
+        return self;
+
+    if (!load_mapped(self, g_mapped_file_get_contents(mapped),
+                     g_mapped_file_get_length(mapped)))
+    {
+        g_warning("Ignoring corrupt library index %s", path);
+        g_array_set_size(self->entries, 0);
+        g_array_set_size(self->dirs, 0);
+        g_byte_array_set_size(self->strings, 0);
+        self->dirty = TRUE;
+    }
+    g_mapped_file_unref(mapped);
+    return self;
+}
+
+void
+gsr_library_index_free(GsrLibraryIndex *self)
+{
+    if (!self)
+        return;
+    g_clear_pointer(&self->by_path, g_hash_table_destroy);
+    g_array_unref(self->entries);
+    g_array_unref(self->dirs);
+    g_byte_array_unref(self->strings);
+    g_free(self->path);
+    g_free(self);
+}
+
+gboolean
+gsr_library_index_save(GsrLibraryIndex *self)
+{
+    /* Rebuild the string table without removed paths */
+    GByteArray *strings = g_byte_array_new();
+    GArray *entries = g_array_copy(self->entries);
+    GArray *dirs = g_array_copy(self->dirs);
+    for (guint i = 0; i < entries->len; i++) {
+        GsrLibraryEntry *e = &g_array_index(entries, GsrLibraryEntry, i);
+        const char *str = string_at(self, e->path_offset);
+        e->path_offset = strings->len;
+        g_byte_array_append(strings, (const guint8 *)str, (guint)strlen(str) + 1);
+    }
+    for (guint i = 0; i < dirs->len; i++) {
+        DirRecord *d = &g_array_index(dirs, DirRecord, i);
+        const char *str = string_at(self, d->path_offset);
+        d->path_offset = strings->len;
+        g_byte_array_append(strings, (const guint8 *)str, (guint)strlen(str) + 1);
+    }
+
+    IndexHeader header = {
+        .n_entries = entries->len,
+        .n_dirs = dirs->len,
+        .strings_size = strings->len,
+    };
+    memcpy(header.magic, INDEX_MAGIC, sizeof(header.magic));
+
+    GByteArray *out = g_byte_array_sized_new((guint)(sizeof(header)
+        + dirs->len * sizeof(DirRecord) + entries->len * sizeof(GsrLibraryEntry)
+        + strings->len));
+    g_byte_array_append(out, (const guint8 *)&header, sizeof(header));
+    g_byte_array_append(out, (const guint8 *)dirs->data, dirs->len * (guint)sizeof(DirRecord));
+    g_byte_array_append(out, (const guint8 *)entries->data,
+                        entries->len * (guint)sizeof(GsrLibraryEntry));
+    g_byte_array_append(out, strings->data, strings->len);
+
+    g_autofree char *dir = g_path_get_dirname(self->path);
+    g_mkdir_with_parents(dir, 0755);
+
+    GError *error = NULL;
+    gboolean ok = g_file_set_contents(self->path, (const char *)out->data,
+                                      (gssize)out->len, &error);
+    if (ok) {
+        /* Adopt the compacted table; positions are unchanged */
+        g_byte_array_unref(self->strings);
+        self->strings = g_byte_array_ref(strings);
+        g_array_unref(self->entries);
+        self->entries = g_array_ref(entries);
+        g_array_unref(self->dirs);
+        self->dirs = g_array_ref(dirs);
+        self->dirty = FALSE;
+    } else {
+        g_warning("Failed to save library index: %s", error->message);
+        g_error_free(error);
+    }
+
+    g_byte_array_unref(out);
+    g_byte_array_unref(strings);
+    g_array_unref(entries);
+    g_array_unref(dirs);
+    return ok;
+}
+
+/* ── Entries ─────────────────────────────────────────────────────── */
+
+guint
+gsr_library_index_get_n_entries(GsrLibraryIndex *self)
+{
+    return self->entries->len;
+}
+
+const GsrLibraryEntry *
+gsr_library_index_get_entry(GsrLibraryIndex *self, guint position)
+{
+    g_return_val_if_fail(position < self->entries->len, NULL);
+    return &g_array_index(self->entries, GsrLibraryEntry, position);
+}
+
+const char *
+gsr_library_index_get_path(GsrLibraryIndex *self, const GsrLibraryEntry *entry)
+{
+    return string_at(self, entry->path_offset);
+}
+
+int
+gsr_library_index_find(GsrLibraryIndex *self, const char *path)
+{
+    ensure_by_path(self);
+    gpointer value = g_hash_table_lookup(self->by_path, path);
+    return value ? (int)GPOINTER_TO_UINT(value) - 1 : -1;
+}
+
+guint
+gsr_library_index_update(GsrLibraryIndex *self, const char *path,
+                         guint64 size, gint64 mtime, gboolean *out_added)
+{
+    int existing = gsr_library_index_find(self, path);
+    if (existing >= 0) {
+        GsrLibraryEntry *e = &g_array_index(self->entries, GsrLibraryEntry, existing);
+        if (e->size != size || e->mtime != mtime) {
+            e->size = size;
+            e->mtime = mtime;
+            e->flags &= ~GSR_LIBRARY_ENTRY_PROBED;
+            self->dirty = TRUE;
+        }
+        if (out_added)
+            *out_added = FALSE;
+        return (guint)existing;
+    }
+
+    GsrLibraryEntry entry = {
+        .size = size,
+        .mtime = mtime,
+        .path_offset = add_string(self, path),
+    };
+    g_array_append_val(self->entries, entry);
+    g_hash_table_insert(self->by_path, g_strdup(path),
+                        GUINT_TO_POINTER(self->entries->len));
+    self->dirty = TRUE;
+    if (out_added)
+        *out_added = TRUE;
+    return self->entries->len - 1;
+}
+
+void
+gsr_library_index_remove(GsrLibraryIndex *self, guint position)
+{
+    g_return_if_fail(position < self->entries->len);
+    g_array_remove_index(self->entries, position);
+    /* Positions after it shifted; rebuilt on the next lookup */
+    g_clear_pointer(&self->by_path, g_hash_table_destroy);
+    self->dirty = TRUE;
+}
+
+void
+gsr_library_index_set_metadata(GsrLibraryIndex *self, guint position,
+                               guint32 duration_ms, guint16 width,
+                               guint16 height, const char *codec)
+{
+    g_return_if_fail(position < self->entries->len);
+    GsrLibraryEntry *e = &g_array_index(self->entries, GsrLibraryEntry, position);
+    e->duration_ms = duration_ms;
+    e->width = width;
+    e->height = height;
+    g_strlcpy(e->codec, codec ? codec : "", sizeof(e->codec));
+    e->flags |= GSR_LIBRARY_ENTRY_PROBED;
+    self->dirty = TRUE;
+}
+
+/* ── Directories ─────────────────────────────────────────────────── */
+
+static DirRecord *
+find_dir(GsrLibraryIndex *self, const char *dir)
+{
+    for (guint i = 0; i < self->dirs->len; i++) {
+        DirRecord *d = &g_array_index(self->dirs, DirRecord, i);
+        if (g_str_equal(string_at(self, d->path_offset), dir))
+            return d;
+    }
+    return NULL;
+}
+
+gboolean
+gsr_library_index_get_dir_mtime(GsrLibraryIndex *self, const char *dir,
+                                gint64 *out_mtime)
+{
+    const DirRecord *d = find_dir(self, dir);
+    if (!d)
+        return FALSE;
+    *out_mtime = d->mtime;
+    return TRUE;
+}
+
+void
+gsr_library_index_set_dir_mtime(GsrLibraryIndex *self, const char *dir,
+                                gint64 mtime)
+{
+    DirRecord *d = find_dir(self, dir);
+    if (d) {
+        if (d->mtime == mtime)
+            return;
+        d->mtime = mtime;
+    } else {
+        DirRecord record = { .path_offset = add_string(self, dir), .mtime = mtime };
+        g_array_append_val(self->dirs, record);
+    }
+    self->dirty = TRUE;
+}
+
+gboolean
+gsr_library_index_is_dirty(GsrLibraryIndex *self)
+{
+    return self->dirty;
+}
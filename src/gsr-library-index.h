@@ -0,0 +1,97 @@
+#pragma once
+
+/*
+ * gsr-library-index.h — On-disk index of saved recordings.
+ *
+ * The file is a fixed header, an array of directory records, an array of
+ * fixed-size entry records and a table of NUL-terminated paths, in host
+ * byte order (it's a cache, not an exchange format).  Loading maps the
+ * file and copies the arrays out in one go, so opening an index of tens
+ * of thousands of files costs a few memcpy()s and no per-file parsing.
+ */
+
+#include <glib.h>
+
+/* Metadata (duration/codec/resolution) has been read for this entry */
+#define GSR_LIBRARY_ENTRY_PROBED  (1u << 0)
+
+typedef struct {
+    guint64 size;
+    gint64  mtime;          /* seconds since the epoch */
+    guint32 duration_ms;    /* 0 if unknown */
+    guint16 width;
+    guint16 height;
+    char    codec[8];       /* e.g. "h264", "hevc", "av1"; "" if unknown */
+    guint32 path_offset;    /* into the string table */
+    guint32 flags;          /* GSR_LIBRARY_ENTRY_* */
+} GsrLibraryEntry;
+
+typedef struct _GsrLibraryIndex GsrLibraryIndex;
+
+/**
+ * Load the index at path, or start an empty one if it's missing or
+ * unreadable.  Nothing is written until gsr_library_index_save().
+ */
+GsrLibraryIndex       *gsr_library_index_load         (const char *path);
+void                   gsr_library_index_free         (GsrLibraryIndex *self);
+
+/**
+ * Write the index atomically, compacting the string table.
+ */
+gboolean               gsr_library_index_save         (GsrLibraryIndex *self);
+
+guint                  gsr_library_index_get_n_entries(GsrLibraryIndex *self);
+const GsrLibraryEntry *gsr_library_index_get_entry    (GsrLibraryIndex *self,
+                                                       guint            position);
+const char            *gsr_library_index_get_path     (GsrLibraryIndex       *self,
+                                                       const GsrLibraryEntry *entry);
+
+/**
+ * Position of the entry for path, or -1.
+ */
+int                    gsr_library_index_find         (GsrLibraryIndex *self,
+                                                       const char      *path);
+
+/**
+ * Add path at the end, or update its size/mtime in place.  Metadata is
+ * dropped if the file changed.  Returns the position; *out_added tells
+ * which of the two happened.
+ */
+guint                  gsr_library_index_update       (GsrLibraryIndex *self,
+                                                       const char      *path,
+                                                       guint64          size,
+                                                       gint64           mtime,
+                                                       gboolean        *out_added);
+
+/**
+ * Remove the entry at position; later entries move down by one.
+ */
+void                   gsr_library_index_remove       (GsrLibraryIndex *self,
+                                                       guint            position);
+
+/**
+ * Store probed metadata and mark the entry GSR_LIBRARY_ENTRY_PROBED.
+ */
+void                   gsr_library_index_set_metadata (GsrLibraryIndex *self,
+                                                       guint            position,
+                                                       guint32          duration_ms,
+                                                       guint16          width,
+                                                       guint16          height,
+                                                       const char      *codec);
+
+/**
+ * Directories whose contents are in the index, with the directory mtime
+ * seen when they were last brought up to date.  Returns FALSE if dir
+ * isn't known.
+ */
+gboolean               gsr_library_index_get_dir_mtime(GsrLibraryIndex *self,
+                                                       const char      *dir,
+                                                       gint64          *out_mtime);
+void                   gsr_library_index_set_dir_mtime(GsrLibraryIndex *self,
+                                                       const char      *dir,
+                                                       gint64           mtime);
+
+/**
+ * TRUE if anything changed since the index was loaded or last saved.
+ */
+gboolean               gsr_library_index_is_dirty     (GsrLibraryIndex *self);
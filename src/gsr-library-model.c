@@ -0,0 +1,748 @@
+#include "gsr-library-model.h"
+
+#include <string.h>
+
+#include <glib/gstdio.h>
+
+#include "gsr-library-index.h"
+
+#define SAVE_DELAY_SECONDS  2
+#define SCAN_BATCH_SIZE     256
+#define MAX_PROBES          2    /* ffprobe processes at once */
+#define MAX_PENDING_PROBES  64   /* rows scrolled past are dropped first */
+
+static const char *const video_extensions[] = {
+    ".mp4", ".mkv", ".flv", ".webm", ".mov", ".ts", ".m4v",
+};
+
+/* ═══════════════════════════════════════════════════════════════════
+ *  GsrLibraryItem
+ * ═══════════════════════════════════════════════════════════════════ */
+
+struct _GsrLibraryItem {
+    GObject         parent_instance;
+    char           *path;
+    GsrLibraryEntry entry;
+};
+
+G_DEFINE_FINAL_TYPE(GsrLibraryItem, gsr_library_item, G_TYPE_OBJECT)
+
+static void
+gsr_library_item_finalize(GObject *object)
+{
+    g_free(GSR_LIBRARY_ITEM(object)->path);
+    G_OBJECT_CLASS(gsr_library_item_parent_class)->finalize(object);
+}
+
+static void
+gsr_library_item_class_init(GsrLibraryItemClass *klass)
+{
+    G_OBJECT_CLASS(klass)->finalize = gsr_library_item_finalize;
+}
+
+static void
+gsr_library_item_init(GsrLibraryItem *self G_GNUC_UNUSED)
+{
+}
+
+const char *
+gsr_library_item_get_path(GsrLibraryItem *self)
+{
+    return self->path;
+}
+
+guint64
+gsr_library_item_get_size(GsrLibraryItem *self)
+{
+    return self->entry.size;
+}
+
+gint64
+gsr_library_item_get_mtime(GsrLibraryItem *self)
+{
+    return self->entry.mtime;
+}
+
+guint32
+gsr_library_item_get_duration_ms(GsrLibraryItem *self)
+{
+    return self->entry.duration_ms;
+}
+
+int
+gsr_library_item_get_width(GsrLibraryItem *self)
+{
+    return self->entry.width;
+}
+
+int
+gsr_library_item_get_height(GsrLibraryItem *self)
+{
+    return self->entry.height;
+}
+
+const char *
+gsr_library_item_get_codec(GsrLibraryItem *self)
+{
+    return self->entry.codec;
+}
+
+gboolean
+gsr_library_item_has_metadata(GsrLibraryItem *self)
+{
+    return (self->entry.flags & GSR_LIBRARY_ENTRY_PROBED) != 0;
+}
+
+/* ═══════════════════════════════════════════════════════════════════
+ *  GsrLibraryModel
+ *
+ *  Index position i is model position n - 1 - i: new files are appended
+ *  to the index and show up at the top.
+ * ═══════════════════════════════════════════════════════════════════ */
+
+struct _GsrLibraryModel {
+    GObject          parent_instance;
+
+    GsrLibraryIndex *index;
+    guint            save_timer_id;
+    GCancellable    *cancellable;       /* cancelled on dispose */
+
+    /* ── Watched directories ─── */
+    char           **dirs;
+    GPtrArray       *monitors;          /* GFileMonitor */
+    GCancellable    *scan_cancellable;  /* replaced with the directories */
+    GHashTable      *scanning;          /* directories with a scan running */
+
+    /* ── Metadata ─── */
+    GQueue           pending_probes;    /* char*, most recently bound first */
+    GHashTable      *probing;           /* paths queued or running */
+    int              n_probes;
+    guint            probe_idle_id;
+    gboolean         have_ffprobe;
+};
+
+static void gsr_library_model_list_model_init(GListModelInterface *iface);
+
+G_DEFINE_FINAL_TYPE_WITH_CODE(GsrLibraryModel, gsr_library_model, G_TYPE_OBJECT,
+    G_IMPLEMENT_INTERFACE(G_TYPE_LIST_MODEL, gsr_library_model_list_model_init))
+
+/* ── GListModel ──────────────────────────────────────────────────── */
+
+static GType
+gsr_library_model_get_item_type(GListModel *list G_GNUC_UNUSED)
+{
+    return GSR_TYPE_LIBRARY_ITEM;
+}
+
+static guint
+gsr_library_model_get_n_items(GListModel *list)
+{
+    return gsr_library_index_get_n_entries(GSR_LIBRARY_MODEL(list)->index);
+}
+
+static gpointer
+gsr_library_model_get_item(GListModel *list, guint position)
+{
+    GsrLibraryModel *self = GSR_LIBRARY_MODEL(list);
+    guint n = gsr_library_index_get_n_entries(self->index);
+    if (position >= n)
+        return NULL;
+
+    const GsrLibraryEntry *entry = gsr_library_index_get_entry(self->index, n - 1 - position);
+    GsrLibraryItem *item = g_object_new(GSR_TYPE_LIBRARY_ITEM, NULL);
+    item->path = g_strdup(gsr_library_index_get_path(self->index, entry));
+    item->entry = *entry;
+    return item;
+}
+
+static void
+gsr_library_model_list_model_init(GListModelInterface *iface)
+{
+    iface->get_item_type = gsr_library_model_get_item_type;
+    iface->get_n_items = gsr_library_model_get_n_items;
+    iface->get_item = gsr_library_model_get_item;
+}
+
+/* ── Index changes ───────────────────────────────────────────────── */
+
+static gboolean
+on_save_timeout(gpointer user_data)
+{
+    GsrLibraryModel *self = user_data;
+    self->save_timer_id = 0;
+    gsr_library_index_save(self->index);
+    return G_SOURCE_REMOVE;
+}
+
+static void
+schedule_save(GsrLibraryModel *self)
+{
+    if (!self->save_timer_id && gsr_library_index_is_dirty(self->index))
+        self->save_timer_id = g_timeout_add_seconds(SAVE_DELAY_SECONDS, on_save_timeout, self);
+}
+
+static gboolean
+is_video_path(const char *path)
+{
+    for (gsize i = 0; i < G_N_ELEMENTS(video_extensions); i++) {
+        if (g_str_has_suffix(path, video_extensions[i]))
+            return TRUE;
+    }
+    return FALSE;
+}
+
+static void
+remove_entry(GsrLibraryModel *self, guint index_pos)
+{
+    guint n = gsr_library_index_get_n_entries(self->index);
+    gsr_library_index_remove(self->index, index_pos);
+    g_list_model_items_changed(G_LIST_MODEL(self), n - 1 - index_pos, 1, 0);
+}
+
+static void
+update_entry(GsrLibraryModel *self, const char *path, guint64 size, gint64 mtime)
+{
+    gboolean added = FALSE;
+    guint index_pos = gsr_library_index_update(self->index, path, size, mtime, &added);
+    guint n = gsr_library_index_get_n_entries(self->index);
+    g_list_model_items_changed(G_LIST_MODEL(self), n - 1 - index_pos, added ? 0 : 1, 1);
+}
+
+/* Bring the entry for path in line with the file, adding or removing it */
+static void
+sync_path(GsrLibraryModel *self, const char *path)
+{
+    if (!is_video_path(path))
+        return;
+
+    GStatBuf st;
+    int pos = gsr_library_index_find(self->index, path);
+    if (g_stat(path, &st) == 0 && S_ISREG(st.st_mode))
+        update_entry(self, path, (guint64)st.st_size, st.st_mtime);
+    else if (pos >= 0)
+        remove_entry(self, (guint)pos);
+}
+
+static void
+record_dir_mtime(GsrLibraryModel *self, const char *dir)
+{
+    GStatBuf st;
+    if (g_stat(dir, &st) == 0)
+        gsr_library_index_set_dir_mtime(self->index, dir, st.st_mtime);
+}
+
+/* ── Directory scans ─────────────────────────────────────────────── */
+
+/*
+ * Only directories that changed while nobody was watching are read, in
+ * batches on GIO's worker threads.  The index is updated in one go at
+ * the end, so the view sees a single change instead of one per file.
+ */
+
+typedef struct {
+    char   *path;
+    guint64 size;
+    gint64  mtime;
+} ScanFile;
+
+typedef struct {
+    GsrLibraryModel *self;          /* valid while cancellable isn't cancelled */
+    GCancellable    *cancellable;
+    GFile           *dir;
+    char            *dir_path;
+    gint64           dir_mtime;     /* at the start of the scan */
+    GFileEnumerator *enumerator;
+    GArray          *files;         /* ScanFile */
+    GHashTable      *seen;          /* paths in files */
+} Scan;
+
+static void
+scan_file_clear(ScanFile *file)
+{
+    g_free(file->path);
+}
+
+static void
+scan_free(Scan *scan)
+{
+    if (!g_cancellable_is_cancelled(scan->cancellable))
+        g_hash_table_remove(scan->self->scanning, scan->dir_path);
+    g_object_unref(scan->cancellable);
+    g_object_unref(scan->dir);
+    g_free(scan->dir_path);
+    g_clear_object(&scan->enumerator);
+    g_array_unref(scan->files);
+    g_hash_table_destroy(scan->seen);
+    g_free(scan);
+}
+
+static gint
+compare_scan_file_mtime(gconstpointer a, gconstpointer b)
+{
+    gint64 ma = ((const ScanFile *)a)->mtime;
+    gint64 mb = ((const ScanFile *)b)->mtime;
+    return (ma > mb) - (ma < mb);
+}
+
+/* path is directly inside dir (dir has no trailing slash) */
+static gboolean
+is_in_dir(const char *path, const char *dir, gsize dir_len)
+{
+    return strncmp(path, dir, dir_len) == 0 && path[dir_len] == '/' &&
+           !strchr(path + dir_len + 1, '/');
+}
+
+static void
+scan_finish(Scan *scan)
+{
+    GsrLibraryModel *self = scan->self;
+    guint old_n = gsr_library_index_get_n_entries(self->index);
+
+    /* Files that are gone.  A file created after the enumerator passed
+       its name may already be in the index via the monitor; keep it. */
+    gsize dir_len = strlen(scan->dir_path);
+    for (guint i = old_n; i-- > 0;) {
+        const GsrLibraryEntry *entry = gsr_library_index_get_entry(self->index, i);
+        const char *path = gsr_library_index_get_path(self->index, entry);
+        if (is_in_dir(path, scan->dir_path, dir_len) &&
+            !g_hash_table_contains(scan->seen, path) &&
+            !g_file_test(path, G_FILE_TEST_IS_REGULAR))
+        {
+            gsr_library_index_remove(self->index, i);
+        }
+    }
+
+    /* New files go in oldest first, so the newest end up on top */
+    g_array_sort(scan->files, compare_scan_file_mtime);
+    for (guint i = 0; i < scan->files->len; i++) {
+        const ScanFile *file = &g_array_index(scan->files, ScanFile, i);
+        gsr_library_index_update(self->index, file->path, file->size, file->mtime, NULL);
+    }
+
+    gsr_library_index_set_dir_mtime(self->index, scan->dir_path, scan->dir_mtime);
+    g_list_model_items_changed(G_LIST_MODEL(self), 0, old_n,
+                               gsr_library_index_get_n_entries(self->index));
+    schedule_save(self);
+    g_debug("Library: scanned %s, %u files", scan->dir_path, scan->files->len);
+}
+
+static void
+on_scan_next_files(GObject *source, GAsyncResult *result, gpointer user_data)
+{
+    Scan *scan = user_data;
+    GError *error = NULL;
+    GList *infos = g_file_enumerator_next_files_finish(G_FILE_ENUMERATOR(source),
+                                                       result, &error);
+    if (g_cancellable_is_cancelled(scan->cancellable)) {
+        g_list_free_full(infos, g_object_unref);
+        g_clear_error(&error);
+        scan_free(scan);
+        return;
+    }
+    if (error) {
+        g_warning("Failed to read %s: %s", scan->dir_path, error->message);
+        g_error_free(error);
+        scan_free(scan);
+        return;
+    }
+    if (!infos) {
+        scan_finish(scan);
+        scan_free(scan);
+        return;
+    }
+
+    for (GList *l = infos; l; l = l->next) {
+        GFileInfo *info = l->data;
+        const char *name = g_file_info_get_name(info);
+        if (g_file_info_get_file_type(info) != G_FILE_TYPE_REGULAR || !is_video_path(name))
+            continue;
+
+        ScanFile file = {
+            .path = g_build_filename(scan->dir_path, name, NULL),
+            .size = (guint64)g_file_info_get_size(info),
+            .mtime = (gint64)g_file_info_get_attribute_uint64(info,
+                         G_FILE_ATTRIBUTE_TIME_MODIFIED),
+        };
+        g_hash_table_add(scan->seen, file.path);
+        g_array_append_val(scan->files, file);
+    }
+    g_list_free_full(infos, g_object_unref);
+
+    g_file_enumerator_next_files_async(scan->enumerator, SCAN_BATCH_SIZE, G_PRIORITY_LOW,
+                                       scan->cancellable, on_scan_next_files, scan);
+}
+
+static void
+on_scan_enumerate(GObject *source, GAsyncResult *result, gpointer user_data)
+{
+    Scan *scan = user_data;
+    GError *error = NULL;
+    scan->enumerator = g_file_enumerate_children_finish(G_FILE(source), result, &error);
+    if (g_cancellable_is_cancelled(scan->cancellable)) {
+        g_clear_error(&error);
+        scan_free(scan);
+        return;
+    }
+    if (!scan->enumerator) {
+        g_warning("Failed to read %s: %s", scan->dir_path, error->message);
+        g_error_free(error);
+        scan_free(scan);
+        return;
+    }
+
+    g_file_enumerator_next_files_async(scan->enumerator, SCAN_BATCH_SIZE, G_PRIORITY_LOW,
+                                       scan->cancellable, on_scan_next_files, scan);
+}
+
+static void
+start_scan(GsrLibraryModel *self, GFile *dir, const char *dir_path, gint64 dir_mtime)
+{
+    Scan *scan = g_new0(Scan, 1);
+    scan->self = self;
+    scan->cancellable = g_object_ref(self->scan_cancellable);
+    scan->dir = g_object_ref(dir);
+    scan->dir_path = g_strdup(dir_path);
+    scan->dir_mtime = dir_mtime;
+    g_hash_table_add(self->scanning, g_strdup(dir_path));
+    scan->files = g_array_new(FALSE, FALSE, sizeof(ScanFile));
+    g_array_set_clear_func(scan->files, (GDestroyNotify)scan_file_clear);
+    scan->seen = g_hash_table_new(g_str_hash, g_str_equal);   /* keys owned by files */
+
+    g_file_enumerate_children_async(dir,
+        G_FILE_ATTRIBUTE_STANDARD_NAME "," G_FILE_ATTRIBUTE_STANDARD_TYPE ","
+        G_FILE_ATTRIBUTE_STANDARD_SIZE "," G_FILE_ATTRIBUTE_TIME_MODIFIED,
+        G_FILE_QUERY_INFO_NONE, G_PRIORITY_LOW, scan->cancellable,
+        on_scan_enumerate, scan);
+}
+
+/* ── Directory monitors ──────────────────────────────────────────── */
+
+static void
+on_dir_changed(GFileMonitor *monitor G_GNUC_UNUSED, GFile *file, GFile *other_file,
+               GFileMonitorEvent event, gpointer user_data)
+{
+    GsrLibraryModel *self = GSR_LIBRARY_MODEL(user_data);
+    g_autofree char *path = g_file_get_path(file);
+    g_autofree char *other_path = other_file ? g_file_get_path(other_file) : NULL;
+
+    switch (event) {
+    case G_FILE_MONITOR_EVENT_CREATED:
+    case G_FILE_MONITOR_EVENT_CHANGES_DONE_HINT:
+    case G_FILE_MONITOR_EVENT_DELETED:
+    case G_FILE_MONITOR_EVENT_MOVED_IN:
+    case G_FILE_MONITOR_EVENT_MOVED_OUT:
+        sync_path(self, path);
+        break;
+    case G_FILE_MONITOR_EVENT_RENAMED:
+        sync_path(self, path);
+        if (other_path)
+            sync_path(self, other_path);
+        break;
+    default:
+        return;
+    }
+
+    /* The index matches the directory again; no rescan on next start.
+       Unless a scan of it is still running: the files it hasn't reached
+       aren't in the index yet, and it records the mtime when done. */
+    g_autofree char *dir = g_path_get_dirname(path);
+    if (!g_hash_table_contains(self->scanning, dir))
+        record_dir_mtime(self, dir);
+    schedule_save(self);
+}
+
+static void
+watch_directory(GsrLibraryModel *self, const char *dir_path)
+{
+    g_autoptr(GFile) dir = g_file_new_for_path(dir_path);
+    GError *error = NULL;
+
+    /* Watch first, so nothing created during the scan is missed.  A
+       directory that doesn't exist yet is watched for being created. */
+    GFileMonitor *monitor = g_file_monitor_directory(dir, G_FILE_MONITOR_WATCH_MOVES,
+                                                     NULL, &error);
+    if (monitor) {
+        g_signal_connect_object(monitor, "changed", G_CALLBACK(on_dir_changed), self, 0);
+        g_ptr_array_add(self->monitors, monitor);
+    } else {
+        g_warning("Failed to watch %s: %s", dir_path, error->message);
+        g_clear_error(&error);
+    }
+
+    GStatBuf st;
+    if (g_stat(dir_path, &st) != 0)
+        return;
+
+    gint64 known_mtime;
+    if (!gsr_library_index_get_dir_mtime(self->index, dir_path, &known_mtime) ||
+        known_mtime != st.st_mtime)
+    {
+        start_scan(self, dir, dir_path, st.st_mtime);
+    }
+}
+
+/* ── Metadata ────────────────────────────────────────────────────── */
+
+typedef struct {
+    GsrLibraryModel *self;          /* valid while cancellable isn't cancelled */
+    GCancellable    *cancellable;
+    char            *path;
+} Probe;
+
+static void pump_probes(GsrLibraryModel *self);
+
+/* Output of ffprobe -of default=noprint_wrappers=1: key=value lines */
+static void
+apply_probe_output(GsrLibraryModel *self, const char *path, const char *output)
+{
+    int pos = gsr_library_index_find(self->index, path);
+    if (pos < 0)
+        return;
+
+    double duration = 0.0;
+    guint64 width = 0, height = 0;
+    g_autofree char *codec = NULL;
+    g_auto(GStrv) lines = g_strsplit(output ? output : "", "\n", -1);
+    for (int i = 0; lines[i]; i++) {
+        const char *value = strchr(lines[i], '=');
+        if (!value)
+            continue;
+        value++;
+        if (g_str_has_prefix(lines[i], "codec_name=") && !codec)
+            codec = g_strdup(value);
+        else if (g_str_has_prefix(lines[i], "width="))
+            width = g_ascii_strtoull(value, NULL, 10);
+        else if (g_str_has_prefix(lines[i], "height="))
+            height = g_ascii_strtoull(value, NULL, 10);
+        else if (g_str_has_prefix(lines[i], "duration="))
+            duration = g_ascii_strtod(value, NULL);   /* "N/A" reads as 0 */
+    }
+
+    /* Stored even if ffprobe found nothing, so the file isn't retried */
+    gsr_library_index_set_metadata(self->index, (guint)pos,
+        (guint32)CLAMP(duration * 1000.0, 0.0, (double)G_MAXUINT32),
+        (guint16)MIN(width, G_MAXUINT16), (guint16)MIN(height, G_MAXUINT16), codec);
+
+    guint n = gsr_library_index_get_n_entries(self->index);
+    g_list_model_items_changed(G_LIST_MODEL(self), n - 1 - (guint)pos, 1, 1);
+    schedule_save(self);
+}
+
+static void
+on_probe_done(GObject *source, GAsyncResult *result, gpointer user_data)
+{
+    Probe *probe = user_data;
+    g_autofree char *output = NULL;
+    GError *error = NULL;
+    g_subprocess_communicate_utf8_finish(G_SUBPROCESS(source), result, &output, NULL, &error);
+
+    if (!g_cancellable_is_cancelled(probe->cancellable)) {
+        GsrLibraryModel *self = probe->self;
+        if (error)
+            g_warning("ffprobe failed for %s: %s", probe->path, error->message);
+        else
+            apply_probe_output(self, probe->path, output);
+        self->n_probes--;
+        g_hash_table_remove(self->probing, probe->path);
+        pump_probes(self);
+    }
+
+    g_clear_error(&error);
+    g_object_unref(probe->cancellable);
+    g_free(probe->path);
+    g_free(probe);
+}
+
+static gboolean
+start_probe(GsrLibraryModel *self, const char *path)
+{
+    GError *error = NULL;
+    GSubprocess *proc = g_subprocess_new(
+        G_SUBPROCESS_FLAGS_STDOUT_PIPE | G_SUBPROCESS_FLAGS_STDERR_SILENCE, &error,
+        "ffprobe", "-v", "error", "-select_streams", "v:0",
+        "-show_entries", "stream=codec_name,width,height:format=duration",
+        "-of", "default=noprint_wrappers=1", "--", path, NULL);
+    if (!proc) {
+        /* Without ffprobe the library still lists files, just without
+           duration and resolution */
+        g_warning("Failed to run ffprobe: %s", error->message);
+        g_error_free(error);
+        self->have_ffprobe = FALSE;
+        return FALSE;
+    }
+
+    Probe *probe = g_new0(Probe, 1);
+    probe->self = self;
+    probe->cancellable = g_object_ref(self->cancellable);
+    probe->path = g_strdup(path);
+    g_subprocess_communicate_utf8_async(proc, NULL, probe->cancellable, on_probe_done, probe);
+    g_object_unref(proc);
+    self->n_probes++;
+    return TRUE;
+}
+
+static void
+pump_probes(GsrLibraryModel *self)
+{
+    while (self->n_probes < MAX_PROBES && !g_queue_is_empty(&self->pending_probes)) {
+        g_autofree char *path = g_queue_pop_head(&self->pending_probes);
+        int pos = gsr_library_index_find(self->index, path);
+        const GsrLibraryEntry *entry = pos >= 0
+            ? gsr_library_index_get_entry(self->index, (guint)pos) : NULL;
+
+        /* The file may have changed or gone since the row was bound */
+        GStatBuf st;
+        if (entry && g_stat(path, &st) != 0) {
+            remove_entry(self, (guint)pos);
+            schedule_save(self);
+            entry = NULL;
+        } else if (entry && (entry->size != (guint64)st.st_size || entry->mtime != st.st_mtime)) {
+            update_entry(self, path, (guint64)st.st_size, st.st_mtime);
+            schedule_save(self);
+        }
+
+        if (!entry || !self->have_ffprobe || !start_probe(self, path))
+            g_hash_table_remove(self->probing, path);
+    }
+}
+
+static void
+on_probe_idle(gpointer user_data)
+{
+    GsrLibraryModel *self = user_data;
+    self->probe_idle_id = 0;
+    pump_probes(self);
+}
+
+void
+gsr_library_model_request_metadata(GsrLibraryModel *self, guint position)
+{
+    g_return_if_fail(GSR_IS_LIBRARY_MODEL(self));
+
+    guint n = gsr_library_index_get_n_entries(self->index);
+    if (position >= n)
+        return;
+
+    const GsrLibraryEntry *entry = gsr_library_index_get_entry(self->index, n - 1 - position);
+    if (entry->flags & GSR_LIBRARY_ENTRY_PROBED)
+        return;
+
+    const char *path = gsr_library_index_get_path(self->index, entry);
+    if (!g_hash_table_add(self->probing, g_strdup(path)))
+        return;
+
+    g_queue_push_head(&self->pending_probes, g_strdup(path));
+    if (g_queue_get_length(&self->pending_probes) > MAX_PENDING_PROBES) {
+        g_autofree char *dropped = g_queue_pop_tail(&self->pending_probes);
+        g_hash_table_remove(self->probing, dropped);
+    }
+
+    /* Not from here: this runs while the view binds rows, and the model
+       must not change under it */
+    if (!self->probe_idle_id)
+        self->probe_idle_id = g_idle_add_once(on_probe_idle, self);
+}
+
+/* ── Public API ──────────────────────────────────────────────────── */
+
+void
+gsr_library_model_set_directories(GsrLibraryModel *self, const char *const *dirs)
+{
+    g_return_if_fail(GSR_IS_LIBRARY_MODEL(self));
+
+    /* Canonical paths (no trailing slash, no duplicates) */
+    GPtrArray *paths = g_ptr_array_new();
+    for (int i = 0; dirs && dirs[i]; i++) {
+        if (!dirs[i][0])
+            continue;
+        g_autoptr(GFile) file = g_file_new_for_path(dirs[i]);
+        char *path = g_file_get_path(file);
+        if (g_ptr_array_find_with_equal_func(paths, path, g_str_equal, NULL))
+            g_free(path);
+        else
+            g_ptr_array_add(paths, path);
+    }
+    g_ptr_array_add(paths, NULL);
+    char **new_dirs = (char **)g_ptr_array_free(paths, FALSE);
+
+    if (self->dirs && g_strv_equal((const char *const *)self->dirs,
+                                   (const char *const *)new_dirs))
+    {
+        g_strfreev(new_dirs);
+        return;
+    }
+
+    g_cancellable_cancel(self->scan_cancellable);
+    g_object_unref(self->scan_cancellable);
+    self->scan_cancellable = g_cancellable_new();
+    g_hash_table_remove_all(self->scanning);
+    g_ptr_array_set_size(self->monitors, 0);
+    g_strfreev(self->dirs);
+    self->dirs = new_dirs;
+
+    for (int i = 0; self->dirs[i]; i++)
+        watch_directory(self, self->dirs[i]);
+}
+
+GsrLibraryModel *
+gsr_library_model_new(const char *index_path)
+{
+    GsrLibraryModel *self = g_object_new(GSR_TYPE_LIBRARY_MODEL, NULL);
+    self->index = gsr_library_index_load(index_path);
+    return self;
+}
+
+/* ── GObject ─────────────────────────────────────────────────────── */
+
+static void
+gsr_library_model_dispose(GObject *object)
+{
+    GsrLibraryModel *self = GSR_LIBRARY_MODEL(object);
+
+    g_cancellable_cancel(self->cancellable);
+    g_cancellable_cancel(self->scan_cancellable);
+    g_clear_pointer(&self->monitors, g_ptr_array_unref);
+    g_clear_handle_id(&self->probe_idle_id, g_source_remove);
+
+    g_clear_handle_id(&self->save_timer_id, g_source_remove);
+    if (self->index && gsr_library_index_is_dirty(self->index))
+        gsr_library_index_save(self->index);
+
+    G_OBJECT_CLASS(gsr_library_model_parent_class)->dispose(object);
+}
+
+static void
+gsr_library_model_finalize(GObject *object)
+{
+    GsrLibraryModel *self = GSR_LIBRARY_MODEL(object);
+
+    g_clear_pointer(&self->index, gsr_library_index_free);
+    g_clear_object(&self->cancellable);
+    g_clear_object(&self->scan_cancellable);
+    g_strfreev(self->dirs);
+    g_queue_clear_full(&self->pending_probes, g_free);
+    g_hash_table_destroy(self->probing);
+    g_hash_table_destroy(self->scanning);
+
+    G_OBJECT_CLASS(gsr_library_model_parent_class)->finalize(object);
+}
+
+static void
+gsr_library_model_class_init(GsrLibraryModelClass *klass)
+{
+    GObjectClass *obj_class = G_OBJECT_CLASS(klass);
+    obj_class->dispose = gsr_library_model_dispose;
+    obj_class->finalize = gsr_library_model_finalize;
+}
+
+static void
+gsr_library_model_init(GsrLibraryModel *self)
+{
+    self->cancellable = g_cancellable_new();
+    self->scan_cancellable = g_cancellable_new();
+    self->monitors = g_ptr_array_new_with_free_func(g_object_unref);
+    self->scanning = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+    g_queue_init(&self->pending_probes);
+    self->probing = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+    self->have_ffprobe = TRUE;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+/*
+ * gsr-library-model.h — GListModel of saved recordings, newest first.
+ *
+ * Backed by a GsrLibraryIndex.  A save directory is read in full only if
+ * it is new to the index or its mtime changed while the app wasn't
+ * running; after that a GFileMonitor keeps the index up to date file by
+ * file.  Duration, codec and resolution are read with ffprobe on demand,
+ * when a row first shows the file, and stored in the index.
+ */
+
+#include <gio/gio.h>
+
+G_BEGIN_DECLS
+
+#define GSR_TYPE_LIBRARY_ITEM (gsr_library_item_get_type())
+G_DECLARE_FINAL_TYPE(GsrLibraryItem, gsr_library_item, GSR, LIBRARY_ITEM, GObject)
+
+/* Snapshot of one index entry; a changed entry gets a new item. */
+const char *gsr_library_item_get_path       (GsrLibraryItem *self);
+guint64     gsr_library_item_get_size       (GsrLibraryItem *self);
+gint64      gsr_library_item_get_mtime      (GsrLibraryItem *self);
+/* FALSE until the fields below have been read */
+gboolean    gsr_library_item_has_metadata   (GsrLibraryItem *self);
+guint32     gsr_library_item_get_duration_ms(GsrLibraryItem *self);
+int         gsr_library_item_get_width      (GsrLibraryItem *self);
+int         gsr_library_item_get_height     (GsrLibraryItem *self);
+const char *gsr_library_item_get_codec      (GsrLibraryItem *self);
+
+#define GSR_TYPE_LIBRARY_MODEL (gsr_library_model_get_type())
+G_DECLARE_FINAL_TYPE(GsrLibraryModel, gsr_library_model, GSR, LIBRARY_MODEL, GObject)
+
+/**
+ * Open the index at index_path.  Its entries are available immediately;
+ * nothing is watched until gsr_library_model_set_directories().
+ */
+GsrLibraryModel *gsr_library_model_new            (const char *index_path);
+
+/**
+ * Watch these directories (NULL-terminated), bringing each up to date
+ * first if it changed since it was last seen.
+ */
+void             gsr_library_model_set_directories(GsrLibraryModel   *self,
+                                                   const char *const *dirs);
+
+/**
+ * Read metadata for the item at position if it's missing, and drop the
+ * item if its file is gone.  Cheap to call for every bound row.
+ */
+void             gsr_library_model_request_metadata(GsrLibraryModel *self,
+                                                    guint            position);
+
+G_END_DECLS
@@ -0,0 +1,312 @@
+#include "gsr-library-page.h"
+
+#include <glib/gi18n.h>
+
+#include "gsr-library-model.h"
+#include "gsr-thumbnailer.h"
+
+#define THUMBNAIL_CACHE_BYTES  (64 * 1024 * 1024)
+
+/* ═══════════════════════════════════════════════════════════════════
+ *  GsrLibraryPage — "Library" tab
+ *
+ *  Saved recordings and replays, newest first.  The list view only
+ *  creates rows for what is on screen, and a row asks for its file's
+ *  metadata and thumbnail when it is bound, so the page costs the same
+ *  with ten files as with fifty thousand.
+ * ═══════════════════════════════════════════════════════════════════ */
+
+struct _GsrLibraryPage {
+    AdwBin           parent_instance;
+
+    GsrLibraryModel *model;
+    GsrThumbnailer  *thumbnailer;
+    GtkStack        *stack;        /* "empty" / "list" */
+    GtkListView     *list_view;
+};
+
+G_DEFINE_FINAL_TYPE(GsrLibraryPage, gsr_library_page, ADW_TYPE_BIN)
+
+/* ── Rows ────────────────────────────────────────────────────────── */
+
+static char *
+format_duration(guint32 duration_ms)
+{
+    guint seconds = duration_ms / 1000;
+    if (seconds >= 3600)
+        return g_strdup_printf("%u:%02u:%02u", seconds / 3600, seconds / 60 % 60, seconds % 60);
+    return g_strdup_printf("%u:%02u", seconds / 60, seconds % 60);
+}
+
+/* "date · size · duration · resolution · codec" */
+static char *
+format_details(GsrLibraryItem *item)
+{
+    GString *details = g_string_new(NULL);
+
+    GDateTime *date = g_date_time_new_from_unix_local(gsr_library_item_get_mtime(item));
+    if (date) {
+        g_autofree char *text = g_date_time_format(date, "%x %H:%M");
+        g_string_append(details, text);
+        g_date_time_unref(date);
+    }
+
+    g_autofree char *size = g_format_size(gsr_library_item_get_size(item));
+    g_string_append_printf(details, " · %s", size);
+
+    if (gsr_library_item_has_metadata(item)) {
+        guint32 duration_ms = gsr_library_item_get_duration_ms(item);
+        if (duration_ms > 0) {
+            g_autofree char *duration = format_duration(duration_ms);
+            g_string_append_printf(details, " · %s", duration);
+        }
+        if (gsr_library_item_get_width(item) > 0)
+            g_string_append_printf(details, " · %d×%d",
+                gsr_library_item_get_width(item), gsr_library_item_get_height(item));
+        const char *codec = gsr_library_item_get_codec(item);
+        if (codec[0]) {
+            g_autofree char *upper = g_ascii_strup(codec, -1);
+            g_string_append_printf(details, " · %s", upper);
+        }
+    }
+
+    return g_string_free(details, FALSE);
+}
+
+static void
+on_row_setup(GtkSignalListItemFactory *factory G_GNUC_UNUSED,
+             GtkListItem *list_item, gpointer user_data G_GNUC_UNUSED)
+{
+    GtkWidget *box = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 12);
+    gtk_widget_set_margin_top(box, 6);
+    gtk_widget_set_margin_bottom(box, 6);
+    gtk_widget_set_margin_start(box, 12);
+    gtk_widget_set_margin_end(box, 12);
+
+    /* The thumbnail covers the placeholder icon once it's loaded */
+    GtkWidget *icon = gtk_image_new_from_icon_name("video-x-generic-symbolic");
+    gtk_image_set_pixel_size(GTK_IMAGE(icon), 32);
+    gtk_widget_add_css_class(icon, "dim-label");
+
+    GtkWidget *picture = gtk_picture_new();
+    gtk_picture_set_content_fit(GTK_PICTURE(picture), GTK_CONTENT_FIT_COVER);
+    gtk_picture_set_can_shrink(GTK_PICTURE(picture), TRUE);
+
+    GtkWidget *thumbnail = gtk_overlay_new();
+    gtk_widget_set_size_request(thumbnail, 96, 54);
+    gtk_widget_set_valign(thumbnail, GTK_ALIGN_CENTER);
+    gtk_widget_set_overflow(thumbnail, GTK_OVERFLOW_HIDDEN);
+    gtk_widget_add_css_class(thumbnail, "card");
+    gtk_overlay_set_child(GTK_OVERLAY(thumbnail), icon);
+    gtk_overlay_add_overlay(GTK_OVERLAY(thumbnail), picture);
+    gtk_box_append(GTK_BOX(box), thumbnail);
+
+    GtkWidget *labels = gtk_box_new(GTK_ORIENTATION_VERTICAL, 2);
+    gtk_widget_set_valign(labels, GTK_ALIGN_CENTER);
+    gtk_widget_set_hexpand(labels, TRUE);
+
+    GtkWidget *title = gtk_label_new(NULL);
+    gtk_label_set_xalign(GTK_LABEL(title), 0.0f);
+    gtk_label_set_ellipsize(GTK_LABEL(title), PANGO_ELLIPSIZE_MIDDLE);
+    gtk_box_append(GTK_BOX(labels), title);
+
+    GtkWidget *details = gtk_label_new(NULL);
+    gtk_label_set_xalign(GTK_LABEL(details), 0.0f);
+    gtk_label_set_ellipsize(GTK_LABEL(details), PANGO_ELLIPSIZE_END);
+    gtk_widget_add_css_class(details, "dim-label");
+    gtk_widget_add_css_class(details, "caption");
+    gtk_box_append(GTK_BOX(labels), details);
+
+    gtk_box_append(GTK_BOX(box), labels);
+
+    g_object_set_data(G_OBJECT(box), "picture", picture);
+    g_object_set_data(G_OBJECT(box), "title", title);
+    g_object_set_data(G_OBJECT(box), "details", details);
+    gtk_list_item_set_child(list_item, box);
+}
+
+static void
+on_thumbnail(GdkTexture *texture, gpointer user_data)
+{
+    gtk_picture_set_paintable(GTK_PICTURE(user_data), GDK_PAINTABLE(texture));
+}
+
+static void
+on_row_bind(GtkSignalListItemFactory *factory G_GNUC_UNUSED,
+            GtkListItem *list_item, gpointer user_data)
+{
+    GsrLibraryPage *self = GSR_LIBRARY_PAGE(user_data);
+    GsrLibraryItem *item = gtk_list_item_get_item(list_item);
+    GtkWidget *box = gtk_list_item_get_child(list_item);
+
+    g_autofree char *name = g_path_get_basename(gsr_library_item_get_path(item));
+    gtk_label_set_text(g_object_get_data(G_OBJECT(box), "title"), name);
+
+    g_autofree char *details = format_details(item);
+    gtk_label_set_text(g_object_get_data(G_OBJECT(box), "details"), details);
+
+    if (!gsr_library_item_has_metadata(item))
+        gsr_library_model_request_metadata(self->model, gtk_list_item_get_position(list_item));
+
+    /* Cancelled on unbind, so the picture is still this row's */
+    guint request_id = gsr_thumbnailer_request(self->thumbnailer,
+        gsr_library_item_get_path(item), gsr_library_item_get_mtime(item),
+        on_thumbnail, g_object_get_data(G_OBJECT(box), "picture"));
+    g_object_set_data(G_OBJECT(box), "thumbnail-request", GUINT_TO_POINTER(request_id));
+}
+
+static void
+on_row_unbind(GtkSignalListItemFactory *factory G_GNUC_UNUSED,
+              GtkListItem *list_item, gpointer user_data)
+{
+    GsrLibraryPage *self = GSR_LIBRARY_PAGE(user_data);
+    GtkWidget *box = gtk_list_item_get_child(list_item);
+
+    guint request_id = GPOINTER_TO_UINT(g_object_get_data(G_OBJECT(box), "thumbnail-request"));
+    gsr_thumbnailer_cancel(self->thumbnailer, request_id);
+    g_object_set_data(G_OBJECT(box), "thumbnail-request", NULL);
+    gtk_picture_set_paintable(g_object_get_data(G_OBJECT(box), "picture"), NULL);
+}
+
+/* ── Opening files ───────────────────────────────────────────────── */
+
+static void
+on_launch_finished(GObject *source, GAsyncResult *result, gpointer user_data G_GNUC_UNUSED)
+{
+    GError *error = NULL;
+    if (!gtk_file_launcher_launch_finish(GTK_FILE_LAUNCHER(source), result, &error)) {
+        if (!g_error_matches(error, GTK_DIALOG_ERROR, GTK_DIALOG_ERROR_DISMISSED))
+            g_warning("Failed to open recording: %s", error->message);
+        g_clear_error(&error);
+    }
+}
+
+static void
+on_row_activated(GtkListView *list_view G_GNUC_UNUSED, guint position, gpointer user_data)
+{
+    GsrLibraryPage *self = GSR_LIBRARY_PAGE(user_data);
+    g_autoptr(GsrLibraryItem) item = g_list_model_get_item(G_LIST_MODEL(self->model), position);
+    if (!item)
+        return;
+
+    g_autoptr(GFile) file = g_file_new_for_path(gsr_library_item_get_path(item));
+    g_autoptr(GtkFileLauncher) launcher = gtk_file_launcher_new(file);
+    gtk_file_launcher_launch(launcher, GTK_WINDOW(gtk_widget_get_root(GTK_WIDGET(self))),
+                             NULL, on_launch_finished, NULL);
+}
+
+/* ── Empty state ─────────────────────────────────────────────────── */
+
+static void
+update_empty_state(GsrLibraryPage *self)
+{
+    gboolean empty = g_list_model_get_n_items(G_LIST_MODEL(self->model)) == 0;
+    gtk_stack_set_visible_child_name(self->stack, empty ? "empty" : "list");
+}
+
+static void
+on_items_changed(GListModel *model G_GNUC_UNUSED, guint position G_GNUC_UNUSED,
+                 guint removed, guint added, gpointer user_data)
+{
+    if (removed != added)
+        update_empty_state(GSR_LIBRARY_PAGE(user_data));
+}
+
+/* ── GObject ─────────────────────────────────────────────────────── */
+
+static void
+gsr_library_page_dispose(GObject *object)
+{
+    GsrLibraryPage *self = GSR_LIBRARY_PAGE(object);
+
+    /* The list view holds a reference through its selection model; drop
+       ours so the model (and its pending index save) goes with it */
+    if (self->model)
+        g_signal_handlers_disconnect_by_data(self->model, self);
+    g_clear_object(&self->model);
+
+    G_OBJECT_CLASS(gsr_library_page_parent_class)->dispose(object);
+}
+
+static void
+gsr_library_page_finalize(GObject *object)
+{
+    GsrLibraryPage *self = GSR_LIBRARY_PAGE(object);
+
+    /* After dispose: unbinding the rows cancels their requests first */
+    g_clear_pointer(&self->thumbnailer, gsr_thumbnailer_free);
+
+    G_OBJECT_CLASS(gsr_library_page_parent_class)->finalize(object);
+}
+
+static void
+gsr_library_page_init(GsrLibraryPage *self)
+{
+    (void)self;
+}
+
+static void
+gsr_library_page_class_init(GsrLibraryPageClass *klass)
+{
+    GObjectClass *obj_class = G_OBJECT_CLASS(klass);
+    obj_class->dispose = gsr_library_page_dispose;
+    obj_class->finalize = gsr_library_page_finalize;
+}
+
+/* ── Public API ──────────────────────────────────────────────────── */
+
+GsrLibraryPage *
+gsr_library_page_new(const char *index_path)
+{
+    GsrLibraryPage *self = g_object_new(GSR_TYPE_LIBRARY_PAGE, NULL);
+    self->model = gsr_library_model_new(index_path);
+
+    g_autofree char *thumbnail_dir = g_build_filename(g_get_user_cache_dir(),
+        "gpu-screen-recorder", "thumbnails", NULL);
+    self->thumbnailer = gsr_thumbnailer_new(thumbnail_dir, THUMBNAIL_CACHE_BYTES);
+
+    GtkListItemFactory *factory = gtk_signal_list_item_factory_new();
+    g_signal_connect(factory, "setup", G_CALLBACK(on_row_setup), NULL);
+    g_signal_connect(factory, "bind", G_CALLBACK(on_row_bind), self);
+    g_signal_connect(factory, "unbind", G_CALLBACK(on_row_unbind), self);
+
+    GtkNoSelection *selection = gtk_no_selection_new(G_LIST_MODEL(g_object_ref(self->model)));
+    self->list_view = GTK_LIST_VIEW(gtk_list_view_new(GTK_SELECTION_MODEL(selection), factory));
+    gtk_list_view_set_single_click_activate(self->list_view, TRUE);
+    gtk_list_view_set_show_separators(self->list_view, TRUE);
+    g_signal_connect(self->list_view, "activate", G_CALLBACK(on_row_activated), self);
+
+    GtkWidget *scrolled = gtk_scrolled_window_new();
+    gtk_scrolled_window_set_policy(GTK_SCROLLED_WINDOW(scrolled),
+        GTK_POLICY_NEVER, GTK_POLICY_AUTOMATIC);
+    gtk_scrolled_window_set_child(GTK_SCROLLED_WINDOW(scrolled), GTK_WIDGET(self->list_view));
+
+    GtkWidget *empty = adw_status_page_new();
+    adw_status_page_set_icon_name(ADW_STATUS_PAGE(empty), "folder-videos-symbolic");
+    adw_status_page_set_title(ADW_STATUS_PAGE(empty), _("No Recordings"));
+    adw_status_page_set_description(ADW_STATUS_PAGE(empty),
+        _("Recordings and saved replays will show up here"));
+
+    self->stack = GTK_STACK(gtk_stack_new());
+    gtk_stack_add_named(self->stack, empty, "empty");
+    gtk_stack_add_named(self->stack, scrolled, "list");
+    adw_bin_set_child(ADW_BIN(self), GTK_WIDGET(self->stack));
+
+    g_signal_connect(self->model, "items-changed", G_CALLBACK(on_items_changed), self);
+    update_empty_state(self);
+
+    return self;
+}
+
+void
+gsr_library_page_apply_config(GsrLibraryPage *self, const GsrConfig *config)
+{
+    g_return_if_fail(GSR_IS_LIBRARY_PAGE(self));
+
+    const char *dirs[] = {
+        config->record_config.save_directory ? config->record_config.save_directory : "",
+        config->replay_config.save_directory ? config->replay_config.save_directory : "",
+        NULL,
+    };
+    gsr_library_model_set_directories(self->model, dirs);
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <adwaita.h>
+
+#include "gsr-config.h"
+
+G_BEGIN_DECLS
+
+#define GSR_TYPE_LIBRARY_PAGE (gsr_library_page_get_type())
+G_DECLARE_FINAL_TYPE(GsrLibraryPage, gsr_library_page, GSR, LIBRARY_PAGE, AdwBin)
+
+/* index_path: where the recordings index is kept (see gsr-library-index.h) */
+GsrLibraryPage *gsr_library_page_new          (const char *index_path);
+
+/* List recordings from the record and replay save directories. */
+void            gsr_library_page_apply_config (GsrLibraryPage  *self,
+                                               const GsrConfig *config);
+
+G_END_DECLS
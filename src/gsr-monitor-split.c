@@ -0,0 +1,49 @@
+#include "gsr-monitor-split.h"
+
+int
+gsr_monitor_split_fps(int budget_fps, int n_monitors, int max_fps)
+{
+    if (budget_fps <= 0 || n_monitors <= 0)
+        return 0;
+    return CLAMP(budget_fps / n_monitors, 1, MAX(max_fps, 1));
+}
+
+void
+gsr_monitor_split_bitrate(int budget_kbps, const gint64 *pixels, int n_monitors,
+                          int *out_kbps)
+{
+    if (n_monitors <= 0)
+        return;
+
+    gint64 total = 0;
+    for (int i = 0; i < n_monitors; i++)
+        total += MAX(pixels[i], 0);
+    gboolean even = total == 0;
+    if (even)
+        total = n_monitors;
+
+    /* Rounded down, remembering what each lost to it (in 1/total kbps) */
+    gint64 budget = MAX(budget_kbps, 0);
+    gint64 left = budget;
+    g_autofree gint64 *lost = g_new(gint64, n_monitors);
+    for (int i = 0; i < n_monitors; i++) {
+        gint64 scaled = budget * (even ? 1 : MAX(pixels[i], 0));
+        out_kbps[i] = (int)(scaled / total);
+        lost[i] = scaled % total;
+        left -= out_kbps[i];
+    }
+
+    /* Fewer than n_monitors kbps are left; the first of equals wins */
+    for (; left > 0; left--) {
+        int most = 0;
+        for (int i = 1; i < n_monitors; i++) {
+            if (lost[i] > lost[most])
+                most = i;
+        }
+        out_kbps[most]++;
+        lost[most] = -1;
+    }
+
+    for (int i = 0; i < n_monitors; i++)
+        out_kbps[i] = MAX(out_kbps[i], 1);
+}
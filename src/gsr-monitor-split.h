@@ -0,0 +1,29 @@
+#pragma once
+
+/*
+ * gsr-monitor-split.h — Sharing the budgets of a multi-monitor recording.
+ *
+ * Each monitor gets its own gpu-screen-recorder.  The Record page's frame
+ * rate budget is split evenly between them, the bitrate budget by pixel
+ * count, so a 4K monitor next to a 1080p one gets four times the bitrate.
+ */
+
+#include <glib.h>
+
+/**
+ * Frame rate of each of n_monitors recorders, at least 1 and at most
+ * max_fps.  0 (use the Config page's) if there is no budget.
+ */
+int  gsr_monitor_split_fps    (int budget_fps, int n_monitors, int max_fps);
+
+/**
+ * Fill out_kbps with each monitor's share of budget_kbps, in proportion
+ * to pixels.  The shares add up to the budget exactly: what rounding down
+ * leaves over goes to the monitors that lost the most to it.  Every
+ * monitor gets at least 1 kbps, so a budget below n_monitors is exceeded.
+ * Monitors without a known size all count the same.
+ */
+void gsr_monitor_split_bitrate(int           budget_kbps,
+                               const gint64 *pixels,
+                               int           n_monitors,
+                               int          *out_kbps);
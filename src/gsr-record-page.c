@@ -5,6 +5,7 @@
 
 #include <glib/gi18n.h>
 
+#include "gsr-stats-panel.h"
 #include "gsr-window.h"
 
 #ifdef HAVE_X11
@@ -34,9 +35,11 @@ struct _GsrRecordPage {
     AdwActionRow        *x11_start_stop_row;
     GtkShortcutLabel    *x11_start_stop_label;
     char                *x11_start_stop_accel;       /* owned */
+    gboolean             x11_start_stop_on_press;
     AdwActionRow        *x11_pause_row;
     GtkShortcutLabel    *x11_pause_label;
     char                *x11_pause_accel;             /* owned */
+    gboolean             x11_pause_on_press;
 #endif
 
     /* ── Output group ─── */
@@ -44,6 +47,15 @@ struct _GsrRecordPage {
     AdwActionRow        *save_dir_row;
     char                *save_directory;  /* owned */
     AdwComboRow         *container_row;
+    AdwSpinRow          *segment_minutes_row;
+    AdwSpinRow          *segment_size_row;
+
+    /* ── Monitors group (two monitors or more) ─── */
+    AdwPreferencesGroup *monitors_group;
+    AdwExpanderRow      *multi_monitor_row;
+    GPtrArray           *monitor_rows;    /* AdwSwitchRow*, as info's monitors */
+    AdwSpinRow          *fps_budget_row;
+    AdwSpinRow          *bitrate_budget_row;
 
     /* ── Action group ─── */
     AdwPreferencesGroup *action_group;
@@ -55,6 +67,7 @@ struct _GsrRecordPage {
     GtkBox              *status_box;
     GtkImage            *record_icon;
     GtkLabel            *timer_label;
+    GsrStatsPanel       *stats_panel;
 
     gboolean             is_active;
     gboolean             is_paused;
@@ -147,6 +160,22 @@ on_save_dir_activated(AdwActionRow *row G_GNUC_UNUSED,
 
 /* ── Callbacks ───────────────────────────────────────────────────── */
 
+static const char *combo_row_get_selected_string(AdwComboRow *row);
+
+/* HLS is split into segments already; several monitors aren't split */
+static void
+on_container_changed(GObject    *obj G_GNUC_UNUSED,
+                     GParamSpec *pspec G_GNUC_UNUSED,
+                     gpointer    user_data)
+{
+    GsrRecordPage *self = GSR_RECORD_PAGE(user_data);
+    gboolean can_split = !g_str_equal(combo_row_get_selected_string(self->container_row), "m3u8");
+    if (self->multi_monitor_row && adw_expander_row_get_enable_expansion(self->multi_monitor_row))
+        can_split = FALSE;
+    gtk_widget_set_sensitive(GTK_WIDGET(self->segment_minutes_row), can_split);
+    gtk_widget_set_sensitive(GTK_WIDGET(self->segment_size_row), can_split);
+}
+
 static void
 on_start_recording_clicked(GtkButton *btn G_GNUC_UNUSED,
                            gpointer   user_data)
@@ -194,9 +223,10 @@ on_pause_recording_clicked(GtkButton *btn G_GNUC_UNUSED,
     GtkRoot *root = gtk_widget_get_root(GTK_WIDGET(self));
     GsrWindow *window = (root && GSR_IS_WINDOW(root)) ? GSR_WINDOW(root) : NULL;
 
-    /* Send SIGUSR2 to toggle pause/unpause */
-    if (window)
-        gsr_window_send_signal(window, SIGUSR2);
+    /* Send SIGUSR2 to toggle pause/unpause.  Refused while the child
+       is still starting or already stopping; keep the UI as it is then. */
+    if (!window || !gsr_window_send_signal(window, SIGUSR2))
+        return;
 
     self->is_paused = !self->is_paused;
     gsr_record_page_set_paused(self, self->is_paused);
@@ -232,6 +262,7 @@ on_x11_start_stop_shortcut_set(GsrShortcutAccelDialog *dialog,
     const char *accel = gsr_shortcut_accel_dialog_get_accelerator(dialog);
 
     g_set_str(&self->x11_start_stop_accel, accel);
+    self->x11_start_stop_on_press = gsr_shortcut_accel_dialog_get_trigger_on_press(dialog);
 
     if (self->x11_start_stop_label)
         gtk_shortcut_label_set_accelerator(self->x11_start_stop_label,
@@ -250,6 +281,7 @@ on_x11_start_stop_activated(AdwActionRow *row G_GNUC_UNUSED,
     GsrRecordPage *self = GSR_RECORD_PAGE(user_data);
     GsrShortcutAccelDialog *dialog = gsr_shortcut_accel_dialog_new(
         _("Start/Stop recording"), self->x11_start_stop_accel);
+    gsr_shortcut_accel_dialog_set_trigger_on_press(dialog, self->x11_start_stop_on_press);
     g_signal_connect(dialog, "shortcut-set",
         G_CALLBACK(on_x11_start_stop_shortcut_set), self);
     adw_dialog_present(ADW_DIALOG(dialog), GTK_WIDGET(self));
@@ -263,6 +295,7 @@ on_x11_pause_shortcut_set(GsrShortcutAccelDialog *dialog,
     const char *accel = gsr_shortcut_accel_dialog_get_accelerator(dialog);
 
     g_set_str(&self->x11_pause_accel, accel);
+    self->x11_pause_on_press = gsr_shortcut_accel_dialog_get_trigger_on_press(dialog);
 
     if (self->x11_pause_label)
         gtk_shortcut_label_set_accelerator(self->x11_pause_label,
@@ -281,6 +314,7 @@ on_x11_pause_activated(AdwActionRow *row G_GNUC_UNUSED,
     GsrRecordPage *self = GSR_RECORD_PAGE(user_data);
     GsrShortcutAccelDialog *dialog = gsr_shortcut_accel_dialog_new(
         _("Pause/Unpause recording"), self->x11_pause_accel);
+    gsr_shortcut_accel_dialog_set_trigger_on_press(dialog, self->x11_pause_on_press);
     g_signal_connect(dialog, "shortcut-set",
         G_CALLBACK(on_x11_pause_shortcut_set), self);
     adw_dialog_present(ADW_DIALOG(dialog), GTK_WIDGET(self));
@@ -441,9 +475,82 @@ build_output_group(GsrRecordPage *self)
     adw_preferences_group_add(self->output_group,
         GTK_WIDGET(self->container_row));
 
+    /* Segments: a long recording as several files */
+    self->segment_minutes_row = ADW_SPIN_ROW(adw_spin_row_new_with_range(0, 1440, 5));
+    adw_preferences_row_set_title(ADW_PREFERENCES_ROW(self->segment_minutes_row),
+        _("Split every (minutes)"));
+    adw_action_row_set_subtitle(ADW_ACTION_ROW(self->segment_minutes_row),
+        _("Start a new file after this long, 0 to keep one file"));
+    adw_preferences_group_add(self->output_group,
+        GTK_WIDGET(self->segment_minutes_row));
+
+    self->segment_size_row = ADW_SPIN_ROW(adw_spin_row_new_with_range(0, 1000, 0.5));
+    adw_spin_row_set_digits(self->segment_size_row, 1);
+    adw_preferences_row_set_title(ADW_PREFERENCES_ROW(self->segment_size_row),
+        _("Split at size (GB)"));
+    adw_action_row_set_subtitle(ADW_ACTION_ROW(self->segment_size_row),
+        _("Start a new file once one reaches this size, 0 for no limit"));
+    adw_preferences_group_add(self->output_group,
+        GTK_WIDGET(self->segment_size_row));
+
+    g_signal_connect(self->container_row, "notify::selected",
+        G_CALLBACK(on_container_changed), self);
+
     adw_preferences_page_add(ADW_PREFERENCES_PAGE(self), self->output_group);
 }
 
+static void
+build_monitors_group(GsrRecordPage *self)
+{
+    const GsrSupportedCaptureOptions *opts = &self->info->supported_capture_options;
+    if (opts->n_monitors < 2)
+        return;
+
+    self->monitors_group = ADW_PREFERENCES_GROUP(adw_preferences_group_new());
+    adw_preferences_group_set_title(self->monitors_group, _("Monitors"));
+
+    self->multi_monitor_row = ADW_EXPANDER_ROW(adw_expander_row_new());
+    adw_preferences_row_set_title(ADW_PREFERENCES_ROW(self->multi_monitor_row),
+        _("Record several monitors"));
+    adw_expander_row_set_subtitle(self->multi_monitor_row,
+        _("One file per monitor, all started and stopped together"));
+    adw_expander_row_set_show_enable_switch(self->multi_monitor_row, TRUE);
+    adw_expander_row_set_enable_expansion(self->multi_monitor_row, FALSE);
+
+    self->monitor_rows = g_ptr_array_new();
+    for (int i = 0; i < opts->n_monitors; i++) {
+        const GsrMonitor *m = &opts->monitors[i];
+        AdwSwitchRow *row = ADW_SWITCH_ROW(adw_switch_row_new());
+        adw_preferences_row_set_title(ADW_PREFERENCES_ROW(row), m->name);
+        g_autofree char *size = g_strdup_printf("%d × %d", m->width, m->height);
+        adw_action_row_set_subtitle(ADW_ACTION_ROW(row), size);
+        adw_switch_row_set_active(row, TRUE);
+        adw_expander_row_add_row(self->multi_monitor_row, GTK_WIDGET(row));
+        g_ptr_array_add(self->monitor_rows, row);
+    }
+
+    /* Each recorder encodes on its own; these keep the sum in check */
+    self->fps_budget_row = ADW_SPIN_ROW(adw_spin_row_new_with_range(0, 1000, 10));
+    adw_preferences_row_set_title(ADW_PREFERENCES_ROW(self->fps_budget_row),
+        _("Total frame rate"));
+    adw_action_row_set_subtitle(ADW_ACTION_ROW(self->fps_budget_row),
+        _("Shared evenly between the monitors, 0 for no limit"));
+    adw_expander_row_add_row(self->multi_monitor_row, GTK_WIDGET(self->fps_budget_row));
+
+    self->bitrate_budget_row = ADW_SPIN_ROW(adw_spin_row_new_with_range(0, 500000, 1000));
+    adw_preferences_row_set_title(ADW_PREFERENCES_ROW(self->bitrate_budget_row),
+        _("Total bitrate (kbps)"));
+    adw_action_row_set_subtitle(ADW_ACTION_ROW(self->bitrate_budget_row),
+        _("Shared by monitor size at a constant bitrate, 0 to use the quality setting"));
+    adw_expander_row_add_row(self->multi_monitor_row, GTK_WIDGET(self->bitrate_budget_row));
+
+    g_signal_connect(self->multi_monitor_row, "notify::enable-expansion",
+        G_CALLBACK(on_container_changed), self);
+
+    adw_preferences_group_add(self->monitors_group, GTK_WIDGET(self->multi_monitor_row));
+    adw_preferences_page_add(ADW_PREFERENCES_PAGE(self), self->monitors_group);
+}
+
 static void
 build_action_group(GsrRecordPage *self)
 {
@@ -491,6 +598,10 @@ build_status_group(GsrRecordPage *self)
     gtk_box_append(self->status_box, GTK_WIDGET(self->timer_label));
 
     adw_preferences_group_add(self->status_group, GTK_WIDGET(self->status_box));
+
+    self->stats_panel = gsr_stats_panel_new();
+    gtk_widget_set_margin_top(GTK_WIDGET(self->stats_panel), 12);
+    adw_preferences_group_add(self->status_group, GTK_WIDGET(self->stats_panel));
     adw_preferences_page_add(ADW_PREFERENCES_PAGE(self), self->status_group);
 }
 
@@ -503,6 +614,7 @@ gsr_record_page_finalize(GObject *object)
 
     g_clear_handle_id(&self->timer_source_id, g_source_remove);
 
+    g_clear_pointer(&self->monitor_rows, g_ptr_array_unref);
     g_free(self->save_directory);
 #ifdef HAVE_X11
     g_free(self->x11_start_stop_accel);
@@ -588,17 +700,37 @@ gsr_record_page_apply_config(GsrRecordPage *self, const GsrConfig *config)
     combo_row_select_string(self->container_row,
         container_id_to_display(r->container));
 
+    /* Segments */
+    adw_spin_row_set_value(self->segment_minutes_row, MAX(r->segment_minutes, 0));
+    adw_spin_row_set_value(self->segment_size_row, MAX(r->segment_size_mb, 0) / 1000.0);
+
+    /* Monitors: an empty list means all of them */
+    if (self->multi_monitor_row) {
+        const GsrSupportedCaptureOptions *opts = &self->info->supported_capture_options;
+        for (int i = 0; i < opts->n_monitors; i++) {
+            gboolean chosen = r->n_monitors == 0;
+            for (int j = 0; j < r->n_monitors && !chosen; j++)
+                chosen = g_str_equal(r->monitors[j], opts->monitors[i].name);
+            adw_switch_row_set_active(g_ptr_array_index(self->monitor_rows, i), chosen);
+        }
+        adw_spin_row_set_value(self->fps_budget_row, MAX(r->multi_fps_budget, 0));
+        adw_spin_row_set_value(self->bitrate_budget_row, MAX(r->multi_bitrate_budget_kbps, 0));
+        adw_expander_row_set_enable_expansion(self->multi_monitor_row, r->multi_monitor);
+    }
+
     /* Hotkeys (X11 only) */
 #ifdef HAVE_X11
     if (self->x11_start_stop_label) {
         g_free(self->x11_start_stop_accel);
         self->x11_start_stop_accel = gsr_config_hotkey_to_accel(&r->start_stop_hotkey);
+        self->x11_start_stop_on_press = r->start_stop_hotkey.trigger == GSR_HOTKEY_TRIGGER_PRESS;
         gtk_shortcut_label_set_accelerator(self->x11_start_stop_label,
             self->x11_start_stop_accel ? self->x11_start_stop_accel : "");
     }
     if (self->x11_pause_label) {
         g_free(self->x11_pause_accel);
         self->x11_pause_accel = gsr_config_hotkey_to_accel(&r->pause_unpause_hotkey);
+        self->x11_pause_on_press = r->pause_unpause_hotkey.trigger == GSR_HOTKEY_TRIGGER_PRESS;
         gtk_shortcut_label_set_accelerator(self->x11_pause_label,
             self->x11_pause_accel ? self->x11_pause_accel : "");
     }
@@ -617,10 +749,45 @@ gsr_record_page_read_config(GsrRecordPage *self, GsrConfig *config)
     g_set_str(&r->container, container_display_to_id(
         combo_row_get_selected_string(self->container_row)));
 
+    /* Segments */
+    r->segment_minutes = gsr_record_page_get_segment_minutes(self);
+    r->segment_size_mb = gsr_record_page_get_segment_size_mb(self);
+
+    /* Monitors: kept as they were if this machine has fewer than two, or
+       if none is switched on; an empty list would read back as all of them */
+    if (self->multi_monitor_row) {
+        const GsrSupportedCaptureOptions *opts = &self->info->supported_capture_options;
+        int n_chosen = 0;
+        for (int i = 0; i < opts->n_monitors; i++) {
+            if (adw_switch_row_get_active(g_ptr_array_index(self->monitor_rows, i)))
+                n_chosen++;
+        }
+        if (n_chosen > 0) {
+            if (r->monitors) {
+                for (int i = 0; i < r->n_monitors; i++)
+                    g_free(r->monitors[i]);
+                g_clear_pointer(&r->monitors, g_free);
+            }
+            r->monitors = g_new0(char *, n_chosen + 1);
+            r->n_monitors = 0;
+            for (int i = 0; i < opts->n_monitors; i++) {
+                if (adw_switch_row_get_active(g_ptr_array_index(self->monitor_rows, i)))
+                    r->monitors[r->n_monitors++] = g_strdup(opts->monitors[i].name);
+            }
+        }
+        r->multi_monitor = adw_expander_row_get_enable_expansion(self->multi_monitor_row);
+        r->multi_fps_budget = gsr_record_page_get_fps_budget(self);
+        r->multi_bitrate_budget_kbps = gsr_record_page_get_bitrate_budget_kbps(self);
+    }
+
     /* Hotkeys */
 #ifdef HAVE_X11
     gsr_config_hotkey_from_accel(&r->start_stop_hotkey, self->x11_start_stop_accel);
+    r->start_stop_hotkey.trigger = self->x11_start_stop_on_press
+        ? GSR_HOTKEY_TRIGGER_PRESS : GSR_HOTKEY_TRIGGER_RELEASE;
     gsr_config_hotkey_from_accel(&r->pause_unpause_hotkey, self->x11_pause_accel);
+    r->pause_unpause_hotkey.trigger = self->x11_pause_on_press
+        ? GSR_HOTKEY_TRIGGER_PRESS : GSR_HOTKEY_TRIGGER_RELEASE;
 #endif
 }
 
@@ -645,6 +812,7 @@ gsr_record_page_set_active(GsrRecordPage *self, gboolean active)
         gtk_button_set_label(self->pause_button, _("Pause recording"));
         gtk_widget_set_opacity(GTK_WIDGET(self->status_box), 0.5);
         gtk_label_set_text(self->timer_label, "00:00:00");
+        gsr_stats_panel_clear(self->stats_panel);
         gtk_image_set_from_icon_name(self->record_icon, "media-record-symbolic");
         gtk_widget_remove_css_class(GTK_WIDGET(self->record_icon), "recording-active");
         gtk_widget_remove_css_class(GTK_WIDGET(self->record_icon), "recording-paused");
@@ -678,6 +846,13 @@ gsr_record_page_update_timer(GsrRecordPage *self, const char *text)
     gtk_label_set_text(self->timer_label, text);
 }
 
+void
+gsr_record_page_update_stats(GsrRecordPage *self, const GsrEncodeStats *stats)
+{
+    g_return_if_fail(GSR_IS_RECORD_PAGE(self));
+    gsr_stats_panel_update(self->stats_panel, stats);
+}
+
 const char *
 gsr_record_page_get_save_dir(GsrRecordPage *self)
 {
@@ -691,6 +866,53 @@ gsr_record_page_get_container(GsrRecordPage *self)
         combo_row_get_selected_string(self->container_row)));
 }
 
+int
+gsr_record_page_get_segment_minutes(GsrRecordPage *self)
+{
+    return (int)adw_spin_row_get_value(self->segment_minutes_row);
+}
+
+int
+gsr_record_page_get_segment_size_mb(GsrRecordPage *self)
+{
+    return (int)(adw_spin_row_get_value(self->segment_size_row) * 1000.0 + 0.5);
+}
+
+char **
+gsr_record_page_get_monitors(GsrRecordPage *self)
+{
+    if (!self->multi_monitor_row || !adw_expander_row_get_enable_expansion(self->multi_monitor_row))
+        return NULL;
+
+    const GsrSupportedCaptureOptions *opts = &self->info->supported_capture_options;
+    GStrvBuilder *builder = g_strv_builder_new();
+    guint n = 0;
+    for (int i = 0; i < opts->n_monitors; i++) {
+        if (adw_switch_row_get_active(g_ptr_array_index(self->monitor_rows, i))) {
+            g_strv_builder_add(builder, opts->monitors[i].name);
+            n++;
+        }
+    }
+    char **monitors = g_strv_builder_end(builder);
+    g_strv_builder_unref(builder);
+
+    if (n < 2)
+        g_clear_pointer(&monitors, g_strfreev);
+    return monitors;
+}
+
+int
+gsr_record_page_get_fps_budget(GsrRecordPage *self)
+{
+    return self->fps_budget_row ? (int)adw_spin_row_get_value(self->fps_budget_row) : 0;
+}
+
+int
+gsr_record_page_get_bitrate_budget_kbps(GsrRecordPage *self)
+{
+    return self->bitrate_budget_row ? (int)adw_spin_row_get_value(self->bitrate_budget_row) : 0;
+}
+
 /* ── Public API ──────────────────────────────────────────────────── */
 
 GsrRecordPage *
@@ -705,6 +927,7 @@ gsr_record_page_new(const GsrInfo *info)
 
     build_hotkey_group(self);
     build_output_group(self);
+    build_monitors_group(self);
     build_action_group(self);
     build_status_group(self);
 
@@ -3,6 +3,7 @@
 #include <adwaita.h>
 
 #include "gsr-config.h"
+#include "gsr-encode-stats.h"
 #include "gsr-info.h"
 
 G_BEGIN_DECLS
@@ -23,6 +24,8 @@ void           gsr_record_page_set_paused    (GsrRecordPage *self,
                                               gboolean       paused);
 void           gsr_record_page_update_timer  (GsrRecordPage *self,
                                               const char    *text);
+void           gsr_record_page_update_stats  (GsrRecordPage        *self,
+                                              const GsrEncodeStats *stats);
 
 /* Get the save directory. Borrowed pointer, do NOT free. */
 const char    *gsr_record_page_get_save_dir  (GsrRecordPage *self);
@@ -30,6 +33,18 @@ const char    *gsr_record_page_get_save_dir  (GsrRecordPage *self);
 /* Get the container ID for -c argument. Caller must g_free(). */
 char          *gsr_record_page_get_container (GsrRecordPage *self);
 
+/* Split the recording after this many minutes / at this size, 0 if not. */
+int            gsr_record_page_get_segment_minutes(GsrRecordPage *self);
+int            gsr_record_page_get_segment_size_mb(GsrRecordPage *self);
+
+/* The monitors to record at once, NULL unless that's on and at least
+   two are chosen.  Caller must g_strfreev(). */
+char         **gsr_record_page_get_monitors  (GsrRecordPage *self);
+
+/* Frame rate and bitrate shared by those monitors, 0 if unlimited. */
+int            gsr_record_page_get_fps_budget(GsrRecordPage *self);
+int            gsr_record_page_get_bitrate_budget_kbps(GsrRecordPage *self);
+
 /* Hotkey: programmatically toggle start/stop. */
 void           gsr_record_page_activate_start_stop(GsrRecordPage *self);
 
@@ -0,0 +1,174 @@
+#include "gsr-replay-budget.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define AUDIO_BYTES_PER_SECOND  (128000 / 8)    /* per track, opus/aac default */
+#define CONTAINER_OVERHEAD_PCT  5
+#define SCALE_BLEND_PCT         25              /* weight of a new measurement */
+
+/* ── Bitrate guess ───────────────────────────────────────────────── */
+
+/*
+ * Bits per pixel per frame gpu-screen-recorder's presets end up at with
+ * h264 on typical desktop/game content; 1080p60 "high" comes to ~7.5 Mbps.
+ */
+static double
+quality_bits_per_pixel(const char *quality)
+{
+    if (g_strcmp0(quality, "medium") == 0)    return 0.04;
+    if (g_strcmp0(quality, "very_high") == 0) return 0.08;
+    if (g_strcmp0(quality, "ultra") == 0)     return 0.12;
+    return 0.06; /* high */
+}
+
+/* Size relative to h264 at the same quality */
+static double
+codec_efficiency(const char *codec)
+{
+    if (!codec)                           return 1.0;
+    if (g_str_has_prefix(codec, "hevc"))  return 0.75;
+    if (g_str_has_prefix(codec, "av1"))   return 0.65;
+    if (g_str_has_prefix(codec, "vp"))    return 0.8;
+    return 1.0;
+}
+
+/* ── Public API ──────────────────────────────────────────────────── */
+
+gint64
+gsr_replay_budget_bytes_per_second(const GsrReplayStream *stream)
+{
+    gint64 video;
+    if (g_strcmp0(stream->quality, "custom") == 0) {
+        video = (gint64)stream->bitrate_kbps * 1000 / 8;
+    } else {
+        double bits = quality_bits_per_pixel(stream->quality)
+            * codec_efficiency(stream->codec)
+            * stream->width * stream->height * stream->fps;
+        video = (gint64)(bits / 8);
+    }
+
+    gint64 audio = (gint64)MAX(stream->n_audio_tracks, 0) * AUDIO_BYTES_PER_SECOND;
+    return (video + audio) * (100 + CONTAINER_OVERHEAD_PCT) / 100;
+}
+
+gint64
+gsr_replay_budget_estimate(gint64 bytes_per_second, int seconds,
+                           int scale_percent)
+{
+    if (scale_percent <= 0)
+        scale_percent = 100;
+    return bytes_per_second * MAX(seconds, 0) * scale_percent / 100;
+}
+
+int
+gsr_replay_budget_refine_scale(int scale_percent, gint64 estimated,
+                               gint64 measured)
+{
+    if (scale_percent <= 0)
+        scale_percent = 100;
+    if (estimated <= 0 || measured <= 0)
+        return scale_percent;
+
+    gint64 observed = measured * 100 / estimated;
+    observed = CLAMP(observed, GSR_REPLAY_SCALE_MIN_PERCENT, GSR_REPLAY_SCALE_MAX_PERCENT);
+
+    /* Exponential moving average so one odd session can't swing it */
+    gint64 blended = (scale_percent * (100 - SCALE_BLEND_PCT)
+                      + observed * SCALE_BLEND_PCT) / 100;
+    return (int)CLAMP(blended, GSR_REPLAY_SCALE_MIN_PERCENT, GSR_REPLAY_SCALE_MAX_PERCENT);
+}
+
+/* ── /proc and cgroup parsing ────────────────────────────────────── */
+
+/* Value of a "Key:   1234 kB" line, in bytes, or -1 */
+static gint64
+read_kib_field(const char *path, const char *key)
+{
+    FILE *f = fopen(path, "r");
+    if (!f)
+        return -1;
+
+    size_t key_len = strlen(key);
+    char line[256];
+    gint64 result = -1;
+    while (fgets(line, sizeof(line), f)) {
+        if (strncmp(line, key, key_len) == 0 && line[key_len] == ':') {
+            long long kib = 0;
+            if (sscanf(line + key_len + 1, "%lld", &kib) == 1)
+                result = (gint64)kib * 1024;
+            break;
+        }
+    }
+    fclose(f);
+    return result;
+}
+
+/* A single-number cgroup file; "max" and errors return -1 */
+static gint64
+read_cgroup_value(const char *dir, const char *name)
+{
+    g_autofree char *path = g_build_filename(dir, name, NULL);
+    g_autofree char *contents = NULL;
+    if (!g_file_get_contents(path, &contents, NULL, NULL))
+        return -1;
+    if (g_str_has_prefix(contents, "max"))
+        return -1;
+    return g_ascii_strtoll(contents, NULL, 10);
+}
+
+/*
+ * Smallest memory.max - memory.current from our cgroup up to the root;
+ * any ancestor's limit applies to us too.  cgroup v1 isn't handled.
+ */
+static gint64
+cgroup_headroom(void)
+{
+    g_autofree char *contents = NULL;
+    if (!g_file_get_contents("/proc/self/cgroup", &contents, NULL, NULL))
+        return -1;
+
+    /* v2 has a single "0::/path" line */
+    const char *line = strstr(contents, "0::");
+    if (!line)
+        return -1;
+    g_autofree char *rel = g_strndup(line + 3, strcspn(line + 3, "\n"));
+    g_autofree char *dir = g_build_filename("/sys/fs/cgroup", rel, NULL);
+
+    gint64 headroom = -1;
+    while (g_str_has_prefix(dir, "/sys/fs/cgroup/")) {
+        gint64 max = read_cgroup_value(dir, "memory.max");
+        gint64 current = read_cgroup_value(dir, "memory.current");
+        if (max >= 0 && current >= 0) {
+            gint64 room = MAX(max - current, 0);
+            if (headroom < 0 || room < headroom)
+                headroom = room;
+        }
+
+        char *parent = g_path_get_dirname(dir);
+        g_free(dir);
+        dir = parent;
+    }
+    return headroom;
+}
+
+gint64
+gsr_replay_budget_available_ram(void)
+{
+    gint64 available = read_kib_field("/proc/meminfo", "MemAvailable");
+    gint64 headroom = cgroup_headroom();
+
+    if (available < 0)
+        return headroom;
+    if (headroom < 0)
+        return available;
+    return MIN(available, headroom);
+}
+
+gint64
+gsr_replay_budget_rss(pid_t pid)
+{
+    char path[64];
+    snprintf(path, sizeof(path), "/proc/%d/status", (int)pid);
+    return read_kib_field(path, "VmRSS");
+}
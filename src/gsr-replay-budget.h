@@ -0,0 +1,65 @@
+#pragma once
+
+/*
+ * gsr-replay-budget.h — How much memory a replay buffer will pin.
+ *
+ * gpu-screen-recorder keeps the last -r seconds of encoded packets in RAM
+ * (or in a file with -replay-storage disk), so the buffer is roughly the
+ * encoded bitrate times the replay length.  Preset qualities have no fixed
+ * bitrate; theirs is guessed from resolution, fps and codec.  Estimates
+ * are scaled by a correction factor learned from the child's measured RSS.
+ */
+
+#include <glib.h>
+#include <sys/types.h>
+
+typedef struct {
+    const char *codec;          /* resolved: "h264", "hevc_10bit", "av1", ... */
+    const char *quality;        /* "custom", "medium", "high", "very_high", "ultra" */
+    int         bitrate_kbps;   /* custom quality only */
+    int         width;
+    int         height;
+    int         fps;
+    int         n_audio_tracks;
+} GsrReplayStream;
+
+/* Share of available RAM a replay buffer may take before it's shortened */
+#define GSR_REPLAY_RAM_BUDGET_PERCENT 80
+/* Shortest replay the Replay page allows */
+#define GSR_REPLAY_MIN_SECONDS        5
+
+/* Correction factors outside this range are treated as measurement noise */
+#define GSR_REPLAY_SCALE_MIN_PERCENT  25
+#define GSR_REPLAY_SCALE_MAX_PERCENT  400
+
+/**
+ * Encoded bytes per second of the stream, uncorrected.
+ */
+gint64 gsr_replay_budget_bytes_per_second(const GsrReplayStream *stream);
+
+/**
+ * Bytes a buffer of `seconds` holds at `bytes_per_second`, scaled by
+ * scale_percent / 100.
+ */
+gint64 gsr_replay_budget_estimate(gint64 bytes_per_second, int seconds,
+                                  int scale_percent);
+
+/**
+ * Blend one measurement (buffer bytes actually resident vs. the
+ * uncorrected estimate for the same span) into scale_percent.
+ * Returns the new, clamped scale.
+ */
+int    gsr_replay_budget_refine_scale(int scale_percent, gint64 estimated,
+                                      gint64 measured);
+
+/**
+ * Memory a new child can still use: the smaller of MemAvailable and the
+ * headroom under the cgroup v2 memory.max limits of this process.
+ * Returns -1 if neither is known.
+ */
+gint64 gsr_replay_budget_available_ram(void);
+
+/**
+ * Resident set size of pid in bytes, or -1.
+ */
+gint64 gsr_replay_budget_rss(pid_t pid);
@@ -1,10 +1,11 @@
 #include "gsr-replay-page.h"
 
-#include <signal.h>
 #include <time.h>
 
 #include <glib/gi18n.h>
 
+#include "gsr-replay-budget.h"
+#include "gsr-stats-panel.h"
 #include "gsr-window.h"
 
 #ifdef HAVE_X11
@@ -34,9 +35,19 @@ struct _GsrReplayPage {
     AdwActionRow        *x11_start_stop_row;
     GtkShortcutLabel    *x11_start_stop_label;
     char                *x11_start_stop_accel;       /* owned */
+    gboolean             x11_start_stop_on_press;
     AdwActionRow        *x11_save_row;
     GtkShortcutLabel    *x11_save_label;
     char                *x11_save_accel;              /* owned */
+    gboolean             x11_save_on_press;
+    AdwActionRow        *x11_save_short_row;
+    GtkShortcutLabel    *x11_save_short_label;
+    char                *x11_save_short_accel;        /* owned */
+    gboolean             x11_save_short_on_press;
+    AdwActionRow        *x11_save_long_row;
+    GtkShortcutLabel    *x11_save_long_label;
+    char                *x11_save_long_accel;         /* owned */
+    gboolean             x11_save_long_on_press;
 #endif
 
     /* ── Output group ─── */
@@ -45,6 +56,11 @@ struct _GsrReplayPage {
     char                *save_directory;  /* owned */
     AdwComboRow         *container_row;
     AdwSpinRow          *replay_time_row;
+    AdwComboRow         *storage_row;      /* 0 = RAM, 1 = disk */
+    AdwActionRow        *estimate_row;
+    GtkImage            *estimate_warning;
+    AdwComboRow         *save_short_row;   /* index into gsr_replay_save_lengths */
+    AdwComboRow         *save_long_row;
 
     /* ── Action group ─── */
     AdwPreferencesGroup *action_group;
@@ -56,6 +72,7 @@ struct _GsrReplayPage {
     GtkBox              *status_box;
     GtkImage            *record_icon;
     GtkLabel            *timer_label;
+    GsrStatsPanel       *stats_panel;
 
     gboolean             is_active;
     double               start_time;
@@ -103,6 +120,56 @@ on_timer_tick(gpointer user_data)
     return G_SOURCE_CONTINUE;
 }
 
+/* ── Buffer size estimate ────────────────────────────────────────── */
+
+static void
+update_estimate(GsrReplayPage *self)
+{
+    GtkRoot *root = gtk_widget_get_root(GTK_WIDGET(self));
+    if (!root || !GSR_IS_WINDOW(root))
+        return;
+
+    int seconds = (int)adw_spin_row_get_value(self->replay_time_row);
+    gint64 estimate = gsr_window_estimate_replay_bytes(GSR_WINDOW(root), seconds);
+    g_autofree char *size = g_format_size((guint64)estimate);
+    g_autofree char *subtitle = NULL;
+    gboolean too_big = FALSE;
+
+    if (adw_combo_row_get_selected(self->storage_row) == 1) {
+        subtitle = g_strdup_printf(_("About %s on disk"), size);
+    } else {
+        gint64 available = gsr_replay_budget_available_ram();
+        if (available < 0) {
+            subtitle = g_strdup_printf(_("About %s of RAM"), size);
+        } else {
+            g_autofree char *avail = g_format_size((guint64)available);
+            too_big = estimate > available * GSR_REPLAY_RAM_BUDGET_PERCENT / 100;
+            subtitle = too_big
+                ? g_strdup_printf(_("About %s of RAM, only %s available. The replay "
+                                    "will be shortened; consider disk storage."), size, avail)
+                : g_strdup_printf(_("About %s of RAM (%s available)"), size, avail);
+        }
+    }
+
+    adw_action_row_set_subtitle(self->estimate_row, subtitle);
+    gtk_widget_set_visible(GTK_WIDGET(self->estimate_warning), too_big);
+}
+
+static void
+on_estimate_input_changed(GObject    *object G_GNUC_UNUSED,
+                          GParamSpec *pspec G_GNUC_UNUSED,
+                          gpointer    user_data)
+{
+    update_estimate(GSR_REPLAY_PAGE(user_data));
+}
+
+/* Capture settings live on the Config page; re-estimate whenever shown */
+static void
+on_page_map(GtkWidget *widget, gpointer user_data G_GNUC_UNUSED)
+{
+    update_estimate(GSR_REPLAY_PAGE(widget));
+}
+
 /* ── File chooser ────────────────────────────────────────────────── */
 
 static void
@@ -175,20 +242,25 @@ on_start_replay_clicked(GtkButton *btn G_GNUC_UNUSED,
     }
 }
 
+/* Save the last `seconds` of the replay, 0 for all of it */
 static void
-on_save_replay_clicked(GtkButton *btn G_GNUC_UNUSED,
-                       gpointer   user_data)
+save_replay(GsrReplayPage *self, int seconds)
 {
-    GsrReplayPage *self = GSR_REPLAY_PAGE(user_data);
     if (!self->is_active) return;
 
     GtkRoot *root = gtk_widget_get_root(GTK_WIDGET(self));
     GsrWindow *window = (root && GSR_IS_WINDOW(root)) ? GSR_WINDOW(root) : NULL;
 
-    if (window) {
-        gsr_window_send_signal(window, SIGUSR1);
+    /* Repeated presses within the minimum save interval are dropped */
+    if (window && gsr_window_save_replay(window, seconds))
         gsr_window_notify_replay_saved(window);
-    }
+}
+
+static void
+on_save_replay_clicked(GtkButton *btn G_GNUC_UNUSED,
+                       gpointer   user_data)
+{
+    save_replay(GSR_REPLAY_PAGE(user_data), 0);
 }
 
 /* ── Build groups ────────────────────────────────────────────────── */
@@ -213,6 +285,7 @@ on_x11_start_stop_shortcut_set(GsrShortcutAccelDialog *dialog,
     const char *accel = gsr_shortcut_accel_dialog_get_accelerator(dialog);
 
     g_set_str(&self->x11_start_stop_accel, accel);
+    self->x11_start_stop_on_press = gsr_shortcut_accel_dialog_get_trigger_on_press(dialog);
 
     if (self->x11_start_stop_label)
         gtk_shortcut_label_set_accelerator(self->x11_start_stop_label,
@@ -230,6 +303,7 @@ on_x11_start_stop_activated(AdwActionRow *row G_GNUC_UNUSED,
     GsrReplayPage *self = GSR_REPLAY_PAGE(user_data);
     GsrShortcutAccelDialog *dialog = gsr_shortcut_accel_dialog_new(
         _("Start/Stop replay"), self->x11_start_stop_accel);
+    gsr_shortcut_accel_dialog_set_trigger_on_press(dialog, self->x11_start_stop_on_press);
     g_signal_connect(dialog, "shortcut-set",
         G_CALLBACK(on_x11_start_stop_shortcut_set), self);
     adw_dialog_present(ADW_DIALOG(dialog), GTK_WIDGET(self));
@@ -243,6 +317,7 @@ on_x11_save_shortcut_set(GsrShortcutAccelDialog *dialog,
     const char *accel = gsr_shortcut_accel_dialog_get_accelerator(dialog);
 
     g_set_str(&self->x11_save_accel, accel);
+    self->x11_save_on_press = gsr_shortcut_accel_dialog_get_trigger_on_press(dialog);
 
     if (self->x11_save_label)
         gtk_shortcut_label_set_accelerator(self->x11_save_label,
@@ -260,10 +335,94 @@ on_x11_save_activated(AdwActionRow *row G_GNUC_UNUSED,
     GsrReplayPage *self = GSR_REPLAY_PAGE(user_data);
     GsrShortcutAccelDialog *dialog = gsr_shortcut_accel_dialog_new(
         _("Save replay"), self->x11_save_accel);
+    gsr_shortcut_accel_dialog_set_trigger_on_press(dialog, self->x11_save_on_press);
     g_signal_connect(dialog, "shortcut-set",
         G_CALLBACK(on_x11_save_shortcut_set), self);
     adw_dialog_present(ADW_DIALOG(dialog), GTK_WIDGET(self));
 }
+
+static void
+on_x11_save_short_shortcut_set(GsrShortcutAccelDialog *dialog,
+                                gpointer                user_data)
+{
+    GsrReplayPage *self = GSR_REPLAY_PAGE(user_data);
+    const char *accel = gsr_shortcut_accel_dialog_get_accelerator(dialog);
+
+    g_set_str(&self->x11_save_short_accel, accel);
+    self->x11_save_short_on_press = gsr_shortcut_accel_dialog_get_trigger_on_press(dialog);
+
+    if (self->x11_save_short_label)
+        gtk_shortcut_label_set_accelerator(self->x11_save_short_label,
+            accel ? accel : "");
+
+    GtkRoot *root = gtk_widget_get_root(GTK_WIDGET(self));
+    if (root && GSR_IS_WINDOW(root))
+        gsr_window_on_hotkey_changed(GSR_WINDOW(root));
+}
+
+static void
+on_x11_save_short_activated(AdwActionRow *row G_GNUC_UNUSED,
+                             gpointer      user_data)
+{
+    GsrReplayPage *self = GSR_REPLAY_PAGE(user_data);
+    GsrShortcutAccelDialog *dialog = gsr_shortcut_accel_dialog_new(
+        _("Save short replay"), self->x11_save_short_accel);
+    gsr_shortcut_accel_dialog_set_trigger_on_press(dialog, self->x11_save_short_on_press);
+    g_signal_connect(dialog, "shortcut-set",
+        G_CALLBACK(on_x11_save_short_shortcut_set), self);
+    adw_dialog_present(ADW_DIALOG(dialog), GTK_WIDGET(self));
+}
+
+static void
+on_x11_save_long_shortcut_set(GsrShortcutAccelDialog *dialog,
+                               gpointer                user_data)
+{
+    GsrReplayPage *self = GSR_REPLAY_PAGE(user_data);
+    const char *accel = gsr_shortcut_accel_dialog_get_accelerator(dialog);
+
+    g_set_str(&self->x11_save_long_accel, accel);
+    self->x11_save_long_on_press = gsr_shortcut_accel_dialog_get_trigger_on_press(dialog);
+
+    if (self->x11_save_long_label)
+        gtk_shortcut_label_set_accelerator(self->x11_save_long_label,
+            accel ? accel : "");
+
+    GtkRoot *root = gtk_widget_get_root(GTK_WIDGET(self));
+    if (root && GSR_IS_WINDOW(root))
+        gsr_window_on_hotkey_changed(GSR_WINDOW(root));
+}
+
+static void
+on_x11_save_long_activated(AdwActionRow *row G_GNUC_UNUSED,
+                            gpointer      user_data)
+{
+    GsrReplayPage *self = GSR_REPLAY_PAGE(user_data);
+    GsrShortcutAccelDialog *dialog = gsr_shortcut_accel_dialog_new(
+        _("Save long replay"), self->x11_save_long_accel);
+    gsr_shortcut_accel_dialog_set_trigger_on_press(dialog, self->x11_save_long_on_press);
+    g_signal_connect(dialog, "shortcut-set",
+        G_CALLBACK(on_x11_save_long_shortcut_set), self);
+    adw_dialog_present(ADW_DIALOG(dialog), GTK_WIDGET(self));
+}
+
+/* An activatable row showing a hotkey, opening the accel dialog */
+static AdwActionRow *
+new_x11_hotkey_row(const char        *title,
+                   const char        *accel,
+                   GtkShortcutLabel **out_label)
+{
+    AdwActionRow *row = ADW_ACTION_ROW(adw_action_row_new());
+    adw_preferences_row_set_title(ADW_PREFERENCES_ROW(row), title);
+    gtk_list_box_row_set_activatable(GTK_LIST_BOX_ROW(row), TRUE);
+
+    *out_label = GTK_SHORTCUT_LABEL(gtk_shortcut_label_new(accel ? accel : ""));
+    gtk_widget_set_valign(GTK_WIDGET(*out_label), GTK_ALIGN_CENTER);
+    adw_action_row_add_suffix(row, GTK_WIDGET(*out_label));
+    GtkImage *arrow = GTK_IMAGE(gtk_image_new_from_icon_name("go-next-symbolic"));
+    gtk_widget_add_css_class(GTK_WIDGET(arrow), "dim-label");
+    adw_action_row_add_suffix(row, GTK_WIDGET(arrow));
+    return row;
+}
 #endif /* HAVE_X11 */
 
 static void
@@ -368,6 +527,19 @@ build_hotkey_group(GsrReplayPage *self)
         g_signal_connect(self->x11_save_row, "activated",
             G_CALLBACK(on_x11_save_activated), self);
         adw_preferences_group_add(self->hotkey_group, GTK_WIDGET(self->x11_save_row));
+
+        /* Partial save rows */
+        self->x11_save_short_row = new_x11_hotkey_row(_("Save short replay"),
+            self->x11_save_short_accel, &self->x11_save_short_label);
+        g_signal_connect(self->x11_save_short_row, "activated",
+            G_CALLBACK(on_x11_save_short_activated), self);
+        adw_preferences_group_add(self->hotkey_group, GTK_WIDGET(self->x11_save_short_row));
+
+        self->x11_save_long_row = new_x11_hotkey_row(_("Save long replay"),
+            self->x11_save_long_accel, &self->x11_save_long_label);
+        g_signal_connect(self->x11_save_long_row, "activated",
+            G_CALLBACK(on_x11_save_long_activated), self);
+        adw_preferences_group_add(self->hotkey_group, GTK_WIDGET(self->x11_save_long_row));
     }
 #endif /* HAVE_X11 */
 
@@ -376,6 +548,27 @@ build_hotkey_group(GsrReplayPage *self)
     adw_preferences_page_add(ADW_PREFERENCES_PAGE(self), self->hotkey_group);
 }
 
+static AdwComboRow *
+new_save_length_row(const char *title, const char *subtitle, int seconds)
+{
+    AdwComboRow *row = ADW_COMBO_ROW(adw_combo_row_new());
+    adw_preferences_row_set_title(ADW_PREFERENCES_ROW(row), title);
+    adw_action_row_set_subtitle(ADW_ACTION_ROW(row), subtitle);
+
+    GtkStringList *model = gtk_string_list_new(NULL);
+    for (int i = 0; i < GSR_N_REPLAY_SAVE_LENGTHS; i++) {
+        int n = gsr_replay_save_lengths[i];
+        g_autofree char *label = n < 60
+            ? g_strdup_printf(ngettext("Last %d second", "Last %d seconds", n), n)
+            : g_strdup_printf(ngettext("Last %d minute", "Last %d minutes", n / 60), n / 60);
+        gtk_string_list_append(model, label);
+    }
+    adw_combo_row_set_model(row, G_LIST_MODEL(model));
+    g_object_unref(model);
+    adw_combo_row_set_selected(row, (guint)gsr_replay_save_length_index(seconds));
+    return row;
+}
+
 static void
 build_output_group(GsrReplayPage *self)
 {
@@ -422,13 +615,52 @@ build_output_group(GsrReplayPage *self)
 
     /* Replay time */
     self->replay_time_row = ADW_SPIN_ROW(
-        adw_spin_row_new_with_range(5, 1200, 1));
+        adw_spin_row_new_with_range(GSR_REPLAY_MIN_SECONDS, 1200, 1));
     adw_preferences_row_set_title(ADW_PREFERENCES_ROW(self->replay_time_row),
         _("Replay time (seconds)"));
     adw_spin_row_set_value(self->replay_time_row, 30);
     adw_preferences_group_add(self->output_group,
         GTK_WIDGET(self->replay_time_row));
 
+    /* Buffer storage */
+    self->storage_row = ADW_COMBO_ROW(adw_combo_row_new());
+    adw_preferences_row_set_title(ADW_PREFERENCES_ROW(self->storage_row),
+        _("Buffer storage"));
+    GtkStringList *storage_model = gtk_string_list_new(
+        (const char *[]){ _("RAM"), _("Disk"), NULL });
+    adw_combo_row_set_model(self->storage_row, G_LIST_MODEL(storage_model));
+    g_object_unref(storage_model);
+    adw_preferences_group_add(self->output_group,
+        GTK_WIDGET(self->storage_row));
+
+    /* Estimated buffer size */
+    self->estimate_row = ADW_ACTION_ROW(adw_action_row_new());
+    adw_preferences_row_set_title(ADW_PREFERENCES_ROW(self->estimate_row),
+        _("Estimated buffer size"));
+    self->estimate_warning = GTK_IMAGE(
+        gtk_image_new_from_icon_name("dialog-warning-symbolic"));
+    gtk_widget_add_css_class(GTK_WIDGET(self->estimate_warning), "warning");
+    gtk_widget_set_visible(GTK_WIDGET(self->estimate_warning), FALSE);
+    adw_action_row_add_suffix(self->estimate_row, GTK_WIDGET(self->estimate_warning));
+    adw_preferences_group_add(self->output_group,
+        GTK_WIDGET(self->estimate_row));
+
+    g_signal_connect(self->replay_time_row, "notify::value",
+        G_CALLBACK(on_estimate_input_changed), self);
+    g_signal_connect(self->storage_row, "notify::selected",
+        G_CALLBACK(on_estimate_input_changed), self);
+    g_signal_connect(self, "map", G_CALLBACK(on_page_map), NULL);
+
+    /* Partial save lengths (hotkeys and app.save-replay) */
+    self->save_short_row = new_save_length_row(_("Short save"),
+        _("Saves only the end of the replay"), 30);
+    adw_preferences_group_add(self->output_group,
+        GTK_WIDGET(self->save_short_row));
+    self->save_long_row = new_save_length_row(_("Long save"),
+        _("Saves only the end of the replay"), 300);
+    adw_preferences_group_add(self->output_group,
+        GTK_WIDGET(self->save_long_row));
+
     adw_preferences_page_add(ADW_PREFERENCES_PAGE(self), self->output_group);
 }
 
@@ -479,6 +711,10 @@ build_status_group(GsrReplayPage *self)
     gtk_box_append(self->status_box, GTK_WIDGET(self->timer_label));
 
     adw_preferences_group_add(self->status_group, GTK_WIDGET(self->status_box));
+
+    self->stats_panel = gsr_stats_panel_new();
+    gtk_widget_set_margin_top(GTK_WIDGET(self->stats_panel), 12);
+    adw_preferences_group_add(self->status_group, GTK_WIDGET(self->stats_panel));
     adw_preferences_page_add(ADW_PREFERENCES_PAGE(self), self->status_group);
 }
 
@@ -495,6 +731,8 @@ gsr_replay_page_finalize(GObject *object)
 #ifdef HAVE_X11
     g_free(self->x11_start_stop_accel);
     g_free(self->x11_save_accel);
+    g_free(self->x11_save_short_accel);
+    g_free(self->x11_save_long_accel);
 #endif
     G_OBJECT_CLASS(gsr_replay_page_parent_class)->finalize(object);
 }
@@ -580,20 +818,48 @@ gsr_replay_page_apply_config(GsrReplayPage *self, const GsrConfig *config)
     if (rp->replay_time > 0)
         adw_spin_row_set_value(self->replay_time_row, rp->replay_time);
 
+    /* Buffer storage */
+    adw_combo_row_set_selected(self->storage_row,
+        g_strcmp0(rp->storage, "disk") == 0 ? 1 : 0);
+
+    /* Partial save lengths (values in between round up) */
+    int idx = gsr_replay_save_length_index(rp->save_short_time);
+    if (idx >= 0)
+        adw_combo_row_set_selected(self->save_short_row, (guint)idx);
+    idx = gsr_replay_save_length_index(rp->save_long_time);
+    if (idx >= 0)
+        adw_combo_row_set_selected(self->save_long_row, (guint)idx);
+
     /* Hotkeys (X11 only) */
 #ifdef HAVE_X11
     if (self->x11_start_stop_label) {
         g_free(self->x11_start_stop_accel);
         self->x11_start_stop_accel = gsr_config_hotkey_to_accel(&rp->start_stop_hotkey);
+        self->x11_start_stop_on_press = rp->start_stop_hotkey.trigger == GSR_HOTKEY_TRIGGER_PRESS;
         gtk_shortcut_label_set_accelerator(self->x11_start_stop_label,
             self->x11_start_stop_accel ? self->x11_start_stop_accel : "");
     }
     if (self->x11_save_label) {
         g_free(self->x11_save_accel);
         self->x11_save_accel = gsr_config_hotkey_to_accel(&rp->save_hotkey);
+        self->x11_save_on_press = rp->save_hotkey.trigger == GSR_HOTKEY_TRIGGER_PRESS;
         gtk_shortcut_label_set_accelerator(self->x11_save_label,
             self->x11_save_accel ? self->x11_save_accel : "");
     }
+    if (self->x11_save_short_label) {
+        g_free(self->x11_save_short_accel);
+        self->x11_save_short_accel = gsr_config_hotkey_to_accel(&rp->save_short_hotkey);
+        self->x11_save_short_on_press = rp->save_short_hotkey.trigger == GSR_HOTKEY_TRIGGER_PRESS;
+        gtk_shortcut_label_set_accelerator(self->x11_save_short_label,
+            self->x11_save_short_accel ? self->x11_save_short_accel : "");
+    }
+    if (self->x11_save_long_label) {
+        g_free(self->x11_save_long_accel);
+        self->x11_save_long_accel = gsr_config_hotkey_to_accel(&rp->save_long_hotkey);
+        self->x11_save_long_on_press = rp->save_long_hotkey.trigger == GSR_HOTKEY_TRIGGER_PRESS;
+        gtk_shortcut_label_set_accelerator(self->x11_save_long_label,
+            self->x11_save_long_accel ? self->x11_save_long_accel : "");
+    }
 #endif
 }
 
@@ -612,10 +878,27 @@ gsr_replay_page_read_config(GsrReplayPage *self, GsrConfig *config)
     /* Replay time */
     rp->replay_time = (int32_t)adw_spin_row_get_value(self->replay_time_row);
 
+    /* Buffer storage */
+    g_set_str(&rp->storage, gsr_replay_page_get_storage(self));
+
+    /* Partial save lengths */
+    rp->save_short_time = gsr_replay_page_get_save_short_time(self);
+    rp->save_long_time = gsr_replay_page_get_save_long_time(self);
+
     /* Hotkeys */
 #ifdef HAVE_X11
     gsr_config_hotkey_from_accel(&rp->start_stop_hotkey, self->x11_start_stop_accel);
+    rp->start_stop_hotkey.trigger = self->x11_start_stop_on_press
+        ? GSR_HOTKEY_TRIGGER_PRESS : GSR_HOTKEY_TRIGGER_RELEASE;
     gsr_config_hotkey_from_accel(&rp->save_hotkey, self->x11_save_accel);
+    rp->save_hotkey.trigger = self->x11_save_on_press
+        ? GSR_HOTKEY_TRIGGER_PRESS : GSR_HOTKEY_TRIGGER_RELEASE;
+    gsr_config_hotkey_from_accel(&rp->save_short_hotkey, self->x11_save_short_accel);
+    rp->save_short_hotkey.trigger = self->x11_save_short_on_press
+        ? GSR_HOTKEY_TRIGGER_PRESS : GSR_HOTKEY_TRIGGER_RELEASE;
+    gsr_config_hotkey_from_accel(&rp->save_long_hotkey, self->x11_save_long_accel);
+    rp->save_long_hotkey.trigger = self->x11_save_long_on_press
+        ? GSR_HOTKEY_TRIGGER_PRESS : GSR_HOTKEY_TRIGGER_RELEASE;
 #endif
 }
 
@@ -638,6 +921,7 @@ gsr_replay_page_set_active(GsrReplayPage *self, gboolean active)
         gtk_widget_set_sensitive(GTK_WIDGET(self->save_button), FALSE);
         gtk_widget_set_opacity(GTK_WIDGET(self->status_box), 0.5);
         gtk_label_set_text(self->timer_label, "00:00:00");
+        gsr_stats_panel_clear(self->stats_panel);
         gtk_widget_remove_css_class(GTK_WIDGET(self->record_icon), "recording-active");
 
         /* Reset internal state (handles external stop via handle_child_death) */
@@ -652,6 +936,13 @@ gsr_replay_page_update_timer(GsrReplayPage *self, const char *text)
     gtk_label_set_text(self->timer_label, text);
 }
 
+void
+gsr_replay_page_update_stats(GsrReplayPage *self, const GsrEncodeStats *stats)
+{
+    g_return_if_fail(GSR_IS_REPLAY_PAGE(self));
+    gsr_stats_panel_update(self->stats_panel, stats);
+}
+
 const char *
 gsr_replay_page_get_save_dir(GsrReplayPage *self)
 {
@@ -671,6 +962,24 @@ gsr_replay_page_get_time(GsrReplayPage *self)
     return (int)adw_spin_row_get_value(self->replay_time_row);
 }
 
+const char *
+gsr_replay_page_get_storage(GsrReplayPage *self)
+{
+    return adw_combo_row_get_selected(self->storage_row) == 1 ? "disk" : "ram";
+}
+
+int
+gsr_replay_page_get_save_short_time(GsrReplayPage *self)
+{
+    return gsr_replay_save_lengths[adw_combo_row_get_selected(self->save_short_row)];
+}
+
+int
+gsr_replay_page_get_save_long_time(GsrReplayPage *self)
+{
+    return gsr_replay_save_lengths[adw_combo_row_get_selected(self->save_long_row)];
+}
+
 /* ── Public API ──────────────────────────────────────────────────── */
 
 GsrReplayPage *
@@ -699,11 +1008,10 @@ gsr_replay_page_activate_start_stop(GsrReplayPage *self)
 }
 
 void
-gsr_replay_page_activate_save(GsrReplayPage *self)
+gsr_replay_page_activate_save(GsrReplayPage *self, int seconds)
 {
     g_return_if_fail(GSR_IS_REPLAY_PAGE(self));
-    if (!self->is_active) return;
-    gtk_widget_activate(GTK_WIDGET(self->save_button));
+    save_replay(self, seconds);
 }
 
 #ifdef HAVE_WAYLAND
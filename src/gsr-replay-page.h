@@ -3,6 +3,7 @@
 #include <adwaita.h>
 
 #include "gsr-config.h"
+#include "gsr-encode-stats.h"
 #include "gsr-info.h"
 
 G_BEGIN_DECLS
@@ -21,6 +22,8 @@ void           gsr_replay_page_set_active    (GsrReplayPage *self,
                                               gboolean       active);
 void           gsr_replay_page_update_timer  (GsrReplayPage *self,
                                               const char    *text);
+void           gsr_replay_page_update_stats  (GsrReplayPage        *self,
+                                              const GsrEncodeStats *stats);
 
 /* Get the save directory. Borrowed pointer, do NOT free. */
 const char    *gsr_replay_page_get_save_dir  (GsrReplayPage *self);
@@ -31,11 +34,20 @@ char          *gsr_replay_page_get_container (GsrReplayPage *self);
 /* Get the replay time in seconds. */
 int            gsr_replay_page_get_time      (GsrReplayPage *self);
 
+/* Get the replay buffer storage for -replay-storage: "ram" or "disk". */
+const char    *gsr_replay_page_get_storage   (GsrReplayPage *self);
+
+/* Get the short/long partial save lengths in seconds, as currently set. */
+int            gsr_replay_page_get_save_short_time(GsrReplayPage *self);
+int            gsr_replay_page_get_save_long_time (GsrReplayPage *self);
+
 /* Hotkey: programmatically toggle start/stop. */
 void           gsr_replay_page_activate_start_stop(GsrReplayPage *self);
 
-/* Hotkey: programmatically save replay. */
-void           gsr_replay_page_activate_save(GsrReplayPage *self);
+/* Hotkey: programmatically save the last `seconds` of the replay,
+   0 for all of it. */
+void           gsr_replay_page_activate_save(GsrReplayPage *self,
+                                             int            seconds);
 
 /* Wayland: show/hide hotkey-not-supported banner. */
 #ifdef HAVE_WAYLAND
@@ -0,0 +1,79 @@
+#include "gsr-replay-trim.h"
+
+#include <errno.h>
+
+#include <glib/gstdio.h>
+
+typedef struct {
+    char             *path;
+    char             *tmp_path;
+    GsrReplayTrimFunc callback;
+    gpointer          user_data;
+} Trim;
+
+static void
+trim_free(Trim *trim)
+{
+    g_free(trim->path);
+    g_free(trim->tmp_path);
+    g_free(trim);
+}
+
+static void
+on_trim_done(GObject *source, GAsyncResult *result, gpointer user_data)
+{
+    Trim *trim = user_data;
+    GError *error = NULL;
+    gboolean ok = g_subprocess_wait_check_finish(G_SUBPROCESS(source), result, &error);
+
+    if (g_error_matches(error, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+        g_subprocess_force_exit(G_SUBPROCESS(source));
+    } else {
+        if (!ok) {
+            g_warning("Failed to trim %s: %s", trim->path, error->message);
+        } else if (g_rename(trim->tmp_path, trim->path) != 0) {
+            g_warning("Failed to replace %s with its trimmed copy: %s",
+                      trim->path, g_strerror(errno));
+            ok = FALSE;
+        }
+        trim->callback(trim->path, ok, trim->user_data);
+    }
+
+    if (!ok)
+        g_unlink(trim->tmp_path);
+    g_clear_error(&error);
+    trim_free(trim);
+}
+
+void
+gsr_replay_trim_async(const char *path, int seconds, GCancellable *cancellable,
+                      GsrReplayTrimFunc callback, gpointer user_data)
+{
+    /* Hidden, and with the same extension so ffmpeg picks the same muxer */
+    g_autofree char *dir = g_path_get_dirname(path);
+    g_autofree char *name = g_path_get_basename(path);
+    g_autofree char *tmp_name = g_strconcat(".trim-", name, NULL);
+    g_autofree char *sseof = g_strdup_printf("-%d", seconds);
+
+    Trim *trim = g_new0(Trim, 1);
+    trim->path = g_strdup(path);
+    trim->tmp_path = g_build_filename(dir, tmp_name, NULL);
+    trim->callback = callback;
+    trim->user_data = user_data;
+
+    GError *error = NULL;
+    GSubprocess *proc = g_subprocess_new(
+        G_SUBPROCESS_FLAGS_STDIN_INHERIT, &error,
+        "ffmpeg", "-nostdin", "-v", "error", "-y", "-sseof", sseof,
+        "-i", path, "-map", "0", "-c", "copy", trim->tmp_path, NULL);
+    if (!proc) {
+        g_warning("Failed to run ffmpeg to trim %s: %s", path, error->message);
+        g_error_free(error);
+        callback(path, FALSE, user_data);
+        trim_free(trim);
+        return;
+    }
+
+    g_subprocess_wait_check_async(proc, cancellable, on_trim_done, trim);
+    g_object_unref(proc);
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+/*
+ * gsr-replay-trim.h — Cut a saved replay down to its last seconds.
+ *
+ * For recorders without partial saves (SIGRTMIN+N): the whole buffer is
+ * saved with SIGUSR1 and cut here by ffmpeg, stream copied into a file
+ * next to it that then replaces it.  The cut starts at a keyframe, so the
+ * result can be up to one keyframe interval longer than asked.
+ */
+
+#include <gio/gio.h>
+
+/* trimmed is FALSE if ffmpeg failed; path is then left as it was */
+typedef void (*GsrReplayTrimFunc)(const char *path, gboolean trimmed,
+                                  gpointer user_data);
+
+/**
+ * Keep the last `seconds` of path.  The callback runs on the main loop
+ * once ffmpeg exits, or before this returns if it can't be started.  It
+ * doesn't run if cancellable is cancelled first; ffmpeg is then killed.
+ */
+void gsr_replay_trim_async(const char        *path,
+                           int                seconds,
+                           GCancellable      *cancellable,
+                           GsrReplayTrimFunc  callback,
+                           gpointer           user_data);
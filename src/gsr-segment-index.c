@@ -0,0 +1,114 @@
+#include "gsr-segment-index.h"
+
+#include <sys/stat.h>
+
+typedef struct {
+    int    sequence;
+    char  *file;        /* as listed: relative to the index if possible */
+    gint64 size;
+} Segment;
+
+struct _GsrSegmentIndex {
+    char   *path;
+    char   *dir;
+    GArray *segments;   /* Segment, by sequence */
+};
+
+static void
+segment_clear(Segment *segment)
+{
+    g_free(segment->file);
+}
+
+/* ffconcat quoting: the name in single quotes, a quote as '\'' */
+static void
+append_quoted(GString *out, const char *str)
+{
+    g_string_append_c(out, '\'');
+    for (const char *p = str; *p; p++) {
+        if (*p == '\'')
+            g_string_append(out, "'\\''");
+        else
+            g_string_append_c(out, *p);
+    }
+    g_string_append_c(out, '\'');
+}
+
+static gboolean
+write_index(GsrSegmentIndex *self, GError **error)
+{
+    GString *out = g_string_new("ffconcat version 1.0\n");
+    g_string_append(out, "# Segments of one recording; consecutive segments overlap by a moment\n");
+    for (guint i = 0; i < self->segments->len; i++) {
+        const Segment *segment = &g_array_index(self->segments, Segment, i);
+        g_string_append_printf(out, "# %d, %" G_GINT64_FORMAT " bytes\nfile ",
+                               segment->sequence, segment->size);
+        append_quoted(out, segment->file);
+        g_string_append_c(out, '\n');
+    }
+
+    gboolean ok = g_file_set_contents(self->path, out->str, (gssize)out->len, error);
+    g_string_free(out, TRUE);
+    return ok;
+}
+
+/* ── Public API ──────────────────────────────────────────────────── */
+
+GsrSegmentIndex *
+gsr_segment_index_new(const char *path)
+{
+    GsrSegmentIndex *self = g_new0(GsrSegmentIndex, 1);
+    self->path = g_strdup(path);
+    self->dir = g_path_get_dirname(path);
+    self->segments = g_array_new(FALSE, TRUE, sizeof(Segment));
+    g_array_set_clear_func(self->segments, (GDestroyNotify)segment_clear);
+    return self;
+}
+
+void
+gsr_segment_index_free(GsrSegmentIndex *self)
+{
+    if (!self)
+        return;
+    g_array_unref(self->segments);
+    g_free(self->dir);
+    g_free(self->path);
+    g_free(self);
+}
+
+gboolean
+gsr_segment_index_add(GsrSegmentIndex *self, int sequence, const char *file,
+                      GError **error)
+{
+    g_return_val_if_fail(self != NULL && file != NULL, FALSE);
+
+    g_autofree char *dir = g_path_get_dirname(file);
+    Segment segment = {
+        .sequence = sequence,
+        .file = g_str_equal(dir, self->dir) ? g_path_get_basename(file) : g_strdup(file),
+        .size = -1,
+    };
+    struct stat st;
+    if (stat(file, &st) == 0)
+        segment.size = st.st_size;
+
+    /* Usually the last one; a segment stopped early can finish after the next */
+    guint pos = self->segments->len;
+    while (pos > 0 && g_array_index(self->segments, Segment, pos - 1).sequence > sequence)
+        pos--;
+    g_array_insert_val(self->segments, pos, segment);
+
+    return write_index(self, error);
+}
+
+const char *
+gsr_segment_index_get_path(GsrSegmentIndex *self)
+{
+    return self->path;
+}
+
+guint
+gsr_segment_index_get_n_segments(GsrSegmentIndex *self)
+{
+    return self->segments->len;
+}
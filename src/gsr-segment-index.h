@@ -0,0 +1,39 @@
+#pragma once
+
+/*
+ * gsr-segment-index.h — List of the segments of a split recording.
+ *
+ * Written as an ffconcat playlist next to the segments, so the recording
+ * can be played or joined in one go:
+ *
+ *   ffmpeg -f concat -safe 0 -i Video_<date>.ffconcat -c copy Video.mp4
+ *
+ * The file is rewritten (atomically) whenever a segment is added, so it
+ * lists every finished segment even if the recording never ends cleanly.
+ * Segments are kept in sequence order whatever order they finish in.
+ */
+
+#include <glib.h>
+
+typedef struct _GsrSegmentIndex GsrSegmentIndex;
+
+/**
+ * An index to be written to path.  Nothing is written until the first
+ * segment is added.
+ */
+GsrSegmentIndex *gsr_segment_index_new     (const char *path);
+
+void             gsr_segment_index_free    (GsrSegmentIndex *self);
+
+/**
+ * Add the finished segment number sequence and rewrite the index.  file
+ * is listed relative to the index when it's in the same directory.
+ */
+gboolean         gsr_segment_index_add     (GsrSegmentIndex *self,
+                                            int              sequence,
+                                            const char      *file,
+                                            GError         **error);
+
+const char      *gsr_segment_index_get_path(GsrSegmentIndex *self);
+
+guint            gsr_segment_index_get_n_segments(GsrSegmentIndex *self);
@@ -14,7 +14,8 @@
  *  - Valid key combo → store, switch to display mode, user clicks "Set"
  *
  *  The dialog emits "shortcut-set" with the accelerator string (or NULL
- *  if cleared).
+ *  if cleared).  A "Trigger on key press" switch below the capture area
+ *  picks which key edge fires the hotkey.
  * ═══════════════════════════════════════════════════════════════════ */
 
 struct _GsrShortcutAccelDialog {
@@ -31,6 +32,9 @@ struct _GsrShortcutAccelDialog {
     guint      keyval;
     GdkModifierType modifier;
 
+    /* Fire on key press instead of release */
+    gboolean   trigger_on_press;
+
     /* State */
     gboolean   editing;     /* TRUE = waiting for key press */
 
@@ -41,6 +45,7 @@ struct _GsrShortcutAccelDialog {
     GtkShortcutLabel *display_label;
     GtkButton *set_button;
     GtkButton *cancel_button;
+    AdwSwitchRow *press_row;
 };
 
 G_DEFINE_FINAL_TYPE(GsrShortcutAccelDialog, gsr_shortcut_accel_dialog, ADW_TYPE_DIALOG)
@@ -183,6 +188,22 @@ on_key_pressed(GtkEventControllerKey *controller,
 
 /* ── Button callbacks ────────────────────────────────────────────── */
 
+static void
+on_press_row_toggled(AdwSwitchRow *row,
+                     GParamSpec   *pspec G_GNUC_UNUSED,
+                     gpointer      user_data)
+{
+    GsrShortcutAccelDialog *self = GSR_SHORTCUT_ACCEL_DIALOG(user_data);
+    self->trigger_on_press = adw_switch_row_get_active(row);
+
+    /* Changing only the edge of an existing shortcut shouldn't require
+       re-entering the keys — offer the current one for confirmation. */
+    if (self->editing && self->accelerator) {
+        self->editing = FALSE;
+        update_display(self);
+    }
+}
+
 static void
 on_set_clicked(GtkButton *btn G_GNUC_UNUSED, gpointer user_data)
 {
@@ -244,7 +265,7 @@ build_dialog_ui(GsrShortcutAccelDialog *self)
 {
     adw_dialog_set_title(ADW_DIALOG(self), _("Set Shortcut"));
     adw_dialog_set_content_width(ADW_DIALOG(self), 400);
-    adw_dialog_set_content_height(ADW_DIALOG(self), 260);
+    adw_dialog_set_content_height(ADW_DIALOG(self), 340);
 
     /* ── Header bar ─── */
     AdwHeaderBar *header = ADW_HEADER_BAR(adw_header_bar_new());
@@ -325,6 +346,26 @@ build_dialog_ui(GsrShortcutAccelDialog *self)
 
     gtk_stack_add_named(self->stack, GTK_WIDGET(display_box), "display");
 
+    /* ── Trigger edge ─── */
+    AdwPreferencesGroup *trigger_group = ADW_PREFERENCES_GROUP(adw_preferences_group_new());
+    gtk_widget_set_margin_start(GTK_WIDGET(trigger_group), 12);
+    gtk_widget_set_margin_end(GTK_WIDGET(trigger_group), 12);
+    gtk_widget_set_margin_bottom(GTK_WIDGET(trigger_group), 12);
+
+    self->press_row = ADW_SWITCH_ROW(adw_switch_row_new());
+    adw_preferences_row_set_title(ADW_PREFERENCES_ROW(self->press_row),
+        _("Trigger on key press"));
+    adw_action_row_set_subtitle(ADW_ACTION_ROW(self->press_row),
+        _("Fire as soon as the key goes down instead of when it is released"));
+    g_signal_connect(self->press_row, "notify::active",
+        G_CALLBACK(on_press_row_toggled), self);
+    adw_preferences_group_add(trigger_group, GTK_WIDGET(self->press_row));
+
+    GtkBox *content_box = GTK_BOX(gtk_box_new(GTK_ORIENTATION_VERTICAL, 0));
+    gtk_widget_set_vexpand(GTK_WIDGET(self->stack), TRUE);
+    gtk_box_append(content_box, GTK_WIDGET(self->stack));
+    gtk_box_append(content_box, GTK_WIDGET(trigger_group));
+
     /* ── Key event controller (capture phase) ─── */
     GtkEventController *key_ctrl = gtk_event_controller_key_new();
     gtk_event_controller_set_propagation_phase(key_ctrl, GTK_PHASE_CAPTURE);
@@ -335,7 +376,7 @@ build_dialog_ui(GsrShortcutAccelDialog *self)
     /* ── Layout: toolbar-view ─── */
     AdwToolbarView *toolbar_view = ADW_TOOLBAR_VIEW(adw_toolbar_view_new());
     adw_toolbar_view_add_top_bar(toolbar_view, GTK_WIDGET(header));
-    adw_toolbar_view_set_content(toolbar_view, GTK_WIDGET(self->stack));
+    adw_toolbar_view_set_content(toolbar_view, GTK_WIDGET(content_box));
 
     adw_dialog_set_child(ADW_DIALOG(self), GTK_WIDGET(toolbar_view));
 
@@ -371,3 +412,22 @@ gsr_shortcut_accel_dialog_get_accelerator(GsrShortcutAccelDialog *self)
     g_return_val_if_fail(GSR_IS_SHORTCUT_ACCEL_DIALOG(self), NULL);
     return self->accelerator;
 }
+
+void
+gsr_shortcut_accel_dialog_set_trigger_on_press(GsrShortcutAccelDialog *self,
+                                                gboolean                on_press)
+{
+    g_return_if_fail(GSR_IS_SHORTCUT_ACCEL_DIALOG(self));
+
+    self->trigger_on_press = on_press;
+    g_signal_handlers_block_by_func(self->press_row, on_press_row_toggled, self);
+    adw_switch_row_set_active(self->press_row, on_press);
+    g_signal_handlers_unblock_by_func(self->press_row, on_press_row_toggled, self);
+}
+
+gboolean
+gsr_shortcut_accel_dialog_get_trigger_on_press(GsrShortcutAccelDialog *self)
+{
+    g_return_val_if_fail(GSR_IS_SHORTCUT_ACCEL_DIALOG(self), FALSE);
+    return self->trigger_on_press;
+}
@@ -32,4 +32,12 @@ GsrShortcutAccelDialog *gsr_shortcut_accel_dialog_new(const char *shortcut_title
  */
 const char *gsr_shortcut_accel_dialog_get_accelerator(GsrShortcutAccelDialog *self);
 
+/**
+ * Set/get whether the shortcut fires on key press (TRUE) or on key
+ * release (FALSE, the default).  Set before presenting the dialog.
+ */
+void     gsr_shortcut_accel_dialog_set_trigger_on_press(GsrShortcutAccelDialog *self,
+                                                         gboolean                on_press);
+gboolean gsr_shortcut_accel_dialog_get_trigger_on_press(GsrShortcutAccelDialog *self);
+
 G_END_DECLS
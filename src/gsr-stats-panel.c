@@ -0,0 +1,196 @@
+#include "gsr-stats-panel.h"
+
+#include <glib/gi18n.h>
+
+#define SPARKLINE_WIDTH   120
+#define SPARKLINE_HEIGHT  20
+
+typedef struct {
+    GtkWidget *name_label;
+    GtkWidget *value_label;
+    GtkWidget *sparkline;
+    double     history[GSR_ENCODE_STATS_HISTORY];
+    guint      n_history;
+} StatRow;
+
+struct _GsrStatsPanel {
+    GtkBox   parent_instance;
+
+    GtkGrid *grid;
+    StatRow  rows[GSR_N_ENCODE_STATS];
+};
+
+G_DEFINE_FINAL_TYPE(GsrStatsPanel, gsr_stats_panel, GTK_TYPE_BOX)
+
+/* ── Formatting ──────────────────────────────────────────────────── */
+
+static char *
+format_bitrate(double bits_per_second)
+{
+    if (bits_per_second >= 1e6)
+        return g_strdup_printf(_("%.1f Mbps"), bits_per_second / 1e6);
+    return g_strdup_printf(_("%.0f kbps"), bits_per_second / 1e3);
+}
+
+static char *
+format_value(const GsrEncodeStats *stats, GsrEncodeStat stat)
+{
+    double value = gsr_encode_stats_latest(stats, stat);
+    switch (stat) {
+    case GSR_ENCODE_STAT_FPS:
+        return g_strdup_printf("%.0f", value);
+    case GSR_ENCODE_STAT_DROPPED:
+        /* Per second now, and the running total */
+        return g_strdup_printf(_("%.0f/s (%" G_GUINT64_FORMAT " total)"),
+                               value, stats->total_dropped);
+    case GSR_ENCODE_STAT_BITRATE:
+        return format_bitrate(value);
+    case GSR_ENCODE_STAT_FILE_SIZE:
+        return g_format_size((guint64)value);
+    default:
+        return g_strdup("");
+    }
+}
+
+/* ── Sparklines ──────────────────────────────────────────────────── */
+
+static void
+draw_sparkline(GtkDrawingArea *area, cairo_t *cr, int width, int height,
+               gpointer user_data)
+{
+    const StatRow *row = user_data;
+    if (row->n_history < 2)
+        return;
+
+    double max = 0.0;
+    for (guint i = 0; i < row->n_history; i++)
+        max = MAX(max, row->history[i]);
+    if (max <= 0.0)
+        max = 1.0;
+
+    /* Full history spans the width, so the line scrolls once it's full */
+    double step = (double)width / (GSR_ENCODE_STATS_HISTORY - 1);
+    double x0 = width - step * (row->n_history - 1);
+
+    GdkRGBA color;
+    gtk_widget_get_color(GTK_WIDGET(area), &color);
+    gdk_cairo_set_source_rgba(cr, &color);
+    cairo_set_line_width(cr, 1.0);
+    cairo_set_line_join(cr, CAIRO_LINE_JOIN_ROUND);
+
+    for (guint i = 0; i < row->n_history; i++) {
+        double x = x0 + step * i;
+        double y = height - 1.0 - (height - 2.0) * (row->history[i] / max);
+        if (i == 0)
+            cairo_move_to(cr, x, y);
+        else
+            cairo_line_to(cr, x, y);
+    }
+    cairo_stroke(cr);
+}
+
+/* ── Rows ────────────────────────────────────────────────────────── */
+
+static void
+add_row(GsrStatsPanel *self, GsrEncodeStat stat, const char *name)
+{
+    StatRow *row = &self->rows[stat];
+
+    row->name_label = gtk_label_new(name);
+    gtk_label_set_xalign(GTK_LABEL(row->name_label), 0.0f);
+    gtk_widget_add_css_class(row->name_label, "dim-label");
+
+    row->value_label = gtk_label_new(NULL);
+    gtk_label_set_xalign(GTK_LABEL(row->value_label), 1.0f);
+    gtk_widget_add_css_class(row->value_label, "numeric");
+
+    row->sparkline = gtk_drawing_area_new();
+    gtk_drawing_area_set_content_width(GTK_DRAWING_AREA(row->sparkline), SPARKLINE_WIDTH);
+    gtk_drawing_area_set_content_height(GTK_DRAWING_AREA(row->sparkline), SPARKLINE_HEIGHT);
+    gtk_drawing_area_set_draw_func(GTK_DRAWING_AREA(row->sparkline), draw_sparkline, row, NULL);
+    gtk_widget_add_css_class(row->sparkline, "accent");
+
+    gtk_grid_attach(self->grid, row->name_label, 0, (int)stat, 1, 1);
+    gtk_grid_attach(self->grid, row->value_label, 1, (int)stat, 1, 1);
+    gtk_grid_attach(self->grid, row->sparkline, 2, (int)stat, 1, 1);
+}
+
+static void
+set_row_visible(StatRow *row, gboolean visible)
+{
+    gtk_widget_set_visible(row->name_label, visible);
+    gtk_widget_set_visible(row->value_label, visible);
+    gtk_widget_set_visible(row->sparkline, visible);
+}
+
+/* ── GObject ─────────────────────────────────────────────────────── */
+
+static void
+gsr_stats_panel_init(GsrStatsPanel *self)
+{
+    (void)self;
+}
+
+static void
+gsr_stats_panel_class_init(GsrStatsPanelClass *klass)
+{
+    (void)klass;
+}
+
+/* ── Public API ──────────────────────────────────────────────────── */
+
+GsrStatsPanel *
+gsr_stats_panel_new(void)
+{
+    GsrStatsPanel *self = g_object_new(GSR_TYPE_STATS_PANEL,
+        "orientation", GTK_ORIENTATION_VERTICAL, NULL);
+
+    self->grid = GTK_GRID(gtk_grid_new());
+    gtk_grid_set_row_spacing(self->grid, 4);
+    gtk_grid_set_column_spacing(self->grid, 12);
+    gtk_widget_set_halign(GTK_WIDGET(self->grid), GTK_ALIGN_CENTER);
+    gtk_box_append(GTK_BOX(self), GTK_WIDGET(self->grid));
+
+    add_row(self, GSR_ENCODE_STAT_FPS, _("FPS"));
+    add_row(self, GSR_ENCODE_STAT_DROPPED, _("Dropped"));
+    add_row(self, GSR_ENCODE_STAT_BITRATE, _("Bitrate"));
+    add_row(self, GSR_ENCODE_STAT_FILE_SIZE, _("File size"));
+
+    gsr_stats_panel_clear(self);
+    return self;
+}
+
+void
+gsr_stats_panel_update(GsrStatsPanel *self, const GsrEncodeStats *stats)
+{
+    g_return_if_fail(GSR_IS_STATS_PANEL(self));
+
+    gboolean any = FALSE;
+    for (int i = 0; i < GSR_N_ENCODE_STATS; i++) {
+        StatRow *row = &self->rows[i];
+        gboolean has = gsr_encode_stats_has(stats, i);
+        set_row_visible(row, has);
+        if (!has)
+            continue;
+
+        g_autofree char *text = format_value(stats, i);
+        gtk_label_set_text(GTK_LABEL(row->value_label), text);
+        row->n_history = gsr_encode_stats_history(stats, i, row->history,
+                                                  GSR_ENCODE_STATS_HISTORY);
+        gtk_widget_queue_draw(row->sparkline);
+        any = TRUE;
+    }
+    gtk_widget_set_visible(GTK_WIDGET(self), any);
+}
+
+void
+gsr_stats_panel_clear(GsrStatsPanel *self)
+{
+    g_return_if_fail(GSR_IS_STATS_PANEL(self));
+
+    for (int i = 0; i < GSR_N_ENCODE_STATS; i++) {
+        set_row_visible(&self->rows[i], FALSE);
+        self->rows[i].n_history = 0;
+    }
+    gtk_widget_set_visible(GTK_WIDGET(self), FALSE);
+}
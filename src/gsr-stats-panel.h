@@ -0,0 +1,27 @@
+#pragma once
+
+#include <gtk/gtk.h>
+
+#include "gsr-encode-stats.h"
+
+G_BEGIN_DECLS
+
+/*
+ * GsrStatsPanel — compact live view of a GsrEncodeStats: one row per
+ * metric with its latest value and a sparkline of the recent history.
+ * Rows for metrics without samples are hidden.
+ */
+
+#define GSR_TYPE_STATS_PANEL (gsr_stats_panel_get_type())
+G_DECLARE_FINAL_TYPE(GsrStatsPanel, gsr_stats_panel, GSR, STATS_PANEL, GtkBox)
+
+GsrStatsPanel *gsr_stats_panel_new   (void);
+
+/* Show the current state of stats. */
+void           gsr_stats_panel_update(GsrStatsPanel        *self,
+                                      const GsrEncodeStats *stats);
+
+/* Hide every row, e.g. when the capture stops. */
+void           gsr_stats_panel_clear (GsrStatsPanel *self);
+
+G_END_DECLS
@@ -0,0 +1,272 @@
+#include "gsr-stream-health.h"
+
+#include <errno.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <linux/inet_diag.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <linux/sock_diag.h>
+#include <linux/tcp.h>
+
+const int gsr_stream_tier_percent[GSR_STREAM_N_TIERS] = { 100, 70, 50, 35 };
+
+/* Send queue relative to one second of video at the current bitrate */
+#define CONGESTED_QUEUE_PERCENT  50
+#define HEALTHY_QUEUE_PERCENT    10
+
+/* ── Controller ──────────────────────────────────────────────────── */
+
+void
+gsr_stream_health_reset(GsrStreamHealth *health)
+{
+    memset(health, 0, sizeof(*health));
+    health->up_after = GSR_STREAM_UP_AFTER;
+}
+
+gboolean
+gsr_stream_health_parse_line(GsrStreamHealth *health, const char *line)
+{
+    /* "Error: failed to write frame index 123 to muxer, reason: ..." */
+    if (!g_strstr_len(line, -1, "failed to write frame"))
+        return FALSE;
+    health->write_errors++;
+    return TRUE;
+}
+
+static void
+step_down(GsrStreamHealth *health, gint64 now_us)
+{
+    /* Back down soon after going up: that tier didn't hold, wait longer */
+    if (health->last_step_up_us > 0 &&
+        now_us - health->last_step_up_us < GSR_STREAM_FLAP_WINDOW_US)
+    {
+        health->up_after = MIN(health->up_after * 2, GSR_STREAM_UP_AFTER_MAX);
+    }
+    health->tier++;
+    health->congested_samples = 0;
+    health->healthy_samples = 0;
+}
+
+GsrStreamHealthAction
+gsr_stream_health_sample(GsrStreamHealth *health, gint64 send_queue_bytes,
+                         int bitrate_kbps, gint64 now_us)
+{
+    gint64 bytes_per_second = (gint64)bitrate_kbps * 1000 / 8;
+    gboolean errors = health->write_errors > 0;
+    health->write_errors = 0;
+
+    gboolean congested = errors ||
+        (send_queue_bytes >= 0 &&
+         send_queue_bytes * 100 > bytes_per_second * CONGESTED_QUEUE_PERCENT);
+    gboolean healthy = !errors && send_queue_bytes >= 0 &&
+        send_queue_bytes * 100 <= bytes_per_second * HEALTHY_QUEUE_PERCENT;
+
+    if (congested) {
+        /* A write error means frames are already being lost: don't wait */
+        health->healthy_samples = 0;
+        if ((errors || ++health->congested_samples >= GSR_STREAM_DOWN_AFTER) &&
+            health->tier + 1 < GSR_STREAM_N_TIERS)
+        {
+            step_down(health, now_us);
+            return GSR_STREAM_HEALTH_STEP_DOWN;
+        }
+    } else if (healthy) {
+        health->congested_samples = 0;
+        if (++health->healthy_samples >= health->up_after && health->tier > 0) {
+            health->tier--;
+            health->healthy_samples = 0;
+            health->last_step_up_us = now_us;
+            return GSR_STREAM_HEALTH_STEP_UP;
+        }
+    } else {
+        /* In between: neither counts towards a change */
+        health->congested_samples = 0;
+        health->healthy_samples = 0;
+    }
+    return GSR_STREAM_HEALTH_KEEP;
+}
+
+gboolean
+gsr_stream_health_on_failure(GsrStreamHealth *health)
+{
+    if (health->tier + 1 >= GSR_STREAM_N_TIERS)
+        return FALSE;
+    step_down(health, g_get_monotonic_time());
+    return TRUE;
+}
+
+int
+gsr_stream_health_bitrate(const GsrStreamHealth *health, int base_kbps)
+{
+    return base_kbps * gsr_stream_tier_percent[health->tier] / 100;
+}
+
+/* ── Send queue ──────────────────────────────────────────────────── */
+
+/* Inodes of the sockets pid has open */
+static GHashTable *
+read_socket_inodes(const char *proc_root, pid_t pid)
+{
+    g_autofree char *fd_dir = g_strdup_printf("%s/%d/fd", proc_root, (int)pid);
+    GDir *dir = g_dir_open(fd_dir, 0, NULL);
+    if (!dir)
+        return NULL;
+
+    GHashTable *inodes = g_hash_table_new_full(g_int64_hash, g_int64_equal, g_free, NULL);
+    const char *name;
+    while ((name = g_dir_read_name(dir))) {
+        g_autofree char *link_path = g_build_filename(fd_dir, name, NULL);
+        g_autofree char *target = g_file_read_link(link_path, NULL);
+        guint64 inode;
+        if (target && sscanf(target, "socket:[%" G_GUINT64_FORMAT "]", &inode) == 1)
+            g_hash_table_add(inodes, g_memdup2(&inode, sizeof(inode)));
+    }
+    g_dir_close(dir);
+    return inodes;
+}
+
+/*
+ * /proc/<pid>/net/{tcp,udp}[6]: "sl local rem st tx_queue:rx_queue tr:when
+ * retrnsmt uid timeout inode ...", queues in hex.
+ */
+static gboolean
+add_send_queue(const char *table_path, GHashTable *inodes, gint64 *total)
+{
+    g_autofree char *contents = NULL;
+    if (!g_file_get_contents(table_path, &contents, NULL, NULL))
+        return FALSE;
+
+    gboolean found = FALSE;
+    g_auto(GStrv) lines = g_strsplit(contents, "\n", -1);
+    for (int i = 1; lines[i]; i++) {
+        unsigned long tx_queue;
+        guint64 inode;
+        if (sscanf(lines[i], "%*s %*s %*s %*s %lx:%*x %*s %*s %*s %*s %" G_GUINT64_FORMAT,
+                   &tx_queue, &inode) != 2)
+            continue;
+        if (g_hash_table_contains(inodes, &inode)) {
+            *total += (gint64)tx_queue;
+            found = TRUE;
+        }
+    }
+    return found;
+}
+
+/*
+ * tx_queue counts what was sent but not acknowledged yet too, which at a
+ * high RTT is a lot even on a healthy link.  sock_diag gives TCP sockets'
+ * tcpi_notsent_bytes, the part still waiting to go out.  Returns FALSE
+ * if the kernel doesn't answer (or is older than 4.6, with no such count).
+ */
+static gboolean
+add_tcp_notsent(int family, GHashTable *inodes, gint64 *total, gboolean *found)
+{
+    int fd = socket(AF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC, NETLINK_SOCK_DIAG);
+    if (fd < 0)
+        return FALSE;
+
+    struct {
+        struct nlmsghdr         nlh;
+        struct inet_diag_req_v2 req;
+    } request = {
+        .nlh = {
+            .nlmsg_len = sizeof(request),
+            .nlmsg_type = SOCK_DIAG_BY_FAMILY,
+            .nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP,
+        },
+        .req = {
+            .sdiag_family = (__u8)family,
+            .sdiag_protocol = IPPROTO_TCP,
+            .idiag_ext = 1 << (INET_DIAG_INFO - 1),
+            .idiag_states = ~0U,
+        },
+    };
+    if (send(fd, &request, sizeof(request), 0) < 0) {
+        close(fd);
+        return FALSE;
+    }
+
+    gboolean done = FALSE, failed = FALSE;
+    long buf[8192 / sizeof(long)];
+    while (!done && !failed) {
+        ssize_t n = recv(fd, buf, sizeof(buf), 0);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            break;
+
+        int len = (int)n;
+        for (struct nlmsghdr *h = (struct nlmsghdr *)buf; NLMSG_OK(h, len); h = NLMSG_NEXT(h, len)) {
+            if (h->nlmsg_type == NLMSG_DONE) {
+                done = TRUE;
+                break;
+            }
+            if (h->nlmsg_type == NLMSG_ERROR) {
+                failed = TRUE;
+                break;
+            }
+
+            const struct inet_diag_msg *msg = NLMSG_DATA(h);
+            guint64 inode = msg->idiag_inode;
+            if (!g_hash_table_contains(inodes, &inode))
+                continue;
+
+            int attr_len = (int)(h->nlmsg_len - NLMSG_LENGTH(sizeof(*msg)));
+            for (struct rtattr *attr = (struct rtattr *)(msg + 1); RTA_OK(attr, attr_len);
+                 attr = RTA_NEXT(attr, attr_len))
+            {
+                if (attr->rta_type != INET_DIAG_INFO ||
+                    RTA_PAYLOAD(attr) < offsetof(struct tcp_info, tcpi_notsent_bytes) +
+                                        sizeof(__u32))
+                    continue;
+                const struct tcp_info *info = RTA_DATA(attr);
+                *total += info->tcpi_notsent_bytes;
+                *found = TRUE;
+            }
+        }
+    }
+    close(fd);
+    return done;
+}
+
+/* proc_root is "/proc" outside of tests; sock_diag only goes with that */
+static gint64
+read_send_queue(const char *proc_root, pid_t pid)
+{
+    GHashTable *inodes = read_socket_inodes(proc_root, pid);
+    if (!inodes)
+        return -1;
+
+    /* TCP from sock_diag if it answers for both families, else from the
+       tx_queue in /proc after all */
+    gint64 total = 0, tcp_total = 0;
+    gboolean found = FALSE, tcp_found = FALSE;
+    gboolean use_diag = g_str_equal(proc_root, "/proc") &&
+        add_tcp_notsent(AF_INET, inodes, &tcp_total, &tcp_found) &&
+        add_tcp_notsent(AF_INET6, inodes, &tcp_total, &tcp_found);
+    if (use_diag) {
+        total = tcp_total;
+        found = tcp_found;
+    }
+
+    static const char *const tables[] = { "tcp", "tcp6", "udp", "udp6" };
+    for (gsize i = use_diag ? 2 : 0; i < G_N_ELEMENTS(tables) && g_hash_table_size(inodes) > 0; i++) {
+        g_autofree char *path = g_strdup_printf("%s/%d/net/%s", proc_root, (int)pid, tables[i]);
+        found |= add_send_queue(path, inodes, &total);
+    }
+
+    g_hash_table_destroy(inodes);
+    return found ? total : -1;
+}
+
+gint64
+gsr_stream_health_read_send_queue(pid_t pid)
+{
+    return read_send_queue("/proc", pid);
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+/*
+ * gsr-stream-health.h — Adaptive bitrate for streaming.
+ *
+ * Once a second the window feeds the controller the stream socket's send
+ * queue (bytes written by the recorder but not sent yet; bytes in flight
+ * don't count, or a high RTT would look like congestion) and any write
+ * errors the recorder printed.  A queue holding
+ * more than half a second of video for GSR_STREAM_DOWN_AFTER samples in
+ * a row, or any write error, steps down one bitrate tier; an empty queue
+ * for up_after samples steps back up.  Stepping down again soon after a
+ * step up doubles up_after, so a link at the edge of a tier doesn't
+ * flap between the two.  Each change restarts the recorder at the new
+ * bitrate.
+ */
+
+#include <glib.h>
+#include <sys/types.h>
+
+#define GSR_STREAM_N_TIERS         4
+#define GSR_STREAM_DOWN_AFTER      3     /* congested samples */
+#define GSR_STREAM_UP_AFTER        30    /* healthy samples, doubled on flapping */
+#define GSR_STREAM_UP_AFTER_MAX    480
+#define GSR_STREAM_FLAP_WINDOW_US  (120 * G_USEC_PER_SEC)
+
+/* Share of the configured bitrate per tier, full first */
+extern const int gsr_stream_tier_percent[GSR_STREAM_N_TIERS];
+
+typedef enum {
+    GSR_STREAM_HEALTH_KEEP,
+    GSR_STREAM_HEALTH_STEP_DOWN,
+    GSR_STREAM_HEALTH_STEP_UP,
+} GsrStreamHealthAction;
+
+typedef struct {
+    int    tier;               /* index into gsr_stream_tier_percent */
+    int    congested_samples;
+    int    healthy_samples;
+    int    up_after;
+    int    write_errors;       /* since the last sample */
+    gint64 last_step_up_us;    /* 0 if none */
+} GsrStreamHealth;
+
+/**
+ * Start at full bitrate with the default hysteresis.
+ */
+void                  gsr_stream_health_reset     (GsrStreamHealth *health);
+
+/**
+ * Count write failures in one line of recorder output.  Returns TRUE if
+ * the line was one.
+ */
+gboolean              gsr_stream_health_parse_line(GsrStreamHealth *health,
+                                                   const char      *line);
+
+/**
+ * Feed one sample: send_queue_bytes from gsr_stream_health_read_send_queue()
+ * (-1 if unknown) while streaming at bitrate_kbps.  Moves to the tier the
+ * returned action names; the caller restarts the recorder unless it's
+ * GSR_STREAM_HEALTH_KEEP.
+ */
+GsrStreamHealthAction gsr_stream_health_sample    (GsrStreamHealth *health,
+                                                   gint64           send_queue_bytes,
+                                                   int              bitrate_kbps,
+                                                   gint64           now_us);
+
+/**
+ * The recorder died while streaming.  Steps down and returns TRUE if
+ * there is a lower tier to retry at.
+ */
+gboolean              gsr_stream_health_on_failure(GsrStreamHealth *health);
+
+/**
+ * base_kbps scaled to the current tier.
+ */
+int                   gsr_stream_health_bitrate   (const GsrStreamHealth *health,
+                                                   int                    base_kbps);
+
+/**
+ * Bytes queued for sending on the TCP and UDP sockets of process pid.
+ * Sockets come from /proc/<pid>/fd; TCP queues from sock_diag's
+ * tcpi_notsent_bytes, or failing that (and for UDP) /proc/<pid>/net,
+ * whose tx_queue includes unacknowledged bytes.  -1 if it has no sockets
+ * or /proc can't be read.
+ */
+gint64                gsr_stream_health_read_send_queue(pid_t pid);
@@ -3,6 +3,8 @@
 #include <time.h>
 #include <glib/gi18n.h>
 
+#include "gsr-ingest-probe.h"
+#include "gsr-stats-panel.h"
 #include "gsr-window.h"
 
 #ifdef HAVE_X11
@@ -12,7 +14,7 @@
 /* ═══════════════════════════════════════════════════════════════════
  *  GsrStreamPage — "Stream" tab
  *
- *  Groups: Service · Action · Status
+ *  Groups: Service · Simulcast · Action · Status
  * ═══════════════════════════════════════════════════════════════════ */
 
 typedef enum {
@@ -21,6 +23,19 @@ typedef enum {
     STREAM_SERVICE_CUSTOM,
 } StreamService;
 
+#define RTMP_DEFAULT_PORT 1935
+
+/* Used when the config lists no ingest servers of its own */
+static const char *const default_twitch_ingest_hosts[] = {
+    "live.twitch.tv",
+    "ingest.global-contribute.live-video.net",
+    NULL
+};
+static const char *const default_youtube_ingest_hosts[] = {
+    "a.rtmp.youtube.com",
+    NULL
+};
+
 struct _GsrStreamPage {
     AdwPreferencesPage parent_instance;
 
@@ -38,6 +53,7 @@ struct _GsrStreamPage {
     AdwActionRow        *x11_start_stop_row;
     GtkShortcutLabel    *x11_start_stop_label;
     char                *x11_start_stop_accel;       /* owned */
+    gboolean             x11_start_stop_on_press;
 #endif
 
     /* ── Service group ─── */
@@ -47,6 +63,15 @@ struct _GsrStreamPage {
     AdwPasswordEntryRow *youtube_key_row;
     AdwPasswordEntryRow *custom_url_row;
     AdwComboRow         *container_row;
+    GsrIngestProbe      *ingest_probe;
+    char               **twitch_ingest_hosts;   /* owned, NULL for defaults */
+    char               **youtube_ingest_hosts;  /* owned, NULL for defaults */
+    AdwSwitchRow        *adaptive_bitrate_row;
+    AdwSwitchRow        *save_locally_row;
+
+    /* ── Simulcast group ─── */
+    AdwPreferencesGroup *simulcast_group;
+    GPtrArray           *simulcast_rows;   /* AdwPasswordEntryRow*, borrowed */
 
     /* ── Action group ─── */
     AdwPreferencesGroup *action_group;
@@ -57,6 +82,8 @@ struct _GsrStreamPage {
     GtkBox              *status_box;
     GtkImage            *record_icon;
     GtkLabel            *timer_label;
+    GsrStatsPanel       *stats_panel;
+    GtkLabel            *relay_label;      /* per-destination simulcast status */
 
     gboolean             is_active;
     double               start_time;
@@ -124,6 +151,79 @@ on_timer_tick(gpointer user_data)
     return G_SOURCE_CONTINUE;
 }
 
+/* ── Ingest servers ──────────────────────────────────────────────── */
+
+static const char *
+service_id(StreamService svc)
+{
+    return svc == STREAM_SERVICE_YOUTUBE ? "youtube" : "twitch";
+}
+
+static const char *const *
+get_ingest_hosts(GsrStreamPage *self, StreamService svc)
+{
+    if (svc == STREAM_SERVICE_YOUTUBE)
+        return self->youtube_ingest_hosts
+            ? (const char *const *)self->youtube_ingest_hosts : default_youtube_ingest_hosts;
+    return self->twitch_ingest_hosts
+        ? (const char *const *)self->twitch_ingest_hosts : default_twitch_ingest_hosts;
+}
+
+/* The fastest host if it was probed recently, the first one otherwise */
+static const char *
+get_ingest_host(GsrStreamPage *self, StreamService svc, gint64 *rtt_us)
+{
+    const char *const *hosts = get_ingest_hosts(self, svc);
+    const char *best = gsr_ingest_probe_get_best(self->ingest_probe,
+        service_id(svc), hosts, rtt_us);
+    if (best)
+        return best;
+    if (rtt_us)
+        *rtt_us = -1;
+    return hosts[0];
+}
+
+static void
+update_ingest_subtitle(GsrStreamPage *self)
+{
+    StreamService svc = get_selected_service(self);
+    if (svc == STREAM_SERVICE_CUSTOM) {
+        adw_action_row_set_subtitle(ADW_ACTION_ROW(self->service_row), "");
+        return;
+    }
+
+    gint64 rtt_us;
+    const char *host = get_ingest_host(self, svc, &rtt_us);
+    g_autofree char *text = rtt_us >= 0
+        ? g_strdup_printf(_("Server: %s (%" G_GINT64_FORMAT " ms)"), host, rtt_us / 1000)
+        : g_strdup_printf(_("Server: %s"), host);
+    adw_action_row_set_subtitle(ADW_ACTION_ROW(self->service_row), text);
+}
+
+static void
+on_ingest_probed(const char *service G_GNUC_UNUSED, const char *best_host G_GNUC_UNUSED,
+                 gint64 rtt_us G_GNUC_UNUSED, gpointer user_data)
+{
+    update_ingest_subtitle(GSR_STREAM_PAGE(user_data));
+}
+
+/* Probe the selected service's servers unless the last result is fresh */
+static void
+refresh_ingest(GsrStreamPage *self)
+{
+    StreamService svc = get_selected_service(self);
+    if (svc != STREAM_SERVICE_CUSTOM) {
+        const char *const *hosts = get_ingest_hosts(self, svc);
+        if (hosts[1] && !gsr_ingest_probe_get_best(self->ingest_probe,
+                                                    service_id(svc), hosts, NULL))
+        {
+            gsr_ingest_probe_run(self->ingest_probe, service_id(svc), hosts,
+                                 RTMP_DEFAULT_PORT, on_ingest_probed, self);
+        }
+    }
+    update_ingest_subtitle(self);
+}
+
 /* ── Callbacks ───────────────────────────────────────────────────── */
 
 static void
@@ -132,6 +232,7 @@ on_service_changed(GObject    *obj G_GNUC_UNUSED,
                    gpointer    user_data)
 {
     update_service_visibility(GSR_STREAM_PAGE(user_data));
+    refresh_ingest(GSR_STREAM_PAGE(user_data));
 }
 
 static void
@@ -190,6 +291,7 @@ on_x11_start_stop_shortcut_set(GsrShortcutAccelDialog *dialog,
     const char *accel = gsr_shortcut_accel_dialog_get_accelerator(dialog);
 
     g_set_str(&self->x11_start_stop_accel, accel);
+    self->x11_start_stop_on_press = gsr_shortcut_accel_dialog_get_trigger_on_press(dialog);
 
     if (self->x11_start_stop_label)
         gtk_shortcut_label_set_accelerator(self->x11_start_stop_label,
@@ -209,6 +311,7 @@ on_x11_start_stop_activated(AdwActionRow *row G_GNUC_UNUSED,
     GsrStreamPage *self = GSR_STREAM_PAGE(user_data);
     GsrShortcutAccelDialog *dialog = gsr_shortcut_accel_dialog_new(
         _("Start/Stop streaming"), self->x11_start_stop_accel);
+    gsr_shortcut_accel_dialog_set_trigger_on_press(dialog, self->x11_start_stop_on_press);
     g_signal_connect(dialog, "shortcut-set",
         G_CALLBACK(on_x11_start_stop_shortcut_set), self);
     adw_dialog_present(ADW_DIALOG(dialog), GTK_WIDGET(self));
@@ -366,9 +469,84 @@ build_service_group(GsrStreamPage *self)
     adw_preferences_group_add(self->service_group,
         GTK_WIDGET(self->container_row));
 
+    /* Adaptive bitrate (needs a constant bitrate to scale) */
+    self->adaptive_bitrate_row = ADW_SWITCH_ROW(adw_switch_row_new());
+    adw_preferences_row_set_title(ADW_PREFERENCES_ROW(self->adaptive_bitrate_row),
+        _("Adaptive bitrate"));
+    adw_action_row_set_subtitle(ADW_ACTION_ROW(self->adaptive_bitrate_row),
+        _("Lower the bitrate while the connection can't keep up. Requires a custom video quality"));
+    adw_switch_row_set_active(self->adaptive_bitrate_row, FALSE);
+    adw_preferences_group_add(self->service_group,
+        GTK_WIDGET(self->adaptive_bitrate_row));
+
+    /* Local copy from the same encode */
+    self->save_locally_row = ADW_SWITCH_ROW(adw_switch_row_new());
+    adw_preferences_row_set_title(ADW_PREFERENCES_ROW(self->save_locally_row),
+        _("Also save locally"));
+    adw_action_row_set_subtitle(ADW_ACTION_ROW(self->save_locally_row),
+        _("Write the stream to the Record tab's directory as well. Needs ffmpeg"));
+    adw_switch_row_set_active(self->save_locally_row, FALSE);
+    adw_preferences_group_add(self->service_group,
+        GTK_WIDGET(self->save_locally_row));
+
     adw_preferences_page_add(ADW_PREFERENCES_PAGE(self), self->service_group);
 }
 
+static void
+on_remove_simulcast_clicked(GtkButton *btn, gpointer user_data)
+{
+    GsrStreamPage *self = GSR_STREAM_PAGE(user_data);
+    GtkWidget *row = g_object_get_data(G_OBJECT(btn), "simulcast-row");
+    g_ptr_array_remove(self->simulcast_rows, row);
+    adw_preferences_group_remove(self->simulcast_group, row);
+}
+
+static void
+add_simulcast_row(GsrStreamPage *self, const char *url)
+{
+    /* Password rows: the URL usually carries a stream key */
+    AdwPasswordEntryRow *row = ADW_PASSWORD_ENTRY_ROW(adw_password_entry_row_new());
+    adw_preferences_row_set_title(ADW_PREFERENCES_ROW(row), _("URL"));
+    gtk_editable_set_text(GTK_EDITABLE(row), url ? url : "");
+
+    GtkButton *rm = GTK_BUTTON(gtk_button_new_from_icon_name("window-close-symbolic"));
+    gtk_widget_add_css_class(GTK_WIDGET(rm), "flat");
+    gtk_widget_add_css_class(GTK_WIDGET(rm), "circular");
+    gtk_widget_set_valign(GTK_WIDGET(rm), GTK_ALIGN_CENTER);
+    gtk_widget_set_tooltip_text(GTK_WIDGET(rm), _("Remove destination"));
+    g_object_set_data(G_OBJECT(rm), "simulcast-row", row);
+    g_signal_connect(rm, "clicked", G_CALLBACK(on_remove_simulcast_clicked), self);
+    adw_entry_row_add_suffix(ADW_ENTRY_ROW(row), GTK_WIDGET(rm));
+
+    g_ptr_array_add(self->simulcast_rows, row);
+    adw_preferences_group_add(self->simulcast_group, GTK_WIDGET(row));
+}
+
+static void
+on_add_simulcast_clicked(GtkButton *btn G_GNUC_UNUSED, gpointer user_data)
+{
+    GsrStreamPage *self = GSR_STREAM_PAGE(user_data);
+    add_simulcast_row(self, NULL);
+}
+
+static void
+build_simulcast_group(GsrStreamPage *self)
+{
+    self->simulcast_group = ADW_PREFERENCES_GROUP(adw_preferences_group_new());
+    adw_preferences_group_set_title(self->simulcast_group, _("Simulcast"));
+    adw_preferences_group_set_description(self->simulcast_group,
+        _("Also stream to these URLs from the same encode. Needs ffmpeg"));
+
+    GtkButton *add = GTK_BUTTON(gtk_button_new_from_icon_name("list-add-symbolic"));
+    gtk_widget_add_css_class(GTK_WIDGET(add), "flat");
+    gtk_widget_set_valign(GTK_WIDGET(add), GTK_ALIGN_CENTER);
+    gtk_widget_set_tooltip_text(GTK_WIDGET(add), _("Add destination"));
+    g_signal_connect(add, "clicked", G_CALLBACK(on_add_simulcast_clicked), self);
+    adw_preferences_group_set_header_suffix(self->simulcast_group, GTK_WIDGET(add));
+
+    adw_preferences_page_add(ADW_PREFERENCES_PAGE(self), self->simulcast_group);
+}
+
 static void
 build_action_group(GsrStreamPage *self)
 {
@@ -408,6 +586,17 @@ build_status_group(GsrStreamPage *self)
     gtk_box_append(self->status_box, GTK_WIDGET(self->timer_label));
 
     adw_preferences_group_add(self->status_group, GTK_WIDGET(self->status_box));
+
+    self->stats_panel = gsr_stats_panel_new();
+    gtk_widget_set_margin_top(GTK_WIDGET(self->stats_panel), 12);
+    adw_preferences_group_add(self->status_group, GTK_WIDGET(self->stats_panel));
+
+    self->relay_label = GTK_LABEL(gtk_label_new(NULL));
+    gtk_label_set_justify(self->relay_label, GTK_JUSTIFY_CENTER);
+    gtk_widget_add_css_class(GTK_WIDGET(self->relay_label), "dim-label");
+    gtk_widget_set_margin_top(GTK_WIDGET(self->relay_label), 12);
+    gtk_widget_set_visible(GTK_WIDGET(self->relay_label), FALSE);
+    adw_preferences_group_add(self->status_group, GTK_WIDGET(self->relay_label));
     adw_preferences_page_add(ADW_PREFERENCES_PAGE(self), self->status_group);
 }
 
@@ -419,6 +608,10 @@ gsr_stream_page_finalize(GObject *object)
     GsrStreamPage *self = GSR_STREAM_PAGE(object);
 
     g_clear_handle_id(&self->timer_source_id, g_source_remove);
+    g_clear_pointer(&self->simulcast_rows, g_ptr_array_unref);
+    g_clear_pointer(&self->ingest_probe, gsr_ingest_probe_free);
+    g_strfreev(self->twitch_ingest_hosts);
+    g_strfreev(self->youtube_ingest_hosts);
 
 #ifdef HAVE_X11
     g_free(self->x11_start_stop_accel);
@@ -429,7 +622,7 @@ gsr_stream_page_finalize(GObject *object)
 static void
 gsr_stream_page_init(GsrStreamPage *self)
 {
-    (void)self;
+    self->simulcast_rows = g_ptr_array_new();
 }
 
 static void
@@ -447,12 +640,17 @@ gsr_stream_page_new(const GsrInfo *info)
     GsrStreamPage *self = g_object_new(GSR_TYPE_STREAM_PAGE, NULL);
     self->info = info;
 
+    g_autofree char *ingest_cache = g_build_filename(g_get_user_cache_dir(),
+        "gpu-screen-recorder", "ingest-servers", NULL);
+    self->ingest_probe = gsr_ingest_probe_new(ingest_cache);
+
     adw_preferences_page_set_title(ADW_PREFERENCES_PAGE(self), _("Stream"));
     adw_preferences_page_set_icon_name(ADW_PREFERENCES_PAGE(self),
         "network-transmit-symbolic");
 
     build_hotkey_group(self);
     build_service_group(self);
+    build_simulcast_group(self);
     build_action_group(self);
     build_status_group(self);
 
@@ -553,13 +751,32 @@ gsr_stream_page_apply_config(GsrStreamPage *self, const GsrConfig *config)
     combo_row_select_string(self->container_row,
         stream_container_id_to_display(s->custom_container));
 
+    g_strfreev(self->twitch_ingest_hosts);
+    self->twitch_ingest_hosts = s->n_twitch_ingest_host > 0
+        ? g_strdupv(s->twitch_ingest_host) : NULL;
+    g_strfreev(self->youtube_ingest_hosts);
+    self->youtube_ingest_hosts = s->n_youtube_ingest_host > 0
+        ? g_strdupv(s->youtube_ingest_host) : NULL;
+
+    adw_switch_row_set_active(self->adaptive_bitrate_row, s->adaptive_bitrate);
+    adw_switch_row_set_active(self->save_locally_row, s->save_locally);
+
+    while (self->simulcast_rows->len > 0) {
+        GtkWidget *row = g_ptr_array_steal_index(self->simulcast_rows, 0);
+        adw_preferences_group_remove(self->simulcast_group, row);
+    }
+    for (int i = 0; i < s->n_simulcast_url; i++)
+        add_simulcast_row(self, s->simulcast_url[i]);
+
     update_service_visibility(self);
+    refresh_ingest(self);
 
     /* Hotkeys (X11 only) */
 #ifdef HAVE_X11
     if (self->x11_start_stop_label) {
         g_free(self->x11_start_stop_accel);
         self->x11_start_stop_accel = gsr_config_hotkey_to_accel(&s->start_stop_hotkey);
+        self->x11_start_stop_on_press = s->start_stop_hotkey.trigger == GSR_HOTKEY_TRIGGER_PRESS;
         gtk_shortcut_label_set_accelerator(self->x11_start_stop_label,
             self->x11_start_stop_accel ? self->x11_start_stop_accel : "");
     }
@@ -583,9 +800,27 @@ gsr_stream_page_read_config(GsrStreamPage *self, GsrConfig *config)
     g_set_str(&s->custom_container, stream_container_display_to_id(
         combo_row_get_selected_string(self->container_row)));
 
+    s->adaptive_bitrate = adw_switch_row_get_active(self->adaptive_bitrate_row);
+    s->save_locally = adw_switch_row_get_active(self->save_locally_row);
+
+    if (s->simulcast_url) {
+        for (int i = 0; i < s->n_simulcast_url; i++)
+            g_free(s->simulcast_url[i]);
+        g_clear_pointer(&s->simulcast_url, g_free);
+    }
+    s->simulcast_url = g_new0(char *, self->simulcast_rows->len + 1);
+    s->n_simulcast_url = 0;
+    for (guint i = 0; i < self->simulcast_rows->len; i++) {
+        const char *url = gtk_editable_get_text(GTK_EDITABLE(g_ptr_array_index(self->simulcast_rows, i)));
+        if (url && url[0])
+            s->simulcast_url[s->n_simulcast_url++] = g_strdup(url);
+    }
+
     /* Hotkeys */
 #ifdef HAVE_X11
     gsr_config_hotkey_from_accel(&s->start_stop_hotkey, self->x11_start_stop_accel);
+    s->start_stop_hotkey.trigger = self->x11_start_stop_on_press
+        ? GSR_HOTKEY_TRIGGER_PRESS : GSR_HOTKEY_TRIGGER_RELEASE;
 #endif
 }
 
@@ -607,10 +842,15 @@ gsr_stream_page_set_active(GsrStreamPage *self, gboolean active)
         gtk_widget_set_opacity(GTK_WIDGET(self->status_box), 0.5);
         gtk_widget_remove_css_class(GTK_WIDGET(self->record_icon), "recording-active");
         gtk_label_set_text(self->timer_label, "00:00:00");
+        gsr_stats_panel_clear(self->stats_panel);
+        gtk_widget_set_visible(GTK_WIDGET(self->relay_label), FALSE);
 
         /* Reset internal state (handles external stop via handle_child_death) */
         self->is_active = FALSE;
         g_clear_handle_id(&self->timer_source_id, g_source_remove);
+
+        /* Have a current server ready for the next stream */
+        refresh_ingest(self);
     }
 }
 
@@ -620,6 +860,62 @@ gsr_stream_page_update_timer(GsrStreamPage *self, const char *text)
     gtk_label_set_text(self->timer_label, text);
 }
 
+void
+gsr_stream_page_update_stats(GsrStreamPage *self, const GsrEncodeStats *stats)
+{
+    g_return_if_fail(GSR_IS_STREAM_PAGE(self));
+    gsr_stats_panel_update(self->stats_panel, stats);
+}
+
+void
+gsr_stream_page_update_relay(GsrStreamPage *self, GsrStreamRelay *relay)
+{
+    g_return_if_fail(GSR_IS_STREAM_PAGE(self));
+
+    GString *text = g_string_new(NULL);
+    guint n = gsr_stream_relay_get_n_destinations(relay);
+    for (guint i = 0; i < n; i++) {
+        GsrRelayDestInfo info;
+        gsr_stream_relay_get_destination(relay, i, &info);
+
+        const char *state = info.state == GSR_RELAY_DEST_LIVE     ? _("live")
+                          : info.state == GSR_RELAY_DEST_STARTING ? _("connecting")
+                          : info.state == GSR_RELAY_DEST_FAILED   ? _("write failed")
+                          :                                         _("reconnecting");
+        g_autofree char *sent = g_format_size(info.bytes_sent);
+        if (text->len > 0)
+            g_string_append_c(text, '\n');
+        g_string_append_printf(text, _("%s: %s, %s sent"), info.name, state, sent);
+        if (info.bytes_dropped > 0) {
+            g_autofree char *dropped = g_format_size(info.bytes_dropped);
+            g_string_append_printf(text, _(", %s dropped"), dropped);
+        }
+        if (info.n_restarts > 0)
+            g_string_append_printf(text, _(", %u reconnects"), info.n_restarts);
+    }
+    gtk_label_set_text(self->relay_label, text->str);
+    gtk_widget_set_visible(GTK_WIDGET(self->relay_label), n > 0);
+    g_string_free(text, TRUE);
+}
+
+/* If no recognized scheme prefix, prepend rtmp:// */
+static char *
+normalize_stream_url(const char *url)
+{
+    if (!url || !url[0])
+        return g_strdup("");
+    if (g_str_has_prefix(url, "rtmp://")  ||
+        g_str_has_prefix(url, "rtmps://") ||
+        g_str_has_prefix(url, "rtsp://")  ||
+        g_str_has_prefix(url, "srt://")   ||
+        g_str_has_prefix(url, "http://")  ||
+        g_str_has_prefix(url, "https://") ||
+        g_str_has_prefix(url, "tcp://")   ||
+        g_str_has_prefix(url, "udp://"))
+        return g_strdup(url);
+    return g_strdup_printf("rtmp://%s", url);
+}
+
 char *
 gsr_stream_page_get_stream_url(GsrStreamPage *self)
 {
@@ -628,32 +924,38 @@ gsr_stream_page_get_stream_url(GsrStreamPage *self)
     switch (svc) {
     case STREAM_SERVICE_TWITCH: {
         const char *key = gtk_editable_get_text(GTK_EDITABLE(self->twitch_key_row));
-        return g_strdup_printf("rtmp://live.twitch.tv/app/%s", key ? key : "");
+        return g_strdup_printf("rtmp://%s/app/%s",
+            get_ingest_host(self, svc, NULL), key ? key : "");
     }
     case STREAM_SERVICE_YOUTUBE: {
         const char *key = gtk_editable_get_text(GTK_EDITABLE(self->youtube_key_row));
-        return g_strdup_printf("rtmp://a.rtmp.youtube.com/live2/%s", key ? key : "");
-    }
-    case STREAM_SERVICE_CUSTOM: {
-        const char *url = gtk_editable_get_text(GTK_EDITABLE(self->custom_url_row));
-        if (!url || !url[0])
-            return g_strdup("");
-        /* If no recognized scheme prefix, prepend rtmp:// */
-        if (g_str_has_prefix(url, "rtmp://")  ||
-            g_str_has_prefix(url, "rtmps://") ||
-            g_str_has_prefix(url, "rtsp://")  ||
-            g_str_has_prefix(url, "srt://")   ||
-            g_str_has_prefix(url, "http://")  ||
-            g_str_has_prefix(url, "https://") ||
-            g_str_has_prefix(url, "tcp://")   ||
-            g_str_has_prefix(url, "udp://"))
-            return g_strdup(url);
-        return g_strdup_printf("rtmp://%s", url);
+        return g_strdup_printf("rtmp://%s/live2/%s",
+            get_ingest_host(self, svc, NULL), key ? key : "");
     }
+    case STREAM_SERVICE_CUSTOM:
+        return normalize_stream_url(
+            gtk_editable_get_text(GTK_EDITABLE(self->custom_url_row)));
     }
     return g_strdup("");
 }
 
+char **
+gsr_stream_page_get_simulcast_urls(GsrStreamPage *self)
+{
+    g_return_val_if_fail(GSR_IS_STREAM_PAGE(self), NULL);
+
+    GStrvBuilder *builder = g_strv_builder_new();
+    for (guint i = 0; i < self->simulcast_rows->len; i++) {
+        g_autofree char *url = normalize_stream_url(
+            gtk_editable_get_text(GTK_EDITABLE(g_ptr_array_index(self->simulcast_rows, i))));
+        if (url[0])
+            g_strv_builder_add(builder, url);
+    }
+    char **urls = g_strv_builder_end(builder);
+    g_strv_builder_unref(builder);
+    return urls;
+}
+
 char *
 gsr_stream_page_get_container(GsrStreamPage *self)
 {
@@ -664,6 +966,20 @@ gsr_stream_page_get_container(GsrStreamPage *self)
         combo_row_get_selected_string(self->container_row)));
 }
 
+gboolean
+gsr_stream_page_get_adaptive_bitrate(GsrStreamPage *self)
+{
+    g_return_val_if_fail(GSR_IS_STREAM_PAGE(self), FALSE);
+    return adw_switch_row_get_active(self->adaptive_bitrate_row);
+}
+
+gboolean
+gsr_stream_page_get_save_locally(GsrStreamPage *self)
+{
+    g_return_val_if_fail(GSR_IS_STREAM_PAGE(self), FALSE);
+    return adw_switch_row_get_active(self->save_locally_row);
+}
+
 void
 gsr_stream_page_activate_start_stop(GsrStreamPage *self)
 {
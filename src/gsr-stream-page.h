@@ -3,7 +3,9 @@
 #include <adwaita.h>
 
 #include "gsr-config.h"
+#include "gsr-encode-stats.h"
 #include "gsr-info.h"
+#include "gsr-stream-relay.h"
 
 G_BEGIN_DECLS
 
@@ -21,13 +23,26 @@ void           gsr_stream_page_set_active    (GsrStreamPage *self,
                                               gboolean       active);
 void           gsr_stream_page_update_timer  (GsrStreamPage *self,
                                               const char    *text);
+void           gsr_stream_page_update_stats  (GsrStreamPage        *self,
+                                              const GsrEncodeStats *stats);
+void           gsr_stream_page_update_relay  (GsrStreamPage  *self,
+                                              GsrStreamRelay *relay);
 
 /* Get the stream URL for -o argument. Caller must g_free(). */
 char          *gsr_stream_page_get_stream_url(GsrStreamPage *self);
 
+/* Further destinations, NULL-terminated. Caller must g_strfreev(). */
+char         **gsr_stream_page_get_simulcast_urls(GsrStreamPage *self);
+
 /* Get the container ID for -c argument. Caller must g_free(). */
 char          *gsr_stream_page_get_container (GsrStreamPage *self);
 
+/* Whether to scale the bitrate to the connection's health. */
+gboolean       gsr_stream_page_get_adaptive_bitrate(GsrStreamPage *self);
+
+/* Whether to also write the stream to a local file. */
+gboolean       gsr_stream_page_get_save_locally(GsrStreamPage *self);
+
 /* Hotkey: programmatically toggle start/stop. */
 void           gsr_stream_page_activate_start_stop(GsrStreamPage *self);
 
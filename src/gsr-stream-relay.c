@@ -0,0 +1,696 @@
+#define _GNU_SOURCE     /* accept4() */
+
+#include "gsr-stream-relay.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <signal.h>
+#include <string.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+
+#include <gio/gio.h>
+#include <glib-unix.h>
+
+#define READ_SIZE       (64 * 1024)
+#define RETRY_MIN_MS    1000
+#define RETRY_MAX_MS    30000
+/* A destination that ran this long starts its backoff over */
+#define STABLE_US       (30 * G_USEC_PER_SEC)
+
+typedef struct {
+    char             *url;
+    char             *name;
+    GsrRelayDestState state;
+    GPid              pid;          /* 0 when not running */
+    gboolean          is_file;      /* a local copy, written directly */
+    int               fd;           /* ffmpeg's stdin or the file, -1 if down */
+    guint             watch_id;
+    guint             write_id;     /* waiting for stdin to be writable */
+    guint             retry_id;
+    GQueue            chunks;       /* GBytes*, oldest first */
+    gsize             head_offset;  /* written part of the first chunk */
+    gsize             queued;
+    guint             retry_ms;
+    gint64            started_us;
+    gboolean          restart_now;  /* respawn as soon as it exits */
+    guint64           bytes_sent;
+    guint64           bytes_dropped;
+    guint             n_restarts;
+
+    /* ── Files: written by a thread of their own ─── */
+    GThread          *writer;
+    GAsyncQueue      *writes;       /* GBytes*; an empty one ends the thread */
+    guint64           pushed;
+    GMutex            write_lock;   /* guards the three below */
+    guint64           written;
+    guint64           discarded;    /* after a failed write */
+    gboolean          write_failed;
+} Dest;
+
+struct _GsrStreamRelay {
+    int        listen_fd;
+    guint      listen_id;
+    guint16    port;
+    int        input_fd;            /* -1 until the recorder connects */
+    guint      input_id;
+    gboolean   had_input;           /* a recorder connected before */
+    GPtrArray *dests;               /* Dest* */
+};
+
+/* ── Destinations ────────────────────────────────────────────────── */
+
+/* "rtmp://live.twitch.tv/app/KEY" → "rtmp://live.twitch.tv" */
+static char *
+url_display_name(const char *url)
+{
+    const char *sep = strstr(url, "://");
+    const char *host = sep ? sep + 3 : url;
+    const char *end = host + strcspn(host, "/?");
+    const char *at = memchr(host, '@', (gsize)(end - host));
+    if (at)
+        host = at + 1;
+
+    GString *name = g_string_new_len(url, sep ? sep + 3 - url : 0);
+    g_string_append_len(name, host, end - host);
+    return g_string_free(name, FALSE);
+}
+
+/* ffmpeg can't guess the muxer from a network URL */
+static const char *
+muxer_for_url(const char *url)
+{
+    if (g_str_has_prefix(url, "rtmp://") || g_str_has_prefix(url, "rtmps://"))
+        return "flv";
+    if (g_str_has_prefix(url, "srt://") || g_str_has_prefix(url, "udp://") ||
+        g_str_has_prefix(url, "tcp://"))
+        return "mpegts";
+    if (g_str_has_prefix(url, "rtsp://"))
+        return "rtsp";
+    return NULL;
+}
+
+static void
+dest_clear_queue(Dest *dest)
+{
+    g_queue_clear_full(&dest->chunks, (GDestroyNotify)g_bytes_unref);
+    dest->head_offset = 0;
+    dest->queued = 0;
+}
+
+static gboolean on_dest_writable(gint fd, GIOCondition condition, gpointer user_data);
+
+/*
+ * write() to an ffmpeg that exited raises SIGPIPE, which would kill the
+ * app.  It is blocked around the write instead of ignored process-wide,
+ * which children would inherit, and one the write raised is taken off
+ * the pending set before unblocking.  The caller sees EPIPE.
+ */
+static ssize_t
+write_pipe(int fd, const void *data, size_t size)
+{
+    sigset_t pipe_set, old_set, pending;
+    sigemptyset(&pipe_set);
+    sigaddset(&pipe_set, SIGPIPE);
+    pthread_sigmask(SIG_BLOCK, &pipe_set, &old_set);
+    sigpending(&pending);
+    gboolean was_pending = sigismember(&pending, SIGPIPE);
+
+    ssize_t n = write(fd, data, size);
+    int saved_errno = errno;
+    if (n < 0 && saved_errno == EPIPE && !was_pending) {
+        static const struct timespec no_wait = { 0, 0 };
+        while (sigtimedwait(&pipe_set, NULL, &no_wait) < 0 && errno == EINTR)
+            ;
+    }
+
+    pthread_sigmask(SIG_SETMASK, &old_set, NULL);
+    errno = saved_errno;
+    return n;
+}
+
+/* Write as much as the pipe takes; waits for G_IO_OUT for the rest */
+static void
+dest_flush(Dest *dest)
+{
+    while (dest->fd >= 0 && !g_queue_is_empty(&dest->chunks)) {
+        GBytes *chunk = g_queue_peek_head(&dest->chunks);
+        gsize size;
+        const guint8 *data = g_bytes_get_data(chunk, &size);
+
+        ssize_t n = write_pipe(dest->fd, data + dest->head_offset, size - dest->head_offset);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            if (dest->write_id == 0)
+                dest->write_id = g_unix_fd_add(dest->fd, G_IO_OUT,
+                                               on_dest_writable, dest);
+            return;
+        }
+        if (n < 0) {
+            /* ffmpeg is gone; the child watch restarts it */
+            dest->bytes_dropped += dest->queued;
+            dest_clear_queue(dest);
+            break;
+        }
+
+        dest->bytes_sent += (guint64)n;
+        dest->queued -= (gsize)n;
+        dest->head_offset += (gsize)n;
+        dest->state = GSR_RELAY_DEST_LIVE;
+        if (dest->head_offset == size) {
+            g_bytes_unref(g_queue_pop_head(&dest->chunks));
+            dest->head_offset = 0;
+        }
+    }
+    g_clear_handle_id(&dest->write_id, g_source_remove);
+}
+
+static gboolean
+on_dest_writable(gint fd G_GNUC_UNUSED, GIOCondition condition G_GNUC_UNUSED,
+                 gpointer user_data)
+{
+    Dest *dest = user_data;
+    dest->write_id = 0;
+    dest_flush(dest);
+    return G_SOURCE_REMOVE;
+}
+
+/*
+ * A slow disk must not stall the main loop, so files are written by a
+ * thread of their own.  After a failed write it only discards what it
+ * gets, and the file stays failed; fsync() is its last step.
+ */
+static gpointer
+file_writer_thread(gpointer user_data)
+{
+    Dest *dest = user_data;
+    for (;;) {
+        GBytes *chunk = g_async_queue_pop(dest->writes);
+        gsize size;
+        const guint8 *data = g_bytes_get_data(chunk, &size);
+        if (size == 0) {
+            g_bytes_unref(chunk);
+            break;
+        }
+
+        gsize done = 0;
+        int error = 0;
+        while (!dest->write_failed && done < size) {
+            ssize_t n = write(dest->fd, data + done, size - done);
+            if (n < 0 && errno == EINTR)
+                continue;
+            if (n < 0) {
+                error = errno;
+                break;
+            }
+            done += (gsize)n;
+        }
+        g_bytes_unref(chunk);
+
+        if (error)
+            g_warning("Failed to write %s: %s", dest->url, g_strerror(error));
+        g_mutex_lock(&dest->write_lock);
+        dest->written += done;
+        dest->discarded += size - done;
+        if (error)
+            dest->write_failed = TRUE;
+        g_mutex_unlock(&dest->write_lock);
+    }
+
+    if (!dest->write_failed && fsync(dest->fd) != 0) {
+        g_warning("Failed to sync %s: %s", dest->url, g_strerror(errno));
+        g_mutex_lock(&dest->write_lock);
+        dest->write_failed = TRUE;
+        g_mutex_unlock(&dest->write_lock);
+    }
+    return NULL;
+}
+
+/* Main thread: sync a file's counters and state with its writer */
+static void
+dest_update_file(Dest *dest)
+{
+    g_mutex_lock(&dest->write_lock);
+    dest->bytes_sent = dest->written;
+    dest->queued = (gsize)(dest->pushed - dest->written - dest->discarded);
+    if (dest->write_failed)
+        dest->state = GSR_RELAY_DEST_FAILED;
+    g_mutex_unlock(&dest->write_lock);
+}
+
+/* Ends the writer once it wrote what it has */
+static void
+dest_stop_writer(Dest *dest)
+{
+    if (!dest->writer)
+        return;
+    g_async_queue_push(dest->writes, g_bytes_new(NULL, 0));
+    g_thread_join(g_steal_pointer(&dest->writer));
+    dest_update_file(dest);
+}
+
+static void
+dest_push_file(Dest *dest, GBytes *chunk)
+{
+    gsize size = g_bytes_get_size(chunk);
+    dest_update_file(dest);
+    if (!dest->writer || dest->state == GSR_RELAY_DEST_FAILED ||
+        dest->queued + size > GSR_STREAM_RELAY_MAX_QUEUED)
+    {
+        dest->bytes_dropped += size;
+        return;
+    }
+    dest->pushed += size;
+    dest->queued += size;
+    g_async_queue_push(dest->writes, g_bytes_ref(chunk));
+}
+
+static void
+dest_push(Dest *dest, GBytes *chunk)
+{
+    if (dest->is_file) {
+        dest_push_file(dest, chunk);
+        return;
+    }
+    gsize size = g_bytes_get_size(chunk);
+    if (dest->fd < 0) {
+        dest->bytes_dropped += size;
+        return;
+    }
+
+    /* Too far behind: drop all but the chunk being written, which would
+       leave the stream cut mid-packet.  The demuxer resyncs. */
+    if (dest->queued + size > GSR_STREAM_RELAY_MAX_QUEUED) {
+        GBytes *head = dest->head_offset > 0 ? g_queue_pop_head(&dest->chunks) : NULL;
+        gsize head_left = head ? g_bytes_get_size(head) - dest->head_offset : 0;
+        dest->bytes_dropped += dest->queued - head_left;
+        g_queue_clear_full(&dest->chunks, (GDestroyNotify)g_bytes_unref);
+        dest->queued = head_left;
+        if (head)
+            g_queue_push_head(&dest->chunks, head);
+        else
+            dest->head_offset = 0;
+    }
+
+    g_queue_push_tail(&dest->chunks, g_bytes_ref(chunk));
+    dest->queued += size;
+    if (dest->write_id == 0)
+        dest_flush(dest);
+}
+
+static void dest_start(Dest *dest);
+
+static gboolean
+on_dest_retry(gpointer user_data)
+{
+    Dest *dest = user_data;
+    dest->retry_id = 0;
+    dest->n_restarts++;
+    dest_start(dest);
+    return G_SOURCE_REMOVE;
+}
+
+static void
+dest_close(Dest *dest)
+{
+    g_clear_handle_id(&dest->write_id, g_source_remove);
+    if (dest->fd >= 0) {
+        close(dest->fd);
+        dest->fd = -1;
+    }
+    dest->bytes_dropped += dest->queued;
+    dest_clear_queue(dest);
+}
+
+static void
+on_dest_exited(GPid pid, gint wait_status, gpointer user_data)
+{
+    Dest *dest = user_data;
+    g_spawn_close_pid(pid);
+    dest->watch_id = 0;
+    dest->pid = 0;
+    dest_close(dest);
+
+    if (dest->restart_now) {
+        dest->restart_now = FALSE;
+        dest->n_restarts++;
+        dest_start(dest);
+        return;
+    }
+
+    if (g_get_monotonic_time() - dest->started_us >= STABLE_US)
+        dest->retry_ms = RETRY_MIN_MS;
+    int exit_status = WIFEXITED(wait_status) ? WEXITSTATUS(wait_status) : -1;
+    g_warning("Simulcast to %s stopped (status %d), retrying in %u s",
+              dest->name, exit_status, dest->retry_ms / 1000);
+
+    dest->state = GSR_RELAY_DEST_RETRYING;
+    dest->retry_id = g_timeout_add(dest->retry_ms, on_dest_retry, dest);
+    dest->retry_ms = MIN(dest->retry_ms * 2, RETRY_MAX_MS);
+}
+
+static void
+dest_start(Dest *dest)
+{
+    GPtrArray *argv = g_ptr_array_new();
+    g_ptr_array_add(argv, "ffmpeg");
+    g_ptr_array_add(argv, "-hide_banner");
+    g_ptr_array_add(argv, "-loglevel");
+    g_ptr_array_add(argv, "error");
+    g_ptr_array_add(argv, "-i");
+    g_ptr_array_add(argv, "pipe:0");
+    g_ptr_array_add(argv, "-map");
+    g_ptr_array_add(argv, "0");
+    g_ptr_array_add(argv, "-c");
+    g_ptr_array_add(argv, "copy");
+    const char *muxer = muxer_for_url(dest->url);
+    if (muxer) {
+        g_ptr_array_add(argv, "-f");
+        g_ptr_array_add(argv, (char *)muxer);
+    }
+    g_ptr_array_add(argv, dest->url);
+    g_ptr_array_add(argv, NULL);
+
+    GError *error = NULL;
+    gboolean ok = g_spawn_async_with_pipes(NULL, (char **)argv->pdata, NULL,
+        G_SPAWN_SEARCH_PATH | G_SPAWN_DO_NOT_REAP_CHILD | G_SPAWN_STDOUT_TO_DEV_NULL,
+        NULL, NULL, &dest->pid, &dest->fd, NULL, NULL, &error);
+    g_ptr_array_unref(argv);
+
+    dest->started_us = g_get_monotonic_time();
+    if (!ok) {
+        g_warning("Failed to start ffmpeg for %s: %s", dest->name, error->message);
+        g_error_free(error);
+        dest->pid = 0;
+        dest->fd = -1;
+        dest->state = GSR_RELAY_DEST_RETRYING;
+        dest->retry_id = g_timeout_add(dest->retry_ms, on_dest_retry, dest);
+        dest->retry_ms = MIN(dest->retry_ms * 2, RETRY_MAX_MS);
+        return;
+    }
+
+    g_unix_set_fd_nonblocking(dest->fd, TRUE, NULL);
+    dest->state = GSR_RELAY_DEST_STARTING;
+    dest->watch_id = g_child_watch_add(dest->pid, on_dest_exited, dest);
+    g_debug("Simulcast to %s (pid=%d)", dest->name, dest->pid);
+}
+
+/* Make ffmpeg finish its output and start over on the next stream */
+static void
+dest_restart(Dest *dest)
+{
+    /* A file just carries on: MPEG-TS can be concatenated, and the
+       window only keeps a copy across restarts in MPEG-TS */
+    if (dest->is_file)
+        return;
+    if (dest->pid == 0) {
+        if (dest->retry_id != 0) {
+            g_clear_handle_id(&dest->retry_id, g_source_remove);
+            dest->n_restarts++;
+            dest_start(dest);
+        }
+        return;
+    }
+    dest->restart_now = TRUE;
+    dest_close(dest);
+}
+
+static void
+on_reaped(GPid pid, gint wait_status G_GNUC_UNUSED, gpointer user_data G_GNUC_UNUSED)
+{
+    g_spawn_close_pid(pid);
+}
+
+static Dest *
+dest_new(const char *url, const char *name)
+{
+    Dest *dest = g_new0(Dest, 1);
+    dest->url = g_strdup(url);
+    dest->name = g_strdup(name);
+    dest->fd = -1;
+    dest->retry_ms = RETRY_MIN_MS;
+    g_queue_init(&dest->chunks);
+    return dest;
+}
+
+static void
+dest_free(Dest *dest)
+{
+    g_clear_handle_id(&dest->retry_id, g_source_remove);
+    if (dest->is_file) {
+        dest_stop_writer(dest);
+        g_async_queue_unref(dest->writes);
+        g_mutex_clear(&dest->write_lock);
+    }
+    dest_close(dest);
+    if (dest->pid != 0) {
+        /* Let it write its trailer; a watch of its own reaps it */
+        g_clear_handle_id(&dest->watch_id, g_source_remove);
+        kill(dest->pid, SIGTERM);
+        g_child_watch_add(dest->pid, on_reaped, NULL);
+    }
+    g_free(dest->url);
+    g_free(dest->name);
+    g_free(dest);
+}
+
+/* ── Input ───────────────────────────────────────────────────────── */
+
+static void
+close_input(GsrStreamRelay *self)
+{
+    g_clear_handle_id(&self->input_id, g_source_remove);
+    if (self->input_fd >= 0) {
+        close(self->input_fd);
+        self->input_fd = -1;
+    }
+}
+
+/* Returns FALSE once the recorder closed the stream or it failed */
+static gboolean
+read_input(GsrStreamRelay *self)
+{
+    for (;;) {
+        guint8 *buf = g_malloc(READ_SIZE);
+        ssize_t n = read(self->input_fd, buf, READ_SIZE);
+        if (n > 0) {
+            GBytes *chunk = g_bytes_new_take(g_realloc(buf, (gsize)n), (gsize)n);
+            for (guint i = 0; i < self->dests->len; i++)
+                dest_push(g_ptr_array_index(self->dests, i), chunk);
+            g_bytes_unref(chunk);
+            continue;
+        }
+        g_free(buf);
+        if (n < 0 && errno == EINTR)
+            continue;
+        return n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+    }
+}
+
+static gboolean
+on_input_ready(gint fd G_GNUC_UNUSED, GIOCondition condition G_GNUC_UNUSED,
+               gpointer user_data)
+{
+    GsrStreamRelay *self = user_data;
+    if (read_input(self))
+        return G_SOURCE_CONTINUE;
+
+    self->input_id = 0;
+    close(self->input_fd);
+    self->input_fd = -1;
+    return G_SOURCE_REMOVE;
+}
+
+static gboolean
+on_listen_ready(gint fd, GIOCondition condition G_GNUC_UNUSED, gpointer user_data)
+{
+    GsrStreamRelay *self = user_data;
+
+    /* Not inherited by the ffmpeg destinations spawned meanwhile */
+    int conn = accept4(fd, NULL, NULL, SOCK_CLOEXEC | SOCK_NONBLOCK);
+    if (conn < 0)
+        return G_SOURCE_CONTINUE;
+
+    /* A new recorder: the old one is done, and the stream starts over */
+    close_input(self);
+    if (self->had_input) {
+        for (guint i = 0; i < self->dests->len; i++)
+            dest_restart(g_ptr_array_index(self->dests, i));
+    }
+    self->had_input = TRUE;
+
+    self->input_fd = conn;
+    self->input_id = g_unix_fd_add(conn, G_IO_IN | G_IO_HUP | G_IO_ERR,
+                                   on_input_ready, self);
+    return G_SOURCE_CONTINUE;
+}
+
+static gboolean
+open_listener(GsrStreamRelay *self, GError **error)
+{
+    self->listen_fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
+    if (self->listen_fd < 0)
+        goto fail;
+
+    struct sockaddr_in addr = {
+        .sin_family = AF_INET,
+        .sin_addr.s_addr = htonl(INADDR_LOOPBACK),
+        .sin_port = 0,
+    };
+    socklen_t addr_len = sizeof(addr);
+    if (bind(self->listen_fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 ||
+        listen(self->listen_fd, 1) != 0 ||
+        getsockname(self->listen_fd, (struct sockaddr *)&addr, &addr_len) != 0)
+        goto fail;
+
+    self->port = ntohs(addr.sin_port);
+    self->listen_id = g_unix_fd_add(self->listen_fd, G_IO_IN, on_listen_ready, self);
+    return TRUE;
+
+fail:
+    g_set_error(error, G_IO_ERROR, g_io_error_from_errno(errno),
+                "Failed to open the simulcast relay port: %s", g_strerror(errno));
+    return FALSE;
+}
+
+/* ── Public API ──────────────────────────────────────────────────── */
+
+GsrStreamRelay *
+gsr_stream_relay_new(const char *const *urls, GError **error)
+{
+    GsrStreamRelay *self = g_new0(GsrStreamRelay, 1);
+    self->listen_fd = -1;
+    self->input_fd = -1;
+    self->dests = g_ptr_array_new_with_free_func((GDestroyNotify)dest_free);
+
+    if (!open_listener(self, error)) {
+        gsr_stream_relay_free(self);
+        return NULL;
+    }
+
+    for (int i = 0; urls[i]; i++) {
+        g_autofree char *name = url_display_name(urls[i]);
+        Dest *dest = dest_new(urls[i], name);
+        g_ptr_array_add(self->dests, dest);
+        dest_start(dest);
+    }
+    return self;
+}
+
+gboolean
+gsr_stream_relay_add_file(GsrStreamRelay *self, const char *path, GError **error)
+{
+    g_return_val_if_fail(self != NULL && path != NULL, FALSE);
+
+    int fd = open(path, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        int saved_errno = errno;
+        g_set_error(error, G_IO_ERROR, g_io_error_from_errno(saved_errno),
+                    "Failed to create %s: %s", path, g_strerror(saved_errno));
+        return FALSE;
+    }
+
+    g_autofree char *name = g_path_get_basename(path);
+    Dest *dest = dest_new(path, name);
+    dest->is_file = TRUE;
+    dest->fd = fd;
+    dest->state = GSR_RELAY_DEST_LIVE;
+    dest->writes = g_async_queue_new_full((GDestroyNotify)g_bytes_unref);
+    g_mutex_init(&dest->write_lock);
+    g_ptr_array_add(self->dests, dest);
+
+    dest->writer = g_thread_try_new("gsr-relay-file", file_writer_thread, dest, error);
+    if (!dest->writer) {
+        g_ptr_array_remove(self->dests, dest);
+        return FALSE;
+    }
+    return TRUE;
+}
+
+gboolean
+gsr_stream_relay_finish_file(GsrStreamRelay *self)
+{
+    g_return_val_if_fail(self != NULL, FALSE);
+
+    /* As in gsr_stream_relay_free(): the recorder has exited */
+    if (self->input_fd >= 0)
+        read_input(self);
+    close_input(self);
+
+    for (guint i = 0; i < self->dests->len; i++) {
+        Dest *dest = g_ptr_array_index(self->dests, i);
+        if (dest->is_file) {
+            dest_stop_writer(dest);
+            return dest->state != GSR_RELAY_DEST_FAILED;
+        }
+    }
+    return FALSE;
+}
+
+void
+gsr_stream_relay_free(GsrStreamRelay *self)
+{
+    if (!self)
+        return;
+
+    /* The recorder has exited, so the rest of its stream is already in
+       the socket; don't cut the local copy short */
+    if (self->input_fd >= 0)
+        read_input(self);
+    close_input(self);
+    g_clear_handle_id(&self->listen_id, g_source_remove);
+    if (self->listen_fd >= 0)
+        close(self->listen_fd);
+    g_ptr_array_unref(self->dests);
+    g_free(self);
+}
+
+char *
+gsr_stream_relay_get_input_url(GsrStreamRelay *self)
+{
+    g_return_val_if_fail(self != NULL, NULL);
+    return g_strdup_printf("tcp://127.0.0.1:%u", self->port);
+}
+
+guint
+gsr_stream_relay_get_n_destinations(GsrStreamRelay *self)
+{
+    g_return_val_if_fail(self != NULL, 0);
+    return self->dests->len;
+}
+
+void
+gsr_stream_relay_get_destination(GsrStreamRelay *self, guint index,
+                                 GsrRelayDestInfo *info)
+{
+    g_return_if_fail(self != NULL && index < self->dests->len);
+
+    Dest *dest = g_ptr_array_index(self->dests, index);
+    if (dest->is_file)
+        dest_update_file(dest);
+    info->name = dest->name;
+    info->state = dest->state;
+    info->bytes_sent = dest->bytes_sent;
+    info->bytes_dropped = dest->bytes_dropped;
+    info->n_restarts = dest->n_restarts;
+    info->queued = dest->queued;
+}
+
+gsize
+gsr_stream_relay_get_max_queued(GsrStreamRelay *self)
+{
+    g_return_val_if_fail(self != NULL, 0);
+
+    /* A slow disk has its own limit; it shouldn't lower the bitrate */
+    gsize max = 0;
+    for (guint i = 0; i < self->dests->len; i++) {
+        const Dest *dest = g_ptr_array_index(self->dests, i);
+        if (!dest->is_file)
+            max = MAX(max, dest->queued);
+    }
+    return max;
+}
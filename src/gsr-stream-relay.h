@@ -0,0 +1,94 @@
+#pragma once
+
+/*
+ * gsr-stream-relay.h — Simulcast one encode to several destinations.
+ *
+ * The relay listens on a loopback TCP port that gpu-screen-recorder
+ * streams into (as MPEG-TS, or WebM for VP8/VP9), and copies what
+ * arrives to one ffmpeg per destination, which remuxes it for that
+ * destination's protocol without re-encoding.  Destinations are
+ * independent: each has its own queue, and one that exits is restarted
+ * with a backoff while the others keep going.  A destination that
+ * can't keep up has its queue dropped once it holds
+ * GSR_STREAM_RELAY_MAX_QUEUED bytes, rather than holding everything up.
+ *
+ * A file can be added as another destination: it's written as it
+ * arrives, so a dropped connection doesn't cut the local copy short.
+ * A thread of its own does the writing, so a slow disk doesn't stall
+ * the main loop; it drops what doesn't fit in GSR_STREAM_RELAY_MAX_QUEUED.
+ *
+ * When the recorder reconnects (e.g. restarted at another bitrate) every
+ * network destination is restarted, since the new stream starts over
+ * with new headers and timestamps; a file is appended to, which only
+ * gives a playable file for MPEG-TS.
+ */
+
+#include <glib.h>
+
+#define GSR_STREAM_RELAY_MAX_QUEUED  (16 * 1024 * 1024)
+
+typedef struct _GsrStreamRelay GsrStreamRelay;
+
+typedef enum {
+    GSR_RELAY_DEST_STARTING,   /* ffmpeg started, nothing forwarded yet */
+    GSR_RELAY_DEST_LIVE,
+    GSR_RELAY_DEST_RETRYING,   /* exited, waiting to be restarted */
+    GSR_RELAY_DEST_FAILED,     /* a file that couldn't be written */
+} GsrRelayDestState;
+
+typedef struct {
+    const char       *name;           /* scheme://host or file name, no stream key */
+    GsrRelayDestState state;
+    guint64           bytes_sent;
+    guint64           bytes_dropped;  /* while down or too far behind */
+    guint             n_restarts;
+    gsize             queued;
+} GsrRelayDestInfo;
+
+/**
+ * Start listening and start one ffmpeg per URL in the NULL-terminated
+ * urls.  Returns NULL with error set if the port can't be opened.
+ */
+GsrStreamRelay *gsr_stream_relay_new        (const char *const *urls,
+                                             GError           **error);
+
+/**
+ * Also write the stream to path, appending if it exists.
+ */
+gboolean        gsr_stream_relay_add_file   (GsrStreamRelay *self,
+                                             const char     *path,
+                                             GError        **error);
+
+/**
+ * Forward what is left of the stream to the file added with
+ * gsr_stream_relay_add_file() and wait until it is written and synced.
+ * Returns FALSE if there is no file or writing it failed.
+ */
+gboolean        gsr_stream_relay_finish_file(GsrStreamRelay *self);
+
+/**
+ * Forward what is left of the stream, stop listening and stop the
+ * destinations; each ffmpeg gets SIGTERM and finishes its output on its
+ * own.
+ */
+void            gsr_stream_relay_free       (GsrStreamRelay *self);
+
+/**
+ * The URL to pass to gpu-screen-recorder as -o.  Caller must g_free().
+ */
+char           *gsr_stream_relay_get_input_url(GsrStreamRelay *self);
+
+guint           gsr_stream_relay_get_n_destinations(GsrStreamRelay *self);
+
+/**
+ * Fill info for destination index.  Strings in info stay valid until the
+ * relay is freed.
+ */
+void            gsr_stream_relay_get_destination(GsrStreamRelay   *self,
+                                                 guint             index,
+                                                 GsrRelayDestInfo *info);
+
+/**
+ * Bytes queued for the network destination furthest behind.
+ */
+gsize           gsr_stream_relay_get_max_queued(GsrStreamRelay *self);
@@ -0,0 +1,399 @@
+#include "gsr-thumbnailer.h"
+
+#include <string.h>
+
+#include <glib/gstdio.h>
+
+#define N_WORKERS          2
+#define THUMBNAIL_WIDTH    192    /* 2× the row size, for HiDPI */
+#define MAX_TEXTURES       128    /* decoded thumbnails kept in memory */
+#define EVICT_TO_PERCENT   90     /* trim the disk cache below the cap */
+
+/* First keyframe only: no full decode, and no seeking on short clips */
+#define DEFAULT_COMMAND \
+    "ffmpeg -nostdin -v error -skip_frame nokey -i {input} -frames:v 1 " \
+    "-vf scale=" G_STRINGIFY(THUMBNAIL_WIDTH) ":-2 -f image2 -update 1 -c:v png -y {output}"
+
+typedef struct {
+    GsrThumbnailer  *owner;       /* NULL once cancelled or freed; main thread only */
+    guint            id;
+    char            *path;
+    char            *key;
+    char            *cache_path;
+    gint             cancelled;   /* atomic */
+    GdkTexture      *texture;     /* result, set by the worker */
+    GsrThumbnailFunc callback;
+    gpointer         user_data;
+} Task;
+
+typedef struct {
+    char       *key;
+    GdkTexture *texture;
+} CachedTexture;
+
+struct _GsrThumbnailer {
+    char        *cache_dir;
+    char       **command;         /* argv with {input}/{output} */
+    guint64      max_cache_bytes;
+    GThreadPool *pool;
+    guint        next_id;
+    GHashTable  *requests;        /* id → Task, pending ones */
+
+    /* ── Decoded textures, most recently used first ─── */
+    GQueue       textures;        /* CachedTexture* */
+    GHashTable  *texture_links;   /* key → GList link in textures */
+    GHashTable  *failed;          /* keys that produced no thumbnail */
+
+    /* ── Disk cache size, shared with the workers ─── */
+    GMutex       cache_lock;
+    gint64       cache_bytes;     /* -1 until counted */
+};
+
+/* ── Tasks ───────────────────────────────────────────────────────── */
+
+static void
+task_clear(Task *task)
+{
+    g_free(task->path);
+    g_free(task->key);
+    g_free(task->cache_path);
+    g_clear_object(&task->texture);
+}
+
+static Task *
+task_ref(Task *task)
+{
+    return g_atomic_rc_box_acquire(task);
+}
+
+static void
+task_unref(Task *task)
+{
+    g_atomic_rc_box_release_full(task, (GDestroyNotify)task_clear);
+}
+
+/* Newest request first, so rows just scrolled to win over ones gone by */
+static gint
+compare_tasks(gconstpointer a, gconstpointer b, gpointer user_data G_GNUC_UNUSED)
+{
+    guint ia = ((const Task *)a)->id;
+    guint ib = ((const Task *)b)->id;
+    return (ia < ib) - (ia > ib);
+}
+
+/* ── Texture LRU (main thread) ───────────────────────────────────── */
+
+static void
+cached_texture_free(CachedTexture *cached)
+{
+    g_free(cached->key);
+    g_object_unref(cached->texture);
+    g_free(cached);
+}
+
+static GdkTexture *
+lookup_texture(GsrThumbnailer *self, const char *key)
+{
+    GList *link = g_hash_table_lookup(self->texture_links, key);
+    if (!link)
+        return NULL;
+    g_queue_unlink(&self->textures, link);
+    g_queue_push_head_link(&self->textures, link);
+    return ((CachedTexture *)link->data)->texture;
+}
+
+static void
+store_texture(GsrThumbnailer *self, const char *key, GdkTexture *texture)
+{
+    if (g_hash_table_contains(self->texture_links, key))
+        return;
+
+    CachedTexture *cached = g_new0(CachedTexture, 1);
+    cached->key = g_strdup(key);
+    cached->texture = g_object_ref(texture);
+    g_queue_push_head(&self->textures, cached);
+    g_hash_table_insert(self->texture_links, cached->key, self->textures.head);
+
+    while (g_queue_get_length(&self->textures) > MAX_TEXTURES) {
+        CachedTexture *old = g_queue_pop_tail(&self->textures);
+        g_hash_table_remove(self->texture_links, old->key);
+        cached_texture_free(old);
+    }
+}
+
+/* ── Disk cache (worker threads) ─────────────────────────────────── */
+
+typedef struct {
+    char  *path;
+    gint64 size;
+    gint64 mtime;
+} CacheFile;
+
+static gint
+compare_cache_file_mtime(gconstpointer a, gconstpointer b)
+{
+    gint64 ma = ((const CacheFile *)a)->mtime;
+    gint64 mb = ((const CacheFile *)b)->mtime;
+    return (ma > mb) - (ma < mb);
+}
+
+/* Lists the cache's PNGs; returns their total size */
+static gint64
+list_cache(GsrThumbnailer *self, GArray *files)
+{
+    GDir *dir = g_dir_open(self->cache_dir, 0, NULL);
+    if (!dir)
+        return 0;
+
+    gint64 total = 0;
+    const char *name;
+    while ((name = g_dir_read_name(dir))) {
+        if (!g_str_has_suffix(name, ".png"))
+            continue;
+        char *path = g_build_filename(self->cache_dir, name, NULL);
+        GStatBuf st;
+        if (g_stat(path, &st) != 0) {
+            g_free(path);
+            continue;
+        }
+        total += st.st_size;
+        if (files) {
+            CacheFile file = { path, st.st_size, st.st_mtime };
+            g_array_append_val(files, file);
+        } else {
+            g_free(path);
+        }
+    }
+    g_dir_close(dir);
+    return total;
+}
+
+/*
+ * A hit bumps the PNG's mtime, so mtime order is use order.  Over the
+ * cap, the least recently used files go until the cache is at
+ * EVICT_TO_PERCENT of it, so the directory isn't listed on every insert.
+ */
+static void
+account_cache(GsrThumbnailer *self, gint64 added_bytes)
+{
+    g_mutex_lock(&self->cache_lock);
+    if (self->cache_bytes < 0)
+        self->cache_bytes = list_cache(self, NULL);
+    else
+        self->cache_bytes += added_bytes;
+
+    if ((guint64)self->cache_bytes <= self->max_cache_bytes) {
+        g_mutex_unlock(&self->cache_lock);
+        return;
+    }
+
+    GArray *files = g_array_new(FALSE, FALSE, sizeof(CacheFile));
+    self->cache_bytes = list_cache(self, files);
+    g_array_sort(files, compare_cache_file_mtime);
+
+    gint64 target = (gint64)(self->max_cache_bytes / 100 * EVICT_TO_PERCENT);
+    for (guint i = 0; i < files->len; i++) {
+        CacheFile *file = &g_array_index(files, CacheFile, i);
+        if (self->cache_bytes > target && g_unlink(file->path) == 0)
+            self->cache_bytes -= file->size;
+        g_free(file->path);
+    }
+    g_array_unref(files);
+    g_mutex_unlock(&self->cache_lock);
+}
+
+static gboolean
+generate(GsrThumbnailer *self, Task *task)
+{
+    g_autofree char *tmp_path = g_strconcat(task->cache_path, ".tmp", NULL);
+    GStrvBuilder *builder = g_strv_builder_new();
+    for (int i = 0; self->command[i]; i++) {
+        GString *arg = g_string_new(self->command[i]);
+        g_string_replace(arg, "{input}", task->path, 0);
+        g_string_replace(arg, "{output}", tmp_path, 0);
+        g_strv_builder_add(builder, arg->str);
+        g_string_free(arg, TRUE);
+    }
+    g_auto(GStrv) argv = g_strv_builder_end(builder);
+    g_strv_builder_unref(builder);
+
+    int wait_status = 0;
+    GError *error = NULL;
+    if (!g_spawn_sync(NULL, argv, NULL,
+                      G_SPAWN_SEARCH_PATH | G_SPAWN_STDOUT_TO_DEV_NULL |
+                      G_SPAWN_STDERR_TO_DEV_NULL,
+                      NULL, NULL, NULL, NULL, &wait_status, &error))
+    {
+        g_warning("Failed to run thumbnailer: %s", error->message);
+        g_error_free(error);
+        return FALSE;
+    }
+
+    GStatBuf st;
+    if (!g_spawn_check_wait_status(wait_status, NULL) || g_stat(tmp_path, &st) != 0 ||
+        st.st_size == 0 || g_rename(tmp_path, task->cache_path) != 0)
+    {
+        g_unlink(tmp_path);
+        return FALSE;
+    }
+
+    account_cache(self, st.st_size);
+    return TRUE;
+}
+
+static gboolean
+deliver(gpointer user_data)
+{
+    Task *task = user_data;
+    GsrThumbnailer *self = task->owner;
+
+    /* Cancelled or orphaned: the thumbnailer may be gone, don't touch it */
+    if (!self || g_atomic_int_get(&task->cancelled)) {
+        task_unref(task);
+        return G_SOURCE_REMOVE;
+    }
+
+    /* Still pending: the hash table holds the other reference */
+    if (g_hash_table_steal(self->requests, GUINT_TO_POINTER(task->id))) {
+        if (task->texture)
+            store_texture(self, task->key, task->texture);
+        else
+            g_hash_table_add(self->failed, g_strdup(task->key));
+        task->callback(task->texture, task->user_data);
+        task_unref(task);
+    }
+
+    task_unref(task);
+    return G_SOURCE_REMOVE;
+}
+
+static void
+run_task(gpointer data, gpointer user_data)
+{
+    Task *task = data;
+    GsrThumbnailer *self = user_data;
+
+    if (g_atomic_int_get(&task->cancelled)) {
+        task_unref(task);
+        return;
+    }
+
+    /* Cached: mark as used; otherwise make it */
+    if (g_utime(task->cache_path, NULL) == 0 || generate(self, task)) {
+        GError *error = NULL;
+        task->texture = gdk_texture_new_from_filename(task->cache_path, &error);
+        if (!task->texture) {
+            g_warning("Failed to load thumbnail %s: %s", task->cache_path, error->message);
+            g_error_free(error);
+            g_unlink(task->cache_path);
+        }
+    }
+
+    g_idle_add_full(G_PRIORITY_DEFAULT, deliver, task, NULL);
+}
+
+/* ── Public API ──────────────────────────────────────────────────── */
+
+GsrThumbnailer *
+gsr_thumbnailer_new(const char *cache_dir, guint64 max_cache_bytes)
+{
+    GsrThumbnailer *self = g_new0(GsrThumbnailer, 1);
+    self->cache_dir = g_strdup(cache_dir);
+    self->max_cache_bytes = max_cache_bytes;
+    self->cache_bytes = -1;
+    g_mutex_init(&self->cache_lock);
+    self->requests = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL,
+                                           (GDestroyNotify)task_unref);
+    g_queue_init(&self->textures);
+    self->texture_links = g_hash_table_new(g_str_hash, g_str_equal);
+    self->failed = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+
+    const char *command = g_getenv("GSR_THUMBNAILER");
+    GError *error = NULL;
+    if (command && !g_shell_parse_argv(command, NULL, &self->command, &error)) {
+        g_warning("Ignoring GSR_THUMBNAILER: %s", error->message);
+        g_clear_error(&error);
+    }
+    if (!self->command)
+        g_shell_parse_argv(DEFAULT_COMMAND, NULL, &self->command, NULL);
+
+    g_mkdir_with_parents(cache_dir, 0700);
+
+    self->pool = g_thread_pool_new(run_task, self, N_WORKERS, FALSE, NULL);
+    g_thread_pool_set_sort_function(self->pool, compare_tasks, NULL);
+    return self;
+}
+
+static void
+disown_task(gpointer key G_GNUC_UNUSED, gpointer value, gpointer user_data G_GNUC_UNUSED)
+{
+    Task *task = value;
+    task->owner = NULL;
+    g_atomic_int_set(&task->cancelled, TRUE);
+}
+
+void
+gsr_thumbnailer_free(GsrThumbnailer *self)
+{
+    if (!self)
+        return;
+
+    /* Queued tasks are skipped by the workers; results still in flight
+       find no owner */
+    g_hash_table_foreach(self->requests, disown_task, NULL);
+    g_thread_pool_free(self->pool, FALSE, TRUE);
+
+    g_hash_table_destroy(self->requests);
+    g_queue_clear_full(&self->textures, (GDestroyNotify)cached_texture_free);
+    g_hash_table_destroy(self->texture_links);
+    g_hash_table_destroy(self->failed);
+    g_mutex_clear(&self->cache_lock);
+    g_strfreev(self->command);
+    g_free(self->cache_dir);
+    g_free(self);
+}
+
+guint
+gsr_thumbnailer_request(GsrThumbnailer *self, const char *path, gint64 mtime,
+                        GsrThumbnailFunc callback, gpointer user_data)
+{
+    g_return_val_if_fail(self != NULL && path != NULL && callback != NULL, 0);
+
+    g_autofree char *key_source = g_strdup_printf("%s\n%" G_GINT64_FORMAT, path, mtime);
+    g_autofree char *key = g_compute_checksum_for_string(G_CHECKSUM_SHA1, key_source, -1);
+
+    GdkTexture *texture = lookup_texture(self, key);
+    if (texture || g_hash_table_contains(self->failed, key)) {
+        callback(texture, user_data);
+        return 0;
+    }
+
+    Task *task = g_atomic_rc_box_new0(Task);
+    task->owner = self;
+    task->id = ++self->next_id;
+    task->path = g_strdup(path);
+    task->cache_path = g_strdup_printf("%s/%s.png", self->cache_dir, key);
+    task->key = g_steal_pointer(&key);
+    task->callback = callback;
+    task->user_data = user_data;
+
+    g_hash_table_insert(self->requests, GUINT_TO_POINTER(task->id), task);
+    g_thread_pool_push(self->pool, task_ref(task), NULL);
+    return task->id;
+}
+
+void
+gsr_thumbnailer_cancel(GsrThumbnailer *self, guint request_id)
+{
+    g_return_if_fail(self != NULL);
+    if (request_id == 0)
+        return;
+
+    Task *task = g_hash_table_lookup(self->requests, GUINT_TO_POINTER(request_id));
+    if (!task)
+        return;
+    /* A result already queued for delivery may outlive the thumbnailer */
+    task->owner = NULL;
+    g_atomic_int_set(&task->cancelled, TRUE);
+    g_hash_table_remove(self->requests, GUINT_TO_POINTER(request_id));
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+/*
+ * gsr-thumbnailer.h — Keyframe thumbnails for saved recordings.
+ *
+ * Thumbnails are made by a small pool of worker threads, each running an
+ * external decoder (ffmpeg by default) on one file, and kept as PNGs in
+ * a disk cache keyed by path and mtime.  The cache is capped in size;
+ * least recently used thumbnails are deleted first.  Decoded textures
+ * are kept only for a bounded number of recently requested files.
+ *
+ * GSR_THUMBNAILER overrides the decoder command.  "{input}" and
+ * "{output}" in it are replaced by the video file and the PNG to write.
+ */
+
+#include <gtk/gtk.h>
+
+typedef struct _GsrThumbnailer GsrThumbnailer;
+
+/* texture is NULL if no thumbnail could be made. */
+typedef void (*GsrThumbnailFunc)(GdkTexture *texture, gpointer user_data);
+
+/**
+ * cache_dir is created if needed; max_cache_bytes caps the PNGs in it.
+ */
+GsrThumbnailer *gsr_thumbnailer_new    (const char *cache_dir,
+                                        guint64     max_cache_bytes);
+
+/**
+ * Cancel everything and free.  Waits for running decoders to exit.
+ */
+void            gsr_thumbnailer_free   (GsrThumbnailer *self);
+
+/**
+ * Get the thumbnail of path as it was at mtime.  If it is in memory the
+ * callback runs before this returns and 0 is returned; otherwise it runs
+ * later on the main thread, unless the request is cancelled first.
+ * Requests made last are served first.
+ */
+guint           gsr_thumbnailer_request(GsrThumbnailer  *self,
+                                        const char      *path,
+                                        gint64           mtime,
+                                        GsrThumbnailFunc callback,
+                                        gpointer         user_data);
+
+/**
+ * Drop a pending request; its callback won't run.  0 is ignored.
+ */
+void            gsr_thumbnailer_cancel (GsrThumbnailer *self,
+                                        guint           request_id);
@@ -0,0 +1,48 @@
+#include "gsr-trace.h"
+
+#include <stdarg.h>
+
+/* ── Sinks ───────────────────────────────────────────────────────── */
+
+static gboolean
+log_enabled(void)
+{
+    static gsize initialized = 0;
+    static gboolean enabled = FALSE;
+
+    if (g_once_init_enter(&initialized)) {
+        const char *env = g_getenv("GSR_TRACE");
+        enabled = env && *env && !g_str_equal(env, "0");
+        g_once_init_leave(&initialized, 1);
+    }
+    return enabled;
+}
+
+/* ── Public API ──────────────────────────────────────────────────── */
+
+gboolean
+gsr_trace_is_active(void)
+{
+    return log_enabled() || sysprof_collector_is_active();
+}
+
+void
+gsr_trace_mark(gint64      begin_nsec,
+               const char *name,
+               const char *message_format,
+               ...)
+{
+    gint64 duration = SYSPROF_CAPTURE_CURRENT_TIME - begin_nsec;
+
+    va_list args;
+    va_start(args, message_format);
+    g_autofree char *message = g_strdup_vprintf(message_format, args);
+    va_end(args);
+
+    if (sysprof_collector_is_active())
+        sysprof_collector_mark(begin_nsec, duration, "gpu-screen-recorder",
+                               name, message);
+
+    if (log_enabled())
+        g_message("trace: %-22s %9.3f ms  %s", name, duration / 1e6, message);
+}
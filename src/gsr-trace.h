@@ -0,0 +1,50 @@
+#pragma once
+
+/*
+ * gsr-trace.h — Optional Sysprof capture marks on hot paths.
+ *
+ * Built with -Dtracing=true, GSR_TRACE_MARK() records a mark spanning
+ * from `begin` to now.  Marks go to Sysprof when the app runs under it,
+ * and to the log when the GSR_TRACE environment variable is set.
+ * Without the build option both macros compile to nothing.
+ *
+ *     gint64 trace_begin = GSR_TRACE_CURRENT_TIME;
+ *     ...
+ *     GSR_TRACE_MARK(trace_begin, "build_command_args", "mode=%d", mode);
+ */
+
+#include <glib.h>
+
+#ifdef HAVE_SYSPROF
+
+#include <sysprof-capture.h>
+
+#define GSR_TRACE_CURRENT_TIME SYSPROF_CAPTURE_CURRENT_TIME
+
+/**
+ * TRUE when marks have somewhere to go (Sysprof collector or GSR_TRACE).
+ */
+gboolean gsr_trace_is_active(void);
+
+/**
+ * Record a mark that started at begin_nsec (GSR_TRACE_CURRENT_TIME) and
+ * ends now.  Use GSR_TRACE_MARK() rather than calling this directly.
+ */
+void gsr_trace_mark(gint64      begin_nsec,
+                    const char *name,
+                    const char *message_format,
+                    ...) G_GNUC_PRINTF(3, 4);
+
+#define GSR_TRACE_MARK(begin, name, ...)                        \
+    G_STMT_START {                                              \
+        if (gsr_trace_is_active())                              \
+            gsr_trace_mark((begin), (name), __VA_ARGS__);       \
+    } G_STMT_END
+
+#else /* !HAVE_SYSPROF */
+
+#define GSR_TRACE_CURRENT_TIME ((gint64)0)
+#define GSR_TRACE_MARK(begin, name, ...) \
+    G_STMT_START { (void)(begin); } G_STMT_END
+
+#endif /* HAVE_SYSPROF */
@@ -0,0 +1,401 @@
+#include "gsr-window-chooser-dialog.h"
+
+#include <glib/gi18n.h>
+#include <string.h>
+
+/* ═══════════════════════════════════════════════════════════════════
+ *  GsrWindowChooserDialog — pick a window by name instead of by click
+ *
+ *  GListStore of GsrWindowChoice → GtkFilterListModel (GtkCustomFilter
+ *  on a casefolded "name class" key computed once per window) →
+ *  GtkSingleSelection → GtkListView.  The list view only creates rows
+ *  for what's on screen, and typing a longer query tells the filter it
+ *  got stricter, so it rechecks only the windows still shown.
+ *
+ *  The dialog emits "window-chosen" on Enter or on activating a row.
+ * ═══════════════════════════════════════════════════════════════════ */
+
+/* ── List item ───────────────────────────────────────────────────── */
+
+#define GSR_TYPE_WINDOW_CHOICE (gsr_window_choice_get_type())
+G_DECLARE_FINAL_TYPE(GsrWindowChoice, gsr_window_choice, GSR, WINDOW_CHOICE, GObject)
+
+struct _GsrWindowChoice {
+    GObject       parent_instance;
+    unsigned long window;
+    char         *name;
+    char         *wm_class;
+    char         *key;      /* casefolded name and class, for the filter */
+};
+
+G_DEFINE_FINAL_TYPE(GsrWindowChoice, gsr_window_choice, G_TYPE_OBJECT)
+
+static void
+gsr_window_choice_finalize(GObject *object)
+{
+    GsrWindowChoice *self = GSR_WINDOW_CHOICE(object);
+    g_free(self->name);
+    g_free(self->wm_class);
+    g_free(self->key);
+    G_OBJECT_CLASS(gsr_window_choice_parent_class)->finalize(object);
+}
+
+static void
+gsr_window_choice_init(GsrWindowChoice *self)
+{
+    (void)self;
+}
+
+static void
+gsr_window_choice_class_init(GsrWindowChoiceClass *klass)
+{
+    G_OBJECT_CLASS(klass)->finalize = gsr_window_choice_finalize;
+}
+
+static char *
+search_key(const char *text)
+{
+    g_autofree char *normalized = g_utf8_normalize(text, -1, G_NORMALIZE_ALL);
+    return g_utf8_casefold(normalized ? normalized : "", -1);
+}
+
+static GsrWindowChoice *
+gsr_window_choice_new(const GsrX11WindowInfo *info)
+{
+    GsrWindowChoice *self = g_object_new(GSR_TYPE_WINDOW_CHOICE, NULL);
+    self->window = (unsigned long)info->window;
+    self->name = g_strdup(info->name);
+    self->wm_class = g_strdup(info->wm_class);
+    g_autofree char *text = g_strconcat(info->name, " ", info->wm_class, NULL);
+    self->key = search_key(text);
+    return self;
+}
+
+/* ── Dialog ──────────────────────────────────────────────────────── */
+
+struct _GsrWindowChooserDialog {
+    AdwDialog           parent_instance;
+
+    GListStore         *store;      /* GsrWindowChoice */
+    GtkCustomFilter    *filter;
+    GtkFilterListModel *filtered;
+    GtkSingleSelection *selection;
+    char               *query;      /* casefolded, "" shows all */
+
+    GtkSearchEntry     *search_entry;
+    GtkStack           *stack;      /* "list" / "empty" */
+
+    unsigned long       chosen_window;
+    char               *chosen_name;
+};
+
+G_DEFINE_FINAL_TYPE(GsrWindowChooserDialog, gsr_window_chooser_dialog, ADW_TYPE_DIALOG)
+
+/* ── Signals ─────────────────────────────────────────────────────── */
+
+enum {
+    SIGNAL_WINDOW_CHOSEN,
+    N_SIGNALS
+};
+
+static guint signals[N_SIGNALS];
+
+/* ── Filtering ───────────────────────────────────────────────────── */
+
+static gboolean
+filter_window(gpointer item, gpointer user_data)
+{
+    GsrWindowChooserDialog *self = user_data;
+    return self->query[0] == '\0' ||
+           strstr(GSR_WINDOW_CHOICE(item)->key, self->query) != NULL;
+}
+
+static void
+on_search_changed(GtkSearchEntry *entry, gpointer user_data)
+{
+    GsrWindowChooserDialog *self = GSR_WINDOW_CHOOSER_DIALOG(user_data);
+
+    char *query = search_key(gtk_editable_get_text(GTK_EDITABLE(entry)));
+    GtkFilterChange change = GTK_FILTER_CHANGE_DIFFERENT;
+    if (strstr(query, self->query))
+        change = GTK_FILTER_CHANGE_MORE_STRICT;
+    else if (strstr(self->query, query))
+        change = GTK_FILTER_CHANGE_LESS_STRICT;
+    g_free(self->query);
+    self->query = query;
+
+    gtk_filter_changed(GTK_FILTER(self->filter), change);
+}
+
+static void
+on_filtered_items_changed(GListModel *model,
+                          guint       position G_GNUC_UNUSED,
+                          guint       removed G_GNUC_UNUSED,
+                          guint       added G_GNUC_UNUSED,
+                          gpointer    user_data)
+{
+    GsrWindowChooserDialog *self = GSR_WINDOW_CHOOSER_DIALOG(user_data);
+    gtk_stack_set_visible_child_name(self->stack,
+        g_list_model_get_n_items(model) > 0 ? "list" : "empty");
+}
+
+/* ── Choosing ────────────────────────────────────────────────────── */
+
+static void
+choose(GsrWindowChooserDialog *self, GsrWindowChoice *choice)
+{
+    if (!choice)
+        return;
+
+    self->chosen_window = choice->window;
+    g_set_str(&self->chosen_name, choice->name);
+    g_signal_emit(self, signals[SIGNAL_WINDOW_CHOSEN], 0);
+    adw_dialog_close(ADW_DIALOG(self));
+}
+
+static void
+on_row_activated(GtkListView *view G_GNUC_UNUSED, guint position, gpointer user_data)
+{
+    GsrWindowChooserDialog *self = GSR_WINDOW_CHOOSER_DIALOG(user_data);
+    g_autoptr(GsrWindowChoice) choice =
+        g_list_model_get_item(G_LIST_MODEL(self->selection), position);
+    choose(self, choice);
+}
+
+/* Enter in the search entry takes the selected match, the first by default */
+static void
+on_search_activate(GtkSearchEntry *entry G_GNUC_UNUSED, gpointer user_data)
+{
+    GsrWindowChooserDialog *self = GSR_WINDOW_CHOOSER_DIALOG(user_data);
+    choose(self, gtk_single_selection_get_selected_item(self->selection));
+}
+
+static void
+on_stop_search(GtkSearchEntry *entry G_GNUC_UNUSED, gpointer user_data)
+{
+    adw_dialog_close(ADW_DIALOG(user_data));
+}
+
+/* ── Row factory ─────────────────────────────────────────────────── */
+
+static void
+on_setup_row(GtkSignalListItemFactory *factory G_GNUC_UNUSED,
+             GtkListItem              *item,
+             gpointer                  user_data G_GNUC_UNUSED)
+{
+    GtkBox *box = GTK_BOX(gtk_box_new(GTK_ORIENTATION_VERTICAL, 2));
+    gtk_widget_set_margin_start(GTK_WIDGET(box), 12);
+    gtk_widget_set_margin_end(GTK_WIDGET(box), 12);
+    gtk_widget_set_margin_top(GTK_WIDGET(box), 8);
+    gtk_widget_set_margin_bottom(GTK_WIDGET(box), 8);
+
+    GtkLabel *name = GTK_LABEL(gtk_label_new(NULL));
+    gtk_label_set_xalign(name, 0);
+    gtk_label_set_ellipsize(name, PANGO_ELLIPSIZE_END);
+    gtk_box_append(box, GTK_WIDGET(name));
+
+    GtkLabel *wm_class = GTK_LABEL(gtk_label_new(NULL));
+    gtk_label_set_xalign(wm_class, 0);
+    gtk_label_set_ellipsize(wm_class, PANGO_ELLIPSIZE_END);
+    gtk_widget_add_css_class(GTK_WIDGET(wm_class), "caption");
+    gtk_widget_add_css_class(GTK_WIDGET(wm_class), "dim-label");
+    gtk_box_append(box, GTK_WIDGET(wm_class));
+
+    gtk_list_item_set_child(item, GTK_WIDGET(box));
+}
+
+static void
+on_bind_row(GtkSignalListItemFactory *factory G_GNUC_UNUSED,
+            GtkListItem              *item,
+            gpointer                  user_data G_GNUC_UNUSED)
+{
+    GsrWindowChoice *choice = gtk_list_item_get_item(item);
+    GtkWidget *name = gtk_widget_get_first_child(gtk_list_item_get_child(item));
+    GtkWidget *wm_class = gtk_widget_get_next_sibling(name);
+
+    gtk_label_set_text(GTK_LABEL(name), choice->name[0] ? choice->name : _("(no name)"));
+    g_autofree char *detail = g_strdup_printf("%s  0x%lx", choice->wm_class, choice->window);
+    gtk_label_set_text(GTK_LABEL(wm_class), g_strstrip(detail));
+}
+
+/* ── GObject lifecycle ───────────────────────────────────────────── */
+
+static void
+gsr_window_chooser_dialog_dispose(GObject *object)
+{
+    GsrWindowChooserDialog *self = GSR_WINDOW_CHOOSER_DIALOG(object);
+    /* The list view outlives this; stop its models calling back into us */
+    if (self->filter)
+        gtk_custom_filter_set_filter_func(self->filter, NULL, NULL, NULL);
+    if (self->filtered)
+        g_signal_handlers_disconnect_by_data(self->filtered, self);
+    g_clear_object(&self->selection);
+    g_clear_object(&self->filtered);
+    g_clear_object(&self->filter);
+    g_clear_object(&self->store);
+    G_OBJECT_CLASS(gsr_window_chooser_dialog_parent_class)->dispose(object);
+}
+
+static void
+gsr_window_chooser_dialog_finalize(GObject *object)
+{
+    GsrWindowChooserDialog *self = GSR_WINDOW_CHOOSER_DIALOG(object);
+    g_free(self->query);
+    g_free(self->chosen_name);
+    G_OBJECT_CLASS(gsr_window_chooser_dialog_parent_class)->finalize(object);
+}
+
+static void
+gsr_window_chooser_dialog_init(GsrWindowChooserDialog *self)
+{
+    self->query = g_strdup("");
+}
+
+static void
+gsr_window_chooser_dialog_class_init(GsrWindowChooserDialogClass *klass)
+{
+    GObjectClass *obj_class = G_OBJECT_CLASS(klass);
+    obj_class->dispose = gsr_window_chooser_dialog_dispose;
+    obj_class->finalize = gsr_window_chooser_dialog_finalize;
+
+    /**
+     * GsrWindowChooserDialog::window-chosen:
+     *
+     * Emitted when the user picks a window.  Call get_window() and
+     * get_window_name() to retrieve it.
+     */
+    signals[SIGNAL_WINDOW_CHOSEN] = g_signal_new(
+        "window-chosen",
+        G_TYPE_FROM_CLASS(klass),
+        G_SIGNAL_RUN_LAST,
+        0, NULL, NULL, NULL,
+        G_TYPE_NONE, 0);
+}
+
+/* ── Build UI ────────────────────────────────────────────────────── */
+
+static void
+build_dialog_ui(GsrWindowChooserDialog *self)
+{
+    adw_dialog_set_title(ADW_DIALOG(self), _("Choose Window"));
+    adw_dialog_set_content_width(ADW_DIALOG(self), 460);
+    adw_dialog_set_content_height(ADW_DIALOG(self), 520);
+
+    /* ── Header bar with the search entry ─── */
+    AdwHeaderBar *header = ADW_HEADER_BAR(adw_header_bar_new());
+    self->search_entry = GTK_SEARCH_ENTRY(gtk_search_entry_new());
+    gtk_search_entry_set_placeholder_text(self->search_entry, _("Search windows"));
+    gtk_widget_set_hexpand(GTK_WIDGET(self->search_entry), TRUE);
+    g_signal_connect(self->search_entry, "search-changed",
+        G_CALLBACK(on_search_changed), self);
+    g_signal_connect(self->search_entry, "activate",
+        G_CALLBACK(on_search_activate), self);
+    g_signal_connect(self->search_entry, "stop-search",
+        G_CALLBACK(on_stop_search), self);
+    /* Typing anywhere in the dialog searches */
+    gtk_search_entry_set_key_capture_widget(self->search_entry, GTK_WIDGET(self));
+    adw_header_bar_set_title_widget(header, GTK_WIDGET(self->search_entry));
+
+    /* ── Models ─── */
+    self->store = g_list_store_new(GSR_TYPE_WINDOW_CHOICE);
+    self->filter = gtk_custom_filter_new(filter_window, self, NULL);
+    self->filtered = gtk_filter_list_model_new(G_LIST_MODEL(g_object_ref(self->store)),
+                                               GTK_FILTER(g_object_ref(self->filter)));
+    self->selection = gtk_single_selection_new(G_LIST_MODEL(g_object_ref(self->filtered)));
+    g_signal_connect(self->filtered, "items-changed",
+        G_CALLBACK(on_filtered_items_changed), self);
+
+    /* ── List ─── */
+    GtkListItemFactory *factory = gtk_signal_list_item_factory_new();
+    g_signal_connect(factory, "setup", G_CALLBACK(on_setup_row), NULL);
+    g_signal_connect(factory, "bind", G_CALLBACK(on_bind_row), NULL);
+
+    GtkListView *view = GTK_LIST_VIEW(gtk_list_view_new(
+        GTK_SELECTION_MODEL(g_object_ref(self->selection)), factory));
+    gtk_list_view_set_single_click_activate(view, TRUE);
+    gtk_widget_add_css_class(GTK_WIDGET(view), "navigation-sidebar");
+    g_signal_connect(view, "activate", G_CALLBACK(on_row_activated), self);
+
+    GtkScrolledWindow *scroller = GTK_SCROLLED_WINDOW(gtk_scrolled_window_new());
+    gtk_scrolled_window_set_policy(scroller, GTK_POLICY_NEVER, GTK_POLICY_AUTOMATIC);
+    gtk_scrolled_window_set_child(scroller, GTK_WIDGET(view));
+
+    AdwStatusPage *empty = ADW_STATUS_PAGE(adw_status_page_new());
+    adw_status_page_set_icon_name(empty, "edit-find-symbolic");
+    adw_status_page_set_title(empty, _("No Windows Found"));
+    adw_status_page_set_description(empty,
+        _("Only windows listed by the window manager can be chosen here"));
+
+    self->stack = GTK_STACK(gtk_stack_new());
+    gtk_stack_add_named(self->stack, GTK_WIDGET(scroller), "list");
+    gtk_stack_add_named(self->stack, GTK_WIDGET(empty), "empty");
+    gtk_stack_set_visible_child_name(self->stack, "empty");
+
+    /* ── Layout: toolbar-view ─── */
+    AdwToolbarView *toolbar_view = ADW_TOOLBAR_VIEW(adw_toolbar_view_new());
+    adw_toolbar_view_add_top_bar(toolbar_view, GTK_WIDGET(header));
+    adw_toolbar_view_set_content(toolbar_view, GTK_WIDGET(self->stack));
+
+    adw_dialog_set_child(ADW_DIALOG(self), GTK_WIDGET(toolbar_view));
+    adw_dialog_set_focus(ADW_DIALOG(self), GTK_WIDGET(self->search_entry));
+}
+
+/* ── Public API ──────────────────────────────────────────────────── */
+
+GsrWindowChooserDialog *
+gsr_window_chooser_dialog_new(GsrX11WindowList *list)
+{
+    GsrWindowChooserDialog *self = g_object_new(
+        GSR_TYPE_WINDOW_CHOOSER_DIALOG, NULL);
+
+    build_dialog_ui(self);
+    gsr_window_chooser_dialog_update(self, list);
+
+    return self;
+}
+
+void
+gsr_window_chooser_dialog_update(GsrWindowChooserDialog *self,
+                                 GsrX11WindowList       *list)
+{
+    g_return_if_fail(GSR_IS_WINDOW_CHOOSER_DIALOG(self));
+
+    GsrWindowChoice *selected = gtk_single_selection_get_selected_item(self->selection);
+    unsigned long selected_window = selected ? selected->window : 0;
+
+    /* Newest first: the window just opened is the likely pick */
+    guint n = list ? gsr_x11_window_list_get_n(list) : 0;
+    GPtrArray *choices = g_ptr_array_new_full(n, g_object_unref);
+    for (guint i = n; i > 0; i--)
+        g_ptr_array_add(choices, gsr_window_choice_new(gsr_x11_window_list_get(list, i - 1)));
+
+    /* One splice: the filter and the view see a single change */
+    g_list_store_splice(self->store, 0, g_list_model_get_n_items(G_LIST_MODEL(self->store)),
+                        choices->pdata, choices->len);
+    g_ptr_array_unref(choices);
+
+    if (selected_window == 0)
+        return;
+    guint n_shown = g_list_model_get_n_items(G_LIST_MODEL(self->filtered));
+    for (guint i = 0; i < n_shown; i++) {
+        g_autoptr(GsrWindowChoice) choice = g_list_model_get_item(G_LIST_MODEL(self->filtered), i);
+        if (choice->window == selected_window) {
+            gtk_single_selection_set_selected(self->selection, i);
+            break;
+        }
+    }
+}
+
+unsigned long
+gsr_window_chooser_dialog_get_window(GsrWindowChooserDialog *self)
+{
+    g_return_val_if_fail(GSR_IS_WINDOW_CHOOSER_DIALOG(self), 0);
+    return self->chosen_window;
+}
+
+const char *
+gsr_window_chooser_dialog_get_window_name(GsrWindowChooserDialog *self)
+{
+    g_return_val_if_fail(GSR_IS_WINDOW_CHOOSER_DIALOG(self), NULL);
+    return self->chosen_name;
+}
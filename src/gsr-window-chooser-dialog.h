@@ -0,0 +1,41 @@
+#pragma once
+
+/*
+ * gsr-window-chooser-dialog.h — Searchable list of the open windows.
+ *
+ * AdwDialog over a GsrX11WindowList.  Typing filters by window name and
+ * class; Enter or a click chooses.  Keep it current by passing every
+ * change of the list to gsr_window_chooser_dialog_update().
+ *
+ * X11 only.
+ */
+
+#include <adwaita.h>
+
+#include "gsr-x11-window-list.h"
+
+G_BEGIN_DECLS
+
+#define GSR_TYPE_WINDOW_CHOOSER_DIALOG (gsr_window_chooser_dialog_get_type())
+G_DECLARE_FINAL_TYPE(GsrWindowChooserDialog, gsr_window_chooser_dialog,
+                     GSR, WINDOW_CHOOSER_DIALOG, AdwDialog)
+
+/**
+ * Create a chooser showing the windows of list.  The list isn't kept.
+ */
+GsrWindowChooserDialog *gsr_window_chooser_dialog_new(GsrX11WindowList *list);
+
+/**
+ * Show the current contents of list, keeping the query and selection.
+ */
+void gsr_window_chooser_dialog_update(GsrWindowChooserDialog *self,
+                                      GsrX11WindowList       *list);
+
+/**
+ * The window chosen, valid once "window-chosen" was emitted.  The name
+ * is borrowed, valid until the dialog is destroyed.
+ */
+unsigned long gsr_window_chooser_dialog_get_window     (GsrWindowChooserDialog *self);
+const char   *gsr_window_chooser_dialog_get_window_name(GsrWindowChooserDialog *self);
+
+G_END_DECLS
@@ -1,25 +1,70 @@
 #include "gsr-window.h"
 
 #include <errno.h>
+#include <fcntl.h>
 #include <signal.h>
+#include <stdio.h>
+#include <sys/stat.h>
 #include <sys/wait.h>
 #include <time.h>
 #include <unistd.h>
 
+#include <glib-unix.h>
 #include <glib/gi18n.h>
 
+#include "gsr-child-output.h"
 #include "gsr-config-page.h"
 #include "gsr-config.h"
+#include "gsr-encode-stats.h"
 #include "gsr-hotkeys.h"
 #include "gsr-info.h"
+#include "gsr-job-queue.h"
+#include "gsr-latency-histogram.h"
+#include "gsr-library-page.h"
+#include "gsr-monitor-split.h"
 #include "gsr-record-page.h"
+#include "gsr-replay-budget.h"
 #include "gsr-replay-page.h"
+#include "gsr-replay-trim.h"
+#include "gsr-segment-index.h"
+#include "gsr-stream-health.h"
 #include "gsr-stream-page.h"
+#include "gsr-stream-relay.h"
+#include "gsr-trace.h"
 
 #ifdef __linux__
 #include <sys/prctl.h>
 #endif
 
+typedef enum {
+    CHILD_IDLE,         /* no child */
+    CHILD_STARTING,     /* forked, may not handle signals yet */
+    CHILD_RUNNING,
+    CHILD_STOPPING,     /* SIGINT sent, waiting to reap */
+} ChildState;
+
+/* The previous segment's recorder, stopped once the next one runs */
+typedef struct {
+    pid_t               pid;                /* -1 if none */
+    int                 sequence;
+    gboolean            stopping;           /* SIGINT sent */
+    guint               watch_id;
+    char               *filename;           /* owned */
+    GsrChildOutput     *out;
+    GsrChildOutput     *err;
+} RetiringSegment;
+
+/* Another monitor's recorder in a multi-monitor recording */
+typedef struct {
+    pid_t               pid;
+    gboolean            stopping;           /* SIGINT sent */
+    guint               watch_id;
+    char               *monitor;            /* owned */
+    char               *filename;           /* owned */
+    GsrChildOutput     *out;
+    GsrChildOutput     *err;
+} MonitorChild;
+
 struct _GsrWindow {
     AdwApplicationWindow parent_instance;
 
@@ -43,11 +88,18 @@ struct _GsrWindow {
     /* Config (owned, lifetime = window) */
     GsrConfig           config;
 
-    /* Pages */
+    /* Pages.  Only the Config page is built eagerly; the action pages are
+       created on first visit (or first hotkey use) inside their AdwBin
+       placeholder and stay NULL until then. */
     GsrConfigPage      *config_page;
     GsrStreamPage      *stream_page;
     GsrRecordPage      *record_page;
     GsrReplayPage      *replay_page;
+    GsrLibraryPage     *library_page;
+    AdwBin             *stream_bin;
+    AdwBin             *record_bin;
+    AdwBin             *replay_bin;
+    AdwBin             *library_bin;
 
     /* ── Hamburger menu ─── */
     GMenu              *primary_menu;       /* top-level menu model */
@@ -58,14 +110,76 @@ struct _GsrWindow {
     GsrHotkeys         *hotkeys;
 #ifdef HAVE_WAYLAND
     gboolean            wayland_shortcuts_registered;
+    gboolean            wayland_hotkeys_init_done;  /* portal answered */
+    gboolean            wayland_hotkeys_supported;  /* replayed on lazy pages */
 #endif
 
+    /* ── Hotkey latency (event time → fork()/kill()) ─── */
+    GsrLatencyHistogram hotkey_latency;
+    gint64              hotkey_event_time;  /* pending sample, 0 if none */
+    const char         *hotkey_backend;     /* "x11" / "wayland", static */
+
     /* ── Process management ─── */
     pid_t               child_pid;          /* -1 when idle */
+    ChildState          child_state;
     int                 prev_exit_status;
     GsrActiveMode       active_mode;
     char               *record_filename;    /* owned, recording only */
-    guint               poll_timer_id;      /* 500ms poll timer */
+    char               *stream_filename;    /* owned, local copy of a stream */
+    guint               child_watch_id;     /* reaps child_pid */
+    GsrChildOutput     *child_stdout;       /* saved replay paths */
+    GsrChildOutput     *child_stderr;       /* fps reports, errors */
+    guint               settle_timer_id;    /* STARTING → RUNNING */
+    gint64              stop_trace_begin;
+
+    /* ── Action queue (coalesced start/stop/save requests) ─── */
+    gboolean            want_running;
+    GsrActiveMode       want_mode;
+    gint64              last_save_time;     /* last replay save, monotonic µs */
+    int                 last_save_seconds;  /* what it covered, 0 = whole buffer */
+    int                 replay_buffer_seconds; /* -r of the running replay */
+    GQueue              pending_trims;      /* per save sent, seconds to cut its file to */
+    GCancellable       *trim_cancellable;
+
+    /* ── Replay buffer budget (RSS vs. estimate) ─── */
+    guint               rss_timer_id;
+    gint64              replay_bytes_per_second; /* uncorrected, running replay */
+    int                 replay_seconds;     /* 0 if not sampling */
+    gint64              rss_baseline;       /* -1 until the first sample */
+
+    /* ── Live encode statistics ─── */
+    GsrEncodeStats      encode_stats;
+    guint               stats_timer_id;
+
+    /* ── Adaptive streaming bitrate ─── */
+    GsrStreamHealth     stream_health;
+    gboolean            adaptive_bitrate;   /* the running stream adapts */
+    gboolean            restart_pending;    /* respawn at the current tier */
+
+    /* ── Simulcast ─── */
+    GsrStreamRelay     *relay;              /* streaming to several URLs */
+
+    /* ── Segmented recording ─── */
+    int                 segment_seconds;    /* split after, 0 = never */
+    gint64              segment_bytes;      /* split at, 0 = never */
+    int                 segment_sequence;   /* current segment, 0 if not split */
+    int                 segment_ticks;      /* stats ticks recorded, not paused */
+    time_t              segment_time;       /* recording start, names segments */
+    gboolean            rotating;           /* spawning the next segment */
+    gboolean            paused;             /* recording paused (SIGUSR2) */
+    GsrSegmentIndex    *segment_index;
+    RetiringSegment     retiring;
+
+    /* ── Multi-monitor recording ─── */
+    char              **multi_monitors;     /* recording these at once, else NULL */
+    GArray             *monitor_children;   /* MonitorChild, all but the first monitor */
+    time_t              multi_time;         /* recording start, names all the files */
+    const char         *capture_monitor;    /* replaces the record area, borrowed */
+    int                 capture_fps;        /* replaces the frame rate, 0 if not */
+    int                 capture_kbps;       /* constant bitrate instead, 0 if not */
+
+    /* ── Post-processing of saved files ─── */
+    GsrJobQueue        *jobs;
 
     /* ── Desktop notifications ─── */
     gboolean            showing_notification;
@@ -82,6 +196,7 @@ G_DEFINE_FINAL_TYPE(GsrWindow, gsr_window, ADW_TYPE_APPLICATION_WINDOW)
 /* ── Forward declarations ────────────────────────────────────────── */
 
 static void handle_child_death(GsrWindow *self, int exit_status);
+static void set_page_inactive(GsrWindow *self, GsrActiveMode mode);
 static void send_notification(GsrWindow *self, const char *title,
                               const char *body, GNotificationPriority priority);
 
@@ -98,6 +213,45 @@ active_mode_to_string(GsrActiveMode mode)
     }
 }
 
+/* ── Startup milestones (bench/startup.py) ───────────────────────── */
+
+/*
+ * When GSR_STARTUP_TRACE names a file, append "<milestone> <usec>" with a
+ * CLOCK_MONOTONIC timestamp so the startup benchmark can time us without
+ * scraping logs.  Does nothing in normal runs.
+ */
+static void
+startup_mark(const char *milestone)
+{
+    const char *path = g_getenv("GSR_STARTUP_TRACE");
+    if (!path || !*path)
+        return;
+
+    FILE *f = fopen(path, "a");
+    if (!f)
+        return;
+    fprintf(f, "%s %" G_GINT64_FORMAT "\n", milestone, g_get_monotonic_time());
+    fclose(f);
+}
+
+static void
+on_first_frame_painted(GdkFrameClock *clock, gpointer user_data)
+{
+    g_signal_handlers_disconnect_by_func(clock, on_first_frame_painted, user_data);
+    startup_mark("first_frame");
+}
+
+static void
+on_first_map(GtkWidget *widget, gpointer user_data G_GNUC_UNUSED)
+{
+    g_signal_handlers_disconnect_by_func(widget, on_first_map, NULL);
+
+    GdkFrameClock *clock = gtk_widget_get_frame_clock(widget);
+    if (clock)
+        g_signal_connect(clock, "after-paint",
+            G_CALLBACK(on_first_frame_painted), widget);
+}
+
 /* ── Desktop notification helpers ────────────────────────────────── */
 
 /**
@@ -139,6 +293,7 @@ send_notification_full(GsrWindow *self, const char *title,
                        const char *body, GNotificationPriority priority,
                        const char *open_file_path)
 {
+    gint64 trace_begin = GSR_TRACE_CURRENT_TIME;
     GtkApplication *app = GTK_APPLICATION(
         gtk_window_get_application(GTK_WINDOW(self)));
     if (!app)
@@ -185,6 +340,8 @@ send_notification_full(GsrWindow *self, const char *title,
             g_variant_new_string(open_file_path));
     }
     adw_toast_overlay_add_toast(self->toast_overlay, toast);
+
+    GSR_TRACE_MARK(trace_begin, "send_notification_full", "priority=%d", effective);
 }
 
 static void
@@ -194,6 +351,173 @@ send_notification(GsrWindow *self, const char *title,
     send_notification_full(self, title, body, priority, NULL);
 }
 
+/* ── Lazy action pages ───────────────────────────────────────────── */
+
+/*
+ * Build each action page the first time it is needed and fill it from
+ * self->config.  Until then the page's settings live only in the config
+ * struct, which save_config() writes back untouched.
+ */
+
+static GsrStreamPage *
+ensure_stream_page(GsrWindow *self)
+{
+    if (self->stream_page)
+        return self->stream_page;
+
+    self->stream_page = gsr_stream_page_new(&self->info);
+    gsr_stream_page_apply_config(self->stream_page, &self->config);
+#ifdef HAVE_WAYLAND
+    if (self->wayland_hotkeys_init_done)
+        gsr_stream_page_set_wayland_hotkeys_supported(self->stream_page,
+            self->wayland_hotkeys_supported);
+#endif
+    adw_bin_set_child(self->stream_bin, GTK_WIDGET(self->stream_page));
+    return self->stream_page;
+}
+
+static GsrRecordPage *
+ensure_record_page(GsrWindow *self)
+{
+    if (self->record_page)
+        return self->record_page;
+
+    self->record_page = gsr_record_page_new(&self->info);
+    gsr_record_page_apply_config(self->record_page, &self->config);
+#ifdef HAVE_WAYLAND
+    if (self->wayland_hotkeys_init_done)
+        gsr_record_page_set_wayland_hotkeys_supported(self->record_page,
+            self->wayland_hotkeys_supported);
+#endif
+    adw_bin_set_child(self->record_bin, GTK_WIDGET(self->record_page));
+    return self->record_page;
+}
+
+static GsrReplayPage *
+ensure_replay_page(GsrWindow *self)
+{
+    if (self->replay_page)
+        return self->replay_page;
+
+    self->replay_page = gsr_replay_page_new(&self->info);
+    gsr_replay_page_apply_config(self->replay_page, &self->config);
+#ifdef HAVE_WAYLAND
+    if (self->wayland_hotkeys_init_done)
+        gsr_replay_page_set_wayland_hotkeys_supported(self->replay_page,
+            self->wayland_hotkeys_supported);
+#endif
+    adw_bin_set_child(self->replay_bin, GTK_WIDGET(self->replay_page));
+    return self->replay_page;
+}
+
+/* The library opens its index and starts watching the save directories
+   only when first shown. */
+static GsrLibraryPage *
+ensure_library_page(GsrWindow *self)
+{
+    if (self->library_page)
+        return self->library_page;
+
+    g_autofree char *config_dir = gsr_config_get_dir();
+    g_autofree char *index_path = g_build_filename(config_dir, "library-index", NULL);
+    self->library_page = gsr_library_page_new(index_path);
+    gsr_library_page_apply_config(self->library_page, &self->config);
+    adw_bin_set_child(self->library_bin, GTK_WIDGET(self->library_page));
+    return self->library_page;
+}
+
+/* Build the action page named by the view stack, if it is one. */
+static void
+ensure_page_by_name(GsrWindow *self, const char *page)
+{
+    if (!page)
+        return;
+
+    if (g_str_equal(page, "stream"))
+        ensure_stream_page(self);
+    else if (g_str_equal(page, "record"))
+        ensure_record_page(self);
+    else if (g_str_equal(page, "replay"))
+        ensure_replay_page(self);
+    else if (g_str_equal(page, "library"))
+        ensure_library_page(self);
+}
+
+/* ── Hotkey latency ──────────────────────────────────────────────── */
+
+/*
+ * The histogram summary is the state of the "win.hotkey-latency" action,
+ * so it can be read over D-Bus (org.gtk.Actions.Describe on the window's
+ * object path) as well as shown in the UI.
+ */
+static void
+update_hotkey_latency_state(GsrWindow *self)
+{
+    GAction *action = g_action_map_lookup_action(G_ACTION_MAP(self), "hotkey-latency");
+    if (!action)
+        return;
+
+    const GsrLatencyHistogram *h = &self->hotkey_latency;
+    GVariantBuilder b;
+    g_variant_builder_init(&b, G_VARIANT_TYPE_VARDICT);
+    g_variant_builder_add(&b, "{sv}", "backend",
+        g_variant_new_string(self->hotkey_backend ? self->hotkey_backend : ""));
+    g_variant_builder_add(&b, "{sv}", "count", g_variant_new_uint64(h->total));
+    g_variant_builder_add(&b, "{sv}", "min-ms", g_variant_new_double(h->min_us / 1000.0));
+    g_variant_builder_add(&b, "{sv}", "p50-ms",
+        g_variant_new_double(gsr_latency_histogram_percentile(h, 50.0) / 1000.0));
+    g_variant_builder_add(&b, "{sv}", "p90-ms",
+        g_variant_new_double(gsr_latency_histogram_percentile(h, 90.0) / 1000.0));
+    g_variant_builder_add(&b, "{sv}", "p99-ms",
+        g_variant_new_double(gsr_latency_histogram_percentile(h, 99.0) / 1000.0));
+    g_variant_builder_add(&b, "{sv}", "max-ms", g_variant_new_double(h->max_us / 1000.0));
+
+    g_simple_action_set_state(G_SIMPLE_ACTION(action), g_variant_builder_end(&b));
+}
+
+/* Call right before the fork()/kill() a hotkey results in. */
+static void
+hotkey_action_issued(GsrWindow *self)
+{
+    if (self->hotkey_event_time == 0)
+        return;
+
+    gsr_latency_histogram_record(&self->hotkey_latency,
+        g_get_monotonic_time() - self->hotkey_event_time);
+    self->hotkey_event_time = 0;
+    update_hotkey_latency_state(self);
+}
+
+static void
+on_show_hotkey_latency(GSimpleAction *action G_GNUC_UNUSED,
+                       GVariant      *parameter G_GNUC_UNUSED,
+                       gpointer       user_data)
+{
+    GsrWindow *self = GSR_WINDOW(user_data);
+    const GsrLatencyHistogram *h = &self->hotkey_latency;
+
+    g_autofree char *body = NULL;
+    if (h->total == 0) {
+        body = g_strdup(_("No hotkey has started, stopped or signalled a "
+            "capture yet in this session."));
+    } else {
+        body = g_strdup_printf(
+            _("Time from key event to the recorder being started or signalled.\n\n"
+              "Backend: %s\nSamples: %" G_GUINT64_FORMAT "\n"
+              "Median: %.1f ms\n90th percentile: %.1f ms\n"
+              "99th percentile: %.1f ms\nWorst: %.1f ms"),
+            self->hotkey_backend, h->total,
+            gsr_latency_histogram_percentile(h, 50.0) / 1000.0,
+            gsr_latency_histogram_percentile(h, 90.0) / 1000.0,
+            gsr_latency_histogram_percentile(h, 99.0) / 1000.0,
+            h->max_us / 1000.0);
+    }
+
+    AdwDialog *dlg = adw_alert_dialog_new(_("Hotkey Latency"), body);
+    adw_alert_dialog_add_response(ADW_ALERT_DIALOG(dlg), "close", _("Close"));
+    adw_dialog_present(dlg, GTK_WIDGET(self));
+}
+
 /* ── Container compatibility fix ─────────────────────────────────── */
 
 static const char *
@@ -229,7 +553,8 @@ resolve_codec_and_encoder(GsrWindow *self, const char **out_codec,
     }
 
     if (g_str_equal(selected, "auto")) {
-        const char *hw = gsr_info_get_first_usable_hw_video_codec(&self->info);
+        const char *hw = gsr_info_get_first_usable_hw_video_codec(&self->info,
+            gsr_config_page_get_gpu_card(self->config_page));
         if (hw) {
             *out_codec = hw;
         } else {
@@ -243,19 +568,165 @@ resolve_codec_and_encoder(GsrWindow *self, const char **out_codec,
     *out_codec = selected;
 }
 
+/* ── Replay buffer budget ────────────────────────────────────────── */
+
+/* Output size the encoder will see; a guess for window/portal capture */
+static void
+get_capture_size(GsrWindow *self, int *width, int *height)
+{
+    const char *area_id = self->capture_monitor ? self->capture_monitor
+                        : gsr_config_page_get_record_area_id(self->config_page);
+
+    if (g_str_equal(area_id, "focused")) {
+        *width = gsr_config_page_get_area_width(self->config_page);
+        *height = gsr_config_page_get_area_height(self->config_page);
+        return;
+    }
+
+    if (gsr_config_page_get_change_video_resolution(self->config_page)) {
+        *width = gsr_config_page_get_video_width(self->config_page);
+        *height = gsr_config_page_get_video_height(self->config_page);
+        if (*width > 0 && *height > 0)
+            return;
+    }
+
+    int region_x, region_y;
+    if (g_str_equal(area_id, "region") &&
+        gsr_config_page_get_region(self->config_page, &region_x, &region_y, width, height))
+        return;
+
+    /* The named monitor, else the largest one */
+    const GsrSupportedCaptureOptions *opts = &self->info.supported_capture_options;
+    *width = 1920;
+    *height = 1080;
+    gint64 largest = 0;
+    for (int i = 0; i < opts->n_monitors; i++) {
+        const GsrMonitor *mon = &opts->monitors[i];
+        if (g_strcmp0(mon->name, area_id) == 0) {
+            *width = mon->width;
+            *height = mon->height;
+            return;
+        }
+        if ((gint64)mon->width * mon->height > largest) {
+            largest = (gint64)mon->width * mon->height;
+            *width = mon->width;
+            *height = mon->height;
+        }
+    }
+}
+
+static gint64
+replay_bytes_per_second(GsrWindow *self)
+{
+    const char *codec = NULL;
+    gboolean use_software = FALSE;
+    resolve_codec_and_encoder(self, &codec, &use_software);
+
+    gboolean merge = !gsr_config_page_get_split_audio(self->config_page);
+    GPtrArray *audio_tracks = gsr_config_page_build_audio_args(self->config_page, merge);
+
+    GsrReplayStream stream = {
+        .codec          = codec,
+        .quality        = gsr_config_page_get_quality_id(self->config_page),
+        .bitrate_kbps   = gsr_config_page_get_video_bitrate(self->config_page),
+        .fps            = gsr_config_page_get_fps(self->config_page),
+        .n_audio_tracks = (int)audio_tracks->len,
+    };
+    get_capture_size(self, &stream.width, &stream.height);
+    g_ptr_array_unref(audio_tracks);
+
+    return gsr_replay_budget_bytes_per_second(&stream);
+}
+
+/* Shorten a RAM replay buffer that wouldn't fit next to everything else */
+static int
+fit_replay_time_in_ram(GsrWindow *self, int seconds)
+{
+    gint64 available = gsr_replay_budget_available_ram();
+    gint64 per_second = gsr_window_estimate_replay_bytes(self, 1);
+    if (available < 0 || per_second <= 0)
+        return seconds;
+
+    gint64 budget = available * GSR_REPLAY_RAM_BUDGET_PERCENT / 100;
+    if (per_second * seconds <= budget)
+        return seconds;
+
+    int fit = (int)MAX(budget / per_second, GSR_REPLAY_MIN_SECONDS);
+    if (fit >= seconds)
+        return seconds;
+
+    g_autofree char *msg = g_strdup_printf(
+        _("Replay shortened to %d seconds to fit in memory"), fit);
+    gsr_window_show_toast(self, msg);
+    return fit;
+}
+
+/*
+ * Measure how big the buffer really got: RSS once the encoder is up,
+ * and again when the buffer has filled, against the estimate for the
+ * same span.  One measurement per replay session refines the scale.
+ */
+#define RSS_BASELINE_SECONDS  5
+
+static gboolean
+on_rss_sample(gpointer user_data)
+{
+    GsrWindow *self = GSR_WINDOW(user_data);
+    self->rss_timer_id = 0;
+
+    if (self->child_pid <= 0 || self->active_mode != GSR_ACTIVE_MODE_REPLAY)
+        return G_SOURCE_REMOVE;
+
+    gint64 rss = gsr_replay_budget_rss(self->child_pid);
+    if (rss < 0)
+        return G_SOURCE_REMOVE;
+
+    int span = self->replay_seconds - RSS_BASELINE_SECONDS;
+    if (self->rss_baseline < 0) {
+        self->rss_baseline = rss;
+        self->rss_timer_id = g_timeout_add_seconds((guint)span, on_rss_sample, self);
+        return G_SOURCE_REMOVE;
+    }
+
+    gint64 estimated = gsr_replay_budget_estimate(self->replay_bytes_per_second, span, 100);
+    int *scale = &self->config.replay_config.estimate_scale_percent;
+    int old_scale = *scale;
+    *scale = gsr_replay_budget_refine_scale(old_scale, estimated, rss - self->rss_baseline);
+    g_debug("Replay buffer: estimated %" G_GINT64_FORMAT " bytes, measured %" G_GINT64_FORMAT
+            ", scale %d%% -> %d%%", estimated, rss - self->rss_baseline, old_scale, *scale);
+    return G_SOURCE_REMOVE;
+}
+
+static void
+start_rss_sampling(GsrWindow *self)
+{
+    g_clear_handle_id(&self->rss_timer_id, g_source_remove);
+    self->rss_baseline = -1;
+
+    /* Too short to tell buffer growth from encoder warm-up */
+    if (self->replay_seconds < 3 * RSS_BASELINE_SECONDS)
+        return;
+    self->rss_timer_id = g_timeout_add_seconds(RSS_BASELINE_SECONDS, on_rss_sample, self);
+}
+
 /* ── Build recording filename ────────────────────────────────────── */
 
+/* sequence > 0 numbers a segment, tag names a monitor; all files of a
+   recording share its start */
 static char *
-build_record_filename(const char *dir, const char *container_display)
+build_record_filename(const char *dir, const char *container_display,
+                      time_t when, int sequence, const char *tag)
 {
-    time_t now = time(NULL);
-    struct tm *tm = localtime(&now);
+    g_autofree char *suffix = sequence > 0 ? g_strdup_printf("_%03d", sequence)
+                            : tag ? g_strdelimit(g_strdup_printf("_%s", tag), "/", '_')
+                            : g_strdup("");
+    struct tm *tm = localtime(&when);
     if (!tm) {
-        return g_strdup_printf("%s/Video.%s", dir, container_display);
+        return g_strdup_printf("%s/Video%s.%s", dir, suffix, container_display);
     }
     char date_buf[64];
     strftime(date_buf, sizeof(date_buf), "%Y-%m-%d_%H-%M-%S", tm);
-    return g_strdup_printf("%s/Video_%s.%s", dir, date_buf, container_display);
+    return g_strdup_printf("%s/Video_%s%s.%s", dir, date_buf, suffix, container_display);
 }
 
 /* Map internal container ID to display extension for filename */
@@ -273,12 +744,23 @@ container_id_to_extension(const char *id)
 static GPtrArray *
 build_command_args(GsrWindow *self, GsrActiveMode mode)
 {
+    gint64 trace_begin = GSR_TRACE_CURRENT_TIME;
     GPtrArray *args = g_ptr_array_new_with_free_func(g_free);
 
+    /* ── GPU: the recorder runs on the card its environment picks ─── */
+    int card = gsr_config_page_get_gpu_card(self->config_page);
+    g_auto(GStrv) card_env = gsr_info_get_card_environ(&self->info, card);
+    if (card_env) {
+        g_ptr_array_add(args, g_strdup("env"));
+        for (int i = 0; card_env[i]; i++)
+            g_ptr_array_add(args, g_strdup(card_env[i]));
+    }
+
     g_ptr_array_add(args, g_strdup("gpu-screen-recorder"));
 
     /* ── Record area / window ─── */
-    const char *area_id = gsr_config_page_get_record_area_id(self->config_page);
+    const char *area_id = self->capture_monitor ? self->capture_monitor
+                        : gsr_config_page_get_record_area_id(self->config_page);
     g_ptr_array_add(args, g_strdup("-w"));
 
     if (g_str_equal(area_id, "focused")) {
@@ -291,9 +773,21 @@ build_command_args(GsrWindow *self, GsrActiveMode mode)
         unsigned long wid = gsr_config_page_get_selected_window(self->config_page);
         if (wid == 0) {
             g_ptr_array_unref(args);
+            GSR_TRACE_MARK(trace_begin, "build_command_args", "no window selected");
             return NULL;
         }
         g_ptr_array_add(args, g_strdup_printf("%lu", wid));
+    } else if (g_str_equal(area_id, "region")) {
+        /* Only the region is captured and encoded, not its monitor */
+        int x, y, width, height;
+        if (!gsr_config_page_get_region(self->config_page, &x, &y, &width, &height)) {
+            g_ptr_array_unref(args);
+            GSR_TRACE_MARK(trace_begin, "build_command_args", "no region selected");
+            return NULL;
+        }
+        g_ptr_array_add(args, g_strdup("region"));
+        g_ptr_array_add(args, g_strdup("-region"));
+        g_ptr_array_add(args, g_strdup_printf("%dx%d+%d+%d", width, height, x, y));
     } else {
         /* Monitor name */
         g_ptr_array_add(args, g_strdup(area_id));
@@ -310,15 +804,17 @@ build_command_args(GsrWindow *self, GsrActiveMode mode)
 
     switch (mode) {
     case GSR_ACTIVE_MODE_STREAM:
-        container_owned = gsr_stream_page_get_container(self->stream_page);
+        /* The relay takes anything ffmpeg can read from a pipe */
+        container_owned = self->relay ? g_strdup("mpegts")
+                        : gsr_stream_page_get_container(ensure_stream_page(self));
         container = container_owned;
         break;
     case GSR_ACTIVE_MODE_RECORD:
-        container_owned = gsr_record_page_get_container(self->record_page);
+        container_owned = gsr_record_page_get_container(ensure_record_page(self));
         container = container_owned;
         break;
     case GSR_ACTIVE_MODE_REPLAY:
-        container_owned = gsr_replay_page_get_container(self->replay_page);
+        container_owned = gsr_replay_page_get_container(ensure_replay_page(self));
         container = container_owned;
         break;
     default:
@@ -340,7 +836,8 @@ build_command_args(GsrWindow *self, GsrActiveMode mode)
 
     /* FPS */
     g_ptr_array_add(args, g_strdup("-f"));
-    g_ptr_array_add(args, g_strdup_printf("%d", gsr_config_page_get_fps(self->config_page)));
+    g_ptr_array_add(args, g_strdup_printf("%d", self->capture_fps > 0
+        ? self->capture_fps : gsr_config_page_get_fps(self->config_page)));
 
     /* Cursor */
     g_ptr_array_add(args, g_strdup("-cursor"));
@@ -362,12 +859,19 @@ build_command_args(GsrWindow *self, GsrActiveMode mode)
 
     /* ── Quality args ─── */
     const char *quality = gsr_config_page_get_quality_id(self->config_page);
-    if (g_str_equal(quality, "custom")) {
+    if (self->capture_kbps > 0) {
         g_ptr_array_add(args, g_strdup("-bm"));
         g_ptr_array_add(args, g_strdup("cbr"));
         g_ptr_array_add(args, g_strdup("-q"));
-        g_ptr_array_add(args, g_strdup_printf("%d",
-            gsr_config_page_get_video_bitrate(self->config_page)));
+        g_ptr_array_add(args, g_strdup_printf("%d", self->capture_kbps));
+    } else if (g_str_equal(quality, "custom")) {
+        int bitrate = gsr_config_page_get_video_bitrate(self->config_page);
+        if (mode == GSR_ACTIVE_MODE_STREAM && self->adaptive_bitrate)
+            bitrate = gsr_stream_health_bitrate(&self->stream_health, bitrate);
+        g_ptr_array_add(args, g_strdup("-bm"));
+        g_ptr_array_add(args, g_strdup("cbr"));
+        g_ptr_array_add(args, g_strdup("-q"));
+        g_ptr_array_add(args, g_strdup_printf("%d", bitrate));
     } else {
         g_ptr_array_add(args, g_strdup("-q"));
         g_ptr_array_add(args, g_strdup(quality));
@@ -409,9 +913,23 @@ build_command_args(GsrWindow *self, GsrActiveMode mode)
     /* ── Mode-specific: output (-o) and extra flags ─── */
     switch (mode) {
     case GSR_ACTIVE_MODE_REPLAY: {
+        gboolean on_disk = g_str_equal(gsr_replay_page_get_storage(self->replay_page), "disk");
         int replay_time = gsr_replay_page_get_time(self->replay_page);
+        if (!on_disk)
+            replay_time = fit_replay_time_in_ram(self, replay_time);
         g_ptr_array_add(args, g_strdup("-r"));
         g_ptr_array_add(args, g_strdup_printf("%d", replay_time));
+        self->replay_buffer_seconds = replay_time;
+
+        /* RAM is the default; older recorders don't know the option */
+        if (on_disk) {
+            g_ptr_array_add(args, g_strdup("-replay-storage"));
+            g_ptr_array_add(args, g_strdup("disk"));
+        }
+
+        /* Only a RAM buffer shows up in the child's RSS */
+        self->replay_seconds = on_disk ? 0 : replay_time;
+        self->replay_bytes_per_second = replay_bytes_per_second(self);
 
         const char *save_dir = gsr_replay_page_get_save_dir(self->replay_page);
         g_ptr_array_add(args, g_strdup("-o"));
@@ -421,116 +939,1039 @@ build_command_args(GsrWindow *self, GsrActiveMode mode)
     case GSR_ACTIVE_MODE_RECORD: {
         const char *save_dir = gsr_record_page_get_save_dir(self->record_page);
         const char *ext = container_id_to_extension(container);
-        char *filename = build_record_filename(
-            save_dir ? save_dir : "/tmp", ext);
+        char *filename = self->segment_sequence > 0
+            ? build_record_filename(save_dir ? save_dir : "/tmp", ext,
+                                    self->segment_time, self->segment_sequence, NULL)
+            : self->capture_monitor
+            ? build_record_filename(save_dir ? save_dir : "/tmp", ext,
+                                    self->multi_time, 0, self->capture_monitor)
+            : build_record_filename(save_dir ? save_dir : "/tmp", ext, time(NULL), 0, NULL);
 
         g_set_str(&self->record_filename, filename);
 
-        g_ptr_array_add(args, g_strdup("-o"));
-        g_ptr_array_add(args, filename); /* transfers ownership */
+        g_ptr_array_add(args, g_strdup("-o"));
+        g_ptr_array_add(args, filename); /* transfers ownership */
+        break;
+    }
+    case GSR_ACTIVE_MODE_STREAM: {
+        char *url = self->relay ? gsr_stream_relay_get_input_url(self->relay)
+                  : gsr_stream_page_get_stream_url(self->stream_page);
+        g_ptr_array_add(args, g_strdup("-o"));
+        g_ptr_array_add(args, url); /* transfers ownership */
+        break;
+    }
+    default:
+        break;
+    }
+
+    g_free(container_owned);
+
+    /* NULL-terminate for execvp */
+    g_ptr_array_add(args, NULL);
+
+    GSR_TRACE_MARK(trace_begin, "build_command_args", "mode=%d argc=%u",
+                   mode, args->len - 1);
+    return args;
+}
+
+/* ── Post-processing ─────────────────────────────────────────────── */
+
+/* Queue the configured post-processing commands for a saved file */
+static void
+post_process_file(GsrWindow *self, const char *file)
+{
+    const GsrMainConfig *m = &self->config.main_config;
+    if (!self->jobs || m->n_post_process_command == 0)
+        return;
+
+    gsr_job_queue_set_max_jobs(self->jobs, m->post_process_max_jobs);
+    gsr_job_queue_add(self->jobs, file,
+        (const char *const *)m->post_process_command, m->n_post_process_command);
+}
+
+static void
+on_post_process_finished(const char *file, const char *command,
+                         int exit_status, gpointer user_data)
+{
+    GsrWindow *self = GSR_WINDOW(user_data);
+
+    if (exit_status == 0) {
+        g_debug("Post-processed %s: %s", file, command);
+        return;
+    }
+
+    g_warning("Post-processing \"%s\" failed for %s (exit status %d)",
+              command, file, exit_status);
+    g_autofree char *name = g_path_get_basename(file);
+    g_autofree char *msg = g_strdup_printf(_("Post-processing failed for %s"), name);
+    gsr_window_show_toast(self, msg);
+}
+
+static void
+on_replay_trimmed(const char *path, gboolean trimmed G_GNUC_UNUSED, gpointer user_data)
+{
+    /* Untrimmed, it is still the replay that was saved */
+    post_process_file(GSR_WINDOW(user_data), path);
+}
+
+static void
+on_child_stdout_line(const char *line, gpointer user_data)
+{
+    GsrWindow *self = GSR_WINDOW(user_data);
+
+    /* Anything but a saved replay's path is just logged.  Paths come in
+       the order the saves were sent, so each takes its save's trim. */
+    if (self->active_mode == GSR_ACTIVE_MODE_REPLAY &&
+        g_path_is_absolute(line) &&
+        g_file_test(line, G_FILE_TEST_IS_REGULAR))
+    {
+        int trim_seconds = GPOINTER_TO_INT(g_queue_pop_head(&self->pending_trims));
+        g_debug("Replay saved: %s", line);
+        if (trim_seconds > 0)
+            gsr_replay_trim_async(line, trim_seconds, self->trim_cancellable,
+                                  on_replay_trimmed, self);
+        else
+            post_process_file(self, line);
+    } else if (line[0]) {
+        g_debug("gpu-screen-recorder: %s", line);
+    }
+}
+
+static void
+on_child_stderr_line(const char *line, gpointer user_data)
+{
+    GsrWindow *self = GSR_WINDOW(user_data);
+
+    /* Stats are shown in the UI; anything else goes where it always went */
+    if (gsr_encode_stats_parse_line(&self->encode_stats, line) || !line[0])
+        return;
+    if (self->adaptive_bitrate)
+        gsr_stream_health_parse_line(&self->stream_health, line);
+    fprintf(stderr, "%s\n", line);
+}
+
+/* ── Live encode statistics ──────────────────────────────────────── */
+
+#define STATS_INTERVAL_MS 1000
+
+static void settle_child(GsrWindow *self);
+static void sample_stream_health(GsrWindow *self);
+static void check_segment(GsrWindow *self);
+
+static gboolean
+on_stats_tick(gpointer user_data)
+{
+    GsrWindow *self = GSR_WINDOW(user_data);
+
+    /* Only a recording has a file to measure */
+    const char *output = self->active_mode == GSR_ACTIVE_MODE_RECORD
+        ? self->record_filename : NULL;
+    gsr_encode_stats_sample(&self->encode_stats, output, g_get_monotonic_time());
+
+    switch (self->active_mode) {
+    case GSR_ACTIVE_MODE_STREAM:
+        if (self->stream_page)
+            gsr_stream_page_update_stats(self->stream_page, &self->encode_stats);
+        if (self->stream_page && self->relay)
+            gsr_stream_page_update_relay(self->stream_page, self->relay);
+        if (self->adaptive_bitrate)
+            sample_stream_health(self);
+        break;
+    case GSR_ACTIVE_MODE_RECORD:
+        if (self->record_page)
+            gsr_record_page_update_stats(self->record_page, &self->encode_stats);
+        if (self->segment_sequence > 0)
+            check_segment(self);
+        break;
+    case GSR_ACTIVE_MODE_REPLAY:
+        if (self->replay_page)
+            gsr_replay_page_update_stats(self->replay_page, &self->encode_stats);
+        break;
+    default:
+        break;
+    }
+    return G_SOURCE_CONTINUE;
+}
+
+static void
+start_stats(GsrWindow *self)
+{
+    /* Frames short of the target only mean something at a constant rate */
+    const char *fm = gsr_config_page_get_framerate_mode_id(self->config_page);
+    int fps = self->capture_fps > 0 ? self->capture_fps : gsr_config_page_get_fps(self->config_page);
+    int target_fps = g_str_equal(fm, "cfr") ? fps : 0;
+
+    gsr_encode_stats_reset(&self->encode_stats, target_fps);
+    g_clear_handle_id(&self->stats_timer_id, g_source_remove);
+    self->stats_timer_id = g_timeout_add(STATS_INTERVAL_MS, on_stats_tick, self);
+}
+
+/* ── Adaptive streaming bitrate ──────────────────────────────────── */
+
+/*
+ * gpu-screen-recorder can't change its bitrate while running, so a tier
+ * change stops the stream with SIGINT and starts it again at the new
+ * bitrate; restart_pending keeps on_child_exited() from treating that as
+ * the user stopping it.  Costs a second or two of stream, which is why
+ * gsr_stream_health only changes tiers on sustained trouble.
+ */
+
+static gboolean
+stream_can_adapt(GsrWindow *self)
+{
+    /* Only a constant bitrate can be scaled */
+    return self->stream_page &&
+           gsr_stream_page_get_adaptive_bitrate(self->stream_page) &&
+           g_str_equal(gsr_config_page_get_quality_id(self->config_page), "custom");
+}
+
+/* Caller runs settle_child() to carry it out */
+static void
+restart_stream(GsrWindow *self, GsrStreamHealthAction action)
+{
+    int bitrate = gsr_stream_health_bitrate(&self->stream_health,
+        gsr_config_page_get_video_bitrate(self->config_page));
+    g_autofree char *msg = g_strdup_printf(action == GSR_STREAM_HEALTH_STEP_UP
+        ? _("Connection recovered, raising stream bitrate to %d kbps")
+        : _("Connection congested, lowering stream bitrate to %d kbps"), bitrate);
+    g_debug("%s", msg);
+    gsr_window_show_toast(self, msg);
+    self->restart_pending = TRUE;
+}
+
+static void
+sample_stream_health(GsrWindow *self)
+{
+    /* A restart is already on its way, or the child isn't streaming yet */
+    if (self->restart_pending || self->child_state != CHILD_RUNNING)
+        return;
+
+    int bitrate = gsr_stream_health_bitrate(&self->stream_health,
+        gsr_config_page_get_video_bitrate(self->config_page));
+    /* With a relay, the destination furthest behind is the bottleneck */
+    gint64 queued = self->relay
+        ? (gint64)gsr_stream_relay_get_max_queued(self->relay)
+        : gsr_stream_health_read_send_queue(self->child_pid);
+    GsrStreamHealthAction action = gsr_stream_health_sample(&self->stream_health,
+        queued, bitrate, g_get_monotonic_time());
+    if (action != GSR_STREAM_HEALTH_KEEP) {
+        restart_stream(self, action);
+        settle_child(self);
+    }
+}
+
+/* ── fork/exec ───────────────────────────────────────────────────── */
+
+/* With a barrier pipe, the child waits for the parent to close its write
+   end before it execs, so several children can be let go at once */
+static gboolean
+start_child_process(GsrWindow *self, GPtrArray *args,
+                    GsrChildOutputLineFunc on_stderr_line, const int *barrier)
+{
+    gint64 trace_begin = GSR_TRACE_CURRENT_TIME;
+
+    /* The recorder prints the path of each saved replay on stdout, and
+       its fps and errors on stderr */
+    int out_pipe[2], err_pipe[2];
+    GError *error = NULL;
+    if (!g_unix_open_pipe(out_pipe, FD_CLOEXEC, &error)) {
+        g_warning("Failed to create pipe: %s", error->message);
+        g_error_free(error);
+        return FALSE;
+    }
+    if (!g_unix_open_pipe(err_pipe, FD_CLOEXEC, &error)) {
+        g_warning("Failed to create pipe: %s", error->message);
+        g_error_free(error);
+        close(out_pipe[0]);
+        close(out_pipe[1]);
+        return FALSE;
+    }
+
+    hotkey_action_issued(self);
+    pid_t pid = fork();
+    if (pid == -1) {
+        g_warning("fork() failed: %s", g_strerror(errno));
+        close(out_pipe[0]);
+        close(out_pipe[1]);
+        close(err_pipe[0]);
+        close(err_pipe[1]);
+        return FALSE;
+    }
+
+    if (pid == 0) {
+        /* Child process */
+#ifdef __linux__
+        prctl(PR_SET_PDEATHSIG, SIGTERM);
+#endif
+        dup2(out_pipe[1], STDOUT_FILENO);
+        dup2(err_pipe[1], STDERR_FILENO);
+        if (barrier) {
+            char c;
+            close(barrier[1]);
+            while (read(barrier[0], &c, 1) < 0 && errno == EINTR)
+                ;
+        }
+        execvp(g_ptr_array_index(args, 0), (char **)args->pdata);
+        /* If execvp returns, it failed */
+        _exit(127);
+    }
+
+    /* Parent */
+    close(out_pipe[1]);
+    close(err_pipe[1]);
+    self->child_pid = pid;
+    self->child_stdout = gsr_child_output_new(out_pipe[0], on_child_stdout_line, self);
+    self->child_stderr = gsr_child_output_new(err_pipe[0], on_stderr_line, self);
+    GSR_TRACE_MARK(trace_begin, "start_child_process", "pid=%d", pid);
+
+    /* Log the command line for debugging */
+    g_autofree char *cmdline = g_strjoinv(" ", (char **)args->pdata);
+    g_debug("Started gpu-screen-recorder (pid=%d): %s", pid, cmdline);
+
+    return TRUE;
+}
+
+/* ── Segmented recording ─────────────────────────────────────────── */
+
+/*
+ * A recording with a time or size limit is split into numbered files,
+ * Video_<start>_001.mp4, _002 and so on.  gpu-screen-recorder can't switch
+ * files while it runs, so at the limit the next segment's recorder is
+ * started next to the running one, and the old one is only stopped (with
+ * SIGINT, so it finishes its file) once the new one has settled.  The
+ * segments overlap by that moment instead of losing frames in between.
+ * If the next one doesn't start, the old one carries on and the recording
+ * isn't split any further.  Finished segments are post-processed right
+ * away and listed in Video_<start>.ffconcat.
+ *
+ * A portal capture is only split when the portal session is restored:
+ * otherwise every new segment would ask for the screen to share again.
+ */
+
+static void on_child_exited(GPid pid, gint wait_status, gpointer user_data);
+static gboolean spawn_child(GsrWindow *self, GsrActiveMode mode);
+
+static void
+start_segments(GsrWindow *self, GsrActiveMode mode)
+{
+    self->segment_sequence = 0;
+    self->segment_ticks = 0;
+    g_clear_pointer(&self->segment_index, gsr_segment_index_free);
+    if (mode != GSR_ACTIVE_MODE_RECORD || !self->record_page || self->multi_monitors)
+        return;
+
+    /* HLS is split into segments by the recorder already */
+    g_autofree char *container = gsr_record_page_get_container(self->record_page);
+    int minutes = gsr_record_page_get_segment_minutes(self->record_page);
+    int size_mb = gsr_record_page_get_segment_size_mb(self->record_page);
+    if (g_str_equal(container, "hls") || (minutes <= 0 && size_mb <= 0))
+        return;
+    if (g_str_equal(gsr_config_page_get_record_area_id(self->config_page), "portal") &&
+        !gsr_config_page_get_restore_portal_session(self->config_page))
+    {
+        gsr_window_show_toast(self,
+            _("Splitting a portal capture needs a restored portal session, recording into one file"));
+        return;
+    }
+
+    self->segment_seconds = MAX(minutes, 0) * 60;
+    self->segment_bytes = (gint64)MAX(size_mb, 0) * 1000 * 1000;
+    self->segment_sequence = 1;
+    self->segment_time = time(NULL);
+
+    const char *save_dir = gsr_record_page_get_save_dir(self->record_page);
+    g_autofree char *index_path = build_record_filename(save_dir ? save_dir : "/tmp",
+        "ffconcat", self->segment_time, 0, NULL);
+    self->segment_index = gsr_segment_index_new(index_path);
+}
+
+static void
+add_segment(GsrWindow *self, int sequence, const char *file)
+{
+    GError *error = NULL;
+    if (self->segment_index &&
+        !gsr_segment_index_add(self->segment_index, sequence, file, &error))
+    {
+        g_warning("Failed to write segment index: %s", error->message);
+        g_error_free(error);
+    }
+}
+
+/* Once the last recorder of a split recording is gone */
+static void
+finish_segments(GsrWindow *self)
+{
+    if (self->active_mode == GSR_ACTIVE_MODE_RECORD || self->retiring.pid > 0)
+        return;
+    g_clear_pointer(&self->segment_index, gsr_segment_index_free);
+    self->segment_sequence = 0;
+}
+
+static void
+free_retiring_segment(RetiringSegment *r)
+{
+    g_clear_handle_id(&r->watch_id, g_source_remove);
+    g_clear_pointer(&r->out, gsr_child_output_free);
+    g_clear_pointer(&r->err, gsr_child_output_free);
+    g_clear_pointer(&r->filename, g_free);
+    r->pid = -1;
+}
+
+static void
+on_retired_segment_exited(GPid pid, gint wait_status, gpointer user_data)
+{
+    GsrWindow *self = GSR_WINDOW(user_data);
+    RetiringSegment *r = &self->retiring;
+    int exit_status = WIFEXITED(wait_status) ? WEXITSTATUS(wait_status) : -1;
+
+    r->watch_id = 0;
+    g_spawn_close_pid(pid);
+    gsr_child_output_flush(r->out);
+    gsr_child_output_flush(r->err);
+
+    if (exit_status == 0) {
+        add_segment(self, r->sequence, r->filename);
+        post_process_file(self, r->filename);
+    } else {
+        g_warning("Segment %s ended with exit_status=%d", r->filename, exit_status);
+    }
+    free_retiring_segment(r);
+
+    finish_segments(self);
+    /* A new start may have waited for this one */
+    settle_child(self);
+}
+
+static void
+stop_retiring_segment(GsrWindow *self)
+{
+    if (self->retiring.pid <= 0 || self->retiring.stopping)
+        return;
+    kill(self->retiring.pid, SIGINT);
+    self->retiring.stopping = TRUE;
+}
+
+/* The next segment didn't start: the previous one carries on, unsplit */
+static void
+resume_retiring_segment(GsrWindow *self)
+{
+    RetiringSegment *r = &self->retiring;
+    g_warning("Failed to start segment %d, continuing %s", self->segment_sequence, r->filename);
+
+    g_clear_handle_id(&r->watch_id, g_source_remove);
+    self->child_pid = r->pid;
+    self->child_state = CHILD_RUNNING;
+    self->child_watch_id = g_child_watch_add(self->child_pid, on_child_exited, self);
+    g_free(self->record_filename);
+    self->record_filename = g_steal_pointer(&r->filename);
+    g_clear_pointer(&self->child_stdout, gsr_child_output_free);
+    self->child_stdout = g_steal_pointer(&r->out);
+    g_clear_pointer(&self->child_stderr, gsr_child_output_free);
+    self->child_stderr = g_steal_pointer(&r->err);
+    self->segment_sequence = r->sequence;
+    self->segment_seconds = 0;
+    self->segment_bytes = 0;
+    r->pid = -1;
+
+    gsr_window_show_toast(self, _("Couldn't start a new file, recording on in the current one"));
+}
+
+/* The running recorder goes on until the next segment's has settled */
+static void
+rotate_segment(GsrWindow *self)
+{
+    RetiringSegment *r = &self->retiring;
+    g_debug("Starting segment %d, %s is long enough", self->segment_sequence + 1,
+            self->record_filename);
+
+    r->pid = self->child_pid;
+    r->sequence = self->segment_sequence;
+    r->stopping = FALSE;
+    r->filename = g_steal_pointer(&self->record_filename);
+    r->out = g_steal_pointer(&self->child_stdout);
+    r->err = g_steal_pointer(&self->child_stderr);
+    g_clear_handle_id(&self->child_watch_id, g_source_remove);
+    r->watch_id = g_child_watch_add(r->pid, on_retired_segment_exited, self);
+    self->child_pid = -1;
+    self->child_state = CHILD_IDLE;
+
+    self->segment_sequence++;
+    self->segment_ticks = 0;
+    self->rotating = TRUE;
+    if (!spawn_child(self, GSR_ACTIVE_MODE_RECORD))
+        resume_retiring_segment(self);
+}
+
+static void
+check_segment(GsrWindow *self)
+{
+    /* Time spent paused doesn't count towards a segment's length */
+    if (!self->paused)
+        self->segment_ticks++;
+    if (self->child_state != CHILD_RUNNING || self->paused || !self->want_running ||
+        self->retiring.pid > 0 || !self->record_filename)
+        return;
+
+    struct stat st;
+    gboolean too_long = self->segment_seconds > 0 &&
+        (gint64)self->segment_ticks * STATS_INTERVAL_MS >= (gint64)self->segment_seconds * 1000;
+    gboolean too_big = self->segment_bytes > 0 &&
+        stat(self->record_filename, &st) == 0 && st.st_size >= self->segment_bytes;
+    if (too_long || too_big)
+        rotate_segment(self);
+}
+
+/* ── Multi-monitor recording ─────────────────────────────────────── */
+
+/*
+ * Recording several monitors runs one recorder per monitor, each into its
+ * own Video_<start>_<monitor> file.  The first monitor's is the usual
+ * child and drives the state machine below; the others are kept in
+ * monitor_children and follow it: they are forked first, all of them wait
+ * on one pipe until the last is forked, and closing it lets them exec at
+ * once.  Stopping signals them all, and one ending on its own stops the
+ * rest, so the files cover the same span.  A frame rate budget is split
+ * evenly and a bitrate budget by pixel count, each recorder encoding at
+ * its share.  Only the first monitor's recorder feeds the statistics.
+ */
+
+static void
+free_monitor_child(gpointer data)
+{
+    MonitorChild *c = data;
+    g_clear_handle_id(&c->watch_id, g_source_remove);
+    g_clear_pointer(&c->out, gsr_child_output_free);
+    g_clear_pointer(&c->err, gsr_child_output_free);
+    g_clear_pointer(&c->monitor, g_free);
+    g_clear_pointer(&c->filename, g_free);
+}
+
+/* The statistics follow the first monitor's recorder only */
+static void
+on_monitor_child_stderr_line(const char *line, gpointer user_data G_GNUC_UNUSED)
+{
+    if (line[0] && !g_strstr_len(line, -1, "update fps:") && !g_str_has_prefix(line, "fps:"))
+        fprintf(stderr, "%s\n", line);
+}
+
+static void
+on_monitor_child_exited(GPid pid, gint wait_status, gpointer user_data)
+{
+    GsrWindow *self = GSR_WINDOW(user_data);
+    int exit_status = WIFEXITED(wait_status) ? WEXITSTATUS(wait_status) : -1;
+
+    guint index;
+    for (index = 0; index < self->monitor_children->len; index++) {
+        if (g_array_index(self->monitor_children, MonitorChild, index).pid == pid)
+            break;
+    }
+    g_spawn_close_pid(pid);
+    if (index == self->monitor_children->len)
+        return;
+
+    MonitorChild *c = &g_array_index(self->monitor_children, MonitorChild, index);
+    c->watch_id = 0;
+    gsr_child_output_flush(c->out);
+    gsr_child_output_flush(c->err);
+
+    if (exit_status == 0)
+        post_process_file(self, c->filename);
+    else
+        g_warning("Recording of %s ended with exit_status=%d", c->monitor, exit_status);
+
+    /* Lost one monitor: the others stop too, so their files line up */
+    if (!c->stopping && self->want_running && self->want_mode == GSR_ACTIVE_MODE_RECORD) {
+        g_autofree char *msg = g_strdup_printf(
+            _("Recording of %s stopped, stopping the other monitors"), c->monitor);
+        gsr_window_show_toast(self, msg);
+        self->want_running = FALSE;
+        set_page_inactive(self, GSR_ACTIVE_MODE_RECORD);
+        gsr_window_set_recording_active(self, FALSE);
+    }
+    g_array_remove_index_fast(self->monitor_children, index);
+
+    settle_child(self);
+    if (self->jobs)
+        gsr_job_queue_set_paused(self->jobs,
+            self->child_state != CHILD_IDLE || self->monitor_children->len > 0);
+}
+
+static void
+stop_monitor_children(GsrWindow *self)
+{
+    for (guint i = 0; i < self->monitor_children->len; i++) {
+        MonitorChild *c = &g_array_index(self->monitor_children, MonitorChild, i);
+        if (!c->stopping)
+            kill(c->pid, SIGINT);
+        c->stopping = TRUE;
+    }
+}
+
+/* Children still waiting at the barrier never exec; no file to keep */
+static void
+kill_monitor_children(GsrWindow *self)
+{
+    for (guint i = 0; i < self->monitor_children->len; i++) {
+        MonitorChild *c = &g_array_index(self->monitor_children, MonitorChild, i);
+        g_clear_handle_id(&c->watch_id, g_source_remove);
+        kill(c->pid, SIGKILL);
+        waitpid(c->pid, NULL, 0);
+    }
+    g_array_set_size(self->monitor_children, 0);
+}
+
+/* Leaves the recorder as the primary child */
+static gboolean
+fork_monitor_recorder(GsrWindow *self, int index, int kbps, const int barrier[2])
+{
+    self->capture_kbps = kbps;
+    self->capture_monitor = self->multi_monitors[index];
+    GPtrArray *args = build_command_args(self, GSR_ACTIVE_MODE_RECORD);
+    self->capture_monitor = NULL;
+    if (!args)
+        return FALSE;
+
+    GsrChildOutputLineFunc on_stderr_line = index == 0
+        ? on_child_stderr_line : on_monitor_child_stderr_line;
+    gboolean ok = start_child_process(self, args, on_stderr_line, barrier);
+    g_ptr_array_unref(args);
+    return ok;
+}
+
+static gboolean
+start_monitor_children(GsrWindow *self)
+{
+    int barrier[2];
+    GError *error = NULL;
+    if (!g_unix_open_pipe(barrier, FD_CLOEXEC, &error)) {
+        g_warning("Failed to create pipe: %s", error->message);
+        g_error_free(error);
+        return FALSE;
+    }
+
+    int n = (int)g_strv_length(self->multi_monitors);
+    self->capture_fps = gsr_monitor_split_fps(gsr_record_page_get_fps_budget(self->record_page),
+                                              n, gsr_config_page_get_fps(self->config_page));
+    self->multi_time = time(NULL);
+
+    /* 0 for each without a budget: the Config page's quality */
+    g_autofree int *kbps = g_new0(int, n);
+    int budget_kbps = gsr_record_page_get_bitrate_budget_kbps(self->record_page);
+    if (budget_kbps > 0) {
+        g_autofree gint64 *pixels = g_new(gint64, n);
+        for (int i = 0; i < n; i++) {
+            int width, height;
+            self->capture_monitor = self->multi_monitors[i];
+            get_capture_size(self, &width, &height);
+            pixels[i] = (gint64)width * height;
+        }
+        self->capture_monitor = NULL;
+        gsr_monitor_split_bitrate(budget_kbps, pixels, n, kbps);
+    }
+
+    /* The others first, so the primary child's fields end up its own */
+    gboolean ok = TRUE;
+    for (int i = 1; i < n; i++) {
+        ok = fork_monitor_recorder(self, i, kbps[i], barrier);
+        if (!ok)
+            break;
+        MonitorChild c = {
+            .pid      = self->child_pid,
+            .monitor  = g_strdup(self->multi_monitors[i]),
+            .filename = g_steal_pointer(&self->record_filename),
+            .out      = g_steal_pointer(&self->child_stdout),
+            .err      = g_steal_pointer(&self->child_stderr),
+            .watch_id = g_child_watch_add(self->child_pid, on_monitor_child_exited, self),
+        };
+        g_array_append_val(self->monitor_children, c);
+        self->child_pid = -1;
+    }
+    if (ok)
+        ok = fork_monitor_recorder(self, 0, kbps[0], barrier);
+    if (!ok)
+        kill_monitor_children(self);
+
+    /* Lets them all go */
+    close(barrier[1]);
+    close(barrier[0]);
+    return ok;
+}
+
+/* ── Child process state machine ─────────────────────────────────── */
+
+/*
+ * Start/stop requests (buttons, hotkeys) only record what the user wants
+ * — want_running/want_mode — and settle_child() moves the child towards
+ * it one step at a time:
+ *
+ *   IDLE ─fork→ STARTING ─CHILD_SETTLE_MS→ RUNNING ─SIGINT→ STOPPING ─reap→ IDLE
+ *
+ * A new child is never forked before the previous one is reaped, a child
+ * isn't signalled before it had time to install its handlers, and a burst
+ * of toggles collapses into whatever the last one asked for.  Nothing
+ * blocks the main loop: the child is reaped by a GChildWatch.
+ */
+#define CHILD_SETTLE_MS       500
+#define MIN_SAVE_INTERVAL_US  (1 * G_USEC_PER_SEC)
+
+static void settle_child(GsrWindow *self);
+
+static void
+set_page_inactive(GsrWindow *self, GsrActiveMode mode)
+{
+    switch (mode) {
+    case GSR_ACTIVE_MODE_STREAM:
+        if (self->stream_page)
+            gsr_stream_page_set_active(self->stream_page, FALSE);
         break;
-    }
-    case GSR_ACTIVE_MODE_STREAM: {
-        char *url = gsr_stream_page_get_stream_url(self->stream_page);
-        g_ptr_array_add(args, g_strdup("-o"));
-        g_ptr_array_add(args, url); /* transfers ownership */
+    case GSR_ACTIVE_MODE_RECORD:
+        if (self->record_page)
+            gsr_record_page_set_active(self->record_page, FALSE);
+        break;
+    case GSR_ACTIVE_MODE_REPLAY:
+        if (self->replay_page)
+            gsr_replay_page_set_active(self->replay_page, FALSE);
         break;
-    }
     default:
         break;
     }
+}
 
-    g_free(container_owned);
-
-    /* NULL-terminate for execvp */
-    g_ptr_array_add(args, NULL);
-
-    return args;
+/* Notification for a stop the user asked for */
+static void
+notify_stopped(GsrWindow *self, GsrActiveMode mode, int exit_status)
+{
+    if (exit_status == 0 && mode == GSR_ACTIVE_MODE_RECORD && self->record_filename) {
+        if (gsr_config_page_get_notify_saved(self->config_page)) {
+            /* A split recording is found through its index, several
+               monitors' through their folder */
+            g_autofree char *dir = self->multi_monitors
+                ? g_path_get_dirname(self->record_filename) : NULL;
+            const char *saved = dir ? dir
+                : self->segment_index ? gsr_segment_index_get_path(self->segment_index)
+                : self->record_filename;
+            g_autofree char *msg = dir
+                ? g_strdup_printf(_("Recordings saved to %s"), saved)
+                : g_strdup_printf(_("Recording saved to %s"), saved);
+            send_notification_full(self, "GPU Screen Recorder", msg,
+                G_NOTIFICATION_PRIORITY_NORMAL, saved);
+        }
+    } else if (gsr_config_page_get_notify_stopped(self->config_page)) {
+        const char *mode_str = active_mode_to_string(mode);
+        g_autofree char *msg = g_strdup_printf(_("Stopped %s"), mode_str);
+        send_notification(self, "GPU Screen Recorder", msg,
+            G_NOTIFICATION_PRIORITY_NORMAL);
+    }
 }
 
-/* ── fork/exec ───────────────────────────────────────────────────── */
+static void stop_relay(GsrWindow *self);
 
-static gboolean
-start_child_process(GsrWindow *self, GPtrArray *args)
+static void
+on_child_exited(GPid pid, gint wait_status, gpointer user_data)
 {
-    pid_t pid = fork();
-    if (pid == -1) {
-        g_warning("fork() failed: %s", g_strerror(errno));
-        return FALSE;
+    GsrWindow *self = GSR_WINDOW(user_data);
+    gboolean requested = self->child_state == CHILD_STOPPING;
+    gboolean was_running = self->child_state == CHILD_RUNNING;
+    GsrActiveMode mode = self->active_mode;
+    int exit_status = WIFEXITED(wait_status) ? WEXITSTATUS(wait_status) : -1;
+
+    self->child_watch_id = 0;
+    g_clear_handle_id(&self->settle_timer_id, g_source_remove);
+    g_clear_handle_id(&self->rss_timer_id, g_source_remove);
+    g_clear_handle_id(&self->stats_timer_id, g_source_remove);
+    g_spawn_close_pid(pid);
+    gsr_child_output_flush(self->child_stdout);
+    g_clear_pointer(&self->child_stdout, gsr_child_output_free);
+    gsr_child_output_flush(self->child_stderr);
+    g_clear_pointer(&self->child_stderr, gsr_child_output_free);
+    /* Saves it never answered won't be */
+    g_queue_clear(&self->pending_trims);
+    self->child_pid = -1;
+    self->child_state = CHILD_IDLE;
+
+    /* The next segment's recorder died before it took over */
+    if (!requested && self->retiring.pid > 0 && !self->retiring.stopping) {
+        resume_retiring_segment(self);
+        self->stats_timer_id = g_timeout_add(STATS_INTERVAL_MS, on_stats_tick, self);
+        settle_child(self);
+        return;
     }
 
-    if (pid == 0) {
-        /* Child process */
-#ifdef __linux__
-        prctl(PR_SET_PDEATHSIG, SIGTERM);
-#endif
-        execvp(g_ptr_array_index(args, 0), (char **)args->pdata);
-        /* If execvp returns, it failed */
-        _exit(127);
+    if (exit_status == 0 && mode == GSR_ACTIVE_MODE_RECORD && self->record_filename) {
+        if (self->segment_sequence > 0)
+            add_segment(self, self->segment_sequence, self->record_filename);
+        post_process_file(self, self->record_filename);
     }
 
-    /* Parent */
-    self->child_pid = pid;
+    /* An adaptive stream that drops out after it got going is most
+       likely the connection: retry a tier lower while there is one */
+    if (!requested && was_running && self->adaptive_bitrate &&
+        self->want_running && self->want_mode == mode &&
+        exit_status != 0 && exit_status != 10 && exit_status != 50 && exit_status != 60 &&
+        gsr_stream_health_on_failure(&self->stream_health))
+    {
+        g_debug("Stream died with exit_status=%d, retrying at a lower bitrate", exit_status);
+        restart_stream(self, GSR_STREAM_HEALTH_STEP_DOWN);
+        requested = TRUE;
+    }
 
-    /* Log the command line for debugging */
-    g_autofree char *cmdline = g_strjoinv(" ", (char **)args->pdata);
-    g_debug("Started gpu-screen-recorder (pid=%d): %s", pid, cmdline);
+    if (requested && self->restart_pending && self->want_running && self->want_mode == mode) {
+        /* Respawned by settle_child() below, active_mode and page stay */
+        self->prev_exit_status = exit_status;
+    } else if (requested) {
+        GSR_TRACE_MARK(self->stop_trace_begin, "child_stop", "pid=%d status=%d",
+                       pid, exit_status);
+        self->restart_pending = FALSE;
+        self->prev_exit_status = exit_status;
+        self->active_mode = GSR_ACTIVE_MODE_NONE;
+        notify_stopped(self, mode, exit_status);
+    } else {
+        /* Died on its own: whatever was queued no longer applies */
+        self->want_running = FALSE;
+        handle_child_death(self, exit_status);
+    }
 
-    return TRUE;
-}
+    /* Streaming is over, not just restarting */
+    if (self->active_mode == GSR_ACTIVE_MODE_NONE)
+        stop_relay(self);
+    finish_segments(self);
 
-/* ── Kill helper (matches kill_gpu_screen_recorder_get_result) ───── */
+    settle_child(self);
+
+    /* Post-processing waits while a capture runs */
+    if (self->jobs)
+        gsr_job_queue_set_paused(self->jobs, self->child_state != CHILD_IDLE);
+}
 
 static gboolean
-kill_and_wait(pid_t pid, gboolean *already_dead)
+on_child_settled(gpointer user_data)
 {
-    if (already_dead) *already_dead = FALSE;
+    GsrWindow *self = GSR_WINDOW(user_data);
+    self->settle_timer_id = 0;
+    if (self->child_state == CHILD_STARTING) {
+        self->child_state = CHILD_RUNNING;
+        /* The next segment is up: the previous one can finish */
+        stop_retiring_segment(self);
+    }
+    settle_child(self);
+    return G_SOURCE_REMOVE;
+}
+
+/* ── Simulcast ───────────────────────────────────────────────────── */
 
-    if (pid <= 0) {
-        if (already_dead) *already_dead = TRUE;
+/*
+ * With simulcast URLs set, the recorder streams into a local relay that
+ * feeds the primary service and every further URL, so one encode serves
+ * them all.  The relay outlives adaptive-bitrate restarts of the recorder.
+ */
+static gboolean
+start_relay(GsrWindow *self, GsrActiveMode mode)
+{
+    g_clear_pointer(&self->relay, gsr_stream_relay_free);
+    if (mode != GSR_ACTIVE_MODE_STREAM || !self->stream_page)
         return TRUE;
+
+    g_auto(GStrv) extra = gsr_stream_page_get_simulcast_urls(self->stream_page);
+    gboolean save_locally = gsr_stream_page_get_save_locally(self->stream_page);
+
+    /* The local copy is in the container the relay gets.  An adaptive
+       restart starts the stream over with new headers: MPEG-TS can be
+       appended to, WebM (VP8/VP9) can't */
+    const char *codec = NULL;
+    gboolean use_software = FALSE;
+    resolve_codec_and_encoder(self, &codec, &use_software);
+    const char *container = fix_container_for_codec("mpegts", codec);
+    if (save_locally && self->adaptive_bitrate && !g_str_equal(container, "mpegts")) {
+        gsr_window_show_toast(self,
+            _("A VP8/VP9 stream can't be saved locally with adaptive bitrate"));
+        save_locally = FALSE;
     }
+    if (!extra[0] && !save_locally)
+        return TRUE;
+
+    GStrvBuilder *builder = g_strv_builder_new();
+    g_autofree char *primary = gsr_stream_page_get_stream_url(self->stream_page);
+    g_strv_builder_add(builder, primary);
+    g_strv_builder_addv(builder, (const char **)extra);
+    g_auto(GStrv) urls = g_strv_builder_end(builder);
+    g_strv_builder_unref(builder);
+
+    GError *error = NULL;
+    self->relay = gsr_stream_relay_new((const char *const *)urls, &error);
+    if (self->relay && save_locally) {
+        /* Named like a recording */
+        const char *save_dir = self->record_page
+            ? gsr_record_page_get_save_dir(self->record_page)
+            : self->config.record_config.save_directory;
+        if (!save_dir || !save_dir[0])
+            save_dir = "/tmp";
+        const char *ext = container_id_to_extension(container);
 
-    /* Check if already dead */
-    int status = 0;
-    pid_t ret = waitpid(pid, &status, WNOHANG);
-    if (ret == pid) {
-        /* Already exited */
-        if (already_dead) *already_dead = TRUE;
-        if (WIFEXITED(status))
-            return WEXITSTATUS(status) == 0;
+        g_mkdir_with_parents(save_dir, 0755);
+        g_free(self->stream_filename);
+        self->stream_filename = build_record_filename(save_dir, ext, time(NULL), 0, NULL);
+        if (!gsr_stream_relay_add_file(self->relay, self->stream_filename, &error)) {
+            g_clear_pointer(&self->relay, gsr_stream_relay_free);
+            g_clear_pointer(&self->stream_filename, g_free);
+        }
+    }
+    if (!self->relay) {
+        send_notification(self, "GPU Screen Recorder", error->message,
+            G_NOTIFICATION_PRIORITY_URGENT);
+        g_error_free(error);
         return FALSE;
     }
-
-    /* Still running — send SIGINT and block until exit */
-    kill(pid, SIGINT);
-    ret = waitpid(pid, &status, 0);
-    if (ret == pid && WIFEXITED(status))
-        return WEXITSTATUS(status) == 0;
-    return FALSE;
+    return TRUE;
 }
 
-/* ── 500ms poll timer ────────────────────────────────────────────── */
+/* Streaming is over: the local copy is complete once the relay is gone */
+static void
+stop_relay(GsrWindow *self)
+{
+    gboolean saved = self->stream_filename && self->relay &&
+                     gsr_stream_relay_finish_file(self->relay);
+    g_clear_pointer(&self->relay, gsr_stream_relay_free);
+    if (!self->stream_filename)
+        return;
+
+    if (!saved) {
+        g_autofree char *msg = g_strdup_printf(_("Failed to save the stream to %s"),
+            self->stream_filename);
+        send_notification(self, "GPU Screen Recorder", msg,
+            G_NOTIFICATION_PRIORITY_URGENT);
+        g_clear_pointer(&self->stream_filename, g_free);
+        return;
+    }
+
+    post_process_file(self, self->stream_filename);
+    if (gsr_config_page_get_notify_saved(self->config_page)) {
+        g_autofree char *msg = g_strdup_printf(_("Stream saved to %s"),
+            self->stream_filename);
+        send_notification_full(self, "GPU Screen Recorder", msg,
+            G_NOTIFICATION_PRIORITY_NORMAL, self->stream_filename);
+    }
+    g_clear_pointer(&self->stream_filename, g_free);
+}
 
 static gboolean
-on_poll_timer(gpointer user_data)
+spawn_child(GsrWindow *self, GsrActiveMode mode)
 {
-    GsrWindow *self = GSR_WINDOW(user_data);
+    /* A restart keeps the stream's bitrate tier, a rotation the
+       recording's segments; neither is announced */
+    gboolean rotating = self->rotating;
+    gboolean restarting = self->restart_pending || rotating;
+    self->restart_pending = FALSE;
+    self->rotating = FALSE;
+    if (!restarting) {
+        self->adaptive_bitrate = mode == GSR_ACTIVE_MODE_STREAM && stream_can_adapt(self);
+        gsr_stream_health_reset(&self->stream_health);
+        self->paused = FALSE;
+        g_clear_pointer(&self->multi_monitors, g_strfreev);
+        self->capture_fps = 0;
+        self->capture_kbps = 0;
+        if (mode == GSR_ACTIVE_MODE_RECORD && self->record_page)
+            self->multi_monitors = gsr_record_page_get_monitors(self->record_page);
+        start_segments(self, mode);
+        if (!start_relay(self, mode))
+            return FALSE;
+    }
 
-    if (self->child_pid <= 0)
-        return G_SOURCE_CONTINUE;
+    gboolean ok;
+    if (self->multi_monitors && mode == GSR_ACTIVE_MODE_RECORD) {
+        ok = start_monitor_children(self);
+    } else {
+        GPtrArray *args = build_command_args(self, mode);
+        if (!args) {
+            g_clear_pointer(&self->relay, gsr_stream_relay_free);
+            g_clear_pointer(&self->stream_filename, g_free);
+            if (!rotating)
+                send_notification(self, "GPU Screen Recorder",
+                    _("Failed to build command (no window selected)"),
+                    G_NOTIFICATION_PRIORITY_URGENT);
+            return FALSE;
+        }
 
-    /* Check if child died */
-    int status = 0;
-    pid_t ret = waitpid(self->child_pid, &status, WNOHANG);
-    if (ret == self->child_pid) {
-        /* Child died */
-        int exit_status = WIFEXITED(status) ? WEXITSTATUS(status) : -1;
-        self->child_pid = -1;
-        handle_child_death(self, exit_status);
+        ok = start_child_process(self, args, on_child_stderr_line, NULL);
+        g_ptr_array_unref(args);
     }
 
-    return G_SOURCE_CONTINUE;
+    if (!ok) {
+        g_clear_pointer(&self->relay, gsr_stream_relay_free);
+        g_clear_pointer(&self->stream_filename, g_free);
+        if (!rotating) {
+            const char *mode_str = active_mode_to_string(mode);
+            g_autofree char *msg = g_strdup_printf(_("Failed to start %s (failed to fork)"), mode_str);
+            send_notification(self, "GPU Screen Recorder", msg,
+                G_NOTIFICATION_PRIORITY_URGENT);
+        }
+        return FALSE;
+    }
+
+    self->active_mode = mode;
+    self->child_state = CHILD_STARTING;
+    if (self->jobs)
+        gsr_job_queue_set_paused(self->jobs, TRUE);
+    self->child_watch_id = g_child_watch_add(self->child_pid, on_child_exited, self);
+    self->settle_timer_id = g_timeout_add(CHILD_SETTLE_MS, on_child_settled, self);
+    if (mode == GSR_ACTIVE_MODE_REPLAY)
+        start_rss_sampling(self);
+    if (rotating)
+        self->encode_stats.last_size = -1;  /* a new file, same session */
+    else
+        start_stats(self);
+
+    /* Show "started" notification */
+    if (!restarting && gsr_config_page_get_notify_started(self->config_page)) {
+        const char *mode_str = active_mode_to_string(mode);
+        g_autofree char *msg = g_strdup_printf(_("Started %s"), mode_str);
+        send_notification(self, "GPU Screen Recorder", msg,
+            G_NOTIFICATION_PRIORITY_NORMAL);
+    }
+
+    return TRUE;
+}
+
+static void
+settle_child(GsrWindow *self)
+{
+    switch (self->child_state) {
+    case CHILD_IDLE:
+        /* The last segment of a split recording is still finishing */
+        if (self->retiring.pid > 0)
+            break;
+        /* The other monitors' recorders end with the first one's */
+        if (self->monitor_children->len > 0) {
+            stop_monitor_children(self);
+            break;
+        }
+        if (self->want_running && !spawn_child(self, self->want_mode)) {
+            /* A queued start or a restart failed; the page already looks active */
+            self->want_running = FALSE;
+            set_page_inactive(self, self->want_mode);
+            gsr_window_set_recording_active(self, FALSE);
+            /* An adaptive restart keeps active_mode across the respawn */
+            if (self->active_mode != GSR_ACTIVE_MODE_NONE) {
+                self->active_mode = GSR_ACTIVE_MODE_NONE;
+                stop_relay(self);
+            }
+        }
+        break;
+    case CHILD_RUNNING:
+        if (!self->want_running || self->want_mode != self->active_mode ||
+            self->restart_pending)
+        {
+            hotkey_action_issued(self);
+            self->stop_trace_begin = GSR_TRACE_CURRENT_TIME;
+            kill(self->child_pid, SIGINT);
+            stop_monitor_children(self);
+            self->child_state = CHILD_STOPPING;
+        }
+        break;
+    case CHILD_STARTING:
+    case CHILD_STOPPING:
+        /* Wait for on_child_settled() / on_child_exited() */
+        break;
+    }
 }
 
 /* ── Handle unexpected child death ───────────────────────────────── */
@@ -543,23 +1984,8 @@ handle_child_death(GsrWindow *self, int exit_status)
 
     g_debug("Child died with exit_status=%d, mode=%d", exit_status, mode);
 
-    /* Stop the poll timer */
-    g_clear_handle_id(&self->poll_timer_id, g_source_remove);
-
     /* Enter the "stopped" state on the appropriate page */
-    switch (mode) {
-    case GSR_ACTIVE_MODE_STREAM:
-        gsr_stream_page_set_active(self->stream_page, FALSE);
-        break;
-    case GSR_ACTIVE_MODE_RECORD:
-        gsr_record_page_set_active(self->record_page, FALSE);
-        break;
-    case GSR_ACTIVE_MODE_REPLAY:
-        gsr_replay_page_set_active(self->replay_page, FALSE);
-        break;
-    default:
-        break;
-    }
+    set_page_inactive(self, mode);
 
     self->active_mode = GSR_ACTIVE_MODE_NONE;
     gsr_window_set_recording_active(self, FALSE);
@@ -568,20 +1994,7 @@ handle_child_death(GsrWindow *self, int exit_status)
     if (exit_status == 60) {
         /* Canceled by user — silent */
     } else if (exit_status == 0) {
-        /* Success */
-        if (mode == GSR_ACTIVE_MODE_RECORD && self->record_filename) {
-            if (gsr_config_page_get_notify_saved(self->config_page)) {
-                g_autofree char *msg = g_strdup_printf(_("Recording saved to %s"),
-                    self->record_filename);
-                send_notification_full(self, "GPU Screen Recorder", msg,
-                    G_NOTIFICATION_PRIORITY_NORMAL, self->record_filename);
-            }
-        } else if (gsr_config_page_get_notify_stopped(self->config_page)) {
-            const char *mode_str = active_mode_to_string(mode);
-            g_autofree char *msg = g_strdup_printf(_("Stopped %s"), mode_str);
-            send_notification(self, "GPU Screen Recorder", msg,
-                G_NOTIFICATION_PRIORITY_NORMAL);
-        }
+        notify_stopped(self, mode, exit_status);
     } else {
         /* Error — always notify regardless of user prefs */
         g_autofree char *msg = NULL;
@@ -608,11 +2021,19 @@ handle_child_death(GsrWindow *self, int exit_status)
 static void
 save_config(GsrWindow *self)
 {
-    /* Read current widget state into config struct */
+    /* Read current widget state into config struct.  Pages that were
+       never built still hold exactly what was loaded, so skip them. */
     gsr_config_page_read_config(self->config_page, &self->config);
-    gsr_stream_page_read_config(self->stream_page, &self->config);
-    gsr_record_page_read_config(self->record_page, &self->config);
-    gsr_replay_page_read_config(self->replay_page, &self->config);
+    if (self->stream_page)
+        gsr_stream_page_read_config(self->stream_page, &self->config);
+    if (self->record_page)
+        gsr_record_page_read_config(self->record_page, &self->config);
+    if (self->replay_page)
+        gsr_replay_page_read_config(self->replay_page, &self->config);
+
+    /* Save directories may have changed */
+    if (self->library_page)
+        gsr_library_page_apply_config(self->library_page, &self->config);
 
     /* Persist view-mode */
     GAction *action = g_action_map_lookup_action(G_ACTION_MAP(self), "view-mode");
@@ -651,17 +2072,65 @@ on_close_request(GtkWindow *window, gpointer user_data G_GNUC_UNUSED)
 {
     GsrWindow *self = GSR_WINDOW(window);
 
-    /* If child is running, kill it before exiting */
+    /* If child is running, kill it before exiting.  The child watch
+       must go first or it would race us for the waitpid(). */
+    g_clear_handle_id(&self->child_watch_id, g_source_remove);
+    g_clear_handle_id(&self->settle_timer_id, g_source_remove);
+    g_clear_handle_id(&self->rss_timer_id, g_source_remove);
+    g_clear_handle_id(&self->stats_timer_id, g_source_remove);
+    self->want_running = FALSE;
+    if (self->retiring.pid > 0) {
+        /* A split recording's previous segment, still finishing */
+        g_clear_handle_id(&self->retiring.watch_id, g_source_remove);
+        if (!self->retiring.stopping)
+            kill(self->retiring.pid, SIGINT);
+        int status = 0;
+        waitpid(self->retiring.pid, &status, 0);
+        if (WIFEXITED(status) && WEXITSTATUS(status) == 0) {
+            add_segment(self, self->retiring.sequence, self->retiring.filename);
+            post_process_file(self, self->retiring.filename);
+        }
+        free_retiring_segment(&self->retiring);
+    }
+    for (guint i = 0; i < self->monitor_children->len; i++) {
+        /* The other monitors of a multi-monitor recording */
+        MonitorChild *c = &g_array_index(self->monitor_children, MonitorChild, i);
+        g_clear_handle_id(&c->watch_id, g_source_remove);
+        if (!c->stopping)
+            kill(c->pid, SIGINT);
+        int status = 0;
+        waitpid(c->pid, &status, 0);
+        if (WIFEXITED(status) && WEXITSTATUS(status) == 0)
+            post_process_file(self, c->filename);
+    }
+    g_array_set_size(self->monitor_children, 0);
     if (self->child_pid > 0) {
         g_debug("Window closing — killing child pid %d", self->child_pid);
-        kill(self->child_pid, SIGINT);
-        waitpid(self->child_pid, NULL, 0);
+        if (self->child_state != CHILD_STOPPING)
+            kill(self->child_pid, SIGINT);
+        int status = 0;
+        waitpid(self->child_pid, &status, 0);
         self->child_pid = -1;
+        self->child_state = CHILD_IDLE;
+        g_clear_pointer(&self->child_stdout, gsr_child_output_free);
+        g_clear_pointer(&self->child_stderr, gsr_child_output_free);
+
+        /* Queued now, run on the next start (the queue dies with us) */
+        if (WIFEXITED(status) && WEXITSTATUS(status) == 0 &&
+            self->active_mode == GSR_ACTIVE_MODE_RECORD && self->record_filename)
+        {
+            if (self->segment_sequence > 0)
+                add_segment(self, self->segment_sequence, self->record_filename);
+            post_process_file(self, self->record_filename);
+        }
+        /* The local copy only counts once the relay has written it all */
+        gboolean stream_saved = self->stream_filename && self->relay &&
+                                gsr_stream_relay_finish_file(self->relay);
+        g_clear_pointer(&self->relay, gsr_stream_relay_free);
+        if (stream_saved)
+            post_process_file(self, self->stream_filename);
     }
 
-    /* Stop poll timer */
-    g_clear_handle_id(&self->poll_timer_id, g_source_remove);
-
     /* Free hotkeys before the window is destroyed */
     if (self->hotkeys) {
         gsr_hotkeys_free(self->hotkeys);
@@ -710,6 +2179,7 @@ create_primary_menu(GsrWindow *self)
 
     /* About section (always present) */
     g_autoptr(GMenu) about_section = g_menu_new();
+    g_menu_append(about_section, _("Hotkey Latency"), "win.hotkey-latency");
     g_menu_append(about_section, _("Keyboard Shortcuts"), "app.shortcuts");
     g_menu_append(about_section, _("About"), "app.about");
     g_menu_append_section(self->primary_menu, NULL,
@@ -743,6 +2213,9 @@ on_visible_page_changed(GObject *object G_GNUC_UNUSED,
     gboolean on_config = page && g_str_equal(page, "config");
     update_view_section_visibility(self, on_config);
 
+    /* First visit to an action page builds it */
+    ensure_page_by_name(self, page);
+
     /* X11: re-grab hotkeys for the now-visible page */
 #ifdef HAVE_X11
     if (self->hotkeys)
@@ -752,7 +2225,7 @@ on_visible_page_changed(GObject *object G_GNUC_UNUSED,
     /* Wayland: register shortcuts once when first visiting an action page */
 #ifdef HAVE_WAYLAND
     if (self->hotkeys && !self->wayland_shortcuts_registered) {
-        if (page && (!g_str_equal(page, "config"))) {
+        if (page && !g_str_equal(page, "config") && !g_str_equal(page, "library")) {
             self->wayland_shortcuts_registered = TRUE;
             gsr_hotkeys_register_wayland_shortcuts_once(self->hotkeys);
         }
@@ -853,10 +2326,32 @@ gsr_window_init(GsrWindow *self)
 {
     /* ── Init process state ─── */
     self->child_pid = -1;
+    self->child_state = CHILD_IDLE;
+    self->retiring.pid = -1;
+    self->monitor_children = g_array_new(FALSE, TRUE, sizeof(MonitorChild));
+    g_array_set_clear_func(self->monitor_children, free_monitor_child);
     self->prev_exit_status = 0;
     self->active_mode = GSR_ACTIVE_MODE_NONE;
     self->record_filename = NULL;
-    self->poll_timer_id = 0;
+    self->stream_filename = NULL;
+    self->child_watch_id = 0;
+    self->settle_timer_id = 0;
+    self->want_running = FALSE;
+    self->want_mode = GSR_ACTIVE_MODE_NONE;
+    self->last_save_time = 0;
+    self->rss_timer_id = 0;
+    self->rss_baseline = -1;
+    self->stats_timer_id = 0;
+    gsr_encode_stats_reset(&self->encode_stats, 0);
+    gsr_stream_health_reset(&self->stream_health);
+    self->adaptive_bitrate = FALSE;
+    self->restart_pending = FALSE;
+    self->relay = NULL;
+
+    /* ── Init hotkey latency state ─── */
+    gsr_latency_histogram_reset(&self->hotkey_latency);
+    self->hotkey_event_time = 0;
+    self->hotkey_backend = NULL;
 
     /* ── Init notification state ─── */
     self->showing_notification = FALSE;
@@ -869,7 +2364,9 @@ gsr_window_init(GsrWindow *self)
     gtk_widget_set_size_request(GTK_WIDGET(self), 430, 300);
 
     /* ── Load system info ─── */
-    GsrInfoExitStatus info_status = gsr_info_load(&self->info);
+    g_autofree char *gpu_cache = g_build_filename(g_get_user_cache_dir(),
+        "gpu-screen-recorder", "gpu-cards", NULL);
+    GsrInfoExitStatus info_status = gsr_info_load(&self->info, gpu_cache);
     if (info_status != GSR_INFO_EXIT_OK)
         g_warning("gsr_info_load returned status %d", info_status);
 
@@ -880,22 +2377,38 @@ gsr_window_init(GsrWindow *self)
     gsr_config_init_defaults(&self->config);
     gsr_config_read(&self->config);
 
+    /* Post-processing jobs, including ones left over from the last run */
+    g_autofree char *config_dir = gsr_config_get_dir();
+    g_autofree char *queue_path = g_build_filename(config_dir, "post-process-queue", NULL);
+    self->jobs = gsr_job_queue_new(queue_path, on_post_process_finished, self);
+    gsr_job_queue_set_max_jobs(self->jobs, self->config.main_config.post_process_max_jobs);
+    /* Replays cut down after a whole-buffer save, see gsr_window_save_replay() */
+    self->trim_cancellable = g_cancellable_new();
+
     /* ── View stack ─── */
     self->view_stack = ADW_VIEW_STACK(adw_view_stack_new());
 
     self->config_page = gsr_config_page_new(&self->info);
-    self->stream_page = gsr_stream_page_new(&self->info);
-    self->record_page = gsr_record_page_new(&self->info);
-    self->replay_page = gsr_replay_page_new(&self->info);
+
+    /* --info above and the audio device listing done by the Config page */
+    startup_mark("probes_done");
+
+    /* Action pages start as empty placeholders — see ensure_stream_page() */
+    self->stream_bin = ADW_BIN(adw_bin_new());
+    self->record_bin = ADW_BIN(adw_bin_new());
+    self->replay_bin = ADW_BIN(adw_bin_new());
+    self->library_bin = ADW_BIN(adw_bin_new());
 
     adw_view_stack_add_titled_with_icon(self->view_stack,
         GTK_WIDGET(self->config_page), "config", _("Config"), "preferences-system-symbolic");
     adw_view_stack_add_titled_with_icon(self->view_stack,
-        GTK_WIDGET(self->stream_page), "stream", _("Stream"), "network-transmit-symbolic");
+        GTK_WIDGET(self->stream_bin), "stream", _("Stream"), "network-transmit-symbolic");
     adw_view_stack_add_titled_with_icon(self->view_stack,
-        GTK_WIDGET(self->record_page), "record", _("Record"), "media-record-symbolic");
+        GTK_WIDGET(self->record_bin), "record", _("Record"), "media-record-symbolic");
     adw_view_stack_add_titled_with_icon(self->view_stack,
-        GTK_WIDGET(self->replay_page), "replay", _("Replay"), "media-playlist-repeat-symbolic");
+        GTK_WIDGET(self->replay_bin), "replay", _("Replay"), "media-playlist-repeat-symbolic");
+    adw_view_stack_add_titled_with_icon(self->view_stack,
+        GTK_WIDGET(self->library_bin), "library", _("Library"), "folder-videos-symbolic");
 
     /* ── Header bar with view switcher / title stack ─── */
     self->header_switcher = ADW_VIEW_SWITCHER(adw_view_switcher_new());
@@ -965,25 +2478,30 @@ gsr_window_init(GsrWindow *self)
     GActionEntry win_actions[] = {
         { .name = "view-mode", .activate = on_view_mode_change,
           .parameter_type = "s", .state = initial_mode },
+        { .name = "hotkey-latency", .activate = on_show_hotkey_latency,
+          .state = "@a{sv} {}" },
     };
     g_action_map_add_action_entries(G_ACTION_MAP(self),
         win_actions, G_N_ELEMENTS(win_actions), self);
 
-    /* ── Apply config to all pages ─── */
+    /* ── Apply config (action pages pick it up when they are built) ─── */
     gsr_config_page_apply_config(self->config_page, &self->config);
-    gsr_stream_page_apply_config(self->stream_page, &self->config);
-    gsr_record_page_apply_config(self->record_page, &self->config);
-    gsr_replay_page_apply_config(self->replay_page, &self->config);
 
     /* Apply advanced view mode */
     gsr_config_page_set_advanced(self->config_page,
         self->config.main_config.advanced_view);
+    startup_mark("config_applied");
+
+    if (g_getenv("GSR_STARTUP_TRACE"))
+        g_signal_connect(self, "map", G_CALLBACK(on_first_map), NULL);
 
     /* ── Hotkeys ─── */
-    self->hotkeys = gsr_hotkeys_new(self->info.system_info.display_server, self);
 #ifdef HAVE_WAYLAND
     self->wayland_shortcuts_registered = FALSE;
+    self->wayland_hotkeys_init_done = FALSE;
+    self->wayland_hotkeys_supported = FALSE;
 #endif
+    self->hotkeys = gsr_hotkeys_new(self->info.system_info.display_server, self);
 
     /* Re-grab hotkeys whenever the visible page changes */
     g_signal_connect(self->view_stack, "notify::visible-child-name",
@@ -1006,7 +2524,21 @@ gsr_window_finalize(GObject *object)
 
     g_clear_handle_id(&self->startup_idle_id, g_source_remove);
 
-    g_clear_handle_id(&self->poll_timer_id, g_source_remove);
+    g_clear_handle_id(&self->child_watch_id, g_source_remove);
+    g_clear_handle_id(&self->settle_timer_id, g_source_remove);
+    g_clear_handle_id(&self->rss_timer_id, g_source_remove);
+    g_clear_handle_id(&self->stats_timer_id, g_source_remove);
+    g_clear_pointer(&self->child_stdout, gsr_child_output_free);
+    g_clear_pointer(&self->child_stderr, gsr_child_output_free);
+    g_clear_pointer(&self->relay, gsr_stream_relay_free);
+    free_retiring_segment(&self->retiring);
+    g_clear_pointer(&self->monitor_children, g_array_unref);
+    g_clear_pointer(&self->multi_monitors, g_strfreev);
+    g_clear_pointer(&self->segment_index, gsr_segment_index_free);
+    g_clear_pointer(&self->jobs, gsr_job_queue_free);
+    g_cancellable_cancel(self->trim_cancellable);
+    g_clear_object(&self->trim_cancellable);
+    g_queue_clear(&self->pending_trims);
 
     g_clear_handle_id(&self->notification_timeout_id, g_source_remove);
 
@@ -1016,6 +2548,7 @@ gsr_window_finalize(GObject *object)
     }
 
     g_free(self->record_filename);
+    g_free(self->stream_filename);
     g_clear_object(&self->primary_menu);
     g_clear_object(&self->view_section);
     gsr_config_clear(&self->config);
@@ -1046,57 +2579,40 @@ gsr_window_set_recording_active(GsrWindow *self, gboolean active)
     g_return_if_fail(GSR_IS_WINDOW(self));
     gtk_widget_set_sensitive(GTK_WIDGET(self->header_switcher), !active);
     gtk_widget_set_sensitive(GTK_WIDGET(self->view_switcher_bar), !active);
+    gsr_config_page_set_session_active(self->config_page, active);
 }
 
 gboolean
 gsr_window_start_process(GsrWindow *self, GsrActiveMode mode)
 {
     g_return_val_if_fail(GSR_IS_WINDOW(self), FALSE);
-    g_return_val_if_fail(self->child_pid <= 0, FALSE);
 
-    /* Validate window selection if in "window" mode */
+    /* Validate window / region selection in "window" / "region" mode */
     if (!gsr_config_page_has_valid_window_selection(self->config_page)) {
+        gboolean region = g_str_equal(
+            gsr_config_page_get_record_area_id(self->config_page), "region");
         send_notification(self, "GPU Screen Recorder",
-            _("No window selected! Please select a window first."),
-            G_NOTIFICATION_PRIORITY_URGENT);
-        return FALSE;
-    }
-
-    /* Build command line */
-    GPtrArray *args = build_command_args(self, mode);
-    if (!args) {
-        send_notification(self, "GPU Screen Recorder",
-            _("Failed to build command (no window selected)"),
+            region ? _("No region selected! Please select a region first.")
+                   : _("No window selected! Please select a window first."),
             G_NOTIFICATION_PRIORITY_URGENT);
         return FALSE;
     }
 
-    /* Fork/exec */
-    gboolean ok = start_child_process(self, args);
-    g_ptr_array_unref(args);
+    self->want_running = TRUE;
+    self->want_mode = mode;
 
-    if (!ok) {
-        const char *mode_str = active_mode_to_string(mode);
-        g_autofree char *msg = g_strdup_printf(_("Failed to start %s (failed to fork)"), mode_str);
-        send_notification(self, "GPU Screen Recorder", msg,
-            G_NOTIFICATION_PRIORITY_URGENT);
-        return FALSE;
+    /* Still busy with the previous child: start once it's reaped */
+    if (self->child_state != CHILD_IDLE || self->retiring.pid > 0 ||
+        self->monitor_children->len > 0)
+    {
+        settle_child(self);
+        return TRUE;
     }
 
-    self->active_mode = mode;
-
-    /* Start 500ms poll timer */
-    if (self->poll_timer_id == 0)
-        self->poll_timer_id = g_timeout_add(500, on_poll_timer, self);
-
-    /* Show "started" notification */
-    if (gsr_config_page_get_notify_started(self->config_page)) {
-        const char *mode_str = active_mode_to_string(mode);
-        g_autofree char *msg = g_strdup_printf(_("Started %s"), mode_str);
-        send_notification(self, "GPU Screen Recorder", msg,
-            G_NOTIFICATION_PRIORITY_NORMAL);
+    if (!spawn_child(self, mode)) {
+        self->want_running = FALSE;
+        return FALSE;
     }
-
     return TRUE;
 }
 
@@ -1105,55 +2621,113 @@ gsr_window_stop_process(GsrWindow *self, gboolean *already_dead)
 {
     g_return_val_if_fail(GSR_IS_WINDOW(self), FALSE);
 
-    if (self->child_pid <= 0) {
-        if (already_dead) *already_dead = TRUE;
-        return TRUE;
-    }
+    self->want_running = FALSE;
 
-    pid_t pid = self->child_pid;
-    self->child_pid = -1;
-    GsrActiveMode mode = self->active_mode;
+    if (already_dead)
+        *already_dead = self->child_state == CHILD_IDLE;
 
-    gboolean success = kill_and_wait(pid, already_dead);
+    settle_child(self);
+    return TRUE;
+}
 
-    /* Stop poll timer */
-    g_clear_handle_id(&self->poll_timer_id, g_source_remove);
+gboolean
+gsr_window_send_signal(GsrWindow *self, int sig)
+{
+    g_return_val_if_fail(GSR_IS_WINDOW(self), FALSE);
 
-    self->active_mode = GSR_ACTIVE_MODE_NONE;
+    /* A child that just started may not handle SIGUSR1/2 yet (the
+       default action would kill it); one that's stopping doesn't care */
+    if (self->child_state != CHILD_RUNNING)
+        return FALSE;
 
-    /* Show stop notification (respecting user prefs) */
-    if (success && mode == GSR_ACTIVE_MODE_RECORD && self->record_filename) {
-        if (gsr_config_page_get_notify_saved(self->config_page)) {
-            g_autofree char *msg = g_strdup_printf(_("Recording saved to %s"),
-                self->record_filename);
-            send_notification_full(self, "GPU Screen Recorder", msg,
-                G_NOTIFICATION_PRIORITY_NORMAL, self->record_filename);
+    /* SIGUSR1 saves the whole replay, SIGRTMIN+1.. the partial saves */
+    if (sig == SIGUSR1 ||
+        (sig > SIGRTMIN && sig <= SIGRTMIN + GSR_N_REPLAY_SAVE_LENGTHS))
+    {
+        gint64 now = g_get_monotonic_time();
+        if (self->last_save_time != 0 &&
+            now - self->last_save_time < MIN_SAVE_INTERVAL_US)
+        {
+            g_debug("Ignoring replay save request, last one was %" G_GINT64_FORMAT " ms ago",
+                    (now - self->last_save_time) / 1000);
+            return FALSE;
         }
-    } else if (gsr_config_page_get_notify_stopped(self->config_page)) {
-        const char *mode_str = active_mode_to_string(mode);
-        g_autofree char *msg = g_strdup_printf(_("Stopped %s"), mode_str);
-        send_notification(self, "GPU Screen Recorder", msg,
-            G_NOTIFICATION_PRIORITY_NORMAL);
+        self->last_save_time = now;
     }
 
-    return success;
+    hotkey_action_issued(self);
+    kill(self->child_pid, sig);
+    if (sig == SIGUSR2 && self->active_mode == GSR_ACTIVE_MODE_RECORD) {
+        /* A segment that hasn't been told to finish yet pauses along */
+        if (self->retiring.pid > 0 && !self->retiring.stopping)
+            kill(self->retiring.pid, sig);
+        /* Several monitors pause together */
+        for (guint i = 0; i < self->monitor_children->len; i++) {
+            MonitorChild *c = &g_array_index(self->monitor_children, MonitorChild, i);
+            if (!c->stopping)
+                kill(c->pid, sig);
+        }
+        self->paused = !self->paused;
+    }
+    return TRUE;
 }
 
-void
-gsr_window_send_signal(GsrWindow *self, int sig)
+gint64
+gsr_window_estimate_replay_bytes(GsrWindow *self, int seconds)
 {
-    g_return_if_fail(GSR_IS_WINDOW(self));
-    if (self->child_pid > 0)
-        kill(self->child_pid, sig);
+    g_return_val_if_fail(GSR_IS_WINDOW(self), 0);
+    return gsr_replay_budget_estimate(replay_bytes_per_second(self), seconds,
+        self->config.replay_config.estimate_scale_percent);
+}
+
+gboolean
+gsr_window_save_replay(GsrWindow *self, int seconds)
+{
+    g_return_val_if_fail(GSR_IS_WINDOW(self), FALSE);
+
+    if (self->active_mode != GSR_ACTIVE_MODE_REPLAY)
+        return FALSE;
+
+    /* A window as long as the running buffer is the buffer; the spin row
+       may have changed since, or RAM limits may have shortened it */
+    int idx = gsr_replay_save_length_index(seconds);
+    if (idx < 0 || gsr_replay_save_lengths[idx] >= self->replay_buffer_seconds) {
+        if (!gsr_window_send_signal(self, SIGUSR1))
+            return FALSE;
+        self->last_save_seconds = 0;
+        g_queue_push_tail(&self->pending_trims, GINT_TO_POINTER(0));
+        return TRUE;
+    }
+
+    /* Older recorders exit on SIGRTMIN+N: save it all and cut the file */
+    gboolean partial = self->info.system_info.supports_partial_saves;
+    if (!gsr_window_send_signal(self, partial ? SIGRTMIN + 1 + idx : SIGUSR1))
+        return FALSE;
+    self->last_save_seconds = gsr_replay_save_lengths[idx];
+    g_queue_push_tail(&self->pending_trims,
+                      GINT_TO_POINTER(partial ? 0 : gsr_replay_save_lengths[idx]));
+    return TRUE;
 }
 
 void
 gsr_window_notify_replay_saved(GsrWindow *self)
 {
     g_return_if_fail(GSR_IS_WINDOW(self));
-    if (gsr_config_page_get_notify_saved(self->config_page))
+    if (!gsr_config_page_get_notify_saved(self->config_page))
+        return;
+
+    int length = self->last_save_seconds;
+    if (length == 0) {
         send_notification(self, "GPU Screen Recorder", _("Saved replay"),
             G_NOTIFICATION_PRIORITY_NORMAL);
+        return;
+    }
+
+    g_autofree char *msg = length < 60
+        ? g_strdup_printf(_("Saved the last %d seconds of replay"), length)
+        : g_strdup_printf(_("Saved the last %d minutes of replay"), length / 60);
+    send_notification(self, "GPU Screen Recorder", msg,
+        G_NOTIFICATION_PRIORITY_NORMAL);
 }
 
 void
@@ -1198,25 +2772,60 @@ gsr_window_hotkey_start_stop(GsrWindow *self)
         return;
 
     if (g_str_equal(page, "stream"))
-        gsr_stream_page_activate_start_stop(self->stream_page);
+        gsr_stream_page_activate_start_stop(ensure_stream_page(self));
     else if (g_str_equal(page, "record"))
-        gsr_record_page_activate_start_stop(self->record_page);
+        gsr_record_page_activate_start_stop(ensure_record_page(self));
     else if (g_str_equal(page, "replay"))
-        gsr_replay_page_activate_start_stop(self->replay_page);
+        gsr_replay_page_activate_start_stop(ensure_replay_page(self));
 }
 
 void
 gsr_window_hotkey_pause_unpause(GsrWindow *self)
 {
     g_return_if_fail(GSR_IS_WINDOW(self));
-    gsr_record_page_activate_pause(self->record_page);
+
+    /* A page that was never built cannot be recording */
+    if (self->record_page)
+        gsr_record_page_activate_pause(self->record_page);
+}
+
+void
+gsr_window_hotkey_save_replay(GsrWindow *self, int seconds)
+{
+    g_return_if_fail(GSR_IS_WINDOW(self));
+
+    if (self->replay_page)
+        gsr_replay_page_activate_save(self->replay_page, seconds);
+}
+
+void
+gsr_window_hotkey_save_replay_partial(GsrWindow *self, gboolean long_save)
+{
+    g_return_if_fail(GSR_IS_WINDOW(self));
+
+    if (!self->replay_page)
+        return;
+    /* The page, not self->config: that is only written back on save */
+    int seconds = long_save
+        ? gsr_replay_page_get_save_long_time(self->replay_page)
+        : gsr_replay_page_get_save_short_time(self->replay_page);
+    gsr_replay_page_activate_save(self->replay_page, seconds);
+}
+
+void
+gsr_window_begin_hotkey(GsrWindow *self, gint64 event_time_us, const char *backend)
+{
+    g_return_if_fail(GSR_IS_WINDOW(self));
+    self->hotkey_event_time = event_time_us > 0 ? event_time_us : g_get_monotonic_time();
+    self->hotkey_backend = backend;
 }
 
 void
-gsr_window_hotkey_save_replay(GsrWindow *self)
+gsr_window_end_hotkey(GsrWindow *self)
 {
     g_return_if_fail(GSR_IS_WINDOW(self));
-    gsr_replay_page_activate_save(self->replay_page);
+    /* Drop the sample if the action didn't fork or signal anything */
+    self->hotkey_event_time = 0;
 }
 
 #ifdef HAVE_WAYLAND
@@ -1225,9 +2834,16 @@ gsr_window_on_wayland_hotkeys_init(GsrWindow *self, gboolean success)
 {
     g_return_if_fail(GSR_IS_WINDOW(self));
 
-    gsr_stream_page_set_wayland_hotkeys_supported(self->stream_page, success);
-    gsr_record_page_set_wayland_hotkeys_supported(self->record_page, success);
-    gsr_replay_page_set_wayland_hotkeys_supported(self->replay_page, success);
+    /* Remember the answer for pages that are built later */
+    self->wayland_hotkeys_init_done = TRUE;
+    self->wayland_hotkeys_supported = success;
+
+    if (self->stream_page)
+        gsr_stream_page_set_wayland_hotkeys_supported(self->stream_page, success);
+    if (self->record_page)
+        gsr_record_page_set_wayland_hotkeys_supported(self->record_page, success);
+    if (self->replay_page)
+        gsr_replay_page_set_wayland_hotkeys_supported(self->replay_page, success);
 }
 #endif /* HAVE_WAYLAND */
 
@@ -23,15 +23,19 @@ void       gsr_window_set_recording_active(GsrWindow *self, gboolean active);
 
 /**
  * Start gpu-screen-recorder for the given mode.
- * Returns TRUE on success, FALSE on fork failure.
+ * If the previous child is still starting or exiting, the start is queued
+ * and runs once it has been reaped; a later stop cancels it.
+ * Returns TRUE if started or queued, FALSE on validation or fork failure.
  */
 gboolean   gsr_window_start_process(GsrWindow    *self,
                                      GsrActiveMode mode);
 
 /**
- * Stop the running gpu-screen-recorder process (SIGINT + waitpid).
- * Returns TRUE if the child exited successfully.
- * Sets *already_dead if the child was already gone.
+ * Ask the running gpu-screen-recorder process to stop (SIGINT).  Does not
+ * block: the child is reaped asynchronously and the stop/saved
+ * notification is shown then.  A child that is still starting is stopped
+ * once it is up.
+ * Sets *already_dead if there was no child.
  */
 gboolean   gsr_window_stop_process (GsrWindow *self,
                                      gboolean  *already_dead);
@@ -39,11 +43,34 @@ gboolean   gsr_window_stop_process (GsrWindow *self,
 /**
  * Send a signal to the running child process.
  * Used for SIGUSR1 (save replay) and SIGUSR2 (pause/unpause).
+ * Returns FALSE if the signal was not sent: the child is not running
+ * (or still starting/stopping), or a SIGUSR1 came within the minimum
+ * save interval of the previous one.
  */
-void       gsr_window_send_signal  (GsrWindow *self, int sig);
+gboolean   gsr_window_send_signal  (GsrWindow *self, int sig);
 
 /**
- * Notify replay saved (respects notify_saved config pref).
+ * Save the last `seconds` of the running replay, or all of it if seconds
+ * is 0.  Partial saves use the recorder's SIGRTMIN+N signals, so seconds
+ * is rounded up to the next of gsr_replay_save_lengths; anything at least
+ * as long as the running buffer (its -r, not the page's current value)
+ * saves the whole buffer.  Older gpu-screen-recorder versions exit on
+ * those signals, so with one that doesn't document them in --help the
+ * whole buffer is saved and the file cut to the length afterwards.
+ * Returns FALSE if nothing was sent (see gsr_window_send_signal()).
+ */
+gboolean   gsr_window_save_replay  (GsrWindow *self, int seconds);
+
+/**
+ * Expected size in bytes of a replay buffer of `seconds` with the current
+ * capture settings, corrected by what earlier replays measured.
+ */
+gint64     gsr_window_estimate_replay_bytes(GsrWindow *self, int seconds);
+
+/**
+ * Notify replay saved (respects notify_saved config pref), worded after
+ * what the last gsr_window_save_replay() actually sent: a SIGUSR1 saves
+ * the whole buffer whatever length was asked for.
  */
 void       gsr_window_notify_replay_saved(GsrWindow *self);
 
@@ -83,9 +110,28 @@ void       gsr_window_hotkey_start_stop   (GsrWindow *self);
 void       gsr_window_hotkey_pause_unpause(GsrWindow *self);
 
 /**
- * Hotkey: Save replay (replay page only).
+ * Hotkey / app.save-replay: Save the last `seconds` of the replay, 0 for
+ * the whole buffer (replay page only).
+ */
+void       gsr_window_hotkey_save_replay  (GsrWindow *self, int seconds);
+
+/**
+ * Hotkey: Save the short or long partial-save length currently set on
+ * the replay page (replay page only).
+ */
+void       gsr_window_hotkey_save_replay_partial(GsrWindow *self,
+                                                 gboolean   long_save);
+
+/**
+ * Bracket a hotkey dispatch.  event_time_us is when the key event
+ * happened (g_get_monotonic_time() clock); the delay until the resulting
+ * fork()/kill() is added to the session's hotkey latency histogram.
+ * Actions that never reach a fork()/kill() record nothing.
  */
-void       gsr_window_hotkey_save_replay  (GsrWindow *self);
+void       gsr_window_begin_hotkey(GsrWindow  *self,
+                                   gint64      event_time_us,
+                                   const char *backend);
+void       gsr_window_end_hotkey  (GsrWindow  *self);
 
 /**
  * Called by gsr-hotkeys when Wayland global shortcuts init completes.
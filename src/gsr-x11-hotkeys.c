@@ -3,22 +3,48 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include <X11/XKBlib.h>
+#include <X11/Xatom.h>
 #include <X11/Xlib.h>
 #include <X11/Xutil.h>
+#include <X11/extensions/XInput2.h>
 #include <glib-unix.h>
 #include <glib.h>
 
 /* ── Internal types ──────────────────────────────────────────────── */
 
-#define MAX_GRABBED_COMBOS 16
+typedef struct {
+    GsrX11HotkeyCombo combo;
+    KeyCode           keycode;   /* 0 if the keysym isn't on the current layout */
+    KeyCode           collided;  /* keycode another binding held, warned about */
+} Binding;
+
+/*
+ * Bindings are looked up by what a key event carries — keycode, modifier
+ * state and edge — so dispatch is a single hash lookup.  X11 modifier
+ * masks fit in 8 bits.
+ */
+#define BINDING_KEY(keycode, mods, on_press) \
+    GUINT_TO_POINTER(((guint)(on_press) << 16) | (((guint)(mods) & 0xff) << 8) | (guint)(keycode))
 
 struct _GsrX11Hotkeys {
-    Display              *display;
+    Display              *display;      /* our own connection */
     Window                root;
     unsigned int          numlockmask;
+    uint32_t              server_time_offset; /* local ms − server ms */
+    bool                  detectable_repeat;  /* XKB suppresses repeat releases */
+    unsigned char         keys_down[32];      /* keycode bitset, for repeat presses */
+    int                   xkb_event_base;     /* -1 without XKB */
+
+    /* Raw backend (XInput2): no grabs, modifiers tracked by hand */
+    GsrX11HotkeyBackend   backend;
+    int                   xi_opcode;
+    unsigned char         raw_mod_of_key[256]; /* keycode → modifier bits it sets */
+    unsigned short        raw_mod_refs[8];     /* held keys per modifier bit */
+    unsigned int          raw_state;           /* bits with raw_mod_refs > 0 */
 
-    GsrX11HotkeyCombo    combos[MAX_GRABBED_COMBOS];
-    int                   num_combos;
+    GPtrArray            *bindings;           /* Binding*, owned */
+    GHashTable           *by_key;             /* BINDING_KEY → Binding*, borrowed */
 
     GsrX11HotkeyCallback callback;
     void                 *userdata;
@@ -47,6 +73,151 @@ detect_numlock_mask(Display *display)
     return mask;
 }
 
+/* ── Keysym → keycode via XKB ────────────────────────────────────── */
+
+/*
+ * The keycode whose unshifted symbol in the first group is keysym.  This
+ * is what XLookupKeysym(ev, 0) used to compare against at dispatch time,
+ * now done once per binding (and again when the layout changes).
+ */
+static KeyCode
+resolve_keycode(Display *display, KeySym keysym)
+{
+    int min_kc = 0, max_kc = 0;
+    XDisplayKeycodes(display, &min_kc, &max_kc);
+    for (int kc = min_kc; kc <= max_kc; kc++) {
+        if (XkbKeycodeToKeysym(display, (KeyCode)kc, 0, 0) == keysym)
+            return (KeyCode)kc;
+    }
+    /* Symbols only reachable on a shifted level (e.g. some punctuation) */
+    return XKeysymToKeycode(display, keysym);
+}
+
+/* ── Raw backend: modifier tracking ──────────────────────────────── */
+
+/*
+ * Raw events carry no modifier state, so derive it from which modifier
+ * keys are held.  Lock and NumLock are toggles and are ignored here just
+ * as key_state_without_locks() strips them from core events.
+ */
+static void
+raw_rebuild_modmap(GsrX11Hotkeys *self)
+{
+    memset(self->raw_mod_of_key, 0, sizeof(self->raw_mod_of_key));
+    memset(self->raw_mod_refs, 0, sizeof(self->raw_mod_refs));
+
+    XModifierKeymap *modmap = XGetModifierMapping(self->display);
+    if (modmap) {
+        for (int i = 0; i < 8; i++) {
+            unsigned int bit = 1u << i;
+            if (bit == LockMask || bit == self->numlockmask)
+                continue;
+            for (int j = 0; j < modmap->max_keypermod; j++) {
+                KeyCode kc = modmap->modifiermap[i * modmap->max_keypermod + j];
+                if (kc)
+                    self->raw_mod_of_key[kc] |= (unsigned char)bit;
+            }
+        }
+        XFreeModifiermap(modmap);
+    }
+
+    /* Recount from keys already held so a remap mid-chord stays correct */
+    for (unsigned int kc = 0; kc < 256; kc++) {
+        if (!((self->keys_down[kc >> 3] >> (kc & 7)) & 1))
+            continue;
+        for (int i = 0; i < 8; i++) {
+            if (self->raw_mod_of_key[kc] & (1u << i))
+                self->raw_mod_refs[i]++;
+        }
+    }
+    self->raw_state = 0;
+    for (int i = 0; i < 8; i++) {
+        if (self->raw_mod_refs[i] > 0)
+            self->raw_state |= 1u << i;
+    }
+}
+
+/*
+ * Select raw key events for the master keyboards, so a key isn't seen
+ * once per slave device too.  Since XI 2.1 raw events are delivered to
+ * root-window listeners even while another client holds a keyboard grab.
+ * Event masks are per client, so GDK's own XI2 selection is untouched.
+ */
+static bool
+raw_select(GsrX11Hotkeys *self, bool enable)
+{
+    unsigned char bits[XIMaskLen(XI_LASTEVENT)] = { 0 };
+    if (enable) {
+        XISetMask(bits, XI_RawKeyPress);
+        XISetMask(bits, XI_RawKeyRelease);
+    }
+    XIEventMask mask = {
+        .deviceid = XIAllMasterDevices,
+        .mask_len = sizeof(bits),
+        .mask     = bits,
+    };
+    return XISelectEvents(self->display, self->root, &mask, 1) == Success;
+}
+
+static bool
+raw_init(GsrX11Hotkeys *self)
+{
+    int event_base, error_base;
+    if (!XQueryExtension(self->display, "XInputExtension",
+                         &self->xi_opcode, &event_base, &error_base))
+        return false;
+
+    int major = 2, minor = 1;
+    if (XIQueryVersion(self->display, &major, &minor) != Success ||
+        major < 2 || (major == 2 && minor < 1))
+        return false;
+
+    raw_rebuild_modmap(self);
+    return raw_select(self, true);
+}
+
+/* ── Server timestamp → local clock ──────────────────────────────── */
+
+/*
+ * Key event timestamps are X server milliseconds.  Learn their offset
+ * from our monotonic clock once, by provoking a PropertyNotify on a
+ * throwaway window — the usual way to read the server's current time.
+ * XWindowEvent() waits one round trip on our own connection; GDK's
+ * events are never touched.
+ */
+static uint32_t
+calibrate_server_time(Display *display, Window root)
+{
+    XSetWindowAttributes attrs = { .event_mask = PropertyChangeMask };
+    Window win = XCreateWindow(display, root, -1, -1, 1, 1, 0,
+                               CopyFromParent, InputOnly, CopyFromParent,
+                               CWEventMask, &attrs);
+    Atom probe = XInternAtom(display, "_GSR_TIMESTAMP_PROBE", False);
+
+    XChangeProperty(display, win, probe, XA_STRING, 8, PropModeAppend,
+                    (const unsigned char *)"", 0);
+    XEvent ev;
+    XWindowEvent(display, win, PropertyChangeMask, &ev);
+    uint32_t local_ms = (uint32_t)(g_get_monotonic_time() / 1000);
+
+    XDestroyWindow(display, win);
+    return local_ms - (uint32_t)ev.xproperty.time;
+}
+
+static int64_t
+server_time_to_monotonic(GsrX11Hotkeys *self, Time server_time)
+{
+    int64_t now_us = g_get_monotonic_time();
+    uint32_t now_ms = (uint32_t)(now_us / 1000);
+    uint32_t age_ms = now_ms - self->server_time_offset - (uint32_t)server_time;
+
+    /* A stale calibration (server clock jumped) shows up as an absurd
+       age; fall back to "now" rather than report garbage. */
+    if (age_ms > 60000)
+        return now_us;
+    return now_us - (int64_t)age_ms * 1000;
+}
+
 /* ── X error handling ────────────────────────────────────────────── */
 
 static bool x_grab_failed = false;
@@ -60,19 +231,254 @@ xerror_grab(Display *dpy G_GNUC_UNUSED, XErrorEvent *ev G_GNUC_UNUSED)
 
 /* ── Strip NumLock/CapsLock from key state ───────────────────────── */
 
+/* NumLock is whichever modifier the server put it on, not always Mod2 */
 static unsigned int
-key_state_without_locks(unsigned int state)
+key_state_without_locks(const GsrX11Hotkeys *self, unsigned int state)
+{
+    return state & ~(self->numlockmask | LockMask);
+}
+
+/* ── Auto-repeat handling ────────────────────────────────────────── */
+
+static bool
+key_is_down(const GsrX11Hotkeys *self, unsigned int keycode)
+{
+    return (self->keys_down[(keycode >> 3) & 31] >> (keycode & 7)) & 1;
+}
+
+static void
+set_key_down(GsrX11Hotkeys *self, unsigned int keycode, bool down)
+{
+    unsigned char bit = (unsigned char)(1u << (keycode & 7));
+    if (down)
+        self->keys_down[(keycode >> 3) & 31] |= bit;
+    else
+        self->keys_down[(keycode >> 3) & 31] &= (unsigned char)~bit;
+}
+
+/*
+ * Without XKB detectable auto-repeat a held key produces Release+Press
+ * pairs with identical timestamps.  Recognise the pair from the queue and
+ * swallow the Press so neither edge is reported.
+ */
+static bool
+release_is_repeat(GsrX11Hotkeys *self, const XKeyEvent *release)
 {
-    return state & ~(Mod2Mask | LockMask);
+    if (self->detectable_repeat)
+        return false;
+    if (XEventsQueued(self->display, QueuedAfterReading) == 0)
+        return false;
+
+    XEvent next;
+    XPeekEvent(self->display, &next);
+    if (next.type != KeyPress ||
+        next.xkey.keycode != release->keycode ||
+        next.xkey.time != release->time)
+        return false;
+
+    XNextEvent(self->display, &next);
+    return true;
+}
+
+static void
+fire_matching(GsrX11Hotkeys *self, const XKeyEvent *key, bool on_press)
+{
+    unsigned int state = key_state_without_locks(self, key->state);
+    const Binding *b = g_hash_table_lookup(self->by_key,
+        BINDING_KEY(key->keycode, state, on_press));
+    if (b)
+        self->callback(&b->combo, server_time_to_monotonic(self, key->time),
+                       self->userdata);
+}
+
+/* ── Passive grabs ───────────────────────────────────────────────── */
+
+/*
+ * A press binding and a release binding may share one keycode+modifiers
+ * grab; only the first grabs and only the last ungrabs.
+ */
+static int
+grab_users(const GsrX11Hotkeys *self, KeyCode keycode, unsigned int modifiers)
+{
+    int n = 0;
+    for (guint i = 0; i < self->bindings->len; i++) {
+        const Binding *b = g_ptr_array_index(self->bindings, i);
+        if (b->keycode == keycode && b->combo.modifiers == modifiers)
+            n++;
+    }
+    return n;
+}
+
+static void
+ungrab_key(GsrX11Hotkeys *self, KeyCode keycode, unsigned int modifiers)
+{
+    if (self->backend == GSR_X11_HOTKEY_BACKEND_RAW)
+        return;
+
+    unsigned int locks[] = { 0, LockMask, self->numlockmask,
+                             self->numlockmask | LockMask };
+    for (int m = 0; m < 4; m++)
+        XUngrabKey(self->display, keycode, modifiers | locks[m], self->root);
+}
+
+static bool
+grab_key(GsrX11Hotkeys *self, KeyCode keycode, unsigned int modifiers)
+{
+    if (self->backend == GSR_X11_HOTKEY_BACKEND_RAW)
+        return true;  /* raw events need no grab */
+
+    unsigned int locks[] = { 0, LockMask, self->numlockmask,
+                             self->numlockmask | LockMask };
+
+    XSync(self->display, False);
+    x_grab_failed = false;
+    XErrorHandler prev = XSetErrorHandler(xerror_grab);
+
+    for (int m = 0; m < 4; m++) {
+        XGrabKey(self->display, keycode, modifiers | locks[m], self->root,
+                 False, GrabModeAsync, GrabModeAsync);
+    }
+
+    XSync(self->display, False);
+    XSetErrorHandler(prev);
+
+    if (x_grab_failed) {
+        /* Undo partial grabs */
+        ungrab_key(self, keycode, modifiers);
+        XSync(self->display, False);
+        return false;
+    }
+    return true;
+}
+
+/* ── Keyboard layout changes ─────────────────────────────────────── */
+
+/*
+ * Re-resolve every binding against the new layout.  Keys whose keycode
+ * didn't move keep their grab; the rest are ungrabbed and grabbed anew.
+ * A NumLock change invalidates the lock variants of every grab.  Two
+ * keysyms can land on one keycode; the binding that already holds the
+ * keys (or came first) keeps them, the other stays unbound until a
+ * later change parts them, as gsr_x11_hotkeys_grab() would refuse it.
+ */
+static void
+on_keyboard_changed(GsrX11Hotkeys *self)
+{
+    unsigned int numlock = detect_numlock_mask(self->display);
+    bool regrab_all = numlock != self->numlockmask;
+    guint n = self->bindings->len;
+    KeyCode *new_kc = g_new0(KeyCode, n);
+    bool *dirty = g_new0(bool, n);
+    int moved = 0;
+
+    /* Release the grabs that are about to move (with the old lock masks) */
+    for (guint i = 0; i < n; i++) {
+        Binding *b = g_ptr_array_index(self->bindings, i);
+        new_kc[i] = resolve_keycode(self->display, b->combo.keysym);
+        if (new_kc[i] == b->keycode && !regrab_all)
+            continue;
+
+        dirty[i] = true;
+        moved++;
+        g_hash_table_remove(self->by_key,
+            BINDING_KEY(b->keycode, b->combo.modifiers, b->combo.on_press));
+        if (b->keycode && grab_users(self, b->keycode, b->combo.modifiers) == 1)
+            ungrab_key(self, b->keycode, b->combo.modifiers);
+        b->keycode = 0;
+    }
+
+    self->numlockmask = numlock;
+
+    for (guint i = 0; i < n; i++) {
+        Binding *b = g_ptr_array_index(self->bindings, i);
+        if (!dirty[i] || new_kc[i] == 0)
+            continue;
+        gpointer key = BINDING_KEY(new_kc[i], b->combo.modifiers, b->combo.on_press);
+        if (g_hash_table_contains(self->by_key, key)) {
+            /* Every later change retries it; only warn once per keycode */
+            if (b->collided != new_kc[i])
+                g_warning("Hotkey (keysym=0x%lx) is on the same keys as another after "
+                          "keyboard change, disabling it", (unsigned long)b->combo.keysym);
+            b->collided = new_kc[i];
+            continue;
+        }
+        if (grab_users(self, new_kc[i], b->combo.modifiers) == 0 &&
+            !grab_key(self, new_kc[i], b->combo.modifiers))
+        {
+            g_warning("Failed to regrab hotkey (keysym=0x%lx) after keyboard change",
+                      (unsigned long)b->combo.keysym);
+            continue;
+        }
+        b->keycode = new_kc[i];
+        b->collided = 0;
+        g_hash_table_insert(self->by_key, key, b);
+    }
+
+    if (self->backend == GSR_X11_HOTKEY_BACKEND_RAW)
+        raw_rebuild_modmap(self);
+
+    XSync(self->display, False);
+    g_free(dirty);
+    g_free(new_kc);
+    if (moved > 0)
+        g_debug("Keyboard changed: regrabbed %d hotkey(s)", moved);
+}
+
+/* ── Raw key events ──────────────────────────────────────────────── */
+
+/*
+ * Called for every keystroke on the system, so keep it to bit twiddling
+ * and one hash lookup.  Raw events come from the device before
+ * server-side auto-repeat, but a held key is still ignored via keys_down.
+ * The lookup uses the modifier state from before this key, matching what
+ * a core event's state field would hold.
+ */
+static void
+handle_raw_key(GsrX11Hotkeys *self, const XIRawEvent *raw, bool press)
+{
+    unsigned int kc = (unsigned int)raw->detail & 0xff;
+    if (key_is_down(self, kc) == press)
+        return;
+    set_key_down(self, kc, press);
+
+    const Binding *b = g_hash_table_lookup(self->by_key,
+        BINDING_KEY(kc, self->raw_state, press));
+
+    unsigned char mods = self->raw_mod_of_key[kc];
+    if (mods) {
+        for (int i = 0; i < 8; i++) {
+            if (!(mods & (1u << i)))
+                continue;
+            if (press)
+                self->raw_mod_refs[i]++;
+            else if (self->raw_mod_refs[i] > 0)
+                self->raw_mod_refs[i]--;
+            if (self->raw_mod_refs[i] > 0)
+                self->raw_state |= 1u << i;
+            else
+                self->raw_state &= ~(1u << i);
+        }
+    }
+
+    if (b)
+        self->callback(&b->combo, server_time_to_monotonic(self, raw->time),
+                       self->userdata);
 }
 
 /* ── GSource callbacks for X fd polling ──────────────────────────── */
 
+typedef struct {
+    GSource  source;
+    Display *display;
+} X11Source;
+
 static gboolean
-x11_source_prepare(GSource *source G_GNUC_UNUSED, gint *timeout)
+x11_source_prepare(GSource *source, gint *timeout)
 {
     *timeout = -1;
-    return FALSE;
+    /* Nobody else reads our connection, so events Xlib already buffered
+       (during an XSync, say) would otherwise wait for the next fd wakeup */
+    return XEventsQueued(((X11Source *)source)->display, QueuedAlready) > 0;
 }
 
 static gboolean
@@ -93,21 +499,42 @@ x11_source_dispatch(GSource *source G_GNUC_UNUSED,
         XEvent ev;
         XNextEvent(self->display, &ev);
 
-        if (ev.type != KeyRelease)
-            continue;
-
-        KeySym keysym = XLookupKeysym(&ev.xkey, 0);
-        unsigned int state = key_state_without_locks(ev.xkey.state);
-
-        for (int i = 0; i < self->num_combos; i++) {
-            if (keysym == self->combos[i].keysym &&
-                state == self->combos[i].modifiers)
-            {
-                self->callback(self->combos[i].modifiers,
-                              self->combos[i].keysym,
-                              self->userdata);
-                break;
-            }
+        bool grabbing = self->backend == GSR_X11_HOTKEY_BACKEND_GRAB;
+
+        if (grabbing && ev.type == KeyPress) {
+            /* Held keys repeat presses; only the first one counts */
+            if (key_is_down(self, ev.xkey.keycode))
+                continue;
+            set_key_down(self, ev.xkey.keycode, true);
+            fire_matching(self, &ev.xkey, true);
+        } else if (grabbing && ev.type == KeyRelease) {
+            if (release_is_repeat(self, &ev.xkey))
+                continue;
+            set_key_down(self, ev.xkey.keycode, false);
+            fire_matching(self, &ev.xkey, false);
+        } else if (ev.type == MappingNotify) {
+            XRefreshKeyboardMapping(&ev.xmapping);
+            if (ev.xmapping.request != MappingPointer)
+                on_keyboard_changed(self);
+        } else if (self->xkb_event_base >= 0 &&
+                   ev.type == self->xkb_event_base) {
+            XkbEvent *xkb = (XkbEvent *)&ev;
+            /* Having selected map notifies, Xlib leaves refreshing its
+               copy of the map to us */
+            if (xkb->any.xkb_type == XkbMapNotify)
+                XkbRefreshKeyboardMapping(&xkb->map);
+            if (xkb->any.xkb_type == XkbNewKeyboardNotify ||
+                xkb->any.xkb_type == XkbMapNotify)
+                on_keyboard_changed(self);
+        } else if (ev.type == GenericEvent &&
+                   self->backend == GSR_X11_HOTKEY_BACKEND_RAW &&
+                   ev.xcookie.extension == self->xi_opcode &&
+                   XGetEventData(self->display, &ev.xcookie)) {
+            if (ev.xcookie.evtype == XI_RawKeyPress)
+                handle_raw_key(self, ev.xcookie.data, true);
+            else if (ev.xcookie.evtype == XI_RawKeyRelease)
+                handle_raw_key(self, ev.xcookie.data, false);
+            XFreeEventData(self->display, &ev.xcookie);
         }
     }
 
@@ -125,6 +552,7 @@ static GSourceFuncs x11_source_funcs = {
 
 GsrX11Hotkeys *
 gsr_x11_hotkeys_new(Display *display,
+                     GsrX11HotkeyBackend backend,
                      GsrX11HotkeyCallback callback,
                      void *userdata)
 {
@@ -135,16 +563,55 @@ gsr_x11_hotkeys_new(Display *display,
     if (!self)
         return NULL;
 
+    /* Our own connection to the same server: reading events from GDK's
+       would take them from under it, and calibration would block it */
+    display = XOpenDisplay(DisplayString(display));
+    if (!display) {
+        free(self);
+        return NULL;
+    }
+
     self->display      = display;
     self->root         = DefaultRootWindow(display);
     self->numlockmask  = detect_numlock_mask(display);
+    self->server_time_offset = calibrate_server_time(display, self->root);
+
+    /* Ask the server not to send a Release before each repeated Press.
+       This is per client, so it only affects this connection; when XKB
+       refuses we fall back to pairing in release_is_repeat(). */
+    Bool repeat_supported = False;
+    XkbSetDetectableAutoRepeat(display, True, &repeat_supported);
+    self->detectable_repeat = repeat_supported;
+
     self->callback     = callback;
     self->userdata     = userdata;
-    self->num_combos   = 0;
+    self->bindings     = g_ptr_array_new_with_free_func(g_free);
+    self->by_key       = g_hash_table_new(g_direct_hash, g_direct_equal);
+
+    /* Layout switches and keyboard hotplug move keysyms between keycodes */
+    int xkb_opcode, xkb_error_base, xkb_major = XkbMajorVersion, xkb_minor = XkbMinorVersion;
+    self->xkb_event_base = -1;
+    if (XkbQueryExtension(display, &xkb_opcode, &self->xkb_event_base,
+                          &xkb_error_base, &xkb_major, &xkb_minor)) {
+        unsigned int mask = XkbNewKeyboardNotifyMask | XkbMapNotifyMask;
+        XkbSelectEvents(display, XkbUseCoreKbd, mask, mask);
+    } else {
+        self->xkb_event_base = -1;
+    }
+
+    self->backend = GSR_X11_HOTKEY_BACKEND_GRAB;
+    if (backend == GSR_X11_HOTKEY_BACKEND_RAW) {
+        self->backend = GSR_X11_HOTKEY_BACKEND_RAW;
+        if (!raw_init(self)) {
+            g_warning("XInput 2.1 not available, using key grabs for hotkeys");
+            self->backend = GSR_X11_HOTKEY_BACKEND_GRAB;
+        }
+    }
 
     /* Create a GSource that polls the X connection fd */
     int x_fd = ConnectionNumber(display);
-    self->source = g_source_new(&x11_source_funcs, sizeof(GSource));
+    self->source = g_source_new(&x11_source_funcs, sizeof(X11Source));
+    ((X11Source *)self->source)->display = display;
     g_source_set_callback(self->source, NULL, self, NULL);
     g_source_add_unix_fd(self->source, x_fd, G_IO_IN | G_IO_HUP | G_IO_ERR);
     self->source_id = g_source_attach(self->source, NULL);
@@ -160,12 +627,20 @@ gsr_x11_hotkeys_free(GsrX11Hotkeys *self)
 
     gsr_x11_hotkeys_ungrab_all(self);
 
+    if (self->backend == GSR_X11_HOTKEY_BACKEND_RAW) {
+        raw_select(self, false);
+        XSync(self->display, False);
+    }
+
     if (self->source) {
         g_source_destroy(self->source);
         g_source_unref(self->source);
         self->source = NULL;
     }
 
+    g_hash_table_unref(self->by_key);
+    g_ptr_array_unref(self->bindings);
+    XCloseDisplay(self->display);
     free(self);
 }
 
@@ -175,59 +650,48 @@ gsr_x11_hotkeys_ungrab_all(GsrX11Hotkeys *self)
     if (!self)
         return;
 
-    unsigned int modifiers[] = { 0, LockMask, self->numlockmask,
-                                 self->numlockmask | LockMask };
-
-    for (int i = 0; i < self->num_combos; i++) {
-        KeyCode kc = XKeysymToKeycode(self->display, self->combos[i].keysym);
-        for (int m = 0; m < 4; m++) {
-            XUngrabKey(self->display, kc,
-                       self->combos[i].modifiers | modifiers[m],
-                       self->root);
-        }
+    /* Pop bindings one by one so shared grabs are released exactly once */
+    while (self->bindings->len > 0) {
+        Binding *b = g_ptr_array_index(self->bindings, self->bindings->len - 1);
+        if (b->keycode && grab_users(self, b->keycode, b->combo.modifiers) == 1)
+            ungrab_key(self, b->keycode, b->combo.modifiers);
+        g_ptr_array_remove_index(self->bindings, self->bindings->len - 1);
     }
+    g_hash_table_remove_all(self->by_key);
     XSync(self->display, False);
-    self->num_combos = 0;
 }
 
 bool
 gsr_x11_hotkeys_grab(GsrX11Hotkeys *self, GsrX11HotkeyCombo combo)
 {
-    if (!self || self->num_combos >= MAX_GRABBED_COMBOS)
+    if (!self)
         return false;
 
     if (combo.keysym == None && combo.modifiers == 0)
         return true;  /* nothing to grab */
 
-    unsigned int modifiers[] = { 0, LockMask, self->numlockmask,
-                                 self->numlockmask | LockMask };
-
-    XSync(self->display, False);
-    x_grab_failed = false;
-    XErrorHandler prev = XSetErrorHandler(xerror_grab);
+    KeyCode kc = resolve_keycode(self->display, combo.keysym);
+    if (kc == 0)
+        return false;
 
-    KeyCode kc = XKeysymToKeycode(self->display, combo.keysym);
-    for (int m = 0; m < 4; m++) {
-        XGrabKey(self->display, kc,
-                 combo.modifiers | modifiers[m],
-                 self->root, False,
-                 GrabModeAsync, GrabModeAsync);
-    }
+    gpointer key = BINDING_KEY(kc, combo.modifiers, combo.on_press);
+    if (g_hash_table_contains(self->by_key, key))
+        return false;  /* same keys and edge already bound */
 
-    XSync(self->display, False);
-    XSetErrorHandler(prev);
-
-    if (x_grab_failed) {
-        /* Undo partial grabs */
-        for (int m = 0; m < 4; m++) {
-            XUngrabKey(self->display, kc,
-                       combo.modifiers | modifiers[m],
-                       self->root);
-        }
-        XSync(self->display, False);
+    if (grab_users(self, kc, combo.modifiers) == 0 &&
+        !grab_key(self, kc, combo.modifiers))
         return false;
-    }
 
-    self->combos[self->num_combos++] = combo;
+    Binding *b = g_new0(Binding, 1);
+    b->combo = combo;
+    b->keycode = kc;
+    g_ptr_array_add(self->bindings, b);
+    g_hash_table_insert(self->by_key, key, b);
     return true;
 }
+
+GsrX11HotkeyBackend
+gsr_x11_hotkeys_get_backend(GsrX11Hotkeys *self)
+{
+    return self ? self->backend : GSR_X11_HOTKEY_BACKEND_GRAB;
+}
@@ -3,31 +3,60 @@
 /*
  * gsr-x11-hotkeys.h — X11 global hotkey grabbing for GTK4.
  *
- * GTK4 removed gdk_window_add_filter(), so we poll the X connection fd
- * via a GLib GSource to receive KeyRelease events for grabbed combos.
+ * GTK4 removed gdk_window_add_filter(), so we open our own X connection
+ * and poll its fd via a GLib GSource to receive KeyPress/KeyRelease
+ * events for grabbed combos.  Each combo fires on one edge; auto-repeat
+ * of a held key never fires it twice.
+ *
+ * The raw backend listens to XInput2 raw key events instead of grabbing,
+ * so hotkeys keep working while a fullscreen game grabs the keyboard.
  */
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <X11/Xlib.h>
 
-typedef void (*GsrX11HotkeyCallback)(unsigned int modifiers, KeySym keysym, void *userdata);
+typedef enum {
+    GSR_X11_HOTKEY_BACKEND_GRAB,   /* XGrabKey on the root window */
+    GSR_X11_HOTKEY_BACKEND_RAW,    /* XI_RawKeyPress/Release, no grabs */
+} GsrX11HotkeyBackend;
 
 typedef struct {
     unsigned int modifiers;   /* X11 modifier mask (ControlMask, Mod1Mask, etc.) */
     KeySym       keysym;      /* e.g. XK_1, XK_2 */
+    bool         on_press;    /* fire on KeyPress instead of KeyRelease */
+    int          action;      /* caller-defined, handed back to the callback */
 } GsrX11HotkeyCombo;
 
+/*
+ * combo is the binding that matched (borrowed, valid for the call).
+ * event_time_us is when the X server generated the key event, converted
+ * to the g_get_monotonic_time() clock.
+ */
+typedef void (*GsrX11HotkeyCallback)(const GsrX11HotkeyCombo *combo,
+                                     int64_t event_time_us, void *userdata);
+
 typedef struct _GsrX11Hotkeys GsrX11Hotkeys;
 
 /**
- * Create a new X11 hotkey watcher on the given display.
- * The callback fires on KeyRelease matching any grabbed combo.
+ * Create a new X11 hotkey watcher on the server of the given display.
+ * It opens a connection of its own, so display (usually GDK's) only
+ * names the server and its events are left alone.
+ * The callback fires on the press or release (per combo) of any grabbed
+ * combo.
  * Returns NULL on failure.
  */
 GsrX11Hotkeys *gsr_x11_hotkeys_new(Display *display,
+                                    GsrX11HotkeyBackend backend,
                                     GsrX11HotkeyCallback callback,
                                     void *userdata);
 
+/**
+ * The backend in use.  A raw request falls back to grabs when the server
+ * lacks XInput 2.1.
+ */
+GsrX11HotkeyBackend gsr_x11_hotkeys_get_backend(GsrX11Hotkeys *self);
+
 /**
  * Destroy the hotkey watcher and ungrab all keys.
  */
@@ -39,8 +68,10 @@ void gsr_x11_hotkeys_free(GsrX11Hotkeys *self);
 void gsr_x11_hotkeys_ungrab_all(GsrX11Hotkeys *self);
 
 /**
- * Grab a key combo. The combo is added to the internal list and
- * grabbed with NumLock/CapsLock variants.
- * Returns true on success, false if XGrabKey failed.
+ * Grab a key combo. The keysym is resolved to a keycode on the current
+ * layout and grabbed with NumLock/CapsLock variants; layout changes are
+ * followed automatically.  There is no limit on the number of combos.
+ * Returns true on success, false if the keysym isn't on the keyboard,
+ * the same keys and edge are already bound, or XGrabKey failed.
  */
 bool gsr_x11_hotkeys_grab(GsrX11Hotkeys *self, GsrX11HotkeyCombo combo);
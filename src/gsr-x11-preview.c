@@ -0,0 +1,495 @@
+#include "gsr-x11-preview.h"
+
+#include <string.h>
+#include <sys/ipc.h>
+#include <sys/shm.h>
+#include <time.h>
+
+#include <X11/Xlib.h>
+#include <X11/Xutil.h>
+#include <X11/extensions/XShm.h>
+#include <X11/extensions/Xrandr.h>
+
+#define POOL_SPARE 2        /* frames kept for reuse: one on screen, one next */
+
+typedef enum {
+    TARGET_NONE,
+    TARGET_RECT,            /* root coordinates */
+    TARGET_WINDOW,          /* followed each frame */
+} TargetKind;
+
+/* Frame buffers, shared with the textures still holding them */
+typedef struct {
+    GMutex     lock;        /* textures may be released off the main thread */
+    gsize      size;        /* of every spare buffer */
+    GPtrArray *spare;
+} FramePool;
+
+typedef struct {
+    FramePool *pool;
+    gsize      size;
+    guint8    *data;
+} Frame;
+
+/* ── Internal struct ─────────────────────────────────────────────── */
+
+struct _GsrX11Preview {
+    Display          *display;      /* own connection */
+    Window            root;
+    Visual           *visual;
+    int               depth;
+    GdkMemoryFormat   format;
+
+    XShmSegmentInfo   shm;
+    gsize             shm_size;     /* 0 until the segment exists */
+    gboolean          shm_broken;   /* the server can't attach it: stay off */
+
+    int               max_width;
+    int               max_height;
+    GsrX11PreviewFunc callback;
+    gpointer          user_data;
+
+    TargetKind        kind;
+    int               x;
+    int               y;
+    int               width;
+    int               height;
+    Window            window;
+
+    gboolean          running;
+    guint             timer_id;
+
+    FramePool        *pool;
+    guint32          *acc;          /* row sums, 4 per source pixel */
+    gsize             acc_len;
+
+    double            cost_ms;      /* moving average */
+    gboolean          have_cost;
+};
+
+/* ── Frame pool ──────────────────────────────────────────────────── */
+
+static void
+pool_clear(FramePool *pool)
+{
+    g_ptr_array_unref(pool->spare);
+    g_mutex_clear(&pool->lock);
+}
+
+static guint8 *
+pool_take(FramePool *pool, gsize size)
+{
+    guint8 *data = NULL;
+    g_mutex_lock(&pool->lock);
+    if (size != pool->size) {
+        g_ptr_array_set_size(pool->spare, 0);
+        pool->size = size;
+    }
+    if (pool->spare->len > 0)
+        data = g_ptr_array_steal_index_fast(pool->spare, pool->spare->len - 1);
+    g_mutex_unlock(&pool->lock);
+    return data ? data : g_malloc(size);
+}
+
+static void
+frame_release(gpointer user_data)
+{
+    Frame *frame = user_data;
+    FramePool *pool = frame->pool;
+
+    g_mutex_lock(&pool->lock);
+    if (frame->size == pool->size && pool->spare->len < POOL_SPARE) {
+        g_ptr_array_add(pool->spare, frame->data);
+        frame->data = NULL;
+    }
+    g_mutex_unlock(&pool->lock);
+
+    g_free(frame->data);
+    g_rc_box_release_full(pool, (GDestroyNotify)pool_clear);
+    g_free(frame);
+}
+
+/* ── Downscale ───────────────────────────────────────────────────── */
+
+/*
+ * Average each block of source pixels into one destination pixel.  Whole
+ * source rows are summed into acc first: a flat uint8 → uint32 add the
+ * compiler turns into SIMD, and the bulk of the work.  The per-pixel
+ * horizontal pass then only touches src_w × 4 sums per output row.
+ * Channel order doesn't matter; all four are averaged alike.
+ */
+static void
+box_downscale(const guint8 *restrict src, int src_w, int src_h, int src_stride,
+              guint8 *restrict dst, int dst_w, int dst_h, int dst_stride,
+              guint32 *restrict acc)
+{
+    const int row_len = src_w * 4;
+
+    for (int oy = 0; oy < dst_h; oy++) {
+        int y0 = (int)((gint64)oy * src_h / dst_h);
+        int y1 = (int)((gint64)(oy + 1) * src_h / dst_h);
+
+        memset(acc, 0, (size_t)row_len * sizeof(*acc));
+        for (int y = y0; y < y1; y++) {
+            const guint8 *restrict row = src + (size_t)y * (size_t)src_stride;
+            for (int i = 0; i < row_len; i++)
+                acc[i] += row[i];
+        }
+
+        guint8 *out = dst + (size_t)oy * (size_t)dst_stride;
+        for (int ox = 0; ox < dst_w; ox++) {
+            int x0 = (int)((gint64)ox * src_w / dst_w);
+            int x1 = (int)((gint64)(ox + 1) * src_w / dst_w);
+            guint32 sum[4] = { 0, 0, 0, 0 };
+            for (int x = x0; x < x1; x++) {
+                for (int c = 0; c < 4; c++)
+                    sum[c] += acc[x * 4 + c];
+            }
+            guint32 n = (guint32)((x1 - x0) * (y1 - y0));
+            for (int c = 0; c < 4; c++)
+                out[ox * 4 + c] = (guint8)((sum[c] + n / 2) / n);
+        }
+    }
+}
+
+/* ── X11 ─────────────────────────────────────────────────────────── */
+
+/* Set by ignore_x_error; meaningful right after an XSync */
+static gboolean x_error;
+
+/* The followed window can be gone by the next frame, and a remote
+   server can't attach the segment */
+static int
+ignore_x_error(Display *display G_GNUC_UNUSED, XErrorEvent *event G_GNUC_UNUSED)
+{
+    x_error = TRUE;
+    return 0;
+}
+
+static void
+destroy_segment(GsrX11Preview *self)
+{
+    if (self->shm_size == 0)
+        return;
+    XShmDetach(self->display, &self->shm);
+    XSync(self->display, False);
+    shmdt(self->shm.shmaddr);
+    self->shm_size = 0;
+}
+
+/* Grown as needed, never shrunk: the largest target sets the size */
+static gboolean
+ensure_segment(GsrX11Preview *self, gsize size)
+{
+    if (size <= self->shm_size)
+        return TRUE;
+    destroy_segment(self);
+
+    int id = shmget(IPC_PRIVATE, size, IPC_CREAT | 0600);
+    if (id < 0) {
+        g_warning("gsr_x11_preview: shmget of %zu bytes failed", size);
+        return FALSE;
+    }
+    void *addr = shmat(id, NULL, 0);
+    /* Marked for removal now, so a crash doesn't leak it */
+    shmctl(id, IPC_RMID, NULL);
+    if (addr == (void *)-1) {
+        g_warning("gsr_x11_preview: shmat failed");
+        return FALSE;
+    }
+
+    self->shm.shmid = id;
+    self->shm.shmaddr = addr;
+    self->shm.readOnly = False;
+    /* A server on another host (ssh -X) can't map it; that's an async
+       BadAccess, not a return value */
+    x_error = FALSE;
+    XErrorHandler old = XSetErrorHandler(ignore_x_error);
+    Bool attached = XShmAttach(self->display, &self->shm);
+    XSync(self->display, False);
+    XSetErrorHandler(old);
+    if (!attached || x_error) {
+        g_warning("gsr_x11_preview: XShmAttach failed, preview disabled");
+        shmdt(addr);
+        self->shm_broken = TRUE;
+        return FALSE;
+    }
+    self->shm_size = size;
+    return TRUE;
+}
+
+/* The target in root coordinates, clipped to the screen */
+static gboolean
+get_target_rect(GsrX11Preview *self, int *x, int *y, int *width, int *height)
+{
+    int screen = DefaultScreen(self->display);
+    int x1, y1, x2, y2;
+
+    if (self->kind == TARGET_RECT) {
+        x1 = self->x;
+        y1 = self->y;
+        x2 = self->x + self->width;
+        y2 = self->y + self->height;
+    } else if (self->kind == TARGET_WINDOW) {
+        XErrorHandler old = XSetErrorHandler(ignore_x_error);
+        XWindowAttributes attr;
+        Window child;
+        gboolean ok = XGetWindowAttributes(self->display, self->window, &attr) &&
+                      attr.map_state == IsViewable &&
+                      XTranslateCoordinates(self->display, self->window, self->root,
+                                            0, 0, &x1, &y1, &child);
+        XSync(self->display, False);
+        XSetErrorHandler(old);
+        if (!ok)
+            return FALSE;
+        x2 = x1 + attr.width;
+        y2 = y1 + attr.height;
+    } else {
+        return FALSE;
+    }
+
+    *x = MAX(x1, 0);
+    *y = MAX(y1, 0);
+    *width = MIN(x2, DisplayWidth(self->display, screen)) - *x;
+    *height = MIN(y2, DisplayHeight(self->display, screen)) - *y;
+    return *width > 0 && *height > 0;
+}
+
+/* ── Sampling ────────────────────────────────────────────────────── */
+
+static double
+thread_cpu_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (double)ts.tv_sec * 1e3 + (double)ts.tv_nsec / 1e6;
+}
+
+static void
+capture_frame(GsrX11Preview *self)
+{
+    if (self->shm_broken)
+        return;
+
+    double start_ms = thread_cpu_ms();
+
+    int x, y, width, height;
+    if (!get_target_rect(self, &x, &y, &width, &height))
+        return;
+
+    XImage *image = XShmCreateImage(self->display, self->visual, (unsigned)self->depth,
+                                    ZPixmap, NULL, &self->shm,
+                                    (unsigned)width, (unsigned)height);
+    if (!image)
+        return;
+    if (!ensure_segment(self, (gsize)image->bytes_per_line * (gsize)height)) {
+        XDestroyImage(image);
+        return;
+    }
+    image->data = self->shm.shmaddr;
+    if (!XShmGetImage(self->display, self->root, image, x, y, AllPlanes)) {
+        XDestroyImage(image);
+        return;
+    }
+
+    double scale = MIN(1.0, MIN((double)self->max_width / width,
+                                (double)self->max_height / height));
+    int dst_w = MAX(1, (int)(width * scale));
+    int dst_h = MAX(1, (int)(height * scale));
+    gsize dst_stride = (gsize)dst_w * 4;
+
+    gsize acc_len = (gsize)width * 4;
+    if (acc_len > self->acc_len) {
+        g_free(self->acc);
+        self->acc = g_new(guint32, acc_len);
+        self->acc_len = acc_len;
+    }
+
+    Frame *frame = g_new0(Frame, 1);
+    frame->pool = g_rc_box_acquire(self->pool);
+    frame->size = dst_stride * (gsize)dst_h;
+    frame->data = pool_take(self->pool, frame->size);
+
+    box_downscale((const guint8 *)image->data, width, height, image->bytes_per_line,
+                  frame->data, dst_w, dst_h, (int)dst_stride, self->acc);
+    XDestroyImage(image);   /* the struct only; the segment stays */
+
+    GBytes *bytes = g_bytes_new_with_free_func(frame->data, frame->size,
+                                               frame_release, frame);
+    GdkTexture *texture = gdk_memory_texture_new(dst_w, dst_h, self->format,
+                                                 bytes, dst_stride);
+    g_bytes_unref(bytes);
+
+    double ms = thread_cpu_ms() - start_ms;
+    self->cost_ms = self->have_cost ? self->cost_ms * 0.8 + ms * 0.2 : ms;
+    self->have_cost = TRUE;
+
+    self->callback(texture, self->user_data);
+    g_object_unref(texture);
+}
+
+static gboolean
+on_tick(gpointer user_data)
+{
+    GsrX11Preview *self = user_data;
+    capture_frame(self);
+    if (self->shm_broken) {
+        self->timer_id = 0;
+        return G_SOURCE_REMOVE;
+    }
+    return G_SOURCE_CONTINUE;
+}
+
+/* Sample while running with a target; a new target shows at once */
+static void
+update_timer(GsrX11Preview *self, gboolean target_changed)
+{
+    gboolean want = self->running && self->kind != TARGET_NONE && !self->shm_broken;
+    if (!want) {
+        g_clear_handle_id(&self->timer_id, g_source_remove);
+        return;
+    }
+    if (self->timer_id == 0 || target_changed)
+        capture_frame(self);
+    if (self->shm_broken)
+        g_clear_handle_id(&self->timer_id, g_source_remove);
+    else if (self->timer_id == 0)
+        self->timer_id = g_timeout_add(GSR_X11_PREVIEW_INTERVAL_MS, on_tick, self);
+}
+
+/* ── Public API ──────────────────────────────────────────────────── */
+
+GsrX11Preview *
+gsr_x11_preview_new(int max_width, int max_height,
+                    GsrX11PreviewFunc callback, gpointer user_data)
+{
+    g_return_val_if_fail(max_width > 0 && max_height > 0 && callback, NULL);
+
+    Display *dpy = XOpenDisplay(NULL);
+    if (!dpy) {
+        g_warning("gsr_x11_preview: failed to open X display");
+        return NULL;
+    }
+    if (!XShmQueryExtension(dpy)) {
+        g_debug("gsr_x11_preview: no MIT-SHM, preview disabled");
+        XCloseDisplay(dpy);
+        return NULL;
+    }
+
+    int screen = DefaultScreen(dpy);
+    Visual *visual = DefaultVisual(dpy, screen);
+    int depth = DefaultDepth(dpy, screen);
+
+    /* Only 32-bit pixels; they map straight onto a GdkMemoryFormat */
+    XShmSegmentInfo probe_info = { 0 };
+    XImage *probe = XShmCreateImage(dpy, visual, (unsigned)depth, ZPixmap, NULL,
+                                    &probe_info, 1, 1);
+    if (!probe || probe->bits_per_pixel != 32) {
+        g_debug("gsr_x11_preview: unsupported visual, preview disabled");
+        if (probe)
+            XDestroyImage(probe);
+        XCloseDisplay(dpy);
+        return NULL;
+    }
+    GdkMemoryFormat format = probe->byte_order == LSBFirst
+                           ? GDK_MEMORY_B8G8R8X8 : GDK_MEMORY_X8R8G8B8;
+    XDestroyImage(probe);
+
+    GsrX11Preview *self = g_new0(GsrX11Preview, 1);
+    self->display = dpy;
+    self->root = RootWindow(dpy, screen);
+    self->visual = visual;
+    self->depth = depth;
+    self->format = format;
+    self->max_width = max_width;
+    self->max_height = max_height;
+    self->callback = callback;
+    self->user_data = user_data;
+
+    self->pool = g_rc_box_new0(FramePool);
+    g_mutex_init(&self->pool->lock);
+    self->pool->spare = g_ptr_array_new_with_free_func(g_free);
+
+    return self;
+}
+
+void
+gsr_x11_preview_free(GsrX11Preview *self)
+{
+    if (!self)
+        return;
+
+    g_clear_handle_id(&self->timer_id, g_source_remove);
+    destroy_segment(self);
+    XCloseDisplay(self->display);
+    /* Frames still on screen keep the pool alive */
+    g_rc_box_release_full(self->pool, (GDestroyNotify)pool_clear);
+    g_free(self->acc);
+    g_free(self);
+}
+
+gboolean
+gsr_x11_preview_show_monitor(GsrX11Preview *self, const char *name)
+{
+    int n = 0;
+    XRRMonitorInfo *monitors = XRRGetMonitors(self->display, self->root, True, &n);
+    gboolean found = FALSE;
+    for (int i = 0; i < n && !found; i++) {
+        char *monitor_name = XGetAtomName(self->display, monitors[i].name);
+        if (monitor_name && g_strcmp0(monitor_name, name) == 0) {
+            gsr_x11_preview_show_region(self, monitors[i].x, monitors[i].y,
+                                        monitors[i].width, monitors[i].height);
+            found = TRUE;
+        }
+        if (monitor_name)
+            XFree(monitor_name);
+    }
+    if (monitors)
+        XRRFreeMonitors(monitors);
+    return found;
+}
+
+void
+gsr_x11_preview_show_window(GsrX11Preview *self, unsigned long window)
+{
+    self->kind = window ? TARGET_WINDOW : TARGET_NONE;
+    self->window = (Window)window;
+    update_timer(self, TRUE);
+}
+
+void
+gsr_x11_preview_show_region(GsrX11Preview *self, int x, int y, int width, int height)
+{
+    self->kind = width > 0 && height > 0 ? TARGET_RECT : TARGET_NONE;
+    self->x = x;
+    self->y = y;
+    self->width = width;
+    self->height = height;
+    update_timer(self, TRUE);
+}
+
+void
+gsr_x11_preview_show_nothing(GsrX11Preview *self)
+{
+    self->kind = TARGET_NONE;
+    update_timer(self, TRUE);
+}
+
+void
+gsr_x11_preview_set_running(GsrX11Preview *self, gboolean running)
+{
+    self->running = running;
+    update_timer(self, FALSE);
+}
+
+gboolean
+gsr_x11_preview_get_cost(GsrX11Preview *self, double *ms_per_frame, double *cpu_percent)
+{
+    if (!self->have_cost)
+        return FALSE;
+    if (ms_per_frame)
+        *ms_per_frame = self->cost_ms;
+    if (cpu_percent)
+        *cpu_percent = self->cost_ms / GSR_X11_PREVIEW_INTERVAL_MS * 100.0;
+    return TRUE;
+}
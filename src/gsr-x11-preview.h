@@ -0,0 +1,71 @@
+#pragma once
+
+/*
+ * gsr-x11-preview.h — Low-rate live thumbnail of a capture target.
+ *
+ * Every GSR_X11_PREVIEW_INTERVAL_MS, while running, copies the target's
+ * pixels out of the X server with MIT-SHM (one shared segment, reused),
+ * box-filters them down to at most the requested size and hands the
+ * result over as a GdkTexture.  The texture pixels come from a small
+ * pool, so a steady preview allocates no new frame memory.
+ *
+ * Monitors are looked up by RandR output name.  A window is followed
+ * wherever it moves; what's shown is what's on screen at its position.
+ *
+ * Uses its own X11 display connection, like the window picker.
+ *
+ * X11 only — do NOT use on Wayland.
+ */
+
+#include <gdk/gdk.h>
+
+#define GSR_X11_PREVIEW_INTERVAL_MS 600
+
+typedef struct _GsrX11Preview GsrX11Preview;
+
+/* A new frame, borrowed: ref it to keep it */
+typedef void (*GsrX11PreviewFunc)(GdkTexture *frame, gpointer user_data);
+
+/**
+ * Create a stopped preview of at most max_width×max_height.  Returns NULL
+ * if the display can't be opened or lacks MIT-SHM or a 32-bit visual.
+ * If the server then can't attach the shared segment (a remote display),
+ * the preview stays blank.
+ */
+GsrX11Preview *gsr_x11_preview_new        (int               max_width,
+                                           int               max_height,
+                                           GsrX11PreviewFunc callback,
+                                           gpointer          user_data);
+
+void           gsr_x11_preview_free       (GsrX11Preview *self);
+
+/**
+ * Choose the target.  show_monitor() returns FALSE if there's no monitor
+ * of that name; show_nothing() stops sampling until the next target.
+ */
+gboolean       gsr_x11_preview_show_monitor(GsrX11Preview *self,
+                                            const char    *name);
+void           gsr_x11_preview_show_window (GsrX11Preview *self,
+                                            unsigned long  window);
+void           gsr_x11_preview_show_region (GsrX11Preview *self,
+                                            int            x,
+                                            int            y,
+                                            int            width,
+                                            int            height);
+void           gsr_x11_preview_show_nothing(GsrX11Preview *self);
+
+/**
+ * Start or pause sampling.  Starting shows a frame right away.
+ */
+void           gsr_x11_preview_set_running(GsrX11Preview *self,
+                                           gboolean       running);
+
+/**
+ * Client CPU time per frame (copy out of the segment and downscale),
+ * averaged over recent frames, and the share of one core that is at
+ * the preview rate.  The X server's side of the copy isn't included.
+ * Returns FALSE before the first frame.
+ */
+gboolean       gsr_x11_preview_get_cost   (GsrX11Preview *self,
+                                           double        *ms_per_frame,
+                                           double        *cpu_percent);
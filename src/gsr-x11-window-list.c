@@ -0,0 +1,367 @@
+#include "gsr-x11-window-list.h"
+
+#include <X11/Xatom.h>
+#include <X11/Xutil.h>
+#include <glib-unix.h>
+
+enum {
+    ATOM_NET_CLIENT_LIST,
+    ATOM_NET_WM_NAME,
+    ATOM_UTF8_STRING,
+    N_ATOMS
+};
+
+static char *atom_names[N_ATOMS] = {
+    [ATOM_NET_CLIENT_LIST] = "_NET_CLIENT_LIST",
+    [ATOM_NET_WM_NAME]     = "_NET_WM_NAME",
+    [ATOM_UTF8_STRING]     = "UTF8_STRING",
+};
+
+/* ── Internal struct ─────────────────────────────────────────────── */
+
+struct _GsrX11WindowList {
+    Display                    *display;    /* own connection */
+    Window                      root;
+    Atom                        atoms[N_ATOMS];
+    GPtrArray                  *windows;    /* GsrX11WindowInfo*, client list order, borrowed */
+    GHashTable                 *by_window;  /* Window → GsrX11WindowInfo*, owned */
+    GSource                    *source;
+    GsrX11WindowListChangedFunc changed_func;
+    gpointer                    changed_data;
+};
+
+/* ── X11 queries ─────────────────────────────────────────────────── */
+
+/* Clients can vanish between the client list changing and us reading
+   them.  A handler for the duration of a batch of queries, synced before
+   it's removed, keeps those BadWindow errors away from GDK's handler */
+static int
+ignore_x_error(Display *display G_GNUC_UNUSED, XErrorEvent *event G_GNUC_UNUSED)
+{
+    return 0;
+}
+
+static XErrorHandler
+trap_errors(void)
+{
+    return XSetErrorHandler(ignore_x_error);
+}
+
+static void
+untrap_errors(Display *display, XErrorHandler old)
+{
+    XSync(display, False);
+    XSetErrorHandler(old);
+}
+
+char *
+gsr_x11_get_window_name(Display *display, Window window,
+                        Atom net_wm_name, Atom utf8_string)
+{
+    if (window == None)
+        return NULL;
+
+    /* Try _NET_WM_NAME first (UTF-8) */
+    if (net_wm_name && utf8_string) {
+        Atom type_ret;
+        int format_ret;
+        unsigned long nitems, bytes_after;
+        unsigned char *data = NULL;
+
+        int rc = XGetWindowProperty(display, window, net_wm_name,
+                                    0, 1024, False, utf8_string,
+                                    &type_ret, &format_ret,
+                                    &nitems, &bytes_after, &data);
+        if (rc == Success && data && nitems > 0) {
+            char *name = g_strdup((const char *)data);
+            XFree(data);
+            return name;
+        }
+        if (data)
+            XFree(data);
+    }
+
+    /* Fallback: XGetWMName */
+    XTextProperty wm_name;
+    if (XGetWMName(display, window, &wm_name) && wm_name.nitems > 0) {
+        char **list = NULL;
+        int count = 0;
+        char *result = NULL;
+
+        if (Xutf8TextPropertyToTextList(display, &wm_name, &list, &count) >= 0
+            && list && count > 0 && list[0])
+        {
+            result = g_strdup(list[0]);
+        } else {
+            /* Last resort: just copy the raw value */
+            result = g_strndup((const char *)wm_name.value, wm_name.nitems);
+        }
+
+        if (list)
+            XFreeStringList(list);
+        if (wm_name.value)
+            XFree(wm_name.value);
+
+        return result;
+    }
+
+    return NULL;
+}
+
+static char *
+read_name(GsrX11WindowList *self, Window window)
+{
+    char *name = gsr_x11_get_window_name(self->display, window,
+                                         self->atoms[ATOM_NET_WM_NAME],
+                                         self->atoms[ATOM_UTF8_STRING]);
+    return name ? name : g_strdup("");
+}
+
+static char *
+read_class(GsrX11WindowList *self, Window window)
+{
+    XClassHint hint = { 0 };
+    if (!XGetClassHint(self->display, window, &hint))
+        return g_strdup("");
+
+    char *wm_class = g_strdup(hint.res_class ? hint.res_class : "");
+    if (hint.res_name)
+        XFree(hint.res_name);
+    if (hint.res_class)
+        XFree(hint.res_class);
+    return wm_class;
+}
+
+/* ── Cache ───────────────────────────────────────────────────────── */
+
+static void
+window_info_free(GsrX11WindowInfo *info)
+{
+    g_free(info->name);
+    g_free(info->wm_class);
+    g_free(info);
+}
+
+/* Class never changes; the name is kept current from PropertyNotify */
+static GsrX11WindowInfo *
+add_client(GsrX11WindowList *self, Window window)
+{
+    XSelectInput(self->display, window, PropertyChangeMask | StructureNotifyMask);
+
+    GsrX11WindowInfo *info = g_new0(GsrX11WindowInfo, 1);
+    info->window = window;
+    info->name = read_name(self, window);
+    info->wm_class = read_class(self, window);
+    return info;
+}
+
+/* Re-read _NET_CLIENT_LIST, reusing the entries of windows still on it;
+   only new clients cost queries */
+static void
+refresh_client_list(GsrX11WindowList *self)
+{
+    Atom type_ret;
+    int format_ret;
+    unsigned long nitems = 0, bytes_after;
+    unsigned char *data = NULL;
+
+    int rc = XGetWindowProperty(self->display, self->root,
+                                self->atoms[ATOM_NET_CLIENT_LIST],
+                                0, G_MAXINT32 / 4, False, XA_WINDOW,
+                                &type_ret, &format_ret,
+                                &nitems, &bytes_after, &data);
+    if (rc != Success || type_ret != XA_WINDOW || format_ret != 32)
+        nitems = 0;
+    const unsigned long *clients = (const unsigned long *)data;
+
+    GPtrArray *windows = g_ptr_array_sized_new((guint)nitems);
+    GHashTable *by_window = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL,
+                                                  (GDestroyNotify)window_info_free);
+    XErrorHandler old = trap_errors();
+    for (unsigned long i = 0; i < nitems; i++) {
+        gpointer key = GSIZE_TO_POINTER((Window)clients[i]);
+        GsrX11WindowInfo *info = NULL;
+        if (g_hash_table_contains(by_window, key))
+            continue;
+        if (!g_hash_table_steal_extended(self->by_window, key, NULL, (gpointer *)&info))
+            info = add_client(self, (Window)clients[i]);
+        g_hash_table_insert(by_window, key, info);
+        g_ptr_array_add(windows, info);
+    }
+    untrap_errors(self->display, old);
+    if (data)
+        XFree(data);
+
+    /* Left in the old table: clients that went away */
+    g_hash_table_destroy(self->by_window);
+    g_ptr_array_unref(self->windows);
+    self->by_window = by_window;
+    self->windows = windows;
+}
+
+/* Returns true if the event changed the list */
+static bool
+handle_event(GsrX11WindowList *self, const XEvent *ev)
+{
+    switch (ev->type) {
+    case PropertyNotify: {
+        const XPropertyEvent *prop = &ev->xproperty;
+        if (prop->window == self->root) {
+            if (prop->atom != self->atoms[ATOM_NET_CLIENT_LIST])
+                return false;
+            refresh_client_list(self);
+            return true;
+        }
+        if (prop->atom != self->atoms[ATOM_NET_WM_NAME] && prop->atom != XA_WM_NAME)
+            return false;
+
+        GsrX11WindowInfo *info = g_hash_table_lookup(self->by_window,
+                                                     GSIZE_TO_POINTER(prop->window));
+        if (!info)
+            return false;
+        XErrorHandler old = trap_errors();
+        char *name = read_name(self, prop->window);
+        untrap_errors(self->display, old);
+        if (g_str_equal(name, info->name)) {
+            g_free(name);
+            return false;
+        }
+        g_free(info->name);
+        info->name = name;
+        return true;
+    }
+
+    /* The WM drops it from _NET_CLIENT_LIST too, but may take a while */
+    case DestroyNotify: {
+        GsrX11WindowInfo *info = g_hash_table_lookup(self->by_window,
+                                                     GSIZE_TO_POINTER(ev->xdestroywindow.window));
+        if (!info)
+            return false;
+        g_ptr_array_remove(self->windows, info);
+        g_hash_table_remove(self->by_window, GSIZE_TO_POINTER(info->window));
+        return true;
+    }
+
+    default:
+        return false;
+    }
+}
+
+/* ── GSource dispatch — poll X events ────────────────────────────── */
+
+typedef struct {
+    GSource           source;
+    GsrX11WindowList *list;
+} ListSource;
+
+/* Xlib may have read events into its queue already; poll only when not */
+static gboolean
+list_source_prepare(GSource *source, gint *timeout)
+{
+    *timeout = -1;
+    return XPending(((ListSource *)source)->list->display) > 0;
+}
+
+static gboolean
+list_source_check(GSource *source)
+{
+    return XPending(((ListSource *)source)->list->display) > 0;
+}
+
+static gboolean
+list_source_dispatch(GSource *source,
+                     GSourceFunc callback G_GNUC_UNUSED,
+                     gpointer user_data G_GNUC_UNUSED)
+{
+    GsrX11WindowList *self = ((ListSource *)source)->list;
+
+    /* A burst of events (say, a session restoring its windows) is one change */
+    bool changed = false;
+    while (XPending(self->display)) {
+        XEvent ev;
+        XNextEvent(self->display, &ev);
+        changed |= handle_event(self, &ev);
+    }
+
+    if (changed && self->changed_func)
+        self->changed_func(self, self->changed_data);
+    return G_SOURCE_CONTINUE;
+}
+
+static GSourceFuncs list_source_funcs = {
+    .prepare  = list_source_prepare,
+    .check    = list_source_check,
+    .dispatch = list_source_dispatch,
+    .finalize = NULL,
+};
+
+/* ── Public API ──────────────────────────────────────────────────── */
+
+GsrX11WindowList *
+gsr_x11_window_list_new(void)
+{
+    /* Open our own X connection so we don't conflict with GDK */
+    Display *dpy = XOpenDisplay(NULL);
+    if (!dpy) {
+        g_warning("gsr_x11_window_list: failed to open X display");
+        return NULL;
+    }
+
+    GsrX11WindowList *self = g_new0(GsrX11WindowList, 1);
+    self->display = dpy;
+    self->root = DefaultRootWindow(dpy);
+    XInternAtoms(dpy, atom_names, N_ATOMS, False, self->atoms);
+    self->windows = g_ptr_array_new();
+    self->by_window = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL,
+                                            (GDestroyNotify)window_info_free);
+
+    /* Select before reading, so no change slips in between */
+    XSelectInput(dpy, self->root, PropertyChangeMask | SubstructureNotifyMask);
+    refresh_client_list(self);
+
+    int x_fd = ConnectionNumber(dpy);
+    self->source = g_source_new(&list_source_funcs, sizeof(ListSource));
+    ((ListSource *)self->source)->list = self;
+    g_source_add_unix_fd(self->source, x_fd, G_IO_IN | G_IO_HUP | G_IO_ERR);
+    g_source_attach(self->source, NULL);
+
+    return self;
+}
+
+void
+gsr_x11_window_list_free(GsrX11WindowList *self)
+{
+    if (!self)
+        return;
+
+    if (self->source) {
+        g_source_destroy(self->source);
+        g_source_unref(self->source);
+    }
+    g_ptr_array_unref(self->windows);
+    g_hash_table_destroy(self->by_window);
+    XCloseDisplay(self->display);
+    g_free(self);
+}
+
+guint
+gsr_x11_window_list_get_n(GsrX11WindowList *self)
+{
+    return self->windows->len;
+}
+
+const GsrX11WindowInfo *
+gsr_x11_window_list_get(GsrX11WindowList *self, guint index)
+{
+    g_return_val_if_fail(index < self->windows->len, NULL);
+    return g_ptr_array_index(self->windows, index);
+}
+
+void
+gsr_x11_window_list_set_changed_func(GsrX11WindowList           *self,
+                                     GsrX11WindowListChangedFunc func,
+                                     gpointer                    user_data)
+{
+    self->changed_func = func;
+    self->changed_data = user_data;
+}
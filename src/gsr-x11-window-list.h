@@ -0,0 +1,65 @@
+#pragma once
+
+/*
+ * gsr-x11-window-list.h — Cached list of the window manager's clients.
+ *
+ * Reads _NET_CLIENT_LIST once, with each client's name and class, and
+ * then keeps it current from events alone: PropertyNotify on the root
+ * for the list itself and on each client for its name, DestroyNotify
+ * for clients that go away.  Reading the list is a plain array access,
+ * so a chooser can open and filter it without a round trip to the X
+ * server.
+ *
+ * Uses its own X11 display connection + GLib GSource, like the window
+ * picker.  Needs an EWMH window manager; without one the list is empty.
+ *
+ * X11 only — do NOT use on Wayland.
+ */
+
+#include <X11/Xlib.h>
+#include <glib.h>
+
+typedef struct _GsrX11WindowList GsrX11WindowList;
+
+typedef struct {
+    Window  window;
+    char   *name;       /* _NET_WM_NAME or WM_NAME, never NULL */
+    char   *wm_class;   /* WM_CLASS class part, never NULL */
+} GsrX11WindowInfo;
+
+/* Called from the main loop after the list changed */
+typedef void (*GsrX11WindowListChangedFunc)(GsrX11WindowList *list,
+                                            gpointer          user_data);
+
+/**
+ * Open a connection and read the client list.  Returns NULL if the
+ * display can't be opened.
+ */
+GsrX11WindowList       *gsr_x11_window_list_new   (void);
+
+void                    gsr_x11_window_list_free  (GsrX11WindowList *self);
+
+/**
+ * Clients in _NET_CLIENT_LIST order (oldest first).  Entries are valid
+ * until the next main loop iteration.
+ */
+guint                   gsr_x11_window_list_get_n (GsrX11WindowList *self);
+const GsrX11WindowInfo *gsr_x11_window_list_get   (GsrX11WindowList *self,
+                                                   guint             index);
+
+/**
+ * Set (or, with NULL, clear) the one function told about changes.
+ */
+void                    gsr_x11_window_list_set_changed_func(GsrX11WindowList           *self,
+                                                             GsrX11WindowListChangedFunc func,
+                                                             gpointer                    user_data);
+
+/**
+ * Read a window's _NET_WM_NAME, or WM_NAME if it has none.  The atoms
+ * are passed in so callers intern them once.  Returns a g_malloc'd
+ * string, or NULL.
+ */
+char                   *gsr_x11_get_window_name   (Display *display,
+                                                   Window   window,
+                                                   Atom     net_wm_name,
+                                                   Atom     utf8_string);
@@ -1,4 +1,5 @@
 #include "gsr-x11-window-picker.h"
+#include "gsr-x11-window-list.h"
 
 #include <stdlib.h>
 #include <string.h>
@@ -16,13 +17,30 @@ struct _GsrX11WindowPicker {
     Display                   *display;     /* own connection */
     Window                     root;
     Cursor                     crosshair;
+    Atom                       net_wm_state; /* interned once, not per lookup */
+    Atom                       net_wm_name;
+    Atom                       utf8_string;
     GsrX11WindowPickCallback   callback;
+    GsrX11RegionPickCallback   region_callback; /* set when picking a region */
     void                      *userdata;
     GSource                   *source;
     guint                      source_id;
     bool                       finished;    /* prevents double callback */
+
+    /* Region pick */
+    Window                     band[4];     /* rubber-band edges, None until dragged */
+    bool                       dragging;
+    int                        start_x;
+    int                        start_y;
+    Window                     start_window; /* toplevel frame under the press */
+    GArray                    *snap_x;      /* int: window and screen edges */
+    GArray                    *snap_y;
 };
 
+#define SNAP_DISTANCE  12   /* px a corner jumps to an edge from */
+#define MIN_DRAG        4   /* px below which a drag is a click */
+#define BAND_WIDTH      2
+
 /* ── X11 tree walker ─────────────────────────────────────────────── */
 
 /**
@@ -51,13 +69,9 @@ window_has_atom(Display *display, Window window, Atom atom)
  * which is the "real" toplevel window managed by the WM.
  */
 static Window
-find_toplevel_window(Display *display, Window window)
+find_toplevel_window(Display *display, Window window, Atom wm_state)
 {
-    if (window == None)
-        return None;
-
-    Atom wm_state = XInternAtom(display, "_NET_WM_STATE", False);
-    if (!wm_state)
+    if (window == None || !wm_state)
         return None;
 
     if (window_has_atom(display, window, wm_state))
@@ -83,7 +97,7 @@ find_toplevel_window(Display *display, Window window)
     /* Second pass: recurse */
     for (int i = (int)n_children - 1; i >= 0; i--) {
         if (children[i]) {
-            Window w = find_toplevel_window(display, children[i]);
+            Window w = find_toplevel_window(display, children[i], wm_state);
             if (w != None) {
                 found = w;
                 goto done;
@@ -96,69 +110,141 @@ done:
     return found;
 }
 
-/**
- * Get the WM_NAME of a window.  Returns a g_malloc'd string, or NULL.
- */
-static char *
-get_window_name(Display *display, Window window)
+/* ── Finish the pick ─────────────────────────────────────────────── */
+
+static void
+finish_pick(GsrX11WindowPicker *self, Window window, char *name)
 {
-    if (window == None)
-        return NULL;
+    if (self->finished)
+        return;
+    self->finished = true;
 
-    /* Try _NET_WM_NAME first (UTF-8) */
-    Atom net_wm_name = XInternAtom(display, "_NET_WM_NAME", False);
-    Atom utf8_string = XInternAtom(display, "UTF8_STRING", False);
-
-    if (net_wm_name && utf8_string) {
-        Atom type_ret;
-        int format_ret;
-        unsigned long nitems, bytes_after;
-        unsigned char *data = NULL;
-
-        int rc = XGetWindowProperty(display, window, net_wm_name,
-                                    0, 1024, False, utf8_string,
-                                    &type_ret, &format_ret,
-                                    &nitems, &bytes_after, &data);
-        if (rc == Success && data && nitems > 0) {
-            char *name = g_strdup((const char *)data);
-            XFree(data);
-            return name;
-        }
-        if (data)
-            XFree(data);
+    XUngrabPointer(self->display, CurrentTime);
+    XUngrabKeyboard(self->display, CurrentTime);
+    XSync(self->display, False);
+
+    GsrX11WindowPickResult result = {
+        .window = window,
+        .name   = name,
+    };
+    self->callback(&result, self->userdata);
+
+    /* Self-destroy after callback */
+    gsr_x11_window_picker_free(self);
+}
+
+/* ── Region pick ─────────────────────────────────────────────────── */
+
+static void
+add_snap_edges(GsrX11WindowPicker *self, int x, int y, int width, int height)
+{
+    int x2 = x + width, y2 = y + height;
+    g_array_append_val(self->snap_x, x);
+    g_array_append_val(self->snap_x, x2);
+    g_array_append_val(self->snap_y, y);
+    g_array_append_val(self->snap_y, y2);
+}
+
+/* Edges of the screen and of every visible toplevel frame, collected once:
+   nothing moves while the pointer is grabbed */
+static void
+collect_snap_edges(GsrX11WindowPicker *self)
+{
+    self->snap_x = g_array_new(FALSE, FALSE, sizeof(int));
+    self->snap_y = g_array_new(FALSE, FALSE, sizeof(int));
+
+    int screen = DefaultScreen(self->display);
+    add_snap_edges(self, 0, 0, DisplayWidth(self->display, screen),
+                   DisplayHeight(self->display, screen));
+
+    Window root, parent;
+    Window *children = NULL;
+    unsigned int n_children = 0;
+    if (!XQueryTree(self->display, self->root, &root, &parent, &children, &n_children))
+        return;
+    for (unsigned int i = 0; i < n_children; i++) {
+        XWindowAttributes attr;
+        if (!XGetWindowAttributes(self->display, children[i], &attr) ||
+            attr.map_state != IsViewable || attr.class != InputOutput)
+            continue;
+        add_snap_edges(self, attr.x, attr.y,
+                       attr.width + 2 * attr.border_width,
+                       attr.height + 2 * attr.border_width);
     }
+    if (children)
+        XFree(children);
+}
 
-    /* Fallback: XGetWMName */
-    XTextProperty wm_name;
-    if (XGetWMName(display, window, &wm_name) && wm_name.nitems > 0) {
-        char **list = NULL;
-        int count = 0;
-        char *result = NULL;
-
-        if (Xutf8TextPropertyToTextList(display, &wm_name, &list, &count) >= 0
-            && list && count > 0 && list[0])
-        {
-            result = g_strdup(list[0]);
-        } else {
-            /* Last resort: just copy the raw value */
-            result = g_strndup((const char *)wm_name.value, wm_name.nitems);
+static int
+snap(const GArray *edges, int value)
+{
+    int best = value;
+    int best_distance = SNAP_DISTANCE + 1;
+    for (guint i = 0; i < edges->len; i++) {
+        int edge = g_array_index(edges, int, i);
+        int distance = ABS(edge - value);
+        if (distance < best_distance) {
+            best = edge;
+            best_distance = distance;
         }
+    }
+    return best;
+}
 
-        if (list)
-            XFreeStringList(list);
-        if (wm_name.value)
-            XFree(wm_name.value);
-
-        return result;
+/* The rectangle is four thin override-redirect windows, which a
+   compositor shows like any other (drawing on the root wouldn't be) */
+static void
+create_band(GsrX11WindowPicker *self)
+{
+    int screen = DefaultScreen(self->display);
+    unsigned long pixel = WhitePixel(self->display, screen);
+    XColor color, exact;
+    if (XAllocNamedColor(self->display, DefaultColormap(self->display, screen),
+                         "#3584e4", &color, &exact))
+        pixel = color.pixel;
+
+    XSetWindowAttributes attrs = {
+        .override_redirect = True,
+        .background_pixel  = pixel,
+    };
+    for (int i = 0; i < 4; i++) {
+        self->band[i] = XCreateWindow(self->display, self->root, 0, 0, 1, 1, 0,
+                                      CopyFromParent, InputOutput, CopyFromParent,
+                                      CWOverrideRedirect | CWBackPixel, &attrs);
     }
+}
 
-    return NULL;
+static void
+update_band(GsrX11WindowPicker *self, int x, int y, int width, int height)
+{
+    if (self->band[0] == None)
+        create_band(self);
+
+    int w = MAX(width, 1), h = MAX(height, 1);
+    int t = MIN(BAND_WIDTH, MIN(w, h));
+    XMoveResizeWindow(self->display, self->band[0], x, y, (unsigned)w, (unsigned)t);
+    XMoveResizeWindow(self->display, self->band[1], x, y + h - t, (unsigned)w, (unsigned)t);
+    XMoveResizeWindow(self->display, self->band[2], x, y, (unsigned)t, (unsigned)h);
+    XMoveResizeWindow(self->display, self->band[3], x + w - t, y, (unsigned)t, (unsigned)h);
+    for (int i = 0; i < 4; i++)
+        XMapRaised(self->display, self->band[i]);
+    XFlush(self->display);
 }
 
-/* ── Finish the pick ─────────────────────────────────────────────── */
+static void
+drag_rect(GsrX11WindowPicker *self, int x_root, int y_root,
+          GsrX11RegionPickResult *rect)
+{
+    int x = snap(self->snap_x, x_root);
+    int y = snap(self->snap_y, y_root);
+    rect->x = MIN(self->start_x, x);
+    rect->y = MIN(self->start_y, y);
+    rect->width = ABS(x - self->start_x);
+    rect->height = ABS(y - self->start_y);
+}
 
 static void
-finish_pick(GsrX11WindowPicker *self, Window window, char *name)
+finish_region(GsrX11WindowPicker *self, const GsrX11RegionPickResult *rect)
 {
     if (self->finished)
         return;
@@ -166,18 +252,88 @@ finish_pick(GsrX11WindowPicker *self, Window window, char *name)
 
     XUngrabPointer(self->display, CurrentTime);
     XUngrabKeyboard(self->display, CurrentTime);
+    for (int i = 0; i < 4; i++) {
+        if (self->band[i] != None)
+            XDestroyWindow(self->display, self->band[i]);
+        self->band[i] = None;
+    }
     XSync(self->display, False);
 
-    GsrX11WindowPickResult result = {
-        .window = window,
-        .name   = name,
-    };
-    self->callback(&result, self->userdata);
+    /* Clip to the screen; a frame can hang off its edge */
+    GsrX11RegionPickResult result = { 0 };
+    if (rect) {
+        int screen = DefaultScreen(self->display);
+        int x1 = MAX(rect->x, 0);
+        int y1 = MAX(rect->y, 0);
+        int x2 = MIN(rect->x + rect->width, DisplayWidth(self->display, screen));
+        int y2 = MIN(rect->y + rect->height, DisplayHeight(self->display, screen));
+        if (x2 > x1 && y2 > y1)
+            result = (GsrX11RegionPickResult){ x1, y1, x2 - x1, y2 - y1 };
+    }
+    self->region_callback(&result, self->userdata);
 
-    /* Self-destroy after callback */
     gsr_x11_window_picker_free(self);
 }
 
+/* Returns false once the pick is over */
+static bool
+handle_region_event(GsrX11WindowPicker *self, const XEvent *ev)
+{
+    GsrX11RegionPickResult rect;
+
+    switch (ev->type) {
+    case ButtonPress:
+        if (ev->xbutton.button != Button1) {
+            finish_region(self, NULL);
+            return false;
+        }
+        self->dragging = true;
+        self->start_x = snap(self->snap_x, ev->xbutton.x_root);
+        self->start_y = snap(self->snap_y, ev->xbutton.y_root);
+        self->start_window = ev->xbutton.subwindow;
+        return true;
+
+    case MotionNotify:
+        if (self->dragging) {
+            drag_rect(self, ev->xmotion.x_root, ev->xmotion.y_root, &rect);
+            update_band(self, rect.x, rect.y, rect.width, rect.height);
+        }
+        return true;
+
+    case ButtonRelease:
+        if (!self->dragging || ev->xbutton.button != Button1)
+            return true;
+        drag_rect(self, ev->xbutton.x_root, ev->xbutton.y_root, &rect);
+        if (rect.width < MIN_DRAG && rect.height < MIN_DRAG) {
+            /* A click takes the frame of the window under it */
+            XWindowAttributes attr;
+            if (self->start_window == None ||
+                !XGetWindowAttributes(self->display, self->start_window, &attr))
+            {
+                finish_region(self, NULL);
+                return false;
+            }
+            rect = (GsrX11RegionPickResult){
+                attr.x, attr.y,
+                attr.width + 2 * attr.border_width,
+                attr.height + 2 * attr.border_width,
+            };
+        }
+        finish_region(self, &rect);
+        return false;
+
+    case KeyPress:
+        if (XLookupKeysym((XKeyEvent *)&ev->xkey, 0) == XK_Escape) {
+            finish_region(self, NULL);
+            return false;
+        }
+        return true;
+
+    default:
+        return true;
+    }
+}
+
 /* ── GSource dispatch — poll X events ────────────────────────────── */
 
 static gboolean
@@ -207,13 +363,20 @@ picker_source_dispatch(GSource *source G_GNUC_UNUSED,
         XEvent ev;
         XNextEvent(self->display, &ev);
 
+        if (self->region_callback) {
+            if (!handle_region_event(self, &ev))
+                return G_SOURCE_REMOVE;
+            continue;
+        }
+
         if (ev.type == ButtonPress) {
             Window clicked = ev.xbutton.subwindow;
             if (clicked == None)
                 clicked = ev.xbutton.window;
 
             /* Walk tree to find the real toplevel */
-            Window toplevel = find_toplevel_window(self->display, clicked);
+            Window toplevel = find_toplevel_window(self->display, clicked,
+                                                   self->net_wm_state);
             if (toplevel != None)
                 clicked = toplevel;
 
@@ -223,7 +386,8 @@ picker_source_dispatch(GSource *source G_GNUC_UNUSED,
                 return G_SOURCE_REMOVE;
             }
 
-            char *name = get_window_name(self->display, clicked);
+            char *name = gsr_x11_get_window_name(self->display, clicked,
+                                                 self->net_wm_name, self->utf8_string);
             if (!name)
                 name = g_strdup("(no name)");
 
@@ -252,13 +416,10 @@ static GSourceFuncs picker_source_funcs = {
 
 /* ── Public API ──────────────────────────────────────────────────── */
 
-GsrX11WindowPicker *
-gsr_x11_window_picker_new(GsrX11WindowPickCallback callback,
-                           void *userdata)
+/* Open a connection, grab and start polling; event_mask for the pointer */
+static GsrX11WindowPicker *
+picker_new(unsigned int event_mask, void *userdata)
 {
-    if (!callback)
-        return NULL;
-
     /* Open our own X connection so we don't conflict with GDK */
     Display *dpy = XOpenDisplay(NULL);
     if (!dpy) {
@@ -269,15 +430,20 @@ gsr_x11_window_picker_new(GsrX11WindowPickCallback callback,
     GsrX11WindowPicker *self = g_new0(GsrX11WindowPicker, 1);
     self->display   = dpy;
     self->root      = DefaultRootWindow(dpy);
-    self->callback  = callback;
     self->userdata  = userdata;
     self->finished  = false;
 
     self->crosshair = XCreateFontCursor(dpy, XC_crosshair);
 
+    char *atom_names[] = { "_NET_WM_STATE", "_NET_WM_NAME", "UTF8_STRING" };
+    Atom atoms[G_N_ELEMENTS(atom_names)];
+    XInternAtoms(dpy, atom_names, G_N_ELEMENTS(atom_names), False, atoms);
+    self->net_wm_state = atoms[0];
+    self->net_wm_name  = atoms[1];
+    self->utf8_string  = atoms[2];
+
     /* Grab pointer with crosshair */
-    int status = XGrabPointer(dpy, self->root, False,
-                              ButtonPressMask | ButtonReleaseMask,
+    int status = XGrabPointer(dpy, self->root, False, event_mask,
                               GrabModeAsync, GrabModeAsync,
                               self->root, self->crosshair, CurrentTime);
     if (status != GrabSuccess) {
@@ -304,6 +470,35 @@ gsr_x11_window_picker_new(GsrX11WindowPickCallback callback,
     return self;
 }
 
+GsrX11WindowPicker *
+gsr_x11_window_picker_new(GsrX11WindowPickCallback callback,
+                           void *userdata)
+{
+    if (!callback)
+        return NULL;
+
+    GsrX11WindowPicker *self = picker_new(ButtonPressMask | ButtonReleaseMask, userdata);
+    if (self)
+        self->callback = callback;
+    return self;
+}
+
+GsrX11WindowPicker *
+gsr_x11_region_picker_new(GsrX11RegionPickCallback callback,
+                           void *userdata)
+{
+    if (!callback)
+        return NULL;
+
+    GsrX11WindowPicker *self = picker_new(ButtonPressMask | ButtonReleaseMask |
+                                          PointerMotionMask, userdata);
+    if (self) {
+        self->region_callback = callback;
+        collect_snap_edges(self);
+    }
+    return self;
+}
+
 void
 gsr_x11_window_picker_free(GsrX11WindowPicker *self)
 {
@@ -321,9 +516,14 @@ gsr_x11_window_picker_free(GsrX11WindowPicker *self)
         XUngrabKeyboard(self->display, CurrentTime);
         if (self->crosshair)
             XFreeCursor(self->display, self->crosshair);
+        /* Also destroys the rubber band */
         XCloseDisplay(self->display);
         self->display = NULL;
     }
 
+    if (self->snap_x)
+        g_array_unref(self->snap_x);
+    if (self->snap_y)
+        g_array_unref(self->snap_y);
     g_free(self);
 }
@@ -7,6 +7,10 @@
  * walks the X11 window tree to find the real toplevel, and reports
  * the result via callback.
  *
+ * The same grab can pick a region instead: the user drags a rubber-band
+ * rectangle whose corners snap to nearby window and screen edges, or
+ * clicks to take a whole window's frame.
+ *
  * Uses its own X11 display connection + GLib GSource to avoid
  * interfering with GDK's event loop.
  *
@@ -35,6 +39,20 @@ typedef struct {
 typedef void (*GsrX11WindowPickCallback)(const GsrX11WindowPickResult *result,
                                           void *userdata);
 
+/**
+ * Result of a region pick, in root window coordinates.  width and height
+ * are 0 if the pick was cancelled (Escape or right button).
+ */
+typedef struct {
+    int x;
+    int y;
+    int width;
+    int height;
+} GsrX11RegionPickResult;
+
+typedef void (*GsrX11RegionPickCallback)(const GsrX11RegionPickResult *result,
+                                          void *userdata);
+
 /**
  * Create a window picker.  Returns NULL on failure (e.g. cannot open
  * X display or grab pointer).
@@ -49,6 +67,13 @@ typedef void (*GsrX11WindowPickCallback)(const GsrX11WindowPickResult *result,
 GsrX11WindowPicker *gsr_x11_window_picker_new(GsrX11WindowPickCallback callback,
                                                 void *userdata);
 
+/**
+ * Create a region picker.  Same lifetime rules as a window picker:
+ * destroyed after @callback fires, or with gsr_x11_window_picker_free().
+ */
+GsrX11WindowPicker *gsr_x11_region_picker_new(GsrX11RegionPickCallback callback,
+                                                void *userdata);
+
 /**
  * Cancel and destroy an in-progress pick.
  * Safe to call if picker is NULL.
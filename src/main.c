@@ -120,6 +120,25 @@ on_open_folder_action(GSimpleAction *action,
         on_open_folder_finished, NULL);
 }
 
+/* ── Save replay (also reachable over D-Bus as org.gtk.Actions) ──── */
+
+static void
+on_save_replay_action(GSimpleAction *action,
+                      GVariant      *parameter,
+                      gpointer       user_data)
+{
+    (void)action;
+
+    GtkApplication *app = GTK_APPLICATION(user_data);
+    GtkWindow *win = gtk_application_get_active_window(app);
+    if (!win || !GSR_IS_WINDOW(win))
+        return;
+
+    /* Trailing seconds to save, 0 for the whole replay buffer */
+    int seconds = parameter ? g_variant_get_int32(parameter) : 0;
+    gsr_window_hotkey_save_replay(GSR_WINDOW(win), seconds);
+}
+
 /* ── Application activate ────────────────────────────────────────── */
 
 static void
@@ -159,6 +178,7 @@ int
 main(int argc, char *argv[])
 {
     setlocale(LC_ALL, "");
+
     bindtextdomain(GETTEXT_PACKAGE, GSR_LOCALEDIR);
     bind_textdomain_codeset(GETTEXT_PACKAGE, "UTF-8");
     textdomain(GETTEXT_PACKAGE);
@@ -172,6 +192,8 @@ main(int argc, char *argv[])
         { .name = "about", .activate = on_about_action },
         { .name = "open-folder", .activate = on_open_folder_action,
           .parameter_type = "s" },
+        { .name = "save-replay", .activate = on_save_replay_action,
+          .parameter_type = "i" },
     };
     g_action_map_add_action_entries(G_ACTION_MAP(app),
         app_actions, G_N_ELEMENTS(app_actions), app);
@@ -0,0 +1,80 @@
+#include "gsr-test-util.h"
+
+#include <glib/gstdio.h>
+
+/* ── Temporary directory ─────────────────────────────────────────── */
+
+void
+gsr_test_tmp_dir_setup(GsrTestTmpDir *tmp, gconstpointer data G_GNUC_UNUSED)
+{
+    g_autofree char *tmpl = g_strdup_printf("gsr-%s-XXXXXX", g_get_prgname());
+    tmp->dir = g_dir_make_tmp(tmpl, NULL);
+    g_assert_nonnull(tmp->dir);
+}
+
+void
+gsr_test_tmp_dir_teardown(GsrTestTmpDir *tmp, gconstpointer data G_GNUC_UNUSED)
+{
+    gsr_test_remove_tree(tmp->dir);
+    g_clear_pointer(&tmp->dir, g_free);
+}
+
+char *
+gsr_test_tmp_path(const GsrTestTmpDir *tmp, const char *name)
+{
+    return g_build_filename(tmp->dir, name, NULL);
+}
+
+void
+gsr_test_remove_tree(const char *path)
+{
+    GDir *dir = g_dir_open(path, 0, NULL);
+    if (dir) {
+        const char *name;
+        while ((name = g_dir_read_name(dir))) {
+            g_autofree char *child = g_build_filename(path, name, NULL);
+            if (g_file_test(child, G_FILE_TEST_IS_DIR) &&
+                !g_file_test(child, G_FILE_TEST_IS_SYMLINK))
+                gsr_test_remove_tree(child);
+            else
+                g_unlink(child);
+        }
+        g_dir_close(dir);
+    }
+    g_rmdir(path);
+}
+
+/* ── Main loop ───────────────────────────────────────────────────── */
+
+static gboolean
+on_timeout(gpointer user_data)
+{
+    *(gboolean *)user_data = TRUE;
+    return G_SOURCE_REMOVE;
+}
+
+static gboolean
+value_reached(gpointer user_data)
+{
+    const int *const *args = user_data;   /* { value, &target } */
+    return args[0] && *args[0] >= *args[1];
+}
+
+void
+gsr_test_iterate_until(const int *value, int target, guint timeout_ms)
+{
+    const int *args[] = { value, &target };
+    gsr_test_iterate_until_cond(value_reached, args, timeout_ms);
+}
+
+gboolean
+gsr_test_iterate_until_cond(GsrTestCondition cond, gpointer user_data, guint timeout_ms)
+{
+    gboolean timed_out = FALSE;
+    guint id = g_timeout_add(timeout_ms, on_timeout, &timed_out);
+    while (!timed_out && (!cond || !cond(user_data)))
+        g_main_context_iteration(NULL, TRUE);
+    if (!timed_out)
+        g_source_remove(id);
+    return !timed_out;
+}
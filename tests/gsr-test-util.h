@@ -0,0 +1,47 @@
+#pragma once
+
+/*
+ * gsr-test-util.h — Shared pieces of the unit tests: a temporary directory
+ * per test, and running the main loop until something happened.
+ */
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/**
+ * A fresh directory for one test, named after the test program.  Embed it
+ * first in a Fixture, or pass these to g_test_add() as they are when the
+ * directory is all a test needs.  Teardown removes it with its contents.
+ */
+typedef struct {
+    char *dir;
+} GsrTestTmpDir;
+
+void      gsr_test_tmp_dir_setup    (GsrTestTmpDir *tmp,
+                                     gconstpointer  data);
+void      gsr_test_tmp_dir_teardown (GsrTestTmpDir *tmp,
+                                     gconstpointer  data);
+
+/* A path in the directory; caller must g_free() */
+char     *gsr_test_tmp_path         (const GsrTestTmpDir *tmp,
+                                     const char          *name);
+
+/* rm -r, without following symlinks */
+void      gsr_test_remove_tree      (const char *path);
+
+typedef gboolean (*GsrTestCondition)(gpointer user_data);
+
+/**
+ * Run the main loop until *value reaches target (with NULL, for the whole
+ * timeout), or until cond holds.  The latter returns whether it did in
+ * time.
+ */
+void      gsr_test_iterate_until    (const int *value,
+                                     int        target,
+                                     guint      timeout_ms);
+gboolean  gsr_test_iterate_until_cond(GsrTestCondition cond,
+                                      gpointer         user_data,
+                                      guint            timeout_ms);
+
+G_END_DECLS
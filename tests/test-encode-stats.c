@@ -0,0 +1,185 @@
+/*
+ * gsr-encode-stats.c: recorder lines, derived dropped frames and
+ * bitrate, and the fixed history rings.
+ */
+
+#include "gsr-encode-stats.h"
+#include "gsr-test-util.h"
+
+#include <glib/gstdio.h>
+
+#define SECOND G_USEC_PER_SEC
+
+static void
+test_parse_line(void)
+{
+    GsrEncodeStats stats;
+    gsr_encode_stats_reset(&stats, 60);
+
+    /* Recent recorders */
+    g_assert_true(gsr_encode_stats_parse_line(&stats, "update fps: 59, damage fps: 41"));
+    g_assert_true(stats.have_reported_fps);
+    g_assert_cmpfloat(stats.reported_fps, ==, 59.0);
+
+    /* Older ones */
+    g_assert_true(gsr_encode_stats_parse_line(&stats, "fps: 29.5"));
+    g_assert_cmpfloat(stats.reported_fps, ==, 29.5);
+
+    /* Not statistics: logged as they are, reading untouched */
+    g_assert_false(gsr_encode_stats_parse_line(&stats, "damage fps: 41"));
+    g_assert_false(gsr_encode_stats_parse_line(&stats, "gsr info: fps: set to 60"));
+    g_assert_false(gsr_encode_stats_parse_line(&stats, "fps: n/a"));
+    g_assert_false(gsr_encode_stats_parse_line(&stats, "update fps:"));
+    g_assert_false(gsr_encode_stats_parse_line(&stats, "fps: -3"));
+    g_assert_false(gsr_encode_stats_parse_line(&stats, ""));
+    g_assert_cmpfloat(stats.reported_fps, ==, 29.5);
+
+    /* Only the last reading before a sample counts */
+    gsr_encode_stats_parse_line(&stats, "update fps: 60, damage fps: 60");
+    gsr_encode_stats_sample(&stats, NULL, SECOND);
+    g_assert_false(stats.have_reported_fps);
+    double fps[4];
+    g_assert_cmpuint(gsr_encode_stats_history(&stats, GSR_ENCODE_STAT_FPS, fps, 4), ==, 1);
+    g_assert_cmpfloat(fps[0], ==, 60.0);
+
+    /* No new line: no new sample */
+    gsr_encode_stats_sample(&stats, NULL, 2 * SECOND);
+    g_assert_cmpuint(gsr_encode_stats_history(&stats, GSR_ENCODE_STAT_FPS, fps, 4), ==, 1);
+}
+
+static void
+test_dropped(void)
+{
+    GsrEncodeStats stats;
+    gsr_encode_stats_reset(&stats, 60);
+    g_assert_false(gsr_encode_stats_has(&stats, GSR_ENCODE_STAT_DROPPED));
+    g_assert_cmpfloat(gsr_encode_stats_latest(&stats, GSR_ENCODE_STAT_DROPPED), ==, 0.0);
+
+    gsr_encode_stats_parse_line(&stats, "update fps: 57, damage fps: 57");
+    gsr_encode_stats_sample(&stats, NULL, SECOND);
+    g_assert_cmpfloat(gsr_encode_stats_latest(&stats, GSR_ENCODE_STAT_DROPPED), ==, 3.0);
+
+    /* Above the target is not negative drops */
+    gsr_encode_stats_parse_line(&stats, "update fps: 61, damage fps: 61");
+    gsr_encode_stats_sample(&stats, NULL, 2 * SECOND);
+    g_assert_cmpfloat(gsr_encode_stats_latest(&stats, GSR_ENCODE_STAT_DROPPED), ==, 0.0);
+
+    /* Fractions are rounded into the total */
+    gsr_encode_stats_parse_line(&stats, "fps: 57.4");
+    gsr_encode_stats_sample(&stats, NULL, 3 * SECOND);
+    g_assert_cmpfloat_with_epsilon(gsr_encode_stats_latest(&stats, GSR_ENCODE_STAT_DROPPED),
+                                   2.6, 1e-9);
+    g_assert_cmpuint(stats.total_dropped, ==, 3 + 0 + 3);
+
+    /* Variable frame rate: there is no target to fall short of */
+    gsr_encode_stats_reset(&stats, 0);
+    gsr_encode_stats_parse_line(&stats, "update fps: 12, damage fps: 12");
+    gsr_encode_stats_sample(&stats, NULL, SECOND);
+    g_assert_true(gsr_encode_stats_has(&stats, GSR_ENCODE_STAT_FPS));
+    g_assert_false(gsr_encode_stats_has(&stats, GSR_ENCODE_STAT_DROPPED));
+    g_assert_cmpuint(stats.total_dropped, ==, 0);
+}
+
+static void
+grow_file(const char *path, gsize size)
+{
+    g_autofree char *contents = g_malloc0(size);
+    g_assert_true(g_file_set_contents(path, contents, (gssize)size, NULL));
+}
+
+static void
+test_bitrate(GsrTestTmpDir *tmp, gconstpointer data G_GNUC_UNUSED)
+{
+    g_autofree char *path = gsr_test_tmp_path(tmp, "Video.mp4");
+    GsrEncodeStats stats;
+    gsr_encode_stats_reset(&stats, 60);
+
+    /* Nothing written yet, or no file at all */
+    gsr_encode_stats_sample(&stats, path, SECOND);
+    gsr_encode_stats_sample(&stats, NULL, SECOND);
+    g_assert_false(gsr_encode_stats_has(&stats, GSR_ENCODE_STAT_FILE_SIZE));
+    g_assert_false(gsr_encode_stats_has(&stats, GSR_ENCODE_STAT_BITRATE));
+
+    /* The first size is only a starting point */
+    grow_file(path, 1000);
+    gsr_encode_stats_sample(&stats, path, 2 * SECOND);
+    g_assert_cmpfloat(gsr_encode_stats_latest(&stats, GSR_ENCODE_STAT_FILE_SIZE), ==, 1000.0);
+    g_assert_false(gsr_encode_stats_has(&stats, GSR_ENCODE_STAT_BITRATE));
+
+    /* 125000 bytes in a second */
+    grow_file(path, 126000);
+    gsr_encode_stats_sample(&stats, path, 3 * SECOND);
+    g_assert_cmpfloat(gsr_encode_stats_latest(&stats, GSR_ENCODE_STAT_FILE_SIZE), ==, 126000.0);
+    g_assert_cmpfloat(gsr_encode_stats_latest(&stats, GSR_ENCODE_STAT_BITRATE), ==, 1000000.0);
+
+    /* The same over half a second is twice the rate */
+    grow_file(path, 251000);
+    gsr_encode_stats_sample(&stats, path, 3 * SECOND + SECOND / 2);
+    g_assert_cmpfloat(gsr_encode_stats_latest(&stats, GSR_ENCODE_STAT_BITRATE), ==, 2000000.0);
+
+    /* No time passed: no rate */
+    gsr_encode_stats_sample(&stats, path, 3 * SECOND + SECOND / 2);
+    double rates[8];
+    g_assert_cmpuint(gsr_encode_stats_history(&stats, GSR_ENCODE_STAT_BITRATE, rates, 8), ==, 2);
+
+    /* A new, smaller file is not a negative rate */
+    grow_file(path, 10);
+    gsr_encode_stats_sample(&stats, path, 5 * SECOND);
+    g_assert_cmpfloat(gsr_encode_stats_latest(&stats, GSR_ENCODE_STAT_BITRATE), ==, 0.0);
+    g_assert_cmpfloat(gsr_encode_stats_latest(&stats, GSR_ENCODE_STAT_FILE_SIZE), ==, 10.0);
+
+    /* Once the file is gone, earlier samples stay */
+    g_assert_cmpint(g_unlink(path), ==, 0);
+    gsr_encode_stats_sample(&stats, path, 6 * SECOND);
+    g_assert_cmpuint(gsr_encode_stats_history(&stats, GSR_ENCODE_STAT_BITRATE, rates, 8), ==, 3);
+}
+
+static void
+test_ring_wrap(void)
+{
+    GsrEncodeStats stats;
+    gsr_encode_stats_reset(&stats, 0);
+    guint n = GSR_ENCODE_STATS_HISTORY + 5;
+
+    for (guint i = 0; i < n; i++) {
+        char line[32];
+        g_snprintf(line, sizeof(line), "fps: %u", i);
+        g_assert_true(gsr_encode_stats_parse_line(&stats, line));
+        gsr_encode_stats_sample(&stats, NULL, (gint64)(i + 1) * SECOND);
+
+        const GsrEncodeStatRing *ring = &stats.rings[GSR_ENCODE_STAT_FPS];
+        g_assert_cmpuint(ring->count, ==, MIN(i + 1, GSR_ENCODE_STATS_HISTORY));
+        g_assert_cmpfloat(gsr_encode_stats_latest(&stats, GSR_ENCODE_STAT_FPS), ==, (double)i);
+    }
+
+    /* The oldest five were overwritten; the rest come oldest first */
+    double values[GSR_ENCODE_STATS_HISTORY + 10];
+    guint got = gsr_encode_stats_history(&stats, GSR_ENCODE_STAT_FPS, values, G_N_ELEMENTS(values));
+    g_assert_cmpuint(got, ==, GSR_ENCODE_STATS_HISTORY);
+    for (guint i = 0; i < got; i++)
+        g_assert_cmpfloat(values[i], ==, (double)(i + 5));
+
+    /* Fewer than held: the most recent ones */
+    got = gsr_encode_stats_history(&stats, GSR_ENCODE_STAT_FPS, values, 3);
+    g_assert_cmpuint(got, ==, 3);
+    g_assert_cmpfloat(values[0], ==, (double)(n - 3));
+    g_assert_cmpfloat(values[2], ==, (double)(n - 1));
+
+    /* A new capture starts empty */
+    gsr_encode_stats_reset(&stats, 60);
+    g_assert_false(gsr_encode_stats_has(&stats, GSR_ENCODE_STAT_FPS));
+    g_assert_cmpuint(gsr_encode_stats_history(&stats, GSR_ENCODE_STAT_FPS, values, 3), ==, 0);
+    g_assert_cmpint(stats.last_size, ==, -1);
+}
+
+int
+main(int argc, char **argv)
+{
+    g_test_init(&argc, &argv, NULL);
+
+    g_test_add_func("/encode-stats/parse-line", test_parse_line);
+    g_test_add_func("/encode-stats/dropped", test_dropped);
+    g_test_add("/encode-stats/bitrate", GsrTestTmpDir, NULL, gsr_test_tmp_dir_setup, test_bitrate, gsr_test_tmp_dir_teardown);
+    g_test_add_func("/encode-stats/ring-wrap", test_ring_wrap);
+    return g_test_run();
+}
@@ -0,0 +1,446 @@
+/*
+ * gsr-info.c: the --info sections, cards read from a fake /sys, their
+ * environments, and the per-card probe cache.  The .c is included to
+ * reach info_load() and load_info(), which take the recorder command and
+ * the sysfs root; a shell stub stands in for gpu-screen-recorder.
+ */
+
+#include "gsr-info.c"
+#include "gsr-test-util.h"
+
+#include <unistd.h>
+#include <glib/gstdio.h>
+
+/*
+ * Prints the file "info", or "info-<tag>" when there is one for the
+ * environment it runs in: the DRI_PRIME value, or "nvidia" when offloaded.
+ * Every run appends its tag and arguments to "calls", and exits with the
+ * number in "exit" if there is one.  --help prints "help", unlogged.
+ */
+static const char stub_script[] =
+    "#!/bin/sh\n"
+    "dir=%s\n"
+    "if [ \"$1\" = --help ]; then cat \"$dir/help\" 2>/dev/null; exit 0; fi\n"
+    "tag=${DRI_PRIME:-plain}\n"
+    "[ -n \"$__NV_PRIME_RENDER_OFFLOAD\" ] && tag=nvidia\n"
+    "echo \"$tag $*\" >> \"$dir/calls\"\n"
+    "if [ -f \"$dir/info-$tag\" ]; then cat \"$dir/info-$tag\"; else cat \"$dir/info\"; fi\n"
+    "[ -f \"$dir/exit\" ] && exit \"$(cat \"$dir/exit\")\"\n"
+    "exit 0\n";
+
+#define INTEL_SLOT  "0000:00:02.0"
+#define AMD_SLOT    "0000:03:00.0"
+#define INTEL_ENV   "DRI_PRIME=pci-0000_00_02_0"
+#define AMD_ENV     "DRI_PRIME=pci-0000_03_00_0"
+
+typedef struct {
+    GsrTestTmpDir tmp;
+    char         *sysfs;
+    char         *recorder;     /* the stub, quoted for the shell */
+    char         *cache_path;
+} Fixture;
+
+static void
+write_tmp_file(const Fixture *f, const char *name, const char *contents)
+{
+    g_autofree char *path = gsr_test_tmp_path(&f->tmp, name);
+    g_assert_true(g_file_set_contents(path, contents, -1, NULL));
+}
+
+/* /sys/class/drm/<card>/device, a link to the PCI device at slot with
+   a vendor file; without a slot, a card with no device at all */
+static void
+add_sysfs_card(const Fixture *f, const char *card, const char *slot, const char *vendor)
+{
+    g_autofree char *card_dir = g_build_filename(f->sysfs, "class", "drm", card, NULL);
+    g_assert_cmpint(g_mkdir_with_parents(card_dir, 0755), ==, 0);
+    if (!slot)
+        return;
+
+    g_autofree char *device_dir = g_build_filename(f->sysfs, "devices", "pci0000:00", slot, NULL);
+    g_assert_cmpint(g_mkdir_with_parents(device_dir, 0755), ==, 0);
+    if (vendor) {
+        g_autofree char *vendor_path = g_build_filename(device_dir, "vendor", NULL);
+        g_assert_true(g_file_set_contents(vendor_path, vendor, -1, NULL));
+    }
+
+    g_autofree char *link = g_build_filename(card_dir, "device", NULL);
+    g_autofree char *target = g_build_filename("..", "..", "..", "devices", "pci0000:00", slot, NULL);
+    g_assert_cmpint(symlink(target, link), ==, 0);
+}
+
+static void
+fixture_setup(Fixture *f, gconstpointer data)
+{
+    gsr_test_tmp_dir_setup(&f->tmp, data);
+    f->sysfs = gsr_test_tmp_path(&f->tmp, "sys");
+    f->cache_path = gsr_test_tmp_path(&f->tmp, "cache/gpu-probes");
+
+    g_autofree char *stub = gsr_test_tmp_path(&f->tmp, "gpu-screen-recorder");
+    g_autofree char *quoted_dir = g_shell_quote(f->tmp.dir);
+    g_autofree char *script = g_strdup_printf(stub_script, quoted_dir);
+    g_assert_true(g_file_set_contents(stub, script, -1, NULL));
+    g_assert_cmpint(g_chmod(stub, 0755), ==, 0);
+    f->recorder = g_shell_quote(stub);
+
+    add_sysfs_card(f, "card0", INTEL_SLOT, "0x8086\n");
+    add_sysfs_card(f, "card1", AMD_SLOT, "0x1002\n");
+    add_sysfs_card(f, "card2", NULL, NULL);
+}
+
+static void
+fixture_teardown(Fixture *f, gconstpointer data)
+{
+    gsr_test_tmp_dir_teardown(&f->tmp, data);
+    g_free(f->sysfs);
+    g_free(f->recorder);
+    g_free(f->cache_path);
+}
+
+/* The stub's runs since the last call, one "tag args" line each */
+static GStrv
+take_calls(const Fixture *f)
+{
+    g_autofree char *path = gsr_test_tmp_path(&f->tmp, "calls");
+    g_autofree char *contents = NULL;
+    if (!g_file_get_contents(path, &contents, NULL, NULL))
+        return g_new0(char *, 1);
+    g_unlink(path);
+    g_strchomp(contents);
+    return g_strsplit(contents, "\n", -1);
+}
+
+static void
+load_stub(const Fixture *f, GsrInfo *info, int *exit_code)
+{
+    g_autofree char *cmd = g_strdup_printf("%s --info", f->recorder);
+    g_assert_true(load_info(info, cmd, f->sysfs, exit_code, NULL));
+}
+
+/* ── Parsing ─────────────────────────────────────────────────────── */
+
+static void
+test_parse(Fixture *f, gconstpointer data G_GNUC_UNUSED)
+{
+    write_tmp_file(f, "info",
+        "section=system_info\n"
+        "display_server|wayland\n"
+        "is_steam_deck|no\n"
+        "supports_app_audio|yes\n"
+        "section=gpu_info\n"
+        "vendor|amd\n"
+        "section=video_codecs\n"
+        "h264\n"
+        "hevc_10bit\n"
+        "av1\n"
+        "x265\n"
+        "section=image_formats\n"
+        "jpeg\n"
+        "DP-9|1x1\n"
+        "section=capture_options\n"
+        "window\n"
+        "portal\n"
+        "DP-1|2560x1440\n"
+        "\n"
+        "HDMI-A-1|1920x1080\n"
+        "eDP-1\n");
+
+    GsrInfo info;
+    int exit_code = -1;
+    load_stub(f, &info, &exit_code);
+    g_assert_cmpint(exit_code, ==, 0);
+
+    g_assert_cmpint(info.system_info.display_server, ==, GSR_DISPLAY_SERVER_WAYLAND);
+    g_assert_false(info.system_info.is_steam_deck);
+    g_assert_true(info.system_info.supports_app_audio);
+    g_assert_cmpint(info.gpu_info.vendor, ==, GSR_GPU_VENDOR_AMD);
+
+    /* Codecs it doesn't know, and sections it doesn't, are skipped */
+    const GsrSupportedVideoCodecs *vc = &info.supported_video_codecs;
+    g_assert_true(vc->h264);
+    g_assert_true(vc->hevc_10bit);
+    g_assert_true(vc->av1);
+    g_assert_false(vc->hevc);
+    g_assert_false(vc->vp9);
+
+    g_assert_true(info.supported_capture_options.window);
+    g_assert_true(info.supported_capture_options.portal);
+    g_assert_false(info.supported_capture_options.focused);
+    g_assert_cmpint(info.supported_capture_options.n_monitors, ==, 3);
+    const GsrMonitor *m = info.supported_capture_options.monitors;
+    g_assert_cmpstr(m[0].name, ==, "DP-1");
+    g_assert_cmpint(m[0].width, ==, 2560);
+    g_assert_cmpint(m[0].height, ==, 1440);
+    g_assert_cmpstr(m[1].name, ==, "HDMI-A-1");
+    g_assert_cmpstr(m[2].name, ==, "eDP-1");
+    g_assert_cmpint(m[2].width, ==, 0);
+    g_assert_cmpint(info.gpu_info.n_cards, ==, 0);
+    gsr_info_clear(&info);
+
+    /* Partial saves only when the usage text documents their signals */
+    g_assert_cmpint(info_load(&info, NULL, f->recorder, f->sysfs), ==, GSR_INFO_EXIT_OK);
+    g_assert_false(info.system_info.supports_partial_saves);
+    gsr_info_clear(&info);
+    write_tmp_file(f, "help",
+        "usage: gpu-screen-recorder -w <window_id|monitor|focused|portal|region> ...\n"
+        "  Send signal SIGUSR1 to save a replay (when in replay mode).\n");
+    g_assert_cmpint(info_load(&info, NULL, f->recorder, f->sysfs), ==, GSR_INFO_EXIT_OK);
+    g_assert_false(info.system_info.supports_partial_saves);
+    gsr_info_clear(&info);
+    write_tmp_file(f, "help",
+        "usage: gpu-screen-recorder -w <window_id|monitor|focused|portal|region> ...\n"
+        "  Send signal SIGUSR1 to save a replay (when in replay mode).\n"
+        "  Send signal SIGRTMIN+1 to save a replay of the last 10 seconds.\n");
+    g_assert_cmpint(info_load(&info, NULL, f->recorder, f->sysfs), ==, GSR_INFO_EXIT_OK);
+    g_assert_true(info.system_info.supports_partial_saves);
+    gsr_info_clear(&info);
+
+    /* Recorders' own failures come through as they are */
+    write_tmp_file(f, "exit", "22");
+    g_assert_cmpint(info_load(&info, NULL, f->recorder, f->sysfs), ==, GSR_INFO_EXIT_OPENGL_FAILED);
+    gsr_info_clear(&info);
+    write_tmp_file(f, "exit", "23");
+    g_assert_cmpint(info_load(&info, NULL, f->recorder, f->sysfs), ==, GSR_INFO_EXIT_NO_DRM_CARD);
+    gsr_info_clear(&info);
+    write_tmp_file(f, "exit", "1");
+    g_assert_cmpint(info_load(&info, NULL, f->recorder, f->sysfs), ==, GSR_INFO_EXIT_FAILED_TO_RUN);
+    gsr_info_clear(&info);
+}
+
+static void
+test_cards(Fixture *f, gconstpointer data G_GNUC_UNUSED)
+{
+    /* card3 is listed but not in /sys; card4's device has no vendor */
+    add_sysfs_card(f, "card4", "0000:05:00.0", NULL);
+    write_tmp_file(f, "info",
+        "section=capture_options\n"
+        "/dev/dri/card0|DP-1\n"
+        "/dev/dri/card1\n"
+        "DP-1|1920x1080\n"
+        "/dev/dri/card2\n"
+        "/dev/dri/card3\n"
+        "/dev/dri/card4\n");
+
+    GsrInfo info;
+    int exit_code = -1;
+    load_stub(f, &info, &exit_code);
+
+    /* Cards aren't monitors */
+    g_assert_cmpint(info.supported_capture_options.n_monitors, ==, 1);
+    g_assert_cmpint(info.gpu_info.n_cards, ==, 5);
+    const GsrDrmCard *cards = info.gpu_info.cards;
+
+    g_assert_cmpstr(cards[0].path, ==, "/dev/dri/card0");
+    g_assert_cmpstr(cards[0].pci_slot, ==, INTEL_SLOT);
+    g_assert_cmpint(cards[0].vendor, ==, GSR_GPU_VENDOR_INTEL);
+    g_assert_cmpstr(cards[1].path, ==, "/dev/dri/card1");
+    g_assert_cmpstr(cards[1].pci_slot, ==, AMD_SLOT);
+    g_assert_cmpint(cards[1].vendor, ==, GSR_GPU_VENDOR_AMD);
+    for (int i = 2; i < 5; i++) {
+        g_assert_null(cards[i].pci_slot);
+        g_assert_cmpint(cards[i].vendor, ==, GSR_GPU_VENDOR_UNKNOWN);
+        g_assert_false(cards[i].probed);
+    }
+
+    g_assert_cmpint(gsr_info_find_card(&info, "/dev/dri/card1"), ==, 1);
+    g_assert_cmpint(gsr_info_find_card(&info, "/dev/dri/card9"), ==, -1);
+    g_assert_cmpint(gsr_info_find_card(&info, NULL), ==, -1);
+    gsr_info_clear(&info);
+}
+
+/* ── Card environments ───────────────────────────────────────────── */
+
+static void
+assert_environ(const GsrInfo *info, int index, const char *expected)
+{
+    g_auto(GStrv) env = gsr_info_get_card_environ(info, index);
+    if (!expected) {
+        g_assert_null(env);
+        return;
+    }
+    g_assert_nonnull(env);
+    g_assert_cmpstr(env[0], ==, expected);
+    g_assert_null(env[1]);
+}
+
+static void
+test_card_environ(Fixture *f, gconstpointer data G_GNUC_UNUSED)
+{
+    write_tmp_file(f, "info",
+        "section=capture_options\n"
+        "/dev/dri/card0\n"
+        "/dev/dri/card1\n"
+        "/dev/dri/card2\n");
+
+    GsrInfo info;
+    int exit_code = -1;
+    load_stub(f, &info, &exit_code);
+
+    /* Mesa's tag for the slot; nothing to pick a card without one */
+    assert_environ(&info, 0, INTEL_ENV);
+    assert_environ(&info, 1, AMD_ENV);
+    assert_environ(&info, 2, NULL);
+    assert_environ(&info, -1, NULL);
+    assert_environ(&info, 3, NULL);
+
+    /* One NVIDIA card: offloaded to, whatever its slot */
+    info.gpu_info.cards[1].vendor = GSR_GPU_VENDOR_NVIDIA;
+    assert_environ(&info, 1, "__NV_PRIME_RENDER_OFFLOAD=1");
+    assert_environ(&info, 0, INTEL_ENV);
+
+    /* Two: the driver would choose, so neither can be */
+    info.gpu_info.cards[2].vendor = GSR_GPU_VENDOR_NVIDIA;
+    assert_environ(&info, 1, NULL);
+    assert_environ(&info, 2, NULL);
+    assert_environ(&info, 0, INTEL_ENV);
+    gsr_info_clear(&info);
+}
+
+/* ── Probes and their cache ──────────────────────────────────────── */
+
+#define TWO_CARDS_INFO \
+    "section=gpu_info\n" \
+    "vendor|intel\n" \
+    "section=video_codecs\n" \
+    "h264\n" \
+    "section=capture_options\n" \
+    "/dev/dri/card0\n" \
+    "/dev/dri/card1\n" \
+    "DP-1|1920x1080\n"
+
+static void
+assert_probed(const GsrInfo *info)
+{
+    g_assert_cmpint(info->gpu_info.n_cards, ==, 2);
+    const GsrDrmCard *intel = &info->gpu_info.cards[0];
+    const GsrDrmCard *amd = &info->gpu_info.cards[1];
+    g_assert_true(intel->probed);
+    g_assert_true(amd->probed);
+    g_assert_cmpint(intel->vendor, ==, GSR_GPU_VENDOR_INTEL);
+    g_assert_cmpint(amd->vendor, ==, GSR_GPU_VENDOR_AMD);
+    g_assert_cmpint(intel->n_monitors, ==, 1);
+    g_assert_cmpint(amd->n_monitors, ==, 2);
+
+    g_assert_true(gsr_info_is_codec_supported(info, 0, "h264"));
+    g_assert_false(gsr_info_is_codec_supported(info, 0, "av1"));
+    g_assert_false(gsr_info_is_codec_supported(info, 1, "h264"));
+    g_assert_true(gsr_info_is_codec_supported(info, 1, "hevc"));
+    g_assert_true(gsr_info_is_codec_supported(info, 1, "av1_10bit"));
+    g_assert_cmpstr(gsr_info_get_first_usable_hw_video_codec(info, 1), ==, "hevc");
+    /* No card: what the recorder picks itself */
+    g_assert_true(gsr_info_is_codec_supported(info, -1, "h264"));
+    g_assert_false(gsr_info_is_codec_supported(info, -1, "hevc"));
+}
+
+static void
+test_probe_cache(Fixture *f, gconstpointer data G_GNUC_UNUSED)
+{
+    write_tmp_file(f, "info", TWO_CARDS_INFO);
+    write_tmp_file(f, "info-pci-0000_00_02_0",
+        "section=video_codecs\n"
+        "h264\n"
+        "section=capture_options\n"
+        "DP-1|1920x1080\n");
+    write_tmp_file(f, "info-pci-0000_03_00_0",
+        "section=gpu_info\n"
+        "vendor|amd\n"
+        "section=video_codecs\n"
+        "hevc\n"
+        "av1_10bit\n"
+        "section=capture_options\n"
+        "HDMI-A-1|3840x2160\n"
+        "HDMI-A-2|3840x2160\n");
+
+    /* First run: the plain --info, then each card under its environment */
+    GsrInfo info;
+    g_assert_cmpint(info_load(&info, f->cache_path, f->recorder, f->sysfs), ==, GSR_INFO_EXIT_OK);
+    assert_probed(&info);
+    gsr_info_clear(&info);
+    g_auto(GStrv) calls = take_calls(f);
+    g_assert_cmpuint(g_strv_length(calls), ==, 3);
+    g_assert_cmpstr(calls[0], ==, "plain --info");
+    g_assert_cmpstr(calls[1], ==, "pci-0000_00_02_0 --info");
+    g_assert_cmpstr(calls[2], ==, "pci-0000_03_00_0 --info");
+
+    g_autofree char *cached = NULL;
+    g_assert_true(g_file_get_contents(f->cache_path, &cached, NULL, NULL));
+    g_autofree char *checksum = g_compute_checksum_for_string(G_CHECKSUM_SHA256, TWO_CARDS_INFO, -1);
+    g_assert_true(g_str_has_prefix(cached, checksum));
+
+    /* Same output: the probes come from the cache */
+    g_assert_cmpint(info_load(&info, f->cache_path, f->recorder, f->sysfs), ==, GSR_INFO_EXIT_OK);
+    assert_probed(&info);
+    gsr_info_clear(&info);
+    g_strfreev(calls);
+    calls = take_calls(f);
+    g_assert_cmpuint(g_strv_length(calls), ==, 1);
+    g_assert_cmpstr(calls[0], ==, "plain --info");
+
+    /* Anything changed, a monitor plugged in here: probed again */
+    write_tmp_file(f, "info", TWO_CARDS_INFO "DP-2|1920x1080\n");
+    g_assert_cmpint(info_load(&info, f->cache_path, f->recorder, f->sysfs), ==, GSR_INFO_EXIT_OK);
+    assert_probed(&info);
+    gsr_info_clear(&info);
+    g_strfreev(calls);
+    calls = take_calls(f);
+    g_assert_cmpuint(g_strv_length(calls), ==, 3);
+
+    /* A cache missing a card is no cache */
+    g_autofree char *contents = NULL;
+    g_assert_true(g_file_get_contents(f->cache_path, &contents, NULL, NULL));
+    g_auto(GStrv) lines = g_strsplit(contents, "\n", -1);
+    g_autofree char *truncated = g_strdup_printf("%s\n%s\n", lines[0], lines[1]);
+    g_assert_true(g_file_set_contents(f->cache_path, truncated, -1, NULL));
+    g_assert_cmpint(info_load(&info, f->cache_path, f->recorder, f->sysfs), ==, GSR_INFO_EXIT_OK);
+    assert_probed(&info);
+    gsr_info_clear(&info);
+    g_strfreev(calls);
+    calls = take_calls(f);
+    g_assert_cmpuint(g_strv_length(calls), ==, 3);
+}
+
+static void
+test_probe_skipped(Fixture *f, gconstpointer data G_GNUC_UNUSED)
+{
+    /* One card: nothing to choose between, nothing probed or cached */
+    write_tmp_file(f, "info", "section=capture_options\n/dev/dri/card0\n");
+    GsrInfo info;
+    g_assert_cmpint(info_load(&info, f->cache_path, f->recorder, f->sysfs), ==, GSR_INFO_EXIT_OK);
+    g_assert_false(info.gpu_info.cards[0].probed);
+    gsr_info_clear(&info);
+    g_auto(GStrv) calls = take_calls(f);
+    g_assert_cmpuint(g_strv_length(calls), ==, 1);
+    g_assert_false(g_file_test(f->cache_path, G_FILE_TEST_EXISTS));
+
+    /* A card with no environment keeps the plain answers */
+    write_tmp_file(f, "info", TWO_CARDS_INFO "/dev/dri/card2\n");
+    g_assert_cmpint(info_load(&info, f->cache_path, f->recorder, f->sysfs), ==, GSR_INFO_EXIT_OK);
+    g_assert_true(info.gpu_info.cards[0].probed);
+    g_assert_false(info.gpu_info.cards[2].probed);
+    g_assert_true(gsr_info_is_codec_supported(&info, 2, "h264"));
+    gsr_info_clear(&info);
+    g_strfreev(calls);
+    calls = take_calls(f);
+    g_assert_cmpuint(g_strv_length(calls), ==, 3);
+
+    /* A failed run probes nothing */
+    write_tmp_file(f, "exit", "22");
+    g_assert_cmpint(info_load(&info, NULL, f->recorder, f->sysfs), ==, GSR_INFO_EXIT_OPENGL_FAILED);
+    gsr_info_clear(&info);
+    g_strfreev(calls);
+    calls = take_calls(f);
+    g_assert_cmpuint(g_strv_length(calls), ==, 1);
+}
+
+int
+main(int argc, char **argv)
+{
+    g_test_init(&argc, &argv, NULL);
+
+    g_test_add("/info/parse", Fixture, NULL, fixture_setup, test_parse, fixture_teardown);
+    g_test_add("/info/cards", Fixture, NULL, fixture_setup, test_cards, fixture_teardown);
+    g_test_add("/info/card-environ", Fixture, NULL, fixture_setup, test_card_environ, fixture_teardown);
+    g_test_add("/info/probe-cache", Fixture, NULL, fixture_setup, test_probe_cache, fixture_teardown);
+    g_test_add("/info/probe-skipped", Fixture, NULL, fixture_setup, test_probe_skipped, fixture_teardown);
+    return g_test_run();
+}
@@ -0,0 +1,210 @@
+/*
+ * gsr-ingest-probe.c against loopback listeners standing in for ingest
+ * servers.  Nothing needs to accept(): the kernel finishes the handshake.
+ */
+
+#include "gsr-ingest-probe.h"
+#include "gsr-test-util.h"
+
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+
+#define WAIT_TIMEOUT_MS 5000
+
+typedef struct {
+    GsrTestTmpDir tmp;
+    char *cache_path;
+    int   n_results;
+    char *best_host;
+    gint64 rtt_us;
+} Fixture;
+
+static void
+fixture_setup(Fixture *f, gconstpointer data)
+{
+    gsr_test_tmp_dir_setup(&f->tmp, data);
+    f->cache_path = gsr_test_tmp_path(&f->tmp, "ingest");
+}
+
+static void
+fixture_teardown(Fixture *f, gconstpointer data)
+{
+    gsr_test_tmp_dir_teardown(&f->tmp, data);
+    g_free(f->cache_path);
+    g_free(f->best_host);
+}
+
+static void
+on_result(const char *service, const char *best_host, gint64 rtt_us,
+          gpointer user_data)
+{
+    Fixture *f = user_data;
+    g_assert_cmpstr(service, ==, "test");
+    g_free(f->best_host);
+    f->best_host = g_strdup(best_host);
+    f->rtt_us = rtt_us;
+    f->n_results++;
+}
+
+/* A loopback listener; *port is where it listens */
+static int
+open_listener(int backlog, guint16 *port)
+{
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    g_assert_cmpint(fd, >=, 0);
+    struct sockaddr_in addr = {
+        .sin_family = AF_INET,
+        .sin_addr.s_addr = htonl(INADDR_LOOPBACK),
+    };
+    socklen_t addr_len = sizeof(addr);
+    g_assert_cmpint(bind(fd, (struct sockaddr *)&addr, sizeof(addr)), ==, 0);
+    g_assert_cmpint(listen(fd, backlog), ==, 0);
+    g_assert_cmpint(getsockname(fd, (struct sockaddr *)&addr, &addr_len), ==, 0);
+    *port = ntohs(addr.sin_port);
+    return fd;
+}
+
+/* A port nothing listens on: connecting is refused right away */
+static guint16
+closed_port(void)
+{
+    guint16 port;
+    close(open_listener(1, &port));
+    return port;
+}
+
+static char *
+host_for(guint16 port)
+{
+    return g_strdup_printf("127.0.0.1:%u", port);
+}
+
+/* Only the host that answers wins, and it is remembered */
+static void
+test_best_host(Fixture *f, gconstpointer data G_GNUC_UNUSED)
+{
+    guint16 port;
+    int fd = open_listener(8, &port);
+    g_autofree char *open_host = host_for(port);
+    g_autofree char *closed_host = host_for(closed_port());
+    const char *hosts[] = { closed_host, open_host, NULL };
+
+    GsrIngestProbe *probe = gsr_ingest_probe_new(f->cache_path);
+    g_assert_null(gsr_ingest_probe_get_best(probe, "test", hosts, NULL));
+
+    gsr_ingest_probe_run(probe, "test", hosts, 1935, on_result, f);
+    /* Already running: ignored */
+    gsr_ingest_probe_run(probe, "test", hosts, 1935, on_result, f);
+    gsr_test_iterate_until(&f->n_results, 1, WAIT_TIMEOUT_MS);
+    g_assert_cmpint(f->n_results, ==, 1);
+    g_assert_cmpstr(f->best_host, ==, open_host);
+    g_assert_cmpint(f->rtt_us, >=, 0);
+    g_assert_cmpint(f->rtt_us, <, GSR_INGEST_PROBE_DEADLINE_MS * 1000);
+
+    gint64 rtt_us = -1;
+    g_assert_cmpstr(gsr_ingest_probe_get_best(probe, "test", hosts, &rtt_us), ==, open_host);
+    g_assert_cmpint(rtt_us, ==, f->rtt_us);
+    g_assert_null(gsr_ingest_probe_get_best(probe, "other", hosts, NULL));
+    gsr_ingest_probe_free(probe);
+
+    /* From the cache file, as on the next start */
+    probe = gsr_ingest_probe_new(f->cache_path);
+    g_assert_cmpstr(gsr_ingest_probe_get_best(probe, "test", hosts, NULL), ==, open_host);
+    /* A host no longer on the list isn't used */
+    const char *others[] = { closed_host, NULL };
+    g_assert_null(gsr_ingest_probe_get_best(probe, "test", others, NULL));
+    g_assert_null(gsr_ingest_probe_get_best(probe, "test", NULL, NULL));
+    gsr_ingest_probe_free(probe);
+
+    close(fd);
+}
+
+static void
+test_default_port(Fixture *f, gconstpointer data G_GNUC_UNUSED)
+{
+    guint16 port;
+    int fd = open_listener(8, &port);
+    const char *hosts[] = { "127.0.0.1", NULL };
+
+    GsrIngestProbe *probe = gsr_ingest_probe_new(f->cache_path);
+    gsr_ingest_probe_run(probe, "test", hosts, port, on_result, f);
+    gsr_test_iterate_until(&f->n_results, 1, WAIT_TIMEOUT_MS);
+    g_assert_cmpint(f->n_results, ==, 1);
+    g_assert_cmpstr(f->best_host, ==, "127.0.0.1");
+    gsr_ingest_probe_free(probe);
+
+    close(fd);
+}
+
+/* A host that never completes the handshake is dropped at the deadline */
+static void
+test_deadline(Fixture *f, gconstpointer data G_GNUC_UNUSED)
+{
+    /* With its accept queue full, a listener ignores further SYNs */
+    guint16 port;
+    int fd = open_listener(0, &port);
+    int fillers[4];
+    for (guint i = 0; i < G_N_ELEMENTS(fillers); i++) {
+        fillers[i] = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
+        struct sockaddr_in addr = {
+            .sin_family = AF_INET,
+            .sin_addr.s_addr = htonl(INADDR_LOOPBACK),
+            .sin_port = htons(port),
+        };
+        connect(fillers[i], (struct sockaddr *)&addr, sizeof(addr));
+    }
+    g_usleep(100 * 1000);
+
+    g_autofree char *host = host_for(port);
+    const char *hosts[] = { host, NULL };
+    GsrIngestProbe *probe = gsr_ingest_probe_new(f->cache_path);
+
+    gint64 start_us = g_get_monotonic_time();
+    gsr_ingest_probe_run(probe, "test", hosts, 1935, on_result, f);
+    gsr_test_iterate_until(&f->n_results, 1, WAIT_TIMEOUT_MS);
+    gint64 elapsed_ms = (g_get_monotonic_time() - start_us) / 1000;
+
+    g_assert_cmpint(f->n_results, ==, 1);
+    g_assert_null(f->best_host);
+    g_assert_cmpint(elapsed_ms, >=, GSR_INGEST_PROBE_DEADLINE_MS - 100);
+    g_assert_cmpint(elapsed_ms, <, WAIT_TIMEOUT_MS);
+    /* Nothing worth remembering */
+    g_assert_null(gsr_ingest_probe_get_best(probe, "test", hosts, NULL));
+    g_assert_false(g_file_test(f->cache_path, G_FILE_TEST_EXISTS));
+    gsr_ingest_probe_free(probe);
+
+    for (guint i = 0; i < G_N_ELEMENTS(fillers); i++)
+        close(fillers[i]);
+    close(fd);
+}
+
+/* Freeing mid-probe: no callback afterwards */
+static void
+test_free_while_running(Fixture *f, gconstpointer data G_GNUC_UNUSED)
+{
+    guint16 port;
+    int fd = open_listener(8, &port);
+    g_autofree char *host = host_for(port);
+    const char *hosts[] = { host, NULL };
+
+    GsrIngestProbe *probe = gsr_ingest_probe_new(f->cache_path);
+    gsr_ingest_probe_run(probe, "test", hosts, 1935, on_result, f);
+    gsr_ingest_probe_free(probe);
+
+    gsr_test_iterate_until(NULL, 0, 300);
+    g_assert_cmpint(f->n_results, ==, 0);
+    close(fd);
+}
+
+int
+main(int argc, char **argv)
+{
+    g_test_init(&argc, &argv, NULL);
+
+    g_test_add("/ingest-probe/best-host", Fixture, NULL, fixture_setup, test_best_host, fixture_teardown);
+    g_test_add("/ingest-probe/default-port", Fixture, NULL, fixture_setup, test_default_port, fixture_teardown);
+    g_test_add("/ingest-probe/deadline", Fixture, NULL, fixture_setup, test_deadline, fixture_teardown);
+    g_test_add("/ingest-probe/free-while-running", Fixture, NULL, fixture_setup, test_free_while_running, fixture_teardown);
+    return g_test_run();
+}
@@ -0,0 +1,195 @@
+/*
+ * gsr-job-queue.c with sh, touch and false standing in for real
+ * post-processing commands.
+ */
+
+#include "gsr-job-queue.h"
+#include "gsr-test-util.h"
+
+#define WAIT_TIMEOUT_MS 5000
+
+typedef struct {
+    GsrTestTmpDir tmp;
+    char      *state_path;
+    char      *file;          /* the "saved recording" jobs run on */
+    int        n_finished;
+    GPtrArray *commands;      /* in the order they finished */
+    GArray    *statuses;
+} Fixture;
+
+static void
+fixture_setup(Fixture *f, gconstpointer data)
+{
+    gsr_test_tmp_dir_setup(&f->tmp, data);
+    f->state_path = gsr_test_tmp_path(&f->tmp, "jobs");
+    f->file = gsr_test_tmp_path(&f->tmp, "Video 1.mp4");
+    f->commands = g_ptr_array_new_with_free_func(g_free);
+    f->statuses = g_array_new(FALSE, FALSE, sizeof(int));
+}
+
+static void
+fixture_teardown(Fixture *f, gconstpointer data)
+{
+    gsr_test_tmp_dir_teardown(&f->tmp, data);
+    g_free(f->file);
+    g_free(f->state_path);
+    g_ptr_array_unref(f->commands);
+    g_array_unref(f->statuses);
+}
+
+static void
+on_job_finished(const char *file, const char *command, int exit_status,
+                gpointer user_data)
+{
+    Fixture *f = user_data;
+    g_assert_cmpstr(file, ==, f->file);
+    g_ptr_array_add(f->commands, g_strdup(command));
+    g_array_append_val(f->statuses, exit_status);
+    f->n_finished++;
+}
+
+static int
+status_at(const Fixture *f, guint i)
+{
+    return g_array_index(f->statuses, int, i);
+}
+
+/* Jobs for one file run one after another, in the order added */
+static void
+test_order(Fixture *f, gconstpointer data G_GNUC_UNUSED)
+{
+    GsrJobQueue *queue = gsr_job_queue_new(f->state_path, on_job_finished, f);
+    gsr_job_queue_set_max_jobs(queue, 4);
+
+    const char *commands[] = {
+        "sh -c 'sleep 0.2; echo one >> \"$0\"' {file}",
+        "sh -c 'echo two >> \"$0\"' {file}",
+        "sh -c 'echo three >> \"$0\"'",
+    };
+    gsr_job_queue_add(queue, f->file, commands, G_N_ELEMENTS(commands));
+    g_assert_cmpuint(gsr_job_queue_get_n_jobs(queue), ==, 3);
+    g_assert_true(g_file_test(f->state_path, G_FILE_TEST_EXISTS));
+
+    gsr_test_iterate_until(&f->n_finished, 3, WAIT_TIMEOUT_MS);
+    g_assert_cmpint(f->n_finished, ==, 3);
+    for (guint i = 0; i < 3; i++) {
+        g_assert_cmpstr(g_ptr_array_index(f->commands, i), ==, commands[i]);
+        g_assert_cmpint(status_at(f, i), ==, 0);
+    }
+
+    g_autofree char *contents = NULL;
+    g_assert_true(g_file_get_contents(f->file, &contents, NULL, NULL));
+    g_assert_cmpstr(contents, ==, "one\ntwo\nthree\n");
+
+    /* Nothing left to resume */
+    g_assert_cmpuint(gsr_job_queue_get_n_jobs(queue), ==, 0);
+    g_assert_false(g_file_test(f->state_path, G_FILE_TEST_EXISTS));
+    gsr_job_queue_free(queue);
+}
+
+static void
+test_exit_status(Fixture *f, gconstpointer data G_GNUC_UNUSED)
+{
+    GsrJobQueue *queue = gsr_job_queue_new(f->state_path, on_job_finished, f);
+
+    const char *commands[] = {
+        "false",
+        "sh -c 'exit 3'",
+        "sh -c 'kill -9 $$'",
+        "gsr-test-no-such-command",
+        "sh -c 'unterminated",
+        "",
+    };
+    g_test_expect_message(G_LOG_DOMAIN, G_LOG_LEVEL_WARNING, "Failed to run*");
+    g_test_expect_message(G_LOG_DOMAIN, G_LOG_LEVEL_WARNING, "Failed to run*");
+    gsr_job_queue_add(queue, f->file, commands, G_N_ELEMENTS(commands));
+
+    /* Empty commands are skipped */
+    gsr_test_iterate_until(&f->n_finished, 5, WAIT_TIMEOUT_MS);
+    g_test_assert_expected_messages();
+    g_assert_cmpint(f->n_finished, ==, 5);
+    g_assert_cmpint(status_at(f, 0), ==, 1);
+    g_assert_cmpint(status_at(f, 1), ==, 3);
+    /* Killed by a signal */
+    g_assert_cmpint(status_at(f, 2), ==, -1);
+    /* Couldn't be started */
+    g_assert_cmpint(status_at(f, 3), ==, -1);
+    g_assert_cmpint(status_at(f, 4), ==, -1);
+
+    gsr_job_queue_free(queue);
+}
+
+static void
+test_paused(Fixture *f, gconstpointer data G_GNUC_UNUSED)
+{
+    GsrJobQueue *queue = gsr_job_queue_new(f->state_path, on_job_finished, f);
+
+    /* A running job is stopped, not killed */
+    const char *slow[] = { "sh -c 'sleep 0.3; echo slow >> \"$0\"' {file}" };
+    gsr_job_queue_add(queue, f->file, slow, 1);
+    gsr_job_queue_set_paused(queue, TRUE);
+
+    /* and queued ones don't start */
+    const char *touch[] = { "touch" };
+    gsr_job_queue_add(queue, f->file, touch, 1);
+
+    gsr_test_iterate_until(NULL, 0, 600);
+    g_assert_cmpint(f->n_finished, ==, 0);
+    g_assert_cmpuint(gsr_job_queue_get_n_jobs(queue), ==, 2);
+    g_assert_false(g_file_test(f->file, G_FILE_TEST_EXISTS));
+
+    gsr_job_queue_set_paused(queue, FALSE);
+    gsr_test_iterate_until(&f->n_finished, 2, WAIT_TIMEOUT_MS);
+    g_assert_cmpint(f->n_finished, ==, 2);
+    g_assert_cmpint(status_at(f, 0), ==, 0);
+    g_assert_cmpint(status_at(f, 1), ==, 0);
+
+    g_autofree char *contents = NULL;
+    g_assert_true(g_file_get_contents(f->file, &contents, NULL, NULL));
+    g_assert_cmpstr(contents, ==, "slow\n");
+
+    gsr_job_queue_free(queue);
+}
+
+/* Jobs left over when the app quits run on the next start; the tab and
+   backslash check the state file's escaping */
+static void
+test_resume(Fixture *f, gconstpointer data G_GNUC_UNUSED)
+{
+    GsrJobQueue *queue = gsr_job_queue_new(f->state_path, on_job_finished, f);
+    gsr_job_queue_set_paused(queue, TRUE);
+
+    const char *commands[] = {
+        "sh -c 'printf \"%s\\\\n\" \"tab\tstop\" >> \"$0\"' {file}",
+        "touch",
+    };
+    gsr_job_queue_add(queue, f->file, commands, G_N_ELEMENTS(commands));
+    gsr_job_queue_free(queue);
+    g_assert_cmpint(f->n_finished, ==, 0);
+    g_assert_true(g_file_test(f->state_path, G_FILE_TEST_EXISTS));
+
+    queue = gsr_job_queue_new(f->state_path, on_job_finished, f);
+    g_assert_cmpuint(gsr_job_queue_get_n_jobs(queue), ==, 2);
+    gsr_test_iterate_until(&f->n_finished, 2, WAIT_TIMEOUT_MS);
+    g_assert_cmpint(f->n_finished, ==, 2);
+    g_assert_cmpstr(g_ptr_array_index(f->commands, 0), ==, commands[0]);
+    g_assert_cmpstr(g_ptr_array_index(f->commands, 1), ==, commands[1]);
+
+    g_autofree char *contents = NULL;
+    g_assert_true(g_file_get_contents(f->file, &contents, NULL, NULL));
+    g_assert_cmpstr(contents, ==, "tab\tstop\n");
+
+    gsr_job_queue_free(queue);
+}
+
+int
+main(int argc, char **argv)
+{
+    g_test_init(&argc, &argv, NULL);
+
+    g_test_add("/job-queue/order", Fixture, NULL, fixture_setup, test_order, fixture_teardown);
+    g_test_add("/job-queue/exit-status", Fixture, NULL, fixture_setup, test_exit_status, fixture_teardown);
+    g_test_add("/job-queue/paused", Fixture, NULL, fixture_setup, test_paused, fixture_teardown);
+    g_test_add("/job-queue/resume", Fixture, NULL, fixture_setup, test_resume, fixture_teardown);
+    return g_test_run();
+}
@@ -0,0 +1,99 @@
+/*
+ * gsr-latency-histogram.c: bucket bounds and percentiles.
+ */
+
+#include "gsr-latency-histogram.h"
+
+static void
+test_empty(void)
+{
+    GsrLatencyHistogram hist;
+    gsr_latency_histogram_reset(&hist);
+
+    g_assert_cmpuint(hist.total, ==, 0);
+    g_assert_cmpint(gsr_latency_histogram_percentile(&hist, 50.0), ==, 0);
+    g_assert_cmpint(gsr_latency_histogram_percentile(&hist, 99.0), ==, 0);
+}
+
+/* Below 32 µs every value has a bucket of its own */
+static void
+test_exact_small_values(void)
+{
+    GsrLatencyHistogram hist;
+    gsr_latency_histogram_reset(&hist);
+
+    for (gint64 v = 0; v < 32; v++)
+        gsr_latency_histogram_record(&hist, v);
+
+    for (gint64 v = 0; v < 32; v++) {
+        double p = (double)(v + 1) / 32.0 * 100.0;
+        g_assert_cmpint(gsr_latency_histogram_percentile(&hist, p), ==, v);
+    }
+    g_assert_cmpint(hist.min_us, ==, 0);
+    g_assert_cmpint(hist.max_us, ==, 31);
+}
+
+/* A reported value is never below the sample, and at most 1/16 above it */
+static void
+test_relative_error(void)
+{
+    for (gint64 v = 1; v < G_MAXINT32 / 2; v = v * 3 / 2 + 1) {
+        GsrLatencyHistogram hist;
+        gsr_latency_histogram_reset(&hist);
+        gsr_latency_histogram_record(&hist, v);
+        /* A larger sample keeps max_us from capping the bucket bound */
+        gsr_latency_histogram_record(&hist, G_MAXINT32);
+
+        gint64 reported = gsr_latency_histogram_percentile(&hist, 50.0);
+        g_assert_cmpint(reported, >=, v);
+        g_assert_cmpint(reported, <=, v + v / 16);
+    }
+}
+
+static void
+test_percentiles(void)
+{
+    GsrLatencyHistogram hist;
+    gsr_latency_histogram_reset(&hist);
+
+    for (gint64 v = 1; v <= 1000; v++)
+        gsr_latency_histogram_record(&hist, v);
+
+    g_assert_cmpuint(hist.total, ==, 1000);
+    g_assert_cmpint(gsr_latency_histogram_percentile(&hist, 0.0), ==, 1);
+    /* 500 lands in [496, 511], 990 in [960, 991] */
+    g_assert_cmpint(gsr_latency_histogram_percentile(&hist, 50.0), ==, 511);
+    g_assert_cmpint(gsr_latency_histogram_percentile(&hist, 99.0), ==, 991);
+    /* The top bucket is capped at the largest sample */
+    g_assert_cmpint(gsr_latency_histogram_percentile(&hist, 100.0), ==, 1000);
+    g_assert_cmpint(gsr_latency_histogram_percentile(&hist, 250.0), ==, 1000);
+}
+
+static void
+test_out_of_range(void)
+{
+    GsrLatencyHistogram hist;
+    gsr_latency_histogram_reset(&hist);
+
+    gsr_latency_histogram_record(&hist, -5);
+    g_assert_cmpint(hist.min_us, ==, 0);
+    g_assert_cmpint(gsr_latency_histogram_percentile(&hist, 50.0), ==, 0);
+
+    gsr_latency_histogram_record(&hist, G_MAXINT64);
+    g_assert_cmpint(hist.max_us, ==, G_MAXINT32);
+    g_assert_cmpint(gsr_latency_histogram_percentile(&hist, 100.0), ==, G_MAXINT32);
+    g_assert_cmpuint(hist.counts[GSR_LATENCY_N_BUCKETS - 1], ==, 1);
+}
+
+int
+main(int argc, char **argv)
+{
+    g_test_init(&argc, &argv, NULL);
+
+    g_test_add_func("/latency-histogram/empty", test_empty);
+    g_test_add_func("/latency-histogram/exact-small-values", test_exact_small_values);
+    g_test_add_func("/latency-histogram/relative-error", test_relative_error);
+    g_test_add_func("/latency-histogram/percentiles", test_percentiles);
+    g_test_add_func("/latency-histogram/out-of-range", test_out_of_range);
+    return g_test_run();
+}
@@ -0,0 +1,446 @@
+/*
+ * gsr-library-index.c and the directory handling of gsr-library-model.c:
+ * the on-disk format, in-place updates, compaction on save, and when a
+ * save directory is read again.  The model's .c is included to call its
+ * monitor callback directly and to see which scans are running.
+ */
+
+#include "gsr-library-model.c"
+#include "gsr-test-util.h"
+
+#include <stddef.h>
+#include <utime.h>
+
+#define HEADER_SIZE  32
+#define DIR_SIZE     16
+#define ENTRY_SIZE   ((gsize)sizeof(GsrLibraryEntry))
+#define OLD_MTIME    1000000000
+
+typedef struct {
+    GsrTestTmpDir tmp;
+    char         *index_path;
+    char         *videos;
+} Fixture;
+
+static void
+fixture_setup(Fixture *f, gconstpointer data)
+{
+    gsr_test_tmp_dir_setup(&f->tmp, data);
+    f->index_path = gsr_test_tmp_path(&f->tmp, "library-index");
+    f->videos = gsr_test_tmp_path(&f->tmp, "Videos");
+    g_assert_cmpint(g_mkdir(f->videos, 0755), ==, 0);
+}
+
+static void
+fixture_teardown(Fixture *f, gconstpointer data)
+{
+    gsr_test_tmp_dir_teardown(&f->tmp, data);
+    g_free(f->index_path);
+    g_free(f->videos);
+}
+
+static char *
+make_video(const Fixture *f, const char *name)
+{
+    char *path = g_build_filename(f->videos, name, NULL);
+    g_assert_true(g_file_set_contents(path, "video", -1, NULL));
+    return path;
+}
+
+static void
+set_mtime(const char *path, gint64 mtime)
+{
+    struct utimbuf times = { .actime = (time_t)mtime, .modtime = (time_t)mtime };
+    g_assert_cmpint(g_utime(path, &times), ==, 0);
+}
+
+static gsize
+file_size(const char *path)
+{
+    GStatBuf st;
+    g_assert_cmpint(g_stat(path, &st), ==, 0);
+    return (gsize)st.st_size;
+}
+
+/* ── Index ───────────────────────────────────────────────────────── */
+
+static void
+test_round_trip(Fixture *f, gconstpointer data G_GNUC_UNUSED)
+{
+    GsrLibraryIndex *index = gsr_library_index_load(f->index_path);
+    g_assert_cmpuint(gsr_library_index_get_n_entries(index), ==, 0);
+    g_assert_false(gsr_library_index_is_dirty(index));
+
+    gboolean added = FALSE;
+    g_assert_cmpuint(gsr_library_index_update(index, "/v/a.mp4", 100, 10, &added), ==, 0);
+    g_assert_true(added);
+    g_assert_cmpuint(gsr_library_index_update(index, "/v/b.mkv", 200, 20, &added), ==, 1);
+    g_assert_cmpuint(gsr_library_index_update(index, "/w/c.webm", 300, 30, &added), ==, 2);
+    gsr_library_index_set_metadata(index, 1, 61500, 1920, 1080, "hevc");
+    gsr_library_index_set_dir_mtime(index, "/v", 40);
+    gsr_library_index_set_dir_mtime(index, "/w", 50);
+    g_assert_true(gsr_library_index_is_dirty(index));
+
+    g_assert_true(gsr_library_index_save(index));
+    g_assert_false(gsr_library_index_is_dirty(index));
+    gsr_library_index_free(index);
+
+    index = gsr_library_index_load(f->index_path);
+    g_assert_false(gsr_library_index_is_dirty(index));
+    g_assert_cmpuint(gsr_library_index_get_n_entries(index), ==, 3);
+
+    const GsrLibraryEntry *a = gsr_library_index_get_entry(index, 0);
+    g_assert_cmpstr(gsr_library_index_get_path(index, a), ==, "/v/a.mp4");
+    g_assert_cmpuint(a->size, ==, 100);
+    g_assert_cmpint(a->mtime, ==, 10);
+    g_assert_cmpuint(a->flags, ==, 0);
+
+    const GsrLibraryEntry *b = gsr_library_index_get_entry(index, 1);
+    g_assert_cmpstr(gsr_library_index_get_path(index, b), ==, "/v/b.mkv");
+    g_assert_cmpuint(b->size, ==, 200);
+    g_assert_cmpint(b->mtime, ==, 20);
+    g_assert_cmpuint(b->flags, ==, GSR_LIBRARY_ENTRY_PROBED);
+    g_assert_cmpuint(b->duration_ms, ==, 61500);
+    g_assert_cmpuint(b->width, ==, 1920);
+    g_assert_cmpuint(b->height, ==, 1080);
+    g_assert_cmpstr(b->codec, ==, "hevc");
+
+    g_assert_cmpstr(gsr_library_index_get_path(index, gsr_library_index_get_entry(index, 2)),
+                    ==, "/w/c.webm");
+    g_assert_cmpint(gsr_library_index_find(index, "/w/c.webm"), ==, 2);
+    g_assert_cmpint(gsr_library_index_find(index, "/w/d.mp4"), ==, -1);
+
+    gint64 mtime = 0;
+    g_assert_true(gsr_library_index_get_dir_mtime(index, "/v", &mtime));
+    g_assert_cmpint(mtime, ==, 40);
+    g_assert_true(gsr_library_index_get_dir_mtime(index, "/w", &mtime));
+    g_assert_cmpint(mtime, ==, 50);
+    g_assert_false(gsr_library_index_get_dir_mtime(index, "/x", &mtime));
+
+    /* An unchanged mtime doesn't make the index worth saving */
+    gsr_library_index_set_dir_mtime(index, "/v", 40);
+    g_assert_false(gsr_library_index_is_dirty(index));
+    gsr_library_index_free(index);
+}
+
+static void
+test_missing(Fixture *f, gconstpointer data G_GNUC_UNUSED)
+{
+    GsrLibraryIndex *index = gsr_library_index_load(f->index_path);
+    g_assert_cmpuint(gsr_library_index_get_n_entries(index), ==, 0);
+    g_assert_false(gsr_library_index_is_dirty(index));
+    g_assert_false(g_file_test(f->index_path, G_FILE_TEST_EXISTS));
+    gsr_library_index_free(index);
+}
+
+/* Each damaged copy of a good index must load as an empty one that
+   gets rewritten, never as a partly read one */
+static void
+expect_corrupt(const Fixture *f, const guint8 *data, gsize length)
+{
+    g_assert_true(g_file_set_contents(f->index_path, (const char *)data, (gssize)length, NULL));
+
+    g_test_expect_message(G_LOG_DOMAIN, G_LOG_LEVEL_WARNING, "Ignoring corrupt library index*");
+    GsrLibraryIndex *index = gsr_library_index_load(f->index_path);
+    g_test_assert_expected_messages();
+
+    gint64 mtime;
+    g_assert_cmpuint(gsr_library_index_get_n_entries(index), ==, 0);
+    g_assert_false(gsr_library_index_get_dir_mtime(index, "/v", &mtime));
+    g_assert_cmpint(gsr_library_index_find(index, "/v/a.mp4"), ==, -1);
+    g_assert_true(gsr_library_index_is_dirty(index));
+    gsr_library_index_free(index);
+}
+
+static void
+test_corrupt(Fixture *f, gconstpointer data G_GNUC_UNUSED)
+{
+    GsrLibraryIndex *index = gsr_library_index_load(f->index_path);
+    gsr_library_index_update(index, "/v/a.mp4", 100, 10, NULL);
+    gsr_library_index_update(index, "/v/b.mp4", 200, 20, NULL);
+    gsr_library_index_set_dir_mtime(index, "/v", 40);
+    g_assert_true(gsr_library_index_save(index));
+    gsr_library_index_free(index);
+
+    g_autofree guint8 *good = NULL;
+    gsize length;
+    g_assert_true(g_file_get_contents(f->index_path, (char **)&good, &length, NULL));
+    g_assert_cmpuint(length, ==, HEADER_SIZE + DIR_SIZE + 2 * ENTRY_SIZE
+                     + sizeof("/v/a.mp4") + sizeof("/v/b.mp4") + sizeof("/v"));
+    g_autofree guint8 *bad = g_memdup2(good, length);
+
+    /* Shorter than the header */
+    expect_corrupt(f, good, HEADER_SIZE - 1);
+
+    /* Cut off, or with trailing bytes: the sizes in the header don't add up */
+    expect_corrupt(f, good, length - 1);
+    guint8 *longer = g_malloc0(length + 1);
+    memcpy(longer, good, length);
+    expect_corrupt(f, longer, length + 1);
+    g_free(longer);
+
+    /* Not an index */
+    bad[0] = 'X';
+    expect_corrupt(f, bad, length);
+    memcpy(bad, good, length);
+
+    /* The last two magic bytes are the format version */
+    bad[7] = 2;
+    expect_corrupt(f, bad, length);
+    memcpy(bad, good, length);
+
+    /* An entry count that doesn't match the file */
+    bad[8] = 3;
+    expect_corrupt(f, bad, length);
+    memcpy(bad, good, length);
+
+    /* A path that runs off the end of the string table */
+    bad[length - 1] = 'x';
+    expect_corrupt(f, bad, length);
+    memcpy(bad, good, length);
+
+    /* A path offset past the string table */
+    guint32 offset = G_MAXUINT32;
+    memcpy(bad + HEADER_SIZE + DIR_SIZE + ENTRY_SIZE + offsetof(GsrLibraryEntry, path_offset),
+           &offset, sizeof(offset));
+    expect_corrupt(f, bad, length);
+    memcpy(bad, good, length);
+
+    /* Same for a directory */
+    memcpy(bad + HEADER_SIZE, &offset, sizeof(offset));
+    expect_corrupt(f, bad, length);
+
+    /* The good copy still loads */
+    g_assert_true(g_file_set_contents(f->index_path, (const char *)good, (gssize)length, NULL));
+    index = gsr_library_index_load(f->index_path);
+    g_assert_cmpuint(gsr_library_index_get_n_entries(index), ==, 2);
+    g_assert_false(gsr_library_index_is_dirty(index));
+    gsr_library_index_free(index);
+}
+
+static void
+test_update_remove_rename(Fixture *f, gconstpointer data G_GNUC_UNUSED)
+{
+    GsrLibraryIndex *index = gsr_library_index_load(f->index_path);
+    gsr_library_index_update(index, "/v/a.mp4", 100, 10, NULL);
+    gsr_library_index_update(index, "/v/b.mp4", 200, 20, NULL);
+    gsr_library_index_update(index, "/v/c.mp4", 300, 30, NULL);
+    gsr_library_index_set_metadata(index, 1, 1000, 1280, 720, "h264");
+    g_assert_true(gsr_library_index_save(index));
+
+    /* Seen again, unchanged: nothing to save, metadata kept */
+    gboolean added = TRUE;
+    g_assert_cmpuint(gsr_library_index_update(index, "/v/b.mp4", 200, 20, &added), ==, 1);
+    g_assert_false(added);
+    g_assert_false(gsr_library_index_is_dirty(index));
+    g_assert_cmpuint(gsr_library_index_get_entry(index, 1)->flags, ==, GSR_LIBRARY_ENTRY_PROBED);
+
+    /* Rewritten: updated in place, metadata has to be read again */
+    g_assert_cmpuint(gsr_library_index_update(index, "/v/b.mp4", 250, 25, &added), ==, 1);
+    g_assert_false(added);
+    g_assert_true(gsr_library_index_is_dirty(index));
+    const GsrLibraryEntry *b = gsr_library_index_get_entry(index, 1);
+    g_assert_cmpuint(b->size, ==, 250);
+    g_assert_cmpint(b->mtime, ==, 25);
+    g_assert_cmpuint(b->flags, ==, 0);
+    g_assert_cmpuint(gsr_library_index_get_n_entries(index), ==, 3);
+
+    /* Removing shifts the later entries down */
+    gsr_library_index_remove(index, 0);
+    g_assert_cmpuint(gsr_library_index_get_n_entries(index), ==, 2);
+    g_assert_cmpint(gsr_library_index_find(index, "/v/a.mp4"), ==, -1);
+    g_assert_cmpint(gsr_library_index_find(index, "/v/b.mp4"), ==, 0);
+    g_assert_cmpint(gsr_library_index_find(index, "/v/c.mp4"), ==, 1);
+
+    /* A rename, the way the model handles one: the old path goes, the
+       new one is added on top */
+    int pos = gsr_library_index_find(index, "/v/b.mp4");
+    gsr_library_index_remove(index, (guint)pos);
+    g_assert_cmpuint(gsr_library_index_update(index, "/v/renamed.mp4", 250, 25, &added), ==, 1);
+    g_assert_true(added);
+    g_assert_cmpint(gsr_library_index_find(index, "/v/b.mp4"), ==, -1);
+    g_assert_cmpint(gsr_library_index_find(index, "/v/c.mp4"), ==, 0);
+    g_assert_cmpint(gsr_library_index_find(index, "/v/renamed.mp4"), ==, 1);
+
+    g_assert_true(gsr_library_index_save(index));
+    gsr_library_index_free(index);
+
+    index = gsr_library_index_load(f->index_path);
+    g_assert_cmpuint(gsr_library_index_get_n_entries(index), ==, 2);
+    g_assert_cmpstr(gsr_library_index_get_path(index, gsr_library_index_get_entry(index, 0)),
+                    ==, "/v/c.mp4");
+    g_assert_cmpstr(gsr_library_index_get_path(index, gsr_library_index_get_entry(index, 1)),
+                    ==, "/v/renamed.mp4");
+    g_assert_cmpint(gsr_library_index_find(index, "/v/a.mp4"), ==, -1);
+    gsr_library_index_free(index);
+}
+
+static void
+test_compaction(Fixture *f, gconstpointer data G_GNUC_UNUSED)
+{
+    static const char *const paths[] = {
+        "/v/first.mp4", "/v/second.mp4", "/v/third.mp4", "/v/fourth.mp4",
+    };
+
+    GsrLibraryIndex *index = gsr_library_index_load(f->index_path);
+    for (gsize i = 0; i < G_N_ELEMENTS(paths); i++)
+        gsr_library_index_update(index, paths[i], 1, 1, NULL);
+    gsr_library_index_set_dir_mtime(index, "/v", 1);
+    g_assert_true(gsr_library_index_save(index));
+    gsize full = file_size(f->index_path);
+
+    /* Removed paths stay in the table until the next save */
+    gsr_library_index_remove(index, 2);
+    gsr_library_index_remove(index, 0);
+    gsr_library_index_update(index, "/v/fifth.mp4", 1, 1, NULL);
+    g_assert_true(gsr_library_index_save(index));
+
+    gsize live = sizeof("/v/second.mp4") + sizeof("/v/fourth.mp4")
+               + sizeof("/v/fifth.mp4") + sizeof("/v");
+    g_assert_cmpuint(file_size(f->index_path), ==, HEADER_SIZE + DIR_SIZE + 3 * ENTRY_SIZE + live);
+    g_assert_cmpuint(file_size(f->index_path), <, full);
+
+    /* The index in memory adopted the compacted table; positions hold */
+    g_assert_cmpint(gsr_library_index_find(index, "/v/fourth.mp4"), ==, 1);
+    g_assert_cmpstr(gsr_library_index_get_path(index, gsr_library_index_get_entry(index, 2)),
+                    ==, "/v/fifth.mp4");
+    gint64 mtime = 0;
+    g_assert_true(gsr_library_index_get_dir_mtime(index, "/v", &mtime));
+    g_assert_cmpint(mtime, ==, 1);
+
+    /* Saving again with nothing removed keeps the same size */
+    g_assert_true(gsr_library_index_save(index));
+    g_assert_cmpuint(file_size(f->index_path), ==, HEADER_SIZE + DIR_SIZE + 3 * ENTRY_SIZE + live);
+    gsr_library_index_free(index);
+
+    index = gsr_library_index_load(f->index_path);
+    g_assert_cmpstr(gsr_library_index_get_path(index, gsr_library_index_get_entry(index, 0)),
+                    ==, "/v/second.mp4");
+    g_assert_cmpstr(gsr_library_index_get_path(index, gsr_library_index_get_entry(index, 1)),
+                    ==, "/v/fourth.mp4");
+    g_assert_cmpstr(gsr_library_index_get_path(index, gsr_library_index_get_entry(index, 2)),
+                    ==, "/v/fifth.mp4");
+    gsr_library_index_free(index);
+}
+
+/* ── Model: directory scans ──────────────────────────────────────── */
+
+static gboolean
+scans_done(gpointer user_data)
+{
+    GsrLibraryModel *model = user_data;
+    return g_hash_table_size(model->scanning) == 0;
+}
+
+static GsrLibraryModel *
+open_model(const Fixture *f)
+{
+    GsrLibraryModel *model = gsr_library_model_new(f->index_path);
+    const char *dirs[] = { f->videos, NULL };
+    gsr_library_model_set_directories(model, dirs);
+    return model;
+}
+
+/* Disposing saves the index; let the cancelled scans wind down */
+static void
+close_model(GsrLibraryModel *model)
+{
+    g_object_unref(model);
+    gsr_test_iterate_until(NULL, 0, 100);
+}
+
+static void
+test_unchanged_dir_skipped(Fixture *f, gconstpointer data G_GNUC_UNUSED)
+{
+    g_autofree char *a = make_video(f, "a.mp4");
+    g_autofree char *b = make_video(f, "b.mkv");
+    g_autofree char *notes = make_video(f, "notes.txt");
+    set_mtime(f->videos, OLD_MTIME);
+
+    /* First start: the directory is new to the index */
+    GsrLibraryModel *model = open_model(f);
+    g_assert_cmpuint(g_hash_table_size(model->scanning), ==, 1);
+    g_assert_true(gsr_test_iterate_until_cond(scans_done, model, 5000));
+    g_assert_cmpuint(g_list_model_get_n_items(G_LIST_MODEL(model)), ==, 2);
+    close_model(model);
+
+    GsrLibraryIndex *index = gsr_library_index_load(f->index_path);
+    gint64 mtime = 0;
+    g_assert_true(gsr_library_index_get_dir_mtime(index, f->videos, &mtime));
+    g_assert_cmpint(mtime, ==, OLD_MTIME);
+    gsr_library_index_free(index);
+
+    /* A file that shows up with the mtime put back is only found by a
+       scan; its absence shows there was none */
+    g_autofree char *c = make_video(f, "c.mp4");
+    set_mtime(f->videos, OLD_MTIME);
+    model = open_model(f);
+    g_assert_cmpuint(g_hash_table_size(model->scanning), ==, 0);
+    gsr_test_iterate_until(NULL, 0, 200);
+    g_assert_cmpuint(g_list_model_get_n_items(G_LIST_MODEL(model)), ==, 2);
+    g_assert_cmpint(gsr_library_index_find(model->index, c), ==, -1);
+    close_model(model);
+
+    /* Changed while nobody watched: read again */
+    set_mtime(f->videos, OLD_MTIME + 1);
+    model = open_model(f);
+    g_assert_true(gsr_test_iterate_until_cond(scans_done, model, 5000));
+    g_assert_cmpuint(g_list_model_get_n_items(G_LIST_MODEL(model)), ==, 3);
+    g_assert_cmpint(gsr_library_index_find(model->index, c), >=, 0);
+    close_model(model);
+}
+
+/* A monitor event while the first scan runs must not mark the directory
+   as read: closed before the scan ends, the next start has to read it */
+static void
+test_no_mtime_during_scan(Fixture *f, gconstpointer data G_GNUC_UNUSED)
+{
+    g_autofree char *a = make_video(f, "a.mp4");
+    g_autofree char *b = make_video(f, "b.mp4");
+    set_mtime(f->videos, OLD_MTIME);
+
+    GsrLibraryModel *model = open_model(f);
+    g_assert_cmpuint(g_hash_table_size(model->scanning), ==, 1);
+
+    /* As if a.mp4 had just been written, before the scan got anywhere */
+    g_autoptr(GFile) file = g_file_new_for_path(a);
+    on_dir_changed(NULL, file, NULL, G_FILE_MONITOR_EVENT_CHANGES_DONE_HINT, model);
+    g_assert_cmpint(gsr_library_index_find(model->index, a), >=, 0);
+    gint64 mtime = 0;
+    g_assert_false(gsr_library_index_get_dir_mtime(model->index, f->videos, &mtime));
+    close_model(model);
+
+    /* Only a.mp4 was saved, and without the directory's mtime */
+    GsrLibraryIndex *index = gsr_library_index_load(f->index_path);
+    g_assert_cmpuint(gsr_library_index_get_n_entries(index), ==, 1);
+    g_assert_false(gsr_library_index_get_dir_mtime(index, f->videos, &mtime));
+    gsr_library_index_free(index);
+
+    /* So the next start reads the directory and finds b.mp4 */
+    model = open_model(f);
+    g_assert_cmpuint(g_hash_table_size(model->scanning), ==, 1);
+    g_assert_true(gsr_test_iterate_until_cond(scans_done, model, 5000));
+    g_assert_cmpint(gsr_library_index_find(model->index, b), >=, 0);
+    g_assert_cmpuint(g_list_model_get_n_items(G_LIST_MODEL(model)), ==, 2);
+
+    /* Once it's done, events record the mtime again */
+    on_dir_changed(NULL, file, NULL, G_FILE_MONITOR_EVENT_CHANGES_DONE_HINT, model);
+    g_assert_true(gsr_library_index_get_dir_mtime(model->index, f->videos, &mtime));
+    g_assert_cmpint(mtime, ==, OLD_MTIME);
+    close_model(model);
+}
+
+int
+main(int argc, char **argv)
+{
+    g_test_init(&argc, &argv, NULL);
+
+    g_test_add("/library-index/round-trip", Fixture, NULL, fixture_setup, test_round_trip, fixture_teardown);
+    g_test_add("/library-index/missing", Fixture, NULL, fixture_setup, test_missing, fixture_teardown);
+    g_test_add("/library-index/corrupt", Fixture, NULL, fixture_setup, test_corrupt, fixture_teardown);
+    g_test_add("/library-index/update-remove-rename", Fixture, NULL, fixture_setup, test_update_remove_rename, fixture_teardown);
+    g_test_add("/library-index/compaction", Fixture, NULL, fixture_setup, test_compaction, fixture_teardown);
+    g_test_add("/library-model/unchanged-dir-skipped", Fixture, NULL, fixture_setup, test_unchanged_dir_skipped, fixture_teardown);
+    g_test_add("/library-model/no-mtime-during-scan", Fixture, NULL, fixture_setup, test_no_mtime_during_scan, fixture_teardown);
+    return g_test_run();
+}
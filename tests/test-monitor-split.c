@@ -0,0 +1,137 @@
+/*
+ * gsr-monitor-split.c: frame rate and bitrate budgets of a multi-monitor
+ * recording.
+ */
+
+#include "gsr-monitor-split.h"
+
+#define P_1080P ((gint64)1920 * 1080)
+#define P_1440P ((gint64)2560 * 1440)
+#define P_4K    ((gint64)3840 * 2160)
+
+static int
+sum(const int *kbps, int n)
+{
+    int total = 0;
+    for (int i = 0; i < n; i++)
+        total += kbps[i];
+    return total;
+}
+
+static void
+test_fps(void)
+{
+    g_assert_cmpint(gsr_monitor_split_fps(120, 2, 60), ==, 60);
+    g_assert_cmpint(gsr_monitor_split_fps(60, 3, 60), ==, 20);
+
+    /* Rounded down, but never below 1 or above the Config page's */
+    g_assert_cmpint(gsr_monitor_split_fps(10, 4, 60), ==, 2);
+    g_assert_cmpint(gsr_monitor_split_fps(1, 3, 60), ==, 1);
+    g_assert_cmpint(gsr_monitor_split_fps(300, 2, 60), ==, 60);
+
+    /* No budget: every recorder runs at the Config page's rate */
+    g_assert_cmpint(gsr_monitor_split_fps(0, 2, 60), ==, 0);
+}
+
+static void
+test_single_monitor(void)
+{
+    int kbps[1];
+    gint64 pixels[] = { P_4K };
+    gsr_monitor_split_bitrate(12345, pixels, 1, kbps);
+    g_assert_cmpint(kbps[0], ==, 12345);
+
+    /* Size unknown */
+    pixels[0] = 0;
+    gsr_monitor_split_bitrate(12345, pixels, 1, kbps);
+    g_assert_cmpint(kbps[0], ==, 12345);
+}
+
+static void
+test_unequal_sizes(void)
+{
+    int kbps[3];
+
+    /* A 4K monitor has four times the pixels of a 1080p one */
+    gint64 pair[] = { P_1080P, P_4K };
+    gsr_monitor_split_bitrate(10000, pair, 2, kbps);
+    g_assert_cmpint(kbps[0], ==, 2000);
+    g_assert_cmpint(kbps[1], ==, 8000);
+
+    gint64 three[] = { P_1440P, P_1080P, P_1080P };
+    gsr_monitor_split_bitrate(15690, three, 3, kbps);
+    g_assert_cmpint(kbps[0], ==, 7384);
+    g_assert_cmpint(kbps[1], ==, 4153);
+    g_assert_cmpint(kbps[2], ==, 4153);
+    g_assert_cmpint(sum(kbps, 3), ==, 15690);
+
+    /* One size unknown among known ones: it gets the minimum */
+    gint64 unknown[] = { P_1080P, 0, P_1080P };
+    gsr_monitor_split_bitrate(6000, unknown, 3, kbps);
+    g_assert_cmpint(kbps[0], ==, 3000);
+    g_assert_cmpint(kbps[1], ==, 1);
+    g_assert_cmpint(kbps[2], ==, 3000);
+
+    /* None known: split evenly */
+    gint64 none[] = { 0, 0 };
+    gsr_monitor_split_bitrate(6001, none, 2, kbps);
+    g_assert_cmpint(kbps[0], ==, 3001);
+    g_assert_cmpint(kbps[1], ==, 3000);
+}
+
+static void
+test_rounding(void)
+{
+    int kbps[7];
+
+    /* The remainder goes out one kbps at a time, nothing is lost */
+    gint64 equal[] = { P_1080P, P_1080P, P_1080P };
+    gsr_monitor_split_bitrate(10000, equal, 3, kbps);
+    g_assert_cmpint(kbps[0], ==, 3334);
+    g_assert_cmpint(kbps[1], ==, 3333);
+    g_assert_cmpint(kbps[2], ==, 3333);
+
+    gint64 seven[] = { 1, 1, 1, 1, 1, 1, 1 };
+    gsr_monitor_split_bitrate(100, seven, 7, kbps);
+    g_assert_cmpint(kbps[0], ==, 15);
+    g_assert_cmpint(kbps[1], ==, 15);
+    g_assert_cmpint(kbps[2], ==, 14);
+    g_assert_cmpint(kbps[6], ==, 14);
+    g_assert_cmpint(sum(kbps, 7), ==, 100);
+
+    /* 6.67 and 3.33: the one that lost more to rounding down gets it */
+    gint64 two_to_one[] = { 2, 1 };
+    gsr_monitor_split_bitrate(10, two_to_one, 2, kbps);
+    g_assert_cmpint(kbps[0], ==, 7);
+    g_assert_cmpint(kbps[1], ==, 3);
+
+    /* Order doesn't matter */
+    gint64 one_to_two[] = { 1, 2 };
+    gsr_monitor_split_bitrate(10, one_to_two, 2, kbps);
+    g_assert_cmpint(kbps[0], ==, 3);
+    g_assert_cmpint(kbps[1], ==, 7);
+
+    /* Too small a budget to split: every recorder still gets 1 kbps */
+    gsr_monitor_split_bitrate(2, equal, 3, kbps);
+    g_assert_cmpint(kbps[0], ==, 1);
+    g_assert_cmpint(kbps[1], ==, 1);
+    g_assert_cmpint(kbps[2], ==, 1);
+
+    /* A large budget over 4K monitors doesn't overflow */
+    gint64 big[] = { P_4K, P_4K };
+    gsr_monitor_split_bitrate(G_MAXINT - 1, big, 2, kbps);
+    g_assert_cmpint(kbps[0], ==, G_MAXINT / 2);
+    g_assert_cmpint(kbps[1], ==, G_MAXINT / 2);
+}
+
+int
+main(int argc, char **argv)
+{
+    g_test_init(&argc, &argv, NULL);
+
+    g_test_add_func("/monitor-split/fps", test_fps);
+    g_test_add_func("/monitor-split/single-monitor", test_single_monitor);
+    g_test_add_func("/monitor-split/unequal-sizes", test_unequal_sizes);
+    g_test_add_func("/monitor-split/rounding", test_rounding);
+    return g_test_run();
+}
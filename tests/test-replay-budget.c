@@ -0,0 +1,119 @@
+/*
+ * gsr-replay-budget.c: bitrate guesses, buffer estimates and the learned
+ * correction factor.
+ */
+
+#include "gsr-replay-budget.h"
+
+#include <unistd.h>
+
+static void
+test_custom_bitrate(void)
+{
+    GsrReplayStream stream = {
+        .codec = "h264", .quality = "custom", .bitrate_kbps = 6000,
+        .width = 1920, .height = 1080, .fps = 60, .n_audio_tracks = 2,
+    };
+    /* (750000 video + 2 × 16000 audio) + 5% container overhead */
+    g_assert_cmpint(gsr_replay_budget_bytes_per_second(&stream), ==, 821100);
+
+    /* Resolution and fps don't matter for a fixed bitrate */
+    stream.width = 640;
+    stream.fps = 30;
+    g_assert_cmpint(gsr_replay_budget_bytes_per_second(&stream), ==, 821100);
+
+    stream.n_audio_tracks = -1;
+    g_assert_cmpint(gsr_replay_budget_bytes_per_second(&stream), ==, 787500);
+}
+
+static void
+test_preset_quality(void)
+{
+    GsrReplayStream stream = {
+        .codec = "h264", .quality = "high",
+        .width = 1920, .height = 1080, .fps = 60, .n_audio_tracks = 1,
+    };
+    gint64 high = gsr_replay_budget_bytes_per_second(&stream);
+    /* 1080p60 "high" h264 is about 7.5 Mbps */
+    g_assert_cmpint(high, >=, 7400000 / 8);
+    g_assert_cmpint(high, <=, 8200000 / 8);
+
+    stream.quality = "medium";
+    gint64 medium = gsr_replay_budget_bytes_per_second(&stream);
+    stream.quality = "ultra";
+    gint64 ultra = gsr_replay_budget_bytes_per_second(&stream);
+    g_assert_cmpint(medium, <, high);
+    g_assert_cmpint(high, <, ultra);
+
+    stream.quality = "high";
+    stream.codec = "hevc_10bit";
+    gint64 hevc = gsr_replay_budget_bytes_per_second(&stream);
+    stream.codec = "av1";
+    gint64 av1 = gsr_replay_budget_bytes_per_second(&stream);
+    g_assert_cmpint(hevc, <, high);
+    g_assert_cmpint(av1, <, hevc);
+
+    /* Twice the frames, twice the video bytes, give or take rounding */
+    stream.codec = "h264";
+    stream.fps = 120;
+    stream.n_audio_tracks = 0;
+    gint64 fast = gsr_replay_budget_bytes_per_second(&stream);
+    stream.fps = 60;
+    gint64 slow = gsr_replay_budget_bytes_per_second(&stream);
+    g_assert_cmpint(fast - 2 * slow, >=, -2);
+    g_assert_cmpint(fast - 2 * slow, <=, 2);
+}
+
+static void
+test_estimate(void)
+{
+    g_assert_cmpint(gsr_replay_budget_estimate(1000, 30, 100), ==, 30000);
+    g_assert_cmpint(gsr_replay_budget_estimate(1000, 30, 150), ==, 45000);
+    /* An unset scale means uncorrected */
+    g_assert_cmpint(gsr_replay_budget_estimate(1000, 30, 0), ==, 30000);
+    g_assert_cmpint(gsr_replay_budget_estimate(1000, -5, 100), ==, 0);
+    /* A long 4K buffer doesn't overflow */
+    g_assert_cmpint(gsr_replay_budget_estimate(G_GINT64_CONSTANT(100000000), 3600, 400),
+                    ==, G_GINT64_CONSTANT(1440000000000));
+}
+
+static void
+test_refine_scale(void)
+{
+    /* A quarter of the way towards the observed 200% */
+    g_assert_cmpint(gsr_replay_budget_refine_scale(100, 1000, 2000), ==, 125);
+    /* Wild measurements are clamped before blending */
+    g_assert_cmpint(gsr_replay_budget_refine_scale(100, 1000, 100000), ==, 175);
+    g_assert_cmpint(gsr_replay_budget_refine_scale(GSR_REPLAY_SCALE_MIN_PERCENT, 1000, 1),
+                    ==, GSR_REPLAY_SCALE_MIN_PERCENT);
+    /* Nothing to learn from */
+    g_assert_cmpint(gsr_replay_budget_refine_scale(130, 0, 2000), ==, 130);
+    g_assert_cmpint(gsr_replay_budget_refine_scale(130, 1000, -1), ==, 130);
+    g_assert_cmpint(gsr_replay_budget_refine_scale(0, 0, 0), ==, 100);
+
+    /* Repeated sessions settle close to what is measured */
+    int scale = 100;
+    for (int i = 0; i < 50; i++)
+        scale = gsr_replay_budget_refine_scale(scale, 1000, 2000);
+    g_assert_cmpint(scale, >=, 190);
+    g_assert_cmpint(scale, <=, 200);
+}
+
+static void
+test_rss(void)
+{
+    g_assert_cmpint(gsr_replay_budget_rss(getpid()), >, 0);
+}
+
+int
+main(int argc, char **argv)
+{
+    g_test_init(&argc, &argv, NULL);
+
+    g_test_add_func("/replay-budget/custom-bitrate", test_custom_bitrate);
+    g_test_add_func("/replay-budget/preset-quality", test_preset_quality);
+    g_test_add_func("/replay-budget/estimate", test_estimate);
+    g_test_add_func("/replay-budget/refine-scale", test_refine_scale);
+    g_test_add_func("/replay-budget/rss", test_rss);
+    return g_test_run();
+}
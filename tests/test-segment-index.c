@@ -0,0 +1,165 @@
+/*
+ * gsr-segment-index.c: the ffconcat playlist is read back the way ffmpeg's
+ * concat demuxer reads it.
+ */
+
+#include "gsr-segment-index.h"
+#include "gsr-test-util.h"
+
+#include <string.h>
+
+typedef struct {
+    GsrTestTmpDir tmp;
+    char         *index_path;
+} Fixture;
+
+static void
+fixture_setup(Fixture *f, gconstpointer data)
+{
+    gsr_test_tmp_dir_setup(&f->tmp, data);
+    f->index_path = gsr_test_tmp_path(&f->tmp, "Video_2026.ffconcat");
+}
+
+static void
+fixture_teardown(Fixture *f, gconstpointer data)
+{
+    gsr_test_tmp_dir_teardown(&f->tmp, data);
+    g_free(f->index_path);
+}
+
+static char *
+make_segment(const Fixture *f, const char *name, gsize size)
+{
+    char *path = g_build_filename(f->tmp.dir, name, NULL);
+    g_autofree char *contents = g_malloc0(size);
+    g_assert_true(g_file_set_contents(path, contents, (gssize)size, NULL));
+    return path;
+}
+
+/* ffconcat tokens: quoted runs, backslash escapes, everything else as is */
+static char *
+unquote(const char *str)
+{
+    GString *out = g_string_new(NULL);
+    for (const char *p = str; *p; p++) {
+        if (*p == '\'') {
+            const char *end = strchr(p + 1, '\'');
+            g_assert_nonnull(end);
+            g_string_append_len(out, p + 1, end - p - 1);
+            p = end;
+        } else if (*p == '\\' && p[1]) {
+            g_string_append_c(out, *++p);
+        } else {
+            g_string_append_c(out, *p);
+        }
+    }
+    return g_string_free(out, FALSE);
+}
+
+/* The files listed in the index, in order */
+static GStrv
+read_index(const char *path)
+{
+    g_autofree char *contents = NULL;
+    g_assert_true(g_file_get_contents(path, &contents, NULL, NULL));
+    g_assert_true(g_str_has_prefix(contents, "ffconcat version 1.0\n"));
+
+    GStrvBuilder *builder = g_strv_builder_new();
+    g_auto(GStrv) lines = g_strsplit(contents, "\n", -1);
+    for (int i = 1; lines[i]; i++) {
+        if (g_str_has_prefix(lines[i], "file ")) {
+            g_autofree char *file = unquote(lines[i] + strlen("file "));
+            g_strv_builder_add(builder, file);
+        } else {
+            g_assert_true(lines[i][0] == '\0' || lines[i][0] == '#');
+        }
+    }
+    GStrv files = g_strv_builder_end(builder);
+    g_strv_builder_unref(builder);
+    return files;
+}
+
+/* Segments are listed by sequence, relative to the index */
+static void
+test_round_trip(Fixture *f, gconstpointer data G_GNUC_UNUSED)
+{
+    GsrSegmentIndex *index = gsr_segment_index_new(f->index_path);
+    g_assert_cmpstr(gsr_segment_index_get_path(index), ==, f->index_path);
+    g_assert_false(g_file_test(f->index_path, G_FILE_TEST_EXISTS));
+
+    g_autofree char *first = make_segment(f, "Video_2026_001.mkv", 100);
+    g_autofree char *second = make_segment(f, "Video_2026_002.mkv", 200);
+    g_autofree char *third = make_segment(f, "Video_2026_003.mkv", 300);
+
+    GError *error = NULL;
+    g_assert_true(gsr_segment_index_add(index, 1, first, &error));
+    g_assert_no_error(error);
+    /* The second one was cut short and finished after the third */
+    g_assert_true(gsr_segment_index_add(index, 3, third, &error));
+    g_assert_true(gsr_segment_index_add(index, 2, second, &error));
+    g_assert_no_error(error);
+    g_assert_cmpuint(gsr_segment_index_get_n_segments(index), ==, 3);
+
+    g_auto(GStrv) files = read_index(f->index_path);
+    const char *expected[] = {
+        "Video_2026_001.mkv", "Video_2026_002.mkv", "Video_2026_003.mkv", NULL,
+    };
+    g_assert_cmpstrv(files, expected);
+
+    /* Sizes are noted in the comments */
+    g_autofree char *contents = NULL;
+    g_assert_true(g_file_get_contents(f->index_path, &contents, NULL, NULL));
+    g_assert_nonnull(strstr(contents, "# 2, 200 bytes\n"));
+
+    gsr_segment_index_free(index);
+}
+
+/* Names ffconcat has to quote come back unchanged */
+static void
+test_quoting(Fixture *f, gconstpointer data G_GNUC_UNUSED)
+{
+    GsrSegmentIndex *index = gsr_segment_index_new(f->index_path);
+
+    g_autofree char *quoted = make_segment(f, "Bob's game # 'final'.mkv", 10);
+    g_assert_true(gsr_segment_index_add(index, 1, quoted, NULL));
+    /* Elsewhere: listed as given */
+    g_assert_true(gsr_segment_index_add(index, 2, "/nonexistent/other dir/seg 2.mkv", NULL));
+
+    g_auto(GStrv) files = read_index(f->index_path);
+    const char *expected[] = {
+        "Bob's game # 'final'.mkv", "/nonexistent/other dir/seg 2.mkv", NULL,
+    };
+    g_assert_cmpstrv(files, expected);
+
+    /* A segment that can't be stat()ed has no size */
+    g_autofree char *contents = NULL;
+    g_assert_true(g_file_get_contents(f->index_path, &contents, NULL, NULL));
+    g_assert_nonnull(strstr(contents, "# 2, -1 bytes\n"));
+
+    gsr_segment_index_free(index);
+}
+
+static void
+test_write_error(Fixture *f, gconstpointer data G_GNUC_UNUSED)
+{
+    g_autofree char *path = g_build_filename(f->tmp.dir, "missing", "index.ffconcat", NULL);
+    GsrSegmentIndex *index = gsr_segment_index_new(path);
+
+    GError *error = NULL;
+    g_assert_false(gsr_segment_index_add(index, 1, "/videos/seg.mkv", &error));
+    g_assert_error(error, G_FILE_ERROR, G_FILE_ERROR_NOENT);
+    g_clear_error(&error);
+
+    gsr_segment_index_free(index);
+}
+
+int
+main(int argc, char **argv)
+{
+    g_test_init(&argc, &argv, NULL);
+
+    g_test_add("/segment-index/round-trip", Fixture, NULL, fixture_setup, test_round_trip, fixture_teardown);
+    g_test_add("/segment-index/quoting", Fixture, NULL, fixture_setup, test_quoting, fixture_teardown);
+    g_test_add("/segment-index/write-error", Fixture, NULL, fixture_setup, test_write_error, fixture_teardown);
+    return g_test_run();
+}
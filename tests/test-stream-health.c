@@ -0,0 +1,237 @@
+/*
+ * gsr-stream-health.c: the bitrate controller, and the send queue
+ * sampler against a fake /proc.  The .c is included to reach
+ * read_send_queue(), which takes the /proc root to read.
+ */
+
+#include "gsr-stream-health.c"
+#include "gsr-test-util.h"
+
+#include <fcntl.h>
+#include <arpa/inet.h>
+
+#define BITRATE_KBPS   6000                    /* 750000 bytes a second */
+#define CONGESTED      400000
+#define HEALTHY        1000
+#define IN_BETWEEN     200000
+#define FAKE_PID       4242
+
+/* ── Controller ──────────────────────────────────────────────────── */
+
+static void
+test_step_down(void)
+{
+    GsrStreamHealth health;
+    gsr_stream_health_reset(&health);
+    gint64 now = G_USEC_PER_SEC;
+
+    for (int i = 1; i < GSR_STREAM_DOWN_AFTER; i++)
+        g_assert_cmpint(gsr_stream_health_sample(&health, CONGESTED, BITRATE_KBPS, now += G_USEC_PER_SEC),
+                        ==, GSR_STREAM_HEALTH_KEEP);
+    g_assert_cmpint(gsr_stream_health_sample(&health, CONGESTED, BITRATE_KBPS, now += G_USEC_PER_SEC),
+                    ==, GSR_STREAM_HEALTH_STEP_DOWN);
+    g_assert_cmpint(health.tier, ==, 1);
+    g_assert_cmpint(gsr_stream_health_bitrate(&health, BITRATE_KBPS), ==, 4200);
+
+    /* A sample in between starts the count over */
+    gsr_stream_health_sample(&health, CONGESTED, BITRATE_KBPS, now += G_USEC_PER_SEC);
+    gsr_stream_health_sample(&health, IN_BETWEEN, BITRATE_KBPS, now += G_USEC_PER_SEC);
+    gsr_stream_health_sample(&health, CONGESTED, BITRATE_KBPS, now += G_USEC_PER_SEC);
+    gsr_stream_health_sample(&health, CONGESTED, BITRATE_KBPS, now += G_USEC_PER_SEC);
+    g_assert_cmpint(health.tier, ==, 1);
+
+    /* An unknown queue is no evidence either way */
+    g_assert_cmpint(gsr_stream_health_sample(&health, -1, BITRATE_KBPS, now += G_USEC_PER_SEC),
+                    ==, GSR_STREAM_HEALTH_KEEP);
+    g_assert_cmpint(health.congested_samples, ==, 0);
+    g_assert_cmpint(health.healthy_samples, ==, 0);
+}
+
+/* A write error steps down on the next sample, whatever the queue */
+static void
+test_write_error(void)
+{
+    GsrStreamHealth health;
+    gsr_stream_health_reset(&health);
+
+    g_assert_false(gsr_stream_health_parse_line(&health, "Info: stream started"));
+    g_assert_true(gsr_stream_health_parse_line(&health,
+        "Error: failed to write frame index 123 to muxer, reason: Broken pipe"));
+    g_assert_cmpint(health.write_errors, ==, 1);
+
+    g_assert_cmpint(gsr_stream_health_sample(&health, HEALTHY, BITRATE_KBPS, G_USEC_PER_SEC),
+                    ==, GSR_STREAM_HEALTH_STEP_DOWN);
+    g_assert_cmpint(health.tier, ==, 1);
+    g_assert_cmpint(health.write_errors, ==, 0);
+}
+
+static void
+test_step_up_and_flapping(void)
+{
+    GsrStreamHealth health;
+    gsr_stream_health_reset(&health);
+    g_assert_true(gsr_stream_health_on_failure(&health));
+    g_assert_cmpint(health.tier, ==, 1);
+
+    gint64 now = G_USEC_PER_SEC;
+    for (int i = 1; i < GSR_STREAM_UP_AFTER; i++)
+        g_assert_cmpint(gsr_stream_health_sample(&health, HEALTHY, BITRATE_KBPS, now += G_USEC_PER_SEC),
+                        ==, GSR_STREAM_HEALTH_KEEP);
+    g_assert_cmpint(gsr_stream_health_sample(&health, HEALTHY, BITRATE_KBPS, now += G_USEC_PER_SEC),
+                    ==, GSR_STREAM_HEALTH_STEP_UP);
+    g_assert_cmpint(health.tier, ==, 0);
+    /* Already at full bitrate */
+    for (int i = 0; i < GSR_STREAM_UP_AFTER; i++)
+        g_assert_cmpint(gsr_stream_health_sample(&health, HEALTHY, BITRATE_KBPS, now += G_USEC_PER_SEC),
+                        ==, GSR_STREAM_HEALTH_KEEP);
+
+    /* Down again within the flap window: the next step up waits longer */
+    health.write_errors = 1;
+    g_assert_cmpint(gsr_stream_health_sample(&health, HEALTHY, BITRATE_KBPS, now += G_USEC_PER_SEC),
+                    ==, GSR_STREAM_HEALTH_STEP_DOWN);
+    g_assert_cmpint(health.up_after, ==, 2 * GSR_STREAM_UP_AFTER);
+
+    /* Long after the last step up, it doesn't */
+    health.write_errors = 1;
+    gsr_stream_health_sample(&health, HEALTHY, BITRATE_KBPS, now + 2 * GSR_STREAM_FLAP_WINDOW_US);
+    g_assert_cmpint(health.tier, ==, 2);
+    g_assert_cmpint(health.up_after, ==, 2 * GSR_STREAM_UP_AFTER);
+}
+
+static void
+test_lowest_tier(void)
+{
+    GsrStreamHealth health;
+    gsr_stream_health_reset(&health);
+
+    for (int i = 1; i < GSR_STREAM_N_TIERS; i++)
+        g_assert_true(gsr_stream_health_on_failure(&health));
+    g_assert_false(gsr_stream_health_on_failure(&health));
+    g_assert_cmpint(health.tier, ==, GSR_STREAM_N_TIERS - 1);
+
+    health.write_errors = 1;
+    g_assert_cmpint(gsr_stream_health_sample(&health, CONGESTED, BITRATE_KBPS, G_USEC_PER_SEC),
+                    ==, GSR_STREAM_HEALTH_KEEP);
+    g_assert_cmpint(gsr_stream_health_bitrate(&health, BITRATE_KBPS), ==, 2100);
+}
+
+/* ── Send queue ──────────────────────────────────────────────────── */
+
+#define TABLE_HEADER \
+    "  sl  local_address rem_address   st tx_queue rx_queue tr tm->when retrnsmt   uid  timeout inode\n"
+
+/* One socket row; queues are hex */
+#define TABLE_ROW(tx_queue, inode) \
+    "   0: 0100007F:A1B2 0100007F:0F8F 01 " tx_queue ":00000000 00:00000000 00000000  1000        0 " inode " 1 0000000000000000 20 4 30 10 -1\n"
+
+typedef GsrTestTmpDir Fixture;
+
+static void
+write_file(const char *root, const char *name, const char *contents)
+{
+    g_autofree char *path = g_strdup_printf("%s/%d/%s", root, FAKE_PID, name);
+    g_assert_true(g_file_set_contents(path, contents, -1, NULL));
+}
+
+static void
+add_fd(const char *root, int fd, const char *target)
+{
+    g_autofree char *path = g_strdup_printf("%s/%d/fd/%d", root, FAKE_PID, fd);
+    g_assert_cmpint(symlink(target, path), ==, 0);
+}
+
+static void
+fixture_setup(Fixture *f, gconstpointer data)
+{
+    gsr_test_tmp_dir_setup(f, data);
+    g_autofree char *fd_dir = g_strdup_printf("%s/%d/fd", f->dir, FAKE_PID);
+    g_autofree char *net_dir = g_strdup_printf("%s/%d/net", f->dir, FAKE_PID);
+    g_assert_cmpint(g_mkdir_with_parents(fd_dir, 0755), ==, 0);
+    g_assert_cmpint(g_mkdir_with_parents(net_dir, 0755), ==, 0);
+}
+
+/* Only the process's own sockets count, over all four tables */
+static void
+test_fake_proc(Fixture *f, gconstpointer data G_GNUC_UNUSED)
+{
+    add_fd(f->dir, 0, "/dev/null");
+    add_fd(f->dir, 3, "socket:[1001]");
+    add_fd(f->dir, 4, "socket:[1002]");
+    add_fd(f->dir, 5, "socket:[2001]");
+    add_fd(f->dir, 6, "pipe:[3001]");
+
+    write_file(f->dir, "net/tcp", TABLE_HEADER
+               TABLE_ROW("00000100", "1001")
+               TABLE_ROW("00005000", "9999"));
+    write_file(f->dir, "net/tcp6", TABLE_HEADER
+               TABLE_ROW("00000020", "1002"));
+    write_file(f->dir, "net/udp", TABLE_HEADER
+               TABLE_ROW("00000010", "2001")
+               TABLE_ROW("00000400", "3001"));
+
+    g_assert_cmpint(read_send_queue(f->dir, FAKE_PID), ==, 0x100 + 0x20 + 0x10);
+}
+
+static void
+test_fake_proc_unknown(Fixture *f, gconstpointer data G_GNUC_UNUSED)
+{
+    /* No such process */
+    g_assert_cmpint(read_send_queue(f->dir, FAKE_PID + 1), ==, -1);
+
+    /* No sockets */
+    add_fd(f->dir, 0, "/dev/null");
+    write_file(f->dir, "net/tcp", TABLE_HEADER TABLE_ROW("00000100", "1001"));
+    g_assert_cmpint(read_send_queue(f->dir, FAKE_PID), ==, -1);
+
+    /* A socket in none of the tables, e.g. a Unix one */
+    add_fd(f->dir, 3, "socket:[5555]");
+    g_assert_cmpint(read_send_queue(f->dir, FAKE_PID), ==, -1);
+
+    /* An empty queue is known, and 0 */
+    add_fd(f->dir, 4, "socket:[1001]");
+    write_file(f->dir, "net/tcp", TABLE_HEADER TABLE_ROW("00000000", "1001"));
+    g_assert_cmpint(read_send_queue(f->dir, FAKE_PID), ==, 0);
+}
+
+/* The real thing: a loopback connection whose peer never reads */
+static void
+test_real_socket(void)
+{
+    int listen_fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    struct sockaddr_in addr = {
+        .sin_family = AF_INET,
+        .sin_addr.s_addr = htonl(INADDR_LOOPBACK),
+    };
+    socklen_t addr_len = sizeof(addr);
+    g_assert_cmpint(bind(listen_fd, (struct sockaddr *)&addr, sizeof(addr)), ==, 0);
+    g_assert_cmpint(listen(listen_fd, 1), ==, 0);
+    g_assert_cmpint(getsockname(listen_fd, (struct sockaddr *)&addr, &addr_len), ==, 0);
+
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    g_assert_cmpint(connect(fd, (struct sockaddr *)&addr, sizeof(addr)), ==, 0);
+    g_assert_cmpint(gsr_stream_health_read_send_queue(getpid()), ==, 0);
+
+    g_assert_cmpint(fcntl(fd, F_SETFL, O_NONBLOCK), ==, 0);
+    static char buf[64 * 1024];
+    while (write(fd, buf, sizeof(buf)) > 0)
+        ;
+    g_assert_cmpint(gsr_stream_health_read_send_queue(getpid()), >, 0);
+
+    close(fd);
+    close(listen_fd);
+}
+
+int
+main(int argc, char **argv)
+{
+    g_test_init(&argc, &argv, NULL);
+
+    g_test_add_func("/stream-health/step-down", test_step_down);
+    g_test_add_func("/stream-health/write-error", test_write_error);
+    g_test_add_func("/stream-health/step-up-and-flapping", test_step_up_and_flapping);
+    g_test_add_func("/stream-health/lowest-tier", test_lowest_tier);
+    g_test_add("/stream-health/fake-proc", Fixture, NULL, fixture_setup, test_fake_proc, gsr_test_tmp_dir_teardown);
+    g_test_add("/stream-health/fake-proc-unknown", Fixture, NULL, fixture_setup, test_fake_proc_unknown, gsr_test_tmp_dir_teardown);
+    g_test_add_func("/stream-health/real-socket", test_real_socket);
+    return g_test_run();
+}
@@ -0,0 +1,388 @@
+/*
+ * gsr-stream-relay.c with a stand-in "ffmpeg" first in PATH that copies
+ * its stdin to the file:// URL it is given.  The test plays the recorder,
+ * streaming into the relay's loopback port from a thread.
+ */
+
+#include "gsr-stream-relay.h"
+#include "gsr-test-util.h"
+
+#include <string.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+
+#include <glib/gstdio.h>
+
+#define WAIT_TIMEOUT_MS 5000
+#define STREAM_SIZE     (1024 * 1024)
+
+static const char fake_ffmpeg[] =
+    "#!/bin/sh\n"
+    "for url; do :; done\n"
+    "case \"$url\" in\n"
+    "file://*fail*) exit 1 ;;\n"
+    "file://*flaky*) [ -e \"${url#file://}.failed\" ] ||\n"
+    "    { : > \"${url#file://}.failed\"; exit 1; }\n"
+    "    exec cat > \"${url#file://}\" ;;\n"
+    "file://*) exec cat > \"${url#file://}\" ;;\n"
+    "*) exec cat > /dev/null ;;\n"
+    "esac\n";
+
+typedef struct {
+    GsrTestTmpDir tmp;
+    char   *old_path;     /* $PATH before the stand-in went first */
+    GBytes *stream;       /* what the "recorder" sends */
+} Fixture;
+
+typedef struct {
+    int     fd;
+    GBytes *data;
+} Sender;
+
+static void
+fixture_setup(Fixture *f, gconstpointer data)
+{
+    gsr_test_tmp_dir_setup(&f->tmp, data);
+
+    g_autofree char *ffmpeg = g_build_filename(f->tmp.dir, "ffmpeg", NULL);
+    g_assert_true(g_file_set_contents(ffmpeg, fake_ffmpeg, -1, NULL));
+    g_assert_cmpint(g_chmod(ffmpeg, 0755), ==, 0);
+    f->old_path = g_strdup(g_getenv("PATH"));
+    g_autofree char *path = g_strjoin(":", f->tmp.dir, f->old_path, NULL);
+    g_setenv("PATH", path, TRUE);
+
+    guint8 *data = g_malloc(STREAM_SIZE);
+    for (gsize i = 0; i < STREAM_SIZE; i++)
+        data[i] = (guint8)(i * 7 + i / 251);
+    f->stream = g_bytes_new_take(data, STREAM_SIZE);
+}
+
+static void
+fixture_teardown(Fixture *f, gconstpointer data)
+{
+    g_setenv("PATH", f->old_path, TRUE);
+    gsr_test_tmp_dir_teardown(&f->tmp, data);
+    g_free(f->old_path);
+    g_bytes_unref(f->stream);
+}
+
+static char *
+dest_path(const Fixture *f, const char *name)
+{
+    return gsr_test_tmp_path(&f->tmp, name);
+}
+
+static char *
+dest_url(const Fixture *f, const char *name)
+{
+    g_autofree char *path = dest_path(f, name);
+    return g_strconcat("file://", path, NULL);
+}
+
+/* ── The "recorder" ──────────────────────────────────────────────── */
+
+static guint16
+input_port(GsrStreamRelay *relay)
+{
+    g_autofree char *url = gsr_stream_relay_get_input_url(relay);
+    g_assert_true(g_str_has_prefix(url, "tcp://127.0.0.1:"));
+    return (guint16)g_ascii_strtoull(url + strlen("tcp://127.0.0.1:"), NULL, 10);
+}
+
+static int
+connect_to_relay(guint16 port)
+{
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    g_assert_cmpint(fd, >=, 0);
+    struct sockaddr_in addr = {
+        .sin_family = AF_INET,
+        .sin_addr.s_addr = htonl(INADDR_LOOPBACK),
+        .sin_port = htons(port),
+    };
+    g_assert_cmpint(connect(fd, (struct sockaddr *)&addr, sizeof(addr)), ==, 0);
+    return fd;
+}
+
+/* Blocking writes: the relay reads them on the main thread meanwhile */
+static gpointer
+sender_thread(gpointer user_data)
+{
+    Sender *sender = user_data;
+    gsize size;
+    const guint8 *data = g_bytes_get_data(sender->data, &size);
+    gsize done = 0;
+    while (done < size) {
+        ssize_t n = write(sender->fd, data + done, size - done);
+        g_assert_cmpint(n, >, 0);
+        done += (gsize)n;
+    }
+    close(sender->fd);
+    g_bytes_unref(sender->data);
+    g_free(sender);
+    return NULL;
+}
+
+/* Sends data on fd and closes it; join the returned thread */
+static GThread *
+send_stream(int fd, GBytes *data)
+{
+    Sender *sender = g_new0(Sender, 1);
+    sender->fd = fd;
+    sender->data = g_bytes_ref(data);
+    return g_thread_new("recorder", sender_thread, sender);
+}
+
+/* ── Conditions ──────────────────────────────────────────────────── */
+
+typedef struct {
+    GsrStreamRelay *relay;
+    guint           index;
+    guint64         bytes_sent;
+    guint           n_restarts;
+    GsrRelayDestState state;
+    const char     *path;
+    gsize           size;
+} Wait;
+
+static gboolean
+dest_sent(gpointer user_data)
+{
+    Wait *wait = user_data;
+    GsrRelayDestInfo info;
+    gsr_stream_relay_get_destination(wait->relay, wait->index, &info);
+    return info.bytes_sent >= wait->bytes_sent;
+}
+
+static gboolean
+dest_restarted(gpointer user_data)
+{
+    Wait *wait = user_data;
+    GsrRelayDestInfo info;
+    gsr_stream_relay_get_destination(wait->relay, wait->index, &info);
+    return info.n_restarts >= wait->n_restarts && info.state == wait->state;
+}
+
+static gboolean
+file_has_size(gpointer user_data)
+{
+    Wait *wait = user_data;
+    GStatBuf st;
+    return g_stat(wait->path, &st) == 0 && (gsize)st.st_size >= wait->size;
+}
+
+static void
+assert_file_equals(const char *path, GBytes *expected)
+{
+    g_autofree char *contents = NULL;
+    gsize length = 0;
+    g_assert_true(g_file_get_contents(path, &contents, &length, NULL));
+    gsize size;
+    const guint8 *data = g_bytes_get_data(expected, &size);
+    g_assert_cmpuint(length, ==, size);
+    g_assert_true(memcmp(contents, data, size) == 0);
+}
+
+/* ── Tests ───────────────────────────────────────────────────────── */
+
+/* Every destination and the local copy get the whole stream */
+static void
+test_fan_out(Fixture *f, gconstpointer data G_GNUC_UNUSED)
+{
+    g_autofree char *url_a = dest_url(f, "a.ts");
+    g_autofree char *url_b = dest_url(f, "b.ts");
+    const char *urls[] = { url_a, url_b, "rtmp://user@live.example.com/app/KEY", NULL };
+    GError *error = NULL;
+    GsrStreamRelay *relay = gsr_stream_relay_new(urls, &error);
+    g_assert_no_error(error);
+    g_assert_nonnull(relay);
+
+    g_autofree char *local = dest_path(f, "local.ts");
+    g_assert_true(gsr_stream_relay_add_file(relay, local, &error));
+    g_assert_no_error(error);
+    g_assert_cmpuint(gsr_stream_relay_get_n_destinations(relay), ==, 4);
+
+    /* No stream key in what is shown */
+    GsrRelayDestInfo info;
+    gsr_stream_relay_get_destination(relay, 2, &info);
+    g_assert_cmpstr(info.name, ==, "rtmp://live.example.com");
+    gsr_stream_relay_get_destination(relay, 3, &info);
+    g_assert_cmpstr(info.name, ==, "local.ts");
+
+    GThread *sender = send_stream(connect_to_relay(input_port(relay)), f->stream);
+    for (guint i = 0; i < 4; i++) {
+        Wait wait = { .relay = relay, .index = i, .bytes_sent = STREAM_SIZE };
+        g_assert_true(gsr_test_iterate_until_cond(dest_sent, &wait, WAIT_TIMEOUT_MS));
+    }
+    g_thread_join(sender);
+
+    for (guint i = 0; i < 4; i++) {
+        gsr_stream_relay_get_destination(relay, i, &info);
+        g_assert_cmpint(info.state, ==, GSR_RELAY_DEST_LIVE);
+        g_assert_cmpuint(info.bytes_sent, ==, STREAM_SIZE);
+        g_assert_cmpuint(info.bytes_dropped, ==, 0);
+        g_assert_cmpuint(info.n_restarts, ==, 0);
+    }
+    g_assert_cmpuint(gsr_stream_relay_get_max_queued(relay), ==, 0);
+
+    g_assert_true(gsr_stream_relay_finish_file(relay));
+    assert_file_equals(local, f->stream);
+
+    g_autofree char *path_a = dest_path(f, "a.ts");
+    g_autofree char *path_b = dest_path(f, "b.ts");
+    Wait wait_a = { .path = path_a, .size = STREAM_SIZE };
+    Wait wait_b = { .path = path_b, .size = STREAM_SIZE };
+    g_assert_true(gsr_test_iterate_until_cond(file_has_size, &wait_a, WAIT_TIMEOUT_MS));
+    g_assert_true(gsr_test_iterate_until_cond(file_has_size, &wait_b, WAIT_TIMEOUT_MS));
+    assert_file_equals(path_a, f->stream);
+    assert_file_equals(path_b, f->stream);
+
+    gsr_stream_relay_free(relay);
+}
+
+/* A destination that exits is retried; the others carry on */
+static void
+test_failing_destination(Fixture *f, gconstpointer data G_GNUC_UNUSED)
+{
+    g_autofree char *url_ok = dest_url(f, "ok.ts");
+    g_autofree char *url_fail = dest_url(f, "fail.ts");
+    const char *urls[] = { url_ok, url_fail, NULL };
+
+    g_test_expect_message(G_LOG_DOMAIN, G_LOG_LEVEL_WARNING, "Simulcast to * stopped (status 1)*");
+    GsrStreamRelay *relay = gsr_stream_relay_new(urls, NULL);
+    g_assert_nonnull(relay);
+
+    Wait retrying = { .relay = relay, .index = 1, .state = GSR_RELAY_DEST_RETRYING };
+    g_assert_true(gsr_test_iterate_until_cond(dest_restarted, &retrying, WAIT_TIMEOUT_MS));
+    g_test_assert_expected_messages();
+
+    GThread *sender = send_stream(connect_to_relay(input_port(relay)), f->stream);
+    Wait sent = { .relay = relay, .index = 0, .bytes_sent = STREAM_SIZE };
+    g_assert_true(gsr_test_iterate_until_cond(dest_sent, &sent, WAIT_TIMEOUT_MS));
+    g_thread_join(sender);
+
+    GsrRelayDestInfo info;
+    gsr_stream_relay_get_destination(relay, 1, &info);
+    g_assert_cmpint(info.state, ==, GSR_RELAY_DEST_RETRYING);
+    g_assert_cmpuint(info.bytes_sent, ==, 0);
+
+    /* Freed before the retry is due: nothing is started again */
+    gsr_stream_relay_free(relay);
+}
+
+/* A reconnecting recorder restarts network destinations; the local
+   copy is appended to */
+static void
+test_reconnect(Fixture *f, gconstpointer data G_GNUC_UNUSED)
+{
+    g_autofree char *url = dest_url(f, "net.ts");
+    const char *urls[] = { url, NULL };
+    GsrStreamRelay *relay = gsr_stream_relay_new(urls, NULL);
+    g_assert_nonnull(relay);
+    g_autofree char *local = dest_path(f, "local.ts");
+    g_assert_true(gsr_stream_relay_add_file(relay, local, NULL));
+
+    gsize half = STREAM_SIZE / 2;
+    g_autoptr(GBytes) first = g_bytes_new_from_bytes(f->stream, 0, half);
+    g_autoptr(GBytes) second = g_bytes_new_from_bytes(f->stream, half, STREAM_SIZE - half);
+
+    GThread *sender = send_stream(connect_to_relay(input_port(relay)), first);
+    Wait sent_first = { .relay = relay, .index = 1, .bytes_sent = half };
+    g_assert_true(gsr_test_iterate_until_cond(dest_sent, &sent_first, WAIT_TIMEOUT_MS));
+    g_thread_join(sender);
+
+    /* Wait for the stand-in to come back before the new stream flows,
+       or the start of it would be dropped */
+    int fd = connect_to_relay(input_port(relay));
+    Wait restarted = { .relay = relay, .index = 0, .n_restarts = 1,
+                       .state = GSR_RELAY_DEST_STARTING };
+    g_assert_true(gsr_test_iterate_until_cond(dest_restarted, &restarted, WAIT_TIMEOUT_MS));
+
+    sender = send_stream(fd, second);
+    Wait sent_second = { .relay = relay, .index = 1, .bytes_sent = STREAM_SIZE };
+    g_assert_true(gsr_test_iterate_until_cond(dest_sent, &sent_second, WAIT_TIMEOUT_MS));
+    g_thread_join(sender);
+
+    g_assert_true(gsr_stream_relay_finish_file(relay));
+    assert_file_equals(local, f->stream);
+
+    /* The restarted destination only saw the second stream */
+    g_autofree char *net = dest_path(f, "net.ts");
+    Wait wait_net = { .path = net, .size = STREAM_SIZE - half };
+    g_assert_true(gsr_test_iterate_until_cond(file_has_size, &wait_net, WAIT_TIMEOUT_MS));
+    assert_file_equals(net, second);
+
+    gsr_stream_relay_free(relay);
+}
+
+/* The local copy doesn't depend on the network: it is written while a
+   destination is down and being restarted, appended to across a
+   reconnect, and added to a file that is already there */
+static void
+test_file_through_restarts(Fixture *f, gconstpointer data G_GNUC_UNUSED)
+{
+    g_autofree char *url = dest_url(f, "flaky.ts");
+    const char *urls[] = { url, NULL };
+    g_autofree char *local = dest_path(f, "local.ts");
+    g_assert_true(g_file_set_contents(local, "earlier\n", -1, NULL));
+
+    g_test_expect_message(G_LOG_DOMAIN, G_LOG_LEVEL_WARNING, "Simulcast to * stopped (status 1)*");
+    GsrStreamRelay *relay = gsr_stream_relay_new(urls, NULL);
+    g_assert_nonnull(relay);
+    g_assert_true(gsr_stream_relay_add_file(relay, local, NULL));
+    Wait retrying = { .relay = relay, .index = 0, .state = GSR_RELAY_DEST_RETRYING };
+    g_assert_true(gsr_test_iterate_until_cond(dest_restarted, &retrying, WAIT_TIMEOUT_MS));
+    g_test_assert_expected_messages();
+
+    gsize half = STREAM_SIZE / 2;
+    g_autoptr(GBytes) first = g_bytes_new_from_bytes(f->stream, 0, half);
+    g_autoptr(GBytes) second = g_bytes_new_from_bytes(f->stream, half, STREAM_SIZE - half);
+
+    /* The destination is down for all of the first stream */
+    GThread *sender = send_stream(connect_to_relay(input_port(relay)), first);
+    Wait sent_first = { .relay = relay, .index = 1, .bytes_sent = half };
+    g_assert_true(gsr_test_iterate_until_cond(dest_sent, &sent_first, WAIT_TIMEOUT_MS));
+    g_thread_join(sender);
+
+    /* The reconnect restarts it, this time for good */
+    int fd = connect_to_relay(input_port(relay));
+    Wait restarted = { .relay = relay, .index = 0, .n_restarts = 1,
+                       .state = GSR_RELAY_DEST_STARTING };
+    g_assert_true(gsr_test_iterate_until_cond(dest_restarted, &restarted, WAIT_TIMEOUT_MS));
+    sender = send_stream(fd, second);
+    Wait sent_second = { .relay = relay, .index = 1, .bytes_sent = STREAM_SIZE };
+    g_assert_true(gsr_test_iterate_until_cond(dest_sent, &sent_second, WAIT_TIMEOUT_MS));
+    g_thread_join(sender);
+
+    GsrRelayDestInfo info;
+    gsr_stream_relay_get_destination(relay, 1, &info);
+    g_assert_cmpint(info.state, ==, GSR_RELAY_DEST_LIVE);
+    g_assert_cmpuint(info.bytes_dropped, ==, 0);
+    g_assert_cmpuint(info.n_restarts, ==, 0);
+
+    g_assert_true(gsr_stream_relay_finish_file(relay));
+    gsize size;
+    const guint8 *stream = g_bytes_get_data(f->stream, &size);
+    g_autoptr(GByteArray) expected = g_byte_array_new();
+    g_byte_array_append(expected, (const guint8 *)"earlier\n", strlen("earlier\n"));
+    g_byte_array_append(expected, stream, (guint)size);
+    g_autoptr(GBytes) expected_bytes = g_byte_array_free_to_bytes(g_steal_pointer(&expected));
+    assert_file_equals(local, expected_bytes);
+
+    gsr_stream_relay_get_destination(relay, 0, &info);
+    g_assert_cmpint(info.state, !=, GSR_RELAY_DEST_FAILED);
+    g_assert_cmpuint(info.n_restarts, >=, 1);
+    gsr_stream_relay_free(relay);
+}
+
+int
+main(int argc, char **argv)
+{
+    g_test_init(&argc, &argv, NULL);
+
+    g_test_add("/stream-relay/fan-out", Fixture, NULL, fixture_setup, test_fan_out, fixture_teardown);
+    g_test_add("/stream-relay/failing-destination", Fixture, NULL, fixture_setup, test_failing_destination, fixture_teardown);
+    g_test_add("/stream-relay/reconnect", Fixture, NULL, fixture_setup, test_reconnect, fixture_teardown);
+    g_test_add("/stream-relay/file-through-restarts", Fixture, NULL, fixture_setup, test_file_through_restarts, fixture_teardown);
+    return g_test_run();
+}
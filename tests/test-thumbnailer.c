@@ -0,0 +1,215 @@
+/*
+ * gsr-thumbnailer.c with a GSR_THUMBNAILER stub that copies a fixed PNG
+ * instead of decoding video, and logs each run.
+ */
+
+#include "gsr-thumbnailer.h"
+#include "gsr-test-util.h"
+
+#include <glib/gstdio.h>
+
+#define WAIT_TIMEOUT_MS 5000
+
+/* 1×1 RGB */
+static const guint8 frame_png[] = {
+    0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00, 0x0d,
+    0x49, 0x48, 0x44, 0x52, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x01,
+    0x08, 0x02, 0x00, 0x00, 0x00, 0x90, 0x77, 0x53, 0xde, 0x00, 0x00, 0x00,
+    0x0c, 0x49, 0x44, 0x41, 0x54, 0x78, 0x9c, 0x63, 0xf8, 0xcf, 0xc0, 0x00,
+    0x00, 0x03, 0x01, 0x01, 0x00, 0xc9, 0xfe, 0x92, 0xef, 0x00, 0x00, 0x00,
+    0x00, 0x49, 0x45, 0x4e, 0x44, 0xae, 0x42, 0x60, 0x82,
+};
+
+typedef struct {
+    GsrTestTmpDir tmp;
+    char       *cache_dir;
+    char       *log_path;     /* one line per stub run: its input */
+    int         n_callbacks;
+    int         n_null;
+    GdkTexture *texture;      /* last one delivered */
+} Fixture;
+
+static void
+fixture_setup(Fixture *f, gconstpointer data)
+{
+    gsr_test_tmp_dir_setup(&f->tmp, data);
+    f->cache_dir = g_build_filename(f->tmp.dir, "cache", NULL);
+    f->log_path = g_build_filename(f->tmp.dir, "log", NULL);
+
+    g_autofree char *frame = g_build_filename(f->tmp.dir, "frame.png", NULL);
+    g_assert_true(g_file_set_contents(frame, (const char *)frame_png,
+                                      sizeof(frame_png), NULL));
+
+    /* Inputs named *broken* fail, like a file the decoder can't read */
+    g_autofree char *script = g_strdup_printf(
+        "echo \"$0\" >> '%s'; case \"$0\" in *broken*) exit 1;; esac; cp '%s' \"$1\"",
+        f->log_path, frame);
+    g_autofree char *quoted = g_shell_quote(script);
+    g_autofree char *command = g_strdup_printf("sh -c %s {input} {output}", quoted);
+    g_setenv("GSR_THUMBNAILER", command, TRUE);
+}
+
+static void
+fixture_teardown(Fixture *f, gconstpointer data)
+{
+    gsr_test_tmp_dir_teardown(&f->tmp, data);
+    g_free(f->cache_dir);
+    g_free(f->log_path);
+    g_clear_object(&f->texture);
+}
+
+static void
+on_thumbnail(GdkTexture *texture, gpointer user_data)
+{
+    Fixture *f = user_data;
+    f->n_callbacks++;
+    if (!texture)
+        f->n_null++;
+    g_set_object(&f->texture, texture);
+}
+
+static int
+count_runs(const Fixture *f)
+{
+    g_autofree char *contents = NULL;
+    if (!g_file_get_contents(f->log_path, &contents, NULL, NULL))
+        return 0;
+    int n = 0;
+    for (const char *p = contents; *p; p++)
+        n += *p == '\n';
+    return n;
+}
+
+static int
+count_cached(const Fixture *f, gint64 *total_bytes)
+{
+    GDir *dir = g_dir_open(f->cache_dir, 0, NULL);
+    g_assert_nonnull(dir);
+    int n = 0;
+    const char *name;
+    while ((name = g_dir_read_name(dir))) {
+        g_autofree char *path = g_build_filename(f->cache_dir, name, NULL);
+        GStatBuf st;
+        g_assert_true(g_str_has_suffix(name, ".png"));
+        g_assert_cmpint(g_stat(path, &st), ==, 0);
+        if (total_bytes)
+            *total_bytes += st.st_size;
+        n++;
+    }
+    g_dir_close(dir);
+    return n;
+}
+
+/* Made once, then served from memory, then from disk */
+static void
+test_cache_hits(Fixture *f, gconstpointer data G_GNUC_UNUSED)
+{
+    GsrThumbnailer *thumbnailer = gsr_thumbnailer_new(f->cache_dir, 1 << 20);
+
+    guint id = gsr_thumbnailer_request(thumbnailer, "/videos/a.mp4", 100, on_thumbnail, f);
+    g_assert_cmpuint(id, !=, 0);
+    g_assert_cmpint(f->n_callbacks, ==, 0);
+    gsr_test_iterate_until(&f->n_callbacks, 1, WAIT_TIMEOUT_MS);
+    g_assert_cmpint(f->n_callbacks, ==, 1);
+    g_assert_nonnull(f->texture);
+    g_assert_cmpint(gdk_texture_get_width(f->texture), ==, 1);
+    g_assert_cmpint(count_runs(f), ==, 1);
+    g_assert_cmpint(count_cached(f, NULL), ==, 1);
+
+    /* In memory: answered before returning */
+    g_assert_cmpuint(gsr_thumbnailer_request(thumbnailer, "/videos/a.mp4", 100, on_thumbnail, f), ==, 0);
+    g_assert_cmpint(f->n_callbacks, ==, 2);
+    g_assert_nonnull(f->texture);
+    gsr_thumbnailer_free(thumbnailer);
+
+    /* On disk: loaded without running the decoder again */
+    thumbnailer = gsr_thumbnailer_new(f->cache_dir, 1 << 20);
+    g_assert_cmpuint(gsr_thumbnailer_request(thumbnailer, "/videos/a.mp4", 100, on_thumbnail, f), !=, 0);
+    gsr_test_iterate_until(&f->n_callbacks, 3, WAIT_TIMEOUT_MS);
+    g_assert_cmpint(f->n_callbacks, ==, 3);
+    g_assert_nonnull(f->texture);
+    g_assert_cmpint(count_runs(f), ==, 1);
+
+    /* A rewritten file is a new thumbnail */
+    gsr_thumbnailer_request(thumbnailer, "/videos/a.mp4", 200, on_thumbnail, f);
+    gsr_test_iterate_until(&f->n_callbacks, 4, WAIT_TIMEOUT_MS);
+    g_assert_cmpint(f->n_callbacks, ==, 4);
+    g_assert_cmpint(count_runs(f), ==, 2);
+    g_assert_cmpint(count_cached(f, NULL), ==, 2);
+
+    g_assert_cmpint(f->n_null, ==, 0);
+    gsr_thumbnailer_free(thumbnailer);
+}
+
+/* A file the decoder fails on isn't retried */
+static void
+test_failure(Fixture *f, gconstpointer data G_GNUC_UNUSED)
+{
+    GsrThumbnailer *thumbnailer = gsr_thumbnailer_new(f->cache_dir, 1 << 20);
+
+    gsr_thumbnailer_request(thumbnailer, "/videos/broken.mp4", 100, on_thumbnail, f);
+    gsr_test_iterate_until(&f->n_callbacks, 1, WAIT_TIMEOUT_MS);
+    g_assert_cmpint(f->n_callbacks, ==, 1);
+    g_assert_cmpint(f->n_null, ==, 1);
+    g_assert_null(f->texture);
+
+    g_assert_cmpuint(gsr_thumbnailer_request(thumbnailer, "/videos/broken.mp4", 100, on_thumbnail, f), ==, 0);
+    g_assert_cmpint(f->n_null, ==, 2);
+    g_assert_cmpint(count_runs(f), ==, 1);
+    g_assert_cmpint(count_cached(f, NULL), ==, 0);
+
+    gsr_thumbnailer_free(thumbnailer);
+}
+
+static void
+test_cancel(Fixture *f, gconstpointer data G_GNUC_UNUSED)
+{
+    GsrThumbnailer *thumbnailer = gsr_thumbnailer_new(f->cache_dir, 1 << 20);
+
+    guint id = gsr_thumbnailer_request(thumbnailer, "/videos/a.mp4", 100, on_thumbnail, f);
+    gsr_thumbnailer_cancel(thumbnailer, id);
+    gsr_thumbnailer_cancel(thumbnailer, 0);
+    gsr_test_iterate_until(NULL, 0, 500);
+    g_assert_cmpint(f->n_callbacks, ==, 0);
+
+    /* Results still on their way when the thumbnailer goes are dropped */
+    gsr_thumbnailer_request(thumbnailer, "/videos/b.mp4", 100, on_thumbnail, f);
+    gsr_thumbnailer_request(thumbnailer, "/videos/c.mp4", 100, on_thumbnail, f);
+    gsr_thumbnailer_free(thumbnailer);
+    gsr_test_iterate_until(NULL, 0, 500);
+    g_assert_cmpint(f->n_callbacks, ==, 0);
+}
+
+/* Over the cap, least recently used thumbnails are deleted */
+static void
+test_disk_cap(Fixture *f, gconstpointer data G_GNUC_UNUSED)
+{
+    const guint64 cap = sizeof(frame_png) * 5 / 2;
+    GsrThumbnailer *thumbnailer = gsr_thumbnailer_new(f->cache_dir, cap);
+
+    const char *paths[] = { "/videos/a.mp4", "/videos/b.mp4", "/videos/c.mp4", "/videos/d.mp4" };
+    for (guint i = 0; i < G_N_ELEMENTS(paths); i++) {
+        gsr_thumbnailer_request(thumbnailer, paths[i], 100, on_thumbnail, f);
+        gsr_test_iterate_until(&f->n_callbacks, (int)i + 1, WAIT_TIMEOUT_MS);
+    }
+    g_assert_cmpint(f->n_callbacks, ==, G_N_ELEMENTS(paths));
+    g_assert_cmpint(f->n_null, ==, 0);
+
+    gint64 total = 0;
+    g_assert_cmpint(count_cached(f, &total), ==, 2);
+    g_assert_cmpint(total, <=, (gint64)cap);
+
+    gsr_thumbnailer_free(thumbnailer);
+}
+
+int
+main(int argc, char **argv)
+{
+    g_test_init(&argc, &argv, NULL);
+
+    g_test_add("/thumbnailer/cache-hits", Fixture, NULL, fixture_setup, test_cache_hits, fixture_teardown);
+    g_test_add("/thumbnailer/failure", Fixture, NULL, fixture_setup, test_failure, fixture_teardown);
+    g_test_add("/thumbnailer/cancel", Fixture, NULL, fixture_setup, test_cancel, fixture_teardown);
+    g_test_add("/thumbnailer/disk-cap", Fixture, NULL, fixture_setup, test_disk_cap, fixture_teardown);
+    return g_test_run();
+}
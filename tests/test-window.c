@@ -0,0 +1,526 @@
+/*
+ * gsr-window.c's child processes, with bench/fake-gpu-screen-recorder as
+ * gpu-screen-recorder, on Xvfb.  The .c is included to reach the state
+ * machine and the children it keeps.  The fake logs every start, signal
+ * and exit to GSR_FAKE_LOG, which is what the tests check against.
+ */
+
+#include "gsr-window.c"
+#include "gsr-test-util.h"
+
+#include <glib/gstdio.h>
+
+#define WAIT_TIMEOUT_MS 5000
+
+static AdwApplication *app;
+
+typedef struct {
+    GsrTestTmpDir tmp;
+    char         *log_path;
+    GsrWindow    *win;
+} Fixture;
+
+/* Config file lines on top of the defaults, a test's data */
+static void
+write_config(const Fixture *f, const char *extra)
+{
+    g_autofree char *dir = gsr_config_get_dir();
+    g_autofree char *path = g_build_filename(dir, "config", NULL);
+    g_autofree char *contents = g_strdup_printf(
+        "main.record_area_option DP-1\n"
+        "main.show_recording_started_notifications false\n"
+        "main.show_recording_stopped_notifications false\n"
+        "main.show_recording_saved_notifications false\n"
+        "record.save_directory %s\n"
+        "replay.save_directory %s\n"
+        "%s",
+        f->tmp.dir, f->tmp.dir, extra ? extra : "");
+    g_assert_cmpint(g_mkdir_with_parents(dir, 0755), ==, 0);
+    g_assert_true(g_file_set_contents(path, contents, -1, NULL));
+}
+
+static void
+fixture_setup(Fixture *f, gconstpointer data)
+{
+    gsr_test_tmp_dir_setup(&f->tmp, data);
+    f->log_path = gsr_test_tmp_path(&f->tmp, "fake.log");
+    g_setenv("GSR_FAKE_LOG", f->log_path, TRUE);
+    write_config(f, data);
+    f->win = gsr_window_new(app);
+}
+
+static gboolean
+window_idle(gpointer user_data)
+{
+    GsrWindow *win = user_data;
+    return win->child_state == CHILD_IDLE && win->monitor_children->len == 0;
+}
+
+static void
+fixture_teardown(Fixture *f, gconstpointer data)
+{
+    gsr_window_stop_process(f->win, NULL);
+    g_assert_true(gsr_test_iterate_until_cond(window_idle, f->win, WAIT_TIMEOUT_MS));
+    gtk_window_destroy(GTK_WINDOW(f->win));
+    gsr_test_iterate_until(NULL, 0, 50);
+    gsr_test_tmp_dir_teardown(&f->tmp, data);
+    g_free(f->log_path);
+}
+
+/* ── The fake's log ──────────────────────────────────────────────── */
+
+typedef struct {
+    char   *event;      /* "start", "exit", "usr1", "usr2" or a signal number */
+    GPid    pid;
+    gint64  time_us;
+    char   *args;       /* of "start" */
+} LogLine;
+
+static void
+log_line_free(gpointer data)
+{
+    LogLine *line = data;
+    g_free(line->event);
+    g_free(line->args);
+    g_free(line);
+}
+
+static GPtrArray *
+read_log(const Fixture *f)
+{
+    GPtrArray *lines = g_ptr_array_new_with_free_func(log_line_free);
+    g_autofree char *contents = NULL;
+    if (!g_file_get_contents(f->log_path, &contents, NULL, NULL))
+        return lines;
+
+    g_auto(GStrv) split = g_strsplit(contents, "\n", -1);
+    for (int i = 0; split[i]; i++) {
+        g_auto(GStrv) fields = g_strsplit(split[i], " ", 4);
+        if (g_strv_length(fields) < 3)
+            continue;
+        LogLine *line = g_new0(LogLine, 1);
+        line->event = g_strdup(fields[0]);
+        line->pid = (GPid)g_ascii_strtoll(fields[1], NULL, 10);
+        line->time_us = g_ascii_strtoll(fields[2], NULL, 10) / 1000;
+        line->args = g_strdup(fields[3]);
+        g_ptr_array_add(lines, line);
+    }
+    return lines;
+}
+
+static guint
+count_events(const Fixture *f, const char *event)
+{
+    g_autoptr(GPtrArray) lines = read_log(f);
+    guint n = 0;
+    for (guint i = 0; i < lines->len; i++) {
+        if (g_str_equal(((LogLine *)g_ptr_array_index(lines, i))->event, event))
+            n++;
+    }
+    return n;
+}
+
+typedef struct {
+    const Fixture *f;
+    const char    *event;
+    guint          n;
+} EventCount;
+
+static gboolean
+events_logged(gpointer user_data)
+{
+    const EventCount *count = user_data;
+    return count_events(count->f, count->event) >= count->n;
+}
+
+/* Wait until the log has n lines of event */
+static void
+wait_for_events(const Fixture *f, const char *event, guint n)
+{
+    EventCount count = { f, event, n };
+    g_assert_true(gsr_test_iterate_until_cond(events_logged, &count, WAIT_TIMEOUT_MS));
+}
+
+/* The value after flag in a start line's arguments */
+static char *
+arg_value(const LogLine *line, const char *flag)
+{
+    g_auto(GStrv) args = g_strsplit(line->args ? line->args : "", " ", -1);
+    for (int i = 0; args[i] && args[i + 1]; i++) {
+        if (g_str_equal(args[i], flag))
+            return g_strdup(args[i + 1]);
+    }
+    return NULL;
+}
+
+/* ── Several monitors ────────────────────────────────────────────── */
+
+#define MULTI_MONITOR_CONFIG \
+    "record.multi_monitor true\n" \
+    "record.monitors DP-1\n" \
+    "record.monitors DP-2\n" \
+    "record.monitors DP-3\n" \
+    "record.multi_fps_budget 60\n" \
+    "record.multi_bitrate_budget_kbps 10000\n"
+
+/* One recorder per monitor, each forked before any is let past the
+   barrier, with its own share of the budgets */
+static void
+test_monitor_barrier(Fixture *f, gconstpointer data G_GNUC_UNUSED)
+{
+    ensure_record_page(f->win);
+    g_assert_true(gsr_window_start_process(f->win, GSR_ACTIVE_MODE_RECORD));
+    g_assert_cmpuint(f->win->monitor_children->len, ==, 2);
+    g_assert_cmpint(f->win->child_pid, >, 0);
+    g_assert_cmpint(f->win->child_state, ==, CHILD_STARTING);
+
+    wait_for_events(f, "start", 3);
+    g_autoptr(GPtrArray) lines = read_log(f);
+    g_assert_cmpuint(lines->len, ==, 3);
+
+    /* Equal monitors: 10000 kbps doesn't split evenly, nothing is lost */
+    static const char *const monitors[] = { "DP-1", "DP-2", "DP-3" };
+    static const char *const kbps[] = { "3334", "3333", "3333" };
+    for (guint m = 0; m < G_N_ELEMENTS(monitors); m++) {
+        const LogLine *found = NULL;
+        for (guint i = 0; i < lines->len; i++) {
+            const LogLine *line = g_ptr_array_index(lines, i);
+            g_autofree char *monitor = arg_value(line, "-w");
+            if (g_strcmp0(monitor, monitors[m]) == 0) {
+                g_assert_null(found);
+                found = line;
+            }
+        }
+        g_assert_nonnull(found);
+        g_autofree char *q = arg_value(found, "-q");
+        g_autofree char *fps = arg_value(found, "-f");
+        g_assert_cmpstr(q, ==, kbps[m]);
+        g_assert_cmpstr(fps, ==, "20");
+
+        /* The window knows it by the pid that exec'd */
+        gboolean known = found->pid == f->win->child_pid;
+        for (guint i = 0; i < f->win->monitor_children->len; i++)
+            known |= found->pid == g_array_index(f->win->monitor_children, MonitorChild, i).pid;
+        g_assert_true(known);
+    }
+
+    /* Stopping the first stops them all */
+    gsr_window_stop_process(f->win, NULL);
+    g_assert_true(gsr_test_iterate_until_cond(window_idle, f->win, WAIT_TIMEOUT_MS));
+    g_assert_cmpuint(count_events(f, "exit"), ==, 3);
+}
+
+/* ── Replay saves ────────────────────────────────────────────────── */
+
+#define REPLAY_CONFIG \
+    "replay.time 60\n" \
+    "replay.storage disk\n"
+
+/* Rounded up to the next length there is; none past the last */
+static void
+test_replay_save_lengths(void)
+{
+    g_assert_cmpint(gsr_replay_save_length_index(-5), ==, -1);
+    g_assert_cmpint(gsr_replay_save_length_index(0), ==, -1);
+    g_assert_cmpint(gsr_replay_save_length_index(1), ==, 0);
+    g_assert_cmpint(gsr_replay_save_length_index(10), ==, 0);
+    g_assert_cmpint(gsr_replay_save_length_index(11), ==, 1);
+    g_assert_cmpint(gsr_replay_save_length_index(30), ==, 1);
+    g_assert_cmpint(gsr_replay_save_length_index(31), ==, 2);
+    g_assert_cmpint(gsr_replay_save_length_index(61), ==, 3);
+    g_assert_cmpint(gsr_replay_save_length_index(30 * 60), ==, GSR_N_REPLAY_SAVE_LENGTHS - 1);
+    g_assert_cmpint(gsr_replay_save_length_index(30 * 60 + 1), ==, -1);
+}
+
+static gboolean
+child_running(gpointer user_data)
+{
+    return ((GsrWindow *)user_data)->child_state == CHILD_RUNNING;
+}
+
+static void
+start_replay(Fixture *f)
+{
+    ensure_replay_page(f->win);
+    g_assert_true(gsr_window_start_process(f->win, GSR_ACTIVE_MODE_REPLAY));
+    g_assert_true(gsr_test_iterate_until_cond(child_running, f->win, WAIT_TIMEOUT_MS));
+    g_assert_cmpint(f->win->replay_buffer_seconds, ==, 60);
+}
+
+/* Save, without waiting out the rate limit between saves */
+static void
+save_replay(Fixture *f, int seconds, const char *event, guint n)
+{
+    f->win->last_save_time = 0;
+    g_assert_true(gsr_window_save_replay(f->win, seconds));
+    wait_for_events(f, event, n);
+}
+
+static guint
+count_saved_files(const Fixture *f, const char *prefix)
+{
+    g_autoptr(GDir) dir = g_dir_open(f->tmp.dir, 0, NULL);
+    g_assert_nonnull(dir);
+    guint n = 0;
+    for (const char *name; (name = g_dir_read_name(dir));)
+        n += g_str_has_prefix(name, prefix);
+    return n;
+}
+
+typedef struct {
+    const Fixture *f;
+    guint          n;
+} SavedCount;
+
+static gboolean
+files_saved(gpointer user_data)
+{
+    const SavedCount *count = user_data;
+    return count_saved_files(count->f, "Replay_fake_") >= count->n;
+}
+
+static void
+wait_for_saved_files(const Fixture *f, guint n)
+{
+    SavedCount count = { f, n };
+    g_assert_true(gsr_test_iterate_until_cond(files_saved, &count, WAIT_TIMEOUT_MS));
+}
+
+/* The ffmpeg stub's output has replaced path */
+static gboolean
+file_trimmed(gpointer user_data)
+{
+    g_autofree char *contents = NULL;
+    return g_file_get_contents(user_data, &contents, NULL, NULL) &&
+           g_str_has_prefix(contents, "trimmed\n");
+}
+
+/* A recorder that documents SIGRTMIN+N gets the length it was asked
+   for, rounded up, and SIGUSR1 for the whole buffer */
+static void
+test_replay_partial(Fixture *f, gconstpointer data G_GNUC_UNUSED)
+{
+    g_assert_true(f->win->info.system_info.supports_partial_saves);
+    start_replay(f);
+
+    save_replay(f, 5, "35", 1);
+    g_assert_cmpint(f->win->last_save_seconds, ==, 10);
+    save_replay(f, 11, "36", 1);
+    g_assert_cmpint(f->win->last_save_seconds, ==, 30);
+
+    /* As long as the buffer, or longer, or no length: all of it */
+    save_replay(f, 45, "usr1", 1);
+    g_assert_cmpint(f->win->last_save_seconds, ==, 0);
+    save_replay(f, 10 * 60, "usr1", 2);
+    save_replay(f, 0, "usr1", 3);
+
+    /* Nothing is cut after a partial save */
+    wait_for_saved_files(f, 5);
+    gsr_test_iterate_until(NULL, 0, 200);
+    g_assert_cmpuint(count_events(f, "ffmpeg"), ==, 0);
+    g_assert_cmpint(f->win->child_state, ==, CHILD_RUNNING);
+}
+
+/* Within the rate limit the second save is dropped */
+static void
+test_replay_rate_limit(Fixture *f, gconstpointer data G_GNUC_UNUSED)
+{
+    start_replay(f);
+    save_replay(f, 0, "usr1", 1);
+    g_assert_false(gsr_window_save_replay(f->win, 0));
+    g_assert_false(gsr_window_save_replay(f->win, 5));
+    gsr_test_iterate_until(NULL, 0, 200);
+    g_assert_cmpuint(count_events(f, "usr1"), ==, 1);
+    g_assert_cmpuint(count_events(f, "35"), ==, 0);
+}
+
+/* An older recorder would exit on SIGRTMIN+N: it saves everything and
+   the file is cut to the length asked for */
+static void
+test_replay_fallback(Fixture *f, gconstpointer data G_GNUC_UNUSED)
+{
+    g_setenv("GSR_FAKE_PARTIAL_SAVES", "no", TRUE);
+    f->win->info.system_info.supports_partial_saves = false;
+    start_replay(f);
+
+    save_replay(f, 5, "usr1", 1);
+    g_assert_cmpint(f->win->last_save_seconds, ==, 10);
+    wait_for_events(f, "ffmpeg", 1);
+
+    g_autoptr(GPtrArray) lines = read_log(f);
+    const LogLine *ffmpeg = NULL;
+    for (guint i = 0; i < lines->len; i++) {
+        const LogLine *line = g_ptr_array_index(lines, i);
+        if (g_str_equal(line->event, "ffmpeg"))
+            ffmpeg = line;
+    }
+    g_assert_nonnull(ffmpeg);
+    g_autofree char *sseof = arg_value(ffmpeg, "-sseof");
+    g_autofree char *input = arg_value(ffmpeg, "-i");
+    g_assert_cmpstr(sseof, ==, "-10");
+    g_assert_true(g_str_has_prefix(input, f->tmp.dir));
+
+    /* The cut copy replaces the file, under its name */
+    g_assert_true(gsr_test_iterate_until_cond(file_trimmed, input, WAIT_TIMEOUT_MS));
+
+    /* The whole buffer isn't cut; the saves keep their order */
+    save_replay(f, 45, "usr1", 2);
+    wait_for_saved_files(f, 2);
+    gsr_test_iterate_until(NULL, 0, 200);
+    g_assert_cmpuint(count_events(f, "ffmpeg"), ==, 1);
+    g_assert_cmpuint(count_saved_files(f, ".trim-"), ==, 0);
+    g_assert_cmpuint(count_events(f, "exit"), ==, 0);
+    g_assert_cmpint(f->win->child_state, ==, CHILD_RUNNING);
+    g_unsetenv("GSR_FAKE_PARTIAL_SAVES");
+}
+
+/* ── Bursts of requests ──────────────────────────────────────────── */
+
+#define STRESS_ROUNDS 40
+
+/* Toggles faster than children start and stop: never two recorders at
+   once, and what runs in the end is what was asked for last */
+static void
+test_stress_toggles(Fixture *f, gconstpointer data G_GNUC_UNUSED)
+{
+    ensure_record_page(f->win);
+    ensure_replay_page(f->win);
+
+    for (int i = 0; i < STRESS_ROUNDS; i++) {
+        switch (g_test_rand_int_range(0, 3)) {
+        case 0:
+            gsr_window_start_process(f->win, GSR_ACTIVE_MODE_RECORD);
+            break;
+        case 1:
+            gsr_window_start_process(f->win, GSR_ACTIVE_MODE_REPLAY);
+            break;
+        default:
+            gsr_window_stop_process(f->win, NULL);
+            break;
+        }
+        /* Sometimes within the settle time, sometimes past it */
+        gsr_test_iterate_until(NULL, 0, g_test_rand_int_range(0, 2 * CHILD_SETTLE_MS));
+    }
+    g_assert_true(gsr_window_start_process(f->win, GSR_ACTIVE_MODE_REPLAY));
+    g_assert_true(gsr_test_iterate_until_cond(child_running, f->win, WAIT_TIMEOUT_MS));
+    g_assert_cmpint(f->win->active_mode, ==, GSR_ACTIVE_MODE_REPLAY);
+
+    /* Each start comes after the previous child's exit */
+    g_autoptr(GPtrArray) lines = read_log(f);
+    GPid live = 0;
+    guint starts = 0;
+    for (guint i = 0; i < lines->len; i++) {
+        const LogLine *line = g_ptr_array_index(lines, i);
+        if (g_str_equal(line->event, "start")) {
+            g_assert_cmpint(live, ==, 0);
+            live = line->pid;
+            starts++;
+        } else if (g_str_equal(line->event, "exit")) {
+            g_assert_cmpint(line->pid, ==, live);
+            live = 0;
+        }
+    }
+    g_assert_cmpint(live, ==, f->win->child_pid);
+    g_assert_cmpuint(starts, ==, count_events(f, "exit") + 1);
+
+    /* The one left is a replay */
+    const LogLine *last = NULL;
+    for (guint i = 0; i < lines->len; i++) {
+        const LogLine *line = g_ptr_array_index(lines, i);
+        if (g_str_equal(line->event, "start"))
+            last = line;
+    }
+    g_autofree char *replay_time = arg_value(last, "-r");
+    g_assert_cmpstr(replay_time, ==, "60");
+}
+
+/* Save requests faster than the rate limit: the ones let through are
+   at least MIN_SAVE_INTERVAL_US apart */
+static void
+test_stress_saves(Fixture *f, gconstpointer data G_GNUC_UNUSED)
+{
+    start_replay(f);
+
+    gint64 end = g_get_monotonic_time() + 3 * MIN_SAVE_INTERVAL_US + MIN_SAVE_INTERVAL_US / 2;
+    gint64 sent_at[8];
+    guint sent = 0;
+    while (g_get_monotonic_time() < end) {
+        if (gsr_window_send_signal(f->win, SIGUSR1)) {
+            gint64 now = f->win->last_save_time;
+            g_assert_cmpuint(sent, <, G_N_ELEMENTS(sent_at));
+            if (sent > 0)
+                g_assert_cmpint(now - sent_at[sent - 1], >=, MIN_SAVE_INTERVAL_US);
+            sent_at[sent++] = now;
+        }
+        gsr_test_iterate_until(NULL, 0, 50);
+    }
+    g_assert_cmpuint(sent, >=, 3);
+    g_assert_cmpuint(sent, <=, 4);
+    wait_for_events(f, "usr1", sent);
+
+    g_autoptr(GPtrArray) lines = read_log(f);
+    gint64 prev = 0;
+    for (guint i = 0; i < lines->len; i++) {
+        const LogLine *line = g_ptr_array_index(lines, i);
+        if (!g_str_equal(line->event, "usr1"))
+            continue;
+        /* Logged by the child, a little after each was sent */
+        if (prev)
+            g_assert_cmpint(line->time_us - prev, >=, MIN_SAVE_INTERVAL_US - 100 * 1000);
+        prev = line->time_us;
+    }
+    g_assert_cmpuint(count_events(f, "usr1"), ==, sent);
+}
+
+int
+main(int argc, char **argv)
+{
+    g_test_init(&argc, &argv, G_TEST_OPTION_ISOLATE_DIRS, NULL);
+
+    /* 77: skipped, for meson; it runs this under xvfb-run */
+    const char *fake = g_getenv("GSR_FAKE_RECORDER");
+    if (!fake || !gtk_init_check())
+        return 77;
+
+    /* Only criticals fail a test: GTK warns about what Xvfb lacks */
+    g_log_set_always_fatal(G_LOG_FATAL_MASK | G_LOG_LEVEL_CRITICAL);
+
+    /* gpu-screen-recorder is the fake, for --info as for captures */
+    g_autofree char *bin_dir = g_dir_make_tmp("gsr-test-window-bin-XXXXXX", NULL);
+    g_assert_nonnull(bin_dir);
+    g_autofree char *link = g_build_filename(bin_dir, "gpu-screen-recorder", NULL);
+    g_assert_cmpint(symlink(fake, link), ==, 0);
+    g_autofree char *path = g_strdup_printf("%s:%s", bin_dir, g_getenv("PATH"));
+    g_setenv("PATH", path, TRUE);
+    g_setenv("GSR_FAKE_MONITORS", "3", TRUE);
+
+    /* ffmpeg, for cutting replays: logs like the fake and marks its copy */
+    g_autofree char *ffmpeg = g_build_filename(bin_dir, "ffmpeg", NULL);
+    static const char ffmpeg_stub[] =
+        "#!/bin/sh\n"
+        "echo \"ffmpeg $$ $(date +%s%N) $*\" >> \"$GSR_FAKE_LOG\"\n"
+        "prev=\n"
+        "for arg; do\n"
+        "    [ \"$prev\" = -i ] && input=$arg\n"
+        "    prev=$arg\n"
+        "done\n"
+        "{ echo trimmed; cat \"$input\"; } > \"$prev\"\n";
+    g_assert_true(g_file_set_contents(ffmpeg, ffmpeg_stub, -1, NULL));
+    g_assert_cmpint(g_chmod(ffmpeg, 0755), ==, 0);
+
+    app = adw_application_new("com.dec05eba.gpu_screen_recorder.Test", G_APPLICATION_NON_UNIQUE);
+    g_assert_true(g_application_register(G_APPLICATION(app), NULL, NULL));
+
+    g_test_add("/window/monitor-barrier", Fixture, MULTI_MONITOR_CONFIG, fixture_setup, test_monitor_barrier, fixture_teardown);
+    g_test_add_func("/window/replay-save-lengths", test_replay_save_lengths);
+    g_test_add("/window/replay-partial", Fixture, REPLAY_CONFIG, fixture_setup, test_replay_partial, fixture_teardown);
+    g_test_add("/window/replay-rate-limit", Fixture, REPLAY_CONFIG, fixture_setup, test_replay_rate_limit, fixture_teardown);
+    g_test_add("/window/replay-fallback", Fixture, REPLAY_CONFIG, fixture_setup, test_replay_fallback, fixture_teardown);
+    g_test_add("/window/stress-toggles", Fixture, REPLAY_CONFIG, fixture_setup, test_stress_toggles, fixture_teardown);
+    g_test_add("/window/stress-saves", Fixture, REPLAY_CONFIG, fixture_setup, test_stress_saves, fixture_teardown);
+    int result = g_test_run();
+
+    g_object_unref(app);
+    gsr_test_remove_tree(bin_dir);
+    return result;
+}
@@ -0,0 +1,493 @@
+/*
+ * gsr-x11-hotkeys.c on Xvfb, typed at with XTest on a connection of the
+ * test's own.  Both backends get the same chords; keymap changes are made
+ * with XChangeKeyboardMapping and undone after each test.  The .c is
+ * included to reach the bindings, and to queue exact auto-repeat
+ * sequences (which XTest can't produce on demand) in front of the
+ * watcher's own events.
+ */
+
+#include "gsr-x11-hotkeys.c"
+#include "gsr-test-util.h"
+
+#include <X11/extensions/XTest.h>
+
+#define WAIT_TIMEOUT_MS  5000
+#define SETTLE_MS        100
+
+enum {
+    ACTION_F1_PRESS = 1,
+    ACTION_F1_RELEASE,
+    ACTION_F2_PRESS,
+};
+
+static struct {
+    Display *display;
+    Window   root;
+    KeyCode  ctrl, shift, num_lock, f1, f2;
+    KeyCode  spare;        /* no symbols on the default map, 0 if none */
+} x;
+
+typedef struct {
+    GsrX11Hotkeys *hk;
+    GArray        *fired;  /* actions, in order */
+    int            n_fired;
+    gint64         started;
+    /* For undoing keymap changes */
+    int            keysyms_per_keycode;
+    KeySym        *saved_keymap;
+    int            min_keycode, n_keycodes;
+} Fixture;
+
+static void
+on_hotkey(const GsrX11HotkeyCombo *combo, int64_t event_time_us, void *userdata)
+{
+    Fixture *f = userdata;
+    g_assert_cmpint(event_time_us, >=, f->started - G_USEC_PER_SEC);
+    g_assert_cmpint(event_time_us, <=, g_get_monotonic_time());
+    g_array_append_val(f->fired, combo->action);
+    f->n_fired++;
+}
+
+static bool
+add_hotkey(Fixture *f, unsigned int modifiers, KeySym keysym, bool on_press, int action)
+{
+    GsrX11HotkeyCombo combo = {
+        .modifiers = modifiers,
+        .keysym = keysym,
+        .on_press = on_press,
+        .action = action,
+    };
+    return gsr_x11_hotkeys_grab(f->hk, combo);
+}
+
+static void
+fixture_setup(Fixture *f, gconstpointer data)
+{
+    f->fired = g_array_new(FALSE, FALSE, sizeof(int));
+    f->started = g_get_monotonic_time();
+
+    XDisplayKeycodes(x.display, &f->min_keycode, &f->n_keycodes);
+    f->n_keycodes = f->n_keycodes - f->min_keycode + 1;
+    f->saved_keymap = XGetKeyboardMapping(x.display, (KeyCode)f->min_keycode,
+                                          f->n_keycodes, &f->keysyms_per_keycode);
+
+    f->hk = gsr_x11_hotkeys_new(x.display, GPOINTER_TO_INT(data), on_hotkey, f);
+    g_assert_nonnull(f->hk);
+    g_assert_cmpint(gsr_x11_hotkeys_get_backend(f->hk), ==, GPOINTER_TO_INT(data));
+
+    g_assert_true(add_hotkey(f, ControlMask, XK_F1, true, ACTION_F1_PRESS));
+    g_assert_true(add_hotkey(f, ControlMask, XK_F1, false, ACTION_F1_RELEASE));
+    g_assert_true(add_hotkey(f, ControlMask | ShiftMask, XK_F2, true, ACTION_F2_PRESS));
+}
+
+static void
+fixture_teardown(Fixture *f, gconstpointer data G_GNUC_UNUSED)
+{
+    gsr_x11_hotkeys_free(f->hk);
+    XUngrabKeyboard(x.display, CurrentTime);
+    XChangeKeyboardMapping(x.display, f->min_keycode, f->keysyms_per_keycode,
+                           f->saved_keymap, f->n_keycodes);
+    XSync(x.display, False);
+    XFree(f->saved_keymap);
+    g_array_unref(f->fired);
+}
+
+/* ── Typing ──────────────────────────────────────────────────────── */
+
+static void
+type_key(KeyCode keycode, bool down)
+{
+    XTestFakeKeyEvent(x.display, keycode, down, CurrentTime);
+    XSync(x.display, False);
+}
+
+/* Wait until n hotkeys fired in all, then a little more for extra ones */
+static void
+wait_fired(Fixture *f, int n)
+{
+    gsr_test_iterate_until(&f->n_fired, n, WAIT_TIMEOUT_MS);
+    gsr_test_iterate_until(NULL, 0, SETTLE_MS);
+    g_assert_cmpint(f->n_fired, ==, n);
+}
+
+static void
+assert_fired(const Fixture *f, const int *actions, guint n)
+{
+    g_assert_cmpuint(f->fired->len, ==, n);
+    for (guint i = 0; i < n; i++)
+        g_assert_cmpint(g_array_index(f->fired, int, i), ==, actions[i]);
+}
+
+/* ── Lock state ──────────────────────────────────────────────────── */
+
+static void
+test_lock_state(void)
+{
+    /* NumLock moved to Mod3: Mod2 is a real modifier again */
+    GsrX11Hotkeys fake = { .numlockmask = Mod3Mask };
+    g_assert_cmpuint(key_state_without_locks(&fake, ControlMask | Mod3Mask | LockMask), ==, ControlMask);
+    g_assert_cmpuint(key_state_without_locks(&fake, ControlMask | Mod2Mask), ==, ControlMask | Mod2Mask);
+
+    fake.numlockmask = 0;
+    g_assert_cmpuint(key_state_without_locks(&fake, Mod1Mask | Mod2Mask | LockMask), ==, Mod1Mask | Mod2Mask);
+}
+
+/* ── Edges ───────────────────────────────────────────────────────── */
+
+static void
+test_edges(Fixture *f, gconstpointer data G_GNUC_UNUSED)
+{
+    /* The same keys and edge can't be bound twice */
+    g_assert_false(add_hotkey(f, ControlMask, XK_F1, true, ACTION_F1_PRESS));
+
+    type_key(x.ctrl, true);
+    type_key(x.f1, true);
+    wait_fired(f, 1);
+    type_key(x.f1, false);
+    wait_fired(f, 2);
+    type_key(x.ctrl, false);
+
+    /* Without its modifiers, or with extra ones, it isn't the chord */
+    type_key(x.f1, true);
+    type_key(x.f1, false);
+    type_key(x.ctrl, true);
+    type_key(x.f2, true);
+    type_key(x.f2, false);
+    type_key(x.ctrl, false);
+    wait_fired(f, 2);
+
+    type_key(x.ctrl, true);
+    type_key(x.shift, true);
+    type_key(x.f2, true);
+    type_key(x.f2, false);
+    type_key(x.shift, false);
+    type_key(x.ctrl, false);
+    wait_fired(f, 3);
+
+    static const int expected[] = { ACTION_F1_PRESS, ACTION_F1_RELEASE, ACTION_F2_PRESS };
+    assert_fired(f, expected, G_N_ELEMENTS(expected));
+}
+
+static void
+test_num_lock(Fixture *f, gconstpointer data G_GNUC_UNUSED)
+{
+    if (!x.num_lock || !f->hk->numlockmask) {
+        g_test_skip("NumLock isn't a modifier on this server");
+        return;
+    }
+
+    type_key(x.num_lock, true);
+    type_key(x.num_lock, false);
+    type_key(x.ctrl, true);
+    type_key(x.f1, true);
+    type_key(x.f1, false);
+    type_key(x.ctrl, false);
+    type_key(x.num_lock, true);
+    type_key(x.num_lock, false);
+    wait_fired(f, 2);
+
+    static const int expected[] = { ACTION_F1_PRESS, ACTION_F1_RELEASE };
+    assert_fired(f, expected, G_N_ELEMENTS(expected));
+}
+
+/* Another client holding the keyboard: grabs go quiet, raw events don't */
+static void
+test_keyboard_grabbed(Fixture *f, gconstpointer data)
+{
+    g_assert_cmpint(XGrabKeyboard(x.display, x.root, False, GrabModeAsync, GrabModeAsync, CurrentTime),
+                    ==, GrabSuccess);
+    type_key(x.ctrl, true);
+    type_key(x.f1, true);
+    type_key(x.f1, false);
+    type_key(x.ctrl, false);
+
+    bool raw = GPOINTER_TO_INT(data) == GSR_X11_HOTKEY_BACKEND_RAW;
+    wait_fired(f, raw ? 2 : 0);
+}
+
+/* ── Auto-repeat ─────────────────────────────────────────────────── */
+
+/* A second ago by the server's clock, which key events are stamped with */
+static Time
+second_ago(const Fixture *f)
+{
+    uint32_t now_ms = (uint32_t)(g_get_monotonic_time() / 1000);
+    return (Time)(uint32_t)(now_ms - f->hk->server_time_offset - 1000);
+}
+
+/* A core event as the server would send it for the chord's key */
+static XEvent
+key_event(const Fixture *f, int type, Time time)
+{
+    XEvent ev = { 0 };
+    ev.xkey.type = type;
+    ev.xkey.display = f->hk->display;
+    ev.xkey.window = f->hk->root;
+    ev.xkey.root = f->hk->root;
+    ev.xkey.time = time;
+    ev.xkey.state = ControlMask;
+    ev.xkey.keycode = x.f1;
+    ev.xkey.same_screen = True;
+    return ev;
+}
+
+/* Put events in front of the watcher's queue and handle them now */
+static void
+dispatch_events(Fixture *f, XEvent *events, int n)
+{
+    for (int i = n - 1; i >= 0; i--)
+        XPutBackEvent(f->hk->display, &events[i]);
+    x11_source_dispatch(f->hk->source, NULL, f->hk);
+}
+
+static void
+test_repeat_detectable(Fixture *f, gconstpointer data G_GNUC_UNUSED)
+{
+    /* Repeats are more presses, then one release */
+    bool detectable = f->hk->detectable_repeat;
+    f->hk->detectable_repeat = true;
+    Time t = second_ago(f);
+    XEvent events[] = {
+        key_event(f, KeyPress, t),
+        key_event(f, KeyPress, t + 500),
+        key_event(f, KeyPress, t + 533),
+        key_event(f, KeyPress, t + 566),
+        key_event(f, KeyRelease, t + 600),
+    };
+    dispatch_events(f, events, G_N_ELEMENTS(events));
+    f->hk->detectable_repeat = detectable;
+
+    /* XTest presses a held key again as the server would repeat it */
+    type_key(x.ctrl, true);
+    type_key(x.f1, true);
+    type_key(x.f1, true);
+    type_key(x.f1, true);
+    type_key(x.f1, false);
+    type_key(x.ctrl, false);
+    wait_fired(f, 4);
+
+    static const int expected[] = {
+        ACTION_F1_PRESS, ACTION_F1_RELEASE,
+        ACTION_F1_PRESS, ACTION_F1_RELEASE,
+    };
+    assert_fired(f, expected, G_N_ELEMENTS(expected));
+}
+
+static void
+test_repeat_fallback(Fixture *f, gconstpointer data G_GNUC_UNUSED)
+{
+    /* Without detectable repeat each repeat is a Release+Press pair at
+       one timestamp; a real release is followed by nothing, or by a
+       press at another time */
+    f->hk->detectable_repeat = false;
+    Time t = second_ago(f);
+    XEvent events[] = {
+        key_event(f, KeyPress, t),
+        key_event(f, KeyRelease, t + 500),
+        key_event(f, KeyPress, t + 500),
+        key_event(f, KeyRelease, t + 533),
+        key_event(f, KeyPress, t + 533),
+        key_event(f, KeyRelease, t + 600),
+        key_event(f, KeyPress, t + 700),
+        key_event(f, KeyRelease, t + 800),
+    };
+    dispatch_events(f, events, G_N_ELEMENTS(events));
+
+    static const int expected[] = {
+        ACTION_F1_PRESS, ACTION_F1_RELEASE,
+        ACTION_F1_PRESS, ACTION_F1_RELEASE,
+    };
+    assert_fired(f, expected, G_N_ELEMENTS(expected));
+}
+
+/* ── Keymap changes ──────────────────────────────────────────────── */
+
+static void
+set_keysyms(const Fixture *f, KeyCode keycode, KeySym level1, KeySym level2)
+{
+    KeySym *syms = g_new0(KeySym, f->keysyms_per_keycode);
+    syms[0] = level1;
+    if (f->keysyms_per_keycode > 1)
+        syms[1] = level2;
+    XChangeKeyboardMapping(x.display, keycode, f->keysyms_per_keycode, syms, 1);
+    XSync(x.display, False);
+    g_free(syms);
+}
+
+static Binding *
+find_binding(const Fixture *f, int action)
+{
+    for (guint i = 0; i < f->hk->bindings->len; i++) {
+        Binding *b = g_ptr_array_index(f->hk->bindings, i);
+        if (b->combo.action == action)
+            return b;
+    }
+    g_assert_not_reached();
+}
+
+typedef struct {
+    const Fixture *f;
+    int            action;
+    KeyCode        keycode;
+} BindingWait;
+
+static gboolean
+binding_on(gpointer user_data)
+{
+    const BindingWait *w = user_data;
+    return find_binding(w->f, w->action)->keycode == w->keycode;
+}
+
+static void
+wait_for_binding(const Fixture *f, int action, KeyCode keycode)
+{
+    BindingWait w = { f, action, keycode };
+    g_assert_true(gsr_test_iterate_until_cond(binding_on, &w, WAIT_TIMEOUT_MS));
+}
+
+static void
+test_keymap_change(Fixture *f, gconstpointer data G_GNUC_UNUSED)
+{
+    if (!x.spare) {
+        g_test_skip("No unused keycode on this server");
+        return;
+    }
+
+    /* F1 moves to another key */
+    set_keysyms(f, x.spare, XK_F1, NoSymbol);
+    set_keysyms(f, x.f1, NoSymbol, NoSymbol);
+    wait_for_binding(f, ACTION_F1_PRESS, x.spare);
+    wait_for_binding(f, ACTION_F1_RELEASE, x.spare);
+    g_assert_true(find_binding(f, ACTION_F2_PRESS)->keycode == x.f2);
+
+    /* The old key is nothing now */
+    type_key(x.ctrl, true);
+    type_key(x.f1, true);
+    type_key(x.f1, false);
+    type_key(x.ctrl, false);
+    wait_fired(f, 0);
+
+    type_key(x.ctrl, true);
+    type_key(x.spare, true);
+    type_key(x.spare, false);
+    type_key(x.ctrl, false);
+    wait_fired(f, 2);
+
+    /* And back */
+    set_keysyms(f, x.f1, XK_F1, NoSymbol);
+    set_keysyms(f, x.spare, NoSymbol, NoSymbol);
+    wait_for_binding(f, ACTION_F1_PRESS, x.f1);
+    type_key(x.ctrl, true);
+    type_key(x.f1, true);
+    type_key(x.f1, false);
+    type_key(x.ctrl, false);
+    wait_fired(f, 4);
+
+    /* Gone from the keyboard: unbound, and nothing fires */
+    set_keysyms(f, x.f1, NoSymbol, NoSymbol);
+    wait_for_binding(f, ACTION_F1_PRESS, 0);
+    type_key(x.ctrl, true);
+    type_key(x.f1, true);
+    type_key(x.f1, false);
+    type_key(x.ctrl, false);
+    wait_fired(f, 4);
+}
+
+static void
+test_keymap_collision(Fixture *f, gconstpointer data G_GNUC_UNUSED)
+{
+    /* Ctrl+F2 on press would be the same chord as Ctrl+F1 once F2 is
+       only a shifted F1 */
+    g_assert_true(add_hotkey(f, ControlMask, XK_F2, true, ACTION_F2_PRESS));
+
+    g_test_expect_message(G_LOG_DOMAIN, G_LOG_LEVEL_WARNING, "Hotkey (keysym=0x*) is on the same keys*");
+    set_keysyms(f, x.f2, NoSymbol, NoSymbol);
+    set_keysyms(f, x.f1, XK_F1, XK_F2);
+    gsr_test_iterate_until(NULL, 0, SETTLE_MS * 5);
+    g_test_assert_expected_messages();
+
+    /* F1 had the keys first and keeps them */
+    g_assert_true(find_binding(f, ACTION_F1_PRESS)->keycode == x.f1);
+    g_assert_true(g_hash_table_lookup(f->hk->by_key, BINDING_KEY(x.f1, ControlMask, true))
+                  == find_binding(f, ACTION_F1_PRESS));
+    for (guint i = 0; i < f->hk->bindings->len; i++) {
+        const Binding *b = g_ptr_array_index(f->hk->bindings, i);
+        if (b->combo.keysym == XK_F2 && b->combo.modifiers == ControlMask)
+            g_assert_true(b->keycode == 0);
+    }
+
+    type_key(x.ctrl, true);
+    type_key(x.f1, true);
+    type_key(x.f1, false);
+    type_key(x.ctrl, false);
+    wait_fired(f, 2);
+    static const int expected[] = { ACTION_F1_PRESS, ACTION_F1_RELEASE };
+    assert_fired(f, expected, G_N_ELEMENTS(expected));
+}
+
+static KeyCode
+find_spare_keycode(void)
+{
+    int min_kc = 0, max_kc = 0;
+    XDisplayKeycodes(x.display, &min_kc, &max_kc);
+    for (int kc = max_kc; kc >= min_kc; kc--) {
+        if (XkbKeycodeToKeysym(x.display, (KeyCode)kc, 0, 0) == NoSymbol &&
+            XkbKeycodeToKeysym(x.display, (KeyCode)kc, 0, 1) == NoSymbol)
+            return (KeyCode)kc;
+    }
+    return 0;
+}
+
+static void
+add_backend_tests(const char *name, GsrX11HotkeyBackend backend)
+{
+    static const struct {
+        const char *name;
+        void (*func)(Fixture *, gconstpointer);
+    } tests[] = {
+        { "edges",            test_edges },
+        { "num-lock",         test_num_lock },
+        { "keyboard-grabbed", test_keyboard_grabbed },
+        { "keymap-change",    test_keymap_change },
+        { "keymap-collision", test_keymap_collision },
+    };
+    for (guint i = 0; i < G_N_ELEMENTS(tests); i++) {
+        g_autofree char *path = g_strdup_printf("/x11-hotkeys/%s/%s", name, tests[i].name);
+        g_test_add(path, Fixture, GINT_TO_POINTER(backend), fixture_setup, tests[i].func, fixture_teardown);
+    }
+}
+
+int
+main(int argc, char **argv)
+{
+    g_test_init(&argc, &argv, NULL);
+    g_test_add_func("/x11-hotkeys/lock-state", test_lock_state);
+
+    /* 77: skipped, for meson; it runs this under xvfb-run */
+    x.display = XOpenDisplay(NULL);
+    if (!x.display)
+        return 77;
+    int event_base, error_base, major, minor;
+    if (!XTestQueryExtension(x.display, &event_base, &error_base, &major, &minor))
+        return 77;
+    x.root = DefaultRootWindow(x.display);
+    x.ctrl = XKeysymToKeycode(x.display, XK_Control_L);
+    x.shift = XKeysymToKeycode(x.display, XK_Shift_L);
+    x.num_lock = XKeysymToKeycode(x.display, XK_Num_Lock);
+    x.f1 = XKeysymToKeycode(x.display, XK_F1);
+    x.f2 = XKeysymToKeycode(x.display, XK_F2);
+    x.spare = find_spare_keycode();
+    g_assert_true(x.ctrl && x.shift && x.f1 && x.f2);
+
+    add_backend_tests("grab", GSR_X11_HOTKEY_BACKEND_GRAB);
+    add_backend_tests("raw", GSR_X11_HOTKEY_BACKEND_RAW);
+    g_test_add("/x11-hotkeys/grab/repeat-detectable", Fixture, GINT_TO_POINTER(GSR_X11_HOTKEY_BACKEND_GRAB),
+               fixture_setup, test_repeat_detectable, fixture_teardown);
+    g_test_add("/x11-hotkeys/grab/repeat-fallback", Fixture, GINT_TO_POINTER(GSR_X11_HOTKEY_BACKEND_GRAB),
+               fixture_setup, test_repeat_fallback, fixture_teardown);
+
+    int result = g_test_run();
+    XCloseDisplay(x.display);
+    return result;
+}
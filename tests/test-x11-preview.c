@@ -0,0 +1,191 @@
+/*
+ * gsr-x11-preview.c on Xvfb.  The targets are plain windows filled with
+ * their background colour, so every frame pixel is known.
+ */
+
+#include "gsr-x11-preview.h"
+#include "gsr-test-util.h"
+
+#include <X11/Xlib.h>
+#include <X11/extensions/XShm.h>
+#include <X11/extensions/Xrandr.h>
+
+#define WAIT_TIMEOUT_MS (GSR_X11_PREVIEW_INTERVAL_MS * 4)
+#define FILL            0x3366cc    /* 24-bit TrueColor pixel */
+
+static Display *display;
+
+typedef struct {
+    GsrX11Preview *preview;
+    int            n_frames;
+    GdkTexture    *frame;
+    Window         window;
+} Fixture;
+
+static void
+on_frame(GdkTexture *frame, gpointer user_data)
+{
+    Fixture *f = user_data;
+    g_set_object(&f->frame, frame);
+    f->n_frames++;
+}
+
+static void
+fixture_setup(Fixture *f, gconstpointer data G_GNUC_UNUSED)
+{
+    f->preview = gsr_x11_preview_new(100, 100, on_frame, f);
+    g_assert_nonnull(f->preview);
+
+    /* No window manager: mapped means on screen at once */
+    f->window = XCreateSimpleWindow(display, DefaultRootWindow(display),
+                                    0, 0, 200, 100, 0, 0, FILL);
+    XMapWindow(display, f->window);
+    XSync(display, False);
+}
+
+static void
+fixture_teardown(Fixture *f, gconstpointer data G_GNUC_UNUSED)
+{
+    gsr_x11_preview_free(f->preview);
+    g_clear_object(&f->frame);
+    XDestroyWindow(display, f->window);
+    XSync(display, False);
+}
+
+/* The last frame is width×height and all FILL */
+static void
+assert_frame(const Fixture *f, int width, int height)
+{
+    g_assert_nonnull(f->frame);
+    g_assert_cmpint(gdk_texture_get_width(f->frame), ==, width);
+    g_assert_cmpint(gdk_texture_get_height(f->frame), ==, height);
+
+    /* Downloaded as native-endian ARGB32 */
+    g_autofree guint32 *pixels = g_new(guint32, (gsize)width * (gsize)height);
+    gdk_texture_download(f->frame, (guchar *)pixels, (gsize)width * 4);
+    for (int i = 0; i < width * height; i++)
+        g_assert_cmphex(pixels[i], ==, 0xff000000 | FILL);
+}
+
+/* A window is scaled down to fit and followed where it moves */
+static void
+test_window(Fixture *f, gconstpointer data G_GNUC_UNUSED)
+{
+    g_assert_false(gsr_x11_preview_get_cost(f->preview, NULL, NULL));
+
+    /* Nothing happens until it runs */
+    gsr_x11_preview_show_window(f->preview, f->window);
+    g_assert_cmpint(f->n_frames, ==, 0);
+    gsr_x11_preview_set_running(f->preview, TRUE);
+    g_assert_cmpint(f->n_frames, ==, 1);
+    assert_frame(f, 100, 50);
+
+    double ms = -1, percent = -1;
+    g_assert_true(gsr_x11_preview_get_cost(f->preview, &ms, &percent));
+    g_assert_cmpfloat(ms, >=, 0);
+    g_assert_cmpfloat(percent, >=, 0);
+
+    XMoveWindow(display, f->window, 300, 200);
+    XSync(display, False);
+    gsr_test_iterate_until(&f->n_frames, 2, WAIT_TIMEOUT_MS);
+    g_assert_cmpint(f->n_frames, ==, 2);
+    assert_frame(f, 100, 50);
+
+    /* Unmapped: no frames until it's back */
+    XUnmapWindow(display, f->window);
+    XSync(display, False);
+    gsr_x11_preview_show_window(f->preview, f->window);
+    gsr_test_iterate_until(NULL, 0, GSR_X11_PREVIEW_INTERVAL_MS * 2);
+    g_assert_cmpint(f->n_frames, ==, 2);
+
+    XMapWindow(display, f->window);
+    XSync(display, False);
+    gsr_test_iterate_until(&f->n_frames, 3, WAIT_TIMEOUT_MS);
+    assert_frame(f, 100, 50);
+}
+
+/* A region is clipped to the screen; small ones aren't scaled */
+static void
+test_region(Fixture *f, gconstpointer data G_GNUC_UNUSED)
+{
+    gsr_x11_preview_set_running(f->preview, TRUE);
+    g_assert_cmpint(f->n_frames, ==, 0);
+
+    gsr_x11_preview_show_region(f->preview, 20, 30, 50, 40);
+    g_assert_cmpint(f->n_frames, ==, 1);
+    assert_frame(f, 50, 40);
+
+    gsr_x11_preview_show_region(f->preview, -30, -20, 60, 60);
+    g_assert_cmpint(f->n_frames, ==, 2);
+    assert_frame(f, 30, 40);
+
+    /* Entirely off screen */
+    gsr_x11_preview_show_region(f->preview, -100, -100, 50, 50);
+    g_assert_cmpint(f->n_frames, ==, 2);
+}
+
+static void
+test_monitor(Fixture *f, gconstpointer data G_GNUC_UNUSED)
+{
+    gsr_x11_preview_set_running(f->preview, TRUE);
+    g_assert_false(gsr_x11_preview_show_monitor(f->preview, "NO-SUCH"));
+    g_assert_cmpint(f->n_frames, ==, 0);
+
+    int n = 0;
+    XRRMonitorInfo *monitors = XRRGetMonitors(display, DefaultRootWindow(display), True, &n);
+    if (n == 0) {
+        g_test_skip("no RandR monitors");
+        return;
+    }
+    char *name = XGetAtomName(display, monitors[0].name);
+    g_assert_true(gsr_x11_preview_show_monitor(f->preview, name));
+    g_assert_cmpint(f->n_frames, ==, 1);
+    double scale = MIN(100.0 / monitors[0].width, 100.0 / monitors[0].height);
+    g_assert_cmpint(gdk_texture_get_width(f->frame), ==, (int)(monitors[0].width * scale));
+    g_assert_cmpint(gdk_texture_get_height(f->frame), ==, (int)(monitors[0].height * scale));
+    XFree(name);
+    XRRFreeMonitors(monitors);
+}
+
+/* Paused, or with nothing to show, the timer is gone */
+static void
+test_pause(Fixture *f, gconstpointer data G_GNUC_UNUSED)
+{
+    gsr_x11_preview_show_window(f->preview, f->window);
+    gsr_x11_preview_set_running(f->preview, TRUE);
+    gsr_test_iterate_until(&f->n_frames, 2, WAIT_TIMEOUT_MS);
+    g_assert_cmpint(f->n_frames, ==, 2);
+
+    gsr_x11_preview_set_running(f->preview, FALSE);
+    gsr_test_iterate_until(NULL, 0, GSR_X11_PREVIEW_INTERVAL_MS * 2);
+    g_assert_cmpint(f->n_frames, ==, 2);
+
+    gsr_x11_preview_set_running(f->preview, TRUE);
+    g_assert_cmpint(f->n_frames, ==, 3);
+    gsr_x11_preview_show_nothing(f->preview);
+    gsr_test_iterate_until(NULL, 0, GSR_X11_PREVIEW_INTERVAL_MS * 2);
+    g_assert_cmpint(f->n_frames, ==, 3);
+}
+
+int
+main(int argc, char **argv)
+{
+    g_test_init(&argc, &argv, NULL);
+
+    /* 77: skipped, for meson; it runs this under xvfb-run */
+    display = XOpenDisplay(NULL);
+    if (!display)
+        return 77;
+    if (!XShmQueryExtension(display) || DefaultDepth(display, DefaultScreen(display)) != 24) {
+        XCloseDisplay(display);
+        return 77;
+    }
+
+    g_test_add("/x11-preview/window", Fixture, NULL, fixture_setup, test_window, fixture_teardown);
+    g_test_add("/x11-preview/region", Fixture, NULL, fixture_setup, test_region, fixture_teardown);
+    g_test_add("/x11-preview/monitor", Fixture, NULL, fixture_setup, test_monitor, fixture_teardown);
+    g_test_add("/x11-preview/pause", Fixture, NULL, fixture_setup, test_pause, fixture_teardown);
+    int result = g_test_run();
+    XCloseDisplay(display);
+    return result;
+}
@@ -0,0 +1,203 @@
+/*
+ * gsr-x11-window-list.c on Xvfb.  There is no window manager, so the test
+ * plays one: it creates the clients and keeps _NET_CLIENT_LIST itself,
+ * on a connection of its own.
+ */
+
+#include "gsr-x11-window-list.h"
+#include "gsr-test-util.h"
+
+#include <string.h>
+
+#include <X11/Xatom.h>
+#include <X11/Xutil.h>
+
+#define WAIT_TIMEOUT_MS 5000
+
+static struct {
+    Display *display;
+    Window   root;
+    Atom     net_client_list;
+    Atom     net_wm_name;
+    Atom     utf8_string;
+} wm;
+
+typedef struct {
+    GsrX11WindowList *list;
+    int               n_changes;
+} Fixture;
+
+static void
+on_changed(GsrX11WindowList *list, gpointer user_data)
+{
+    Fixture *f = user_data;
+    g_assert_true(list == f->list);
+    f->n_changes++;
+}
+
+/* ── The stand-in window manager ─────────────────────────────────── */
+
+static Window
+create_client(const char *net_wm_name, const char *wm_name, const char *wm_class)
+{
+    Window window = XCreateSimpleWindow(wm.display, wm.root, 0, 0, 100, 100, 0, 0, 0);
+    if (net_wm_name)
+        XChangeProperty(wm.display, window, wm.net_wm_name, wm.utf8_string, 8,
+                        PropModeReplace, (const unsigned char *)net_wm_name,
+                        (int)strlen(net_wm_name));
+    if (wm_name)
+        XStoreName(wm.display, window, wm_name);
+    XClassHint hint = { .res_name = (char *)"test", .res_class = (char *)wm_class };
+    XSetClassHint(wm.display, window, &hint);
+    return window;
+}
+
+static void
+set_client_list(const Window *windows, int n)
+{
+    XChangeProperty(wm.display, wm.root, wm.net_client_list, XA_WINDOW, 32,
+                    PropModeReplace, (const unsigned char *)windows, n);
+    XFlush(wm.display);
+}
+
+static void
+fixture_setup(Fixture *f, gconstpointer data G_GNUC_UNUSED)
+{
+    XDeleteProperty(wm.display, wm.root, wm.net_client_list);
+    XSync(wm.display, False);
+    f->list = gsr_x11_window_list_new();
+    g_assert_nonnull(f->list);
+    gsr_x11_window_list_set_changed_func(f->list, on_changed, f);
+}
+
+static void
+fixture_teardown(Fixture *f, gconstpointer data G_GNUC_UNUSED)
+{
+    gsr_x11_window_list_free(f->list);
+}
+
+static void
+assert_client(GsrX11WindowList *list, guint index, Window window,
+              const char *name, const char *wm_class)
+{
+    const GsrX11WindowInfo *info = gsr_x11_window_list_get(list, index);
+    g_assert_nonnull(info);
+    g_assert_cmpuint(info->window, ==, window);
+    g_assert_cmpstr(info->name, ==, name);
+    g_assert_cmpstr(info->wm_class, ==, wm_class);
+}
+
+/* ── Tests ───────────────────────────────────────────────────────── */
+
+static void
+test_client_list(Fixture *f, gconstpointer data G_GNUC_UNUSED)
+{
+    g_assert_cmpuint(gsr_x11_window_list_get_n(f->list), ==, 0);
+
+    Window browser = create_client("Café – Browser", "Cafe - Browser", "Browser");
+    Window term = create_client(NULL, "xterm", "XTerm");
+    Window unnamed = create_client(NULL, NULL, "Unnamed");
+    Window clients[] = { browser, term, unnamed };
+    set_client_list(clients, 3);
+
+    gsr_test_iterate_until(&f->n_changes, 1, WAIT_TIMEOUT_MS);
+    g_assert_cmpint(f->n_changes, ==, 1);
+    g_assert_cmpuint(gsr_x11_window_list_get_n(f->list), ==, 3);
+    /* _NET_WM_NAME wins over WM_NAME */
+    assert_client(f->list, 0, browser, "Café – Browser", "Browser");
+    assert_client(f->list, 1, term, "xterm", "XTerm");
+    assert_client(f->list, 2, unnamed, "", "Unnamed");
+
+    /* Reordered, one gone from the list */
+    Window reordered[] = { term, browser };
+    set_client_list(reordered, 2);
+    gsr_test_iterate_until(&f->n_changes, 2, WAIT_TIMEOUT_MS);
+    g_assert_cmpuint(gsr_x11_window_list_get_n(f->list), ==, 2);
+    assert_client(f->list, 0, term, "xterm", "XTerm");
+    assert_client(f->list, 1, browser, "Café – Browser", "Browser");
+
+    XDestroyWindow(wm.display, browser);
+    XDestroyWindow(wm.display, term);
+    XDestroyWindow(wm.display, unnamed);
+    XSync(wm.display, False);
+}
+
+/* Names follow the window; no client list change needed */
+static void
+test_rename(Fixture *f, gconstpointer data G_GNUC_UNUSED)
+{
+    Window term = create_client(NULL, "xterm", "XTerm");
+    set_client_list(&term, 1);
+    gsr_test_iterate_until(&f->n_changes, 1, WAIT_TIMEOUT_MS);
+    g_assert_cmpuint(gsr_x11_window_list_get_n(f->list), ==, 1);
+
+    XStoreName(wm.display, term, "vim README");
+    XFlush(wm.display);
+    gsr_test_iterate_until(&f->n_changes, 2, WAIT_TIMEOUT_MS);
+    assert_client(f->list, 0, term, "vim README", "XTerm");
+
+    const char *utf8 = "vim README — ✎";
+    XChangeProperty(wm.display, term, wm.net_wm_name, wm.utf8_string, 8,
+                    PropModeReplace, (const unsigned char *)utf8, (int)strlen(utf8));
+    XFlush(wm.display);
+    gsr_test_iterate_until(&f->n_changes, 3, WAIT_TIMEOUT_MS);
+    assert_client(f->list, 0, term, utf8, "XTerm");
+
+    /* Other properties aren't a change */
+    XClassHint hint = { .res_name = (char *)"x", .res_class = (char *)"Other" };
+    XSetClassHint(wm.display, term, &hint);
+    XSync(wm.display, False);
+    gsr_test_iterate_until(NULL, 0, 200);
+    g_assert_cmpint(f->n_changes, ==, 3);
+
+    XDestroyWindow(wm.display, term);
+    XSync(wm.display, False);
+}
+
+/* A destroyed client goes at once, before the WM updates the list */
+static void
+test_destroy(Fixture *f, gconstpointer data G_GNUC_UNUSED)
+{
+    Window a = create_client(NULL, "a", "A");
+    Window b = create_client(NULL, "b", "B");
+    Window clients[] = { a, b };
+    set_client_list(clients, 2);
+    gsr_test_iterate_until(&f->n_changes, 1, WAIT_TIMEOUT_MS);
+    g_assert_cmpuint(gsr_x11_window_list_get_n(f->list), ==, 2);
+
+    XDestroyWindow(wm.display, a);
+    XFlush(wm.display);
+    gsr_test_iterate_until(&f->n_changes, 2, WAIT_TIMEOUT_MS);
+    g_assert_cmpuint(gsr_x11_window_list_get_n(f->list), ==, 1);
+    assert_client(f->list, 0, b, "b", "B");
+
+    /* No callback once it's unset */
+    gsr_x11_window_list_set_changed_func(f->list, NULL, NULL);
+    XDestroyWindow(wm.display, b);
+    XSync(wm.display, False);
+    gsr_test_iterate_until(NULL, 0, 200);
+    g_assert_cmpint(f->n_changes, ==, 2);
+    g_assert_cmpuint(gsr_x11_window_list_get_n(f->list), ==, 0);
+}
+
+int
+main(int argc, char **argv)
+{
+    g_test_init(&argc, &argv, NULL);
+
+    /* 77: skipped, for meson; it runs this under xvfb-run */
+    wm.display = XOpenDisplay(NULL);
+    if (!wm.display)
+        return 77;
+    wm.root = DefaultRootWindow(wm.display);
+    wm.net_client_list = XInternAtom(wm.display, "_NET_CLIENT_LIST", False);
+    wm.net_wm_name = XInternAtom(wm.display, "_NET_WM_NAME", False);
+    wm.utf8_string = XInternAtom(wm.display, "UTF8_STRING", False);
+
+    g_test_add("/x11-window-list/client-list", Fixture, NULL, fixture_setup, test_client_list, fixture_teardown);
+    g_test_add("/x11-window-list/rename", Fixture, NULL, fixture_setup, test_rename, fixture_teardown);
+    g_test_add("/x11-window-list/destroy", Fixture, NULL, fixture_setup, test_destroy, fixture_teardown);
+    int result = g_test_run();
+    XCloseDisplay(wm.display);
+    return result;
+}